@@ -32,15 +32,20 @@
 #include "type_dispatch.hpp"
 #include "utility.hpp"
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cinttypes>
 #include <cstdio>
 #include <cstring>
+#include <fstream>
 #include <hipsparselt/hipsparselt.h>
 #include <iostream>
 #include <map>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "testing_compress.hpp"
 #include "testing_prune.hpp"
@@ -77,7 +82,8 @@ void run_function(const func_map& map, const Arguments& arg, const std::string&
 }
 
 // Template to dispatch testing_gemm_strided_batched_ex for performance tests
-// the test is marked invalid when (Ti, To, Tc) not in (H/H/S, B/B/S, I8/I8/32, I8/H/I32)
+// the test is marked invalid when (Ti, To, Tc) not in (H/H/S, B/B/S, I8/I8/32, I8/H/I32,
+// F8/{H,B,S}/S, B8/{H,B,S}/S)
 template <typename Ti, typename To = Ti, typename Tc = To, typename TBias = Ti, typename = void>
 struct perf_sparse : hipsparselt_test_invalid
 {
@@ -93,6 +99,8 @@ struct perf_sparse<
 #ifdef __HIP_PLATFORM_AMD__
         (std::is_same<Ti, To>{} && (std::is_same<Ti, __half>{} || std::is_same<Ti, hip_bfloat16>{})
          && std::is_same<Tc, float>{})
+        || ((std::is_same<Ti, __hip_fp8_e4m3_fnuz>{} || std::is_same<Ti, __hip_fp8_e5m2_fnuz>{})
+            && std::is_same<Tc, float>{})
 #else
         (std::is_same<Ti, To>{}
          && ((std::is_same<Ti, __half>{} && std::is_same<Tc, __half>{})
@@ -135,8 +143,7 @@ int run_bench_test(Arguments& arg, const std::string& filter, bool any_stride, b
     // enable timing check,otherwise no performance data collected
     arg.timing = 1;
 
-    // One stream and one thread (0 indicates to use default behavior)
-    arg.streams = 0;
+    // One thread (0 indicates to use default behavior), --streams sets the matmul streams
     arg.threads = 0;
 
     // Skip past any testing_ prefix in function
@@ -254,10 +261,259 @@ void fix_batch(int argc, char* argv[])
         }
 }
 
+int run_bench_command(int argc, char* argv[], bool replayed);
+
+// Run each distinct hipsparselt-bench command line of a bench log, written with
+// HIPSPARSELT_LOG_BENCH=1, once, and weight its time by the number of calls which logged it.
+// The options of extra follow the ones of each line.
+int hipsparselt_bench_replay(const std::string&              file,
+                             char*                           program,
+                             const std::vector<std::string>& extra)
+{
+    std::ifstream log(file);
+    if(!log)
+        throw std::invalid_argument("Invalid value for --replay " + file);
+
+    // the distinct command lines in the order of their first call
+    static constexpr char          bench[] = "hipsparselt-bench ";
+    std::vector<std::string>       commands;
+    std::map<std::string, int64_t> calls;
+    for(std::string line; std::getline(log, line);)
+    {
+        size_t pos = line.find(bench);
+        if(pos == std::string::npos)
+            continue;
+        std::string command = line.substr(pos + sizeof(bench) - 1);
+        if(calls[command]++ == 0)
+            commands.push_back(command);
+    }
+
+    int     ret         = 0;
+    int64_t total_calls = 0, skipped_calls = 0;
+    double  total_us = 0.0, total_gflops = 0.0;
+    for(const auto& command : commands)
+    {
+        std::vector<std::string> words;
+        std::istringstream       tokens(command);
+        for(std::string word; tokens >> word;)
+            words.push_back(word);
+        words.insert(words.end(), extra.begin(), extra.end());
+
+        std::vector<char*> command_argv{program};
+        for(auto& word : words)
+            command_argv.push_back(&word[0]);
+        command_argv.push_back(nullptr);
+
+        int64_t n = calls[command];
+        hipsparselt_cout << "\nreplay: " << n << " calls of " << command << std::endl;
+
+        ArgumentModel_set_last_perf(
+            ArgumentLogging::NA_value, ArgumentLogging::NA_value, ArgumentLogging::NA_value);
+        try
+        {
+            ret |= run_bench_command(int(command_argv.size() - 1), command_argv.data(), true);
+        }
+        catch(const std::invalid_argument& exp)
+        {
+            hipsparselt_cerr << "replay: " << exp.what() << std::endl;
+            ret = -1;
+        }
+
+        double us     = ArgumentModel_get_last_gpu_us();
+        double gflops = ArgumentModel_get_last_gflops();
+        if(us <= 0.0 || gflops == ArgumentLogging::NA_value)
+        {
+            skipped_calls += n;
+            continue;
+        }
+        total_calls += n;
+        total_us += us * n;
+        total_gflops += gflops * n;
+    }
+    test_cleanup::cleanup();
+
+    hipsparselt_cout << "\nreplay: " << commands.size() << " problems, " << total_calls
+                     << " calls timed in " << total_us << " us, "
+                     << (total_us > 0.0 ? total_gflops / total_us * 1e6 : 0.0)
+                     << " hipsparselt-Gflops weighted by the calls";
+    if(skipped_calls)
+        hipsparselt_cout << ", " << skipped_calls << " calls not timed";
+    hipsparselt_cout << std::endl;
+    return ret;
+}
+
+// Sizes of a sweep range first:last[:step] of -m, -n or -k, a step xF multiplies the size by F,
+// an empty range is size alone
+std::vector<int64_t>
+    hipsparselt_sweep_sizes(const std::string& range, int64_t size, const char* option)
+{
+    if(range.empty())
+        return {size};
+
+    int64_t first = 0, last = 0, step = 1;
+    bool    multiply = false;
+    if(sscanf(range.c_str(), "%" SCNd64 ":%" SCNd64 ":x%" SCNd64, &first, &last, &step) == 3)
+        multiply = true;
+    else if(sscanf(range.c_str(), "%" SCNd64 ":%" SCNd64 ":%" SCNd64, &first, &last, &step) < 2)
+        throw std::invalid_argument("Invalid value for "s + option + " " + range);
+    if(first <= 0 || last < first || step < (multiply ? 2 : 1))
+        throw std::invalid_argument("Invalid value for "s + option + " " + range);
+
+    std::vector<int64_t> sizes;
+    for(int64_t value = first; value <= last; value = multiply ? value * step : value + step)
+        sizes.push_back(value);
+    return sizes;
+}
+
+// Run the problem of arg for each of shapes and report its throughput against the peaks of the
+// device, peak_gflops and peak_gbps override them when not 0
+int hipsparselt_bench_sweep(const Arguments&                           arg,
+                            const std::string&                         filter,
+                            bool                                       any_stride,
+                            const std::vector<std::array<int64_t, 3>>& shapes,
+                            double                                     peak_gflops,
+                            double                                     peak_gbps)
+{
+    double device_gflops, device_gbps;
+    hipsparselt_device_peaks(arg.a_type, &device_gflops, &device_gbps);
+    if(peak_gflops <= 0.0)
+        peak_gflops = device_gflops;
+    if(peak_gbps <= 0.0)
+        peak_gbps = device_gbps;
+
+    struct sweep_result
+    {
+        std::array<int64_t, 3> shape;
+        double                 us, gflops, gbytes, dense_us;
+    };
+    std::vector<sweep_result> results;
+
+    int ret = 0;
+    for(const auto& shape : shapes)
+    {
+        Arguments shape_arg = arg;
+        shape_arg.M         = shape[0];
+        shape_arg.N         = shape[1];
+        shape_arg.K         = shape[2];
+        ArgumentModel_set_last_perf(
+            ArgumentLogging::NA_value, ArgumentLogging::NA_value, ArgumentLogging::NA_value);
+        ArgumentModel_set_last_dense_us(ArgumentLogging::NA_value);
+        ret |= run_bench_test(shape_arg, filter, any_stride);
+        results.push_back({shape,
+                           ArgumentModel_get_last_gpu_us(),
+                           ArgumentModel_get_last_gflops(),
+                           ArgumentModel_get_last_gbytes(),
+                           ArgumentModel_get_last_dense_us()});
+    }
+    test_cleanup::cleanup();
+
+    // a percentage is left empty without its peak or its measure
+    auto percent = [](double measured, double peak) {
+        return measured > 0.0 && peak > 0.0 ? std::to_string(measured / peak * 100.0) : "";
+    };
+    hipsparselt_cout << "\nsweep: peak " << peak_gflops << " Gflops with 2:4 sparsity, "
+                     << peak_gbps << " GB/s\n"
+                     << "M,N,K,us,hipsparselt-Gflops,hipsparselt-GB/s,%peak-Gflops,%peak-GB/s"
+                     << (arg.compare_dense ? ",dense-us,sparse-speedup" : "") << std::endl;
+    for(const auto& result : results)
+    {
+        double gflops = result.us > 0.0 && result.gflops > 0.0 ? result.gflops / result.us * 1e6
+                                                               : 0.0;
+        double gbps = result.us > 0.0 && result.gbytes > 0.0 ? result.gbytes / result.us * 1e6
+                                                             : 0.0;
+        hipsparselt_cout << result.shape[0] << "," << result.shape[1] << "," << result.shape[2]
+                         << "," << result.us << "," << gflops << "," << gbps << ","
+                         << percent(gflops, peak_gflops) << "," << percent(gbps, peak_gbps);
+        if(arg.compare_dense && result.dense_us > 0.0 && result.us > 0.0)
+            hipsparselt_cout << "," << result.dense_us << "," << result.dense_us / result.us;
+        else if(arg.compare_dense)
+            hipsparselt_cout << ",,";
+        hipsparselt_cout << std::endl;
+    }
+    return ret;
+}
+
+// Time prune or compress with each launch variant of the library and print the row of the launch
+// table of the fastest one, appended to $HIPSPARSELT_LAUNCH_TABLE when it is set
+int hipsparselt_bench_tune_launch(const Arguments& arg, const std::string& filter, bool any_stride)
+{
+    bool compress = !strcmp(arg.function, "compress");
+    if(!compress && strcmp(arg.function, "prune"))
+        throw std::invalid_argument("Invalid option --tune_launch for --function "s + arg.function);
+    if(!arg.timing)
+        throw std::invalid_argument("Invalid option --tune_launch without --timing 1");
+
+    // the kernels and their number of variants of launch_table.hpp
+    bool        strip    = !compress && arg.prune_algo == HIPSPARSELT_PRUNE_SPMMA_STRIP;
+    const char* kernel   = compress ? "compress" : strip ? "prune_strip" : "prune_tile";
+    int         variants = strip ? 4 : 3;
+
+    int                 ret = 0, best = -1;
+    std::vector<double> us(variants, 0.0);
+    for(int variant = 0; variant < variants; variant++)
+    {
+        // the handle of the run reads the variant when it is created
+        setenv("HIPSPARSELT_LAUNCH_VARIANT", std::to_string(variant).c_str(), 1);
+        ArgumentModel_set_last_perf(
+            ArgumentLogging::NA_value, ArgumentLogging::NA_value, ArgumentLogging::NA_value);
+        ret |= run_bench_test(arg, filter, any_stride);
+        us[variant] = ArgumentModel_get_last_gpu_us();
+        if(us[variant] > 0.0 && (best < 0 || us[variant] < us[best]))
+            best = variant;
+    }
+    unsetenv("HIPSPARSELT_LAUNCH_VARIANT");
+    test_cleanup::cleanup();
+
+    hipsparselt_cout << "\ntune_launch: " << kernel << "\nvariant,us" << std::endl;
+    for(int variant = 0; variant < variants; variant++)
+        hipsparselt_cout << variant << "," << us[variant] << std::endl;
+    if(best < 0)
+    {
+        hipsparselt_cerr << "tune_launch: no variant was timed" << std::endl;
+        return ret ? ret : -1;
+    }
+
+    // the launch table keys the rows on the arch without its features and on whether k is the
+    // contiguous dimension of the sparse matrix
+    hipDeviceProp_t props;
+    int             device;
+    CHECK_HIP_ERROR(hipGetDevice(&device));
+    CHECK_HIP_ERROR(hipGetDeviceProperties(&props, device));
+    std::string arch = props.gcnArchName;
+    arch             = arch.substr(0, arch.find(':'));
+    bool k_contiguous = arg.sparse_b ? toupper(arg.transB) == 'N' : toupper(arg.transA) == 'T';
+
+    std::ostringstream row;
+    row << arch << " " << kernel << " " << hipsparselt_datatype_to_string(arg.a_type) << " "
+        << (k_contiguous ? "k" : "m") << " " << best;
+    hipsparselt_cout << "tune_launch: " << row.str() << std::endl;
+
+    const char* table = getenv("HIPSPARSELT_LAUNCH_TABLE");
+    if(table && *table)
+    {
+        std::ofstream out(table, std::ios::app);
+        if(!out)
+            throw std::invalid_argument("Invalid HIPSPARSELT_LAUNCH_TABLE "s + table);
+        out << row.str() << std::endl;
+    }
+    return ret;
+}
+
 int main(int argc, char* argv[])
 try
 {
     fix_batch(argc, argv);
+    return run_bench_command(argc, argv, false);
+}
+catch(const std::invalid_argument& exp)
+{
+    hipsparselt_cerr << exp.what() << std::endl;
+    return -1;
+}
+
+// Parse a command line and run it, a line of --replay runs on the device already set
+int run_bench_command(int argc, char* argv[], bool replayed)
+{
     Arguments   arg;
     std::string function;
     std::string precision;
@@ -270,9 +526,18 @@ try
     std::string initialization;
     std::string filter;
     std::string activation_type;
+    std::string replay;
+    std::string sweep_m;
+    std::string sweep_n;
+    std::string sweep_k;
+    std::string sweep_file;
+    std::string samples_file;
+    double      peak_gflops;
+    double      peak_gbps;
+    bool        tune_launch;
     int         device_id;
     int         flags             = 0;
-    bool        datafile          = hipsparselt_parse_data(argc, argv);
+    bool        datafile          = !replayed && hipsparselt_parse_data(argc, argv);
     bool        log_function_name = false;
     bool        any_stride        = false;
 
@@ -341,23 +606,23 @@ try
 
         ("precision,r",
          value<std::string>(&precision)->default_value("f16_r"), "Precision. "
-         "Options: h,f16_r,bf16_r,i8_r")
+         "Options: h,f16_r,bf16_r,i8_r,f8_r,bf8_r")
 
         ("a_type",
          value<std::string>(&a_type), "Precision of matrix A. "
-        "Options: h,f16_r,bf16_r,i8_r")
+        "Options: h,f16_r,bf16_r,i8_r,f8_r,bf8_r")
 
         ("b_type",
          value<std::string>(&b_type), "Precision of matrix B. "
-        "Options: h,f16_r,bf16_r,i8_r")
+        "Options: h,f16_r,bf16_r,i8_r,f8_r,bf8_r")
 
         ("c_type",
          value<std::string>(&c_type), "Precision of matrix C. "
-         "Options: h,f16_r,bf16_r,i8_r")
+         "Options: h,f16_r,bf16_r,i8_r,f32_r")
 
         ("d_type",
          value<std::string>(&d_type), "Precision of matrix D. "
-        "Options: h,f16_r,bf16_r,i8_r")
+        "Options: h,f16_r,bf16_r,i8_r,f32_r")
 
         ("compute_type",
          value<std::string>(&compute_type), "Precision of computation. "
@@ -410,15 +675,15 @@ try
 
         ("activation_type",
          value<std::string>(&activation_type)->default_value("none"),
-         "Options: None, clippedrelu, gelu, relu")
+         "Options: None, clippedrelu, gelu, relu, silu, clamp")
 
         ("activation_arg1",
          value<float>(&arg.activation_arg1)->default_value(std::numeric_limits<float>::quiet_NaN()),
-         "activation argument #1, when activation_type is clippedrelu, this argument used to be the threshold(default=0). when type is gelu, this argument used to be the gelu scaling. (default=1)")
+         "activation argument #1, when activation_type is clippedrelu, this argument used to be the threshold(default=0). when type is gelu, this argument used to be the gelu scaling. (default=1), when type is clamp, this argument used to be the lower bound.")
 
         ("activation_arg2",
          value<float>(&arg.activation_arg2)->default_value(std::numeric_limits<float>::infinity()),
-         "activation argument #2, when activation_type is clippedrelu, this argument used to be the upperbound.")
+         "activation argument #2, when activation_type is clippedrelu or clamp, this argument used to be the upperbound.")
 
         ("bias_vector",
          bool_switch(&arg.bias_vector)->default_value(false),
@@ -448,14 +713,147 @@ try
          bool_switch(&arg.search)->default_value(false),
          "Evaluates all available algorithms and find the fastest one.")
 
+        ("search_async",
+         bool_switch(&arg.search_async)->default_value(false),
+         "Run the search of --search in the background with hipsparseLtMatmulSearchAsync")
+
+        ("search_flush_cache",
+         bool_switch(&arg.search_flush_cache)->default_value(false),
+         "Flush L2 and MALL before each timed run of --search, so cold weights are timed")
+
+        ("search_dense",
+         bool_switch(&arg.search_dense)->default_value(false),
+         "Also time the dense path in --search, the matmul runs it when it is faster")
+
         ("search_iters",
          value<int32_t>(&arg.search_iters)->default_value(10),
          "Iterations to run inside timing loop of each algorithms when search is on. (default: 10)")
 
+        ("split_k",
+         value<int32_t>(&arg.split_k)->default_value(0),
+         "Restrict the algorithms to the ones splitting K by this factor, 1 for no split. (default: 0, not set)")
+
+        ("stream_k",
+         bool_switch(&arg.stream_k)->default_value(false),
+         "Restrict the algorithms to the Stream-K ones, which split K only for the last wave of tiles")
+
+        ("alpha_vector_scaling",
+         bool_switch(&arg.alpha_vector_scaling)->default_value(false),
+         "Pass alpha and beta as device vectors of M scales, one per row of D")
+
+        ("scale_a",
+         value<float>(&arg.scale_a)->default_value(1.0), "Scale of matrix A, used to dequantize FP8 inputs")
+
+        ("scale_b",
+         value<float>(&arg.scale_b)->default_value(1.0), "Scale of matrix B, used to dequantize FP8 inputs")
+
+        ("d_scale",
+         value<float>(&arg.d_scale)->default_value(1.0), "Scale of matrix D, applied after the bias and the activation")
+
+        ("d_saturate",
+         bool_switch(&arg.d_saturate)->default_value(false),
+         "Saturate the scaled D to the finite range of its type")
+
+        ("amax_d",
+         bool_switch(&arg.amax_d)->default_value(false),
+         "Return the absolute maximum of D, before its scale, in a device float")
+
+        ("residual",
+         bool_switch(&arg.residual)->default_value(false),
+         "Add a residual matrix of the layout of D after the bias and the activation")
+
+        ("gate",
+         bool_switch(&arg.gate)->default_value(false),
+         "Multiply the activated result by a gate matrix of the layout of D")
+
+        ("bias_grad",
+         bool_switch(&arg.bias_grad)->default_value(false),
+         "Sum the rows of D over its columns and batches into a bias gradient vector")
+
+        ("sparse_dynamic",
+         bool_switch(&arg.sparse_dynamic)->default_value(false),
+         "Give the dense structured matrix to the matmul, which prunes and compresses it")
+
         ("sparse_b",
          bool_switch(&arg.sparse_b)->default_value(false),
          "Structurted Sparsity Matrix B (A is Dense Matrix)")
 
+        ("streams",
+         value<uint16_t>(&arg.streams)->default_value(0),
+         "Number of streams passed to hipsparseLtMatmul, batches are spread over them")
+
+        ("grouped",
+         bool_switch(&arg.grouped)->default_value(false),
+         "Run the matmul twice with hipsparseLtMatmulGrouped")
+
+        ("sharded",
+         bool_switch(&arg.sharded)->default_value(false),
+         "Run the matmul as two shards split along the output with hipsparseLtMatmulSharded")
+
+        ("pointer_array",
+         bool_switch(&arg.pointer_array)->default_value(false),
+         "Pass each batch of the dense matrices by its own pointer to hipsparseLtMatmulPointerArray")
+
+        ("plan_threads",
+         value<uint16_t>(&arg.plan_threads)->default_value(0),
+         "Number of host threads which also run the plan at once, each on its own streams, D and workspace")
+
+        ("cu_count",
+         value<uint16_t>(&arg.cu_count)->default_value(0),
+         "Run on a stream masked to the first cu_count CUs and select the configs for them, 0 for all the CUs (HIP backend only)")
+
+        ("candidates",
+         value<uint16_t>(&arg.candidates)->default_value(0),
+         "Number of configs kept of the ones ranked by the selection heuristic, the best ranked first, 0 for the default (HIP backend only)")
+
+        ("dynamic_n",
+         value<int32_t>(&arg.dynamic_n)->default_value(0),
+         "Also run the plan for its first dynamic_n columns of B, C and D with hipsparseLtMatmulDynamicN, 0 for none")
+
+        ("workspace_pool",
+         bool_switch(&arg.workspace_pool)->default_value(false),
+         "Pass a NULL workspace, drawn from a workspace pool of the handle (HIP backend only)")
+
+        ("plan_stats",
+         bool_switch(&arg.plan_stats)->default_value(false),
+         "Keep the performance counters of the plan and print them after the run (HIP backend only)")
+
+        ("rotating",
+         value<int32_t>(&arg.rotating)->default_value(0),
+         "Rotate the timed matmuls over copies of A, B, C and D taking this many MiB in all, more than the caches hold, so each call reads its matrices from memory (default: 0, not rotating)")
+
+        ("flush",
+         bool_switch(&arg.flush)->default_value(false),
+         "Flush L2 and MALL before each timed matmul and time each one alone")
+
+        ("bench_threads",
+         value<uint16_t>(&arg.bench_threads)->default_value(0),
+         "Also time the matmul from this many host threads at once, each on its own streams, D and workspace, and report the Gflops and the launch rate of each thread and in all")
+
+        ("thread_plans",
+         bool_switch(&arg.thread_plans)->default_value(false),
+         "Each thread of --bench_threads initializes its own plan of the matmul instead of sharing the plan")
+
+        ("compare_dense",
+         bool_switch(&arg.compare_dense)->default_value(false),
+         "Also time the dense GEMM of hipBLASLt on the decompressed matrix with the same buffers and stream, and report the speedup of the sparse matmul (clients built with hipBLASLt only)")
+
+        ("device_reference",
+         bool_switch(&arg.device_reference)->default_value(false),
+         "Compute the reference of --verify and compare D with it on the device, for the sizes the host reference is slow on; a matmul with an epilogue keeps the host reference")
+
+        ("device_init",
+         bool_switch(&arg.device_init)->default_value(false),
+         "Initialize the matrices on the device instead of the host, the trig_float values are the same and the random ones have the same distribution; the host copies are made for --verify only and --initialization special stays on the host")
+
+        ("pinned",
+         bool_switch(&arg.pinned)->default_value(false),
+         "The host matrices of prune and compress are in pinned memory and transferred in the order of the stream; with --timing the upload of the matrix is also timed from the pinned memory and from a pageable copy")
+
+        ("graph",
+         bool_switch(&arg.graph)->default_value(false),
+         "Capture the matmul into a HIP graph and replay it with hipsparseLtMatmulGraphLaunch")
+
         ("log_function_name",
          bool_switch(&log_function_name)->default_value(false),
          "Function name precedes other itmes.")
@@ -464,6 +862,42 @@ try
          value<std::string>(&filter),
          "Simple strstr filter on function name only without wildcards")
 
+        ("replay",
+         value<std::string>(&replay),
+         "Run each distinct hipsparselt-bench command line of a HIPSPARSELT_LOG_BENCH log once, the options given with it apply to all, and report the throughput weighted by the number of calls of each line")
+
+        ("sweep_m",
+         value<std::string>(&sweep_m),
+         "Sweep M over first:last[:step], a step xF multiplies M by F, and report the throughput of each size against the peaks of the device")
+
+        ("sweep_n",
+         value<std::string>(&sweep_n),
+         "Sweep N over first:last[:step], a step xF multiplies N by F")
+
+        ("sweep_k",
+         value<std::string>(&sweep_k),
+         "Sweep K over first:last[:step], a step xF multiplies K by F")
+
+        ("sweep_file",
+         value<std::string>(&sweep_file),
+         "Sweep the sizes of a file, a line of M N K each")
+
+        ("peak_gflops",
+         value<double>(&peak_gflops)->default_value(0.0),
+         "Peak Gflops with 2:4 sparsity the sweep compares to, 0 for the one known for the arch of the device")
+
+        ("peak_gbps",
+         value<double>(&peak_gbps)->default_value(0.0),
+         "Peak GB/s the bandwidth of the runs, of their samples and of the sweep is a percentage of, 0 for the one known for the arch of the device")
+
+        ("tune_launch",
+         bool_switch(&tune_launch)->default_value(false),
+         "Time prune or compress with each launch variant of the library and print the fastest as a row of the launch table, appended to $HIPSPARSELT_LAUNCH_TABLE when it is set")
+
+        ("samples_file",
+         value<std::string>(&samples_file),
+         "Append the min, median, p90, p99, mean and stddev of the time of the hot calls to this file, as JSON lines when it ends with .json and as CSV otherwise")
+
         ("help,h", "produces this help message")
 
         ("version", "Prints the version number");
@@ -474,7 +908,12 @@ try
     store(parse_command_line(argc, argv, desc), vm);
     notify(vm);
 
-    if((argc <= 1 && !datafile) || vm.count("help"))
+    if(replayed)
+    {
+        if(!replay.empty())
+            throw std::invalid_argument("Invalid option --replay in a replayed command line");
+    }
+    else if((argc <= 1 && !datafile) || vm.count("help"))
     {
         hipsparselt_cout << desc << std::endl;
         return 0;
@@ -491,18 +930,38 @@ try
 
     // transfer local variable state
     ArgumentModel_set_log_function_name(log_function_name);
+    ArgumentModel_set_samples_file(samples_file);
+    ArgumentModel_set_peak_gbps(peak_gbps);
 
-    // Device Query
-    int64_t device_count = query_device_property();
+    if(!replayed)
+    {
+        // Device Query
+        int64_t device_count = query_device_property();
 
-    hipsparselt_cout << std::endl;
-    if(device_count <= device_id)
-        throw std::invalid_argument("Invalid Device ID");
-    set_device(device_id);
+        hipsparselt_cout << std::endl;
+        if(device_count <= device_id)
+            throw std::invalid_argument("Invalid Device ID");
+        set_device(device_id);
+    }
 
     if(datafile)
         return hipsparselt_bench_datafile(filter, any_stride);
 
+    if(!replay.empty())
+    {
+        // the options given with --replay, other than the device and the log, override the
+        // ones of the logged lines
+        std::vector<std::string> extra;
+        for(int i = 1; i < argc; i++)
+        {
+            if(!strcmp(argv[i], "--replay") || !strcmp(argv[i], "--device"))
+                i++;
+            else
+                extra.push_back(argv[i]);
+        }
+        return hipsparselt_bench_replay(replay, argv[0], extra);
+    }
+
     // single bench run
 
     // validate arguments
@@ -530,9 +989,10 @@ try
 
     bool is_f16      = arg.a_type == HIPSPARSELT_R_16F || arg.a_type == HIPSPARSELT_R_16BF;
     bool is_f32      = arg.a_type == HIPSPARSELT_R_32F;
+    bool is_f8       = arg.a_type == HIPSPARSELT_R_8F || arg.a_type == HIPSPARSELT_R_8BF;
     arg.compute_type = compute_type == ""
 #ifdef __HIP_PLATFORM_AMD__
-                           ? (is_f16 ? HIPSPARSELT_COMPUTE_32F : HIPSPARSELT_COMPUTE_32I)
+                           ? (is_f16 || is_f8 ? HIPSPARSELT_COMPUTE_32F : HIPSPARSELT_COMPUTE_32I)
 #else
                            ? (is_f16   ? HIPSPARSELT_COMPUTE_16F
                               : is_f32 ? HIPSPARSELT_COMPUTE_TF32
@@ -583,10 +1043,34 @@ try
     if(copied <= 0 || copied >= sizeof(arg.function))
         throw std::invalid_argument("Invalid value for --function");
 
+    if(!sweep_file.empty() || !sweep_m.empty() || !sweep_n.empty() || !sweep_k.empty())
+    {
+        std::vector<std::array<int64_t, 3>> shapes;
+        if(!sweep_file.empty())
+        {
+            std::ifstream sizes(sweep_file);
+            if(!sizes)
+                throw std::invalid_argument("Invalid value for --sweep_file " + sweep_file);
+            for(std::string line; std::getline(sizes, line);)
+            {
+                std::array<int64_t, 3> shape;
+                std::istringstream     fields(line);
+                if(fields >> shape[0] >> shape[1] >> shape[2])
+                    shapes.push_back(shape);
+            }
+        }
+        else
+        {
+            for(int64_t m : hipsparselt_sweep_sizes(sweep_m, arg.M, "--sweep_m"))
+                for(int64_t n : hipsparselt_sweep_sizes(sweep_n, arg.N, "--sweep_n"))
+                    for(int64_t k : hipsparselt_sweep_sizes(sweep_k, arg.K, "--sweep_k"))
+                        shapes.push_back({m, n, k});
+        }
+        return hipsparselt_bench_sweep(arg, filter, any_stride, shapes, peak_gflops, peak_gbps);
+    }
+
+    if(tune_launch)
+        return hipsparselt_bench_tune_launch(arg, filter, any_stride);
+
     return run_bench_test(arg, filter, any_stride);
 }
-catch(const std::invalid_argument& exp)
-{
-    hipsparselt_cerr << exp.what() << std::endl;
-    return -1;
-}
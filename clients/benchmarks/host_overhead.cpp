@@ -0,0 +1,339 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+/*!\file
+ * \brief hipsparselt-bench-host times the host side of the API calls of a matmul on a tiny
+ * problem: the latency of each call, and the host heap allocations and mutex locks it makes,
+ * averaged over the hot calls. The device work of hipsparseLtMatmul is waited for out of the
+ * timed blocks of calls, so the latency is the cost of the call on the host.
+ */
+
+#include "program_options.hpp"
+
+#include "hipsparselt_datatype2string.hpp"
+#include "hipsparselt_test.hpp"
+#include "utility.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <hipsparselt/hipsparselt.h>
+#include <iomanip>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef WIN32
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+using namespace roc; // For emulated program_options
+
+/* ============================================================================================ */
+// Count the mutex locks of the process. The pthread_mutex_lock of the client is found
+// before the one of the C library, so the std::mutex locks taken inside the library and the HIP
+// runtime, on their worker threads too, are counted as well. The count stays 0 on Windows.
+namespace
+{
+    std::atomic<size_t> g_lock_count{0};
+}
+
+#ifndef WIN32
+extern "C" int pthread_mutex_lock(pthread_mutex_t* mutex)
+{
+    using lock_function = int (*)(pthread_mutex_t*);
+    // no static guard here, whose initialization could take this lock again
+    static std::atomic<lock_function> next{nullptr};
+
+    lock_function lock = next.load(std::memory_order_acquire);
+    if(!lock)
+    {
+        lock = reinterpret_cast<lock_function>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+        next.store(lock, std::memory_order_release);
+    }
+    g_lock_count.fetch_add(1, std::memory_order_relaxed);
+    return lock(mutex);
+}
+#endif
+
+/* ============================================================================================ */
+// A timed API call: its name, the call, and whether the device work of the calls is waited for
+// after each block of calls
+struct host_call
+{
+    const char*                        name;
+    std::function<hipsparseStatus_t()> call;
+    bool                               sync;
+};
+
+// Times the hot calls of call in blocks, after the warm-up calls, and prints its line
+static void time_host_call(const host_call& call, int warmup, int iters, hipStream_t stream)
+{
+    // the hipsparseLtMatmul calls of a block are queued without waiting for the device
+    constexpr int block = 64;
+
+    for(int i = 0; i < warmup; i++)
+        EXPECT_HIPSPARSE_STATUS(call.call(), HIPSPARSE_STATUS_SUCCESS);
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+    double host_us = 0;
+    size_t allocs  = 0;
+    size_t locks   = 0;
+    for(int i = 0; i < iters; i += block)
+    {
+        int    calls       = std::min(block, iters - i);
+        size_t block_alloc = hipsparselt_host_alloc_count();
+        size_t block_lock  = g_lock_count.load(std::memory_order_relaxed);
+        double block_us    = get_time_us_no_sync();
+        for(int j = 0; j < calls; j++)
+            EXPECT_HIPSPARSE_STATUS(call.call(), HIPSPARSE_STATUS_SUCCESS);
+        host_us += get_time_us_no_sync() - block_us;
+        allocs += hipsparselt_host_alloc_count() - block_alloc;
+        locks += g_lock_count.load(std::memory_order_relaxed) - block_lock;
+        if(call.sync)
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+    }
+
+    hipsparselt_cout << call.name << "," << host_us / iters << "," << double(allocs) / iters
+                     << "," << double(locks) / iters << std::endl;
+}
+
+int main(int argc, char* argv[])
+try
+{
+    int64_t     M, N, K;
+    std::string precision;
+    int         iters;
+    int         warmup;
+    int         device_id;
+
+    options_description desc("hipsparselt-bench-host command line options");
+    desc.add_options()
+        // clang-format off
+        ("sizem,m",
+         value<int64_t>(&M)->default_value(64),
+         "The rows of A and D of the matmul.")
+
+        ("sizen,n",
+         value<int64_t>(&N)->default_value(64),
+         "The columns of B and D of the matmul.")
+
+        ("sizek,k",
+         value<int64_t>(&K)->default_value(64),
+         "The columns of A and rows of B of the matmul.")
+
+        ("precision,r",
+         value<std::string>(&precision)->default_value("f16_r"),
+         "Precision of A, B, C and D. Options: f16_r, bf16_r, i8_r")
+
+        ("iters,i",
+         value<int>(&iters)->default_value(10000),
+         "Number of hot calls of each API call.")
+
+        ("warmup",
+         value<int>(&warmup)->default_value(100),
+         "Number of warm-up calls of each API call, not timed.")
+
+        ("device",
+         value<int>(&device_id)->default_value(0),
+         "Set default device to be used for subsequent program runs")
+
+        ("help,h", "produces this help message");
+    // clang-format on
+
+    variables_map vm;
+    store(parse_command_line(argc, argv, desc), vm);
+    notify(vm);
+
+    if(vm.count("help"))
+    {
+        hipsparselt_cout << desc << std::endl;
+        return 0;
+    }
+    if(iters < 1 || warmup < 0)
+        throw std::invalid_argument("Invalid value for --iters or --warmup");
+
+    hipsparseLtDatatype_t type = string_to_hipsparselt_datatype(precision);
+    if(type != HIPSPARSELT_R_16F && type != HIPSPARSELT_R_16BF && type != HIPSPARSELT_R_8I)
+        throw std::invalid_argument("Invalid value for --precision " + precision);
+    hipsparseLtComputetype_t compute_type
+        = type == HIPSPARSELT_R_8I ? HIPSPARSELT_COMPUTE_32I : HIPSPARSELT_COMPUTE_32F;
+    size_t type_size = type == HIPSPARSELT_R_8I ? 1 : 2;
+
+    int device_count = 0;
+    CHECK_HIP_ERROR(hipGetDeviceCount(&device_count));
+    if(device_count <= device_id)
+        throw std::invalid_argument("Invalid Device ID");
+    set_device(device_id);
+
+    hipStream_t stream;
+    CHECK_HIP_ERROR(hipStreamCreate(&stream));
+
+    hipsparselt_local_handle    handle;
+    hipsparselt_local_mat_descr matA(hipsparselt_matrix_type_structured,
+                                     handle,
+                                     M,
+                                     K,
+                                     M,
+                                     type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matB(
+        hipsparselt_matrix_type_dense, handle, K, N, K, type, HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matC(
+        hipsparselt_matrix_type_dense, handle, M, N, M, type, HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matD(
+        hipsparselt_matrix_type_dense, handle, M, N, M, type, HIPSPARSE_ORDER_COL);
+    CHECK_HIPSPARSELT_ERROR(matA.status());
+    CHECK_HIPSPARSELT_ERROR(matB.status());
+    CHECK_HIPSPARSELT_ERROR(matC.status());
+    CHECK_HIPSPARSELT_ERROR(matD.status());
+
+    hipsparselt_local_matmul_descr matmul(handle,
+                                          HIPSPARSE_OPERATION_NON_TRANSPOSE,
+                                          HIPSPARSE_OPERATION_NON_TRANSPOSE,
+                                          matA,
+                                          matB,
+                                          matC,
+                                          matD,
+                                          compute_type);
+    CHECK_HIPSPARSELT_ERROR(matmul.status());
+    hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    CHECK_HIPSPARSELT_ERROR(alg_sel.status());
+    hipsparselt_local_matmul_plan plan(handle, matmul, alg_sel);
+    CHECK_HIPSPARSELT_ERROR(plan.status());
+
+    // the matrices are zeros, A compressed once
+    size_t workspace_size, compressed_size, compress_buffer_size;
+    CHECK_HIPSPARSELT_ERROR(hipsparseLtMatmulGetWorkspace(handle, plan, &workspace_size));
+    CHECK_HIPSPARSELT_ERROR(
+        hipsparseLtSpMMACompressedSize(handle, plan, &compressed_size, &compress_buffer_size));
+    device_vector<unsigned char> dA(M * K * type_size);
+    device_vector<unsigned char> dB(K * N * type_size);
+    device_vector<unsigned char> dC(M * N * type_size);
+    device_vector<unsigned char> dD(M * N * type_size);
+    device_vector<unsigned char> dA_compressed(compressed_size);
+    device_vector<unsigned char> dBuffer(std::max<size_t>(compress_buffer_size, 1));
+    device_vector<unsigned char> dWorkspace(std::max<size_t>(workspace_size, 1));
+    CHECK_DEVICE_ALLOCATION(dA.memcheck());
+    CHECK_DEVICE_ALLOCATION(dB.memcheck());
+    CHECK_DEVICE_ALLOCATION(dC.memcheck());
+    CHECK_DEVICE_ALLOCATION(dD.memcheck());
+    CHECK_DEVICE_ALLOCATION(dA_compressed.memcheck());
+    CHECK_DEVICE_ALLOCATION(dBuffer.memcheck());
+    CHECK_DEVICE_ALLOCATION(dWorkspace.memcheck());
+    CHECK_HIP_ERROR(hipMemsetAsync(dA, 0, M * K * type_size, stream));
+    CHECK_HIP_ERROR(hipMemsetAsync(dB, 0, K * N * type_size, stream));
+    CHECK_HIP_ERROR(hipMemsetAsync(dC, 0, M * N * type_size, stream));
+    CHECK_HIPSPARSELT_ERROR(
+        hipsparseLtSpMMACompress(handle, plan, dA, dA_compressed, dBuffer, stream));
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+    float   alpha = 1, beta = 0;
+    int32_t batches = 1, relu = 0;
+
+    // the setters and getters, the selection and the plan, then the matmul
+    std::vector<host_call> calls = {
+        {"hipsparseLtMatDescSetAttribute",
+         [&] {
+             return hipsparseLtMatDescSetAttribute(
+                 handle, matB, HIPSPARSELT_MAT_NUM_BATCHES, &batches, sizeof(batches));
+         },
+         false},
+        {"hipsparseLtMatDescGetAttribute",
+         [&] {
+             int32_t value;
+             return hipsparseLtMatDescGetAttribute(
+                 handle, matB, HIPSPARSELT_MAT_NUM_BATCHES, &value, sizeof(value));
+         },
+         false},
+        {"hipsparseLtMatmulDescSetAttribute",
+         [&] {
+             return hipsparseLtMatmulDescSetAttribute(
+                 handle, matmul, HIPSPARSELT_MATMUL_ACTIVATION_RELU, &relu, sizeof(relu));
+         },
+         false},
+        {"hipsparseLtMatmulDescGetAttribute",
+         [&] {
+             int32_t value;
+             return hipsparseLtMatmulDescGetAttribute(
+                 handle, matmul, HIPSPARSELT_MATMUL_ACTIVATION_RELU, &value, sizeof(value));
+         },
+         false},
+        {"hipsparseLtMatmulAlgSelectionInit",
+         [&] {
+             hipsparseLtMatmulAlgSelection_t sel;
+             return hipsparseLtMatmulAlgSelectionInit(
+                 handle, &sel, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+         },
+         false},
+        // a plan is destroyed by the call that made it, PlanInit is timed with its PlanDestroy
+        {"hipsparseLtMatmulPlanInit+PlanDestroy",
+         [&] {
+             hipsparseLtMatmulPlan_t new_plan;
+             hipsparseStatus_t       status
+                 = hipsparseLtMatmulPlanInit(handle, &new_plan, matmul, alg_sel);
+             return status == HIPSPARSE_STATUS_SUCCESS ? hipsparseLtMatmulPlanDestroy(&new_plan)
+                                                       : status;
+         },
+         false},
+        {"hipsparseLtMatmulGetWorkspace",
+         [&] {
+             size_t size;
+             return hipsparseLtMatmulGetWorkspace(handle, plan, &size);
+         },
+         false},
+        {"hipsparseLtMatmul",
+         [&] {
+             return hipsparseLtMatmul(handle,
+                                      plan,
+                                      &alpha,
+                                      dA_compressed,
+                                      dB,
+                                      &beta,
+                                      dC,
+                                      dD,
+                                      workspace_size ? (void*)dWorkspace : nullptr,
+                                      &stream,
+                                      1);
+         },
+         true},
+    };
+
+    hipsparselt_cout << "M,N,K,precision,iters" << std::endl
+                     << M << "," << N << "," << K << "," << precision << "," << iters << std::endl
+                     << std::endl
+                     << "call,host_us,allocs_per_call,locks_per_call" << std::endl;
+    for(const auto& call : calls)
+        time_host_call(call, warmup, iters, stream);
+
+    CHECK_HIP_ERROR(hipStreamDestroy(stream));
+    return 0;
+}
+catch(const std::invalid_argument& exp)
+{
+    hipsparselt_cerr << exp.what() << std::endl;
+    return -1;
+}
@@ -245,6 +245,12 @@ namespace roc
                     match = argc && sscanf(*argv, "%" SCNu32, &val) == 1;
                     ptr->actual_value(val);
                 }
+                else if(auto* ptr = dynamic_cast<value<uint16_t>*>(m_val.get()))
+                {
+                    uint16_t val;
+                    match = argc && sscanf(*argv, "%" SCNu16, &val) == 1;
+                    ptr->actual_value(val);
+                }
                 else if(auto* ptr = dynamic_cast<value<int64_t>*>(m_val.get()))
                 {
                     int64_t val;
@@ -464,6 +470,8 @@ namespace roc
                             left << dynamic_cast<const value<int32_t>*>(val)->get_value();
                         else if(dynamic_cast<const value<uint32_t>*>(val))
                             left << dynamic_cast<const value<uint32_t>*>(val)->get_value();
+                        else if(dynamic_cast<const value<uint16_t>*>(val))
+                            left << dynamic_cast<const value<uint16_t>*>(val)->get_value();
                         else if(dynamic_cast<const value<int64_t>*>(val))
                             left << dynamic_cast<const value<int64_t>*>(val)->get_value();
                         else if(dynamic_cast<const value<uint64_t>*>(val))
@@ -25,6 +25,11 @@
  *******************************************************************************/
 
 #include "argument_model.hpp"
+#include "utility.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <numeric>
 
 // this should have been a member variable but due to the complex variadic template this singleton allows global control
 
@@ -39,3 +44,184 @@ bool ArgumentModel_get_log_function_name()
 {
     return log_function_name;
 }
+
+static double last_gpu_us = ArgumentLogging::NA_value;
+static double last_gflops = ArgumentLogging::NA_value;
+static double last_gbytes = ArgumentLogging::NA_value;
+
+void ArgumentModel_set_last_perf(double gpu_us, double gflops, double gbytes)
+{
+    last_gpu_us = gpu_us;
+    last_gflops = gflops;
+    last_gbytes = gbytes;
+}
+
+double ArgumentModel_get_last_gpu_us()
+{
+    return last_gpu_us;
+}
+
+double ArgumentModel_get_last_gflops()
+{
+    return last_gflops;
+}
+
+double ArgumentModel_get_last_gbytes()
+{
+    return last_gbytes;
+}
+
+static double last_dense_us = ArgumentLogging::NA_value;
+
+void ArgumentModel_set_last_dense_us(double dense_us)
+{
+    last_dense_us = dense_us;
+}
+
+double ArgumentModel_get_last_dense_us()
+{
+    return last_dense_us;
+}
+
+static double peak_gbps = 0.0;
+
+void ArgumentModel_set_peak_gbps(double gbps)
+{
+    peak_gbps = gbps;
+}
+
+double ArgumentModel_get_peak_gbps()
+{
+    if(peak_gbps > 0.0)
+        return peak_gbps;
+    // the peak GB/s of the device do not depend on the type
+    double device_gflops, device_gbps;
+    hipsparselt_device_peaks(HIPSPARSELT_R_16F, &device_gflops, &device_gbps);
+    return device_gbps;
+}
+
+static std::string samples_file;
+
+void ArgumentModel_set_samples_file(const std::string& file)
+{
+    samples_file = file;
+}
+
+static bool record_samples = false;
+
+bool ArgumentModel_get_samples()
+{
+    return record_samples || !samples_file.empty();
+}
+
+void ArgumentModel_set_record_samples(bool record)
+{
+    record_samples = record;
+}
+
+static double last_median_us = ArgumentLogging::NA_value;
+
+void ArgumentModel_set_last_median_us(double median_us)
+{
+    last_median_us = median_us < 0 ? ArgumentLogging::NA_value : median_us;
+}
+
+double ArgumentModel_get_last_median_us()
+{
+    return last_median_us;
+}
+
+// nearest-rank percentile of sorted samples
+static double samples_percentile(const std::vector<double>& sorted, double p)
+{
+    size_t rank = size_t(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max(rank, size_t(1))) - 1];
+}
+
+void ArgumentModel_log_samples(const Arguments&    arg,
+                               std::vector<double> samples_us,
+                               int                 config_id,
+                               const std::string&  kernel_name)
+{
+    if(samples_us.empty())
+        return;
+
+    std::sort(samples_us.begin(), samples_us.end());
+    size_t n      = samples_us.size();
+    double mean   = std::accumulate(samples_us.begin(), samples_us.end(), 0.0) / n;
+    double sq_sum = 0.0;
+    for(double sample : samples_us)
+        sq_sum += (sample - mean) * (sample - mean);
+    double stddev = n > 1 ? std::sqrt(sq_sum / (n - 1)) : 0.0;
+    double min    = samples_us.front();
+    double median = samples_percentile(samples_us, 50);
+    double p90    = samples_percentile(samples_us, 90);
+    double p99    = samples_percentile(samples_us, 99);
+
+    ArgumentModel_set_last_median_us(median);
+    if(samples_file.empty())
+        return;
+
+    // the bandwidth at the median time, when the run counts its bytes
+    bool   bytes        = last_gbytes != ArgumentLogging::NA_value && median > 0.0;
+    double median_gbps  = bytes ? last_gbytes / median * 1e6 : 0.0;
+    double peak         = bytes ? ArgumentModel_get_peak_gbps() : 0.0;
+    double peak_percent = peak > 0.0 ? median_gbps / peak * 100.0 : 0.0;
+
+    hipsparselt_cout << "samples: " << n << " min-us: " << min << " median-us: " << median
+                     << " p90-us: " << p90 << " p99-us: " << p99 << " mean-us: " << mean
+                     << " stddev-us: " << stddev;
+    if(bytes)
+        hipsparselt_cout << " median-GB/s: " << median_gbps;
+    if(peak > 0.0)
+        hipsparselt_cout << " %peak-GB/s: " << peak_percent;
+    hipsparselt_cout << std::endl;
+
+    std::ifstream existing(samples_file);
+    bool          empty = !existing.good() || existing.peek() == std::ifstream::traits_type::eof();
+    existing.close();
+
+    std::ofstream out(samples_file, std::ios::app);
+    if(!out)
+    {
+        hipsparselt_cerr << "Cannot open the samples file " << samples_file << std::endl;
+        return;
+    }
+    out.precision(9);
+
+    const char* a_type = hipsparselt_datatype_to_string(arg.a_type);
+    bool        json   = samples_file.size() >= 5
+                    && samples_file.compare(samples_file.size() - 5, 5, ".json") == 0;
+    if(json)
+    {
+        out << "{\"function\": \"" << arg.function << "\", \"M\": " << arg.M
+            << ", \"N\": " << arg.N << ", \"K\": " << arg.K
+            << ", \"batch_count\": " << arg.batch_count << ", \"a_type\": \"" << a_type
+            << "\", \"config_id\": " << config_id << ", \"kernel\": \"" << kernel_name
+            << "\", \"n\": " << n << ", \"min_us\": " << min << ", \"median_us\": " << median
+            << ", \"p90_us\": " << p90 << ", \"p99_us\": " << p99 << ", \"mean_us\": " << mean
+            << ", \"stddev_us\": " << stddev;
+        if(bytes)
+            out << ", \"median_gbps\": " << median_gbps;
+        if(peak > 0.0)
+            out << ", \"peak_gbps_percent\": " << peak_percent;
+        out << "}" << std::endl;
+    }
+    else
+    {
+        if(empty)
+            out << "function,M,N,K,batch_count,a_type,config_id,kernel,n,min_us,median_us,"
+                   "p90_us,p99_us,mean_us,stddev_us,median_gbps,peak_gbps_percent"
+                << std::endl;
+        out << arg.function << "," << arg.M << "," << arg.N << "," << arg.K << ","
+            << arg.batch_count << "," << a_type << "," << config_id << "," << kernel_name << ","
+            << n << "," << min << "," << median << "," << p90 << "," << p99 << "," << mean << ","
+            << stddev << ",";
+        if(bytes)
+            out << median_gbps;
+        out << ",";
+        if(peak > 0.0)
+            out << peak_percent;
+        out << std::endl;
+    }
+}
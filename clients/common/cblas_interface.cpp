@@ -442,3 +442,228 @@ void cblas_gemm<int8_t, __half, float>(hipsparseOperation_t transA,
     for(size_t i = 0; i < sizeC; i++)
         C[i] = __half(C_double[i]);
 }
+
+template <>
+void cblas_gemm<int8_t, int32_t, float>(hipsparseOperation_t transA,
+                                        hipsparseOperation_t transB,
+                                        int64_t              m,
+                                        int64_t              n,
+                                        int64_t              k,
+                                        float                alpha,
+                                        const int8_t*        A,
+                                        int64_t              lda,
+                                        const int8_t*        B,
+                                        int64_t              ldb,
+                                        float                beta,
+                                        int32_t*             C,
+                                        int64_t              ldc,
+                                        bool                 alt)
+{
+    // as for an int8_t output, the sums of the int8_t products and an int32_t C are exact
+    // in double, round and saturate the result to int32_t like the library does.
+
+    size_t const sizeA = ((transA == HIPSPARSE_OPERATION_NON_TRANSPOSE) ? k : m) * size_t(lda);
+    size_t const sizeB = ((transB == HIPSPARSE_OPERATION_NON_TRANSPOSE) ? n : k) * size_t(ldb);
+    size_t const sizeC = n * size_t(ldc);
+
+    host_vector<double> A_double(sizeA);
+    host_vector<double> B_double(sizeB);
+    host_vector<double> C_double(sizeC);
+
+    for(size_t i = 0; i < sizeA; i++)
+        A_double[i] = static_cast<double>(A[i]);
+    for(size_t i = 0; i < sizeB; i++)
+        B_double[i] = static_cast<double>(B[i]);
+    for(size_t i = 0; i < sizeC; i++)
+        C_double[i] = static_cast<double>(C[i]);
+
+    // just directly cast, since transA, transB are integers in the enum
+    cblas_dgemm(CblasColMajor,
+                HIPOperationToCBLASTanspose(transA),
+                HIPOperationToCBLASTanspose(transB),
+                m,
+                n,
+                k,
+                alpha,
+                A_double,
+                lda,
+                B_double,
+                ldb,
+                beta,
+                C_double,
+                ldc);
+
+    auto saturate = [](double val) {
+        val = std::nearbyint(val);
+        val = val > 2147483647.0 ? 2147483647.0 : val < -2147483648.0 ? -2147483648.0 : val;
+        return val;
+    };
+
+    for(size_t i = 0; i < sizeC; i++)
+        C[i] = static_cast<int32_t>(saturate(C_double[i]));
+}
+
+#if defined(__HIP_PLATFORM_AMD__)
+// cblas does not support fp8 and bf8, so convert to float. The products of two 8 bit
+// floats are exact in float, so the result only differs by the order of the sums.
+template <typename Ti, typename To>
+static void cblas_gemm_f8(hipsparseOperation_t transA,
+                          hipsparseOperation_t transB,
+                          int64_t              m,
+                          int64_t              n,
+                          int64_t              k,
+                          float                alpha,
+                          const Ti*            A,
+                          int64_t              lda,
+                          const Ti*            B,
+                          int64_t              ldb,
+                          float                beta,
+                          To*                  C,
+                          int64_t              ldc)
+{
+    size_t sizeA = (transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? k : m) * size_t(lda);
+    size_t sizeB = (transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? n : k) * size_t(ldb);
+    size_t sizeC = n * size_t(ldc);
+
+    host_vector<float> A_float(sizeA), B_float(sizeB), C_float(sizeC);
+
+    for(size_t i = 0; i < sizeA; i++)
+        A_float[i] = static_cast<float>(A[i]);
+    for(size_t i = 0; i < sizeB; i++)
+        B_float[i] = static_cast<float>(B[i]);
+    for(size_t i = 0; i < sizeC; i++)
+        C_float[i] = static_cast<float>(C[i]);
+
+    cblas_sgemm(CblasColMajor,
+                HIPOperationToCBLASTanspose(transA),
+                HIPOperationToCBLASTanspose(transB),
+                m,
+                n,
+                k,
+                alpha,
+                A_float,
+                lda,
+                B_float,
+                ldb,
+                beta,
+                C_float,
+                ldc);
+
+    for(size_t i = 0; i < sizeC; i++)
+        C[i] = static_cast<To>(C_float[i]);
+}
+
+template <>
+void cblas_gemm<__hip_fp8_e4m3_fnuz, __half, float>(hipsparseOperation_t       transA,
+                                                    hipsparseOperation_t       transB,
+                                                    int64_t                    m,
+                                                    int64_t                    n,
+                                                    int64_t                    k,
+                                                    float                      alpha,
+                                                    const __hip_fp8_e4m3_fnuz* A,
+                                                    int64_t                    lda,
+                                                    const __hip_fp8_e4m3_fnuz* B,
+                                                    int64_t                    ldb,
+                                                    float                      beta,
+                                                    __half*                    C,
+                                                    int64_t                    ldc,
+                                                    bool                       alt)
+{
+    cblas_gemm_f8(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+template <>
+void cblas_gemm<__hip_fp8_e4m3_fnuz, hip_bfloat16, float>(hipsparseOperation_t       transA,
+                                                          hipsparseOperation_t       transB,
+                                                          int64_t                    m,
+                                                          int64_t                    n,
+                                                          int64_t                    k,
+                                                          float                      alpha,
+                                                          const __hip_fp8_e4m3_fnuz* A,
+                                                          int64_t                    lda,
+                                                          const __hip_fp8_e4m3_fnuz* B,
+                                                          int64_t                    ldb,
+                                                          float                      beta,
+                                                          hip_bfloat16*              C,
+                                                          int64_t                    ldc,
+                                                          bool                       alt)
+{
+    cblas_gemm_f8(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+template <>
+void cblas_gemm<__hip_fp8_e4m3_fnuz, float, float>(hipsparseOperation_t       transA,
+                                                   hipsparseOperation_t       transB,
+                                                   int64_t                    m,
+                                                   int64_t                    n,
+                                                   int64_t                    k,
+                                                   float                      alpha,
+                                                   const __hip_fp8_e4m3_fnuz* A,
+                                                   int64_t                    lda,
+                                                   const __hip_fp8_e4m3_fnuz* B,
+                                                   int64_t                    ldb,
+                                                   float                      beta,
+                                                   float*                     C,
+                                                   int64_t                    ldc,
+                                                   bool                       alt)
+{
+    cblas_gemm_f8(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+template <>
+void cblas_gemm<__hip_fp8_e5m2_fnuz, __half, float>(hipsparseOperation_t       transA,
+                                                    hipsparseOperation_t       transB,
+                                                    int64_t                    m,
+                                                    int64_t                    n,
+                                                    int64_t                    k,
+                                                    float                      alpha,
+                                                    const __hip_fp8_e5m2_fnuz* A,
+                                                    int64_t                    lda,
+                                                    const __hip_fp8_e5m2_fnuz* B,
+                                                    int64_t                    ldb,
+                                                    float                      beta,
+                                                    __half*                    C,
+                                                    int64_t                    ldc,
+                                                    bool                       alt)
+{
+    cblas_gemm_f8(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+template <>
+void cblas_gemm<__hip_fp8_e5m2_fnuz, hip_bfloat16, float>(hipsparseOperation_t       transA,
+                                                          hipsparseOperation_t       transB,
+                                                          int64_t                    m,
+                                                          int64_t                    n,
+                                                          int64_t                    k,
+                                                          float                      alpha,
+                                                          const __hip_fp8_e5m2_fnuz* A,
+                                                          int64_t                    lda,
+                                                          const __hip_fp8_e5m2_fnuz* B,
+                                                          int64_t                    ldb,
+                                                          float                      beta,
+                                                          hip_bfloat16*              C,
+                                                          int64_t                    ldc,
+                                                          bool                       alt)
+{
+    cblas_gemm_f8(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+
+template <>
+void cblas_gemm<__hip_fp8_e5m2_fnuz, float, float>(hipsparseOperation_t       transA,
+                                                   hipsparseOperation_t       transB,
+                                                   int64_t                    m,
+                                                   int64_t                    n,
+                                                   int64_t                    k,
+                                                   float                      alpha,
+                                                   const __hip_fp8_e5m2_fnuz* A,
+                                                   int64_t                    lda,
+                                                   const __hip_fp8_e5m2_fnuz* B,
+                                                   int64_t                    ldb,
+                                                   float                      beta,
+                                                   float*                     C,
+                                                   int64_t                    ldc,
+                                                   bool                       alt)
+{
+    cblas_gemm_f8(transA, transB, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc);
+}
+#endif
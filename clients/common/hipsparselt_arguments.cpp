@@ -96,13 +96,48 @@ void Arguments::init()
     transA = '*';
     transB = '*';
 
-    activation_type = hipsparselt_activation_type::none;
-    activation_arg1 = 0.0f;
-    activation_arg2 = std::numeric_limits<float>::infinity();
-    c_noalias_d     = false;
-    HMM             = false;
-    search          = false;
-    search_iters    = 10;
+    activation_type    = hipsparselt_activation_type::none;
+    activation_arg1    = 0.0f;
+    activation_arg2    = std::numeric_limits<float>::infinity();
+    c_noalias_d        = false;
+    HMM                = false;
+    search             = false;
+    search_async       = false;
+    search_flush_cache = false;
+    search_dense       = false;
+    search_iters       = 10;
+    split_k            = 0;
+    stream_k           = false;
+
+    alpha_vector_scaling = false;
+    scale_a              = 1.0f;
+    scale_b              = 1.0f;
+    d_scale              = 1.0f;
+    d_saturate           = false;
+    amax_d               = false;
+    residual             = false;
+    gate                 = false;
+    bias_grad            = false;
+    sparse_dynamic       = false;
+    graph              = false;
+    grouped            = false;
+    sharded            = false;
+    pointer_array      = false;
+    plan_threads       = 0;
+    cu_count           = 0;
+    candidates         = 0;
+    dynamic_n          = 0;
+    workspace_pool     = false;
+    plan_stats         = false;
+    rotating           = 0;
+    flush              = false;
+    bench_threads      = 0;
+    thread_plans       = false;
+    compare_dense      = false;
+    device_reference   = false;
+    device_init        = false;
+    pinned             = false;
+    perf_tolerance     = 0.1f;
 }
 
 // Function to print Arguments out to stream in YAML format
@@ -26,6 +26,7 @@
 
 #include "utility.hpp"
 #include "d_vector.hpp"
+#include <atomic>
 #include <chrono>
 #include <cstdlib>
 #include <new>
@@ -34,6 +35,41 @@
 
 #include <fcntl.h>
 
+#ifdef HIPSPARSELT_CLIENTS_HIPBLASLT
+#include <hipblaslt/hipblaslt.h>
+#endif
+
+
+/* ============================================================================================ */
+// Count the host heap allocations of the process. The global operator new is replaced in the
+// client, so allocations made inside the library, on its worker threads too, are counted as well.
+namespace
+{
+    std::atomic<size_t> g_host_alloc_count{0};
+}
+
+size_t hipsparselt_host_alloc_count()
+{
+    return g_host_alloc_count.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size)
+{
+    g_host_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if(void* p = malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    free(p);
+}
 
 /* ============================================================================================ */
 // Return path of this executable
@@ -132,6 +168,241 @@ double get_time_us_no_sync(void)
     return (static_cast<double>(duration));
 };
 
+hipsparselt_call_timer::hipsparselt_call_timer(bool enabled, int calls)
+{
+    if(!enabled || calls <= 0)
+        return;
+    m_events.resize(2 * size_t(calls), nullptr);
+    for(auto& event : m_events)
+        if(hipEventCreate(&event) != hipSuccess)
+        {
+            hipsparselt_cerr << "Creating the events of the call timer failed" << std::endl;
+            break;
+        }
+}
+
+hipsparselt_call_timer::~hipsparselt_call_timer()
+{
+    for(auto event : m_events)
+        if(event != nullptr)
+            (void)hipEventDestroy(event);
+}
+
+void hipsparselt_call_timer::start(int call, hipStream_t stream)
+{
+    if(!m_events.empty() && hipEventRecord(m_events[2 * call], stream) != hipSuccess)
+        hipsparselt_cerr << "Recording the start of call " << call << " failed" << std::endl;
+}
+
+void hipsparselt_call_timer::stop(int call, hipStream_t stream)
+{
+    if(!m_events.empty() && hipEventRecord(m_events[2 * call + 1], stream) != hipSuccess)
+        hipsparselt_cerr << "Recording the end of call " << call << " failed" << std::endl;
+}
+
+std::vector<double> hipsparselt_call_timer::samples_us() const
+{
+    std::vector<double> samples;
+    for(size_t i = 0; i + 1 < m_events.size(); i += 2)
+    {
+        float ms = 0.0f;
+        if(hipEventElapsedTime(&ms, m_events[i], m_events[i + 1]) != hipSuccess)
+        {
+            hipsparselt_cerr << "Reading the time of call " << i / 2 << " failed" << std::endl;
+            return {};
+        }
+        samples.push_back(ms * 1000.0);
+    }
+    return samples;
+}
+
+/* ============================================================================================ */
+/*  dense GEMM of hipBLASLt the sparse matmuls are compared with */
+
+#ifdef HIPSPARSELT_CLIENTS_HIPBLASLT
+static hipDataType hipsparselt_dense_datatype(hipsparseLtDatatype_t type)
+{
+    switch(type)
+    {
+    case HIPSPARSELT_R_16F:
+        return HIP_R_16F;
+    case HIPSPARSELT_R_32F:
+        return HIP_R_32F;
+    case HIPSPARSELT_R_8I:
+        return HIP_R_8I;
+    case HIPSPARSELT_R_32I:
+        return HIP_R_32I;
+    case HIPSPARSELT_R_16BF:
+        return HIP_R_16BF;
+    case HIPSPARSELT_R_8F:
+        return HIP_R_8F_E4M3_FNUZ;
+    case HIPSPARSELT_R_8BF:
+        return HIP_R_8F_E5M2_FNUZ;
+    }
+    return HIP_R_32F;
+}
+
+double hipsparselt_dense_gemm_us(const hipsparselt_dense_gemm& gemm,
+                                 int                           cold_calls,
+                                 int                           hot_calls,
+                                 hipStream_t                   stream)
+{
+    // hipBLASLt picks among the algorithms which fit in this workspace
+    constexpr uint64_t workspace_size = uint64_t(128) << 20;
+
+    hipblasLtHandle_t           handle     = nullptr;
+    hipblasLtMatmulDesc_t       desc       = nullptr;
+    hipblasLtMatrixLayout_t     layouts[4] = {};
+    hipblasLtMatmulPreference_t pref       = nullptr;
+    void*                       workspace  = nullptr;
+    double                      us         = -1.0;
+
+    auto ok = [](hipblasStatus_t status) { return status == HIPBLAS_STATUS_SUCCESS; };
+
+    bool nA = gemm.transA == HIPSPARSE_OPERATION_NON_TRANSPOSE;
+    bool nB = gemm.transB == HIPSPARSE_OPERATION_NON_TRANSPOSE;
+
+    bool i32 = gemm.compute_type == HIPSPARSELT_COMPUTE_32I;
+
+    hipblasOperation_t   opA     = nA ? HIPBLAS_OP_N : HIPBLAS_OP_T;
+    hipblasOperation_t   opB     = nB ? HIPBLAS_OP_N : HIPBLAS_OP_T;
+    hipblasComputeType_t compute = i32 ? HIPBLAS_COMPUTE_32I : HIPBLAS_COMPUTE_32F;
+
+    hipsparseLtDatatype_t types[4]   = {gemm.a_type, gemm.b_type, gemm.c_type, gemm.d_type};
+    int64_t               rows[4]    = {nA ? gemm.m : gemm.k, nB ? gemm.k : gemm.n, gemm.m, gemm.m};
+    int64_t               cols[4]    = {nA ? gemm.k : gemm.m, nB ? gemm.n : gemm.k, gemm.n, gemm.n};
+    int64_t               lds[4]     = {gemm.lda, gemm.ldb, gemm.ldc, gemm.ldd};
+    int64_t               strides[4] = {gemm.stride_a, gemm.stride_b, gemm.stride_c, gemm.stride_d};
+
+    bool ready = ok(hipblasLtCreate(&handle))
+                 && ok(hipblasLtMatmulDescCreate(&desc, compute, HIP_R_32F))
+                 && ok(hipblasLtMatmulDescSetAttribute(
+                     desc, HIPBLASLT_MATMUL_DESC_TRANSA, &opA, sizeof(int32_t)))
+                 && ok(hipblasLtMatmulDescSetAttribute(
+                     desc, HIPBLASLT_MATMUL_DESC_TRANSB, &opB, sizeof(int32_t)))
+                 && ok(hipblasLtMatmulPreferenceCreate(&pref))
+                 && ok(hipblasLtMatmulPreferenceSetAttribute(
+                     pref, HIPBLASLT_MATMUL_PREF_MAX_WORKSPACE_BYTES, &workspace_size, 8))
+                 && hipMalloc(&workspace, workspace_size) == hipSuccess;
+    for(int i = 0; ready && i < 4; i++)
+        ready = ok(hipblasLtMatrixLayoutCreate(&layouts[i],
+                                               hipsparselt_dense_datatype(types[i]),
+                                               uint64_t(rows[i]),
+                                               uint64_t(cols[i]),
+                                               lds[i]))
+                && ok(hipblasLtMatrixLayoutSetAttribute(
+                    layouts[i], HIPBLASLT_MATRIX_LAYOUT_BATCH_COUNT, &gemm.batch_count, 4))
+                && ok(hipblasLtMatrixLayoutSetAttribute(
+                    layouts[i], HIPBLASLT_MATRIX_LAYOUT_STRIDED_BATCH_OFFSET, &strides[i], 8));
+
+    hipblasLtMatmulHeuristicResult_t heuristic = {};
+    int                              returned  = 0;
+    ready = ready
+            && ok(hipblasLtMatmulAlgoGetHeuristic(handle,
+                                                  desc,
+                                                  layouts[0],
+                                                  layouts[1],
+                                                  layouts[2],
+                                                  layouts[3],
+                                                  pref,
+                                                  1,
+                                                  &heuristic,
+                                                  &returned))
+            && returned > 0;
+
+    auto call = [&]() {
+        return ok(hipblasLtMatmul(handle,
+                                  desc,
+                                  &gemm.alpha,
+                                  gemm.A,
+                                  layouts[0],
+                                  gemm.B,
+                                  layouts[1],
+                                  &gemm.beta,
+                                  gemm.C,
+                                  layouts[2],
+                                  gemm.D,
+                                  layouts[3],
+                                  &heuristic.algo,
+                                  workspace,
+                                  heuristic.workspaceSize,
+                                  stream));
+    };
+    for(int i = 0; ready && i < cold_calls; i++)
+        ready = call();
+    if(ready && hipStreamSynchronize(stream) == hipSuccess && hot_calls > 0)
+    {
+        double start = get_time_us_sync(stream);
+        for(int i = 0; ready && i < hot_calls; i++)
+            ready = call();
+        double stop = get_time_us_sync(stream);
+        if(ready)
+            us = (stop - start) / hot_calls;
+    }
+
+    if(workspace)
+        (void)hipFree(workspace);
+    for(auto layout : layouts)
+        if(layout)
+            hipblasLtMatrixLayoutDestroy(layout);
+    if(pref)
+        hipblasLtMatmulPreferenceDestroy(pref);
+    if(desc)
+        hipblasLtMatmulDescDestroy(desc);
+    if(handle)
+        hipblasLtDestroy(handle);
+    return us;
+}
+#else
+double hipsparselt_dense_gemm_us(const hipsparselt_dense_gemm& gemm,
+                                 int                           cold_calls,
+                                 int                           hot_calls,
+                                 hipStream_t                   stream)
+{
+    return -1.0;
+}
+#endif
+
+/* ============================================================================================ */
+// Peak 2:4 sparse Gflops and GB/s of the device for the type of A, the ones of the arch table are
+// those of its largest part, 0 when unknown
+void hipsparselt_device_peaks(hipsparseLtDatatype_t type, double* gflops, double* gbps)
+{
+    // dense flops of a CU per clock for 16-bit, 8-bit integer and 8-bit float inputs, and GB/s
+    struct arch_peak
+    {
+        const char* arch;
+        int         f16, i8, f8;
+        double      gbps;
+    };
+    static const arch_peak peaks[] = {
+        {"gfx90a", 1024, 1024, 0, 1638.4},
+        {"gfx942", 2048, 4096, 4096, 5300.0},
+        {"gfx950", 4096, 8192, 8192, 8000.0},
+    };
+
+    *gflops = *gbps = 0.0;
+    int             device;
+    hipDeviceProp_t props;
+    if(hipGetDevice(&device) != hipSuccess || hipGetDeviceProperties(&props, device) != hipSuccess)
+        return;
+    std::string arch(props.gcnArchName);
+    arch = arch.substr(0, arch.find(':'));
+
+    for(const auto& peak : peaks)
+    {
+        if(arch != peak.arch)
+            continue;
+        int rate = type == HIPSPARSELT_R_16F || type == HIPSPARSELT_R_16BF ? peak.f16
+                   : type == HIPSPARSELT_R_8I                              ? peak.i8
+                   : type == HIPSPARSELT_R_8F || type == HIPSPARSELT_R_8BF ? peak.f8
+                                                                           : 0;
+        // clockRate in kHz, 2:4 sparsity doubles the dense rate
+        *gflops = 2.0 * rate * props.multiProcessorCount * props.clockRate / 1e6;
+        *gbps   = peak.gbps;
+    }
+}
+
 /* ============================================================================================ */
 /*  device query and print out their ID and name; return number of compute-capable devices. */
 int64_t query_device_property()
@@ -93,6 +93,8 @@ namespace
         static std::string name_suffix(const Arguments& arg)
         {
             RocSparseLt_TestName<compress_test> name(arg.name);
+            if(strstr(arg.name, "prune_and_compress") != nullptr)
+                name << (arg.prune_algo == HIPSPARSELT_PRUNE_SPMMA_TILE ? "tile_" : "strip_");
             name << hipsparselt_datatype_to_string(arg.a_type);
 
             if(strstr(arg.function, "_bad_arg") != nullptr)
@@ -120,7 +122,9 @@ namespace
 
     TEST_P(compress_test, conversion)
     {
+        hipsparselt_perf_start(GetParam());
         RUN_TEST_ON_THREADS_STREAMS(hipsparselt_spmm_dispatch<compress_testing>(GetParam()));
+        hipsparselt_perf_check(GetParam());
     }
     INSTANTIATE_TEST_CATEGORIES(compress_test);
 
@@ -29,7 +29,20 @@
 #include "hipsparselt_test.hpp"
 #include "test_cleanup.hpp"
 #include "utility.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 #include <string>
+#include <vector>
+#ifndef WIN32
+#include <fcntl.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
 
 using namespace testing;
 
@@ -215,8 +228,8 @@ static void hipsparselt_print_args(const std::string& args)
     hipsparselt_cout.flush();
 }
 
-// Device Query
-static void hipsparselt_set_test_device()
+// Device Query, returns the number of devices
+static int hipsparselt_set_test_device()
 {
     int device_id    = 0;
     int device_count = query_device_property();
@@ -227,7 +240,135 @@ static void hipsparselt_set_test_device()
         exit(-1);
     }
     set_device(device_id);
+    return device_count;
+}
+
+// Scan and remove the --parallel_devices option
+static bool hipsparselt_parse_parallel_devices(int& argc, char** argv)
+{
+    bool   parallel = false;
+    char** argv_p   = argv + 1;
+    for(int i = 1; argv[i]; ++i)
+    {
+        if(!strcmp(argv[i], "--parallel_devices"))
+            parallel = true;
+        else
+            *argv_p++ = argv[i];
+    }
+    *argv_p = nullptr;
+    argc    = argv_p - argv;
+    return parallel;
+}
+
+#ifndef WIN32
+// Run the tests in one worker process per device, each worker sees its device alone and runs
+// the gtest shard of its index. All workers generate the same tests from the same data and the
+// same known_bug categories, so the sharding is deterministic. The logs of the workers are
+// printed in the order of the devices once all are done, followed by the merged results.
+static int hipsparselt_run_parallel_devices(char** argv, int device_count)
+{
+    // the devices of the workers are the visible devices of this process
+    std::vector<std::string> devices;
+    const char*              visible = getenv("HIP_VISIBLE_DEVICES");
+    if(!visible)
+        visible = getenv("CUDA_VISIBLE_DEVICES");
+    if(visible)
+    {
+        std::istringstream list(visible);
+        for(std::string device; std::getline(list, device, ',');)
+            devices.push_back(device);
+        devices.resize(std::min<size_t>(devices.size(), device_count));
+    }
+    else
+    {
+        for(int i = 0; i < device_count; i++)
+            devices.push_back(std::to_string(i));
+    }
+
+    // the environment of the workers, without the variables set for each of them
+    std::vector<std::string> base_env;
+    for(char** e = environ; *e; ++e)
+        if(strncmp(*e, "HIP_VISIBLE_DEVICES=", 20) && strncmp(*e, "CUDA_VISIBLE_DEVICES=", 21)
+           && strncmp(*e, "GTEST_TOTAL_SHARDS=", 19) && strncmp(*e, "GTEST_SHARD_INDEX=", 18))
+            base_env.push_back(*e);
+
+    size_t                   shards = devices.size();
+    std::vector<pid_t>       pids(shards, -1);
+    std::vector<std::string> logs(shards);
+    for(size_t i = 0; i < shards; i++)
+    {
+        std::vector<std::string> env = base_env;
+        env.push_back("HIP_VISIBLE_DEVICES=" + devices[i]);
+        env.push_back("CUDA_VISIBLE_DEVICES=" + devices[i]);
+        env.push_back("GTEST_TOTAL_SHARDS=" + std::to_string(shards));
+        env.push_back("GTEST_SHARD_INDEX=" + std::to_string(i));
+        std::vector<char*> envp;
+        for(auto& e : env)
+            envp.push_back(&e[0]);
+        envp.push_back(nullptr);
+
+        logs[i] = hipsparselt_tempname();
+        posix_spawn_file_actions_t actions;
+        posix_spawn_file_actions_init(&actions);
+        posix_spawn_file_actions_addopen(
+            &actions, STDOUT_FILENO, logs[i].c_str(), O_WRONLY | O_TRUNC, 0);
+        posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+        if(posix_spawn(&pids[i], "/proc/self/exe", &actions, nullptr, argv, envp.data()))
+        {
+            hipsparselt_cerr << "Error: cannot start the worker of device " << devices[i]
+                             << std::endl;
+            pids[i] = -1;
+        }
+        posix_spawn_file_actions_destroy(&actions);
+    }
+
+    int                      status = 0;
+    size_t                   passed = 0;
+    std::vector<std::string> failed;
+    for(size_t i = 0; i < shards; i++)
+    {
+        int worker_status = -1;
+        if(pids[i] == -1 || waitpid(pids[i], &worker_status, 0) == -1 || !WIFEXITED(worker_status)
+           || WEXITSTATUS(worker_status))
+            status = EXIT_FAILURE;
+
+        hipsparselt_cout << "[ DEVICE   ] " << devices[i] << ", shard " << i << " of " << shards
+                         << std::endl;
+        // the failed tests are taken from the list closing the log of the worker
+        std::ifstream log(logs[i]);
+        bool          listing = false;
+        for(std::string line; std::getline(log, line);)
+        {
+            hipsparselt_cout << line << '\n';
+
+            size_t tests;
+            bool   failure = !line.compare(0, 13, "[  FAILED  ] ");
+            if(sscanf(line.c_str(), "[  PASSED  ] %zu test", &tests) == 1)
+                passed += tests;
+            else if(failure && line.find(", listed below:") != line.npos)
+                listing = true;
+            else if(failure && listing)
+                failed.push_back(line.substr(13));
+            else
+                listing = false;
+        }
+        log.close();
+        remove(logs[i].c_str());
+    }
+
+    hipsparselt_cout << "[==========] " << shards << " devices ran their shards." << std::endl;
+    hipsparselt_cout << "[  PASSED  ] " << passed << " tests." << std::endl;
+    if(failed.size())
+    {
+        hipsparselt_cout << "[  FAILED  ] " << failed.size() << " tests, listed below:"
+                         << std::endl;
+        for(auto& name : failed)
+            hipsparselt_cout << "[  FAILED  ] " << name << std::endl;
+    }
+    hipsparselt_cout.flush();
+    return status;
 }
+#endif
 
 /*****************
  * Main function *
@@ -242,7 +383,20 @@ int main(int argc, char** argv)
     hipsparselt_print_version();
 
     // Set test device
-    hipsparselt_set_test_device();
+    bool parallel_devices = hipsparselt_parse_parallel_devices(argc, argv);
+    int  device_count     = hipsparselt_set_test_device();
+
+    // --parallel_devices shards the tests across all the visible devices
+    if(parallel_devices && device_count > 1)
+    {
+#ifndef WIN32
+        int status = hipsparselt_run_parallel_devices(argv, device_count);
+        hipsparselt_print_args(args);
+        return status;
+#else
+        hipsparselt_cerr << "--parallel_devices is not supported on Windows" << std::endl;
+#endif
+    }
 
     hipsparselt_print_usage_warning();
 
@@ -24,11 +24,14 @@
  *
  *******************************************************************************/
 #include "hipsparselt_test.hpp"
+#include "utility.hpp"
 #include <cerrno>
 #include <csetjmp>
 #include <csignal>
 #include <cstdlib>
 #include <exception>
+#include <fstream>
+#include <map>
 #include <regex>
 #include <string.h>
 #ifdef WIN32
@@ -351,7 +354,7 @@ std::string RocSparseLt_TestName_to_string(std::unordered_map<std::string, size_
 }
 
 static const char* const validCategories[]
-    = {"quick", "pre_checkin", "nightly", "multi_gpu", "HMM", "known_bug", NULL};
+    = {"quick", "pre_checkin", "nightly", "multi_gpu", "HMM", "known_bug", "perf", NULL};
 
 static bool valid_category(const char* category)
 {
@@ -410,3 +413,104 @@ bool match_test_category(const Arguments& arg, const char* category)
 
     return true;
 }
+
+/*********************************************************************************************
+ * The perf tests, whose median time is checked against the baseline of the GPU platform     *
+ *********************************************************************************************/
+static bool is_perf_test(const Arguments& arg)
+{
+    // a known bug of the platform is not checked
+    return !strcmp(arg.category, "perf") && arg.timing;
+}
+
+void hipsparselt_perf_start(const Arguments& arg)
+{
+    if(is_perf_test(arg))
+    {
+        ArgumentModel_set_record_samples(true);
+        ArgumentModel_set_last_median_us(-1);
+    }
+}
+
+// The baselines of the platform, read once from <dir>/<arch>.csv as lines of "name,value", the
+// directory is $HIPSPARSELT_PERF_BASELINES or hipsparselt_perf_baselines next to the executable
+static const std::map<std::string, double>& perf_baselines(std::string& file)
+{
+    static std::string                   path;
+    static std::map<std::string, double> baselines = [] {
+        std::map<std::string, double> values;
+        const char*                   dir = getenv("HIPSPARSELT_PERF_BASELINES");
+        char*                         archName;
+        if(hipsparseLtGetArchName(&archName) != HIPSPARSE_STATUS_SUCCESS)
+            return values;
+        path = (dir && *dir ? std::string(dir) + "/"
+                            : hipsparselt_exepath() + "hipsparselt_perf_baselines/")
+               + archName + ".csv";
+        free(archName);
+
+        std::ifstream in(path);
+        std::string   line;
+        while(std::getline(in, line))
+        {
+            auto comma = line.find(',');
+            if(line.empty() || line[0] == '#' || comma == std::string::npos)
+                continue;
+            values[line.substr(0, comma)] = atof(line.c_str() + comma + 1);
+        }
+        return values;
+    }();
+    file = path;
+    return baselines;
+}
+
+void hipsparselt_perf_check(const Arguments& arg)
+{
+    if(!is_perf_test(arg))
+        return;
+    ArgumentModel_set_record_samples(false);
+    if(testing::Test::IsSkipped() || testing::Test::HasFatalFailure())
+        return;
+
+    // the name of the parameters of the test, the same on every platform
+    std::string name = testing::UnitTest::GetInstance()->current_test_info()->name();
+    name             = name.substr(name.rfind('/') + 1);
+
+    // the median time in us, TFLOPS when the test counts its flops, GB/s otherwise
+    double median_us = ArgumentModel_get_last_median_us();
+    double gflops    = ArgumentModel_get_last_gflops();
+    double gbytes    = ArgumentModel_get_last_gbytes();
+    bool   tflops    = gflops != ArgumentLogging::NA_value;
+    if(median_us == ArgumentLogging::NA_value || median_us <= 0
+       || (!tflops && gbytes == ArgumentLogging::NA_value))
+    {
+        ADD_FAILURE() << "perf test " << name << " has no median time to check";
+        return;
+    }
+    double      measured = tflops ? gflops / median_us * 1e3 : gbytes / median_us * 1e6;
+    const char* unit     = tflops ? "TFLOPS" : "GB/s";
+
+    // $HIPSPARSELT_PERF_RECORD appends the measured values, to make or update a baseline file
+    static std::mutex record_mutex;
+    if(const char* record = getenv("HIPSPARSELT_PERF_RECORD"))
+    {
+        std::lock_guard<std::mutex> lock(record_mutex);
+        std::ofstream(record, std::ios::app) << name << "," << measured << "\n";
+    }
+
+    std::string file;
+    const auto& baselines = perf_baselines(file);
+    auto        baseline  = baselines.find(name);
+    if(baseline == baselines.end())
+    {
+        hipsparselt_cout << "perf: " << measured << " " << unit << ", no baseline in " << file
+                         << std::endl;
+        return;
+    }
+
+    double expected = baseline->second * (1 - arg.perf_tolerance);
+    hipsparselt_cout << "perf: " << measured << " " << unit << ", baseline " << baseline->second
+                     << " " << unit << ", tolerance " << arg.perf_tolerance << std::endl;
+    EXPECT_GE(measured, expected) << "perf test " << name << " regressed: " << measured << " "
+                                  << unit << " against the baseline of " << baseline->second
+                                  << " " << unit << " of " << file;
+}
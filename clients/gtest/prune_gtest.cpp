@@ -133,7 +133,9 @@ namespace
 
     TEST_P(prune_test, conversion)
     {
+        hipsparselt_perf_start(GetParam());
         RUN_TEST_ON_THREADS_STREAMS(hipsparselt_spmm_dispatch<prune_testing>(GetParam()));
+        hipsparselt_perf_check(GetParam());
     }
     INSTANTIATE_TEST_CATEGORIES(prune_test);
 
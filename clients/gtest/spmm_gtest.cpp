@@ -56,7 +56,12 @@ namespace
         Tc,
         TBias,
         std::enable_if_t<std::is_same<Ti, __half>{} || std::is_same<Ti, hip_bfloat16>{}
-                         || std::is_same<Ti, int8_t>{}>> : hipsparselt_test_valid
+                         || std::is_same<Ti, int8_t>{}
+#if defined(__HIP_PLATFORM_AMD__)
+                         || std::is_same<Ti, __hip_fp8_e4m3_fnuz>{}
+                         || std::is_same<Ti, __hip_fp8_e5m2_fnuz>{}
+#endif
+                         >> : hipsparselt_test_valid
     {
         void operator()(const Arguments& arg)
         {
@@ -70,6 +75,16 @@ namespace
                 testing_spmm_bad_arg<Ti, To, Tc>(arg);
             else if(!strcmp(arg.function, "aux_plan_assign"))
                 testing_aux_plan_assign<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "aux_config_cache"))
+                testing_aux_config_cache<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "aux_code_object_stats"))
+                testing_aux_code_object_stats<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "aux_mixed_input"))
+                testing_aux_mixed_input<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "aux_plan_serialize"))
+                testing_aux_plan_serialize<Ti, To, Tc>(arg);
+            else if(!strcmp(arg.function, "aux_plan_init_async"))
+                testing_aux_plan_init_async<Ti, To, Tc>(arg);
             else
                 FAIL() << "Internal error: Test called with unknown function: " << arg.function;
         }
@@ -89,7 +104,12 @@ namespace
             return !strcmp(arg.function, "spmm") || !strcmp(arg.function, "spmm_batched")
                    || !strcmp(arg.function, "spmm_strided_batched")
                    || !strcmp(arg.function, "spmm_bad_arg")
-                   || !strcmp(arg.function, "aux_plan_assign");
+                   || !strcmp(arg.function, "aux_plan_assign")
+                   || !strcmp(arg.function, "aux_config_cache")
+                   || !strcmp(arg.function, "aux_code_object_stats")
+                   || !strcmp(arg.function, "aux_mixed_input")
+                   || !strcmp(arg.function, "aux_plan_serialize")
+                   || !strcmp(arg.function, "aux_plan_init_async");
         }
 
         // Google Test name suffix based on parameters
@@ -111,6 +131,102 @@ namespace
 
                 name << '_' << (arg.sparse_b ? "SB" : "SA");
 
+                if(arg.search_async)
+                    name << "_search_async";
+
+                if(arg.search_flush_cache)
+                    name << "_search_flush_cache";
+
+                if(arg.search_dense)
+                    name << "_search_dense";
+
+                if(arg.split_k)
+                    name << "_split_k" << arg.split_k;
+
+                if(arg.stream_k)
+                    name << "_stream_k";
+
+                if(arg.alpha_vector_scaling)
+                    name << "_alpha_vector_scaling";
+
+                if(arg.scale_a != 1 || arg.scale_b != 1)
+                    name << "_scale_" << arg.scale_a << "_" << arg.scale_b;
+
+                if(arg.d_scale != 1)
+                    name << "_d_scale_" << arg.d_scale;
+
+                if(arg.d_saturate)
+                    name << "_d_saturate";
+
+                if(arg.amax_d)
+                    name << "_amax_d";
+
+                if(arg.residual)
+                    name << "_residual";
+
+                if(arg.gate)
+                    name << "_gate";
+
+                if(arg.bias_grad)
+                    name << "_bias_grad";
+
+                if(arg.sparse_dynamic)
+                    name << "_sparse_dynamic";
+
+                if(arg.graph)
+                    name << "_graph";
+
+                if(arg.grouped)
+                    name << "_grouped";
+
+                if(arg.sharded)
+                    name << "_sharded";
+
+                if(arg.pointer_array)
+                    name << "_pointer_array";
+
+                if(arg.plan_threads > 1)
+                    name << "_plan_threads_" << arg.plan_threads;
+
+                if(arg.cu_count > 0)
+                    name << "_cu_count_" << arg.cu_count;
+
+                if(arg.candidates > 0)
+                    name << "_candidates_" << arg.candidates;
+
+                if(arg.dynamic_n > 0)
+                    name << "_dynamic_n_" << arg.dynamic_n;
+
+                if(arg.workspace_pool)
+                    name << "_workspace_pool";
+
+                if(arg.plan_stats)
+                    name << "_plan_stats";
+
+                if(arg.rotating > 0)
+                    name << "_rotating_" << arg.rotating;
+
+                if(arg.flush)
+                    name << "_flush";
+
+                if(arg.bench_threads > 1)
+                    name << "_bench_threads_" << arg.bench_threads;
+
+                if(arg.thread_plans)
+                    name << "_thread_plans";
+
+                if(arg.compare_dense)
+                    name << "_compare_dense";
+
+                if(arg.device_reference)
+                    name << "_device_reference";
+
+                if(arg.device_init)
+                    name << "_device_init";
+
+                if(arg.streams > 1)
+                    name << "_streams_" << arg.streams;
+
                 if(arg.activation_type != hipsparselt_activation_type::none)
                 {
                     name << '_' << hipsparselt_activation_type_to_string(arg.activation_type);
@@ -118,6 +234,7 @@ namespace
                     {
                     case hipsparselt_activation_type::clippedrelu:
                     case hipsparselt_activation_type::tanh:
+                    case hipsparselt_activation_type::clamp:
                         name << '_' << arg.activation_arg1 << '_' << arg.activation_arg2;
                         break;
                     case hipsparselt_activation_type::leakyrelu:
@@ -154,7 +271,9 @@ namespace
 
     TEST_P(spmm_test, spmm)
     {
+        hipsparselt_perf_start(GetParam());
         RUN_TEST_ON_THREADS_STREAMS(hipsparselt_spmm_dispatch<spmm_testing>(GetParam()));
+        hipsparselt_perf_check(GetParam());
     }
     INSTANTIATE_TEST_CATEGORIES(spmm_test);
 
@@ -27,6 +27,8 @@
 #pragma once
 
 #include "hipsparselt_arguments.hpp"
+#include <string>
+#include <vector>
 
 namespace ArgumentLogging
 {
@@ -36,6 +38,43 @@ namespace ArgumentLogging
 void ArgumentModel_set_log_function_name(bool f);
 bool ArgumentModel_get_log_function_name();
 
+// The time in us, the GFlop and the GB of a hot call of the last timed run, for the replay and
+// the sweep of hipsparselt-bench
+void   ArgumentModel_set_last_perf(double gpu_us, double gflops, double gbytes);
+double ArgumentModel_get_last_gpu_us();
+double ArgumentModel_get_last_gflops();
+double ArgumentModel_get_last_gbytes();
+
+// The time in us of a call of the dense GEMM the last timed run was compared with
+void   ArgumentModel_set_last_dense_us(double dense_us);
+double ArgumentModel_get_last_dense_us();
+
+// The peak GB/s the bandwidth of a run is a percentage of, the one of the device when not set or
+// 0, and 0 when the arch of the device is not known
+void   ArgumentModel_set_peak_gbps(double gbps);
+double ArgumentModel_get_peak_gbps();
+
+// The file the time of each hot call is summarized into, as JSON lines when its name ends with
+// .json and as CSV otherwise; without a file the time of each call is not recorded
+void ArgumentModel_set_samples_file(const std::string& file);
+bool ArgumentModel_get_samples();
+
+// Time each hot call even without a samples file, for the median of the perf tests
+void ArgumentModel_set_record_samples(bool record);
+
+// The median time in us of the hot calls of the last run whose calls were timed one by one,
+// ArgumentLogging::NA_value when there is none; set to NA_value with a negative median
+void   ArgumentModel_set_last_median_us(double median_us);
+double ArgumentModel_get_last_median_us();
+
+// Print the min, median, p90, p99, mean and stddev in us of the hot calls of arg and append them to
+// the samples file with the config id and the kernel name of the plan (-1 and "" when none); the
+// median is kept as the last median also when only the samples are recorded
+void ArgumentModel_log_samples(const Arguments&    arg,
+                               std::vector<double> samples_us,
+                               int                 config_id,
+                               const std::string&  kernel_name);
+
 // ArgumentModel template has a variadic list of argument enums
 template <hipsparselt_argument... Args>
 class ArgumentModel
@@ -71,6 +110,11 @@ public:
         if(hot_calls > 1)
             gpu_us /= hot_calls;
 
+        ArgumentModel_set_last_perf(
+            gpu_us,
+            gflops == ArgumentLogging::NA_value ? gflops : gflops * batch_count,
+            gbytes == ArgumentLogging::NA_value ? gbytes : gbytes * batch_count);
+
         // per/us to per/sec *10^6
         double hipsparselt_gflops = gflops * batch_count / gpu_us * 1e6;
         double hipsparselt_GBps   = gbytes * batch_count / gpu_us * 1e6;
@@ -87,6 +131,14 @@ public:
             // GB/s not usually reported for non-memory bound functions
             name_line << ",hipsparselt-GB/s";
             val_line << ", " << hipsparselt_GBps;
+
+            // the share of the peak bandwidth, for the functions bound by it
+            double peak_gbps = ArgumentModel_get_peak_gbps();
+            if(peak_gbps > 0.0)
+            {
+                name_line << ",%peak-GB/s";
+                val_line << ", " << hipsparselt_GBps / peak_gbps * 100.0;
+            }
         }
 
         name_line << ",us";
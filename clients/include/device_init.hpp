@@ -0,0 +1,156 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+
+/*!\file
+ * \brief matrix initialization on the device, with the values of hipsparselt_init.hpp: the trig
+ * modes give the same matrices as the host, the random modes the same distributions, drawn from a
+ * counter based generator whose seed is the next number of t_hipsparselt_rng.
+ */
+
+#include "hipsparselt_random.hpp"
+#include <algorithm>
+#include <cmath>
+#include <hip/hip_runtime.h>
+#include <hipsparselt/hipsparselt.h>
+#include <type_traits>
+
+enum class hipsparselt_device_init_mode
+{
+    rand_int, // the values of hipsparselt_init
+    rand_int_alternating_sign, // the values of hipsparselt_init_alternating_sign
+    sin, // the values of hipsparselt_init_sin
+    cos, // the values of hipsparselt_init_cos
+    hpl, // the values of hipsparselt_init_hpl
+};
+
+// 64 random bits of an element, splitmix64 of its position in the matrices and the seed
+__device__ inline uint64_t hipsparselt_device_random_bits(uint64_t seed, uint64_t pos)
+{
+    uint64_t z = seed + (pos + 1) * 0x9e3779b97f4a7c15ull;
+    z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z          = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+// the value random_generator<T>() would draw: 1 to 10 for float, 1 to 3 for int8, -2 to 2 for the
+// types of 16 and 8 bits
+template <typename T>
+__device__ inline float hipsparselt_device_random_int(uint64_t bits)
+{
+    if constexpr(std::is_same<T, float>{} || std::is_same<T, double>{})
+        return float(1 + bits % 10);
+    else if constexpr(std::is_same<T, int8_t>{})
+        return float(1 + bits % 3);
+    else
+        return float(int(bits % 5) - 2);
+}
+
+// the value random_hpl_generator<T>() would draw: [-0.5, 0.5], -1 to 1 for int8
+template <typename T>
+__device__ inline float hipsparselt_device_random_hpl(uint64_t bits)
+{
+    double u = double(bits >> 11) * 0x1.0p-53;
+    if constexpr(std::is_same<T, int8_t>{})
+        return float(rint(u * 2.0 - 1.0));
+    else
+        return float(u - 0.5);
+}
+
+template <typename T>
+__global__ void hipsparselt_device_init_kernel(T*                           A,
+                                               int64_t                      m,
+                                               int64_t                      n,
+                                               int64_t                      lda,
+                                               int64_t                      stride,
+                                               hipsparselt_device_init_mode mode,
+                                               uint64_t                     seed)
+{
+    for(int64_t idx = int64_t(blockIdx.x) * blockDim.x + threadIdx.x; idx < m * n;
+        idx += int64_t(gridDim.x) * blockDim.x)
+    {
+        int64_t  i    = idx % m;
+        int64_t  j    = idx / m;
+        int64_t  pos  = i + j * lda + int64_t(blockIdx.y) * stride;
+        uint64_t bits = hipsparselt_device_random_bits(seed, pos);
+        float    value;
+        switch(mode)
+        {
+        case hipsparselt_device_init_mode::rand_int:
+            value = hipsparselt_device_random_int<T>(bits);
+            break;
+        case hipsparselt_device_init_mode::rand_int_alternating_sign:
+            value = hipsparselt_device_random_int<T>(bits);
+            value = (i ^ j) & 1 ? value : -value;
+            break;
+        case hipsparselt_device_init_mode::sin:
+            value = float(::sin(double(pos)));
+            break;
+        case hipsparselt_device_init_mode::cos:
+            value = float(::cos(double(pos)));
+            break;
+        default:
+            value = hipsparselt_device_random_hpl<T>(bits);
+            break;
+        }
+        A[pos] = static_cast<T>(value);
+    }
+}
+
+/*! \brief  Initializes batch_count matrices of M x N at stride on the device, nothing is copied
+ *          from or to the host */
+template <typename T>
+hipError_t hipsparselt_init_device(T*                           A,
+                                   size_t                       M,
+                                   size_t                       N,
+                                   size_t                       lda,
+                                   size_t                       stride,
+                                   size_t                       batch_count,
+                                   hipsparselt_device_init_mode mode,
+                                   hipStream_t                  stream)
+{
+    // the seed follows the host generator, so a seeded run draws the same matrices
+    uint64_t seed = (uint64_t(t_hipsparselt_rng()) << 32) | t_hipsparselt_rng();
+    if(M == 0 || N == 0 || batch_count == 0)
+        return hipSuccess;
+
+    constexpr int threads = 256;
+    size_t        blocks  = std::min<size_t>((M * N + threads - 1) / threads, 4096);
+    hipLaunchKernelGGL((hipsparselt_device_init_kernel<T>),
+                       dim3(blocks, batch_count),
+                       dim3(threads),
+                       0,
+                       stream,
+                       A,
+                       int64_t(M),
+                       int64_t(N),
+                       int64_t(lda),
+                       int64_t(stride),
+                       mode,
+                       seed);
+    return hipGetLastError();
+}
@@ -0,0 +1,343 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+
+/*!\file
+ * \brief the reference of the matmuls computed on the device, for the sizes the host reference
+ * takes minutes on: a tiled GEMM of the decompressed matrices, and a comparison of a D with it
+ * which counts the elements the unit check would reject and sums the Frobenius norm error.
+ */
+
+#include "device_vector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <hip/hip_runtime.h>
+#include <hipsparselt/hipsparselt.h>
+#include <type_traits>
+#include <vector>
+
+constexpr int hipsparselt_reference_tile = 16;
+
+// the value of an element of a matrix in double
+template <typename T>
+__device__ inline double hipsparselt_reference_value(T x)
+{
+    if constexpr(std::is_integral<T>{})
+        return static_cast<double>(x);
+    else
+        return static_cast<double>(static_cast<float>(x));
+}
+
+// the element of D of a value, the integers are rounded and saturated as the host reference does
+template <typename To>
+__device__ inline To hipsparselt_reference_cast(double x)
+{
+    if constexpr(std::is_same<To, int8_t>{})
+        return static_cast<To>(fmin(fmax(rint(x), -128.0), 127.0));
+    else if constexpr(std::is_same<To, int32_t>{})
+        return static_cast<To>(fmin(fmax(rint(x), -2147483648.0), 2147483647.0));
+    else
+        return static_cast<To>(static_cast<float>(x));
+}
+
+// D = alpha op(A) op(B) + beta C, a block computes a tile of D of a batch, the int8 products are
+// summed exactly in int32 and the others in float
+template <typename Ti, typename To, typename Tacc>
+__global__ __launch_bounds__(hipsparselt_reference_tile* hipsparselt_reference_tile) void
+    hipsparselt_reference_gemm_kernel(bool      transA,
+                                      bool      transB,
+                                      int64_t   m,
+                                      int64_t   n,
+                                      int64_t   k,
+                                      float     alpha,
+                                      const Ti* A,
+                                      int64_t   lda,
+                                      int64_t   stride_a,
+                                      const Ti* B,
+                                      int64_t   ldb,
+                                      int64_t   stride_b,
+                                      float     beta,
+                                      const To* C,
+                                      int64_t   ldc,
+                                      int64_t   stride_c,
+                                      To*       D,
+                                      int64_t   ldd,
+                                      int64_t   stride_d)
+{
+    constexpr int TILE = hipsparselt_reference_tile;
+    __shared__ Tacc sA[TILE][TILE + 1];
+    __shared__ Tacc sB[TILE][TILE + 1];
+
+    int     tx  = threadIdx.x;
+    int     ty  = threadIdx.y;
+    int64_t row = int64_t(blockIdx.x) * TILE + tx;
+    int64_t col = int64_t(blockIdx.y) * TILE + ty;
+    A += blockIdx.z * stride_a;
+    B += blockIdx.z * stride_b;
+    C += blockIdx.z * stride_c;
+    D += blockIdx.z * stride_d;
+
+    Tacc sum = 0;
+    for(int64_t k0 = 0; k0 < k; k0 += TILE)
+    {
+        // sA[ty][tx] is A(row, k0 + ty) and sB[ty][tx] is B(k0 + tx, col)
+        int64_t ka = k0 + ty;
+        int64_t kb = k0 + tx;
+        sA[ty][tx] = row < m && ka < k
+                         ? static_cast<Tacc>(transA ? A[ka + row * lda] : A[row + ka * lda])
+                         : Tacc(0);
+        sB[ty][tx] = kb < k && col < n
+                         ? static_cast<Tacc>(transB ? B[col + kb * ldb] : B[kb + col * ldb])
+                         : Tacc(0);
+        __syncthreads();
+        for(int kk = 0; kk < TILE; kk++)
+            sum += sA[kk][tx] * sB[ty][kk];
+        __syncthreads();
+    }
+
+    if(row < m && col < n)
+    {
+        double d = double(alpha) * double(sum);
+        if(beta != 0)
+            d += double(beta) * hipsparselt_reference_value(C[row + col * ldc]);
+        D[row + col * ldd] = hipsparselt_reference_cast<To>(d);
+    }
+}
+
+/*! \brief  D = alpha op(A) op(B) + beta C of batch_count column major matrices on stream */
+template <typename Ti, typename To>
+hipError_t hipsparselt_reference_gemm(hipsparseOperation_t transA,
+                                      hipsparseOperation_t transB,
+                                      int64_t              m,
+                                      int64_t              n,
+                                      int64_t              k,
+                                      float                alpha,
+                                      const Ti*            A,
+                                      int64_t              lda,
+                                      int64_t              stride_a,
+                                      const Ti*            B,
+                                      int64_t              ldb,
+                                      int64_t              stride_b,
+                                      float                beta,
+                                      const To*            C,
+                                      int64_t              ldc,
+                                      int64_t              stride_c,
+                                      To*                  D,
+                                      int64_t              ldd,
+                                      int64_t              stride_d,
+                                      int                  batch_count,
+                                      hipStream_t          stream)
+{
+    using Tacc         = std::conditional_t<std::is_same<Ti, int8_t>{}, int32_t, float>;
+    constexpr int TILE = hipsparselt_reference_tile;
+    if(m <= 0 || n <= 0 || batch_count <= 0)
+        return hipSuccess;
+    dim3 grid((m + TILE - 1) / TILE, (n + TILE - 1) / TILE, batch_count);
+    dim3 block(TILE, TILE);
+    hipLaunchKernelGGL((hipsparselt_reference_gemm_kernel<Ti, To, Tacc>),
+                       grid,
+                       block,
+                       0,
+                       stream,
+                       transA != HIPSPARSE_OPERATION_NON_TRANSPOSE,
+                       transB != HIPSPARSE_OPERATION_NON_TRANSPOSE,
+                       m,
+                       n,
+                       k,
+                       alpha,
+                       A,
+                       lda,
+                       stride_a,
+                       B,
+                       ldb,
+                       stride_b,
+                       beta,
+                       C,
+                       ldc,
+                       stride_c,
+                       D,
+                       ldd,
+                       stride_d);
+    return hipGetLastError();
+}
+
+// the largest |a - b| / (|a| + |b| + 1) the unit check accepts, 0 for an exact match
+template <typename Ti, typename To>
+constexpr double hipsparselt_reference_tolerance()
+{
+    if constexpr(std::is_same<To, __half>{})
+        return 0.01;
+    else if constexpr(std::is_same<To, hip_bfloat16>{})
+        return 0.1;
+    else if constexpr(std::is_same<To, float>{})
+        return std::is_same<Ti, hip_bfloat16>{} ? 0.01 : 1e-6;
+    else
+        return 0.0;
+}
+
+constexpr int hipsparselt_reference_check_threads = 256;
+
+// a block sums the squares of the reference and of the error of a part of a batch, and counts
+// the elements out of tolerance or NaN in only one of the two
+template <typename To>
+__global__ __launch_bounds__(hipsparselt_reference_check_threads) void
+    hipsparselt_reference_check_kernel(int64_t             m,
+                                       int64_t             n,
+                                       int64_t             ld,
+                                       int64_t             stride,
+                                       const To*           gold,
+                                       const To*           D,
+                                       double              tolerance,
+                                       unsigned long long* mismatches,
+                                       double*             squares)
+{
+    constexpr int THREADS = hipsparselt_reference_check_threads;
+    __shared__ double s_gold[THREADS];
+    __shared__ double s_error[THREADS];
+    __shared__ unsigned long long s_bad[THREADS];
+
+    gold += blockIdx.y * stride;
+    D += blockIdx.y * stride;
+
+    double             gold_sq = 0.0, error_sq = 0.0;
+    unsigned long long bad = 0;
+    for(int64_t i = int64_t(blockIdx.x) * THREADS + threadIdx.x; i < m * n;
+        i += int64_t(gridDim.x) * THREADS)
+    {
+        int64_t row = i % m;
+        int64_t col = i / m;
+        double  g   = hipsparselt_reference_value(gold[row + col * ld]);
+        double  d   = hipsparselt_reference_value(D[row + col * ld]);
+        if(isnan(g) || isnan(d))
+        {
+            bad += isnan(g) != isnan(d);
+            continue;
+        }
+        double error = fabs(d - g);
+        gold_sq += g * g;
+        error_sq += error * error;
+        if(tolerance == 0.0 ? error != 0.0 : error >= tolerance * (fabs(g) + fabs(d) + 1.0))
+            bad++;
+    }
+
+    s_gold[threadIdx.x]  = gold_sq;
+    s_error[threadIdx.x] = error_sq;
+    s_bad[threadIdx.x]   = bad;
+    __syncthreads();
+    for(int width = THREADS / 2; width > 0; width /= 2)
+    {
+        if(threadIdx.x < width)
+        {
+            s_gold[threadIdx.x] += s_gold[threadIdx.x + width];
+            s_error[threadIdx.x] += s_error[threadIdx.x + width];
+            s_bad[threadIdx.x] += s_bad[threadIdx.x + width];
+        }
+        __syncthreads();
+    }
+    if(threadIdx.x == 0)
+    {
+        atomicAdd(&squares[2 * blockIdx.y], s_gold[0]);
+        atomicAdd(&squares[2 * blockIdx.y + 1], s_error[0]);
+        atomicAdd(mismatches, s_bad[0]);
+    }
+}
+
+/*! \brief  Compares batch_count matrices D of the device with their reference gold: mismatches
+ *          gets the number of elements the unit check rejects, norm_error the sum over the
+ *          batches of the relative Frobenius norm of the error, as norm_check_general does */
+template <typename Ti, typename To>
+hipError_t hipsparselt_reference_check(int64_t     m,
+                                       int64_t     n,
+                                       int64_t     ld,
+                                       int64_t     stride,
+                                       const To*   gold,
+                                       const To*   D,
+                                       int         batch_count,
+                                       hipStream_t stream,
+                                       int64_t*    mismatches,
+                                       double*     norm_error)
+{
+    *mismatches = 0;
+    *norm_error = 0.0;
+    if(m <= 0 || n <= 0 || batch_count <= 0)
+        return hipSuccess;
+
+    device_vector<unsigned long long> d_mismatches(1);
+    device_vector<double>             d_squares(2 * size_t(batch_count));
+    hipError_t                        err = d_mismatches.memcheck();
+    if(err == hipSuccess)
+        err = d_squares.memcheck();
+    if(err == hipSuccess)
+        err = hipMemsetAsync(d_mismatches, 0, sizeof(unsigned long long), stream);
+    if(err == hipSuccess)
+        err = hipMemsetAsync(d_squares, 0, sizeof(double) * 2 * batch_count, stream);
+    if(err != hipSuccess)
+        return err;
+
+    // enough blocks to fill the device, each thread then loops over a few elements
+    int64_t blocks = std::min<int64_t>((m * n + hipsparselt_reference_check_threads - 1)
+                                           / hipsparselt_reference_check_threads,
+                                       1024);
+    hipLaunchKernelGGL((hipsparselt_reference_check_kernel<To>),
+                       dim3(blocks, batch_count),
+                       dim3(hipsparselt_reference_check_threads),
+                       0,
+                       stream,
+                       m,
+                       n,
+                       ld,
+                       stride,
+                       gold,
+                       D,
+                       hipsparselt_reference_tolerance<Ti, To>(),
+                       d_mismatches,
+                       d_squares);
+    if((err = hipGetLastError()) != hipSuccess)
+        return err;
+
+    unsigned long long  h_mismatches = 0;
+    std::vector<double> h_squares(2 * size_t(batch_count));
+    if((err = hipMemcpyAsync(&h_mismatches,
+                             d_mismatches,
+                             sizeof(unsigned long long),
+                             hipMemcpyDeviceToHost,
+                             stream))
+           != hipSuccess
+       || (err = hipMemcpyAsync(h_squares.data(),
+                                d_squares,
+                                sizeof(double) * h_squares.size(),
+                                hipMemcpyDeviceToHost,
+                                stream))
+              != hipSuccess
+       || (err = hipStreamSynchronize(stream)) != hipSuccess)
+        return err;
+
+    *mismatches = int64_t(h_mismatches);
+    for(int i = 0; i < batch_count; i++)
+        *norm_error += std::sqrt(h_squares[2 * i + 1]) / std::sqrt(h_squares[2 * i]);
+    return hipSuccess;
+}
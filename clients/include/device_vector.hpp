@@ -136,6 +136,22 @@ public:
                          this->use_HMM ? hipMemcpyHostToHost : hipMemcpyHostToDevice);
     }
 
+    //!
+    //! @brief Transfer data from a host vector in the order of a stream, the copy is
+    //!        asynchronous to the host only when the host vector is pinned.
+    //! @param that The host vector.
+    //! @param stream The stream.
+    //! @return the hip error.
+    //!
+    hipError_t transfer_from(const host_vector<T>& that, hipStream_t stream)
+    {
+        return hipMemcpyAsync(m_data,
+                              (const T*)that,
+                              this->nmemb() * sizeof(T),
+                              this->use_HMM ? hipMemcpyHostToHost : hipMemcpyHostToDevice,
+                              stream);
+    }
+
     hipError_t memcheck() const
     {
         return !this->nmemb() || m_data ? hipSuccess : hipErrorOutOfMemory;
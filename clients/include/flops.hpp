@@ -93,3 +93,15 @@ constexpr double tanh_gflop_count(int64_t m, int64_t n)
 {
     return 3 * (m * n) / 1e9;
 }
+
+template <typename T>
+constexpr double silu_gflop_count(int64_t m, int64_t n)
+{
+    return 4 * (m * n) / 1e9;
+}
+
+template <typename T>
+constexpr double clamp_gflop_count(int64_t m, int64_t n)
+{
+    return 2 * (m * n) / 1e9;
+}
@@ -121,9 +121,61 @@ struct Arguments
     bool HMM;
 
     bool    search;
+    bool    search_async;
+    bool    search_flush_cache;
+    bool    search_dense;
     int32_t search_iters;
+    int32_t split_k;
+    bool    stream_k;
+
+    bool  alpha_vector_scaling;
+    float scale_a;
+    float scale_b;
+    float d_scale;
+    bool  d_saturate;
+    bool  amax_d;
+    bool  residual;
+    bool  gate;
+    bool  bias_grad;
+    bool  sparse_dynamic;
 
     bool sparse_b;
+
+    bool graph;
+    bool grouped;
+    bool sharded;
+    bool pointer_array;
+
+    // host threads running the plan at once
+    uint16_t plan_threads;
+    // CUs of the stream of the test, 0 for all
+    uint16_t cu_count;
+    // configs kept of the ones ranked by the selection heuristic, 0 for the default
+    uint16_t candidates;
+    // N of a second run with hipsparseLtMatmulDynamicN, 0 for none
+    int32_t dynamic_n;
+    // the matmuls get a NULL workspace, drawn from the workspace pool of the handle
+    bool workspace_pool;
+    // the handle keeps the performance counters of its plans, checked after the test
+    bool plan_stats;
+    // MiB of copies of the matrices the timed matmuls rotate over, 0 for none
+    int32_t rotating;
+    // the caches are flushed before each timed matmul, which is timed alone
+    bool flush;
+    // host threads timing the matmul at once, each on its own streams, D and workspace
+    uint16_t bench_threads;
+    // each of the bench_threads initializes its own plan
+    bool thread_plans;
+    // the timed matmul is compared with the dense GEMM of hipBLASLt on the decompressed matrix
+    bool compare_dense;
+    // the reference of a matmul without epilogue is computed and compared with D on the device
+    bool device_reference;
+    // A, B, C and the residual and gate are initialized on the device
+    bool device_init;
+    // the host matrices of prune and compress are pinned and transferred in the order of the stream
+    bool pinned;
+    // a perf test fails when it is slower than its baseline by more than this fraction
+    float perf_tolerance;
     /*************************************************************************
      *                     End Of Arguments                                  *
      *************************************************************************/
@@ -184,8 +236,42 @@ struct Arguments
     OPER(c_noalias_d) SEP            \
     OPER(HMM) SEP                    \
     OPER(search) SEP                 \
+    OPER(search_async) SEP           \
+    OPER(search_flush_cache) SEP     \
+    OPER(search_dense) SEP           \
     OPER(search_iters) SEP            \
-    OPER(sparse_b) SEP
+    OPER(split_k) SEP                \
+    OPER(stream_k) SEP               \
+    OPER(alpha_vector_scaling) SEP   \
+    OPER(scale_a) SEP                \
+    OPER(scale_b) SEP                \
+    OPER(d_scale) SEP                \
+    OPER(d_saturate) SEP             \
+    OPER(amax_d) SEP                 \
+    OPER(residual) SEP               \
+    OPER(gate) SEP                   \
+    OPER(bias_grad) SEP              \
+    OPER(sparse_dynamic) SEP         \
+    OPER(sparse_b) SEP               \
+    OPER(graph) SEP                  \
+    OPER(grouped) SEP                \
+    OPER(sharded) SEP                \
+    OPER(pointer_array) SEP          \
+    OPER(plan_threads) SEP           \
+    OPER(cu_count) SEP               \
+    OPER(candidates) SEP             \
+    OPER(dynamic_n) SEP              \
+    OPER(workspace_pool) SEP         \
+    OPER(plan_stats) SEP             \
+    OPER(rotating) SEP               \
+    OPER(flush) SEP                  \
+    OPER(bench_threads) SEP          \
+    OPER(thread_plans) SEP           \
+    OPER(compare_dense) SEP          \
+    OPER(device_reference) SEP       \
+    OPER(device_init) SEP            \
+    OPER(pinned) SEP                 \
+    OPER(perf_tolerance) SEP
 
     // clang-format on
 
@@ -27,6 +27,8 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <hip/hip_runtime.h>
 #include <hipsparselt/hipsparselt.h>
 #include <immintrin.h>
@@ -61,6 +63,25 @@ inline __half negate(__half arg)
     return raw;
 }
 
+#if defined(__HIP_PLATFORM_AMD__)
+// the FNUZ formats have no negative zero, its bits are the NaN
+template <>
+inline __hip_fp8_e4m3_fnuz negate(__hip_fp8_e4m3_fnuz x)
+{
+    if(x.__x != 0)
+        x.__x ^= 0x80;
+    return x;
+}
+
+template <>
+inline __hip_fp8_e5m2_fnuz negate(__hip_fp8_e5m2_fnuz x)
+{
+    if(x.__x != 0)
+        x.__x ^= 0x80;
+    return x;
+}
+#endif
+
 template <>
 inline hip_bfloat16 negate(hip_bfloat16 x)
 {
@@ -74,3 +95,42 @@ inline hip_bfloat16 negate(hip_bfloat16 x)
     return raw;
 #endif
 }
+
+/* ============================================================================================ */
+/*! \brief true if a and b have the same n values and all are finite, which passes every unit and
+ *         near check; the comparison is a memcmp and a loop over the bits the compiler vectorizes.
+ *         Always false for the types of different sizes or without such a test of the bits. */
+template <typename T, typename U>
+inline bool hipsparselt_same_finite(const T* a, const U* b, size_t n)
+{
+    if constexpr(!std::is_same<std::remove_cv_t<T>, std::remove_cv_t<U>>{})
+        return false;
+    else if constexpr(std::is_integral<T>{})
+        return !memcmp(a, b, n * sizeof(T));
+    else
+    {
+        using bits_t = std::conditional_t<
+            sizeof(T) == 8,
+            uint64_t,
+            std::conditional_t<sizeof(T) == 4, uint32_t, uint16_t>>;
+        bits_t exponent;
+        if constexpr(std::is_same<T, double>{})
+            exponent = 0x7ff0000000000000ull;
+        else if constexpr(std::is_same<T, float>{})
+            exponent = 0x7f800000u;
+        else if constexpr(std::is_same<T, __half>{})
+            exponent = 0x7c00u;
+        else if constexpr(std::is_same<T, hip_bfloat16>{})
+            exponent = 0x7f80u;
+        else
+            return false;
+
+        if(memcmp(a, b, n * sizeof(T)))
+            return false;
+        bool        finite = true;
+        const auto* bits   = reinterpret_cast<const bits_t*>(a);
+        for(size_t i = 0; i < n; i++)
+            finite &= (bits[i] & exponent) != exponent;
+        return finite;
+    }
+}
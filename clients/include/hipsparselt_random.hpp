@@ -123,6 +123,24 @@ public:
     {
         return random_nan_data<hip_bfloat16, uint16_t, 7, 8>();
     }
+
+#if defined(__HIP_PLATFORM_AMD__)
+    // NaN fp8, the FNUZ formats have a single NaN
+    explicit operator __hip_fp8_e4m3_fnuz()
+    {
+        __hip_fp8_e4m3_fnuz x;
+        x.__x = 0x80;
+        return x;
+    }
+
+    // NaN bf8
+    explicit operator __hip_fp8_e5m2_fnuz()
+    {
+        __hip_fp8_e5m2_fnuz x;
+        x.__x = 0x80;
+        return x;
+    }
+#endif
 };
 
 /* ============================================================================================ */
@@ -239,6 +257,25 @@ inline hip_bfloat16 random_generator<hip_bfloat16>()
     return hip_bfloat16(CAST(std::uniform_int_distribution<int>(-2, 2)(t_hipsparselt_rng)));
 };
 
+#if defined(__HIP_PLATFORM_AMD__)
+// for fp8 and bf8, generate float, and convert to the 8 bit type
+/*! \brief  generate a random number in range [-2,-1,0,1,2] */
+template <>
+inline __hip_fp8_e4m3_fnuz random_generator<__hip_fp8_e4m3_fnuz>()
+{
+    return __hip_fp8_e4m3_fnuz(
+        static_cast<float>(std::uniform_int_distribution<int>(-2, 2)(t_hipsparselt_rng)));
+};
+
+/*! \brief  generate a random number in range [-2,-1,0,1,2] */
+template <>
+inline __hip_fp8_e5m2_fnuz random_generator<__hip_fp8_e5m2_fnuz>()
+{
+    return __hip_fp8_e5m2_fnuz(
+        static_cast<float>(std::uniform_int_distribution<int>(-2, 2)(t_hipsparselt_rng)));
+};
+#endif
+
 /*! \brief  generate a random number in range [1,2,3] */
 template <>
 inline int8_t random_generator<int8_t>()
@@ -300,6 +337,24 @@ inline hip_bfloat16 random_hpl_generator()
     return hip_bfloat16(std::uniform_real_distribution<float>(-0.5, 0.5)(t_hipsparselt_rng));
 }
 
+#if defined(__HIP_PLATFORM_AMD__)
+/*! \brief  generate a random number in HPL-like [-0.5,0.5] doubles  */
+template <>
+inline __hip_fp8_e4m3_fnuz random_hpl_generator()
+{
+    return __hip_fp8_e4m3_fnuz(
+        std::uniform_real_distribution<float>(-0.5, 0.5)(t_hipsparselt_rng));
+}
+
+/*! \brief  generate a random number in HPL-like [-0.5,0.5] doubles  */
+template <>
+inline __hip_fp8_e5m2_fnuz random_hpl_generator()
+{
+    return __hip_fp8_e5m2_fnuz(
+        std::uniform_real_distribution<float>(-0.5, 0.5)(t_hipsparselt_rng));
+}
+#endif
+
 /*! \brief  generate a random ASCII string of up to length n */
 inline std::string random_string(size_t n)
 {
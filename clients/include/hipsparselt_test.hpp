@@ -34,6 +34,7 @@
 #include "hipsparselt_arguments.hpp"
 #include "test_cleanup.hpp"
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <cstdio>
 #include <cstring>
@@ -133,6 +134,21 @@ inline void hipsparselt_expect_status(hipsparseStatus_t status, hipsparseStatus_
 #define CHECK_HIPSPARSELT_ERROR2(STATUS) EXPECT_HIPSPARSE_STATUS(STATUS, HIPSPARSE_STATUS_SUCCESS)
 #define CHECK_HIPSPARSELT_ERROR(STATUS) CHECK_HIPSPARSELT_ERROR2(STATUS)
 
+/*! \brief  Runs check_column(k, j) on the columns j of the batches k on the OpenMP threads,
+ *          check_column returns false when its column fails. The columns left after a failure
+ *          are skipped, so a failed check reports one or a few failures instead of all of them. */
+template <typename F>
+inline bool hipsparselt_check_columns(int64_t batch_count, int64_t N, F&& check_column)
+{
+    std::atomic<bool> failed{false};
+#pragma omp parallel for collapse(2)
+    for(int64_t k = 0; k < batch_count; k++)
+        for(int64_t j = 0; j < N; j++)
+            if(!failed.load(std::memory_order_relaxed) && !check_column(k, j))
+                failed.store(true, std::memory_order_relaxed);
+    return !failed;
+}
+
 #ifdef GOOGLE_TEST
 
 /* ============================================================================================ */
@@ -363,6 +379,12 @@ public:
 // Function to set up signal handlers
 void hipsparselt_test_sigaction();
 
+// A perf test, of the perf category with timing, records the time of each hot call from
+// hipsparselt_perf_start, hipsparselt_perf_check then fails it when its TFLOPS or GB/s at the
+// median time are below the baseline of the platform by more than arg.perf_tolerance
+void hipsparselt_perf_start(const Arguments& arg);
+void hipsparselt_perf_check(const Arguments& arg);
+
 #endif // GOOGLE_TEST
 
 // ----------------------------------------------------------------------------
@@ -28,6 +28,7 @@
 
 #include <cmath>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 //!
@@ -49,6 +50,79 @@ struct host_vector : std::vector<T>
     {
     }
 
+    //!
+    //! @brief Constructor of a vector whose memory is page locked when pinned is true, the
+    //!        vector must then not be resized.
+    //!
+    host_vector(size_t n, ptrdiff_t inc, bool pinned)
+        : host_vector(n, inc)
+    {
+        if(pinned && this->size())
+        {
+            if(hipHostRegister(this->data(), sizeof(T) * this->size(), hipHostRegisterDefault)
+               == hipSuccess)
+                m_pinned = this->data();
+            else
+                (void)hipGetLastError();
+        }
+    }
+
+    //!
+    //! @brief Copy constructor, the copy is pageable.
+    //!
+    host_vector(const host_vector& x)
+        : std::vector<T>(x)
+        , m_n(x.m_n)
+        , m_inc(x.m_inc)
+    {
+    }
+
+    //!
+    //! @brief Move constructor, the memory keeps its pinning.
+    //!
+    host_vector(host_vector&& x) noexcept
+        : std::vector<T>(std::move(x))
+        , m_n(x.m_n)
+        , m_inc(x.m_inc)
+        , m_pinned(x.m_pinned)
+    {
+        x.m_pinned = nullptr;
+    }
+
+    host_vector& operator=(const host_vector& x)
+    {
+        if(this != &x)
+        {
+            unpin();
+            std::vector<T>::operator=(x);
+            m_n   = x.m_n;
+            m_inc = x.m_inc;
+        }
+        return *this;
+    }
+
+    host_vector& operator=(host_vector&& x) noexcept
+    {
+        if(this != &x)
+        {
+            unpin();
+            std::vector<T>::operator=(std::move(x));
+            m_n        = x.m_n;
+            m_inc      = x.m_inc;
+            m_pinned   = x.m_pinned;
+            x.m_pinned = nullptr;
+        }
+        return *this;
+    }
+
+    //!
+    //! @brief Destructor.
+    //!
+    ~host_vector()
+    {
+        unpin();
+    }
+
     //!
     //! @brief Copy constructor from host_vector of other types convertible to T
     //!
@@ -96,6 +170,30 @@ struct host_vector : std::vector<T>
                          that.use_HMM ? hipMemcpyHostToHost : hipMemcpyDeviceToHost);
     }
 
+    //!
+    //! @brief Transfer from a device vector in the order of a stream, the copy is asynchronous to
+    //!        the host only when this vector is pinned.
+    //! @param  that That device vector.
+    //! @param  stream The stream.
+    //! @return the hip error.
+    //!
+    hipError_t transfer_from(const device_vector<T>& that, hipStream_t stream)
+    {
+        return hipMemcpyAsync(*this,
+                              that,
+                              sizeof(T) * this->size(),
+                              that.use_HMM ? hipMemcpyHostToHost : hipMemcpyDeviceToHost,
+                              stream);
+    }
+
+    //!
+    //! @brief Returns true if the memory of the vector is page locked.
+    //!
+    bool pinned() const
+    {
+        return m_pinned != nullptr;
+    }
+
     //!
     //! @brief Returns the length of the vector.
     //!
@@ -137,6 +235,14 @@ struct host_vector : std::vector<T>
     }
 
 private:
-    size_t    m_n   = 0;
-    ptrdiff_t m_inc = 0;
+    void unpin()
+    {
+        if(m_pinned && hipHostUnregister(m_pinned) != hipSuccess)
+            (void)hipGetLastError();
+        m_pinned = nullptr;
+    }
+
+    size_t    m_n      = 0;
+    ptrdiff_t m_inc    = 0;
+    T*        m_pinned = nullptr;
 };
@@ -47,29 +47,40 @@
 #define NEAR_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, err, NEAR_ASSERT) \
     do                                                                            \
     {                                                                             \
-        for(size_t k = 0; k < batch_count; k++)                                   \
-            for(size_t j = 0; j < N; j++)                                         \
-                for(size_t i = 0; i < M; i++)                                     \
-                    NEAR_ASSERT(hCPU[i + j * size_t(lda) + k * strideA],          \
-                                hGPU[i + j * size_t(lda) + k * strideA],          \
-                                err);                                             \
+        hipsparselt_check_columns(batch_count, N, [&](int64_t k, int64_t j) {     \
+            size_t col    = j * size_t(lda) + k * strideA;                        \
+            bool   passed = hipsparselt_same_finite(&hCPU[col], &hGPU[col], M);   \
+            if(!passed)                                                           \
+                [&] {                                                             \
+                    for(size_t i = col; i < col + M; i++)                         \
+                        NEAR_ASSERT(hCPU[i], hGPU[i], err);                       \
+                    passed = true;                                                \
+                }();                                                              \
+            return passed;                                                        \
+        });                                                                       \
     } while(0)
 
-#define NEAR_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, err, NEAR_ASSERT)                    \
-    do                                                                                        \
-    {                                                                                         \
-        for(size_t k = 0; k < batch_count; k++)                                               \
-            for(size_t j = 0; j < N; j++)                                                     \
-                for(size_t i = 0; i < M; i++)                                                 \
-                    if(hipsparselt_isnan(hCPU[k][i + j * size_t(lda)]))                       \
-                    {                                                                         \
-                        ASSERT_TRUE(hipsparselt_isnan(hGPU[k][i + j * size_t(lda)]));         \
-                    }                                                                         \
-                    else                                                                      \
-                    {                                                                         \
-                        NEAR_ASSERT(                                                          \
-                            hCPU[k][i + j * size_t(lda)], hGPU[k][i + j * size_t(lda)], err); \
-                    }                                                                         \
+#define NEAR_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, err, NEAR_ASSERT)            \
+    do                                                                                \
+    {                                                                                 \
+        hipsparselt_check_columns(batch_count, N, [&](int64_t k, int64_t j) {         \
+            size_t col    = j * size_t(lda);                                          \
+            bool   passed = hipsparselt_same_finite(&hCPU[k][col], &hGPU[k][col], M); \
+            if(!passed)                                                               \
+                [&] {                                                                 \
+                    for(size_t i = col; i < col + M; i++)                             \
+                        if(hipsparselt_isnan(hCPU[k][i]))                             \
+                        {                                                             \
+                            ASSERT_TRUE(hipsparselt_isnan(hGPU[k][i]));               \
+                        }                                                             \
+                        else                                                          \
+                        {                                                             \
+                            NEAR_ASSERT(hCPU[k][i], hGPU[k][i], err);                 \
+                        }                                                             \
+                    passed = true;                                                    \
+                }();                                                                  \
+            return passed;                                                            \
+        });                                                                           \
     } while(0)
 
 #endif
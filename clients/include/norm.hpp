@@ -114,6 +114,7 @@ double norm_check_general(char norm_type, int64_t M, int64_t N, int64_t lda, T*
     host_vector<double> hCPU_double(size);
     host_vector<double> hGPU_double(size);
 
+#pragma omp parallel for
     for(int64_t i = 0; i < N; i++)
     {
         for(int64_t j = 0; j < M; j++)
@@ -148,6 +149,7 @@ double norm_check_general(char norm_type, int64_t M, int64_t N, int64_t lda, VEC
     host_vector<double> hCPU_double(size);
     host_vector<double> hGPU_double(size);
 
+#pragma omp parallel for
     for(int64_t i = 0; i < N; i++)
     {
         for(int64_t j = 0; j < M; j++)
@@ -169,6 +171,7 @@ double norm_check_general(char norm_type, int64_t M, int64_t N, int64_t lda, VEC
     host_vector<int> hCPU_int(size);
     host_vector<int> hGPU_int(size);
 
+#pragma omp parallel for
     for(int64_t i = 0; i < N; i++)
     {
         for(int64_t j = 0; j < M; j++)
@@ -200,26 +203,27 @@ double norm_check_general(char        norm_type,
     //
     // use triangle inequality ||a+b|| <= ||a|| + ||b|| to calculate upper limit for Frobenius norm
     // of strided batched matrix
+    //
+    // the batches are checked on the OpenMP threads
 
-    double cumulative_error = 0.0;
+    bool   frobenius = norm_type == 'F' || norm_type == 'f';
+    bool   max_norm  = norm_type == 'O' || norm_type == 'o' || norm_type == 'I' || norm_type == 'i';
+    double sum_error = 0.0, max_error = 0.0;
 
-    for(size_t i = 0; i < batch_count; i++)
+#pragma omp parallel for reduction(+ : sum_error) reduction(max : max_error)
+    for(int64_t i = 0; i < batch_count; i++)
     {
         auto index = i * stride_a;
 
         auto error = norm_check_general(norm_type, M, N, lda, (T_hpa*)hCPU + index, hGPU + index);
 
-        if(norm_type == 'F' || norm_type == 'f')
-        {
-            cumulative_error += error;
-        }
-        else if(norm_type == 'O' || norm_type == 'o' || norm_type == 'I' || norm_type == 'i')
-        {
-            cumulative_error = cumulative_error > error ? cumulative_error : error;
-        }
+        if(frobenius)
+            sum_error += error;
+        else if(max_norm)
+            max_error = max_error > error ? max_error : error;
     }
 
-    return cumulative_error;
+    return frobenius ? sum_error : max_error;
 }
 
 /* ============== Norm Check for batched case ============= */
@@ -234,24 +238,23 @@ double norm_check_general(
     //
     // use triangle inequality ||a+b|| <= ||a|| + ||b|| to calculate upper limit for Frobenius norm
     // of strided batched matrix
+    //
+    // the batches are checked on the OpenMP threads
 
-    double cumulative_error = 0.0;
+    bool   frobenius = norm_type == 'F' || norm_type == 'f';
+    bool   max_norm  = norm_type == 'O' || norm_type == 'o' || norm_type == 'I' || norm_type == 'i';
+    double sum_error = 0.0, max_error = 0.0;
 
+#pragma omp parallel for reduction(+ : sum_error) reduction(max : max_error)
     for(int64_t i = 0; i < batch_count; i++)
     {
-        auto index = i;
-
-        auto error = norm_check_general<T>(norm_type, M, N, lda, hCPU[index], hGPU[index]);
+        auto error = norm_check_general<T>(norm_type, M, N, lda, hCPU[i], hGPU[i]);
 
-        if(norm_type == 'F' || norm_type == 'f')
-        {
-            cumulative_error += error;
-        }
-        else if(norm_type == 'O' || norm_type == 'o' || norm_type == 'I' || norm_type == 'i')
-        {
-            cumulative_error = cumulative_error > error ? cumulative_error : error;
-        }
+        if(frobenius)
+            sum_error += error;
+        else if(max_norm)
+            max_error = max_error > error ? max_error : error;
     }
 
-    return cumulative_error;
+    return frobenius ? sum_error : max_error;
 }
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include "device_init.hpp"
 #include "flops.hpp"
 #include "hipsparselt_datatype2string.hpp"
 #include "hipsparselt_init.hpp"
@@ -270,6 +271,26 @@ void testing_compress_bad_arg(const Arguments& arg)
     EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompress(handle, plan, dA_1, nullptr, dA_ws, stream),
                             HIPSPARSE_STATUS_INVALID_VALUE);
 
+#ifdef __HIP_PLATFORM_AMD__
+    // test the fused prune and compress
+    hipsparseLtPruneAlg_t prune_alg = HIPSPARSELT_PRUNE_SPMMA_STRIP;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneAndCompress(nullptr, plan, dA, dA_1, dA_ws, prune_alg, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneAndCompress(handle, nullptr, dA, dA_1, dA_ws, prune_alg, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneAndCompress(handle, plan, nullptr, dA_1, dA_ws, prune_alg, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneAndCompress(handle, plan, dA, nullptr, dA_ws, prune_alg, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+#endif
+
     // test version 2
     EXPECT_HIPSPARSE_STATUS(
         hipsparseLtSpMMACompressedSize2(nullptr, matA, &compressed_size, &compress_buffer_size),
@@ -303,6 +324,329 @@ void testing_compress_bad_arg(const Arguments& arg)
     EXPECT_HIPSPARSE_STATUS(
         hipsparseLtSpMMACompress2(handle, matA, true, transA, dA_1, nullptr, dA_ws, stream),
         HIPSPARSE_STATUS_INVALID_VALUE);
+
+#ifdef __HIP_PLATFORM_AMD__
+    // test the decompress
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMADecompress(nullptr, plan, dA_1, dA, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMADecompress(handle, nullptr, dA_1, dA, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMADecompress(handle, plan, nullptr, dA, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMADecompress(handle, plan, dA_1, nullptr, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMADecompress2(nullptr, matA, true, transA, dA_1, dA, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMADecompress2(handle, nullptr, true, transA, dA_1, dA, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMADecompress2(handle, matA, true, transA, nullptr, dA, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMADecompress2(handle, matA, true, transA, dA_1, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    // test the optimizer step on the compressed matrix
+    size_t                       state_size;
+    device_vector<float>         dA_state(safe_size);
+    hipsparseLtOptimizerParams_t sgd  = {HIPSPARSELT_OPTIMIZER_SGD, 0.1f, 0.9f};
+    hipsparseLtOptimizerParams_t adam = {HIPSPARSELT_OPTIMIZER_ADAM, 0.1f, 0.9f, 0.99f, 1e-8f};
+    CHECK_DEVICE_ALLOCATION(dA_state.memcheck());
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedUpdateStateSize(nullptr, plan, &state_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedUpdateStateSize(handle, nullptr, &state_size),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedUpdateStateSize(handle, plan, nullptr),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedUpdate(nullptr, plan, &sgd, dA_1, dA, dA_state, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedUpdate(handle,
+                                                             nullptr,
+                                                             &sgd,
+                                                             dA_1,
+                                                             dA,
+                                                             dA_state,
+                                                             nullptr,
+                                                             stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedUpdate(handle,
+                                                             plan,
+                                                             nullptr,
+                                                             dA_1,
+                                                             dA,
+                                                             dA_state,
+                                                             nullptr,
+                                                             stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedUpdate(handle,
+                                                             plan,
+                                                             &sgd,
+                                                             nullptr,
+                                                             dA,
+                                                             dA_state,
+                                                             nullptr,
+                                                             stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedUpdate(handle,
+                                                             plan,
+                                                             &sgd,
+                                                             dA_1,
+                                                             nullptr,
+                                                             dA_state,
+                                                             nullptr,
+                                                             stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    // SGD with momentum needs state1, Adam needs both states and a step from 1
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedUpdate(handle, plan, &sgd, dA_1, dA, nullptr, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedUpdate(handle, plan, &adam, dA_1, dA, dA_state, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedUpdate(handle, plan, &adam, dA_1, dA, dA_state, dA_state, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    // test the 4-bit packing, a group must be even and divide k / 2
+    size_t packed_size;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedInt4Size(nullptr, plan, 16, &packed_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedInt4Size(handle, nullptr, 16, &packed_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedInt4Size(handle, plan, 16, nullptr),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    for(int64_t group_size : {0, 3, 6})
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtSpMMACompressedInt4Size(handle, plan, group_size, &packed_size),
+            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedInt4Pack(nullptr, plan, 16, dA_1, dA, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedInt4Pack(handle, nullptr, 16, dA_1, dA, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedInt4Pack(handle, plan, 3, dA_1, dA, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedInt4Pack(handle, plan, 16, nullptr, dA, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedInt4Pack(handle, plan, 16, dA_1, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedInt4Unpack(nullptr, plan, 16, dA, dA_1, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedInt4Unpack(handle, nullptr, 16, dA, dA_1, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedInt4Unpack(handle, plan, 3, dA, dA_1, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedInt4Unpack(handle, plan, 16, nullptr, dA_1, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedInt4Unpack(handle, plan, 16, dA, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+    // test the grouped compress
+    size_t work_list_size;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAGroupedWorkListSize(nullptr, 1, &work_list_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAGroupedWorkListSize(handle, -1, &work_list_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAGroupedWorkListSize(handle, 1, nullptr),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAGroupedWorkListSize(handle, 1, &work_list_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+
+    device_vector<unsigned char> d_work_list(work_list_size);
+    CHECK_DEVICE_ALLOCATION(d_work_list.memcheck());
+
+    const hipsparseLtMatDescriptor_t* descrs[]     = {matA};
+    const void*                       d_dense[]    = {dA};
+    void*                             d_compress[] = {dA_1};
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress2Grouped(
+            nullptr, 1, descrs, true, transA, d_dense, d_compress, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress2Grouped(
+            handle, -1, descrs, true, transA, d_dense, d_compress, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress2Grouped(
+            handle, 1, nullptr, true, transA, d_dense, d_compress, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress2Grouped(
+            handle, 1, descrs, true, transA, nullptr, d_compress, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress2Grouped(
+            handle, 1, descrs, true, transA, d_dense, nullptr, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress2Grouped(
+            handle, 1, descrs, true, transA, d_dense, d_compress, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    // test the transposable prune and compress
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneAndCompressTransposable(
+                                nullptr, matA, true, dA, dA, dA_1, dA_1, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneAndCompressTransposable(
+                                handle, nullptr, true, dA, dA, dA_1, dA_1, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneAndCompressTransposable(
+                                handle, matA, true, nullptr, dA, dA_1, dA_1, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneAndCompressTransposable(
+                                handle, matA, true, dA, nullptr, dA_1, dA_1, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneAndCompressTransposable(
+                                handle, matA, true, dA, dA, nullptr, dA_1, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneAndCompressTransposable(
+                                handle, matA, true, dA, dA, dA_1, nullptr, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    // test the streamed compress
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompress2Streamed(
+                                nullptr, matA, true, transA, dA, dA_1, dA_ws, K * 4, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompress2Streamed(
+                                handle, nullptr, true, transA, dA, dA_1, dA_ws, K * 4, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompress2Streamed(
+                                handle, matA, true, transA, nullptr, dA_1, dA_ws, K * 4, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompress2Streamed(
+                                handle, matA, true, transA, dA, nullptr, dA_ws, K * 4, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompress2Streamed(
+                                handle, matA, true, transA, dA, dA_1, nullptr, K * 4, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    // smaller than two rows of K elements
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompress2Streamed(
+                                handle, matA, true, transA, dA, dA_1, dA_ws, K, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    // test the streamed prune and compress
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneAndCompressStreamed(
+            nullptr, matA, true, transA, dA, dA_1, dA_ws, K * 4, prune_alg, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneAndCompressStreamed(
+            handle, nullptr, true, transA, dA, dA_1, dA_ws, K * 4, prune_alg, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneAndCompressStreamed(
+            handle, matA, true, transA, nullptr, dA_1, dA_ws, K * 4, prune_alg, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneAndCompressStreamed(
+            handle, matA, true, transA, dA, nullptr, dA_ws, K * 4, prune_alg, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneAndCompressStreamed(
+            handle, matA, true, transA, dA, dA_1, nullptr, K * 4, prune_alg, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    // smaller than two rows of K elements
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneAndCompressStreamed(
+            handle, matA, true, transA, dA, dA_1, dA_ws, K, prune_alg, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    // test the row recompress
+    int64_t ranges[]     = {0, M};
+    int64_t bad_ranges[] = {0, M + 1};
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressRows(nullptr, plan, dA, dA_1, 1, ranges, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressRows(handle, nullptr, dA, dA_1, 1, ranges, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressRows(handle, plan, nullptr, dA_1, 1, ranges, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressRows(handle, plan, dA, nullptr, 1, ranges, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressRows(handle, plan, dA, dA_1, -1, ranges, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressRows(handle, plan, dA, dA_1, 1, nullptr, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressRows(handle, plan, dA, dA_1, 1, ranges, nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressRows(handle, plan, dA, dA_1, 1, bad_ranges, d_work_list, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    // test the host compress
+    host_vector<Ti> hA(safe_size);
+    host_vector<Ti> hA_1(safe_size);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedSizeHost(M, K, lda, arg.a_type, 1, 0, true, transA, nullptr),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedSizeHost(
+                                M, K, M - 1, arg.a_type, 1, 0, true, transA, &compressed_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedSizeHost(
+                                M, K, lda, arg.a_type, 0, 0, true, transA, &compressed_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedSizeHost(
+                                M, K, lda, HIPSPARSELT_R_32F, 1, 0, true, transA, &compressed_size),
+                            HIPSPARSE_STATUS_NOT_SUPPORTED);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressHost(
+                                M, K, lda, arg.a_type, 1, 0, true, transA, nullptr, hA_1, 0),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressHost(
+                                M, K, lda, arg.a_type, 1, 0, true, transA, hA, nullptr, 0),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    // test the compressed file
+    std::string path = hipsparselt_tempname();
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedSave(nullptr, plan, dA_1, path.c_str(), stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedSave(handle, nullptr, dA_1, path.c_str(), stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedSave(handle, plan, nullptr, path.c_str(), stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedSave(handle, plan, dA_1, nullptr, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedLoad(handle, plan, nullptr, dA_1, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedLoad(handle, plan, path.c_str(), nullptr, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    // the temporary file is empty, it has no header
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedLoad(handle, plan, path.c_str(), dA_1, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+    remove(path.c_str());
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedLoad(handle, plan, path.c_str(), dA_1, stream),
+        HIPSPARSE_STATUS_INTERNAL_ERROR);
+#endif
 }
 
 template <typename Ti,
@@ -314,6 +658,15 @@ void testing_compress(const Arguments& arg)
     int run_version = 1;
     if(strstr(arg.name, "compress2") != nullptr)
         run_version = 2;
+    // prune out of place, then compress the unpruned matrix with the fused API and compare
+    else if(strstr(arg.name, "prune_and_compress") != nullptr)
+        run_version = 3;
+
+#ifdef __HIP_PLATFORM_NVIDIA__
+    // cusparseLt has no fused prune and compress.
+    if(run_version == 3)
+        return;
+#endif
 
     hipsparseOperation_t transA = char_to_hipsparselt_operation(arg.transA);
     hipsparseOperation_t transB = char_to_hipsparselt_operation(arg.transB);
@@ -459,7 +812,7 @@ void testing_compress(const Arguments& arg)
 
     hipsparseLtMatmulGetWorkspace(handle, plan, &workspace_size);
 
-    if(run_version == 1)
+    if(run_version == 1 || run_version == 3)
     {
         EXPECT_HIPSPARSE_STATUS(
             hipsparseLtSpMMACompressedSize(handle, plan, &compressed_size, &compress_buffer_size),
@@ -480,20 +833,32 @@ void testing_compress(const Arguments& arg)
     const size_t size_B_pruned_copy     = arg.unit_check || arg.norm_check ? size_B : 0;
     const size_t size_B_compressed_copy = arg.unit_check || arg.norm_check ? compressed_size : 0;
 
+    // the fused API keeps dT unpruned, the reference compresses an out of place pruned copy
+    const size_t size_T_pruned = run_version == 3 ? (arg.sparse_b ? size_B : size_A) : 0;
+
     // allocate memory on device
     device_vector<Ti>            dT(arg.sparse_b ? size_B : size_A, 1, HMM);
+    device_vector<Ti>            dT_pruned(size_T_pruned, 1, HMM);
     device_vector<unsigned char> dT_compressd(compressed_size, 1, HMM);
     device_vector<unsigned char> dT_compressBuffer(compress_buffer_size, 1, HMM);
     CHECK_DEVICE_ALLOCATION(dT.memcheck());
+    CHECK_DEVICE_ALLOCATION(dT_pruned.memcheck());
     CHECK_DEVICE_ALLOCATION(dT_compressd.memcheck());
     CHECK_DEVICE_ALLOCATION(dT_compressBuffer.memcheck());
 
+    // arg.device_init initializes T on the device, the host copies it for the checks only
+    const bool device_init = arg.device_init
+                             && arg.initialization != hipsparselt_initialization::special;
+    const bool host_copy   = !device_init || arg.unit_check || arg.norm_check;
+
     // Naming: dX is in GPU (device) memory. hK is in CPU (host) memory
-    host_vector<Ti>            hT(arg.sparse_b ? size_B : size_A);
-    host_vector<Ti>            hT_pruned(arg.sparse_b ? size_B_pruned_copy : size_A_pruned_copy);
-    host_vector<unsigned char> hT_gold(arg.sparse_b ? size_B_compressed_copy
-                                                    : size_A_compressed_copy);
-    host_vector<unsigned char> hT_1(arg.sparse_b ? size_B_compressed_copy : size_A_compressed_copy);
+    const size_t T_size            = arg.sparse_b ? size_B : size_A;
+    const size_t T_pruned_copy     = arg.sparse_b ? size_B_pruned_copy : size_A_pruned_copy;
+    const size_t T_compressed_copy = arg.sparse_b ? size_B_compressed_copy : size_A_compressed_copy;
+    host_vector<Ti>            hT(host_copy ? T_size : 0, 1, arg.pinned);
+    host_vector<Ti>            hT_pruned(T_pruned_copy, 1, arg.pinned);
+    host_vector<unsigned char> hT_gold(T_compressed_copy);
+    host_vector<unsigned char> hT_1(T_compressed_copy, 1, arg.pinned);
 
     hipsparselt_seedrand();
 
@@ -513,27 +878,46 @@ void testing_compress(const Arguments& arg)
         stride_t = stride_b;
     }
 
-    // Initial Data on CPU
-    if(arg.initialization == hipsparselt_initialization::rand_int)
-    {
-        hipsparselt_init<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
-    }
-    else if(arg.initialization == hipsparselt_initialization::trig_float)
+    if(!device_init)
     {
-        hipsparselt_init_sin<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
-    }
-    else if(arg.initialization == hipsparselt_initialization::hpl)
-    {
-        hipsparselt_init_hpl<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        // Initial Data on CPU
+        if(arg.initialization == hipsparselt_initialization::rand_int)
+        {
+            hipsparselt_init<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        }
+        else if(arg.initialization == hipsparselt_initialization::trig_float)
+        {
+            hipsparselt_init_sin<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        }
+        else if(arg.initialization == hipsparselt_initialization::hpl)
+        {
+            hipsparselt_init_hpl<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        }
+        else if(arg.initialization == hipsparselt_initialization::special)
+        {
+            hipsparselt_init_alt_impl_big<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        }
+
+        // copy data from CPU to device, arg.pinned copies in the order of the stream
+        CHECK_HIP_ERROR(arg.pinned ? dT.transfer_from(hT, stream) : dT.transfer_from(hT));
     }
-    else if(arg.initialization == hipsparselt_initialization::special)
+    else
     {
-        hipsparselt_init_alt_impl_big<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        const hipsparselt_device_init_mode mode
+            = arg.initialization == hipsparselt_initialization::trig_float
+                  ? hipsparselt_device_init_mode::sin
+              : arg.initialization == hipsparselt_initialization::hpl
+                  ? hipsparselt_device_init_mode::hpl
+                  : hipsparselt_device_init_mode::rand_int;
+        CHECK_HIP_ERROR(hipsparselt_init_device<Ti>(
+            dT, T_row, T_col, ldt, stride_t, num_batches, mode, stream));
+        if(hT.size())
+        {
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT.transfer_from(dT));
+        }
     }
 
-    // copy data from CPU to device
-    CHECK_HIP_ERROR(dT.transfer_from(hT));
-
     if(run_version == 1)
     {
         EXPECT_HIPSPARSE_STATUS(
@@ -553,6 +937,13 @@ void testing_compress(const Arguments& arg)
                                                        stream),
                                 HIPSPARSE_STATUS_SUCCESS);
     }
+    else if(run_version == 3)
+    {
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtSpMMAPrune(
+                handle, matmul, dT, dT_pruned, hipsparseLtPruneAlg_t(arg.prune_algo), stream),
+            HIPSPARSE_STATUS_SUCCESS);
+    }
 
     if(arg.unit_check || arg.norm_check)
     {
@@ -598,8 +989,15 @@ void testing_compress(const Arguments& arg)
         auto metadata_offset = c_stride_r * sizeof(Ti)
                                * ((arg.sparse_b ? stride_b : stride_a) == 0 ? 1 : num_batches);
 
-        CHECK_HIP_ERROR(hipStreamSynchronize(stream));
-        CHECK_HIP_ERROR(hT_pruned.transfer_from(dT));
+        // a pinned copy of the pruned matrix is ordered before the compress, the host waits for
+        // both at once
+        if(arg.pinned)
+            CHECK_HIP_ERROR(hT_pruned.transfer_from(run_version == 3 ? dT_pruned : dT, stream));
+        else
+        {
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_pruned.transfer_from(run_version == 3 ? dT_pruned : dT));
+        }
 
         if(run_version == 1)
             EXPECT_HIPSPARSE_STATUS(
@@ -615,9 +1013,519 @@ void testing_compress(const Arguments& arg)
                                                               dT_compressBuffer,
                                                               stream),
                                     HIPSPARSE_STATUS_SUCCESS);
+        else if(run_version == 3)
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMAPruneAndCompress(handle,
+                                                 plan,
+                                                 dT,
+                                                 dT_compressd,
+                                                 dT_compressBuffer,
+                                                 hipsparseLtPruneAlg_t(arg.prune_algo),
+                                                 stream),
+                HIPSPARSE_STATUS_SUCCESS);
 
-        CHECK_HIP_ERROR(hipStreamSynchronize(stream));
-        CHECK_HIP_ERROR(hT_1.transfer_from(dT_compressd));
+        if(arg.pinned)
+        {
+            CHECK_HIP_ERROR(hT_1.transfer_from(dT_compressd, stream));
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+        }
+        else
+        {
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_1.transfer_from(dT_compressd));
+        }
+
+#ifdef __HIP_PLATFORM_AMD__
+        // compress dT twice in one grouped launch, both must match the single compress
+        if(run_version == 2 && arg.unit_check)
+        {
+            size_t work_list_size;
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAGroupedWorkListSize(handle, 2, &work_list_size),
+                                    HIPSPARSE_STATUS_SUCCESS);
+
+            device_vector<unsigned char> dT_work_list(work_list_size, 1, HMM);
+            device_vector<unsigned char> dT_grouped(compressed_size * 2, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_work_list.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_grouped.memcheck());
+
+            hipsparseLtMatDescriptor_t* descr = arg.sparse_b ? matB : matA;
+            hipsparseOperation_t        op    = arg.sparse_b ? transB : transA;
+            unsigned char*              out   = dT_grouped;
+
+            const hipsparseLtMatDescriptor_t* descrs[2]       = {descr, descr};
+            const void*                       d_dense[2]      = {dT, dT};
+            void*                             d_compressed[2] = {out, out + compressed_size};
+
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompress2Grouped(handle,
+                                                                     2,
+                                                                     descrs,
+                                                                     !arg.sparse_b,
+                                                                     op,
+                                                                     d_dense,
+                                                                     d_compressed,
+                                                                     dT_work_list,
+                                                                     stream),
+                                    HIPSPARSE_STATUS_SUCCESS);
+
+            host_vector<unsigned char> hT_grouped(compressed_size * 2);
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_grouped.transfer_from(dT_grouped));
+            for(int i = 0; i < 2; i++)
+                unit_check_general<int8_t>(compressed_size,
+                                           1,
+                                           compressed_size,
+                                           reinterpret_cast<int8_t*>(hT_1.data()),
+                                           reinterpret_cast<int8_t*>(hT_grouped.data())
+                                               + i * compressed_size);
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // compress the pruned matrix from the host through a buffer of two panels of 16 rows,
+        // so that both halves of the buffer get reused, it must match the single compress
+        if(run_version == 2 && arg.unit_check)
+        {
+            size_t                       panel_buffer_size = 2 * 16 * K * sizeof(Ti);
+            device_vector<unsigned char> dT_panels(panel_buffer_size, 1, HMM);
+            device_vector<unsigned char> dT_streamed(compressed_size, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_panels.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_streamed.memcheck());
+
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompress2Streamed(handle,
+                                                  arg.sparse_b ? matB : matA,
+                                                  !arg.sparse_b,
+                                                  arg.sparse_b ? transB : transA,
+                                                  hT_pruned,
+                                                  dT_streamed,
+                                                  dT_panels,
+                                                  panel_buffer_size,
+                                                  stream),
+                HIPSPARSE_STATUS_SUCCESS);
+
+            host_vector<unsigned char> hT_streamed(compressed_size);
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_streamed.transfer_from(dT_streamed));
+            unit_check_general<int8_t>(compressed_size,
+                                       1,
+                                       compressed_size,
+                                       reinterpret_cast<int8_t*>(hT_1.data()),
+                                       reinterpret_cast<int8_t*>(hT_streamed.data()));
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // prune and compress the unpruned matrix from the host through a buffer of three panels
+        // of 16 rows, it must match the prune followed by the compress
+        if(run_version == 2 && arg.unit_check)
+        {
+            size_t                       panel_buffer_size = 3 * 16 * K * sizeof(Ti);
+            device_vector<unsigned char> dT_panels(panel_buffer_size, 1, HMM);
+            device_vector<unsigned char> dT_streamed(compressed_size, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_panels.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_streamed.memcheck());
+
+            float bandwidth = 0.f;
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMAPruneAndCompressStreamed(handle,
+                                                         arg.sparse_b ? matB : matA,
+                                                         !arg.sparse_b,
+                                                         arg.sparse_b ? transB : transA,
+                                                         hT,
+                                                         dT_streamed,
+                                                         dT_panels,
+                                                         panel_buffer_size,
+                                                         hipsparseLtPruneAlg_t(arg.prune_algo),
+                                                         &bandwidth,
+                                                         stream),
+                HIPSPARSE_STATUS_SUCCESS);
+            EXPECT_GT(bandwidth, 0.f);
+
+            host_vector<unsigned char> hT_streamed(compressed_size);
+            CHECK_HIP_ERROR(hT_streamed.transfer_from(dT_streamed));
+            unit_check_general<int8_t>(compressed_size,
+                                       1,
+                                       compressed_size,
+                                       reinterpret_cast<int8_t*>(hT_1.data()),
+                                       reinterpret_cast<int8_t*>(hT_streamed.data()));
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // the transposable prune must be 2:4 along both dimensions, and the compressed matrix
+        // for the operation of the test must match the compress of the matrix it pruned
+        if(run_version == 2 && arg.unit_check)
+        {
+            hipsparseLtMatDescriptor_t*  descr = arg.sparse_b ? matB : matA;
+            hipsparseOperation_t         op    = arg.sparse_b ? transB : transA;
+            device_vector<Ti>            dT_tp(arg.sparse_b ? size_B : size_A, 1, HMM);
+            device_vector<unsigned char> dT_tp_n(compressed_size, 1, HMM);
+            device_vector<unsigned char> dT_tp_t(compressed_size, 1, HMM);
+            device_vector<unsigned char> dT_tp_ref(compressed_size, 1, HMM);
+            device_vector<int>           d_valid(1, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_tp.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_tp_n.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_tp_t.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_tp_ref.memcheck());
+            CHECK_DEVICE_ALLOCATION(d_valid.memcheck());
+
+            CHECK_HIP_ERROR(dT_tp.transfer_from(hT));
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMAPruneAndCompressTransposable(
+                    handle, descr, !arg.sparse_b, dT_tp, dT_tp, dT_tp_n, dT_tp_t, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+
+            for(auto check_op : {HIPSPARSE_OPERATION_NON_TRANSPOSE, HIPSPARSE_OPERATION_TRANSPOSE})
+            {
+                int h_valid = 1;
+                EXPECT_HIPSPARSE_STATUS(
+                    hipsparseLtSpMMAPruneCheck2(
+                        handle, descr, !arg.sparse_b, check_op, dT_tp, d_valid, stream),
+                    HIPSPARSE_STATUS_SUCCESS);
+                CHECK_HIP_ERROR(hipMemcpyAsync(
+                    &h_valid, d_valid, sizeof(int), hipMemcpyDeviceToHost, stream));
+                CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+                CHECK_SUCCESS(h_valid == 0);
+            }
+
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompress2(
+                    handle, descr, !arg.sparse_b, op, dT_tp, dT_tp_ref, dT_compressBuffer, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+
+            host_vector<unsigned char> hT_tp(compressed_size);
+            host_vector<unsigned char> hT_tp_ref(compressed_size);
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(
+                hT_tp.transfer_from(op == HIPSPARSE_OPERATION_TRANSPOSE ? dT_tp_t : dT_tp_n));
+            CHECK_HIP_ERROR(hT_tp_ref.transfer_from(dT_tp_ref));
+            unit_check_general<int8_t>(compressed_size,
+                                       1,
+                                       compressed_size,
+                                       reinterpret_cast<int8_t*>(hT_tp_ref.data()),
+                                       reinterpret_cast<int8_t*>(hT_tp.data()));
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // the host compress must write the same bytes as the device
+        if(arg.unit_check)
+        {
+            hipsparseLtDatatype_t type = arg.sparse_b ? arg.b_type : arg.a_type;
+            hipsparseOperation_t  op   = arg.sparse_b ? transB : transA;
+            size_t                host_compressed_size;
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedSizeHost(T_row,
+                                                                       T_col,
+                                                                       ldt,
+                                                                       type,
+                                                                       num_batches,
+                                                                       stride_t,
+                                                                       !arg.sparse_b,
+                                                                       op,
+                                                                       &host_compressed_size),
+                                    HIPSPARSE_STATUS_SUCCESS);
+            CHECK_SUCCESS(host_compressed_size == compressed_size);
+
+            host_vector<unsigned char> hT_host(compressed_size);
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressHost(T_row,
+                                                                 T_col,
+                                                                 ldt,
+                                                                 type,
+                                                                 num_batches,
+                                                                 stride_t,
+                                                                 !arg.sparse_b,
+                                                                 op,
+                                                                 hT_pruned,
+                                                                 hT_host,
+                                                                 0),
+                                    HIPSPARSE_STATUS_SUCCESS);
+            unit_check_general<int8_t>(compressed_size,
+                                       1,
+                                       compressed_size,
+                                       reinterpret_cast<int8_t*>(hT_1.data()),
+                                       reinterpret_cast<int8_t*>(hT_host.data()));
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // the decompress must give back the pruned dense matrix
+        if(arg.unit_check)
+        {
+            device_vector<Ti> dT_decompressed(hT_pruned.size(), 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_decompressed.memcheck());
+            if(run_version == 2)
+                EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMADecompress2(handle,
+                                                                    arg.sparse_b ? matB : matA,
+                                                                    !arg.sparse_b,
+                                                                    arg.sparse_b ? transB : transA,
+                                                                    dT_compressd,
+                                                                    dT_decompressed,
+                                                                    stream),
+                                        HIPSPARSE_STATUS_SUCCESS);
+            else
+                EXPECT_HIPSPARSE_STATUS(
+                    hipsparseLtSpMMADecompress(
+                        handle, plan, dT_compressd, dT_decompressed, stream),
+                    HIPSPARSE_STATUS_SUCCESS);
+
+            host_vector<Ti> hT_decompressed(hT_pruned.size());
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_decompressed.transfer_from(dT_decompressed));
+            unit_check_general<Ti>(
+                T_row, T_col, ldt, stride_t, hT_pruned, hT_decompressed, num_batches);
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // a row ordered copy of the unpruned matrix with a padded ld must prune to the transpose
+        // of the pruned matrix, compress to the same bytes and decompress back to the pruned copy
+        if(run_version == 2 && arg.unit_check && num_batches == 1)
+        {
+            hipsparseOperation_t        op  = arg.sparse_b ? transB : transA;
+            size_t                      ldr = T_col + 16;
+            hipsparselt_local_mat_descr matR(hipsparselt_matrix_type_structured,
+                                             handle,
+                                             T_row,
+                                             T_col,
+                                             ldr,
+                                             arg.sparse_b ? arg.b_type : arg.a_type,
+                                             HIPSPARSE_ORDER_ROW);
+            EXPECT_HIPSPARSE_STATUS(matR.status(), HIPSPARSE_STATUS_SUCCESS);
+
+            host_vector<Ti> hR(T_row * ldr);
+            host_vector<Ti> hR_gold(T_row * ldr);
+            for(size_t i = 0; i < T_row; i++)
+                for(size_t j = 0; j < ldr; j++)
+                {
+                    bool inside     = j < T_col;
+                    hR[i * ldr + j] = inside ? hT[i + j * ldt] : static_cast<Ti>(0.0f);
+                    hR_gold[i * ldr + j]
+                        = inside ? hT_pruned[i + j * ldt] : static_cast<Ti>(0.0f);
+                }
+
+            device_vector<Ti>            dR(T_row * ldr, 1, HMM);
+            device_vector<Ti>            dR_decompressed(T_row * ldr, 1, HMM);
+            device_vector<unsigned char> dR_compressed(compressed_size, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dR.memcheck());
+            CHECK_DEVICE_ALLOCATION(dR_decompressed.memcheck());
+            CHECK_DEVICE_ALLOCATION(dR_compressed.memcheck());
+            CHECK_HIP_ERROR(dR.transfer_from(hR));
+            CHECK_HIP_ERROR(dR_decompressed.transfer_from(hR));
+
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPrune2(handle,
+                                                           matR,
+                                                           !arg.sparse_b,
+                                                           op,
+                                                           dR,
+                                                           dR,
+                                                           hipsparseLtPruneAlg_t(arg.prune_algo),
+                                                           stream),
+                                    HIPSPARSE_STATUS_SUCCESS);
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompress2(
+                    handle, matR, !arg.sparse_b, op, dR, dR_compressed, dT_compressBuffer, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMADecompress2(handle,
+                                                                matR,
+                                                                !arg.sparse_b,
+                                                                op,
+                                                                dR_compressed,
+                                                                dR_decompressed,
+                                                                stream),
+                                    HIPSPARSE_STATUS_SUCCESS);
+
+            host_vector<Ti>            hR_pruned(T_row * ldr);
+            host_vector<Ti>            hR_decompressed(T_row * ldr);
+            host_vector<unsigned char> hR_compressed(compressed_size);
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hR_pruned.transfer_from(dR));
+            CHECK_HIP_ERROR(hR_decompressed.transfer_from(dR_decompressed));
+            CHECK_HIP_ERROR(hR_compressed.transfer_from(dR_compressed));
+            unit_check_general<Ti>(T_col, T_row, ldr, T_row * ldr, hR_gold, hR_pruned, 1);
+            unit_check_general<Ti>(T_col, T_row, ldr, T_row * ldr, hR_gold, hR_decompressed, 1);
+            unit_check_general<int8_t>(compressed_size,
+                                       1,
+                                       compressed_size,
+                                       reinterpret_cast<int8_t*>(hT_1.data()),
+                                       reinterpret_cast<int8_t*>(hR_compressed.data()));
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // recompress the rows in two calls of disjoint ranges, together they must match the
+        // whole compress, so the second call must leave the rows of the first one untouched.
+        if(run_version == 1 && arg.unit_check)
+        {
+            int64_t rows     = arg.sparse_b ? N : M;
+            int64_t first[]  = {0, rows / 3, rows / 2, rows};
+            int64_t second[] = {rows / 3, rows / 2};
+            size_t  work_list_size;
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAGroupedWorkListSize(handle, 2, &work_list_size),
+                                    HIPSPARSE_STATUS_SUCCESS);
+
+            device_vector<unsigned char> dT_work_list(work_list_size, 1, HMM);
+            device_vector<unsigned char> dT_rows(compressed_size, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_work_list.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_rows.memcheck());
+            CHECK_HIP_ERROR(hipMemsetAsync(dT_rows, 0, compressed_size, stream));
+
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompressRows(
+                    handle, plan, dT, dT_rows, 2, first, dT_work_list, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompressRows(
+                    handle, plan, dT, dT_rows, 1, second, dT_work_list, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+
+            host_vector<unsigned char> hT_rows(compressed_size);
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_rows.transfer_from(dT_rows));
+            unit_check_general<int8_t>(compressed_size,
+                                       1,
+                                       compressed_size,
+                                       reinterpret_cast<int8_t*>(hT_1.data()),
+                                       reinterpret_cast<int8_t*>(hT_rows.data()));
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // a saved compressed matrix must load back into the same bytes
+        if(run_version == 1 && arg.unit_check)
+        {
+            std::string path = hipsparselt_tempname();
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompressedSave(handle, plan, dT_compressd, path.c_str(), stream),
+                HIPSPARSE_STATUS_SUCCESS);
+
+            device_vector<unsigned char> dT_loaded(compressed_size, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_loaded.memcheck());
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompressedLoad(handle, plan, path.c_str(), dT_loaded, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+            remove(path.c_str());
+
+            host_vector<unsigned char> hT_loaded(compressed_size);
+            CHECK_HIP_ERROR(hT_loaded.transfer_from(dT_loaded));
+            unit_check_general<int8_t>(compressed_size,
+                                       1,
+                                       compressed_size,
+                                       reinterpret_cast<int8_t*>(hT_1.data()),
+                                       reinterpret_cast<int8_t*>(hT_loaded.data()));
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // an SGD step with momentum on the compressed matrix, the pruned matrix as its own
+        // gradient, must halve the kept values exactly and leave the pattern as it is
+        if(run_version == 1 && arg.unit_check
+           && (std::is_same<Ti, __half>{} || std::is_same<Ti, hip_bfloat16>{}))
+        {
+            size_t state_size;
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompressedUpdateStateSize(handle, plan, &state_size),
+                HIPSPARSE_STATUS_SUCCESS);
+
+            device_vector<Ti>            dT_grad(hT_pruned.size(), 1, HMM);
+            device_vector<unsigned char> dT_updated(compressed_size, 1, HMM);
+            device_vector<float>         dT_state(state_size / sizeof(float), 1, HMM);
+            device_vector<Ti>            dT_decompressed(hT_pruned.size(), 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_grad.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_updated.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_state.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_decompressed.memcheck());
+            CHECK_HIP_ERROR(dT_grad.transfer_from(hT_pruned));
+            CHECK_HIP_ERROR(hipMemcpyAsync(
+                dT_updated, dT_compressd, compressed_size, hipMemcpyDeviceToDevice, stream));
+            CHECK_HIP_ERROR(hipMemsetAsync(dT_state, 0, state_size, stream));
+
+            hipsparseLtOptimizerParams_t sgd = {HIPSPARSELT_OPTIMIZER_SGD, 0.5f, 0.9f};
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompressedUpdate(
+                    handle, plan, &sgd, dT_updated, dT_grad, dT_state, nullptr, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMADecompress(handle, plan, dT_updated, dT_decompressed, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+
+            host_vector<Ti> hT_decompressed(hT_pruned.size());
+            host_vector<Ti> hT_halved(hT_pruned.size());
+            for(size_t i = 0; i < hT_pruned.size(); i++)
+                hT_halved[i] = static_cast<Ti>(static_cast<float>(hT_pruned[i]) * 0.5f);
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_decompressed.transfer_from(dT_decompressed));
+            unit_check_general<Ti>(
+                T_row, T_col, ldt, stride_t, hT_halved, hT_decompressed, num_batches);
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // pack the compressed matrix to 4 bits and unpack it, each group must come back as its
+        // values rounded to a multiple of max|v| / 7
+        if(run_version == 1 && arg.unit_check
+           && (std::is_same<Ti, __half>{} || std::is_same<Ti, hip_bfloat16>{}))
+        {
+            int64_t group_size = K % 16 == 0 ? 8 : 2;
+            size_t  packed_size;
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompressedInt4Size(handle, plan, group_size, &packed_size),
+                HIPSPARSE_STATUS_SUCCESS);
+
+            device_vector<unsigned char> dT_packed(packed_size, 1, HMM);
+            device_vector<unsigned char> dT_unpacked(compressed_size, 1, HMM);
+            device_vector<Ti>            dT_decompressed(hT_pruned.size(), 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_packed.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_unpacked.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_decompressed.memcheck());
+
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompressedInt4Pack(
+                    handle, plan, group_size, dT_compressd, dT_packed, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMACompressedInt4Unpack(
+                    handle, plan, group_size, dT_packed, dT_unpacked, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMADecompress(handle, plan, dT_unpacked, dT_decompressed, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+
+            // a group of compressed values covers twice as many k of the dense matrix
+            bool    k_rows = arg.sparse_b ? transB == HIPSPARSE_OPERATION_NON_TRANSPOSE
+                                          : transA == HIPSPARSE_OPERATION_TRANSPOSE;
+            int64_t rows   = k_rows ? T_col : T_row;
+            int64_t span   = group_size * 2;
+
+            host_vector<Ti> hT_quantized(hT_pruned);
+            for(int b = 0; b < num_batches; b++)
+                for(int64_t r = 0; r < rows; r++)
+                    for(int64_t k0 = 0; k0 < K; k0 += span)
+                    {
+                        auto at = [&](int64_t k) {
+                            return b * stride_t + (k_rows ? k + r * ldt : r + k * ldt);
+                        };
+                        float max_abs = 0.0f;
+                        for(int64_t k = k0; k < k0 + span; k++)
+                            max_abs = std::max(max_abs,
+                                               std::abs(static_cast<float>(hT_pruned[at(k)])));
+                        float scale = max_abs / 7.0f;
+                        for(int64_t k = k0; k < k0 + span; k++)
+                        {
+                            float v = static_cast<float>(hT_pruned[at(k)]);
+                            int   q = scale == 0.0f ? 0 : static_cast<int>(std::rint(v / scale));
+                            q       = std::max(-8, std::min(7, q));
+
+                            hT_quantized[at(k)] = static_cast<Ti>(static_cast<float>(q) * scale);
+                        }
+                    }
+
+            host_vector<Ti> hT_decompressed(hT_pruned.size());
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_decompressed.transfer_from(dT_decompressed));
+            unit_check_general<Ti>(
+                T_row, T_col, ldt, stride_t, hT_quantized, hT_decompressed, num_batches);
+        }
+#endif
 
         // now we can recycle gold matrix for reference purposes
         if(arg.timing)
@@ -735,33 +1643,66 @@ void testing_compress(const Arguments& arg)
         int number_cold_calls = arg.cold_iters;
         int number_hot_calls  = arg.iters;
 
+        auto compress_call = [&]() {
+            if(run_version == 3)
+                return hipsparseLtSpMMAPruneAndCompress(handle,
+                                                        plan,
+                                                        dT,
+                                                        dT_compressd,
+                                                        dT_compressBuffer,
+                                                        hipsparseLtPruneAlg_t(arg.prune_algo),
+                                                        stream);
+            return hipsparseLtSpMMACompress(
+                handle, plan, dT, dT_compressd, dT_compressBuffer, stream);
+        };
+
         for(int i = 0; i < number_cold_calls; i++)
         {
-            EXPECT_HIPSPARSE_STATUS(
-                hipsparseLtSpMMACompress(handle, plan, dT, dT_compressd, dT_compressBuffer, stream),
-                HIPSPARSE_STATUS_SUCCESS);
+            EXPECT_HIPSPARSE_STATUS(compress_call(), HIPSPARSE_STATUS_SUCCESS);
         }
         CHECK_HIP_ERROR(hipStreamSynchronize(stream));
 
+        hipsparselt_call_timer call_timer(ArgumentModel_get_samples(), number_hot_calls);
         gpu_time_used = get_time_us_sync(stream); // in microseconds
         for(int i = 0; i < number_hot_calls; i++)
         {
-            EXPECT_HIPSPARSE_STATUS(
-                hipsparseLtSpMMACompress(handle, plan, dT, dT_compressd, dT_compressBuffer, stream),
-                HIPSPARSE_STATUS_SUCCESS);
+            call_timer.start(i, stream);
+            EXPECT_HIPSPARSE_STATUS(compress_call(), HIPSPARSE_STATUS_SUCCESS);
+            call_timer.stop(i, stream);
         }
         CHECK_HIP_ERROR(hipStreamSynchronize(stream));
         gpu_time_used = get_time_us_sync(stream) - gpu_time_used;
 
+        // the matrix is read and its compressed copy, with the metadata, written
+        double gbytes = ((arg.sparse_b ? K * N : M * K) * sizeof(Ti)
+                         + double(compressed_size) / num_batches)
+                        / 1e9;
+
         ArgumentModel<e_transA, e_transB, e_M, e_N, e_K, e_lda, e_stride_a, e_batch_count>{}
             .log_args<float>(hipsparselt_cout,
                              arg,
                              gpu_time_used,
                              ArgumentLogging::NA_value,
-                             ArgumentLogging::NA_value,
+                             gbytes,
                              cpu_time_used,
                              hipsparselt_error_c,
                              hipsparselt_error_m);
+        ArgumentModel_log_samples(arg, call_timer.samples_us(), -1, "");
+
+        // the upload of the matrix from the pinned host vector and from a pageable copy of it
+        if(arg.pinned && hT.size())
+        {
+            auto upload_us = [&](const host_vector<Ti>& h) {
+                return hipsparselt_upload_us(dT, h, number_cold_calls, number_hot_calls, stream);
+            };
+            host_vector<Ti> hT_pageable(hT);
+            double          bytes       = double(hT.size()) * sizeof(Ti);
+            double          pinned_us   = upload_us(hT);
+            double          pageable_us = upload_us(hT_pageable);
+            hipsparselt_cout << "upload: pinned " << pinned_us << " us, "
+                             << bytes / pinned_us / 1e3 << " GB/s, pageable " << pageable_us
+                             << " us, " << bytes / pageable_us / 1e3 << " GB/s" << std::endl;
+        }
     }
     CHECK_HIP_ERROR(hipStreamDestroy(stream));
 }
@@ -26,6 +26,7 @@
 
 #pragma once
 
+#include "device_init.hpp"
 #include "flops.hpp"
 #include "hipsparselt_datatype2string.hpp"
 #include "hipsparselt_init.hpp"
@@ -37,6 +38,7 @@
 #include "utility.hpp"
 #include <hipsparselt/hipsparselt.h>
 #include <omp.h>
+#include <set>
 
 template <typename Ti, typename Tc>
 inline Tc norm1(Ti a, Ti b)
@@ -432,6 +434,149 @@ void testing_prune_bad_arg(const Arguments& arg)
         hipsparseLtSpMMAPrune2(
             handle, matA, true, transA, nullptr, dA, HIPSPARSELT_PRUNE_SPMMA_STRIP, stream),
         HIPSPARSE_STATUS_INVALID_VALUE);
+
+#ifdef __HIP_PLATFORM_AMD__
+    // test the check with violation counts
+    device_vector<int64_t> d_count(1);
+    CHECK_DEVICE_ALLOCATION(d_count.memcheck());
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneCheckCount(nullptr, matmul, dA, d_count, nullptr, 0, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneCheckCount(handle, nullptr, dA, d_count, nullptr, 0, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneCheckCount(handle, matmul, nullptr, d_count, nullptr, 0, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneCheckCount(handle, matmul, dA, nullptr, nullptr, 0, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneCheckCount(handle, matmul, dA, d_count, nullptr, 1, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneCheckCount(handle, matmul, dA, d_count, d_count, -1, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    // test the prune with a mask and the mask apply
+    size_t                       mask_size;
+    device_vector<unsigned char> d_mask(safe_size);
+    CHECK_DEVICE_ALLOCATION(d_mask.memcheck());
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneMaskSize(nullptr, matmul, &mask_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneMaskSize(handle, nullptr, &mask_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneMaskSize(handle, matmul, nullptr),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneMask(
+            nullptr, matmul, dA, dA, d_mask, HIPSPARSELT_PRUNE_SPMMA_STRIP, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneMask(
+            handle, nullptr, dA, dA, d_mask, HIPSPARSELT_PRUNE_SPMMA_STRIP, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneMask(
+            handle, matmul, nullptr, dA, d_mask, HIPSPARSELT_PRUNE_SPMMA_STRIP, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneMask(
+            handle, matmul, dA, nullptr, d_mask, HIPSPARSELT_PRUNE_SPMMA_STRIP, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPruneMask(
+            handle, matmul, dA, dA, nullptr, HIPSPARSELT_PRUNE_SPMMA_STRIP, stream),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAMaskApply(nullptr, matmul, dA, dA, d_mask, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAMaskApply(handle, nullptr, dA, dA, d_mask, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAMaskApply(handle, matmul, nullptr, dA, d_mask, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAMaskApply(handle, matmul, dA, nullptr, d_mask, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAMaskApply(handle, matmul, dA, dA, nullptr, stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    // test the prune by score, the mask is optional but a score or a column scale is not
+    device_vector<float> d_score(safe_size);
+    CHECK_DEVICE_ALLOCATION(d_score.memcheck());
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneScored(nullptr,
+                                                        matmul,
+                                                        dA,
+                                                        dA,
+                                                        d_score,
+                                                        nullptr,
+                                                        d_mask,
+                                                        HIPSPARSELT_PRUNE_SPMMA_STRIP,
+                                                        stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneScored(handle,
+                                                        nullptr,
+                                                        dA,
+                                                        dA,
+                                                        d_score,
+                                                        nullptr,
+                                                        d_mask,
+                                                        HIPSPARSELT_PRUNE_SPMMA_STRIP,
+                                                        stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneScored(handle,
+                                                        matmul,
+                                                        nullptr,
+                                                        dA,
+                                                        d_score,
+                                                        nullptr,
+                                                        d_mask,
+                                                        HIPSPARSELT_PRUNE_SPMMA_STRIP,
+                                                        stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneScored(handle,
+                                                        matmul,
+                                                        dA,
+                                                        nullptr,
+                                                        d_score,
+                                                        nullptr,
+                                                        d_mask,
+                                                        HIPSPARSELT_PRUNE_SPMMA_STRIP,
+                                                        stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneScored(handle,
+                                                        matmul,
+                                                        dA,
+                                                        dA,
+                                                        nullptr,
+                                                        nullptr,
+                                                        d_mask,
+                                                        HIPSPARSELT_PRUNE_SPMMA_STRIP,
+                                                        stream),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+#endif
 }
 
 template <typename Ti,
@@ -609,10 +754,15 @@ void testing_prune(const Arguments& arg)
     CHECK_DEVICE_ALLOCATION(dT.memcheck());
     CHECK_DEVICE_ALLOCATION(dT_pruned.memcheck());
 
+    // arg.device_init initializes T on the device, the host copies it for the checks only
+    const bool device_init = arg.device_init
+                             && arg.initialization != hipsparselt_initialization::special;
+    const bool host_copy   = !device_init || arg.unit_check || arg.norm_check;
+
     // Naming: dX is in GPU (device) memory. hK is in CPU (host) memory
-    host_vector<Ti>    hT(arg.sparse_b ? size_B : size_A);
+    host_vector<Ti>    hT(host_copy ? (arg.sparse_b ? size_B : size_A) : 0, 1, arg.pinned);
     host_vector<Ti>    hT_gold(arg.sparse_b ? size_B_copy : size_A_copy);
-    host_vector<Ti>    hT_1(arg.sparse_b ? size_B_copy : size_A_copy);
+    host_vector<Ti>    hT_1(arg.sparse_b ? size_B_copy : size_A_copy, 1, arg.pinned);
     host_vector<float> hT_gold_norm(arg.sparse_b ? size_B_norm_copy : size_A_norm_copy);
     host_vector<float> hT_1_norm(arg.sparse_b ? size_B_norm_copy : size_A_norm_copy);
 
@@ -635,27 +785,46 @@ void testing_prune(const Arguments& arg)
         stride_t = stride_b;
     }
 
-    // Initial Data on CPU
-    if(arg.initialization == hipsparselt_initialization::rand_int)
+    if(!device_init)
     {
-        hipsparselt_init<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
-    }
-    else if(arg.initialization == hipsparselt_initialization::trig_float)
-    {
-        hipsparselt_init_sin<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
-    }
-    else if(arg.initialization == hipsparselt_initialization::hpl)
-    {
-        hipsparselt_init_hpl<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        // Initial Data on CPU
+        if(arg.initialization == hipsparselt_initialization::rand_int)
+        {
+            hipsparselt_init<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        }
+        else if(arg.initialization == hipsparselt_initialization::trig_float)
+        {
+            hipsparselt_init_sin<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        }
+        else if(arg.initialization == hipsparselt_initialization::hpl)
+        {
+            hipsparselt_init_hpl<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        }
+        else if(arg.initialization == hipsparselt_initialization::special)
+        {
+            hipsparselt_init_alt_impl_big<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        }
+
+        // copy data from CPU to device, arg.pinned copies in the order of the stream
+        CHECK_HIP_ERROR(arg.pinned ? dT.transfer_from(hT, stream) : dT.transfer_from(hT));
     }
-    else if(arg.initialization == hipsparselt_initialization::special)
+    else
     {
-        hipsparselt_init_alt_impl_big<Ti>(hT, T_row, T_col, ldt, stride_t, num_batches);
+        const hipsparselt_device_init_mode mode
+            = arg.initialization == hipsparselt_initialization::trig_float
+                  ? hipsparselt_device_init_mode::sin
+              : arg.initialization == hipsparselt_initialization::hpl
+                  ? hipsparselt_device_init_mode::hpl
+                  : hipsparselt_device_init_mode::rand_int;
+        CHECK_HIP_ERROR(hipsparselt_init_device<Ti>(
+            dT, T_row, T_col, ldt, stride_t, num_batches, mode, stream));
+        if(hT.size())
+        {
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT.transfer_from(dT));
+        }
     }
 
-    // copy data from CPU to device
-    CHECK_HIP_ERROR(dT.transfer_from(hT));
-
     if(arg.unit_check || arg.norm_check)
     {
         if(run_version == 1)
@@ -673,8 +842,163 @@ void testing_prune(const Arguments& arg)
                                                            stream),
                                     HIPSPARSE_STATUS_SUCCESS);
 
-        CHECK_HIP_ERROR(hipStreamSynchronize(stream));
-        CHECK_HIP_ERROR(hT_1.transfer_from(dT_pruned));
+        if(arg.pinned)
+        {
+            CHECK_HIP_ERROR(hT_1.transfer_from(dT_pruned, stream));
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+        }
+        else
+        {
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_1.transfer_from(dT_pruned));
+        }
+
+#ifdef __HIP_PLATFORM_AMD__
+        // prune dT twice in one grouped launch, both must match the single prune
+        if(run_version == 2 && arg.unit_check)
+        {
+            const size_t size_T = arg.sparse_b ? size_B : size_A;
+            size_t       work_list_size;
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAGroupedWorkListSize(handle, 2, &work_list_size),
+                                    HIPSPARSE_STATUS_SUCCESS);
+
+            device_vector<unsigned char> dT_work_list(work_list_size, 1, HMM);
+            device_vector<Ti>            dT_grouped(size_T * 2, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_work_list.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_grouped.memcheck());
+
+            hipsparseLtMatDescriptor_t* descr = arg.sparse_b ? matB : matA;
+            hipsparseOperation_t        op    = arg.sparse_b ? transB : transA;
+            Ti*                         out   = dT_grouped;
+
+            const hipsparseLtMatDescriptor_t* descrs[2] = {descr, descr};
+            const void*                       d_in[2]   = {dT, dT};
+            void*                             d_out[2]  = {out, out + size_T};
+
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPrune2Grouped(handle,
+                                                                  2,
+                                                                  descrs,
+                                                                  !arg.sparse_b,
+                                                                  op,
+                                                                  d_in,
+                                                                  d_out,
+                                                                  prune_algo,
+                                                                  dT_work_list,
+                                                                  stream),
+                                    HIPSPARSE_STATUS_SUCCESS);
+
+            host_vector<Ti> hT_grouped(size_T * 2);
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_grouped.transfer_from(dT_grouped));
+            for(int i = 0; i < 2; i++)
+                unit_check_general<Ti>(
+                    T_row, T_col, ldt, stride_t, hT_1, hT_grouped + i * size_T, num_batches);
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // the host prune must pick the same elements as the device
+        if(arg.unit_check)
+        {
+            hipsparseLtDatatype_t type = arg.sparse_b ? arg.b_type : arg.a_type;
+            hipsparseOperation_t  op   = arg.sparse_b ? transB : transA;
+            host_vector<Ti>       hT_host(arg.sparse_b ? size_B : size_A);
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneHost(T_row,
+                                                              T_col,
+                                                              ldt,
+                                                              type,
+                                                              num_batches,
+                                                              stride_t,
+                                                              !arg.sparse_b,
+                                                              op,
+                                                              hT,
+                                                              hT_host,
+                                                              prune_algo,
+                                                              0),
+                                    HIPSPARSE_STATUS_SUCCESS);
+            unit_check_general<Ti>(T_row, T_col, ldt, stride_t, hT_1, hT_host, num_batches);
+        }
+#endif
+
+#ifdef __HIP_PLATFORM_AMD__
+        // the prune with a mask must pick the same elements, and the mask applied to the unpruned
+        // matrix must give the pruned matrix back
+        if(run_version == 1 && arg.unit_check)
+        {
+            const size_t size_T = arg.sparse_b ? size_B : size_A;
+            size_t       mask_size;
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneMaskSize(handle, matmul, &mask_size),
+                                    HIPSPARSE_STATUS_SUCCESS);
+
+            device_vector<unsigned char> dT_mask(mask_size, 1, HMM);
+            device_vector<Ti>            dT_masked(size_T, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_mask.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_masked.memcheck());
+
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMAPruneMask(
+                    handle, matmul, dT, dT_masked, dT_mask, prune_algo, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+
+            host_vector<Ti> hT_masked(size_T);
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_masked.transfer_from(dT_masked));
+            unit_check_general<Ti>(T_row, T_col, ldt, stride_t, hT_1, hT_masked, num_batches);
+
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMAMaskApply(handle, matmul, dT, dT_masked, dT_mask, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_masked.transfer_from(dT_masked));
+            unit_check_general<Ti>(T_row, T_col, ldt, stride_t, hT_1, hT_masked, num_batches);
+
+            // a score equal to the values, or a column scale of ones, must rank like the values
+            host_vector<float> hT_score(size_T);
+            host_vector<float> hT_scale(K);
+            for(size_t i = 0; i < size_T; i++)
+                hT_score[i] = static_cast<float>(hT[i]);
+            for(int64_t i = 0; i < K; i++)
+                hT_scale[i] = 1.0f;
+
+            device_vector<float> dT_score(size_T, 1, HMM);
+            device_vector<float> dT_scale(K, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dT_score.memcheck());
+            CHECK_DEVICE_ALLOCATION(dT_scale.memcheck());
+            CHECK_HIP_ERROR(dT_score.transfer_from(hT_score));
+            CHECK_HIP_ERROR(dT_scale.transfer_from(hT_scale));
+
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneScored(handle,
+                                                                matmul,
+                                                                dT,
+                                                                dT_masked,
+                                                                dT_score,
+                                                                nullptr,
+                                                                nullptr,
+                                                                prune_algo,
+                                                                stream),
+                                    HIPSPARSE_STATUS_SUCCESS);
+
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_masked.transfer_from(dT_masked));
+            unit_check_general<Ti>(T_row, T_col, ldt, stride_t, hT_1, hT_masked, num_batches);
+
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneScored(handle,
+                                                                matmul,
+                                                                dT,
+                                                                dT_masked,
+                                                                nullptr,
+                                                                dT_scale,
+                                                                dT_mask,
+                                                                prune_algo,
+                                                                stream),
+                                    HIPSPARSE_STATUS_SUCCESS);
+
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hT_masked.transfer_from(dT_masked));
+            unit_check_general<Ti>(T_row, T_col, ldt, stride_t, hT_1, hT_masked, num_batches);
+        }
+#endif
 
         //print_strided_batched("device", hT_1.data(), M, K, num_batches, stride_1_a, stride_2_a, stride_a);
 
@@ -715,6 +1039,56 @@ void testing_prune(const Arguments& arg)
             stride_2 = stride_1_b;
         }
 
+#ifdef __HIP_PLATFORM_AMD__
+        if(run_version == 1)
+        {
+            constexpr int          max_offsets = 16;
+            device_vector<int64_t> d_count(1, 1, HMM);
+            device_vector<int64_t> d_offsets(max_offsets, 1, HMM);
+            int64_t                h_count = -1;
+            int64_t                h_offsets[max_offsets];
+
+            // the pruned matrix has no offending group.
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMAPruneCheckCount(
+                                        handle, matmul, dT_pruned, d_count, d_offsets, 0, stream),
+                                    HIPSPARSE_STATUS_SUCCESS);
+            CHECK_HIP_ERROR(
+                hipMemcpyAsync(&h_count, d_count, sizeof(int64_t), hipMemcpyDeviceToHost, stream));
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_SUCCESS(h_count == 0);
+
+            // the dense matrix has as many offending groups as counted on the host.
+            std::set<int64_t> h_offsets_gold;
+            for(int64_t b = 0; b < (stride_t == 0 ? 1 : num_batches); b++)
+                for(int64_t i = 0; i < row; i++)
+                    for(int64_t j = 0; j < col; j += 4)
+                    {
+                        int64_t offset = b * stride_t + i * stride_1 + j * stride_2;
+                        int     nz     = 0;
+                        for(int64_t k = j; k < std::min<int64_t>(j + 4, col); k++)
+                            nz += static_cast<float>(hT[offset + (k - j) * stride_2]) != 0.0f;
+                        if(nz > 2)
+                            h_offsets_gold.insert(offset);
+                    }
+
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtSpMMAPruneCheckCount(
+                    handle, matmul, dT, d_count, d_offsets, max_offsets, stream),
+                HIPSPARSE_STATUS_SUCCESS);
+            CHECK_HIP_ERROR(
+                hipMemcpyAsync(&h_count, d_count, sizeof(int64_t), hipMemcpyDeviceToHost, stream));
+            CHECK_HIP_ERROR(hipMemcpyAsync(h_offsets,
+                                           d_offsets,
+                                           sizeof(int64_t) * max_offsets,
+                                           hipMemcpyDeviceToHost,
+                                           stream));
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_SUCCESS(h_count == static_cast<int64_t>(h_offsets_gold.size()));
+            for(int64_t i = 0; i < std::min<int64_t>(h_count, max_offsets); i++)
+                CHECK_SUCCESS(h_offsets_gold.count(h_offsets[i]) == 1);
+        }
+#endif
+
         // now we can recycle gold matrix for reference purposes
         if(arg.timing)
         {
@@ -780,12 +1154,15 @@ void testing_prune(const Arguments& arg)
         }
         CHECK_HIP_ERROR(hipStreamSynchronize(stream));
 
+        hipsparselt_call_timer call_timer(ArgumentModel_get_samples(), number_hot_calls);
         gpu_time_used = get_time_us_sync(stream); // in microseconds
         for(int i = 0; i < number_hot_calls; i++)
         {
+            call_timer.start(i, stream);
             EXPECT_HIPSPARSE_STATUS(
                 hipsparseLtSpMMAPrune(handle, matmul, dT, dT_pruned, prune_algo, stream),
                 HIPSPARSE_STATUS_SUCCESS);
+            call_timer.stop(i, stream);
         }
         CHECK_HIP_ERROR(hipStreamSynchronize(stream));
         gpu_time_used = get_time_us_sync(stream) - gpu_time_used;
@@ -793,15 +1170,33 @@ void testing_prune(const Arguments& arg)
         double (*gflop_count)(int64_t m, int64_t n);
         gflop_count = (prune_algo == HIPSPARSELT_PRUNE_SPMMA_STRIP) ? prune_strip_gflop_count<Ti>
                                                                     : prune_tile_gflop_count<Ti>;
+        // the matrix is read and its pruned copy written
+        double gbytes = 2.0 * (arg.sparse_b ? K * N : M * K) * sizeof(Ti) / 1e9;
 
         ArgumentModel<e_transA, e_transB, e_M, e_N, e_K, e_lda, e_stride_a, e_batch_count>{}
             .log_args<float>(hipsparselt_cout,
                              arg,
                              gpu_time_used,
                              arg.sparse_b ? gflop_count(K, N) : gflop_count(M, K),
-                             ArgumentLogging::NA_value,
+                             gbytes,
                              cpu_time_used,
                              hipsparselt_error);
+        ArgumentModel_log_samples(arg, call_timer.samples_us(), -1, "");
+
+        // the upload of the matrix from the pinned host vector and from a pageable copy of it
+        if(arg.pinned && hT.size())
+        {
+            auto upload_us = [&](const host_vector<Ti>& h) {
+                return hipsparselt_upload_us(dT, h, number_cold_calls, number_hot_calls, stream);
+            };
+            host_vector<Ti> hT_pageable(hT);
+            double          bytes       = double(hT.size()) * sizeof(Ti);
+            double          pinned_us   = upload_us(hT);
+            double          pageable_us = upload_us(hT_pageable);
+            hipsparselt_cout << "upload: pinned " << pinned_us << " us, "
+                             << bytes / pinned_us / 1e3 << " GB/s, pageable " << pageable_us
+                             << " us, " << bytes / pageable_us / 1e3 << " GB/s" << std::endl;
+        }
     }
     CHECK_HIP_ERROR(hipStreamDestroy(stream));
 }
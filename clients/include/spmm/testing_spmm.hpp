@@ -27,6 +27,8 @@
 #pragma once
 
 #include "cblas_interface.hpp"
+#include "device_init.hpp"
+#include "device_reference.hpp"
 #include "flops.hpp"
 #include "hipsparselt_datatype2string.hpp"
 #include "hipsparselt_init.hpp"
@@ -38,9 +40,14 @@
 #include "norm.hpp"
 #include "unit.hpp"
 #include "utility.hpp"
+#include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <hipsparselt/hipsparselt.h>
+#include <memory>
+#include <numeric>
 #include <omp.h>
+#include <thread>
 
 template <typename T, typename Tb = T, typename To = T>
 void bias(int64_t m, int64_t n, int64_t ld, T* src, To* dest, Tb* bias)
@@ -51,10 +58,18 @@ void bias(int64_t m, int64_t n, int64_t ld, T* src, To* dest, Tb* bias)
         return static_cast<To>(_val);
     };
 
+    auto saturate_i32 = [](Tb val) {
+        auto _val = std::nearbyint(static_cast<double>(val));
+        _val      = std::min(std::max(_val, -2147483648.0), 2147483647.0);
+        return static_cast<To>(_val);
+    };
+
     auto saturate_o = [](Tb val) { return static_cast<To>(val); };
 
     To (*saturate)(Tb val);
     saturate = std::is_same<int8_t, To>() ? saturate_i8 : saturate_o;
+    if(std::is_same<int32_t, To>())
+        saturate = saturate_i32;
 
     using TAccum = std::conditional_t<std::is_same<__half, Tb>::value, float, Tb>;
 
@@ -85,10 +100,18 @@ void activation(int64_t m, int64_t n, int64_t ld, Ti* in, To* out, Tact arg1, Ta
         return static_cast<To>(_val);
     };
 
+    auto saturate_i32 = [](Tact val) {
+        auto _val = std::nearbyint(static_cast<double>(val));
+        _val      = std::min(std::max(_val, -2147483648.0), 2147483647.0);
+        return static_cast<To>(_val);
+    };
+
     auto saturate_o = [](Tact val) { return static_cast<To>(val); };
 
     To (*saturate)(Tact val);
     saturate = std::is_same<int8_t, To>() ? saturate_i8 : saturate_o;
+    if(std::is_same<int32_t, To>())
+        saturate = saturate_i32;
 
     for(int i = 0; i < m; i++)
     {
@@ -102,6 +125,55 @@ void activation(int64_t m, int64_t n, int64_t ld, Ti* in, To* out, Tact arg1, Ta
     }
 }
 
+// The largest finite value of To, the bound of the saturation of D
+template <typename To>
+float max_finite()
+{
+    if constexpr(std::is_same<To, __half>{})
+        return 65504.f;
+    else if constexpr(std::is_same<To, hip_bfloat16>{})
+        return 3.38953139e38f;
+    else
+        return std::numeric_limits<float>::max();
+}
+
+// The epilogue of D: the gate, the residual, amax of the result, then the scale and the
+// saturation to To
+template <typename T, typename To>
+void epilogue_d(int64_t   m,
+                int64_t   n,
+                int64_t   ld,
+                T*        in,
+                const To* gate,
+                const To* residual,
+                To*       out,
+                float     scale,
+                bool      saturate,
+                float&    amax)
+{
+    for(int j = 0; j < n; j++)
+    {
+        for(int i = 0; i < m; i++)
+        {
+            auto  pos   = j * ld + i;
+            float value = static_cast<float>(*(in + pos));
+            if(gate)
+                value *= static_cast<float>(*(gate + pos));
+            if(residual)
+                value += static_cast<float>(*(residual + pos));
+            amax = std::max(amax, std::abs(value));
+            value *= scale;
+            if constexpr(std::is_same<int8_t, To>())
+                value = std::min(std::max(std::nearbyint(value), -128.f), 127.f);
+            else if constexpr(std::is_same<int32_t, To>())
+                value = std::min(std::max(std::nearbyint(value), -2147483648.f), 2147483520.f);
+            else if(saturate && !std::isnan(value))
+                value = std::min(std::max(value, -max_finite<To>()), max_finite<To>());
+            *(out + pos) = static_cast<To>(value);
+        }
+    }
+}
+
 auto _relu = [](auto in, auto /*arg1*/, auto /*arg2*/) -> decltype(in) {
     return static_cast<decltype(in)>(std::max(static_cast<decltype(in)>(0), in));
 };
@@ -151,6 +223,19 @@ auto _tanh = [](auto in, auto arg1, auto arg2) -> decltype(in) {
     return static_cast<decltype(in)>(std::tanh(in_Tc * arg1_Tc) * arg2_Tc);
 };
 
+auto _silu = [](auto in, auto /*arg1*/, auto /*arg2*/) -> decltype(in) {
+    using Tc = float;
+    Tc in_Tc = static_cast<Tc>(in);
+    return static_cast<decltype(in)>(in_Tc / (1.f + std::exp(-in_Tc)));
+};
+
+auto _clamp = [](auto in, auto arg1, auto arg2) -> decltype(in) {
+    using Tc = float;
+    Tc in_Tc = static_cast<Tc>(in);
+    return static_cast<decltype(in)>(
+        std::min(std::max(in_Tc, static_cast<Tc>(arg1)), static_cast<Tc>(arg2)));
+};
+
 template <typename Ti, typename To, typename Tc>
 void testing_spmm_bad_arg(const Arguments& arg)
 {
@@ -254,13 +339,42 @@ void testing_spmm(const Arguments& arg)
     int64_t ldc     = arg.ldc;
     int64_t ldd     = arg.ldd;
 
+    // the scales of A and B multiply alpha
+    Talpha h_alpha_ref = h_alpha * arg.scale_a * arg.scale_b;
+
+    // arg.workspace_pool gives the handle a workspace pool, the matmuls then get a NULL workspace
+    if(arg.workspace_pool)
+        setenv("HIPSPARSELT_WORKSPACE_POOL_SIZE", "268435456", 1);
+    // arg.plan_stats makes the handle time every matmul of its plans
+    if(arg.plan_stats)
+        setenv("HIPSPARSELT_PLAN_STATS", "1", 1);
+    // the samples file records the kernel of the plan, which the stats report, without timing
+    const bool samples = arg.timing && ArgumentModel_get_samples();
+    if(samples && !arg.plan_stats)
+        setenv("HIPSPARSELT_PLAN_STATS", "1000000000", 1);
+
     double gpu_time_used, cpu_time_used;
     gpu_time_used = cpu_time_used              = 0.0;
     double                   hipsparselt_error = 0.0;
     bool                     HMM               = arg.HMM;
     hipsparselt_local_handle handle{arg};
     hipStream_t              stream;
-    CHECK_HIP_ERROR(hipStreamCreate(&stream));
+    if(arg.workspace_pool)
+        unsetenv("HIPSPARSELT_WORKSPACE_POOL_SIZE");
+    if(arg.plan_stats || samples)
+        unsetenv("HIPSPARSELT_PLAN_STATS");
+#ifdef __HIP_PLATFORM_AMD__
+    // arg.cu_count > 0 runs the test on a stream masked to the first cu_count CUs
+    if(arg.cu_count > 0)
+    {
+        std::vector<uint32_t> cu_mask((arg.cu_count + 31) / 32, 0);
+        for(int i = 0; i < arg.cu_count; i++)
+            cu_mask[i / 32] |= 1u << (i % 32);
+        CHECK_HIP_ERROR(hipExtStreamCreateWithCUMask(&stream, cu_mask.size(), cu_mask.data()));
+    }
+    else
+#endif
+        CHECK_HIP_ERROR(hipStreamCreate(&stream));
 
     int64_t A_row = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? M : K;
     int64_t A_col = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : M;
@@ -278,9 +392,9 @@ void testing_spmm(const Arguments& arg)
     int64_t        stride_c           = do_strided_batched ? arg.stride_c : ldc * N;
     int64_t        stride_d           = do_strided_batched ? arg.stride_c : ldd * N;
     int64_t bias_stride = do_strided_batched ? arg.bias_stride == -1 ? M : arg.bias_stride : 0;
+    bool is_16b = arg.a_type == HIPSPARSELT_R_16F || arg.a_type == HIPSPARSELT_R_16BF;
     hipsparseLtDatatype_t bias_type
-        = arg.bias_type == 0 ? (arg.a_type == HIPSPARSELT_R_8I ? HIPSPARSELT_R_32F : arg.a_type)
-                             : arg.bias_type;
+        = arg.bias_type == 0 ? (is_16b ? arg.a_type : HIPSPARSELT_R_32F) : arg.bias_type;
 
     hipsparselt_local_mat_descr matA(arg.sparse_b ? hipsparselt_matrix_type_dense
                                                   : hipsparselt_matrix_type_structured,
@@ -382,6 +496,15 @@ void testing_spmm(const Arguments& arg)
 #ifdef __HIP_PLATFORM_NVIDIA__
     if(matmul.status() != HIPSPARSE_STATUS_SUCCESS)
         return;
+    // cusparseLt has no pointer-array batched matmul
+    if(arg.pointer_array)
+        return;
+    // the N of a cusparseLt plan is fixed
+    if(arg.dynamic_n > 0)
+        return;
+    // nor has cusparseLt a workspace pool or plan counters
+    if(arg.workspace_pool || arg.plan_stats)
+        return;
     if(!(arg.activation_type == hipsparselt_activation_type::none
          || arg.activation_type == hipsparselt_activation_type::relu
          || arg.activation_type == hipsparselt_activation_type::gelu
@@ -496,6 +619,38 @@ void testing_spmm(const Arguments& arg)
                                               sizeof(float)),
             HIPSPARSE_STATUS_SUCCESS);
         break;
+    case hipsparselt_activation_type::silu:
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(handle,
+                                              matmul,
+                                              HIPSPARSELT_MATMUL_ACTIVATION_SILU,
+                                              &activation_on,
+                                              sizeof(activation_on)),
+            HIPSPARSE_STATUS_SUCCESS);
+        break;
+    case hipsparselt_activation_type::clamp:
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(handle,
+                                              matmul,
+                                              HIPSPARSELT_MATMUL_ACTIVATION_CLAMP,
+                                              &activation_on,
+                                              sizeof(activation_on)),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(handle,
+                                              matmul,
+                                              HIPSPARSELT_MATMUL_ACTIVATION_CLAMP_MIN,
+                                              &arg.activation_arg1,
+                                              sizeof(float)),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(handle,
+                                              matmul,
+                                              HIPSPARSELT_MATMUL_ACTIVATION_CLAMP_MAX,
+                                              &arg.activation_arg2,
+                                              sizeof(float)),
+            HIPSPARSE_STATUS_SUCCESS);
+        break;
     default:
         activation_on = 0;
         break;
@@ -532,8 +687,228 @@ void testing_spmm(const Arguments& arg)
 #endif
     }
 
+    // vectors of alpha and beta scale every row alike, so the scalar reference still holds
+    const size_t          size_scale = arg.alpha_vector_scaling ? M : 0;
+    device_vector<Talpha> dAlphaVec(size_scale, 1, HMM);
+    device_vector<Talpha> dBetaVec(size_scale, 1, HMM);
+    CHECK_DEVICE_ALLOCATION(dAlphaVec.memcheck());
+    CHECK_DEVICE_ALLOCATION(dBetaVec.memcheck());
+    const void* alpha_arg = &h_alpha;
+    const void* beta_arg  = &h_beta;
+    if(arg.alpha_vector_scaling)
+    {
+        host_vector<Talpha> hAlphaVec(size_scale), hBetaVec(size_scale);
+        for(size_t i = 0; i < size_scale; i++)
+        {
+            hAlphaVec[i] = h_alpha;
+            hBetaVec[i]  = h_beta;
+        }
+        CHECK_HIP_ERROR(dAlphaVec.transfer_from(hAlphaVec));
+        CHECK_HIP_ERROR(dBetaVec.transfer_from(hBetaVec));
+        alpha_arg = dAlphaVec;
+        beta_arg  = dBetaVec;
+
+        int enable = 1;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_ALPHA_VECTOR_SCALING, &enable, sizeof(int)),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_BETA_VECTOR_SCALING, &enable, sizeof(int)),
+            HIPSPARSE_STATUS_SUCCESS);
+    }
+
+    // the scale and saturation of D, amax(D), the gate, the residual and the bias gradient, the
+    // gate and the residual have the layout of D
+    bool d_epilogue = arg.d_scale != 1 || arg.d_saturate || arg.amax_d || arg.residual || arg.gate
+                      || arg.bias_grad;
+    const size_t size_R = arg.residual ? (stride_d == 0 ? ldd * N : stride_d) * num_batches : 0;
+    const size_t size_G = arg.gate ? (stride_d == 0 ? ldd * N : stride_d) * num_batches : 0;
+
+    device_vector<float> dAmax(arg.amax_d ? 1 : 0, 1, HMM);
+    device_vector<To>    dR(size_R, 1, HMM);
+    device_vector<To>    dG(size_G, 1, HMM);
+    device_vector<float> dBiasGrad(arg.bias_grad ? M : 0, 1, HMM);
+    CHECK_DEVICE_ALLOCATION(dAmax.memcheck());
+    CHECK_DEVICE_ALLOCATION(dR.memcheck());
+    CHECK_DEVICE_ALLOCATION(dG.memcheck());
+    CHECK_DEVICE_ALLOCATION(dBiasGrad.memcheck());
+#ifdef __HIP_PLATFORM_NVIDIA__
+    // the scales of A, B and D and the CU count are HIP backend only
+    if(d_epilogue || arg.scale_a != 1 || arg.scale_b != 1 || arg.cu_count > 0
+       || arg.sparse_dynamic)
+        return;
+#else
+    if(arg.sparse_dynamic)
+    {
+        int enable = 1;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_SPARSE_DYNAMIC, &enable, sizeof(int)),
+            HIPSPARSE_STATUS_SUCCESS);
+    }
+
+    if(d_epilogue)
+    {
+        int   d_saturate = arg.d_saturate;
+        void* _dAmax     = arg.amax_d ? static_cast<float*>(dAmax) : nullptr;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_D_SCALE, &arg.d_scale, sizeof(float)),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_D_SATURATE, &d_saturate, sizeof(int)),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_AMAX_D_POINTER, &_dAmax, sizeof(void*)),
+            HIPSPARSE_STATUS_SUCCESS);
+    }
+
+    if(arg.residual)
+    {
+        void*   _dR             = dR;
+        int64_t residual_stride = stride_d;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_RESIDUAL_POINTER, &_dR, sizeof(void*)),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(handle,
+                                              matmul,
+                                              HIPSPARSELT_MATMUL_RESIDUAL_STRIDE,
+                                              &residual_stride,
+                                              sizeof(int64_t)),
+            HIPSPARSE_STATUS_SUCCESS);
+    }
+
+    if(arg.bias_grad)
+    {
+        void* _dBiasGrad = dBiasGrad;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_BIAS_GRAD_POINTER, &_dBiasGrad, sizeof(void*)),
+            HIPSPARSE_STATUS_SUCCESS);
+    }
+
+    if(arg.gate)
+    {
+        void*   _dG         = dG;
+        int64_t gate_stride = stride_d;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_GATE_POINTER, &_dG, sizeof(void*)),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_GATE_STRIDE, &gate_stride, sizeof(int64_t)),
+            HIPSPARSE_STATUS_SUCCESS);
+    }
+
+    if(arg.scale_a != 1 || arg.scale_b != 1)
+    {
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_SCALE_A, &arg.scale_a, sizeof(float)),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_SCALE_B, &arg.scale_b, sizeof(float)),
+            HIPSPARSE_STATUS_SUCCESS);
+    }
+
+    // the configs are selected for the CUs of the stream
+    if(arg.cu_count > 0)
+    {
+        int cu_count = arg.cu_count;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_CU_COUNT, &cu_count, sizeof(int)),
+            HIPSPARSE_STATUS_SUCCESS);
+        cu_count = 0;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescGetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_CU_COUNT, &cu_count, sizeof(int)),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_EQ(cu_count, arg.cu_count);
+    }
+
+    // the selection heuristic ranks the configs, only the best ranked are kept
+    if(arg.candidates > 0)
+    {
+        int candidates = arg.candidates;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulDescSetAttribute(
+                handle, matmul, HIPSPARSELT_MATMUL_CANDIDATES, &candidates, sizeof(int)),
+            HIPSPARSE_STATUS_SUCCESS);
+    }
+#endif
+
     hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
 
+    // not supported when no config of this problem fuses the vector scaling, the epilogue of D,
+    // the SiLU and clamp activations or an int32 D, which only the reduce kernel of Split-K
+    // computes
+    bool reduce_activation = arg.activation_type == hipsparselt_activation_type::silu
+                             || arg.activation_type == hipsparselt_activation_type::clamp;
+    bool is_i32            = arg.d_type == HIPSPARSELT_R_32I;
+    if((arg.alpha_vector_scaling || d_epilogue || reduce_activation || is_i32)
+       && alg_sel.status() == HIPSPARSE_STATUS_NOT_SUPPORTED)
+        return;
+
+    // not supported when the kernels of this arch have no FP8 instructions
+    bool is_f8 = arg.a_type == HIPSPARSELT_R_8F || arg.a_type == HIPSPARSELT_R_8BF;
+    if(is_f8 && alg_sel.status() == HIPSPARSE_STATUS_NOT_SUPPORTED)
+        return;
+
+    if(arg.split_k)
+    {
+        // not supported when no kernel of this problem splits K by the factor
+        hipsparseStatus_t status = hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_SPLIT_K, &arg.split_k, sizeof(int));
+        if(status == HIPSPARSE_STATUS_NOT_SUPPORTED)
+            return;
+        EXPECT_HIPSPARSE_STATUS(status, HIPSPARSE_STATUS_SUCCESS);
+    }
+
+    if(arg.stream_k)
+    {
+        // not supported when the tiles of this problem fill whole waves of the device
+        int               stream_k = 1;
+        hipsparseStatus_t status   = hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_STREAM_K, &stream_k, sizeof(int));
+        if(status == HIPSPARSE_STATUS_NOT_SUPPORTED)
+            return;
+        EXPECT_HIPSPARSE_STATUS(status, HIPSPARSE_STATUS_SUCCESS);
+    }
+
+#ifdef __HIP_PLATFORM_AMD__
+    // each config scores the fraction of the peak the selection heuristic predicts for it
+    if(arg.candidates > 0)
+    {
+        int config_max_id = 0;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulAlgGetAttribute(
+                handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID, &config_max_id, sizeof(int)),
+            HIPSPARSE_STATUS_SUCCESS);
+        std::vector<float> scores(config_max_id + 1, -1.0f);
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulAlgGetAttribute(handle,
+                                                                 alg_sel,
+                                                                 HIPSPARSELT_MATMUL_CONFIG_SCORES,
+                                                                 scores.data(),
+                                                                 scores.size() * sizeof(float)),
+                                HIPSPARSE_STATUS_SUCCESS);
+        for(int i = 0; i < config_max_id; i++)
+        {
+            EXPECT_GT(scores[i], 0.0f);
+            EXPECT_LE(scores[i], 1.0f);
+        }
+        EXPECT_EQ(scores[config_max_id], 0.0f);
+    }
+#endif
+
     size_t workspace_size = 0, compressed_size = 0, compress_buffer_size = 0;
 
     {
@@ -558,6 +933,30 @@ void testing_spmm(const Arguments& arg)
                                              HIPSPARSELT_MATMUL_SEARCH_ITERATIONS,
                                              &arg.search_iters,
                                              sizeof(int));
+            if(arg.search_flush_cache)
+            {
+                int flush_cache = 1;
+                EXPECT_HIPSPARSE_STATUS(
+                    hipsparseLtMatmulAlgSetAttribute(handle,
+                                                     alg_sel,
+                                                     HIPSPARSELT_MATMUL_SEARCH_FLUSH_CACHE,
+                                                     &flush_cache,
+                                                     sizeof(int)),
+                    HIPSPARSE_STATUS_SUCCESS);
+            }
+#ifdef __HIP_PLATFORM_AMD__
+            if(arg.search_dense)
+            {
+                int search_dense = 1;
+                EXPECT_HIPSPARSE_STATUS(
+                    hipsparseLtMatmulAlgSetAttribute(handle,
+                                                     alg_sel,
+                                                     HIPSPARSELT_MATMUL_SEARCH_DENSE,
+                                                     &search_dense,
+                                                     sizeof(int)),
+                    HIPSPARSE_STATUS_SUCCESS);
+            }
+#endif
         }
         else
         {
@@ -579,8 +978,23 @@ void testing_spmm(const Arguments& arg)
     const size_t size_pruned_copy = arg.unit_check || arg.norm_check || arg.timing ? (arg.sparse_b ? size_B : size_A) : 0;
     const size_t size_C      = stride_c == 0 ? ldc * N * num_batches : stride_c * num_batches;
     const size_t size_D      = stride_d == 0 ? ldd * N * num_batches : stride_d * num_batches;
-    const size_t size_D_copy = arg.unit_check || arg.norm_check ? size_D : 0;
+    // arg.device_reference computes the reference of a matmul without epilogue on the device and
+    // compares D with it there, the host then holds no copy of D
+    const bool   device_ref  = (arg.unit_check || arg.norm_check) && arg.device_reference
+                            && !(activation_on || arg.bias_vector || d_epilogue);
+    const size_t size_D_copy = (arg.unit_check || arg.norm_check) && !device_ref ? size_D : 0;
+    const size_t size_D_gold = device_ref ? size_D : 0;
+    // a grouped or a sharded launch runs the plan a second time into its own D and workspace
+    const bool   twice           = arg.grouped || arg.sharded;
+    const size_t size_D2         = twice ? size_D : 0;
+    const size_t size_D2_copy    = twice ? size_D_copy : 0;
+    const size_t workspace2_size = twice ? workspace_size : 0;
     const size_t size_D_act_copy = activation_on ? size_D_copy : 0;
+    // arg.device_init initializes A, B, C, R and G on the device, the host keeps a copy of them for
+    // the host reference only
+    const bool device_init = arg.device_init && !arg.alpha_isnan<Tc>() && !arg.beta_isnan<Tc>()
+                             && arg.initialization != hipsparselt_initialization::special;
+    const bool host_copies = !device_init || size_D_copy;
 
     // allocate memory on device
     device_vector<Ti>            dA(size_A, 1, HMM);
@@ -590,76 +1004,131 @@ void testing_spmm(const Arguments& arg)
     device_vector<unsigned char> d_compressed(compressed_size, 1, HMM);
     device_vector<unsigned char> d_compressBuffer(compress_buffer_size, 1, HMM);
     device_vector<unsigned char> dWorkspace(workspace_size, 1, HMM);
+    device_vector<To>            dD2(size_D2, 1, HMM);
+    device_vector<unsigned char> dWorkspace2(workspace2_size, 1, HMM);
+    device_vector<To>            dD_gold(size_D_gold, 1, HMM);
     CHECK_DEVICE_ALLOCATION(dA.memcheck());
     CHECK_DEVICE_ALLOCATION(dB.memcheck());
     CHECK_DEVICE_ALLOCATION(dC.memcheck());
     CHECK_DEVICE_ALLOCATION(dD.memcheck());
     CHECK_DEVICE_ALLOCATION(d_compressed.memcheck());
     CHECK_DEVICE_ALLOCATION(dWorkspace.memcheck());
+    CHECK_DEVICE_ALLOCATION(dD2.memcheck());
+    CHECK_DEVICE_ALLOCATION(dWorkspace2.memcheck());
+    CHECK_DEVICE_ALLOCATION(dD_gold.memcheck());
+    void* dWorkspace_  = arg.workspace_pool ? nullptr : static_cast<void*>(dWorkspace);
+    void* dWorkspace2_ = arg.workspace_pool ? nullptr : static_cast<void*>(dWorkspace2);
 
     // Naming: dX is in GPU (device) memory. hK is in CPU (host) memory
-    host_vector<Ti>     hA(size_A);
+    host_vector<Ti>     hA(host_copies ? size_A : 0);
     host_vector<Ti>     h_pruned(size_pruned_copy);
-    host_vector<Ti>     hB(size_B);
-    host_vector<To>     hC(size_C);
+    host_vector<Ti>     hB(host_copies ? size_B : 0);
+    host_vector<To>     hC(host_copies ? size_C : 0);
     host_vector<To>     hD_gold(size_D_copy);
     host_vector<Talpha> hD_gold_act(size_D_copy);
     host_vector<To>     hD_1(size_D_copy);
+    host_vector<To>     hD_2(size_D2_copy);
+    host_vector<To>     hR(host_copies ? size_R : 0);
+    host_vector<To>     hG(host_copies ? size_G : 0);
 
-    // Initial Data on CPU
-    if(arg.alpha_isnan<Tc>())
-    {
-        hipsparselt_init_nan<Ti>(hA, A_row, A_col, lda, stride_a, num_batches);
-        hipsparselt_init_nan<Ti>(hB, B_row, B_col, ldb, stride_b, num_batches);
-    }
-    else
+    if(!device_init)
     {
-        if(arg.initialization == hipsparselt_initialization::rand_int)
+        // Initial Data on CPU
+        if(arg.alpha_isnan<Tc>())
         {
-            hipsparselt_init<Ti>(hA, A_row, A_col, lda, stride_a, num_batches);
-            hipsparselt_init_alternating_sign<Ti>(hB, B_row, B_col, ldb, stride_b, num_batches);
+            hipsparselt_init_nan<Ti>(hA, A_row, A_col, lda, stride_a, num_batches);
+            hipsparselt_init_nan<Ti>(hB, B_row, B_col, ldb, stride_b, num_batches);
         }
-        else if(arg.initialization == hipsparselt_initialization::trig_float)
+        else
         {
-            hipsparselt_init_sin<Ti>(hA, A_row, A_col, lda, stride_a, num_batches);
-            hipsparselt_init_cos<Ti>(hB, B_row, B_col, ldb, stride_b, num_batches);
+            if(arg.initialization == hipsparselt_initialization::rand_int)
+            {
+                hipsparselt_init<Ti>(hA, A_row, A_col, lda, stride_a, num_batches);
+                hipsparselt_init_alternating_sign<Ti>(hB, B_row, B_col, ldb, stride_b, num_batches);
+            }
+            else if(arg.initialization == hipsparselt_initialization::trig_float)
+            {
+                hipsparselt_init_sin<Ti>(hA, A_row, A_col, lda, stride_a, num_batches);
+                hipsparselt_init_cos<Ti>(hB, B_row, B_col, ldb, stride_b, num_batches);
+            }
+            else if(arg.initialization == hipsparselt_initialization::hpl)
+            {
+                hipsparselt_init_hpl<Ti>(hA, A_row, A_col, lda, stride_a, num_batches);
+                hipsparselt_init_hpl<Ti>(hB, B_row, B_col, ldb, stride_b, num_batches);
+            }
+            else if(arg.initialization == hipsparselt_initialization::special)
+            {
+                hipsparselt_init_alt_impl_big<Ti>(hA, A_row, A_col, lda, num_batches);
+                hipsparselt_init_alt_impl_small<Ti>(hB, B_row, B_col, ldb, num_batches);
+            }
         }
-        else if(arg.initialization == hipsparselt_initialization::hpl)
+
+        if(arg.beta_isnan<Tc>())
         {
-            hipsparselt_init_hpl<Ti>(hA, A_row, A_col, lda, stride_a, num_batches);
-            hipsparselt_init_hpl<Ti>(hB, B_row, B_col, ldb, stride_b, num_batches);
+            hipsparselt_init_nan<To>(hC, M, N, ldc, stride_c, num_batches);
         }
-        else if(arg.initialization == hipsparselt_initialization::special)
+        else
         {
-            hipsparselt_init_alt_impl_big<Ti>(hA, A_row, A_col, lda, num_batches);
-            hipsparselt_init_alt_impl_small<Ti>(hB, B_row, B_col, ldb, num_batches);
+            if(arg.initialization == hipsparselt_initialization::rand_int)
+                hipsparselt_init<To>(hC, M, N, ldc, stride_c, num_batches);
+            else if(arg.initialization == hipsparselt_initialization::trig_float)
+                hipsparselt_init_sin<To>(hC, M, N, ldc, stride_c, num_batches);
+            else if(arg.initialization == hipsparselt_initialization::hpl)
+                hipsparselt_init_hpl<To>(hC, M, N, ldc, stride_c, num_batches);
+            else if(arg.initialization == hipsparselt_initialization::special)
+                hipsparselt_init<To>(hC, M, N, ldc, stride_c, num_batches);
         }
-    }
 
-    if(arg.beta_isnan<Tc>())
-    {
-        hipsparselt_init_nan<To>(hC, M, N, ldc, stride_c, num_batches);
+        if(arg.residual)
+            hipsparselt_init<To>(hR, M, N, ldd, stride_d, num_batches);
+        if(arg.gate)
+            hipsparselt_init<To>(hG, M, N, ldd, stride_d, num_batches);
+
+        // copy data from CPU to device
+        CHECK_HIP_ERROR(dA.transfer_from(hA));
+        CHECK_HIP_ERROR(dB.transfer_from(hB));
+        CHECK_HIP_ERROR(dC.transfer_from(hC));
+        if(arg.residual)
+            CHECK_HIP_ERROR(dR.transfer_from(hR));
+        if(arg.gate)
+            CHECK_HIP_ERROR(dG.transfer_from(hG));
     }
     else
     {
-        if(arg.initialization == hipsparselt_initialization::rand_int)
-            hipsparselt_init<To>(hC, M, N, ldc, stride_c, num_batches);
-        else if(arg.initialization == hipsparselt_initialization::trig_float)
-            hipsparselt_init_sin<To>(hC, M, N, ldc, stride_c, num_batches);
-        else if(arg.initialization == hipsparselt_initialization::hpl)
-            hipsparselt_init_hpl<To>(hC, M, N, ldc, stride_c, num_batches);
-        else if(arg.initialization == hipsparselt_initialization::special)
-            hipsparselt_init<To>(hC, M, N, ldc, stride_c, num_batches);
+        using mode        = hipsparselt_device_init_mode;
+        const bool trig   = arg.initialization == hipsparselt_initialization::trig_float;
+        const bool hpl    = arg.initialization == hipsparselt_initialization::hpl;
+        const mode mode_A = trig ? mode::sin : hpl ? mode::hpl : mode::rand_int;
+        const mode mode_B = trig ? mode::cos : hpl ? mode::hpl : mode::rand_int_alternating_sign;
+        CHECK_HIP_ERROR(hipsparselt_init_device<Ti>(
+            dA, A_row, A_col, lda, stride_a, num_batches, mode_A, stream));
+        CHECK_HIP_ERROR(hipsparselt_init_device<Ti>(
+            dB, B_row, B_col, ldb, stride_b, num_batches, mode_B, stream));
+        CHECK_HIP_ERROR(
+            hipsparselt_init_device<To>(dC, M, N, ldc, stride_c, num_batches, mode_A, stream));
+        if(arg.residual)
+            CHECK_HIP_ERROR(hipsparselt_init_device<To>(
+                dR, M, N, ldd, stride_d, num_batches, mode::rand_int, stream));
+        if(arg.gate)
+            CHECK_HIP_ERROR(hipsparselt_init_device<To>(
+                dG, M, N, ldd, stride_d, num_batches, mode::rand_int, stream));
+
+        if(host_copies)
+        {
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            CHECK_HIP_ERROR(hA.transfer_from(dA));
+            CHECK_HIP_ERROR(hB.transfer_from(dB));
+            CHECK_HIP_ERROR(hC.transfer_from(dC));
+            if(arg.residual)
+                CHECK_HIP_ERROR(hR.transfer_from(dR));
+            if(arg.gate)
+                CHECK_HIP_ERROR(hG.transfer_from(dG));
+        }
     }
 
-    // copy data from CPU to device
-    CHECK_HIP_ERROR(dA.transfer_from(hA));
-    CHECK_HIP_ERROR(dB.transfer_from(hB));
-    CHECK_HIP_ERROR(dC.transfer_from(hC));
-
     if(size_D_copy)
     {
-        if(activation_on || arg.bias_vector)
+        if(activation_on || arg.bias_vector || d_epilogue)
         {
             std::transform(hC.begin(), hC.end(), hD_gold_act.begin(), [](To c) -> Talpha {
                 return static_cast<Talpha>(c);
@@ -690,46 +1159,288 @@ void testing_spmm(const Arguments& arg)
         hB_ = h_pruned;
     }
 
+    // a dynamic sparse matmul prunes and compresses the dense matrix itself, the matrix is only
+    // pruned for the reference
+    device_vector<Ti> d_dense(arg.sparse_dynamic ? (arg.sparse_b ? size_B : size_A) : 0, 1, HMM);
+    CHECK_DEVICE_ALLOCATION(d_dense.memcheck());
+    if(arg.sparse_dynamic)
+    {
+        CHECK_HIP_ERROR(hipMemcpy(d_dense,
+                                  dP,
+                                  (arg.sparse_b ? size_B : size_A) * sizeof(Ti),
+                                  hipMemcpyDeviceToDevice));
+        (arg.sparse_b ? dB_ : dA_) = d_dense;
+    }
+
     EXPECT_HIPSPARSE_STATUS(
         hipsparseLtSpMMAPrune(handle, matmul, dP, dP, HIPSPARSELT_PRUNE_SPMMA_STRIP, stream),
         HIPSPARSE_STATUS_SUCCESS);
 
-    EXPECT_HIPSPARSE_STATUS(
-        hipsparseLtSpMMACompress(handle, plan, dP, d_compressed, d_compressBuffer, stream),
-        HIPSPARSE_STATUS_SUCCESS);
+    if(!arg.sparse_dynamic)
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtSpMMACompress(handle, plan, dP, d_compressed, d_compressBuffer, stream),
+            HIPSPARSE_STATUS_SUCCESS);
 
-    if(arg.search)
+    if(arg.search && arg.search_async)
+    {
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulSearchAsync(handle, plan, &h_alpha, dA_, dB_, &h_beta, dC, stream),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulSearchWait(handle, plan),
+                                HIPSPARSE_STATUS_SUCCESS);
+    }
+    else if(arg.search)
         EXPECT_HIPSPARSE_STATUS(
             hipsparseLtMatmulSearch(
-                handle, plan, &h_alpha, dA_, dB_, &h_beta, dC, dD, dWorkspace, &stream, 1),
+                handle, plan, alpha_arg, dA_, dB_, beta_arg, dC, dD, dWorkspace_, &stream, 1),
             HIPSPARSE_STATUS_SUCCESS);
-    if(arg.unit_check || arg.norm_check)
+
+#ifdef __HIP_PLATFORM_AMD__
+    if(arg.search)
     {
-        CHECK_HIP_ERROR(hipStreamSynchronize(stream));
-        CHECK_HIP_ERROR(h_pruned.transfer_from(arg.sparse_b? dB : dA));
+        // the selected algorithm leads the results of the search
+        int                                          config_id = -1;
+        std::vector<hipsparseLtMatmulSearchResult_t> results(4);
         EXPECT_HIPSPARSE_STATUS(
-            hipsparseLtMatmul(
-                handle, plan, &h_alpha, dA_, dB_, &h_beta, dC, dD, dWorkspace, &stream, 1),
+            hipsparseLtMatmulAlgGetAttribute(
+                handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_ID, &config_id, sizeof(int)),
             HIPSPARSE_STATUS_SUCCESS);
-        // now we can recycle gold matrix for reference purposes
-        if(arg.timing)
-        {
-            cpu_time_used = get_time_us_no_sync();
-        }
-
-#define activation_param \
-    M, N, ldd, hD_gold_act + pos, hD_gold + pos, arg.activation_arg1, arg.activation_arg2
-
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulAlgGetAttribute(handle,
+                                             alg_sel,
+                                             HIPSPARSELT_MATMUL_SEARCH_RESULTS,
+                                             results.data(),
+                                             results.size() * sizeof(results[0])),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_EQ(results[0].config_id, config_id);
+        EXPECT_GT(results[0].samples, 0);
+        EXPECT_GT(results[0].mean_ms, 0.0f);
+        EXPECT_LE(results[0].min_ms, results[0].mean_ms);
+        EXPECT_NE(results[0].kernel_name[0], '\0');
+
+        // the matmul below checks D with the path the search selected
+        int dense_selected = -1;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulAlgGetAttribute(
+                handle, alg_sel, HIPSPARSELT_MATMUL_DENSE_SELECTED, &dense_selected, sizeof(int)),
+            HIPSPARSE_STATUS_SUCCESS);
+        if(arg.search_dense)
+            EXPECT_TRUE(dense_selected == 0 || dense_selected == 1);
+        else
+            EXPECT_EQ(dense_selected, 0);
+    }
+#endif
+
+    // capture after the search, so the graph replays the selected algorithm
+    hipGraph_t     graph      = nullptr;
+    hipGraphExec_t graph_exec = nullptr;
+    if(arg.graph)
+    {
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulPlanGetGraph(
+                handle, plan, &h_alpha, dA_, dB_, &h_beta, dC, dD, dWorkspace, stream, &graph),
+            HIPSPARSE_STATUS_SUCCESS);
+        CHECK_HIP_ERROR(hipGraphInstantiate(&graph_exec, graph, nullptr, nullptr, 0));
+    }
+
+    // arg.streams > 1 hands extra streams to hipsparseLtMatmul, they are joined back to stream
+    std::vector<hipStream_t> matmul_streams(std::max<int>(arg.streams, 1), stream);
+    for(size_t i = 1; i < matmul_streams.size(); i++)
+        CHECK_HIP_ERROR(hipStreamCreate(&matmul_streams[i]));
+
+    // arg.pointer_array passes each batch of the dense matrices by its own pointer, at the
+    // offsets of the strided layout
+    std::vector<const void*> dense_batches, c_batches;
+    std::vector<void*>       d_batches;
+    if(arg.pointer_array)
+    {
+        const Ti* dense_a      = dA;
+        const Ti* dense_b      = dB;
+        const Ti* dense        = arg.sparse_b ? dense_a : dense_b;
+        int64_t   dense_stride = arg.sparse_b ? stride_a : stride_b;
         for(int i = 0; i < num_batches; i++)
         {
-            if(activation_on || arg.bias_vector)
+            dense_batches.push_back(dense + i * dense_stride);
+            c_batches.push_back(static_cast<const To*>(dC) + i * stride_c);
+            d_batches.push_back(static_cast<To*>(dD) + i * stride_d);
+        }
+    }
+
+    // the buffers of hipsparseLtMatmul, the timed calls of arg.rotating move them over copies
+    const void* launch_A = dA_;
+    const void* launch_B = dB_;
+    const void* launch_C = dC;
+    void*       launch_D = dD;
+
+    auto matmul_launch = [&]() {
+        if(arg.pointer_array)
+            return hipsparseLtMatmulPointerArray(handle,
+                                                 plan,
+                                                 alpha_arg,
+                                                 arg.sparse_b ? dB_ : dA_,
+                                                 dense_batches.data(),
+                                                 beta_arg,
+                                                 c_batches.data(),
+                                                 d_batches.data(),
+                                                 dWorkspace_,
+                                                 matmul_streams.data(),
+                                                 static_cast<int32_t>(matmul_streams.size()));
+        if(arg.grouped)
+        {
+            const hipsparseLtMatmulPlan_t* plans[] = {plan, plan};
+            const void*                    a[]     = {dA_, dA_};
+            const void*                    b[]     = {dB_, dB_};
+            const void*                    c[]     = {dC, dC};
+            void*                          d[]     = {dD, dD2};
+            void*                          ws[]    = {dWorkspace_, dWorkspace2_};
+            return hipsparseLtMatmulGrouped(handle,
+                                            plans,
+                                            2,
+                                            &h_alpha,
+                                            a,
+                                            b,
+                                            &h_beta,
+                                            c,
+                                            d,
+                                            ws,
+                                            matmul_streams.data(),
+                                            static_cast<int32_t>(matmul_streams.size()));
+        }
+        if(arg.sharded)
+        {
+            // both shards of the output on the device of the test, in the order of stream
+            const hipsparseLtHandle_t*     handles[] = {handle, handle};
+            const hipsparseLtMatmulPlan_t* plans[]   = {plan, plan};
+            const void*                    a[]       = {dA_, dA_};
+            const void*                    b[]       = {dB_, dB_};
+            const void*                    c[]       = {dC, dC};
+            void*                          d[]       = {dD, dD2};
+            void*                          ws[]      = {dWorkspace_, dWorkspace2_};
+            hipStream_t                    streams[] = {stream, stream};
+            return hipsparseLtMatmulSharded(handles,
+                                            plans,
+                                            2,
+                                            HIPSPARSELT_SHARD_SPLIT_OUTPUT,
+                                            &h_alpha,
+                                            a,
+                                            b,
+                                            &h_beta,
+                                            c,
+                                            d,
+                                            ws,
+                                            streams);
+        }
+        if(arg.graph)
+            return hipsparseLtMatmulGraphLaunch(handle,
+                                                plan,
+                                                graph_exec,
+                                                &h_alpha,
+                                                dA_,
+                                                dB_,
+                                                &h_beta,
+                                                dC,
+                                                dD,
+                                                dWorkspace,
+                                                stream);
+        return hipsparseLtMatmul(handle,
+                                 plan,
+                                 alpha_arg,
+                                 launch_A,
+                                 launch_B,
+                                 beta_arg,
+                                 launch_C,
+                                 launch_D,
+                                 dWorkspace_,
+                                 matmul_streams.data(),
+                                 static_cast<int32_t>(matmul_streams.size()));
+    };
+
+    if(arg.unit_check || arg.norm_check)
+    {
+        CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+        if(!device_ref)
+            CHECK_HIP_ERROR(h_pruned.transfer_from(arg.sparse_b? dB : dA));
+        EXPECT_HIPSPARSE_STATUS(matmul_launch(), HIPSPARSE_STATUS_SUCCESS);
+        // now we can recycle gold matrix for reference purposes
+        if(arg.timing)
+        {
+            cpu_time_used = device_ref ? get_time_us_sync(stream) : get_time_us_no_sync();
+        }
+
+#define activation_param \
+    M, N, ldd, hD_gold_act + pos, out + pos, arg.activation_arg1, arg.activation_arg2
+
+        // with the epilogue of D, the bias and the activation stay in Talpha until D is scaled
+        auto apply_activation = [&](auto* out, int64_t pos) {
+            switch(arg.activation_type)
+            {
+            case hipsparselt_activation_type::clippedrelu:
+                activation(activation_param, ::_clippedrelu);
+                break;
+            case hipsparselt_activation_type::gelu:
+                activation(activation_param, ::_gelu);
+                break;
+            case hipsparselt_activation_type::relu:
+                activation(activation_param, ::_relu);
+                break;
+            case hipsparselt_activation_type::abs:
+                activation(activation_param, ::_abs);
+                break;
+            case hipsparselt_activation_type::leakyrelu:
+                activation(activation_param, ::_leakyrelu);
+                break;
+            case hipsparselt_activation_type::sigmoid:
+                activation(activation_param, ::_sigmoid);
+                break;
+            case hipsparselt_activation_type::tanh:
+                activation(activation_param, ::_tanh);
+                break;
+            case hipsparselt_activation_type::silu:
+                activation(activation_param, ::_silu);
+                break;
+            case hipsparselt_activation_type::clamp:
+                activation(activation_param, ::_clamp);
+                break;
+            default:
+                break;
+            }
+        };
+
+        // dA and dB hold the pruned matrices the compressed one was made of
+        if(device_ref)
+            CHECK_HIP_ERROR(hipsparselt_reference_gemm<Ti, To>(transA,
+                                                               transB,
+                                                               M,
+                                                               N,
+                                                               K,
+                                                               h_alpha_ref,
+                                                               dA,
+                                                               lda,
+                                                               stride_a,
+                                                               dB,
+                                                               ldb,
+                                                               stride_b,
+                                                               h_beta,
+                                                               dC,
+                                                               ldc,
+                                                               stride_c,
+                                                               dD_gold,
+                                                               ldd,
+                                                               stride_d,
+                                                               num_batches,
+                                                               stream));
+
+        float amax_gold = 0.f;
+        for(int i = 0; i < num_batches && !device_ref; i++)
+        {
+            if(activation_on || arg.bias_vector || d_epilogue)
             {
                 cblas_gemm<Ti, Talpha, Talpha>(transA,
                                                transB,
                                                M,
                                                N,
                                                K,
-                                               h_alpha,
+                                               h_alpha_ref,
                                                hA_ + stride_a * i,
                                                lda,
                                                hB_ + stride_b * i,
@@ -741,7 +1452,7 @@ void testing_spmm(const Arguments& arg)
                 auto pos = stride_d * i;
                 if(arg.bias_vector)
                 {
-                    if(activation_on)
+                    if(activation_on || d_epilogue)
                         bias<Talpha, TBias>(M,
                                             N,
                                             ldd,
@@ -755,33 +1466,23 @@ void testing_spmm(const Arguments& arg)
 
                 if(activation_on)
                 {
-                    switch(arg.activation_type)
-                    {
-                    case hipsparselt_activation_type::clippedrelu:
-                        activation(activation_param, ::_clippedrelu);
-                        break;
-                    case hipsparselt_activation_type::gelu:
-                        activation(activation_param, ::_gelu);
-                        break;
-                    case hipsparselt_activation_type::relu:
-                        activation(activation_param, ::_relu);
-                        break;
-                    case hipsparselt_activation_type::abs:
-                        activation(activation_param, ::_abs);
-                        break;
-                    case hipsparselt_activation_type::leakyrelu:
-                        activation(activation_param, ::_leakyrelu);
-                        break;
-                    case hipsparselt_activation_type::sigmoid:
-                        activation(activation_param, ::_sigmoid);
-                        break;
-                    case hipsparselt_activation_type::tanh:
-                        activation(activation_param, ::_tanh);
-                        break;
-                    default:
-                        continue;
-                    }
+                    if(d_epilogue)
+                        apply_activation(static_cast<Talpha*>(hD_gold_act), pos);
+                    else
+                        apply_activation(static_cast<To*>(hD_gold), pos);
                 }
+
+                if(d_epilogue)
+                    epilogue_d(M,
+                               N,
+                               ldd,
+                               hD_gold_act + pos,
+                               arg.gate ? hG + pos : nullptr,
+                               arg.residual ? hR + pos : nullptr,
+                               hD_gold + pos,
+                               arg.d_scale,
+                               arg.d_saturate,
+                               amax_gold);
             }
 
             else
@@ -790,7 +1491,7 @@ void testing_spmm(const Arguments& arg)
                                            M,
                                            N,
                                            K,
-                                           h_alpha,
+                                           h_alpha_ref,
                                            hA_ + stride_a * i,
                                            lda,
                                            hB_ + stride_b * i,
@@ -804,24 +1505,206 @@ void testing_spmm(const Arguments& arg)
 
         if(arg.timing)
         {
-            cpu_time_used = get_time_us_no_sync() - cpu_time_used;
+            cpu_time_used = (device_ref ? get_time_us_sync(stream) : get_time_us_no_sync())
+                            - cpu_time_used;
         }
 
+        // compares a D of the device with the reference of its first n columns on the device
+        auto device_check = [&](const To* d, int64_t n) {
+            int64_t mismatches = 0;
+            double  norm_error = 0.0;
+            CHECK_HIP_ERROR(hipsparselt_reference_check<Ti, To>(
+                M, n, ldd, stride_d, dD_gold, d, num_batches, stream, &mismatches, &norm_error));
+            if(arg.unit_check)
+                EXPECT_EQ(mismatches, 0);
+            if(arg.norm_check)
+                hipsparselt_error = std::max(hipsparselt_error, std::abs(norm_error));
+        };
+
         // fetch GPU
         CHECK_HIP_ERROR(hipStreamSynchronize(stream));
-        CHECK_HIP_ERROR(hD_1.transfer_from(dD));
+        if(device_ref)
+        {
+            device_check(dD, N);
+            if(twice)
+                device_check(dD2, N);
+        }
+        else
+        {
+            CHECK_HIP_ERROR(hD_1.transfer_from(dD));
+            if(twice)
+                CHECK_HIP_ERROR(hD_2.transfer_from(dD2));
+        }
 
-        if(arg.unit_check)
+        if(arg.unit_check && !device_ref)
         {
             unit_check_general<To>(M, N, ldd, stride_d, hD_gold, hD_1, num_batches);
+            if(twice)
+                unit_check_general<To>(M, N, ldd, stride_d, hD_gold, hD_2, num_batches);
+            if(arg.amax_d)
+            {
+                // the device sums the products in another order than the reference
+                float h_amax = 0.f;
+                CHECK_HIP_ERROR(hipMemcpy(&h_amax, dAmax, sizeof(float), hipMemcpyDeviceToHost));
+                near_check_general<float>(1, 1, 1, &amax_gold, &h_amax, amax_gold * 1e-3 + 1e-6);
+            }
+            if(arg.bias_grad)
+            {
+                // the device sums D before it is rounded to To, the reference after
+                host_vector<float> h_grad(M), grad_gold(M);
+                float              grad_scale = 0.f;
+                for(int64_t i = 0; i < M; i++)
+                {
+                    double sum = 0.0, abs_sum = 0.0;
+                    for(int64_t b = 0; b < num_batches; b++)
+                        for(int64_t j = 0; j < N; j++)
+                        {
+                            double value = static_cast<float>(hD_gold[b * stride_d + j * ldd + i]);
+                            sum += value;
+                            abs_sum += std::abs(value);
+                        }
+                    grad_gold[i] = static_cast<float>(sum);
+                    grad_scale   = std::max(grad_scale, static_cast<float>(abs_sum));
+                }
+                CHECK_HIP_ERROR(h_grad.transfer_from(dBiasGrad));
+                near_check_general<float>(M, 1, M, grad_gold, h_grad, grad_scale * 1e-2 + 1e-3);
+            }
         }
 
-        if(arg.norm_check)
+        if(arg.norm_check && !device_ref)
         {
             hipsparselt_error = std::abs(
                 norm_check_general<To>('F', M, N, ldd, stride_d, hD_gold, hD_1, num_batches));
         }
 
+        // arg.plan_threads > 1 runs the plan from as many host threads at once, each on its
+        // own streams, D and workspace, as a server sharing the handle and its plans does
+        if(arg.plan_threads > 1)
+        {
+            const size_t ws_stride = (workspace_size + 255) / 256 * 256;
+            device_vector<To>            dD_threads(size_D * arg.plan_threads, 1, HMM);
+            device_vector<unsigned char> dWorkspace_threads(ws_stride * arg.plan_threads, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dD_threads.memcheck());
+            CHECK_DEVICE_ALLOCATION(dWorkspace_threads.memcheck());
+
+            int device;
+            CHECK_HIP_ERROR(hipGetDevice(&device));
+
+            std::vector<hipsparseStatus_t> thread_status(arg.plan_threads,
+                                                         HIPSPARSE_STATUS_SUCCESS);
+            std::vector<std::thread>       threads;
+            for(int t = 0; t < arg.plan_threads; t++)
+                threads.emplace_back([&, t]() {
+                    // as many streams as the matmul above, the batches are forked over them
+                    std::vector<hipStream_t> t_streams(matmul_streams.size(), nullptr);
+                    hipError_t               err = hipSetDevice(device);
+                    for(size_t i = 0; i < t_streams.size() && err == hipSuccess; i++)
+                        err = hipStreamCreate(&t_streams[i]);
+
+                    To*   t_D         = static_cast<To*>(dD_threads) + t * size_D;
+                    void* t_workspace = workspace_size && !arg.workspace_pool
+                                            ? static_cast<unsigned char*>(dWorkspace_threads)
+                                                  + t * ws_stride
+                                            : nullptr;
+                    if(err != hipSuccess)
+                        thread_status[t] = HIPSPARSE_STATUS_INTERNAL_ERROR;
+                    // a few calls each, so the calls of the threads overlap
+                    for(int i = 0; i < 4 && thread_status[t] == HIPSPARSE_STATUS_SUCCESS; i++)
+                        thread_status[t]
+                            = hipsparseLtMatmul(handle,
+                                                plan,
+                                                alpha_arg,
+                                                dA_,
+                                                dB_,
+                                                beta_arg,
+                                                dC,
+                                                t_D,
+                                                t_workspace,
+                                                t_streams.data(),
+                                                static_cast<int32_t>(t_streams.size()));
+                    if(t_streams[0] != nullptr && hipStreamSynchronize(t_streams[0]) != hipSuccess)
+                        thread_status[t] = HIPSPARSE_STATUS_INTERNAL_ERROR;
+                    for(auto t_stream : t_streams)
+                        if(t_stream != nullptr)
+                            (void)hipStreamDestroy(t_stream);
+                });
+            for(auto& thread : threads)
+                thread.join();
+
+            for(int t = 0; t < arg.plan_threads; t++)
+            {
+                EXPECT_HIPSPARSE_STATUS(thread_status[t], HIPSPARSE_STATUS_SUCCESS);
+                if(device_ref)
+                {
+                    device_check(static_cast<To*>(dD_threads) + t * size_D, N);
+                    continue;
+                }
+                CHECK_HIP_ERROR(hipMemcpy(hD_1,
+                                          static_cast<To*>(dD_threads) + t * size_D,
+                                          sizeof(To) * size_D,
+                                          hipMemcpyDeviceToHost));
+                if(arg.unit_check)
+                    unit_check_general<To>(M, N, ldd, stride_d, hD_gold, hD_1, num_batches);
+                if(arg.norm_check)
+                    hipsparselt_error = std::max(
+                        hipsparselt_error,
+                        std::abs(norm_check_general<To>(
+                            'F', M, N, ldd, stride_d, hD_gold, hD_1, num_batches)));
+            }
+        }
+
+        // arg.dynamic_n runs the plan again for the first dynamic_n columns of B, C and D,
+        // which the reference computed above already holds
+        if(arg.dynamic_n > 0 && arg.dynamic_n < N && !arg.sparse_b)
+        {
+            CHECK_HIP_ERROR(hipMemsetAsync(dD, 0, sizeof(To) * size_D, stream));
+            EXPECT_HIPSPARSE_STATUS(
+                hipsparseLtMatmulDynamicN(handle,
+                                          plan,
+                                          arg.dynamic_n,
+                                          alpha_arg,
+                                          dA_,
+                                          dB_,
+                                          beta_arg,
+                                          dC,
+                                          dD,
+                                          dWorkspace_,
+                                          matmul_streams.data(),
+                                          static_cast<int32_t>(matmul_streams.size())),
+                HIPSPARSE_STATUS_SUCCESS);
+            CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+            if(device_ref)
+                device_check(dD, arg.dynamic_n);
+            else
+                CHECK_HIP_ERROR(hD_1.transfer_from(dD));
+            if(arg.unit_check && !device_ref)
+                unit_check_general<To>(M, arg.dynamic_n, ldd, stride_d, hD_gold, hD_1, num_batches);
+            if(arg.norm_check && !device_ref)
+                hipsparselt_error = std::max(
+                    hipsparselt_error,
+                    std::abs(norm_check_general<To>(
+                        'F', M, arg.dynamic_n, ldd, stride_d, hD_gold, hD_1, num_batches)));
+        }
+
+        // arg.plan_stats times every matmul, all of them completed after the synchronization
+        if(arg.plan_stats)
+        {
+            for(auto& matmul_stream : matmul_streams)
+                CHECK_HIP_ERROR(hipStreamSynchronize(matmul_stream));
+            hipsparseLtMatmulPlanStats_t stats;
+            EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanGetStats(handle, plan, &stats),
+                                    HIPSPARSE_STATUS_SUCCESS);
+            EXPECT_GE(stats.calls, 1);
+            EXPECT_EQ(stats.sample_rate, 1);
+            EXPECT_GT(stats.host_time_ms, 0.0);
+            if(!arg.graph)
+            {
+                EXPECT_EQ(stats.timed_calls, stats.calls);
+                EXPECT_GT(stats.gpu_time_ms, 0.0);
+            }
+            EXPECT_GE(stats.max_workspace_bytes, stats.workspace_bytes);
+        }
+
         // Debug
         //print_strided_batched("A", &hA[0], A_row, A_col, num_batches, 1, lda, stride_a);
         //print_strided_batched("B", &hB[0], B_row, B_col, num_batches, 1, ldb, stride_b);
@@ -838,40 +1721,110 @@ void testing_spmm(const Arguments& arg)
         int number_hot_calls  = arg.iters;
         for(int i = 0; i < number_cold_calls; i++)
         {
-            EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
-                                                      plan,
-                                                      &h_alpha,
-                                                      dA_,
-                                                      dB_,
-                                                      &h_beta,
-                                                      dC,
-                                                      dD,
-                                                      dWorkspace,
-                                                      &stream,
-                                                      1),
-                                    HIPSPARSE_STATUS_SUCCESS);
+            EXPECT_HIPSPARSE_STATUS(matmul_launch(), HIPSPARSE_STATUS_SUCCESS);
+        }
+
+        // arg.rotating copies the sparse and dense matrices, C and D, until all the copies take
+        // arg.rotating MiB, and the hot calls of hipsparseLtMatmul use them in turn
+        auto         align_256   = [](size_t bytes) { return (bytes + 255) / 256 * 256; };
+        const size_t dense_bytes = (arg.sparse_b ? size_A : size_B) * sizeof(Ti);
+        const size_t c_bytes     = size_C * sizeof(To);
+        const size_t d_bytes     = size_D * sizeof(To);
+        const size_t set_bytes   = align_256(compressed_size) + align_256(dense_bytes)
+                                 + align_256(c_bytes) + align_256(d_bytes);
+        // the other launches of the test are not rotated
+        size_t copies = 1;
+        if(arg.rotating > 0 && !arg.pointer_array && !twice && !arg.graph && !arg.sparse_dynamic)
+            copies = std::min<size_t>(std::max(number_hot_calls, 1),
+                                      ((size_t(arg.rotating) << 20) + set_bytes - 1) / set_bytes);
+        copies = std::max<size_t>(copies, 1);
+        device_vector<unsigned char> d_rotating((copies - 1) * set_bytes, 1, HMM);
+        CHECK_DEVICE_ALLOCATION(d_rotating.memcheck());
+
+        struct launch_buffers
+        {
+            const void* a;
+            const void* b;
+            const void* c;
+            void*       d;
+        };
+        std::vector<launch_buffers> rotation{{launch_A, launch_B, launch_C, launch_D}};
+        for(size_t i = 1; i < copies; i++)
+        {
+            unsigned char* sparse = static_cast<unsigned char*>(d_rotating) + (i - 1) * set_bytes;
+            unsigned char* dense  = sparse + align_256(compressed_size);
+            unsigned char* c      = dense + align_256(dense_bytes);
+            unsigned char* d      = c + align_256(c_bytes);
+            CHECK_HIP_ERROR(
+                hipMemcpy(sparse, d_compressed, compressed_size, hipMemcpyDeviceToDevice));
+            CHECK_HIP_ERROR(hipMemcpy(
+                dense, arg.sparse_b ? launch_A : launch_B, dense_bytes, hipMemcpyDeviceToDevice));
+            CHECK_HIP_ERROR(hipMemcpy(c, launch_C, c_bytes, hipMemcpyDeviceToDevice));
+            if(arg.sparse_b)
+                rotation.push_back({dense, sparse, c, d});
+            else
+                rotation.push_back({sparse, dense, c, d});
         }
 
+        // arg.flush overwrites more than L2 and the MALL before each hot call, hipDeviceProp_t
+        // does not report the MALL, 512 MiB covers the 256 MiB of MI300
+        int device   = 0;
+        int l2_bytes = 0;
+        CHECK_HIP_ERROR(hipGetDevice(&device));
+        CHECK_HIP_ERROR(hipDeviceGetAttribute(&l2_bytes, hipDeviceAttributeL2CacheSize, device));
+        const size_t flush_bytes
+            = arg.flush ? std::max<size_t>(size_t(l2_bytes) * 4, size_t(512) << 20) : 0;
+        device_vector<unsigned char> d_flush(flush_bytes, 1, HMM);
+        CHECK_DEVICE_ALLOCATION(d_flush.memcheck());
+        // the time of each hot call, which leaves the flushes out
+        hipsparselt_call_timer call_timer(arg.flush || samples, number_hot_calls);
+
         CHECK_HIP_ERROR(hipStreamSynchronize(stream));
-        gpu_time_used = get_time_us_sync(stream); // in microseconds
+        gpu_time_used      = get_time_us_sync(stream); // in microseconds
+        size_t host_allocs = hipsparselt_host_alloc_count();
         for(int i = 0; i < number_hot_calls; i++)
         {
-            EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
-                                                      plan,
-                                                      &h_alpha,
-                                                      dA_,
-                                                      dB_,
-                                                      &h_beta,
-                                                      dC,
-                                                      dD,
-                                                      dWorkspace,
-                                                      &stream,
-                                                      1),
-                                    HIPSPARSE_STATUS_SUCCESS);
+            const launch_buffers& buffers = rotation[i % rotation.size()];
+            launch_A                      = buffers.a;
+            launch_B                      = buffers.b;
+            launch_C                      = buffers.c;
+            launch_D                      = buffers.d;
+            if(arg.flush)
+                CHECK_HIP_ERROR(hipMemsetAsync(d_flush, 0, flush_bytes, stream));
+            call_timer.start(i, stream);
+            EXPECT_HIPSPARSE_STATUS(matmul_launch(), HIPSPARSE_STATUS_SUCCESS);
+            call_timer.stop(i, stream);
         }
+        host_allocs   = hipsparselt_host_alloc_count() - host_allocs;
         CHECK_HIP_ERROR(hipStreamSynchronize(stream));
         gpu_time_used = get_time_us_sync(stream) - gpu_time_used;
-        auto flops    = gemm_gflop_count<float>(M, N, K);
+        auto call_us  = call_timer.samples_us();
+        if(arg.flush)
+            gpu_time_used = std::accumulate(call_us.begin(), call_us.end(), 0.0);
+        launch_A = rotation[0].a;
+        launch_B = rotation[0].b;
+        launch_C = rotation[0].c;
+        launch_D = rotation[0].d;
+
+        // the bytes a call reads and writes, the compressed matrix holds the kept values and
+        // their metadata
+        double gbytes = (compressed_size + dense_bytes + (h_beta != 0 ? c_bytes : 0) + d_bytes)
+                        / 1e9 / num_batches;
+        if(getenv("HIPSPARSELT_REPORT_HOST_ALLOCS"))
+            hipsparselt_cout << "host allocations per hipsparseLtMatmul after warm-up: "
+                             << (number_hot_calls ? double(host_allocs) / number_hot_calls : 0.0)
+                             << std::endl;
+        if(arg.plan_stats)
+        {
+            hipsparseLtMatmulPlanStats_t stats;
+            CHECK_HIPSPARSELT_ERROR(hipsparseLtMatmulPlanGetStats(handle, plan, &stats));
+            hipsparselt_cout << "plan stats: calls " << stats.calls << ", timed calls "
+                             << stats.timed_calls << ", gpu time " << stats.gpu_time_ms
+                             << " ms, host time " << stats.host_time_ms << " ms, workspace "
+                             << stats.max_workspace_bytes << " bytes, kernel " << stats.kernel_name
+                             << std::endl;
+        }
+        auto flops = gemm_gflop_count<float>(M, N, K);
         switch(arg.activation_type)
         {
         case hipsparselt_activation_type::relu:
@@ -895,6 +1848,12 @@ void testing_spmm(const Arguments& arg)
         case hipsparselt_activation_type::tanh:
             flops += tanh_gflop_count<float>(M, N);
             break;
+        case hipsparselt_activation_type::silu:
+            flops += silu_gflop_count<float>(M, N);
+            break;
+        case hipsparselt_activation_type::clamp:
+            flops += clamp_gflop_count<float>(M, N);
+            break;
         default:
             break;
         }
@@ -908,7 +1867,7 @@ void testing_spmm(const Arguments& arg)
                                                             arg,
                                                             gpu_time_used,
                                                             flops,
-                                                            ArgumentLogging::NA_value,
+                                                            gbytes,
                                                             cpu_time_used,
                                                             hipsparselt_error);
         else
@@ -916,10 +1875,209 @@ void testing_spmm(const Arguments& arg)
                                                                arg,
                                                                gpu_time_used,
                                                                flops,
-                                                               ArgumentLogging::NA_value,
+                                                               gbytes,
                                                                cpu_time_used,
                                                                hipsparselt_error);
+
+        // the samples follow the log of the run, whose bytes give the bandwidth at the median
+        if(samples)
+        {
+            int                          config_id = -1;
+            hipsparseLtMatmulPlanStats_t stats;
+            if(hipsparseLtMatmulAlgGetAttribute(handle,
+                                                alg_sel,
+                                                HIPSPARSELT_MATMUL_ALG_CONFIG_ID,
+                                                &config_id,
+                                                sizeof(config_id))
+               != HIPSPARSE_STATUS_SUCCESS)
+                config_id = -1;
+            bool kernel
+                = hipsparseLtMatmulPlanGetStats(handle, plan, &stats) == HIPSPARSE_STATUS_SUCCESS;
+            ArgumentModel_log_samples(arg, call_us, config_id, kernel ? stats.kernel_name : "");
+        }
+
+        // arg.compare_dense times the dense GEMM of hipBLASLt on dA and dB, which hold the pruned
+        // matrices the compressed one was made of, with the C, D and the stream of the matmul
+        if(arg.compare_dense)
+        {
+            hipsparselt_dense_gemm gemm{transA,
+                                        transB,
+                                        M,
+                                        N,
+                                        K,
+                                        arg.a_type,
+                                        arg.b_type,
+                                        arg.c_type,
+                                        arg.d_type,
+                                        arg.compute_type,
+                                        dA,
+                                        dB,
+                                        dC,
+                                        dD,
+                                        lda,
+                                        ldb,
+                                        ldc,
+                                        ldd,
+                                        stride_a,
+                                        stride_b,
+                                        stride_c,
+                                        stride_d,
+                                        num_batches,
+                                        h_alpha_ref,
+                                        h_beta};
+            double dense_us
+                = hipsparselt_dense_gemm_us(gemm, number_cold_calls, number_hot_calls, stream);
+            double sparse_us = ArgumentModel_get_last_gpu_us();
+            ArgumentModel_set_last_dense_us(dense_us > 0.0 ? dense_us : ArgumentLogging::NA_value);
+            if(dense_us > 0.0)
+                hipsparselt_cout << "dense hipBLASLt: " << dense_us << " us, "
+                                 << gemm_gflop_count<float>(M, N, K) * num_batches / dense_us * 1e6
+                                 << " Gflops, sparse speedup " << dense_us / sparse_us << "x"
+                                 << std::endl;
+            else
+                hipsparselt_cout << "dense hipBLASLt: not timed, the clients are built without "
+                                    "hipBLASLt or it has no algorithm for the GEMM"
+                                 << std::endl;
+        }
+
+        // arg.bench_threads times the matmul from as many host threads at once, each on its own
+        // streams, D and workspace, and with arg.thread_plans its own plan
+        if(arg.bench_threads > 1)
+        {
+            const int    threads   = arg.bench_threads;
+            const size_t ws_stride = (workspace_size + 255) / 256 * 256;
+            device_vector<To>            dD_threads(size_D * threads, 1, HMM);
+            device_vector<unsigned char> dWorkspace_threads(ws_stride * threads, 1, HMM);
+            CHECK_DEVICE_ALLOCATION(dD_threads.memcheck());
+            CHECK_DEVICE_ALLOCATION(dWorkspace_threads.memcheck());
+
+            int device;
+            CHECK_HIP_ERROR(hipGetDevice(&device));
+
+            using clock = std::chrono::steady_clock;
+            std::vector<hipsparseStatus_t> thread_status(threads, HIPSPARSE_STATUS_SUCCESS);
+            std::vector<double>            thread_gpu_us(threads, 0.0), thread_launch_us(threads);
+            std::vector<clock::time_point> thread_start(threads), thread_end(threads);
+            std::atomic<int>               ready{0};
+            std::vector<std::thread>       bench_threads;
+            for(int t = 0; t < threads; t++)
+                bench_threads.emplace_back([&, t]() {
+                    std::vector<hipStream_t> t_streams(matmul_streams.size(), nullptr);
+                    hipEvent_t               t_start = nullptr, t_stop = nullptr;
+                    hipError_t               err     = hipSetDevice(device);
+                    for(size_t i = 0; i < t_streams.size() && err == hipSuccess; i++)
+                        err = hipStreamCreate(&t_streams[i]);
+                    if(err == hipSuccess)
+                        err = hipEventCreate(&t_start);
+                    if(err == hipSuccess)
+                        err = hipEventCreate(&t_stop);
+
+                    std::unique_ptr<hipsparselt_local_matmul_plan> t_plan;
+                    if(arg.thread_plans)
+                        t_plan.reset(new hipsparselt_local_matmul_plan(handle, matmul, alg_sel));
+                    const hipsparseLtMatmulPlan_t* run_plan = t_plan ? *t_plan : plan;
+
+                    To*   t_D         = static_cast<To*>(dD_threads) + t * size_D;
+                    void* t_workspace = workspace_size && !arg.workspace_pool
+                                            ? static_cast<unsigned char*>(dWorkspace_threads)
+                                                  + t * ws_stride
+                                            : nullptr;
+                    auto  launch      = [&]() {
+                        return hipsparseLtMatmul(handle,
+                                                 run_plan,
+                                                 alpha_arg,
+                                                 dA_,
+                                                 dB_,
+                                                 beta_arg,
+                                                 dC,
+                                                 t_D,
+                                                 t_workspace,
+                                                 t_streams.data(),
+                                                 static_cast<int32_t>(t_streams.size()));
+                    };
+
+                    auto& status = thread_status[t];
+                    if(err != hipSuccess)
+                        status = HIPSPARSE_STATUS_INTERNAL_ERROR;
+                    else if(t_plan && t_plan->status() != HIPSPARSE_STATUS_SUCCESS)
+                        status = t_plan->status();
+                    for(int i = 0; i < number_cold_calls && status == HIPSPARSE_STATUS_SUCCESS;
+                        i++)
+                        status = launch();
+                    if(status == HIPSPARSE_STATUS_SUCCESS
+                       && hipStreamSynchronize(t_streams[0]) != hipSuccess)
+                        status = HIPSPARSE_STATUS_INTERNAL_ERROR;
+
+                    // the threads start the hot calls together, the failed ones included
+                    ready++;
+                    while(ready.load() < threads)
+                        std::this_thread::yield();
+
+                    thread_start[t] = clock::now();
+                    if(status == HIPSPARSE_STATUS_SUCCESS
+                       && hipEventRecord(t_start, t_streams[0]) != hipSuccess)
+                        status = HIPSPARSE_STATUS_INTERNAL_ERROR;
+                    for(int i = 0; i < number_hot_calls && status == HIPSPARSE_STATUS_SUCCESS; i++)
+                        status = launch();
+                    thread_launch_us[t]
+                        = std::chrono::duration<double, std::micro>(clock::now() - thread_start[t])
+                              .count();
+                    float ms = 0.0f;
+                    if(status == HIPSPARSE_STATUS_SUCCESS
+                       && (hipEventRecord(t_stop, t_streams[0]) != hipSuccess
+                           || hipEventSynchronize(t_stop) != hipSuccess
+                           || hipEventElapsedTime(&ms, t_start, t_stop) != hipSuccess))
+                        status = HIPSPARSE_STATUS_INTERNAL_ERROR;
+                    thread_end[t]    = clock::now();
+                    thread_gpu_us[t] = ms * 1000.0;
+
+                    if(t_start != nullptr)
+                        (void)hipEventDestroy(t_start);
+                    if(t_stop != nullptr)
+                        (void)hipEventDestroy(t_stop);
+                    for(auto t_stream : t_streams)
+                        if(t_stream != nullptr)
+                            (void)hipStreamDestroy(t_stream);
+                });
+            for(auto& thread : bench_threads)
+                thread.join();
+
+            // each thread is timed on its stream, all of them from the first start to the last end
+            const int  hot_calls = std::max(number_hot_calls, 1);
+            const auto gflop     = flops * num_batches;
+            auto       first     = thread_start[0];
+            auto       last      = thread_end[0];
+            for(int t = 0; t < threads; t++)
+            {
+                EXPECT_HIPSPARSE_STATUS(thread_status[t], HIPSPARSE_STATUS_SUCCESS);
+                first = std::min(first, thread_start[t]);
+                last  = std::max(last, thread_end[t]);
+                if(thread_status[t] != HIPSPARSE_STATUS_SUCCESS)
+                    continue;
+                hipsparselt_cout << "thread " << t << ": " << thread_gpu_us[t] / hot_calls
+                                 << " us, " << gflop * hot_calls / thread_gpu_us[t] * 1e6
+                                 << " hipsparselt-Gflops, "
+                                 << thread_launch_us[t] / hot_calls << " us per launch, "
+                                 << hot_calls / thread_launch_us[t] * 1e6 << " launches/s"
+                                 << std::endl;
+            }
+            double all_us = std::chrono::duration<double, std::micro>(last - first).count();
+            double launch_us
+                = *std::max_element(thread_launch_us.begin(), thread_launch_us.end());
+            hipsparselt_cout << threads << (arg.thread_plans ? " threads with their own plans: "
+                                                              : " threads sharing the plan: ")
+                             << gflop * hot_calls * threads / all_us * 1e6
+                             << " hipsparselt-Gflops in all, "
+                             << hot_calls * threads / launch_us * 1e6 << " launches/s in all"
+                             << std::endl;
+        }
     }
+    if(graph_exec != nullptr)
+        CHECK_HIP_ERROR(hipGraphExecDestroy(graph_exec));
+    if(graph != nullptr)
+        CHECK_HIP_ERROR(hipGraphDestroy(graph));
+    for(size_t i = 1; i < matmul_streams.size(); i++)
+        CHECK_HIP_ERROR(hipStreamDestroy(matmul_streams[i]));
     CHECK_HIP_ERROR(hipStreamDestroy(stream));
 }
 
@@ -1350,3 +2508,599 @@ void testing_aux_plan_assign(const Arguments& arg)
 
     CHECK_HIP_ERROR(hipStreamDestroy(stream));
 }
+
+template <typename Ti, typename To, typename Tc>
+void testing_aux_config_cache(const Arguments& arg)
+{
+    hipsparseOperation_t transA = char_to_hipsparselt_operation(arg.transA);
+    hipsparseOperation_t transB = char_to_hipsparselt_operation(arg.transB);
+
+    int64_t M = arg.M;
+    int64_t N = arg.N;
+    int64_t K = arg.K;
+
+    int64_t A_row = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? M : K;
+    int64_t A_col = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : M;
+    int64_t B_row = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : N;
+    int64_t B_col = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? N : K;
+
+    hipsparselt_local_handle handle{arg};
+
+    hipsparseLtConfigCacheStats_t stats;
+    hipsparseStatus_t             status = hipsparseLtGetConfigCacheStats(handle, &stats);
+    if(status == HIPSPARSE_STATUS_NOT_SUPPORTED)
+        return;
+    EXPECT_HIPSPARSE_STATUS(status, HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_mat_descr matA(hipsparselt_matrix_type_structured,
+                                     handle,
+                                     A_row,
+                                     A_col,
+                                     arg.lda,
+                                     arg.a_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matB(hipsparselt_matrix_type_dense,
+                                     handle,
+                                     B_row,
+                                     B_col,
+                                     arg.ldb,
+                                     arg.b_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matC(
+        hipsparselt_matrix_type_dense, handle, M, N, arg.ldc, arg.c_type, HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matD(
+        hipsparselt_matrix_type_dense, handle, M, N, arg.ldd, arg.d_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matA.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matB.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matC.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matD.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_descr matmul(
+        handle, transA, transB, matA, matB, matC, matD, arg.compute_type);
+    EXPECT_HIPSPARSE_STATUS(matmul.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    // the second algorithm selection of the same problem is served by the cache
+    hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    hipsparselt_local_matmul_alg_selection alg_sel2(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    EXPECT_HIPSPARSE_STATUS(alg_sel.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(alg_sel2.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    int config_max_id = 0, config_max_id2 = 0;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID, &config_max_id, sizeof(int)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, alg_sel2, HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID, &config_max_id2, sizeof(int)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(config_max_id, config_max_id2);
+
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtGetConfigCacheStats(handle, &stats),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(stats.misses, 1);
+    if(stats.capacity > 0)
+    {
+        EXPECT_EQ(stats.hits, 1);
+        EXPECT_EQ(stats.entries, 1);
+    }
+    else
+        EXPECT_EQ(stats.misses + stats.hits, 1);
+    EXPECT_EQ(stats.evictions, 0);
+}
+
+template <typename Ti, typename To, typename Tc>
+void testing_aux_code_object_stats(const Arguments& arg)
+{
+    hipsparseOperation_t transA = char_to_hipsparselt_operation(arg.transA);
+    hipsparseOperation_t transB = char_to_hipsparselt_operation(arg.transB);
+
+    int64_t M = arg.M;
+    int64_t N = arg.N;
+    int64_t K = arg.K;
+
+    int64_t A_row = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? M : K;
+    int64_t A_col = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : M;
+    int64_t B_row = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : N;
+    int64_t B_col = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? N : K;
+
+    hipsparselt_local_handle handle{arg};
+
+    hipsparseLtCodeObjectStats_t stats;
+    hipsparseStatus_t            status = hipsparseLtGetCodeObjectStats(handle, &stats);
+    if(status == HIPSPARSE_STATUS_NOT_SUPPORTED)
+        return;
+    EXPECT_HIPSPARSE_STATUS(status, HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtGetCodeObjectStats(handle, nullptr),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    hipsparselt_local_mat_descr matA(hipsparselt_matrix_type_structured,
+                                     handle,
+                                     A_row,
+                                     A_col,
+                                     arg.lda,
+                                     arg.a_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matB(hipsparselt_matrix_type_dense,
+                                     handle,
+                                     B_row,
+                                     B_col,
+                                     arg.ldb,
+                                     arg.b_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matC(
+        hipsparselt_matrix_type_dense, handle, M, N, arg.ldc, arg.c_type, HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matD(
+        hipsparselt_matrix_type_dense, handle, M, N, arg.ldd, arg.d_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matA.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matB.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matC.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matD.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_descr matmul(
+        handle, transA, transB, matA, matB, matC, matD, arg.compute_type);
+    EXPECT_HIPSPARSE_STATUS(matmul.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    EXPECT_HIPSPARSE_STATUS(alg_sel.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    // the plan loads the kernel of its config
+    hipsparselt_local_matmul_plan plan(handle, matmul, alg_sel);
+    EXPECT_HIPSPARSE_STATUS(plan.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparseLtCodeObjectStats_t after;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtGetCodeObjectStats(handle, &after),
+                            HIPSPARSE_STATUS_SUCCESS);
+    int config_max_id = 0;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID, &config_max_id, sizeof(int)),
+        HIPSPARSE_STATUS_SUCCESS);
+    if(config_max_id > 0)
+    {
+        EXPECT_GE(after.modules, 1);
+        EXPECT_GT(after.bytes, 0);
+    }
+    EXPECT_LE(after.pinned, after.modules);
+    EXPECT_GE(after.evictions, stats.evictions);
+    EXPECT_EQ(after.capacity, stats.capacity);
+}
+
+template <typename Ti, typename To, typename Tc>
+void testing_aux_mixed_input(const Arguments& arg)
+{
+#ifdef __HIP_PLATFORM_NVIDIA__
+    // the mixed input is HIP backend only
+    return;
+#endif
+    hipsparseOperation_t transA = char_to_hipsparselt_operation(arg.transA);
+    hipsparseOperation_t transB = char_to_hipsparselt_operation(arg.transB);
+
+    int64_t M = arg.M;
+    int64_t N = arg.N;
+    int64_t K = arg.K;
+
+    int64_t A_row = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? M : K;
+    int64_t A_col = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : M;
+    int64_t B_row = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : N;
+    int64_t B_col = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? N : K;
+
+    const size_t size_A = size_t(arg.lda) * A_col;
+    const size_t size_B = size_t(arg.ldb) * B_col;
+    const size_t size_C = size_t(arg.ldc) * N;
+    const size_t size_D = size_t(arg.ldd) * N;
+
+    hipsparselt_local_handle handle{arg};
+
+    // the mixed input matmul has an int8 A, its reference the same values of the type of B
+    hipsparselt_local_mat_descr matA(hipsparselt_matrix_type_structured,
+                                     handle,
+                                     A_row,
+                                     A_col,
+                                     arg.lda,
+                                     HIPSPARSELT_R_8I,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matA_ref(hipsparselt_matrix_type_structured,
+                                         handle,
+                                         A_row,
+                                         A_col,
+                                         arg.lda,
+                                         arg.a_type,
+                                         HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matB(hipsparselt_matrix_type_dense,
+                                     handle,
+                                     B_row,
+                                     B_col,
+                                     arg.ldb,
+                                     arg.b_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matC(
+        hipsparselt_matrix_type_dense, handle, M, N, arg.ldc, arg.c_type, HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matD(
+        hipsparselt_matrix_type_dense, handle, M, N, arg.ldd, arg.d_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matA.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matA_ref.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matB.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matC.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matD.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    // the products are in the type of B, accumulated in f32
+    hipsparselt_local_matmul_descr matmul_i32(
+        handle, transA, transB, matA, matB, matC, matD, HIPSPARSELT_COMPUTE_32I);
+    EXPECT_HIPSPARSE_STATUS(matmul_i32.status(), HIPSPARSE_STATUS_NOT_SUPPORTED);
+
+    hipsparselt_local_matmul_descr matmul(
+        handle, transA, transB, matA, matB, matC, matD, arg.compute_type);
+    hipsparselt_local_matmul_descr matmul_ref(
+        handle, transA, transB, matA_ref, matB, matC, matD, arg.compute_type);
+    EXPECT_HIPSPARSE_STATUS(matmul.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matmul_ref.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    hipsparselt_local_matmul_alg_selection alg_sel_ref(
+        handle, matmul_ref, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    EXPECT_HIPSPARSE_STATUS(alg_sel.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(alg_sel_ref.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_plan plan(handle, matmul, alg_sel);
+    hipsparselt_local_matmul_plan plan_ref(handle, matmul_ref, alg_sel_ref);
+    EXPECT_HIPSPARSE_STATUS(plan.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(plan_ref.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    // the compressed matrix stays int8, the plan holds the widened one
+    size_t workspace_size = 0, workspace_size_ref = 0;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGetWorkspace(handle, plan, &workspace_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGetWorkspace(handle, plan_ref, &workspace_size_ref),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(workspace_size, workspace_size_ref);
+
+    size_t compressed_size = 0, compress_buffer_size = 0;
+    size_t compressed_size_ref = 0, compress_buffer_size_ref = 0;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompressedSize(handle, plan, &compressed_size, &compress_buffer_size),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtSpMMACompressedSize(
+                                handle, plan_ref, &compressed_size_ref, &compress_buffer_size_ref),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_LT(compressed_size, compressed_size_ref);
+
+    hipStream_t stream;
+    CHECK_HIP_ERROR(hipStreamCreate(&stream));
+
+    device_vector<int8_t>        dA(size_A);
+    device_vector<Ti>            dA_ref(size_A);
+    device_vector<Ti>            dB(size_B);
+    device_vector<To>            dC(size_C);
+    device_vector<To>            dD(size_D);
+    device_vector<To>            dD_ref(size_D);
+    device_vector<unsigned char> d_compressed(compressed_size);
+    device_vector<unsigned char> d_compressed_ref(compressed_size_ref);
+    device_vector<unsigned char> d_compressBuffer(
+        std::max(compress_buffer_size, compress_buffer_size_ref));
+    device_vector<unsigned char> dWorkspace(workspace_size);
+    device_vector<unsigned char> dWorkspace_ref(workspace_size_ref);
+    CHECK_DEVICE_ALLOCATION(dA.memcheck());
+    CHECK_DEVICE_ALLOCATION(dA_ref.memcheck());
+    CHECK_DEVICE_ALLOCATION(dB.memcheck());
+    CHECK_DEVICE_ALLOCATION(dC.memcheck());
+    CHECK_DEVICE_ALLOCATION(dD.memcheck());
+    CHECK_DEVICE_ALLOCATION(dD_ref.memcheck());
+    CHECK_DEVICE_ALLOCATION(d_compressed.memcheck());
+    CHECK_DEVICE_ALLOCATION(d_compressed_ref.memcheck());
+    CHECK_DEVICE_ALLOCATION(d_compressBuffer.memcheck());
+    CHECK_DEVICE_ALLOCATION(dWorkspace.memcheck());
+    CHECK_DEVICE_ALLOCATION(dWorkspace_ref.memcheck());
+
+    // small integers, which every type holds exactly
+    host_vector<int8_t> hA(size_A);
+    host_vector<Ti>     hA_ref(size_A);
+    host_vector<Ti>     hB(size_B);
+    hipsparselt_init<int8_t>(hA, A_row, A_col, arg.lda, size_A, 1);
+    hipsparselt_init<Ti>(hB, B_row, B_col, arg.ldb, size_B, 1);
+    CHECK_HIP_ERROR(dA.transfer_from(hA));
+    CHECK_HIP_ERROR(dB.transfer_from(hB));
+    CHECK_HIP_ERROR(hipMemset(dC, 0, size_C * sizeof(To)));
+
+    // the reference compresses the values pruned as int8
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMAPrune(handle, matmul, dA, dA, HIPSPARSELT_PRUNE_SPMMA_STRIP, stream),
+        HIPSPARSE_STATUS_SUCCESS);
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+    CHECK_HIP_ERROR(hA.transfer_from(dA));
+    for(size_t i = 0; i < size_A; i++)
+        hA_ref[i] = static_cast<Ti>(static_cast<float>(hA[i]));
+    CHECK_HIP_ERROR(dA_ref.transfer_from(hA_ref));
+
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress(handle, plan, dA, d_compressed, d_compressBuffer, stream),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress(
+            handle, plan_ref, dA_ref, d_compressed_ref, d_compressBuffer, stream),
+        HIPSPARSE_STATUS_SUCCESS);
+
+    Tc alpha = static_cast<Tc>(1), beta = static_cast<Tc>(0);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmul(
+            handle, plan, &alpha, d_compressed, dB, &beta, dC, dD, dWorkspace, &stream, 1),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmul(handle,
+                                              plan_ref,
+                                              &alpha,
+                                              d_compressed_ref,
+                                              dB,
+                                              &beta,
+                                              dC,
+                                              dD_ref,
+                                              dWorkspace_ref,
+                                              &stream,
+                                              1),
+                            HIPSPARSE_STATUS_SUCCESS);
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+
+    // the kernels of the type of B run on the same values
+    host_vector<To> hD(size_D);
+    host_vector<To> hD_ref(size_D);
+    CHECK_HIP_ERROR(hD.transfer_from(dD));
+    CHECK_HIP_ERROR(hD_ref.transfer_from(dD_ref));
+    unit_check_general<To>(M, N, arg.ldd, hD_ref, hD);
+
+    // the next matmul of the same compressed matrix reads the widened copy of the plan
+    CHECK_HIP_ERROR(hipMemset(dD, 0, size_D * sizeof(To)));
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmul(
+            handle, plan, &alpha, d_compressed, dB, &beta, dC, dD, dWorkspace, &stream, 1),
+        HIPSPARSE_STATUS_SUCCESS);
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+    CHECK_HIP_ERROR(hD.transfer_from(dD));
+    unit_check_general<To>(M, N, arg.ldd, hD_ref, hD);
+
+    // compressing other values into the same matrix without the plan widens it again
+    for(size_t i = 0; i < size_A; i++)
+        hA[i] = -hA[i];
+    for(size_t i = 0; i < size_D; i++)
+        hD_ref[i] = static_cast<To>(-static_cast<float>(hD_ref[i]));
+    CHECK_HIP_ERROR(dA.transfer_from(hA));
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtSpMMACompress2(
+            handle, matA, true, transA, dA, d_compressed, d_compressBuffer, stream),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmul(
+            handle, plan, &alpha, d_compressed, dB, &beta, dC, dD, dWorkspace, &stream, 1),
+        HIPSPARSE_STATUS_SUCCESS);
+    CHECK_HIP_ERROR(hipStreamSynchronize(stream));
+    CHECK_HIP_ERROR(hD.transfer_from(dD));
+    unit_check_general<To>(M, N, arg.ldd, hD_ref, hD);
+
+    CHECK_HIP_ERROR(hipStreamDestroy(stream));
+}
+
+template <typename Ti, typename To, typename Tc>
+void testing_aux_plan_serialize(const Arguments& arg)
+{
+    hipsparseOperation_t transA = char_to_hipsparselt_operation(arg.transA);
+    hipsparseOperation_t transB = char_to_hipsparselt_operation(arg.transB);
+
+    int64_t M = arg.M;
+    int64_t N = arg.N;
+    int64_t K = arg.K;
+
+    int64_t A_row = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? M : K;
+    int64_t A_col = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : M;
+    int64_t B_row = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : N;
+    int64_t B_col = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? N : K;
+
+    hipsparselt_local_handle handle{arg};
+
+    hipsparselt_local_mat_descr matA(hipsparselt_matrix_type_structured,
+                                     handle,
+                                     A_row,
+                                     A_col,
+                                     arg.lda,
+                                     arg.a_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matB(hipsparselt_matrix_type_dense,
+                                     handle,
+                                     B_row,
+                                     B_col,
+                                     arg.ldb,
+                                     arg.b_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matC(
+        hipsparselt_matrix_type_dense, handle, M, N, arg.ldc, arg.c_type, HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matD(
+        hipsparselt_matrix_type_dense, handle, M, N, arg.ldd, arg.d_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matA.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matB.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matC.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matD.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_descr matmul(
+        handle, transA, transB, matA, matB, matC, matD, arg.compute_type);
+    EXPECT_HIPSPARSE_STATUS(matmul.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    EXPECT_HIPSPARSE_STATUS(alg_sel.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    // select the last config, so that restoring the default one would not pass
+    int config_max_id = 0;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID, &config_max_id, sizeof(int)),
+        HIPSPARSE_STATUS_SUCCESS);
+    int config_id = config_max_id - 1;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgSetAttribute(
+            handle, alg_sel, HIPSPARSELT_MATMUL_ALG_CONFIG_ID, &config_id, sizeof(int)),
+        HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_plan plan(handle, matmul, alg_sel);
+    EXPECT_HIPSPARSE_STATUS(plan.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    size_t            data_size = 0;
+    hipsparseStatus_t status    = hipsparseLtMatmulPlanSerialize(handle, plan, nullptr, &data_size);
+    if(status == HIPSPARSE_STATUS_NOT_SUPPORTED)
+        return;
+    EXPECT_HIPSPARSE_STATUS(status, HIPSPARSE_STATUS_SUCCESS);
+
+    std::vector<char> data(data_size);
+    size_t            small_size = data_size - 1;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanSerialize(handle, plan, data.data(), &small_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+    EXPECT_EQ(small_size, data_size);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanSerialize(handle, plan, data.data(), &data_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparseLtMatmulPlan_t         plan2;
+    hipsparseLtMatmulAlgSelection_t alg_sel2;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanDeserialize(
+                                handle, &plan2, matmul, &alg_sel2, data.data(), data_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+
+    int config_id2 = -1, config_max_id2 = 0;
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, &alg_sel2, HIPSPARSELT_MATMUL_ALG_CONFIG_ID, &config_id2, sizeof(int)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulAlgGetAttribute(
+            handle, &alg_sel2, HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID, &config_max_id2, sizeof(int)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(config_id2, config_id);
+    EXPECT_EQ(config_max_id2, config_max_id);
+
+    size_t workspace_size = 0, workspace_size2 = 0;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGetWorkspace(handle, plan, &workspace_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGetWorkspace(handle, &plan2, &workspace_size2),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_EQ(workspace_size2, workspace_size);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanDestroy(&plan2), HIPSPARSE_STATUS_SUCCESS);
+
+    // a truncated or corrupted plan, and the plan of another problem, are refused
+    hipsparseLtMatmulPlan_t         plan3;
+    hipsparseLtMatmulAlgSelection_t alg_sel3;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanDeserialize(
+                                handle, &plan3, matmul, &alg_sel3, data.data(), data_size - 1),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    std::vector<char> corrupted(data);
+    corrupted[0] = ~corrupted[0];
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanDeserialize(
+                                handle, &plan3, matmul, &alg_sel3, corrupted.data(), data_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    hipsparselt_local_matmul_descr matmul_relu(
+        handle, transA, transB, matA, matB, matC, matD, arg.compute_type);
+    int activation_on = 1;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulDescSetAttribute(handle,
+                                                              matmul_relu,
+                                                              HIPSPARSELT_MATMUL_ACTIVATION_RELU,
+                                                              &activation_on,
+                                                              sizeof(activation_on)),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanDeserialize(
+                                handle, &plan3, matmul_relu, &alg_sel3, data.data(), data_size),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+}
+
+template <typename Ti, typename To, typename Tc>
+void testing_aux_plan_init_async(const Arguments& arg)
+{
+    hipsparseOperation_t transA = char_to_hipsparselt_operation(arg.transA);
+    hipsparseOperation_t transB = char_to_hipsparselt_operation(arg.transB);
+
+    int64_t M = arg.M;
+    int64_t N = arg.N;
+    int64_t K = arg.K;
+
+    int64_t A_row = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? M : K;
+    int64_t A_col = transA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : M;
+    int64_t B_row = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? K : N;
+    int64_t B_col = transB == HIPSPARSE_OPERATION_NON_TRANSPOSE ? N : K;
+
+    hipsparselt_local_handle handle{arg};
+
+    hipsparselt_local_mat_descr matA(hipsparselt_matrix_type_structured,
+                                     handle,
+                                     A_row,
+                                     A_col,
+                                     arg.lda,
+                                     arg.a_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matB(hipsparselt_matrix_type_dense,
+                                     handle,
+                                     B_row,
+                                     B_col,
+                                     arg.ldb,
+                                     arg.b_type,
+                                     HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matC(
+        hipsparselt_matrix_type_dense, handle, M, N, arg.ldc, arg.c_type, HIPSPARSE_ORDER_COL);
+    hipsparselt_local_mat_descr matD(
+        hipsparselt_matrix_type_dense, handle, M, N, arg.ldd, arg.d_type, HIPSPARSE_ORDER_COL);
+    EXPECT_HIPSPARSE_STATUS(matA.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matB.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matC.status(), HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(matD.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_descr matmul(
+        handle, transA, transB, matA, matB, matC, matD, arg.compute_type);
+    EXPECT_HIPSPARSE_STATUS(matmul.status(), HIPSPARSE_STATUS_SUCCESS);
+
+    hipsparselt_local_matmul_alg_selection alg_sel(handle, matmul, HIPSPARSELT_MATMUL_ALG_DEFAULT);
+    EXPECT_HIPSPARSE_STATUS(alg_sel.status(), HIPSPARSE_STATUS_SUCCESS);
+    hipsparselt_local_matmul_plan plan(handle, matmul, alg_sel);
+    EXPECT_HIPSPARSE_STATUS(plan.status(), HIPSPARSE_STATUS_SUCCESS);
+    size_t workspace_size = 0;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulGetWorkspace(handle, plan, &workspace_size),
+                            HIPSPARSE_STATUS_SUCCESS);
+
+    // the plans initialized in the background match the one initialized on this thread
+    constexpr int                   plans = 4;
+    hipsparseLtMatmulPlan_t         plans_async[plans];
+    hipsparseLtMatmulAlgSelection_t alg_sels_async[plans];
+    for(int i = 0; i < plans; i++)
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanInitAsync(handle,
+                                                               &plans_async[i],
+                                                               &alg_sels_async[i],
+                                                               matmul,
+                                                               HIPSPARSELT_MATMUL_ALG_DEFAULT),
+                                HIPSPARSE_STATUS_SUCCESS);
+
+    int ready = -1;
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanInitQuery(handle, &plans_async[0], &ready),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_TRUE(ready == 0 || ready == 1);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanInitQuery(handle, &plans_async[0], nullptr),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
+
+    for(int i = 0; i < plans - 1; i++)
+    {
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanInitWait(handle, &plans_async[i]),
+                                HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanInitQuery(handle, &plans_async[i], &ready),
+                                HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_EQ(ready, 1);
+        size_t workspace_size_async = 0;
+        EXPECT_HIPSPARSE_STATUS(
+            hipsparseLtMatmulGetWorkspace(handle, &plans_async[i], &workspace_size_async),
+            HIPSPARSE_STATUS_SUCCESS);
+        EXPECT_EQ(workspace_size_async, workspace_size);
+    }
+    // a plan whose initialization finished is initialized again in place
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanInitAsync(handle,
+                                                           &plans_async[0],
+                                                           &alg_sels_async[0],
+                                                           matmul,
+                                                           HIPSPARSELT_MATMUL_ALG_DEFAULT),
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanInitWait(handle, &plans_async[0]),
+                            HIPSPARSE_STATUS_SUCCESS);
+    // the last plan is destroyed without waiting, which waits for it
+    for(int i = 0; i < plans; i++)
+        EXPECT_HIPSPARSE_STATUS(hipsparseLtMatmulPlanDestroy(&plans_async[i]),
+                                HIPSPARSE_STATUS_SUCCESS);
+}
@@ -248,16 +248,27 @@ void testing_aux_mat_init_structured_bad_arg(const Arguments& arg)
 #endif
 
 #ifdef __HIP_PLATFORM_AMD__
+    // the ld of a row ordered matrix strides its rows, it must be at least the cols
     EXPECT_HIPSPARSE_STATUS(hipsparseLtStructuredDescriptorInit(handle,
                                                                 &m_descr,
-                                                                row,
+                                                                row * 2,
                                                                 col,
                                                                 ld,
                                                                 16,
                                                                 arg.a_type,
                                                                 HIPSPARSE_ORDER_ROW,
                                                                 HIPSPARSELT_SPARSITY_50_PERCENT),
-                            HIPSPARSE_STATUS_NOT_SUPPORTED);
+                            HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(hipsparseLtStructuredDescriptorInit(handle,
+                                                                &m_descr,
+                                                                row,
+                                                                col * 2,
+                                                                ld,
+                                                                16,
+                                                                arg.a_type,
+                                                                HIPSPARSE_ORDER_ROW,
+                                                                HIPSPARSELT_SPARSITY_50_PERCENT),
+                            HIPSPARSE_STATUS_INVALID_VALUE);
 #endif
 }
 
@@ -1008,6 +1019,31 @@ void testing_aux_matmul_set_get_attr(const Arguments& arg)
             handle, matmul, HIPSPARSELT_MATMUL_ACTIVATION_RELU_UPPERBOUND, &dataf_r, sizeof(dataf)),
         HIPSPARSE_STATUS_SUCCESS);
     ASSERT_TRUE(dataf == dataf_r);
+
+#ifdef __HIP_PLATFORM_AMD__
+    // the label is read back whole, and must leave room for its NUL
+    const char label[] = "layer0.attn.qkv";
+    char       label_r[64];
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulDescSetAttribute(
+            handle, matmul, HIPSPARSELT_MATMUL_LABEL, label, sizeof(label)),
+        HIPSPARSE_STATUS_SUCCESS);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulDescGetAttribute(
+            handle, matmul, HIPSPARSELT_MATMUL_LABEL, label_r, sizeof(label_r)),
+        HIPSPARSE_STATUS_SUCCESS);
+    ASSERT_TRUE(std::string(label) == label_r);
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulDescGetAttribute(
+            handle, matmul, HIPSPARSELT_MATMUL_LABEL, label_r, sizeof(label) - 1),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+
+    const std::string long_label(64, 'x');
+    EXPECT_HIPSPARSE_STATUS(
+        hipsparseLtMatmulDescSetAttribute(
+            handle, matmul, HIPSPARSELT_MATMUL_LABEL, long_label.c_str(), long_label.size() + 1),
+        HIPSPARSE_STATUS_INVALID_VALUE);
+#endif
 }
 
 void testing_aux_matmul_assign(const Arguments& arg)
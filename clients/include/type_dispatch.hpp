@@ -68,6 +68,43 @@ auto hipsparselt_simple_dispatch(const Arguments& arg)
     }
 }
 
+#if defined(__HIP_PLATFORM_AMD__)
+// fp8 and bf8 gemm functions, which write fp16, bf16 or fp32
+template <template <typename...> class TEST>
+auto hipsparselt_spmm_f8_dispatch(const Arguments& arg)
+{
+    if(arg.a_type == HIPSPARSELT_R_8F)
+    {
+        switch(arg.c_type)
+        {
+        case HIPSPARSELT_R_16F:
+            return TEST<__hip_fp8_e4m3_fnuz, __half, float, float>{}(arg);
+        case HIPSPARSELT_R_16BF:
+            return TEST<__hip_fp8_e4m3_fnuz, hip_bfloat16, float, float>{}(arg);
+        case HIPSPARSELT_R_32F:
+            return TEST<__hip_fp8_e4m3_fnuz, float, float, float>{}(arg);
+        default:
+            break;
+        }
+    }
+    else
+    {
+        switch(arg.c_type)
+        {
+        case HIPSPARSELT_R_16F:
+            return TEST<__hip_fp8_e5m2_fnuz, __half, float, float>{}(arg);
+        case HIPSPARSELT_R_16BF:
+            return TEST<__hip_fp8_e5m2_fnuz, hip_bfloat16, float, float>{}(arg);
+        case HIPSPARSELT_R_32F:
+            return TEST<__hip_fp8_e5m2_fnuz, float, float, float>{}(arg);
+        default:
+            break;
+        }
+    }
+    return TEST<void>{}(arg);
+}
+#endif
+
 // gemm functions
 template <template <typename...> class TEST>
 auto hipsparselt_spmm_dispatch(const Arguments& arg)
@@ -126,6 +163,18 @@ auto hipsparselt_spmm_dispatch(const Arguments& arg)
         {
             return TEST<int8_t, __half, int32_t, float>{}(arg);
         }
+        else if(Ti == HIPSPARSELT_R_8I && To == HIPSPARSELT_R_32I && Tc == HIPSPARSELT_COMPUTE_32I
+                && TBias == HIPSPARSELT_R_32F)
+        {
+            return TEST<int8_t, int32_t, int32_t, float>{}(arg);
+        }
+#if defined(__HIP_PLATFORM_AMD__)
+        else if((Ti == HIPSPARSELT_R_8F || Ti == HIPSPARSELT_R_8BF) && Tc == HIPSPARSELT_COMPUTE_32F
+                && TBias == HIPSPARSELT_R_32F)
+        {
+            return hipsparselt_spmm_f8_dispatch<TEST>(arg);
+        }
+#endif
     }
     return TEST<void>{}(arg);
 }
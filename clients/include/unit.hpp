@@ -40,38 +40,50 @@
 #define UNIT_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, UNIT_ASSERT_EQ)
 #define UNIT_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, UNIT_ASSERT_EQ)
 #else
-#define UNIT_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, UNIT_ASSERT_EQ)                  \
-    do                                                                                           \
-    {                                                                                            \
-        for(size_t k = 0; k < batch_count; k++)                                                  \
-            for(size_t j = 0; j < N; j++)                                                        \
-                for(size_t i = 0; i < M; i++)                                                    \
-                    if(hipsparselt_isnan(hCPU[i + j * size_t(lda) + k * strideA]))               \
-                    {                                                                            \
-                        ASSERT_TRUE(hipsparselt_isnan(hGPU[i + j * size_t(lda) + k * strideA])); \
-                    }                                                                            \
-                    else                                                                         \
-                    {                                                                            \
-                        UNIT_ASSERT_EQ(hCPU[i + j * size_t(lda) + k * strideA],                  \
-                                       hGPU[i + j * size_t(lda) + k * strideA]);                 \
-                    }                                                                            \
+#define UNIT_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, UNIT_ASSERT_EQ) \
+    do                                                                          \
+    {                                                                           \
+        hipsparselt_check_columns(batch_count, N, [&](int64_t k, int64_t j) {   \
+            size_t col    = j * size_t(lda) + k * strideA;                      \
+            bool   passed = hipsparselt_same_finite(&hCPU[col], &hGPU[col], M); \
+            if(!passed)                                                         \
+                [&] {                                                           \
+                    for(size_t i = col; i < col + M; i++)                       \
+                        if(hipsparselt_isnan(hCPU[i]))                          \
+                        {                                                       \
+                            ASSERT_TRUE(hipsparselt_isnan(hGPU[i]));            \
+                        }                                                       \
+                        else                                                    \
+                        {                                                       \
+                            UNIT_ASSERT_EQ(hCPU[i], hGPU[i]);                   \
+                        }                                                       \
+                    passed = true;                                              \
+                }();                                                            \
+            return passed;                                                      \
+        });                                                                     \
     } while(0)
 
 #define UNIT_CHECK_B(M, N, lda, hCPU, hGPU, batch_count, UNIT_ASSERT_EQ)              \
     do                                                                                \
     {                                                                                 \
-        for(size_t k = 0; k < batch_count; k++)                                       \
-            for(size_t j = 0; j < N; j++)                                             \
-                for(size_t i = 0; i < M; i++)                                         \
-                    if(hipsparselt_isnan(hCPU[k][i + j * size_t(lda)]))               \
-                    {                                                                 \
-                        ASSERT_TRUE(hipsparselt_isnan(hGPU[k][i + j * size_t(lda)])); \
-                    }                                                                 \
-                    else                                                              \
-                    {                                                                 \
-                        UNIT_ASSERT_EQ(hCPU[k][i + j * size_t(lda)],                  \
-                                       hGPU[k][i + j * size_t(lda)]);                 \
-                    }                                                                 \
+        hipsparselt_check_columns(batch_count, N, [&](int64_t k, int64_t j) {         \
+            size_t col    = j * size_t(lda);                                          \
+            bool   passed = hipsparselt_same_finite(&hCPU[k][col], &hGPU[k][col], M); \
+            if(!passed)                                                               \
+                [&] {                                                                 \
+                    for(size_t i = col; i < col + M; i++)                             \
+                        if(hipsparselt_isnan(hCPU[k][i]))                             \
+                        {                                                             \
+                            ASSERT_TRUE(hipsparselt_isnan(hGPU[k][i]));               \
+                        }                                                             \
+                        else                                                          \
+                        {                                                             \
+                            UNIT_ASSERT_EQ(hCPU[k][i], hGPU[k][i]);                   \
+                        }                                                             \
+                    passed = true;                                                    \
+                }();                                                                  \
+            return passed;                                                            \
+        });                                                                           \
     } while(0)
 
 //#define ASSERT_HALF_EQ(a, b) ASSERT_FLOAT_EQ(float(a), float(b))
@@ -204,6 +216,13 @@ inline void
     UNIT_CHECK(M, N, lda, 0, hCPU, hGPU, 1, ASSERT_EQ);
 }
 
+template <>
+inline void
+    unit_check_general(int64_t M, int64_t N, int64_t lda, const int32_t* hCPU, const int32_t* hGPU)
+{
+    UNIT_CHECK(M, N, lda, 0, hCPU, hGPU, 1, ASSERT_EQ);
+}
+
 template <typename T, typename T_hpa = T>
 void unit_check_general(int64_t                        M,
                         int64_t                        N,
@@ -297,6 +316,18 @@ inline void unit_check_general(int64_t       M,
     UNIT_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, ASSERT_EQ);
 }
 
+template <>
+inline void unit_check_general(int64_t        M,
+                               int64_t        N,
+                               int64_t        lda,
+                               int64_t        strideA,
+                               const int32_t* hCPU,
+                               const int32_t* hGPU,
+                               int64_t        batch_count)
+{
+    UNIT_CHECK(M, N, lda, strideA, hCPU, hGPU, batch_count, ASSERT_EQ);
+}
+
 template <typename T, typename T_hpa = T>
 void unit_check_general(int64_t                                    M,
                         int64_t                                    N,
@@ -487,23 +518,22 @@ inline int64_t unit_check_diff(
 {
     using c_type  = std::conditional_t<std::is_same<__half, T>::value, float, T>;
     int64_t error = 0;
-    do
-    {
-        for(size_t k = 0; k < batch_count; k++)
-            for(size_t j = 0; j < N; j++)
-                for(size_t i = 0; i < M; i++)
-                    if(hipsparselt_isnan(hCPU[i + j * size_t(lda) + k * stride]))
-                    {
-                        error += hipsparselt_isnan(hGPU[i + j * size_t(lda) + k * stride]) ? 0 : 1;
-                    }
-                    else
-                    {
-                        error += static_cast<c_type>(hCPU[i + j * size_t(lda) + k * stride])
-                                         == static_cast<c_type>(
-                                             hGPU[i + j * size_t(lda) + k * stride])
-                                     ? 0
-                                     : 1;
-                    }
-    } while(0);
+#pragma omp parallel for collapse(2) reduction(+ : error)
+    for(int64_t k = 0; k < batch_count; k++)
+        for(int64_t j = 0; j < N; j++)
+        {
+            size_t col = j * size_t(lda) + k * stride;
+            if(hipsparselt_same_finite(hCPU + col, hGPU + col, M))
+                continue;
+            for(size_t i = col; i < col + M; i++)
+                if(hipsparselt_isnan(hCPU[i]))
+                {
+                    error += hipsparselt_isnan(hGPU[i]) ? 0 : 1;
+                }
+                else
+                {
+                    error += static_cast<c_type>(hCPU[i]) == static_cast<c_type>(hGPU[i]) ? 0 : 1;
+                }
+        }
     return error;
 }
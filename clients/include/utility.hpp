@@ -27,6 +27,7 @@
 #pragma once
 
 #include "hipsparselt_vector.hpp"
+#include <algorithm>
 #include <cstdio>
 #include <hipsparselt/hipsparselt.h>
 #include <iomanip>
@@ -367,6 +368,10 @@ int64_t query_device_property();
 /*  set current device to device_id */
 void set_device(int64_t device_id);
 
+/*  the peak 2:4 sparse Gflops for the type of A and the peak GB/s of the current device, 0 when
+ *  its arch is not known */
+void hipsparselt_device_peaks(hipsparseLtDatatype_t type, double* gflops, double* gbps);
+
 /* ============================================================================================ */
 /*  timing: HIP only provides very limited timers function clock() and not general;
             hipsparselt sync CPU and device and use more accurate CPU timer*/
@@ -380,6 +385,77 @@ double get_time_us_sync(hipStream_t stream);
 /*! \brief  CPU Timer(in microsecond): no GPU synchronization and return wall time */
 double get_time_us_no_sync();
 
+/*! \brief  GPU Timer of each call of a timed loop: the events recorded around the calls are read
+ *          once the stream is synchronized, the calls are not synchronized one by one */
+class hipsparselt_call_timer
+{
+    std::vector<hipEvent_t> m_events;
+
+public:
+    // without enabled, start and stop do nothing and there are no samples
+    hipsparselt_call_timer(bool enabled, int calls);
+    ~hipsparselt_call_timer();
+
+    hipsparselt_call_timer(const hipsparselt_call_timer&)            = delete;
+    hipsparselt_call_timer& operator=(const hipsparselt_call_timer&) = delete;
+
+    void start(int call, hipStream_t stream);
+    void stop(int call, hipStream_t stream);
+
+    // time of each call in microseconds, after stream is synchronized
+    std::vector<double> samples_us() const;
+};
+
+/* ============================================================================================ */
+/*! \brief  The dense GEMM a sparse matmul is compared with, D = alpha op(A) op(B) + beta C of the
+ *          decompressed matrices in the column major layouts and the types of the matmul */
+struct hipsparselt_dense_gemm
+{
+    hipsparseOperation_t     transA, transB;
+    int64_t                  m, n, k;
+    hipsparseLtDatatype_t    a_type, b_type, c_type, d_type;
+    hipsparseLtComputetype_t compute_type;
+    const void*              A;
+    const void*              B;
+    const void*              C;
+    void*                    D;
+    int64_t                  lda, ldb, ldc, ldd;
+    int64_t                  stride_a, stride_b, stride_c, stride_d;
+    int                      batch_count;
+    float                    alpha, beta;
+};
+
+/*! \brief  Time in us of a hot call of the dense GEMM run by hipBLASLt on stream, or a negative
+ *          value when the clients are built without hipBLASLt or it has no algorithm for it */
+double hipsparselt_dense_gemm_us(const hipsparselt_dense_gemm& gemm,
+                                 int                           cold_calls,
+                                 int                           hot_calls,
+                                 hipStream_t                   stream);
+
+/*! \brief  Time in us of a hot copy of host to device in the order of stream, the copy is
+ *          asynchronous to the host only when host is pinned */
+template <typename T>
+double hipsparselt_upload_us(device_vector<T>&     device,
+                             const host_vector<T>& host,
+                             int                   cold_calls,
+                             int                   hot_calls,
+                             hipStream_t           stream)
+{
+    for(int i = 0; i < cold_calls; i++)
+        if(device.transfer_from(host, stream) != hipSuccess)
+            return -1.0;
+
+    double us = get_time_us_sync(stream);
+    for(int i = 0; i < hot_calls; i++)
+        if(device.transfer_from(host, stream) != hipSuccess)
+            return -1.0;
+    return (get_time_us_sync(stream) - us) / std::max(hot_calls, 1);
+}
+
+/* ============================================================================================ */
+// Number of host heap allocations made so far by all the threads (debug counter)
+size_t hipsparselt_host_alloc_count();
+
 /* ============================================================================================ */
 // Return path of this executable
 std::string hipsparselt_exepath();
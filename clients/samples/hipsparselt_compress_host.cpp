@@ -0,0 +1,294 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+// Prune and compress a dense matrix stored in a raw binary file on the CPU, and write the
+// compressed matrix and metadata in the layout hipsparseLtSpMMACompress() writes on the device.
+// No GPU is needed, so weights can be converted offline and shipped compressed.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <hipsparselt/hipsparselt.h>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#ifndef CHECK_HIPSPARSELT_ERROR
+#define CHECK_HIPSPARSELT_ERROR(error)                           \
+    if(error != HIPSPARSE_STATUS_SUCCESS)                        \
+    {                                                            \
+        fprintf(stderr, "hipSPARSELt error(Err=%d) : ", error);  \
+        if(error == HIPSPARSE_STATUS_NOT_INITIALIZED)            \
+            fprintf(stderr, "HIPSPARSE_STATUS_NOT_INITIALIZED"); \
+        if(error == HIPSPARSE_STATUS_INTERNAL_ERROR)             \
+            fprintf(stderr, " HIPSPARSE_STATUS_INTERNAL_ERROR"); \
+        if(error == HIPSPARSE_STATUS_INVALID_VALUE)              \
+            fprintf(stderr, "HIPSPARSE_STATUS_INVALID_VALUE");   \
+        if(error == HIPSPARSE_STATUS_NOT_SUPPORTED)              \
+            fprintf(stderr, "HIPSPARSE_STATUS_NOT_SUPPORTED");   \
+        fprintf(stderr, "\n");                                   \
+        exit(EXIT_FAILURE);                                      \
+    }
+#endif
+
+// cppcheck-suppress constParameter
+static void show_usage(char* argv[])
+{
+    std::cerr
+        << "Usage: " << argv[0] << " <options>\n"
+        << "options:\n"
+        << "\t-h, --help\t\t\t\tShow this help message\n"
+        << "\t-i, --input \t\tfile \t\tdense matrix, raw column major elements\n"
+        << "\t-o, --output \t\tfile \t\tcompressed matrix and metadata\n"
+        << "\t-m \t\t\tm\t\trows of the structured matrix\n"
+        << "\t-n \t\t\tn\t\tcolumns of the structured matrix\n"
+        << "\t--ld \t\t\tld \t\tleading dimension, default m\n"
+        << "\t--trans \t\ttrans \t\toperation of the matmul on the structured matrix, N or T\n"
+        << "\t--stride \t\tstride \t\tstride between the batches, default ld * n\n"
+        << "\t--batch_count \t\tbatch_count \tnumber of batches\n"
+        << "\t--sparse_b \t\t\t\tthe structured matrix is matrix B of the matmul\n"
+        << "\t-r \t\t\tprecision \th=half, b=bfloat16, i8=int8, f8=fp8, bf8=bf8\n"
+        << "\t--prune \t\talgorithm \tstrip, tile or none (the input is already pruned)\n"
+        << "\t--threads \t\tthreads \tnumber of threads, default one for each core\n"
+        << std::endl;
+}
+
+static int parse_arguments(int                    argc,
+                           char*                  argv[],
+                           std::string&           input,
+                           std::string&           output,
+                           int64_t&               m,
+                           int64_t&               n,
+                           int64_t&               ld,
+                           int64_t&               stride,
+                           int&                   batch_count,
+                           hipsparseOperation_t&  trans,
+                           hipsparseLtDatatype_t& type,
+                           bool&                  sparse_b,
+                           int&                   prune,
+                           int&                   threads)
+{
+    for(int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if((arg == "-h") || (arg == "--help"))
+        {
+            return EXIT_FAILURE;
+        }
+        else if((arg == "-i" || arg == "--input") && (i + 1 < argc))
+        {
+            input = argv[++i];
+        }
+        else if((arg == "-o" || arg == "--output") && (i + 1 < argc))
+        {
+            output = argv[++i];
+        }
+        else if((arg == "-m") && (i + 1 < argc))
+        {
+            m = atoll(argv[++i]);
+        }
+        else if((arg == "-n") && (i + 1 < argc))
+        {
+            n = atoll(argv[++i]);
+        }
+        else if((arg == "--ld") && (i + 1 < argc))
+        {
+            ld = atoll(argv[++i]);
+        }
+        else if((arg == "--stride") && (i + 1 < argc))
+        {
+            stride = atoll(argv[++i]);
+        }
+        else if((arg == "--batch_count") && (i + 1 < argc))
+        {
+            batch_count = atoi(argv[++i]);
+        }
+        else if((arg == "--threads") && (i + 1 < argc))
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if(arg == "--sparse_b")
+        {
+            sparse_b = true;
+        }
+        else if((arg == "--trans") && (i + 1 < argc))
+        {
+            ++i;
+            if(strcmp(argv[i], "N") == 0 || strcmp(argv[i], "n") == 0)
+                trans = HIPSPARSE_OPERATION_NON_TRANSPOSE;
+            else if(strcmp(argv[i], "T") == 0 || strcmp(argv[i], "t") == 0)
+                trans = HIPSPARSE_OPERATION_TRANSPOSE;
+            else
+            {
+                std::cerr << "do not recognize value " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if((arg == "-r") && (i + 1 < argc))
+        {
+            ++i;
+            if(strcmp(argv[i], "h") == 0)
+                type = HIPSPARSELT_R_16F;
+            else if(strcmp(argv[i], "b") == 0)
+                type = HIPSPARSELT_R_16BF;
+            else if(strcmp(argv[i], "i8") == 0)
+                type = HIPSPARSELT_R_8I;
+            else if(strcmp(argv[i], "f8") == 0)
+                type = HIPSPARSELT_R_8F;
+            else if(strcmp(argv[i], "bf8") == 0)
+                type = HIPSPARSELT_R_8BF;
+            else
+            {
+                std::cerr << "do not recognize value " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if((arg == "--prune") && (i + 1 < argc))
+        {
+            ++i;
+            if(strcmp(argv[i], "strip") == 0)
+                prune = HIPSPARSELT_PRUNE_SPMMA_STRIP;
+            else if(strcmp(argv[i], "tile") == 0)
+                prune = HIPSPARSELT_PRUNE_SPMMA_TILE;
+            else if(strcmp(argv[i], "none") == 0)
+                prune = -1;
+            else
+            {
+                std::cerr << "do not recognize value " << argv[i] << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else
+        {
+            std::cerr << "error with " << arg << std::endl;
+            std::cerr << "do not recognize option" << std::endl << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+    return input.empty() || output.empty() || m <= 0 || n <= 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+static int64_t element_bytes(hipsparseLtDatatype_t type)
+{
+    return type == HIPSPARSELT_R_16F || type == HIPSPARSELT_R_16BF ? 2 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string           input, output;
+    int64_t               m = 0, n = 0, ld = 0, stride = -1;
+    int                   batch_count = 1;
+    hipsparseOperation_t  trans       = HIPSPARSE_OPERATION_NON_TRANSPOSE;
+    hipsparseLtDatatype_t type        = HIPSPARSELT_R_16F;
+    bool                  sparse_b    = false;
+    int                   prune       = HIPSPARSELT_PRUNE_SPMMA_STRIP;
+    int                   threads     = 0;
+
+    if(parse_arguments(argc,
+                       argv,
+                       input,
+                       output,
+                       m,
+                       n,
+                       ld,
+                       stride,
+                       batch_count,
+                       trans,
+                       type,
+                       sparse_b,
+                       prune,
+                       threads))
+    {
+        show_usage(argv);
+        return EXIT_FAILURE;
+    }
+
+    if(ld == 0)
+        ld = m;
+    if(stride < 0)
+        stride = ld * n;
+
+    // a broadcast matrix only stores its first batch
+    int64_t elements = stride == 0 ? ld * n : stride * (batch_count - 1) + ld * n;
+    int64_t bytes    = elements * element_bytes(type);
+
+    std::vector<char> dense(bytes);
+    std::ifstream     in(input, std::ios::binary);
+    if(!in.read(dense.data(), bytes))
+    {
+        std::cerr << "cannot read " << bytes << " bytes from " << input << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    size_t compressed_size;
+    CHECK_HIPSPARSELT_ERROR(hipsparseLtSpMMACompressedSizeHost(
+        m, n, ld, type, batch_count, stride, !sparse_b, trans, &compressed_size));
+    std::vector<char> compressed(compressed_size);
+
+    auto start = std::chrono::steady_clock::now();
+    if(prune >= 0)
+        CHECK_HIPSPARSELT_ERROR(hipsparseLtSpMMAPruneHost(m,
+                                                          n,
+                                                          ld,
+                                                          type,
+                                                          batch_count,
+                                                          stride,
+                                                          !sparse_b,
+                                                          trans,
+                                                          dense.data(),
+                                                          dense.data(),
+                                                          hipsparseLtPruneAlg_t(prune),
+                                                          threads));
+    CHECK_HIPSPARSELT_ERROR(hipsparseLtSpMMACompressHost(m,
+                                                         n,
+                                                         ld,
+                                                         type,
+                                                         batch_count,
+                                                         stride,
+                                                         !sparse_b,
+                                                         trans,
+                                                         dense.data(),
+                                                         compressed.data(),
+                                                         threads));
+    auto end = std::chrono::steady_clock::now();
+
+    std::ofstream out(output, std::ios::binary);
+    if(!out.write(compressed.data(), compressed_size))
+    {
+        std::cerr << "cannot write " << compressed_size << " bytes to " << output << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    double us = std::chrono::duration<double, std::micro>(end - start).count();
+    std::cout << "m, n, ld, stride, batch_count, dense_bytes, compressed_bytes, us, GB/s"
+              << std::endl;
+    std::cout << m << ", " << n << ", " << ld << ", " << stride << ", " << batch_count << ", "
+              << bytes << ", " << compressed_size << ", " << us << ", "
+              << (bytes + compressed_size) / us / 1e3 << std::endl;
+    return EXIT_SUCCESS;
+}
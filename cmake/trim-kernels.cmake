@@ -0,0 +1,58 @@
+# ########################################################################
+# Copyright (c) 2024 Advanced Micro Devices, Inc. All rights reserved.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell cop-
+# ies of the Software, and to permit persons to whom the Software is furnished
+# to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IM-
+# PLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+# FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+# COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+# IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNE-
+# CTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+#
+# ########################################################################
+
+# Copies the logic files and the code objects of SOURCE which solve the problems of
+# HIPSPARSELT_KERNEL_SIGNATURES and HIPSPARSELT_KERNEL_TUNING_DB to DEST, and sets
+# ARCHS to the archs of the copied files.
+function (hipsparselt_trim_kernels SOURCE DEST ARCHS)
+  set(_trim_args --source ${SOURCE} --dest ${DEST})
+  if (HIPSPARSELT_KERNEL_SIGNATURES)
+    string(REPLACE ";" "," _signatures "${HIPSPARSELT_KERNEL_SIGNATURES}")
+    list(APPEND _trim_args --signatures ${_signatures})
+  endif()
+  if (HIPSPARSELT_KERNEL_TUNING_DB)
+    list(APPEND _trim_args --tuning-db ${HIPSPARSELT_KERNEL_TUNING_DB})
+  endif()
+
+  execute_process(
+    COMMAND python3 ${CMAKE_SOURCE_DIR}/library/src/hcc_detail/rocsparselt/utils/trimKernels.py ${_trim_args}
+    OUTPUT_VARIABLE _archs
+    RESULT_VARIABLE _result)
+  if (NOT _result EQUAL 0)
+    message(FATAL_ERROR "cannot trim the kernels of ${SOURCE}")
+  endif()
+  message(STATUS "Kernels of ${SOURCE} trimmed to ${DEST} for ${_archs}")
+  set(${ARCHS} ${_archs} PARENT_SCOPE)
+endfunction()
+
+# Removes the targets, with or without their features, whose arch is not in ARCHS from the
+# list TARGETS
+function (hipsparselt_filter_archs TARGETS ARCHS)
+  set(_targets)
+  foreach (_target ${${TARGETS}})
+    string(REGEX REPLACE ":.*" "" _arch ${_target})
+    if (_arch IN_LIST ARCHS)
+      list(APPEND _targets ${_target})
+    endif()
+  endforeach()
+  set(${TARGETS} ${_targets} PARENT_SCOPE)
+endfunction()
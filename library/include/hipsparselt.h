@@ -79,6 +79,7 @@
 #if defined(__HIP_PLATFORM_AMD__)
 #include <hip/hip_bfloat16.h>
 #include <hip/hip_fp16.h>
+#include <hip/hip_fp8.h>
 #include <hip/library_types.h>
 #else
 #include <cuda_bf16.h>
@@ -162,6 +163,7 @@ typedef enum
    HIPSPARSELT_R_16F = 150, /**< 16 bit floating point, real */
    HIPSPARSELT_R_32F = 151, /**< 32 bit floating point, real */
    HIPSPARSELT_R_8I  = 160, /**<  8 bit signed integer, real */
+   HIPSPARSELT_R_32I = 162, /**< 32 bit signed integer, real, only as the output of int8 inputs */
    HIPSPARSELT_R_16BF = 168, /**< 16 bit bfloat, real */
    HIPSPARSELT_R_8F  = 170, /**<  8 bit floating point, real */
    HIPSPARSELT_R_8BF  = 171, /**<  8 bit bfloat, real */
@@ -177,7 +179,7 @@ typedef enum
  */
 typedef enum {
    HIPSPARSELT_SPARSITY_50_PERCENT /**< 50% sparsity ratio - 1:2 for tf32 and float,
-                                                             2:4 for half, bfloat16, int */
+                                                             2:4 for half, bfloat16, int, fp8 and bf8 */
 } hipsparseLtSparsity_t;
 
 /*! \ingroup types_module
@@ -220,8 +222,8 @@ typedef enum {
    HIPSPARSELT_MATMUL_ACTIVATION_RELU_THRESHOLD = 2,   /**< Lower threshold of the ReLU activation function. */
    HIPSPARSELT_MATMUL_ACTIVATION_GELU = 3,             /**< GeLU activation function. */
    HIPSPARSELT_MATMUL_ACTIVATION_GELU_SCALING = 4,     /**< Scaling coefficient for the GeLU activation function. It implies gelu is endable */
-   HIPSPARSELT_MATMUL_ALPHA_VECTOR_SCALING = 5,        /**< Enable/Disable alpha vector (per-channel) scaling */
-   HIPSPARSELT_MATMUL_BETA_VECTOR_SCALING = 6,         /**< Enable/Disable beta vector (per-channel) scaling */
+   HIPSPARSELT_MATMUL_ALPHA_VECTOR_SCALING = 5,        /**< Enable/Disable alpha vector (per-channel) scaling, the alpha of the matmul is then a device vector of m floats. Only the Split-K configs of the HIP backend without Tensile support it. */
+   HIPSPARSELT_MATMUL_BETA_VECTOR_SCALING = 6,         /**< Enable/Disable beta vector (per-channel) scaling, the beta of the matmul is then a device vector of m floats. Needs the alpha vector scaling. */
    HIPSPARSELT_MATMUL_BIAS_STRIDE = 7,                 /**< Bias pointer. The bias vector size must equal to the number of rows of the output matrix (D). */
    HIPSPARSELT_MATMUL_BIAS_POINTER = 8,                /**< Bias stride between consecutive bias vectors. 0 means broadcast the first bias vector. */
    HIPSPARSELT_MATMUL_ACTIVATION_ABS = 9,              /**< ABS activation function. HIP backend only */
@@ -235,6 +237,24 @@ typedef enum {
                                                             When Input's datatype is FP16 - Bias type can be FP16 or FP32. (default FP16)
                                                             When Input's datatype is BF16 - Bias type can be BF16 or FP32. (default BF16)
                                                             In other cases - Bias type is FP32.*/
+   HIPSPARSELT_MATMUL_SCALE_A = 17,                    /**< Scale of the matrix A, a float applied to A*B together with alpha (default 1). Dequantizes FP8 inputs. HIP backend only */
+   HIPSPARSELT_MATMUL_SCALE_B = 18,                    /**< Scale of the matrix B, a float applied to A*B together with alpha (default 1). Dequantizes FP8 inputs. HIP backend only */
+   HIPSPARSELT_MATMUL_D_SCALE = 19,                    /**< Scale of the matrix D, a float multiplying the result after the bias and the activation (default 1). Quantizes the output. Only the Split-K configs of the HIP backend without Tensile support a scale other than 1. */
+   HIPSPARSELT_MATMUL_D_SATURATE = 20,                 /**< Enable/Disable the saturation of the scaled result to the finite range of the type of D. int8 outputs always saturate. Only the Split-K configs of the HIP backend without Tensile support it. */
+   HIPSPARSELT_MATMUL_AMAX_D_POINTER = 21,             /**< Device pointer to a float which receives the maximum of the absolute values of D over all batches, before the scale of D. Only the Split-K configs of the HIP backend without Tensile support it. */
+   HIPSPARSELT_MATMUL_RESIDUAL_POINTER = 22,           /**< Device pointer to a residual matrix R, of the type and the layout of D, added after the bias and the activation and before the scale of D: D = act(alpha*A*B + beta*C + bias) + R. Only the Split-K configs of the HIP backend without Tensile support it. */
+   HIPSPARSELT_MATMUL_RESIDUAL_STRIDE = 23,            /**< Stride between consecutive residual matrices, in elements. 0 means broadcast the first residual matrix. HIP backend only */
+   HIPSPARSELT_MATMUL_GATE_POINTER = 24,               /**< Device pointer to a gate matrix G, of the type and the layout of D, multiplying the activated result before the residual: D = act(alpha*A*B + beta*C + bias) * G + R. G may be D itself, so a gated linear unit (GeGLU with gelu) runs as the matmul of the up projection into D followed by the matmul of the gate projection with G = D. Only the Split-K configs of the HIP backend without Tensile support it. */
+   HIPSPARSELT_MATMUL_GATE_STRIDE = 25,                /**< Stride between consecutive gate matrices, in elements. 0 means broadcast the first gate matrix. HIP backend only */
+   HIPSPARSELT_MATMUL_ACTIVATION_SILU = 26,            /**< SiLU (Swish) activation function, x*sigmoid(x). Only the Split-K configs of the HIP backend without Tensile support it. */
+   HIPSPARSELT_MATMUL_ACTIVATION_CLAMP = 27,           /**< Clamp activation function, min(max(x, lower bound), upper bound). Only the Split-K configs of the HIP backend without Tensile support it. */
+   HIPSPARSELT_MATMUL_ACTIVATION_CLAMP_MIN = 28,       /**< Lower bound of the clamp activation function (default -inf). HIP backend only */
+   HIPSPARSELT_MATMUL_ACTIVATION_CLAMP_MAX = 29,       /**< Upper bound of the clamp activation function (default inf). HIP backend only */
+   HIPSPARSELT_MATMUL_CU_COUNT = 30,                   /**< Number of CUs the matmul runs on, an int (default 0, all the CUs of the device). The configs are selected and scheduled for these CUs, set it to the number of bits of the mask of a stream created with hipExtStreamCreateWithCUMask. Set it before hipsparseLtMatmulAlgSelectionInit. HIP backend only */
+   HIPSPARSELT_MATMUL_LABEL = 31,                      /**< Label of the matmul, a NUL-terminated string of up to 63 characters, dataSize counting the NUL. It names the roctx ranges of the plans initialized from the descriptor. Set it before hipsparseLtMatmulPlanInit. HIP backend only */
+   HIPSPARSELT_MATMUL_CANDIDATES = 32,                 /**< Number of configs hipsparseLtMatmulAlgSelectionInit keeps, an int (default 0: 10 with Tensile, which also keeps the best of each other Split-K factor, all the kernels of the library without). The configs are ranked by a selection heuristic which predicts their time from the tile and wave counts, config 0 of hipsparseLtMatmulAlgSelectionInit is the one it predicts fastest and a small count searches only the best ranked. Set it before hipsparseLtMatmulAlgSelectionInit. HIP backend only */
+   HIPSPARSELT_MATMUL_BIAS_GRAD_POINTER = 33,          /**< Device pointer to a vector of m floats which receives the sums of the rows of D over its columns and its batches, the gradient of a bias added to D, so the backward pass needs no separate reduction of D. The partial sums are kept in the workspace. Set it before hipsparseLtMatmulAlgSelectionInit. Only the Split-K configs of the HIP backend without Tensile support it. */
+   HIPSPARSELT_MATMUL_SPARSE_DYNAMIC = 34,             /**< Enable/Disable the dynamic sparsity of the structured operand, an int (default 0). When enabled the structured operand given to hipsparseLtMatmul is the dense matrix, which the matmul prunes with HIPSPARSELT_PRUNE_SPMMA_STRIP and compresses into the workspace in a single kernel on the first stream before the multiplication, so fresh activations need no separate prune and compress. Set it before hipsparseLtMatmulAlgSelectionInit. HIP backend only */
 } hipsparseLtMatmulDescAttribute_t;
 
 /*! \ingroup types_module
@@ -258,9 +278,15 @@ typedef enum {
    HIPSPARSELT_MATMUL_ALG_CONFIG_ID = 0,     // READ/WRITE
    HIPSPARSELT_MATMUL_ALG_CONFIG_MAX_ID = 1, // READ-ONLY
    HIPSPARSELT_MATMUL_SEARCH_ITERATIONS = 2,  // READ/WRITE
-   HIPSPARSELT_MATMUL_SPLIT_K = 3,
-   HIPSPARSELT_MATMUL_SPLIT_K_MODE = 4,
-   HIPSPARSELT_MATMUL_SPLIT_K_BUFFERS = 5,
+   HIPSPARSELT_MATMUL_SPLIT_K = 3, // READ/WRITE, Split-K factor, restricts the configs to the ones which split K by it, 1 for no split. Reads the factor of the current config.
+   HIPSPARSELT_MATMUL_SPLIT_K_MODE = 4, // READ/WRITE, hipsparseLtSplitKMode_t, restricts the configs which split K to the ones which reduce their partial results this way. Reads the mode of the current config.
+   HIPSPARSELT_MATMUL_SPLIT_K_BUFFERS = 5, // READ-ONLY, partial results kept in the workspace by the current config, 0 when it does not use a reduction kernel.
+   HIPSPARSELT_MATMUL_SEARCH_FLUSH_CACHE = 6, // READ/WRITE, flush L2 and MALL before each timed run of the search, 0 or 1. Only work when using HIP backend.
+   HIPSPARSELT_MATMUL_SEARCH_RESULTS = 7, // READ-ONLY, array of hipsparseLtMatmulSearchResult_t, timings of the fastest configs measured by the last search. Only work when using HIP backend.
+   HIPSPARSELT_MATMUL_STREAM_K = 8, // READ/WRITE, Stream-K schedule, 0 or 1. 1 restricts the configs to the ones which run the last partial wave of tiles split over K on the idle CUs, 0 leaves them out. Only work when using HIP backend without Tensile.
+   HIPSPARSELT_MATMUL_SEARCH_DENSE = 9, // READ/WRITE, 0 or 1. 1 makes the search also time a dense path, a kernel which multiplies the compressed matrix without the sparse instructions, hipsparseLtMatmul then runs the faster of the two. Only work when using HIP backend.
+   HIPSPARSELT_MATMUL_DENSE_SELECTED = 10, // READ-ONLY, 1 when the last search found the dense path faster than the best config, always 1 on a device without sparse MFMA instructions, whose matmul only has the dense path.
+   HIPSPARSELT_MATMUL_CONFIG_SCORES = 11, // READ-ONLY, array of floats, the fraction of the peak the selection heuristic predicts for each config, in the order of the config ids, which is the order of decreasing scores. dataSize is a multiple of sizeof(float), the floats past the last config read 0. Only work when using HIP backend.
 } hipsparseLtMatmulAlgAttribute_t;
 
 /*! \ingroup types_module
@@ -285,6 +311,103 @@ typedef enum {
    HIPSPARSELT_SPLIT_K_MODE_TWO_KERNELS = 1, /**< Use another kernel to do the final reduction */
 } hipsparseLtSplitKMode_t;
 
+/*! \ingroup types_module
+ *  \brief Statistics of the config cache of a handle.
+ *
+ *  \details
+ *  The \ref hipsparseLtConfigCacheStats_t is filled by the \ref hipsparseLtGetConfigCacheStats function.
+ */
+typedef struct {
+   int64_t hits;      /**< algorithm selection initializations served by the cache. */
+   int64_t misses;    /**< algorithm selection initializations which queried the backend. */
+   int64_t evictions; /**< entries dropped to make room for a new problem. */
+   int64_t entries;   /**< problems currently held by the cache. */
+   int64_t capacity;  /**< maximum number of problems held by the cache. */
+} hipsparseLtConfigCacheStats_t;
+
+/*! \ingroup types_module
+ *  \brief Statistics of the code objects loaded on a device.
+ *
+ *  \details
+ *  The \ref hipsparseLtCodeObjectStats_t is filled by the \ref hipsparseLtGetCodeObjectStats function.
+ */
+typedef struct {
+   int64_t bytes;     /**< bytes of the code objects currently loaded. */
+   int64_t modules;   /**< code objects currently loaded. */
+   int64_t pinned;    /**< code objects bound for a live plan or captured, never evicted. */
+   int64_t evictions; /**< code objects unloaded to keep bytes under capacity. */
+   int64_t capacity;  /**< maximum bytes of the code objects, 0 for no limit. */
+} hipsparseLtCodeObjectStats_t;
+
+/*! \ingroup types_module
+ *  \brief Timings of an algorithm measured by \ref hipsparseLtMatmulSearch.
+ *
+ *  \details
+ *  An array of \ref hipsparseLtMatmulSearchResult_t is returned by \ref hipsparseLtMatmulAlgGetAttribute
+ *  with HIPSPARSELT_MATMUL_SEARCH_RESULTS, fastest first. Up to 16 algorithms are kept per search.
+ */
+typedef struct {
+   int    config_id;           /**< algorithm id of the entry, -1 after the last measured algorithm. */
+   int    samples;             /**< timed runs of the algorithm, the warm up excluded. */
+   float  mean_ms;             /**< mean time of a run in milliseconds. */
+   float  min_ms;              /**< fastest run in milliseconds. */
+   size_t max_workspace_bytes; /**< workspace required by the algorithm. */
+   char   kernel_name[256];    /**< name of the kernel, truncated to fit. */
+} hipsparseLtMatmulSearchResult_t;
+
+/*! \ingroup types_module
+ *  \brief Counters of the matrix multiplications of a plan.
+ *
+ *  \details
+ *  The \ref hipsparseLtMatmulPlanStats_t is filled by the \ref hipsparseLtMatmulPlanGetStats function.
+ */
+typedef struct {
+   int64_t calls;               /**< matrix multiplications run with the plan, the searches excluded. */
+   int64_t timed_calls;         /**< sampled calls whose GPU time was measured. */
+   double  gpu_time_ms;         /**< GPU time of the timed calls in milliseconds. */
+   double  host_time_ms;        /**< host time spent in the calls in milliseconds. */
+   size_t  workspace_bytes;     /**< workspace used by the last call. */
+   size_t  max_workspace_bytes; /**< largest workspace used by a call. */
+   int     sample_rate;         /**< one call in sample_rate is timed on the GPU. */
+   int     config_id;           /**< selected algorithm id of the plan. */
+   int     config_index;        /**< index of the kernel of the selected algorithm in the library. */
+   int     dense_selected;      /**< 1 when the plan runs the dense path. */
+   char    kernel_name[256];    /**< name of the kernel of the selected algorithm, truncated to fit. */
+} hipsparseLtMatmulPlanStats_t;
+
+/*! \ingroup types_module
+ *  \brief Specify the update rule of \ref hipsparseLtSpMMACompressedUpdate.
+ */
+typedef enum {
+   HIPSPARSELT_OPTIMIZER_SGD  = 0, /**< w -= lr * g, with a momentum buffer in state1 when beta1 is not 0. */
+   HIPSPARSELT_OPTIMIZER_ADAM = 1, /**< Adam with the first moment in state1 and the second moment in state2. */
+} hipsparseLtOptimizer_t;
+
+/*! \ingroup types_module
+ *  \brief Parameters of an optimizer step on a compressed matrix.
+ *
+ *  \details
+ *  The \ref hipsparseLtOptimizerParams_t is used in the \ref hipsparseLtSpMMACompressedUpdate function.
+ *  weight_decay * w is added to the gradient before the update.
+ */
+typedef struct {
+   hipsparseLtOptimizer_t optimizer;    /**< update rule. */
+   float                  lr;           /**< learning rate. */
+   float                  beta1;        /**< momentum of SGD, decay of the first moment of Adam. */
+   float                  beta2;        /**< decay of the second moment of Adam. */
+   float                  eps;          /**< added to the square root of the second moment of Adam. */
+   float                  weight_decay; /**< L2 penalty. */
+   int64_t                step;         /**< step of Adam, from 1, for the bias correction. */
+} hipsparseLtOptimizerParams_t;
+
+/*! \ingroup types_module
+ *  \brief Specify the dimension \ref hipsparseLtMatmulSharded splits the matrix multiplication along.
+ */
+typedef enum {
+   HIPSPARSELT_SHARD_SPLIT_OUTPUT = 0, /**< the rows of a sparse A, the cols of a sparse B: each device computes its own rows or cols of D. */
+   HIPSPARSELT_SHARD_SPLIT_K      = 1, /**< k: the partial products of the devices are summed into the D of every device. */
+} hipsparseLtShardSplit_t;
+
 // clang-format on
 
 #ifdef __cplusplus
@@ -302,6 +425,24 @@ extern "C" {
 HIPSPARSELT_EXPORT
 void hipsparseLtInitialize();
 
+/*! \ingroup aux_module
+ *  \brief Initialize hipSPARSELt for several HIP devices
+ *
+ *  \details
+ *  \p hipsparseLtInitDevices performs the initialization of \ref hipsparseLtInitialize for every device whose bit is set in \p deviceMask,
+ *  bit i standing for HIP device i and 0 for all the visible devices. The devices are initialized concurrently,
+ *  the kernel library being loaded only once and shared by them.
+ *  Only work when using HIP backend.
+ *
+ *  @param[in]
+ *  deviceMask  the devices to initialize.
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the devices were initialized.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p deviceMask selects a device which does not exist.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtInitDevices(uint64_t deviceMask);
+
 /*! \ingroup library_module
  *  \brief Retrive the version number of the hipSPARSELt library.
  *
@@ -341,6 +482,55 @@ hipsparseStatus_t hipsparseLtGetGitRevision(hipsparseLtHandle_t handle, char* re
 HIPSPARSELT_EXPORT
 hipsparseStatus_t hipsparseLtGetArchName(char** archName);
 
+/*! \ingroup library_module
+ *  \brief Retrieve the statistics of the config cache of a handle.
+ *
+ *  \details
+ *  \p hipsparseLtGetConfigCacheStats returns the hits, misses and evictions of the cache
+ *  which lets the plans of identical problems share the algorithms found by
+ *  \ref hipsparseLtMatmulAlgSelectionInit and the one selected by \ref hipsparseLtMatmulSearch.
+ *  The capacity of the cache is set by the environment variable HIPSPARSELT_CONFIG_CACHE_SIZE
+ *  (256 problems by default, 0 disables the cache).
+ *
+ *  @param[in]
+ *  handle   hipsparselt library handle.
+ *  @param[out]
+ *  stats    statistics of the cache.
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS
+ *  \retval HIPSPARSE_STATUS_NOT_INITIALIZED \p handle is invalid.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p stats is invalid.
+ *  \retval HIPSPARSE_STATUS_NOT_SUPPORTED the backend has no config cache.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtGetConfigCacheStats(const hipsparseLtHandle_t*     handle,
+                                                 hipsparseLtConfigCacheStats_t* stats);
+
+/*! \ingroup library_module
+ *  \brief Retrieve the statistics of the code objects loaded on the device of a handle.
+ *
+ *  \details
+ *  \p hipsparseLtGetCodeObjectStats returns the bytes of the code objects of the kernels
+ *  loaded for all the handles of the device of \p handle, which are kept for the process
+ *  lifetime by default. The environment variable HIPSPARSELT_CODE_OBJECT_CACHE_SIZE sets
+ *  their capacity in MiB: the least recently used code objects of the kernels of no live plan
+ *  are unloaded to stay under it, once the kernels launched from them complete, and loaded
+ *  again on their next use. It is best combined with HIPSPARSELT_LAZY_LOADING.
+ *
+ *  @param[in]
+ *  handle   hipsparselt library handle.
+ *  @param[out]
+ *  stats    statistics of the code objects.
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS
+ *  \retval HIPSPARSE_STATUS_NOT_INITIALIZED \p handle is invalid.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p stats is invalid.
+ *  \retval HIPSPARSE_STATUS_NOT_SUPPORTED the backend loads its code objects itself.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtGetCodeObjectStats(const hipsparseLtHandle_t*    handle,
+                                                hipsparseLtCodeObjectStats_t* stats);
+
 /*! \ingroup library_module
  *  \brief Create a hipsparselt handle
  *
@@ -382,6 +572,10 @@ hipsparseStatus_t hipsparseLtDestroy(const hipsparseLtHandle_t* handle);
  *  \details
  *  \p hipsparseLtDenseDescriptorInit creates a matrix descriptor It initializes
  *  It should be destroyed at the end using \ref hipsparseLtMatDescriptorDestroy().
+ *  The rows and the cols must be a multiple of 8, of 16 for the 8-bit types, unless the
+ *  environment variable HIPSPARSELT_PAD_SHAPES is set to 1: the plans of a matmul of other
+ *  sizes then run its problem padded with zeros, see \ref hipsparseLtMatmulGetWorkspace().
+ *  Only the functions taking a plan and the prune functions pad.
  *
  *  @param[in]
  *  handle     the hipsparselt handle
@@ -419,6 +613,10 @@ hipsparseStatus_t hipsparseLtDenseDescriptorInit(const hipsparseLtHandle_t*  han
  *  \details
  *  \p hipsparseLtStructuredDescriptorInit creates a matrix descriptor It initializes
  *  It should be destroyed at the end using \ref hipsparseLtMatDescriptorDestroy().
+ *  The rows and the cols must be a multiple of 8, of 16 for the 8-bit types, unless the
+ *  environment variable HIPSPARSELT_PAD_SHAPES is set to 1: the plans of a matmul of other
+ *  sizes then run its problem padded with zeros, see \ref hipsparseLtMatmulGetWorkspace().
+ *  Only the functions taking a plan and the prune functions pad.
  *
  *  @param[in]
  *  handle     the hipsparselt handle
@@ -435,7 +633,7 @@ hipsparseStatus_t hipsparseLtDenseDescriptorInit(const hipsparseLtHandle_t*  han
  *  @param[in]
  *  valueType  data type of the matrix. see \ref hipsparseLtDatatype_t
  *  @param[in]
- *  order      memory layout. \p HIPSPARSE_ORDER_COL or \p HIPSPARSE_ORDER_ROW. (HIP backend only support HIPSPARSE_ORDER_COL.)
+ *  order      memory layout. \p HIPSPARSE_ORDER_COL or \p HIPSPARSE_ORDER_ROW. (HIP backend: the ld of \p HIPSPARSE_ORDER_ROW strides the rows, the prune, the compress and the decompress read and write the dense matrix in its order and the compressed matrix has the layout of the matmul either way.)
 
  *  @param[in]
  *  sparsity   matrix sparsity ratio. see \ref hipsparseLtSparsity_t
@@ -534,6 +732,17 @@ hipsparseStatus_t hipsparseLtMatDescGetAttribute(const hipsparseLtHandle_t*
  *  \details
  *  \p hipsparseLtMatmulDescriptorInit creates a matrix multiplication descriptor.
  *
+ *  With the HIP backend, a structured \p HIPSPARSELT_R_8I matrix can multiply a dense
+ *  \p HIPSPARSELT_R_16F or \p HIPSPARSELT_R_16BF matrix, with C and D of the type of the
+ *  dense matrix and \p HIPSPARSELT_COMPUTE_32F. The compressed matrix stays int8, the first
+ *  matmul of a plan widens its values into a device copy the plan keeps for its next matmuls
+ *  of the same compressed matrix, and runs the kernels of the type of the dense matrix. It saves
+ *  the storage of the weights, not device memory. The copy is widened again after any function
+ *  of the library wrote a compressed matrix. A compressed matrix changed by a copy of the caller
+ *  is only seen by a new plan.
+ *  The per row scales of the int8 values are the alpha vector of
+ *  \p HIPSPARSELT_MATMUL_ALPHA_VECTOR_SCALING.
+ *
  *  @param[in]
  *  handle          the hipsparselt handle
  *  @param[inout]
@@ -634,6 +843,12 @@ hipsparseStatus_t
  *  \details
  *  \p hipsparseLtMatmulAlgSelectionInit creates a algorithm selection descriptor.
  *
+ *  \note
+ *  Without Tensile, the code objects of all the algorithms of the problem type are loaded by
+ *  the first call, in parallel. Setting the environment variable HIPSPARSELT_LAZY_LOADING to 1
+ *  defers the loading of each one to its first use but the first HIPSPARSELT_PREFETCH_KERNELS
+ *  (0 by default).
+ *
  *  @param[in]
  *  handle           the hipsparselt handle
  *  @param[out]
@@ -720,6 +935,28 @@ hipsparseStatus_t
  *  \p hipsparseLtMatmulGetWorkspace determines the required workspace size
  *  associated to the selected algorithm.
  *
+ *  \note
+ *  When the environment variable HIPSPARSELT_WORKSPACE_POOL_SIZE sets a size in bytes, the
+ *  handle owns a stream-ordered pool of that size, and the matrix multiplications given a
+ *  NULL workspace draw it from the pool, allocated and freed on their stream. A workspace
+ *  larger than the pool must still be passed, and a matrix multiplication captured into a
+ *  graph needs its workspace as well. \ref hipsparseLtMatmulSearch and
+ *  \ref hipsparseLtMatmulSearchAsync given a NULL workspace also time the configs needing
+ *  up to the size of the pool, query the workspace size again after a search (HIP backend
+ *  only).
+ *
+ *  \note
+ *  A plan padding its matmul with HIPSPARSELT_PAD_SHAPES (see
+ *  \ref hipsparseLtDenseDescriptorInit) copies the dense input and C to their padded matrices in
+ *  the workspace, its matmul writes the padded D there and copies it back to D. The workspace
+ *  size includes them, after the workspace of any config of the plan. Its compressed matrix
+ *  is the one of the padded problem, written by \ref hipsparseLtSpMMACompress() through the
+ *  compress buffer. The background search, the dynamic N, the graph replay, the pointer
+ *  arrays, the serialization and the updates, decompression, files and int4 packing of the
+ *  compressed matrix do not support a padded plan, nor do its bias, vector scaling, amax(D),
+ *  residual and gate. The compress and mask functions given descriptors only need the
+ *  supported sizes (HIP backend only).
+ *
  *  @param[in]
  *  handle           hipsparselt library handle
  *  @param[in]
@@ -759,6 +996,78 @@ hipsparseStatus_t hipsparseLtMatmulPlanInit(const hipsparseLtHandle_t*
                                             const hipsparseLtMatmulDescriptor_t*   matmulDescr,
                                             const hipsparseLtMatmulAlgSelection_t* algSelection);
 
+/*! \ingroup matmul_module
+ *  \brief Initializes the algorithm selection and the plan in the background
+ *  \details
+ *  \p hipsparseLtMatmulPlanInitAsync runs \ref hipsparseLtMatmulAlgSelectionInit and
+ *  \ref hipsparseLtMatmulPlanInit for \p matmulDescr on a thread of the handle, and loads the code
+ *  objects of the selected algorithm, but returns immediately. The initializations of many plans run
+ *  concurrently, on up to HIPSPARSELT_INIT_THREADS threads (the hardware threads by default).
+ *  \ref hipsparseLtMatmulPlanInitWait waits for the plan and \ref hipsparseLtMatmulPlanInitQuery
+ *  polls it. The CUDA backend initializes the plan before returning.
+ *
+ *  \note
+ *  \p matmulDescr is copied before the function returns. \p algSelection must not be used before
+ *  the plan is ready. The functions given \p plan, \ref hipsparseLtMatmul included, wait for it;
+ *  they return HIPSPARSE_STATUS_INVALID_VALUE when its initialization failed.
+ *
+ *  @param[in]
+ *  handle           hipsparselt library handle
+ *  @param[out]
+ *  plan             the matrix multiplication plan descriptor
+ *  algSelection     the algorithm selection descriptor
+ *  @param[in]
+ *  matmulDescr      the matrix multiplication descriptor
+ *  alg              the algorithm used to do the matrix multiplication.
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the initialization was started successfully.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p algSelection or \p matmulDescr is invalid, or an initialization of \p plan is already running.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulPlanInitAsync(const hipsparseLtHandle_t*           handle,
+                                                 hipsparseLtMatmulPlan_t*             plan,
+                                                 hipsparseLtMatmulAlgSelection_t*     algSelection,
+                                                 const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                                 hipsparseLtMatmulAlg_t               alg);
+
+/*! \ingroup matmul_module
+ *  \brief Wait for the background initialization of a plan
+ *  \details
+ *  \p hipsparseLtMatmulPlanInitWait blocks until the initialization started by
+ *  \ref hipsparseLtMatmulPlanInitAsync for \p plan completes, and returns its status.
+ *
+ *  @param[in]
+ *  handle      hipsparselt library handle
+ *  plan        the matrix multiplication plan descriptor
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the plan was not initialized in the background or its initialization completed successfully.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p handle or \p plan is invalid.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulPlanInitWait(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan);
+
+/*! \ingroup matmul_module
+ *  \brief Poll the background initialization of a plan
+ *  \details
+ *  \p hipsparseLtMatmulPlanInitQuery sets \p ready to 1 when the initialization started by
+ *  \ref hipsparseLtMatmulPlanInitAsync for \p plan completed, \ref hipsparseLtMatmulPlanInitWait
+ *  then returns its status at once, and to 0 while it runs.
+ *
+ *  @param[in]
+ *  handle      hipsparselt library handle
+ *  plan        the matrix multiplication plan descriptor
+ *  @param[out]
+ *  ready       1 when the plan is ready, 0 otherwise
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan or \p ready is invalid.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulPlanInitQuery(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 int*                           ready);
+
 /*! \ingroup matmul_module
  *  \brief Destroy a matrix multiplication plan descriptor
  *  \details
@@ -775,6 +1084,100 @@ hipsparseStatus_t hipsparseLtMatmulPlanInit(const hipsparseLtHandle_t*
 HIPSPARSELT_EXPORT
 hipsparseStatus_t hipsparseLtMatmulPlanDestroy(const hipsparseLtMatmulPlan_t* plan);
 
+/*! \ingroup matmul_module
+ *  \brief Serialize a matrix multiplication plan
+ *  \details
+ *  \p hipsparseLtMatmulPlanSerialize writes the problem of \p plan, the configs of its algorithm
+ *  selection, the selected config and the name of its kernel to \p data, after a header which
+ *  records the version of the library and the architecture of the device. A later process restores
+ *  the plan with \ref hipsparseLtMatmulPlanDeserialize, without searching the library again.
+ *  When \p data is NULL, only the size of the serialized plan is returned in \p dataSize.
+ *
+ *  @param[in]
+ *  handle       hipsparselt library handle
+ *  @param[in]
+ *  plan         the matrix multiplication plan descriptor
+ *  @param[out]
+ *  data         the serialized plan, or NULL
+ *  @param[inout]
+ *  dataSize     the size of \p data in bytes, set to the size of the serialized plan
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan or \p dataSize is invalid, or \p dataSize is smaller than the serialized plan.
+ *  \retval HIPSPARSE_STATUS_NOT_SUPPORTED the backend does not support it.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulPlanSerialize(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 void*                          data,
+                                                 size_t*                        dataSize);
+
+/*! \ingroup matmul_module
+ *  \brief Initializes a matrix multiplication plan from a serialized plan
+ *  \details
+ *  \p hipsparseLtMatmulPlanDeserialize initializes \p algSelection with the configs saved by
+ *  \ref hipsparseLtMatmulPlanSerialize and then \p plan, as \ref hipsparseLtMatmulAlgSelectionInit
+ *  and \ref hipsparseLtMatmulPlanInit do, but without looking the configs up in the library. Only the
+ *  code object of the selected kernel is loaded.
+ *  The pointers set in a matrix multiplication descriptor are only valid in the process which set them,
+ *  so \p matmulDescr is built by the caller and must describe the problem of the serialized plan.
+ *  The plan must have been serialized by the same version of the library, on the same architecture.
+ *  Both \p plan and \p algSelection should be destroyed at the end.
+ *
+ *  @param[in]
+ *  handle       hipsparselt library handle
+ *  @param[out]
+ *  plan         the matrix multiplication plan descriptor
+ *  @param[in]
+ *  matmulDescr  the matrix multiplication descriptor
+ *  @param[out]
+ *  algSelection the algorithm selection descriptor
+ *  @param[in]
+ *  data         the serialized plan
+ *  @param[in]
+ *  dataSize     the size of \p data in bytes
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p matmulDescr , \p algSelection or \p data is invalid, \p data is not a serialized plan of \p matmulDescr, or was serialized by another version of the library or on another architecture.
+ *  \retval HIPSPARSE_STATUS_NOT_SUPPORTED \p data has a newer version, or the backend does not support it.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t
+    hipsparseLtMatmulPlanDeserialize(const hipsparseLtHandle_t*           handle,
+                                     hipsparseLtMatmulPlan_t*             plan,
+                                     const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                     hipsparseLtMatmulAlgSelection_t*     algSelection,
+                                     const void*                          data,
+                                     size_t                               dataSize);
+
+/*! \ingroup matmul_module
+ *  \brief Retrieve the counters of the matrix multiplications of a plan
+ *  \details
+ *  \p hipsparseLtMatmulPlanGetStats returns the number of matrix multiplications run with
+ *  \p plan, their host time and workspace, the GPU time of the sampled ones and the kernel of the
+ *  selected algorithm, to be exported to a metrics system without a profiler.
+ *  The counters are only kept when the environment variable HIPSPARSELT_PLAN_STATS sets a sampling
+ *  rate N when the plan is initialized: one call in N is then timed on streams[0] by a pair of
+ *  pooled events, which are read once they completed, so the sampling never synchronizes a stream.
+ *  The calls still running are counted by a later call to this function.
+ *
+ *  @param[in]
+ *  handle       hipsparselt library handle
+ *  @param[in]
+ *  plan         the matrix multiplication plan descriptor
+ *  @param[out]
+ *  stats        the counters of \p plan
+ *
+ *  \retval HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or \p plan is invalid.
+ *  \retval HIPSPARSE_STATUS_INVALID_VALUE \p stats is invalid.
+ *  \retval HIPSPARSE_STATUS_NOT_SUPPORTED HIPSPARSELT_PLAN_STATS was not set when \p plan was initialized, always on the CUDA backend.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulPlanGetStats(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan,
+                                                hipsparseLtMatmulPlanStats_t*  stats);
+
 /* matmul execution */
 /*! \ingroup matmul_module
  *  \brief Sparse matrix dense matrix multiplication
@@ -810,7 +1213,8 @@ hipsparseStatus_t hipsparseLtMatmulPlanDestroy(const hipsparseLtMatmulPlan_t* pl
  *  @param[out]
  *  d_D         Pointer to the dense matrix D
  *  @param[in]
- *  workspace   Pointor to the worksapce
+ *  workspace   Pointor to the worksapce, can be NULL with a workspace pool, see
+ *              \ref hipsparseLtMatmulGetWorkspace
  *  @param[in]
  *  streams     Pointer to HIP stream array for the computation
  *  @param[in]
@@ -855,6 +1259,24 @@ hipsparseStatus_t hipsparseLtMatmul(const hipsparseLtHandle_t*     handle,
  *  \note
  *  The number of iterations for the evaluation can be set by using
  *  hipsparseLtMatmulAlgSetAttribute() with HIPSPARSELT_MATMUL_SEARCH_ITERATIONS.
+ *  They make a budget of timed runs per algorithm which is spent in rounds of
+ *  successive halving: the clearly slower algorithms are dropped after a few runs and
+ *  the remaining runs go to the close contenders.
+ *
+ *  \note
+ *  The inputs stay in L2 and MALL between the timed runs, set
+ *  HIPSPARSELT_MATMUL_SEARCH_FLUSH_CACHE to 1 to time them cold like weights in production.
+ *
+ *  \note
+ *  The timings of the fastest algorithms can be retrieved with
+ *  hipsparseLtMatmulAlgGetAttribute() and HIPSPARSELT_MATMUL_SEARCH_RESULTS.
+ *
+ *  \note
+ *  With HIPSPARSELT_MATMUL_SEARCH_DENSE set to 1, the search also times a dense path which
+ *  multiplies the compressed matrix without the sparse instructions. When it is faster than
+ *  the best algorithm, hipsparseLtMatmul() runs it instead, HIPSPARSELT_MATMUL_DENSE_SELECTED
+ *  then reads 1. The dense path does not support the activations, the bias, the vector
+ *  scaling and the scale, saturation and amax of D.
  *
  *  \note
  *	The selected algorithm id can be retrieved by using
@@ -901,276 +1323,1853 @@ hipsparseStatus_t hipsparseLtMatmulSearch(const hipsparseLtHandle_t* handle,
                                           hipStream_t*               streams,
                                           int32_t                    numStreams);
 
-/* helper */
-// prune
-/*! \ingroup helper_module
- *  \brief Purnes a dense matrix.
+/*! \ingroup matmul_module
+ *  \brief Start a background search of the fastest algorithm
  *
  *  \details
- *  \p hipsparseLtSpMMAPrune prunes a dense matrix d_in according to the specified
- *  algorithm pruneAlg, HIPSPARSELT_PRUNE_SPMMA_TILE or HIPSPARSELT_PRUNE_SPMMA_STRIP.
+ *  \p hipsparseLtMatmulSearchAsync behaves as \ref hipsparseLtMatmulSearch, but returns
+ *  immediately. The search runs on a private stream and workspace, and the selected algorithm
+ *  of the \p plan is replaced atomically by the fastest one when it ends. Until then
+ *  \ref hipsparseLtMatmul keeps using the current algorithm.
  *
  *  \note
- *	The function requires no extra storage.
+ *  \p d_A, \p d_B and \p d_C are copied once the work already queued on \p stream is done,
+ *  they can be overwritten afterwards.
  *
  *  \note
- *  This function supports asynchronous execution with respect to stream.
+ *  Only the algorithms fitting in the workspace of the current algorithm are evaluated.
+ *
+ *  \note
+ *  \p handle must stay valid until the search completes. \ref hipsparseLtMatmulPlanDestroy
+ *  waits for it.
  *
  *  @param[in]
  *  handle      hipsparselt library handle
  *  @param[in]
- *  matmulDescr matrix multiplication descriptor.
+ *  plan        Matrix multiplication plan
  *  @param[in]
- *  d_in        pointer to the dense matrix.
- *  @param[out]
- *  d_out       pointer to the pruned matrix.
+ *  alpha       scalar \f$\alpha\f$. (float)
  *  @param[in]
- *  pruneAlg    pruning algorithm.
+ *  d_A         Pointer to the structured matrix A
  *  @param[in]
- *  stream      HIP stream for the computation.
+ *  d_B         Pointer to the dense matrix B
+ *  @param[in]
+ *  beta        scalar \f$\beta\f$. (float)
+ *  @param[in]
+ *  d_C         Pointer to the dense matrix C
+ *  @param[in]
+ *  stream      HIP stream the inputs are ready on
  *
- *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
- *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p matmulDescr , \p d_in or \p d_out is invalid.
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the search was started successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or \p plan is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p alpha, \p d_A, \p d_B, \p beta or \p d_C is
+ *              invalid, or a search of \p plan is already running.
+ *  \retval     HIPSPARSE_STATUS_ALLOC_FAILED the copies of the inputs cannot be allocated.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the operation is not supported by the backend.
  */
 HIPSPARSELT_EXPORT
-hipsparseStatus_t hipsparseLtSpMMAPrune(const hipsparseLtHandle_t*           handle,
-                                        const hipsparseLtMatmulDescriptor_t* matmulDescr,
-                                        const void*                          d_in,
-                                        void*                                d_out,
-                                        hipsparseLtPruneAlg_t                pruneAlg,
-                                        hipStream_t                          stream);
+hipsparseStatus_t hipsparseLtMatmulSearchAsync(const hipsparseLtHandle_t* handle,
+                                               hipsparseLtMatmulPlan_t*   plan,
+                                               const void*                alpha,
+                                               const void*                d_A,
+                                               const void*                d_B,
+                                               const void*                beta,
+                                               const void*                d_C,
+                                               hipStream_t                stream);
 
-/*! \ingroup helper_module
- *  \brief checks the correctness of the pruning structure for a given matrix.
+/*! \ingroup matmul_module
+ *  \brief Wait for the background search of the fastest algorithm
  *
  *  \details
- *  \p hipsparseLtSpMMAPruneCheck checks the correctness of the pruning structure for a given matrix.
- *  Contents in the given matrix must be sparsity 2:4.
- *
+ *  \p hipsparseLtMatmulSearchWait blocks until the search started by
+ *  \ref hipsparseLtMatmulSearchAsync for \p plan completes, and returns its status.
  *
  *  @param[in]
  *  handle      hipsparselt library handle
  *  @param[in]
- *  matmulDescr matrix multiplication descriptor.
- *  @param[in]
- *  d_in        pointer to the matrix to check.
- *  @param[out]
- *  d_valid     validation results (0 correct, 1 wrong).
- *  @param[in]
- *  stream      HIP stream for the computation.
+ *  plan        Matrix multiplication plan
  *
- *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
- *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p matmulDescr , \p d_in or \p d_valid is invalid.
+ *  \retval     HIPSPARSE_STATUS_SUCCESS no search is pending or it completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or \p plan is invalid.
  */
 HIPSPARSELT_EXPORT
-hipsparseStatus_t hipsparseLtSpMMAPruneCheck(const hipsparseLtHandle_t*           handle,
-                                             const hipsparseLtMatmulDescriptor_t* matmulDescr,
-                                             const void*                          d_in,
-                                             int*                                 d_valid,
-                                             hipStream_t                          stream);
+hipsparseStatus_t hipsparseLtMatmulSearchWait(const hipsparseLtHandle_t* handle,
+                                              hipsparseLtMatmulPlan_t*   plan);
 
-/*! \ingroup helper_module
- *  \brief Purnes a dense matrix.
+/*! \ingroup matmul_module
+ *  \brief Capture a sparse matrix dense matrix multiplication into a HIP graph
  *
  *  \details
- *  \p hipsparseLtSpMMAPrune2 prunes a dense matrix d_in according to the specified
- *  algorithm pruneAlg, HIPSPARSELT_PRUNE_SPMMA_TILE or HIPSPARSELT_PRUNE_SPMMA_STRIP.
+ *  \p hipsparseLtMatmulPlanGetGraph records the kernels that \ref hipsparseLtMatmul would
+ *  launch for \p plan on \p stream into a new HIP graph, without executing them.
+ *  The graph can then be instantiated with hipGraphInstantiate() and replayed with
+ *  \ref hipsparseLtMatmulGraphLaunch, which removes the per-kernel launch cost of
+ *  repeating the same matrix multiplication.
  *
  *  \note
- *	The function requires no extra storage.
+ *  The caller owns the returned graph and must release it with hipGraphDestroy().
  *
  *  \note
- *  This function supports asynchronous execution with respect to stream.
+ *  \p stream must not be the null stream and must not be capturing already.
  *
  *  @param[in]
- *  handle         hipsparselt library handle
+ *  handle      hipsparselt library handle
  *  @param[in]
- *  sparseMatDescr structured(sparse) matrix descriptor.
+ *  plan        Matrix multiplication plan
  *  @param[in]
- *  isSparseA      specify if the structured (sparse) matrix is in the first position (matA or matB) (Currently, only support matA)
+ *  alpha       scalar \f$\alpha\f$. (float)
  *  @param[in]
- *  op             operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  d_A         Pointer to the structured matrix A
  *  @param[in]
- *  d_in           pointer to the dense matrix.
- *  @param[out]
- *  d_out          pointer to the pruned matrix.
+ *  d_B         Pointer to the dense matrix B
  *  @param[in]
- *  pruneAlg       pruning algorithm.
+ *  beta        scalar \f$\beta\f$. (float)
  *  @param[in]
- *  stream         HIP stream for the computation.
+ *  d_C         Pointer to the dense matrix C
+ *  @param[in]
+ *  d_D         Pointer to the dense matrix D
+ *  @param[in]
+ *  workspace   Pointor to the worksapce
+ *  @param[in]
+ *  stream      HIP stream used for the capture
+ *  @param[out]
+ *  graph       The captured HIP graph
  *
  *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
- *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p sparseMatDescr , \p op , \p d_in  or \p d_out is invalid.
- *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or \p plan is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p alpha, \p d_A, \p d_B, \p beta, \p d_C , \p d_D , \p workspace, \p stream or \p graph is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problme is not supported.
  */
 HIPSPARSELT_EXPORT
-hipsparseStatus_t hipsparseLtSpMMAPrune2(const hipsparseLtHandle_t*        handle,
-                                         const hipsparseLtMatDescriptor_t* sparseMatDescr,
-                                         int                               isSparseA,
-                                         hipsparseOperation_t              op,
+hipsparseStatus_t hipsparseLtMatmulPlanGetGraph(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan,
+                                                const void*                    alpha,
+                                                const void*                    d_A,
+                                                const void*                    d_B,
+                                                const void*                    beta,
+                                                const void*                    d_C,
+                                                void*                          d_D,
+                                                void*                          workspace,
+                                                hipStream_t                    stream,
+                                                hipGraph_t*                    graph);
+
+/*! \ingroup matmul_module
+ *  \brief Replay a sparse matrix dense matrix multiplication graph
+ *
+ *  \details
+ *  \p hipsparseLtMatmulGraphLaunch launches \p graphExec, instantiated from a graph returned
+ *  by \ref hipsparseLtMatmulPlanGetGraph for the same \p plan, on \p stream.
+ *  When the pointers, the scalars or the selected algorithm differ from the ones
+ *  \p graphExec was last launched with, only the kernel node parameters of \p graphExec
+ *  are updated (hipGraphExecUpdate()) before the launch.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *  It may return before the actual computation has finished.
+ *
+ *  \note
+ *  Launching graphs of the same plan from several threads at once is not supported.
+ *
+ *  @param[in]
+ *  handle      hipsparselt library handle
+ *  @param[in]
+ *  plan        Matrix multiplication plan
+ *  @param[in]
+ *  graphExec   Executable graph instantiated from the graph of \p plan
+ *  @param[in]
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  @param[in]
+ *  d_A         Pointer to the structured matrix A
+ *  @param[in]
+ *  d_B         Pointer to the dense matrix B
+ *  @param[in]
+ *  beta        scalar \f$\beta\f$. (float)
+ *  @param[in]
+ *  d_C         Pointer to the dense matrix C
+ *  @param[out]
+ *  d_D         Pointer to the dense matrix D
+ *  @param[in]
+ *  workspace   Pointor to the worksapce
+ *  @param[in]
+ *  stream      HIP stream for the computation
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or \p plan is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p graphExec, \p alpha, \p d_A, \p d_B, \p beta, \p d_C , \p d_D , \p workspace or \p stream is invalid, or \p graphExec can not be updated.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problme is not supported.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulGraphLaunch(const hipsparseLtHandle_t* handle,
+                                               hipsparseLtMatmulPlan_t*   plan,
+                                               hipGraphExec_t             graphExec,
+                                               const void*                alpha,
+                                               const void*                d_A,
+                                               const void*                d_B,
+                                               const void*                beta,
+                                               const void*                d_C,
+                                               void*                      d_D,
+                                               void*                      workspace,
+                                               hipStream_t                stream);
+
+/*! \ingroup matmul_module
+ *  \brief Grouped sparse matrix dense matrix multiplication
+ *
+ *  \details
+ *  \p hipsparseLtMatmulGrouped runs \p groupCount independent matrix multiplications, one
+ *  per plan of \p plans, with a single call. The plans may describe different shapes, for
+ *  example the experts of a mixture-of-experts layer that only differ in N.
+ *  All the groups are validated before any of them is launched. The groups are distributed
+ *  over \p streams, the largest ones first, each on the least loaded stream, and the other
+ *  streams are joined back to streams[0] before the function returns.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *  It may return before the actual computation has finished.
+ *
+ *  \note
+ *  Each group is launched with the kernels of its own plan, the groups therefore run
+ *  concurrently only when more than one stream is given.
+ *
+ *  @param[in]
+ *  handle      hipsparselt library handle
+ *  @param[in]
+ *  plans       Array of \p groupCount matrix multiplication plans
+ *  @param[in]
+ *  groupCount  Number of groups
+ *  @param[in]
+ *  alpha       scalar \f$\alpha\f$ of all the groups. (float)
+ *  @param[in]
+ *  d_A         Array of \p groupCount pointers to the matrices A
+ *  @param[in]
+ *  d_B         Array of \p groupCount pointers to the matrices B
+ *  @param[in]
+ *  beta        scalar \f$\beta\f$ of all the groups. (float)
+ *  @param[in]
+ *  d_C         Array of \p groupCount pointers to the dense matrices C
+ *  @param[out]
+ *  d_D         Array of \p groupCount pointers to the dense matrices D
+ *  @param[in]
+ *  workspaces  Array of \p groupCount pointers to the workspaces, can be NULL when no plan needs a workspace
+ *  @param[in]
+ *  streams     Pointer to HIP stream array for the computation
+ *  @param[in]
+ *  numStreams  Number of HIP streams in \p streams
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or one of \p plans is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p plans, \p groupCount, \p alpha, \p d_A, \p d_B, \p beta, \p d_C , \p d_D , \p workspaces \p streams or \p numStreams is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problme is not supported.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulGrouped(const hipsparseLtHandle_t*            handle,
+                                           const hipsparseLtMatmulPlan_t* const* plans,
+                                           int32_t                               groupCount,
+                                           const void*                           alpha,
+                                           const void* const*                    d_A,
+                                           const void* const*                    d_B,
+                                           const void*                           beta,
+                                           const void* const*                    d_C,
+                                           void* const*                          d_D,
+                                           void* const*                          workspaces,
+                                           hipStream_t*                          streams,
+                                           int32_t                               numStreams);
+
+/*! \ingroup matmul_module
+ *  \brief Provide the workspaces of a sharded matrix multiplication
+ *
+ *  \details
+ *  \p hipsparseLtMatmulShardedGetWorkspace provides the size of the workspace of every shard of
+ *  the \ref hipsparseLtMatmulSharded() of \p plans. The workspace of a shard is the one of its
+ *  plan, split along k the workspace of the first shard also receives the partial products of
+ *  the other shards before they are summed.
+ *
+ *  @param[in]
+ *  handles         Array of \p numShards handles, one per shard.
+ *  @param[in]
+ *  plans           Array of \p numShards matrix multiplication plans, plans[i] created with handles[i].
+ *  @param[in]
+ *  numShards       Number of shards.
+ *  @param[in]
+ *  split           dimension the matrix multiplication is split along.
+ *  @param[out]
+ *  workspaceSizes  Array of \p numShards sizes in bytes of the workspaces.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handles , \p plans , \p numShards or \p workspaceSizes is invalid,
+ *              or the shapes of the shards do not make a matrix multiplication split along \p split.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not supported.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t
+    hipsparseLtMatmulShardedGetWorkspace(const hipsparseLtHandle_t* const*     handles,
+                                         const hipsparseLtMatmulPlan_t* const* plans,
+                                         int32_t                               numShards,
+                                         hipsparseLtShardSplit_t               split,
+                                         size_t*                               workspaceSizes);
+
+/*! \ingroup matmul_module
+ *  \brief Tensor-parallel sparse matrix dense matrix multiplication over several devices
+ *
+ *  \details
+ *  \p hipsparseLtMatmulSharded runs a matrix multiplication whose sparse matrix is sharded over
+ *  the devices of \p handles, with a single call. Shard i runs the matmul of plans[i] on the
+ *  device of handles[i] and streams[i], the shards run concurrently.
+ *  - \ref HIPSPARSELT_SHARD_SPLIT_OUTPUT splits the rows of a sparse A, or the cols of a sparse B.
+ *    The shards share k and the other dimension, each one computes its own rows or cols of D,
+ *    nothing is exchanged between the devices.
+ *  - \ref HIPSPARSELT_SHARD_SPLIT_K splits k. The shards share m and n and the layout of D. The
+ *    partial product of every other shard is copied into the workspace of the first shard as
+ *    soon as it is done, and summed into d_D[0] while the other shards still run, only the first
+ *    shard adds \f$\beta C\f$. The sum is then copied to d_D[i] of every other shard.
+ *
+ *  The shards are validated before any of them is launched. A shard may share the device of
+ *  another one.
+ *
+ *  \note
+ *  Split along k, D is of type HIPSPARSELT_R_16F, HIPSPARSELT_R_16BF or HIPSPARSELT_R_32F,
+ *  the shards have no activation, gate, amax(D), scale of D nor vector \f$\beta\f$, and only the
+ *  first shard may add a bias or a residual.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *  streams[i] is done with the shard i when its D holds the result. The current device is
+ *  restored before the function returns.
+ *
+ *  @param[in]
+ *  handles     Array of \p numShards handles, one per shard.
+ *  @param[in]
+ *  plans       Array of \p numShards matrix multiplication plans, plans[i] created with handles[i].
+ *  @param[in]
+ *  numShards   Number of shards.
+ *  @param[in]
+ *  split       dimension the matrix multiplication is split along.
+ *  @param[in]
+ *  alpha       scalar \f$\alpha\f$ of all the shards. (float)
+ *  @param[in]
+ *  d_A         Array of \p numShards pointers to the matrices A, on the devices of their handles.
+ *  @param[in]
+ *  d_B         Array of \p numShards pointers to the matrices B, on the devices of their handles.
+ *  @param[in]
+ *  beta        scalar \f$\beta\f$ of all the shards. (float)
+ *  @param[in]
+ *  d_C         Array of \p numShards pointers to the dense matrices C, on the devices of their handles.
+ *  @param[out]
+ *  d_D         Array of \p numShards pointers to the dense matrices D, on the devices of their handles.
+ *  @param[in]
+ *  workspaces  Array of \p numShards pointers to the workspaces of the sizes given by
+ *              \ref hipsparseLtMatmulShardedGetWorkspace(), can be NULL when no shard needs one.
+ *  @param[in]
+ *  streams     Array of \p numShards HIP streams, streams[i] on the device of handles[i].
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED one of \p handles or \p plans is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p numShards , \p alpha , \p d_A , \p d_B , \p beta , \p d_C , \p d_D , \p workspaces or \p streams is invalid,
+ *              or the shapes of the shards do not make a matrix multiplication split along \p split.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not supported.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulSharded(const hipsparseLtHandle_t* const*     handles,
+                                           const hipsparseLtMatmulPlan_t* const* plans,
+                                           int32_t                               numShards,
+                                           hipsparseLtShardSplit_t               split,
+                                           const void*                           alpha,
+                                           const void* const*                    d_A,
+                                           const void* const*                    d_B,
+                                           const void*                           beta,
+                                           const void* const*                    d_C,
+                                           void* const*                          d_D,
+                                           void* const*                          workspaces,
+                                           hipStream_t*                          streams);
+
+/*! \ingroup matmul_module
+ *  \brief Pointer-array batched sparse matrix dense matrix multiplication
+ *
+ *  \details
+ *  \p hipsparseLtMatmulPointerArray computes the batched matrix multiplication of \p plan
+ *  like \ref hipsparseLtMatmul, except that every batch of the dense matrices has its own
+ *  pointer. Scattered batches, for example the paged KV cache or the activations of the
+ *  requests of a batch, are then multiplied without first gathering them into one
+ *  allocation at a fixed stride.
+ *  The compressed matrix keeps the batch stride of its descriptor, the batch strides of
+ *  the dense matrices are ignored.
+ *
+ *  \note
+ *  The arrays are host arrays of \ref HIPSPARSELT_MAT_NUM_BATCHES device pointers each.
+ *
+ *  \note
+ *  Each batch is launched as its own matrix multiplication. The batches are distributed
+ *  over \p streams, unless the selected algorithm needs a workspace, and the other
+ *  streams are joined back to streams[0] before the function returns.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *  It may return before the actual computation has finished.
+ *
+ *  @param[in]
+ *  handle       hipsparselt library handle
+ *  @param[in]
+ *  plan         Matrix multiplication plan
+ *  @param[in]
+ *  alpha        scalar \f$\alpha\f$. (float)
+ *  @param[in]
+ *  d_compressed Pointer to the compressed structured matrix, A or B
+ *  @param[in]
+ *  d_dense      Array of pointers to the batches of the dense matrix, B or A
+ *  @param[in]
+ *  beta         scalar \f$\beta\f$. (float)
+ *  @param[in]
+ *  d_C          Array of pointers to the batches of the dense matrix C
+ *  @param[out]
+ *  d_D          Array of pointers to the batches of the dense matrix D
+ *  @param[in]
+ *  workspace    Pointor to the worksapce
+ *  @param[in]
+ *  streams      Pointer to HIP stream array for the computation
+ *  @param[in]
+ *  numStreams   Number of HIP streams in \p streams
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or \p plan is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p alpha, \p d_compressed, \p d_dense, \p beta, \p d_C , \p d_D , one of their pointers, \p workspace \p streams or \p numStreams is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problme is not supported, always on the CUDA backend.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulPointerArray(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan,
+                                                const void*                    alpha,
+                                                const void*                    d_compressed,
+                                                const void* const*             d_dense,
+                                                const void*                    beta,
+                                                const void* const*             d_C,
+                                                void* const*                   d_D,
+                                                void*                          workspace,
+                                                hipStream_t*                   streams,
+                                                int32_t                        numStreams);
+
+/*! \ingroup matmul_module
+ *  \brief Sparse matrix dense matrix multiplication with a runtime N
+ *
+ *  \details
+ *  \p hipsparseLtMatmulDynamicN computes the matrix multiplication of \p plan like
+ *  \ref hipsparseLtMatmul, for the first \p n columns of B, C and D only. One plan, one
+ *  compressed A and one allocation of B, C and D sized for the largest N then serve the
+ *  N which changes every call, for example the number of tokens of a decoding step.
+ *  The leading dimensions and the batch strides of the plan are kept.
+ *
+ *  The configs are selected per bucket of \p n: \p n is rounded up to a power of two,
+ *  and the first call of a bucket selects its configs like
+ *  \ref hipsparseLtMatmulAlgSelectionInit for that N, from the tuning database when there
+ *  is one. The configs are restricted to the workspace of the plan, see
+ *  \ref hipsparseLtMatmulGetWorkspace, so that workspace serves every \p n.
+ *  When \p n is the N of the plan, the selected config of the plan is run.
+ *
+ *  \note
+ *  Only supported when A is the structured matrix. The batch count of the plan is kept.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *  It may return before the actual computation has finished.
+ *
+ *  @param[in]
+ *  handle      hipsparselt library handle
+ *  @param[in]
+ *  plan        Matrix multiplication plan
+ *  @param[in]
+ *  n           Number of columns of B, C and D, from 1 to the N of the plan
+ *  @param[in]
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  @param[in]
+ *  d_A         Pointer to the compressed structured matrix A
+ *  @param[in]
+ *  d_B         Pointer to the dense matrix B
+ *  @param[in]
+ *  beta        scalar \f$\beta\f$. (float)
+ *  @param[in]
+ *  d_C         Pointer to the dense matrix C
+ *  @param[out]
+ *  d_D         Pointer to the dense matrix D
+ *  @param[in]
+ *  workspace   Pointor to the worksapce
+ *  @param[in]
+ *  streams     Pointer to HIP stream array for the computation
+ *  @param[in]
+ *  numStreams  Number of HIP streams in \p streams
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle or \p plan is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p n is not in [1, N of the plan], or \p alpha, \p d_A, \p d_B, \p beta, \p d_C , \p d_D , \p workspace \p streams or \p numStreams is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED B is the structured matrix, or the problme is not supported, always on the CUDA backend.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtMatmulDynamicN(const hipsparseLtHandle_t*     handle,
+                                            const hipsparseLtMatmulPlan_t* plan,
+                                            int64_t                        n,
+                                            const void*                    alpha,
+                                            const void*                    d_A,
+                                            const void*                    d_B,
+                                            const void*                    beta,
+                                            const void*                    d_C,
+                                            void*                          d_D,
+                                            void*                          workspace,
+                                            hipStream_t*                   streams,
+                                            int32_t                        numStreams);
+
+/* helper */
+// prune
+/*! \ingroup helper_module
+ *  \brief Purnes a dense matrix.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAPrune prunes a dense matrix d_in according to the specified
+ *  algorithm pruneAlg, HIPSPARSELT_PRUNE_SPMMA_TILE or HIPSPARSELT_PRUNE_SPMMA_STRIP.
+ *
+ *  \note
+ *	The function requires no extra storage.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *
+ *  @param[in]
+ *  handle      hipsparselt library handle
+ *  @param[in]
+ *  matmulDescr matrix multiplication descriptor.
+ *  @param[in]
+ *  d_in        pointer to the dense matrix.
+ *  @param[out]
+ *  d_out       pointer to the pruned matrix.
+ *  @param[in]
+ *  pruneAlg    pruning algorithm.
+ *  @param[in]
+ *  stream      HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p matmulDescr , \p d_in or \p d_out is invalid.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAPrune(const hipsparseLtHandle_t*           handle,
+                                        const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                        const void*                          d_in,
+                                        void*                                d_out,
+                                        hipsparseLtPruneAlg_t                pruneAlg,
+                                        hipStream_t                          stream);
+
+/*! \ingroup helper_module
+ *  \brief checks the correctness of the pruning structure for a given matrix.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAPruneCheck checks the correctness of the pruning structure for a given matrix.
+ *  Contents in the given matrix must be sparsity 2:4.
+ *
+ *
+ *  @param[in]
+ *  handle      hipsparselt library handle
+ *  @param[in]
+ *  matmulDescr matrix multiplication descriptor.
+ *  @param[in]
+ *  d_in        pointer to the matrix to check.
+ *  @param[out]
+ *  d_valid     validation results (0 correct, 1 wrong).
+ *  @param[in]
+ *  stream      HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p matmulDescr , \p d_in or \p d_valid is invalid.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAPruneCheck(const hipsparseLtHandle_t*           handle,
+                                             const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                             const void*                          d_in,
+                                             int*                                 d_valid,
+                                             hipStream_t                          stream);
+
+/*! \ingroup helper_module
+ *  \brief Purnes a dense matrix.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAPrune2 prunes a dense matrix d_in according to the specified
+ *  algorithm pruneAlg, HIPSPARSELT_PRUNE_SPMMA_TILE or HIPSPARSELT_PRUNE_SPMMA_STRIP.
+ *
+ *  \note
+ *	The function requires no extra storage.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *
+ *  @param[in]
+ *  handle         hipsparselt library handle
+ *  @param[in]
+ *  sparseMatDescr structured(sparse) matrix descriptor.
+ *  @param[in]
+ *  isSparseA      specify if the structured (sparse) matrix is in the first position (matA or matB) (Currently, only support matA)
+ *  @param[in]
+ *  op             operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  @param[in]
+ *  d_in           pointer to the dense matrix.
+ *  @param[out]
+ *  d_out          pointer to the pruned matrix.
+ *  @param[in]
+ *  pruneAlg       pruning algorithm.
+ *  @param[in]
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p sparseMatDescr , \p op , \p d_in  or \p d_out is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAPrune2(const hipsparseLtHandle_t*        handle,
+                                         const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                         int                               isSparseA,
+                                         hipsparseOperation_t              op,
                                          const void*                       d_in,
                                          void*                             d_out,
                                          hipsparseLtPruneAlg_t             pruneAlg,
                                          hipStream_t                       stream);
 
 /*! \ingroup helper_module
- *  \brief checks the correctness of the pruning structure for a given matrix.
+ *  \brief checks the correctness of the pruning structure for a given matrix.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAPruneCheck2 checks the correctness of the pruning structure for a given matrix.
+ *  Contents in the given matrix must be sparsity 2:4.
+ *
+ *  @param[in]
+ *  handle         hipsparselt library handle
+ *  @param[in]
+ *  sparseMatDescr structured(sparse) matrix descriptor.
+ *  @param[in]
+ *  isSparseA      specify if the structured (sparse) matrix is in the first position (matA or matB) (HIP backend only support matA)
+ *  @param[in]
+ *  op             operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  @param[in]
+ *  d_in           pointer to the matrix to check.
+ *  @param[out]
+ *  d_valid        validation results (0 correct, 1 wrong).
+ *  @param[in]
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p sparseMatDescr , \p op , \p d_in or \p d_valid is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAPruneCheck2(const hipsparseLtHandle_t*        handle,
+                                              const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                              int                               isSparseA,
+                                              hipsparseOperation_t              op,
+                                              const void*                       d_in,
+                                              int*                              d_valid,
+                                              hipStream_t                       stream);
+
+/*! \ingroup helper_module
+ *  \brief counts the groups of a matrix which break the 2:4 sparsity.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAPruneCheckCount counts the groups of 4 consecutive elements along the k dimension
+ *  of the structured (sparse) matrix that hold more than 2 nonzeros. Unlike \ref hipsparseLtSpMMAPruneCheck,
+ *  which only reports whether the matrix is valid, it tells how many groups are wrong and, when
+ *  \p maxOffsets is positive, where up to \p maxOffsets of them are. The offsets are element offsets
+ *  into \p d_in (including the batch offset), in no particular order.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
+ *
+ *  @param[in]
+ *  handle         hipsparselt library handle
+ *  @param[in]
+ *  matmulDescr    matrix multiplication descriptor.
+ *  @param[in]
+ *  d_in           pointer to the matrix to check.
+ *  @param[out]
+ *  d_count        device pointer to the number of offending groups.
+ *  @param[out]
+ *  d_offsets      device pointer to at least \p maxOffsets offsets, can be nullptr when \p maxOffsets is 0.
+ *  @param[in]
+ *  maxOffsets     maximum number of offsets to write to \p d_offsets.
+ *  @param[in]
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p matmulDescr , \p d_in , \p d_count , \p d_offsets or \p maxOffsets is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAPruneCheckCount(const hipsparseLtHandle_t*           handle,
+                                                  const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                                  const void*                          d_in,
+                                                  int64_t*                             d_count,
+                                                  int64_t*                             d_offsets,
+                                                  int                                  maxOffsets,
+                                                  hipStream_t                          stream);
+
+/*! \ingroup helper_module
+ *  \brief provides the size of the mask written by \ref hipsparseLtSpMMAPruneMask.
+ *
+ *  \details
+ *  The mask has 4 bits for each group of 4 consecutive elements along the k dimension: k / 8 bytes
+ *  for each row of op(A) when A is the structured matrix and each column of op(B) when B is, in the
+ *  layout of the metadata of the compressed matrix.
+ *
+ *  \note
+ *  This function is only supported by the HIP backend.
+ *
+ *  @param[in]
+ *  handle         hipsparselt library handle
+ *  @param[in]
+ *  matmulDescr    matrix multiplication descriptor.
+ *  @param[out]
+ *  maskSize       size in bytes of the mask.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p matmulDescr or \p maskSize is invalid.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAPruneMaskSize(const hipsparseLtHandle_t*           handle,
+                                                const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                                size_t*                              maskSize);
+
+/*! \ingroup helper_module
+ *  \brief prunes a dense matrix and writes the mask of the kept elements.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAPruneMask prunes like \ref hipsparseLtSpMMAPrune and also writes the pattern it
+ *  picked to \p d_mask. Training re-applies the same pattern every step: \ref hipsparseLtSpMMAMaskApply
+ *  does it from the mask in a single pass, without ranking the elements again. Bit j of a nibble is
+ *  set when element j of its group of 4 is kept, the low nibble of a byte holds the first of its
+ *  two groups. \p d_out may be \p d_in.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
+ *
+ *  @param[in]
+ *  handle         hipsparselt library handle
+ *  @param[in]
+ *  matmulDescr    matrix multiplication descriptor.
+ *  @param[in]
+ *  d_in           pointer to the dense matrix.
+ *  @param[out]
+ *  d_out          pointer to the pruned matrix.
+ *  @param[out]
+ *  d_mask         pointer to the mask, of the size given by \ref hipsparseLtSpMMAPruneMaskSize.
+ *  @param[in]
+ *  pruneAlg       pruning algorithm.
+ *  @param[in]
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p matmulDescr , \p d_in , \p d_out or \p d_mask is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAPruneMask(const hipsparseLtHandle_t*           handle,
+                                            const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                            const void*                          d_in,
+                                            void*                                d_out,
+                                            void*                                d_mask,
+                                            hipsparseLtPruneAlg_t                pruneAlg,
+                                            hipStream_t                          stream);
+
+/*! \ingroup helper_module
+ *  \brief zeros the elements of a dense matrix which a mask does not keep.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAMaskApply copies \p d_in to \p d_out with the elements whose bit of \p d_mask
+ *  is clear set to 0, in a single streaming pass. It applies to any matrix of the shape of the
+ *  structured matrix, such as the updated weights or their gradients. \p d_out may be \p d_in.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
+ *
+ *  @param[in]
+ *  handle         hipsparselt library handle
+ *  @param[in]
+ *  matmulDescr    matrix multiplication descriptor.
+ *  @param[in]
+ *  d_in           pointer to the dense matrix.
+ *  @param[out]
+ *  d_out          pointer to the masked matrix.
+ *  @param[in]
+ *  d_mask         pointer to a mask written by \ref hipsparseLtSpMMAPruneMask.
+ *  @param[in]
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p matmulDescr , \p d_in , \p d_out or \p d_mask is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAMaskApply(const hipsparseLtHandle_t*           handle,
+                                            const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                            const void*                          d_in,
+                                            void*                                d_out,
+                                            const void*                          d_mask,
+                                            hipStream_t                          stream);
+
+/*! \ingroup helper_module
+ *  \brief prunes a dense matrix by an importance score instead of the magnitude of its values.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAPruneScored prunes like \ref hipsparseLtSpMMAPruneMask, in the same single
+ *  pass, but ranks the elements by \p d_score , a float tensor in the layout of \p d_in , instead of
+ *  their own magnitude. \p d_colScale , a float vector of one value for each element of the k
+ *  dimension shared by all batches, multiplies the ranks, such as the norm of the activation column
+ *  the weights meet. Either may be NULL but not both: magnitude times \p d_colScale ranks like
+ *  Wanda, a saliency computed by the caller like SparseGPT. Ranks are compared by their absolute
+ *  value and ties keep the first element, as in \ref hipsparseLtSpMMAPrune. \p d_mask is optional.
+ *  \p d_out may be \p d_in.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
+ *
+ *  @param[in]
+ *  handle         hipsparselt library handle
+ *  @param[in]
+ *  matmulDescr    matrix multiplication descriptor.
+ *  @param[in]
+ *  d_in           pointer to the dense matrix.
+ *  @param[out]
+ *  d_out          pointer to the pruned matrix.
+ *  @param[in]
+ *  d_score        pointer to the importance of each element, or NULL to rank by magnitude.
+ *  @param[in]
+ *  d_colScale     pointer to the scale of each element of the k dimension, or NULL.
+ *  @param[out]
+ *  d_mask         pointer to the mask, of the size given by \ref hipsparseLtSpMMAPruneMaskSize, or NULL.
+ *  @param[in]
+ *  pruneAlg       pruning algorithm.
+ *  @param[in]
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p matmulDescr , \p d_in or \p d_out is invalid, or \p d_score and \p d_colScale are both NULL.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAPruneScored(const hipsparseLtHandle_t*           handle,
+                                              const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                              const void*                          d_in,
+                                              void*                                d_out,
+                                              const float*                         d_score,
+                                              const float*                         d_colScale,
+                                              void*                                d_mask,
+                                              hipsparseLtPruneAlg_t                pruneAlg,
+                                              hipStream_t                          stream);
+
+// compression
+/*! \ingroup helper_module
+ *  \brief provide the size of the compressed matrix.
+ *
+ *  \details
+ *  \p HIPSPARSE_STATUS_INVALID_VALUE provides the size of the compressed matrix
+ *  to be allocated before calling \ref hipsparseLtSpMMACompress() or \ref hipsparseLtSpMMACompress2().
+ *  The compress buffer is only needed by a plan padding its matmul, see
+ *  \ref hipsparseLtDenseDescriptorInit(), its compressed matrix is padded as well.
+ *
+ *  @param[in]
+ *  handle                hipsparselt library handle
+ *  @param[in]
+ *  plan                  matrix multiplication plan descriptor.
+ *  @param[out]
+ *  compressedSize        size in bytes of the compressed matrix.
+ *  @param[out]
+ *  compressBufferSize    size in bytes for the buffer needed for the matrix compression.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p compressedSize or \p compressBufferSize is invalid.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompressedSize(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 size_t*                        compressedSize,
+                                                 size_t*                        compressBufferSize);
+
+/*! \ingroup helper_module
+ *  \brief compresses a dense matrix to structured matrix.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompress compresses a dense matrix d_dense.
+ *  The compressed matrix is intended to be used as the first/second operand A/B
+ *  in the \ref hipsparseLtMatmul() function.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  plan               matrix multiplication plan descriptor.
+ *  @param[in]
+ *  d_dense            pointer to the dense matrix.
+ *  @param[out]
+ *  d_compressed       compressed matrix and metadata.
+ *  @param[out]
+ *  d_compressBuffer   temporary buffer for the compression.
+ *  @param[in]
+ *  stream             HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p d_dense or \p d_compressed is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompress(const hipsparseLtHandle_t*     handle,
+                                           const hipsparseLtMatmulPlan_t* plan,
+                                           const void*                    d_dense,
+                                           void*                          d_compressed,
+                                           void*                          d_compressBuffer,
+                                           hipStream_t                    stream);
+
+/*! \ingroup helper_module
+ *  \brief compresses the shards of a sharded matrix multiplication on their devices.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompressSharded compresses d_dense[i] with plans[i] on the device of
+ *  handles[i] for every shard of a \ref hipsparseLtMatmulSharded(), with a single call. The
+ *  shards are validated as for \ref hipsparseLtMatmulSharded() before any of them is launched,
+ *  then compressed concurrently, each on streams[i].
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *  The current device is restored before the function returns.
+ *
+ *  @param[in]
+ *  handles            Array of \p numShards handles, one per shard.
+ *  @param[in]
+ *  plans              Array of \p numShards matrix multiplication plans, plans[i] created with handles[i].
+ *  @param[in]
+ *  numShards          Number of shards.
+ *  @param[in]
+ *  split              dimension the matrix multiplication is split along.
+ *  @param[in]
+ *  d_dense            Array of \p numShards pointers to the dense shards, on the devices of their handles.
+ *  @param[out]
+ *  d_compressed       Array of \p numShards pointers to the compressed shards.
+ *  @param[out]
+ *  d_compressBuffer   Array of \p numShards pointers to the compress buffers, can be NULL when no plan needs one.
+ *  @param[in]
+ *  streams            Array of \p numShards HIP streams, streams[i] on the device of handles[i].
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handles , \p plans , \p numShards , \p d_dense , \p d_compressed or \p streams is invalid,
+ *              or the shapes of the shards do not make a matrix multiplication split along \p split.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t
+    hipsparseLtSpMMACompressSharded(const hipsparseLtHandle_t* const*     handles,
+                                    const hipsparseLtMatmulPlan_t* const* plans,
+                                    int32_t                               numShards,
+                                    hipsparseLtShardSplit_t               split,
+                                    const void* const*                    d_dense,
+                                    void* const*                          d_compressed,
+                                    void* const*                          d_compressBuffer,
+                                    hipStream_t*                          streams);
+
+/*! \ingroup helper_module
+ *  \brief provide the size of the compressed matrix.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompressedSize2 provides the size of the compressed matrix
+ *  to be allocated before calling \ref hipsparseLtSpMMACompress or \ref hipsparseLtSpMMACompress2
+ *
+ *  @param[in]
+ *  handle                hipsparselt library handle
+ *  @param[in]
+ *  sparseMatDescr        structured(sparse) matrix descriptor.
+ *  @param[out]
+ *  compressedSize        size in bytes of the compressed matrix.
+ *  @param[out]
+ *  compressBufferSize    size in bytes for the buffer needed for the matrix compression.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle , \p sparseMatDescr , \p compressedSize or \p compressBufferSize is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompressedSize2(const hipsparseLtHandle_t*        handle,
+                                                  const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                                  size_t*                           compressedSize,
+                                                  size_t* compressBufferSize);
+
+/*! \ingroup helper_module
+ *  \brief compresses a dense matrix to structured matrix.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompress2 compresses a dense matrix d_dense.
+ *  The compressed matrix is intended to be used as the first/second operand A/B
+ *  in the \ref hipsparseLtMatmul() function.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  sparseMatDescr     structured(sparse) matrix descriptor.
+ *  @param[in]
+ *  isSparseA          specify if the structured (sparse) matrix is in the first position (matA or matB) (HIP backend only support matA)
+ *  @param[in]
+ *  op                 operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  @param[in]
+ *  d_dense            pointer to the dense matrix.
+ *  @param[out]
+ *  d_compressed       compressed matrix and metadata
+ *  @param[out]
+ *  d_compressBuffer   temporary buffer for the compression.
+ *  @param[in]
+ *  stream             HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p sparseMatDescr , \p op , \p d_dense or \p d_compressed is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompress2(const hipsparseLtHandle_t*        handle,
+                                            const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                            int                               isSparseA,
+                                            hipsparseOperation_t              op,
+                                            const void*                       d_dense,
+                                            void*                             d_compressed,
+                                            void*                             d_compressBuffer,
+                                            hipStream_t                       stream);
+
+/*! \ingroup helper_module
+ *  \brief prunes a dense matrix and compresses it to structured matrix in one pass.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAPruneAndCompress prunes a dense matrix d_dense according to the specified
+ *  algorithm pruneAlg and writes the surviving values and their metadata straight into d_compressed.
+ *  The pruned dense matrix is never materialized, the result is the same as calling
+ *  \ref hipsparseLtSpMMAPrune() followed by \ref hipsparseLtSpMMACompress().
+ *  The size of d_compressed is given by \ref hipsparseLtSpMMACompressedSize().
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  plan               matrix multiplication plan descriptor.
+ *  @param[in]
+ *  d_dense            pointer to the dense matrix.
+ *  @param[out]
+ *  d_compressed       compressed matrix and metadata.
+ *  @param[out]
+ *  d_compressBuffer   temporary buffer for the compression.
+ *  @param[in]
+ *  pruneAlg           pruning algorithm.
+ *  @param[in]
+ *  stream             HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p d_dense or \p d_compressed is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem or \p pruneAlg is not support, or the backend has no fused implementation (NVIDIA)
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAPruneAndCompress(const hipsparseLtHandle_t*     handle,
+                                                   const hipsparseLtMatmulPlan_t* plan,
+                                                   const void*                    d_dense,
+                                                   void*                          d_compressed,
+                                                   void*                          d_compressBuffer,
+                                                   hipsparseLtPruneAlg_t          pruneAlg,
+                                                   hipStream_t                    stream);
+
+/*! \ingroup helper_module
+ *  \brief prunes a dense matrix for both operations and compresses it for each of them.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAPruneAndCompressTransposable prunes \p d_in with \ref HIPSPARSELT_PRUNE_SPMMA_TILE,
+ *  which keeps 2 elements in each row and each column of every 4x4 tile, so the pruned matrix is
+ *  2:4 along both of its dimensions. From that single pruning pass it writes the compressed matrix
+ *  for the matmul with \p HIPSPARSE_OPERATION_NON_TRANSPOSE to \p d_compressed, and for the one with
+ *  \p HIPSPARSE_OPERATION_TRANSPOSE to \p d_compressedT. Training can then run the forward pass with
+ *  the matrix and the backward pass with its transpose without a second pruned copy.
+ *  Both compressed matrices have the size given by \ref hipsparseLtSpMMACompressedSize2().
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  sparseMatDescr     the descriptor of the structured(sparse) matrix.
+ *  @param[in]
+ *  isSparseA          specify if the structured (sparse) matrix is in the first position (matA or matB)
+ *  @param[in]
+ *  d_in               pointer to the dense matrix.
+ *  @param[out]
+ *  d_out              pointer to the pruned matrix, may be \p d_in.
+ *  @param[out]
+ *  d_compressed       compressed matrix and metadata for the matmul with the matrix.
+ *  @param[out]
+ *  d_compressedT      compressed matrix and metadata for the matmul with its transpose.
+ *  @param[in]
+ *  stream             HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p sparseMatDescr , \p d_in , \p d_out , \p d_compressed or \p d_compressedT is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t
+    hipsparseLtSpMMAPruneAndCompressTransposable(const hipsparseLtHandle_t*        handle,
+                                                 const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                                 int                               isSparseA,
+                                                 const void*                       d_in,
+                                                 void*                             d_out,
+                                                 void*                             d_compressed,
+                                                 void*                             d_compressedT,
+                                                 hipStream_t                       stream);
+
+/*! \ingroup helper_module
+ *  \brief provide the size of the work list of a grouped prune or compression.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAGroupedWorkListSize provides the size of the device buffer to be allocated
+ *  before calling \ref hipsparseLtSpMMAPrune2Grouped() or \ref hipsparseLtSpMMACompress2Grouped()
+ *  for \p groupCount matrices.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  groupCount         number of matrices of the group.
+ *  @param[out]
+ *  workListSize       size in bytes of the work list.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p groupCount or \p workListSize is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the backend has no grouped implementation (NVIDIA)
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAGroupedWorkListSize(const hipsparseLtHandle_t* handle,
+                                                      int                        groupCount,
+                                                      size_t*                    workListSize);
+
+/*! \ingroup helper_module
+ *  \brief prunes a group of dense matrices in one kernel launch.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAPrune2Grouped prunes the dense matrices d_in[i] described by
+ *  sparseMatDescrs[i] into d_out[i], like \ref hipsparseLtSpMMAPrune2() does for each of them,
+ *  with a single kernel launch. The matrices must share their datatype. The descriptors of the
+ *  group are turned into a work list, which is copied to d_workList on \p stream;
+ *  d_workList must stay allocated until the pruning is done and can be reused by the next
+ *  grouped call on the same stream.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  groupCount         number of matrices of the group.
+ *  @param[in]
+ *  sparseMatDescrs    host array of the structured(sparse) matrix descriptors.
+ *  @param[in]
+ *  isSparseA          specify if the structured (sparse) matrices are in the first position (matA or matB)
+ *  @param[in]
+ *  op                 operation that will be applied to the structured (sparse) matrices in the multiplication
+ *  @param[in]
+ *  d_in               host array of the pointers to the dense matrices.
+ *  @param[out]
+ *  d_out              host array of the pointers to the pruned matrices, can be equal to d_in.
+ *  @param[in]
+ *  pruneAlg           pruning algorithm.
+ *  @param[out]
+ *  d_workList         work list of at least the size given by \ref hipsparseLtSpMMAGroupedWorkListSize().
+ *  @param[in]
+ *  stream             HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p groupCount , \p sparseMatDescrs , \p op or a pointer is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem or \p pruneAlg is not support, the datatypes differ or the backend has no grouped implementation (NVIDIA)
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t
+    hipsparseLtSpMMAPrune2Grouped(const hipsparseLtHandle_t*               handle,
+                                  int                                      groupCount,
+                                  const hipsparseLtMatDescriptor_t* const* sparseMatDescrs,
+                                  int                                      isSparseA,
+                                  hipsparseOperation_t                     op,
+                                  const void* const*                       d_in,
+                                  void* const*                             d_out,
+                                  hipsparseLtPruneAlg_t                    pruneAlg,
+                                  void*                                    d_workList,
+                                  hipStream_t                              stream);
+
+/*! \ingroup helper_module
+ *  \brief compresses a group of dense matrices in one kernel launch.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompress2Grouped compresses the dense matrices d_dense[i] described by
+ *  sparseMatDescrs[i] into d_compressed[i], like \ref hipsparseLtSpMMACompress2() does for each of
+ *  them, with a single kernel launch. The matrices must share their datatype. The descriptors of
+ *  the group are turned into a work list, which is copied to d_workList on \p stream;
+ *  d_workList must stay allocated until the compression is done and can be reused by the next
+ *  grouped call on the same stream.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  groupCount         number of matrices of the group.
+ *  @param[in]
+ *  sparseMatDescrs    host array of the structured(sparse) matrix descriptors.
+ *  @param[in]
+ *  isSparseA          specify if the structured (sparse) matrices are in the first position (matA or matB)
+ *  @param[in]
+ *  op                 operation that will be applied to the structured (sparse) matrices in the multiplication
+ *  @param[in]
+ *  d_dense            host array of the pointers to the dense matrices.
+ *  @param[out]
+ *  d_compressed       host array of the pointers to the compressed matrices and metadata, each of the size given by \ref hipsparseLtSpMMACompressedSize2().
+ *  @param[out]
+ *  d_workList         work list of at least the size given by \ref hipsparseLtSpMMAGroupedWorkListSize().
+ *  @param[in]
+ *  stream             HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p groupCount , \p sparseMatDescrs , \p op or a pointer is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support, the datatypes differ or the backend has no grouped implementation (NVIDIA)
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t
+    hipsparseLtSpMMACompress2Grouped(const hipsparseLtHandle_t*               handle,
+                                     int                                      groupCount,
+                                     const hipsparseLtMatDescriptor_t* const* sparseMatDescrs,
+                                     int                                      isSparseA,
+                                     hipsparseOperation_t                     op,
+                                     const void* const*                       d_dense,
+                                     void* const*                             d_compressed,
+                                     void*                                    d_workList,
+                                     hipStream_t                              stream);
+
+/*! \ingroup helper_module
+ *  \brief provide the size of a compressed matrix without a handle.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompressedSizeHost provides the size of the compressed matrix written by
+ *  \ref hipsparseLtSpMMACompressHost(). The matrix is described by the arguments of
+ *  \ref hipsparseLtStructuredDescriptorInit(), of its batch attributes and of the matmul it is
+ *  used in. No GPU is needed.
+ *
+ *  @param[in]
+ *  rows               number of rows of the structured matrix.
+ *  @param[in]
+ *  cols               number of columns of the structured matrix.
+ *  @param[in]
+ *  ld                 leading dimension of the structured matrix, in column order.
+ *  @param[in]
+ *  valueType          data type of the matrix. see \ref hipsparseLtDatatype_t
+ *  @param[in]
+ *  numBatches         number of batches, see \ref HIPSPARSELT_MAT_NUM_BATCHES.
+ *  @param[in]
+ *  batchStride        stride between the batches, see \ref HIPSPARSELT_MAT_BATCH_STRIDE.
+ *  @param[in]
+ *  isSparseA          specify if the structured (sparse) matrix is in the first position (matA or matB)
+ *  @param[in]
+ *  op                 operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  @param[out]
+ *  compressedSize     size in bytes of the compressed matrix.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE a size, \p op or \p compressedSize is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the datatype is not supported, or the backend has no
+ *              host implementation (NVIDIA)
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompressedSizeHost(int64_t               rows,
+                                                     int64_t               cols,
+                                                     int64_t               ld,
+                                                     hipsparseLtDatatype_t valueType,
+                                                     int                   numBatches,
+                                                     int64_t               batchStride,
+                                                     int                   isSparseA,
+                                                     hipsparseOperation_t  op,
+                                                     size_t*               compressedSize);
+
+/*! \ingroup helper_module
+ *  \brief prunes a dense matrix in host memory.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMAPruneHost prunes h_in into h_out on the CPU, choosing the same elements
+ *  as \ref hipsparseLtSpMMAPrune2() does on the device. No GPU is needed, the work is split
+ *  across \p numThreads threads.
+ *
+ *  @param[in]
+ *  rows               number of rows of the structured matrix.
+ *  @param[in]
+ *  cols               number of columns of the structured matrix.
+ *  @param[in]
+ *  ld                 leading dimension of the structured matrix, in column order.
+ *  @param[in]
+ *  valueType          data type of the matrix. see \ref hipsparseLtDatatype_t
+ *  @param[in]
+ *  numBatches         number of batches, see \ref HIPSPARSELT_MAT_NUM_BATCHES.
+ *  @param[in]
+ *  batchStride        stride between the batches, see \ref HIPSPARSELT_MAT_BATCH_STRIDE.
+ *  @param[in]
+ *  isSparseA          specify if the structured (sparse) matrix is in the first position (matA or matB)
+ *  @param[in]
+ *  op                 operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  @param[in]
+ *  h_in               host pointer to the dense matrix.
+ *  @param[out]
+ *  h_out              host pointer to the pruned matrix, it may be \p h_in.
+ *  @param[in]
+ *  pruneAlg           pruning algorithm.
+ *  @param[in]
+ *  numThreads         number of threads, 0 for one thread for each core.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE a size, \p op , \p h_in or \p h_out is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the datatype or \p pruneAlg is not supported, or
+ *              the backend has no host implementation (NVIDIA)
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMAPruneHost(int64_t               rows,
+                                            int64_t               cols,
+                                            int64_t               ld,
+                                            hipsparseLtDatatype_t valueType,
+                                            int                   numBatches,
+                                            int64_t               batchStride,
+                                            int                   isSparseA,
+                                            hipsparseOperation_t  op,
+                                            const void*           h_in,
+                                            void*                 h_out,
+                                            hipsparseLtPruneAlg_t pruneAlg,
+                                            int                   numThreads);
+
+/*! \ingroup helper_module
+ *  \brief compresses a pruned matrix in host memory.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompressHost writes the compressed matrix and metadata of h_dense to
+ *  h_compressed on the CPU. The bytes are those \ref hipsparseLtSpMMACompress() writes with a
+ *  plan of the same matmul, so compressed weights can be produced offline and copied to the
+ *  device as is. No GPU is needed, the work is split across \p numThreads threads.
+ *
+ *  @param[in]
+ *  rows               number of rows of the structured matrix.
+ *  @param[in]
+ *  cols               number of columns of the structured matrix.
+ *  @param[in]
+ *  ld                 leading dimension of the structured matrix, in column order.
+ *  @param[in]
+ *  valueType          data type of the matrix. see \ref hipsparseLtDatatype_t
+ *  @param[in]
+ *  numBatches         number of batches, see \ref HIPSPARSELT_MAT_NUM_BATCHES.
+ *  @param[in]
+ *  batchStride        stride between the batches, see \ref HIPSPARSELT_MAT_BATCH_STRIDE.
+ *  @param[in]
+ *  isSparseA          specify if the structured (sparse) matrix is in the first position (matA or matB)
+ *  @param[in]
+ *  op                 operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  @param[in]
+ *  h_dense            host pointer to the pruned dense matrix.
+ *  @param[out]
+ *  h_compressed       host pointer to the compressed matrix and metadata, of the size given by
+ *                     \ref hipsparseLtSpMMACompressedSizeHost().
+ *  @param[in]
+ *  numThreads         number of threads, 0 for one thread for each core.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE a size, \p op , \p h_dense or \p h_compressed is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the datatype is not supported, or the backend has no
+ *              host implementation (NVIDIA)
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompressHost(int64_t               rows,
+                                               int64_t               cols,
+                                               int64_t               ld,
+                                               hipsparseLtDatatype_t valueType,
+                                               int                   numBatches,
+                                               int64_t               batchStride,
+                                               int                   isSparseA,
+                                               hipsparseOperation_t  op,
+                                               const void*           h_dense,
+                                               void*                 h_compressed,
+                                               int                   numThreads);
+
+/*! \ingroup helper_module
+ *  \brief recompresses some rows of a dense matrix in place.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompressRows compresses the rows [rowRanges[2 * i], rowRanges[2 * i + 1]) of
+ *  \p d_dense into \p d_compressed, values and metadata, and leaves the other rows untouched, so an
+ *  update of a few rows costs about the size of the update rather than of the matrix. A row is a row
+ *  of op(A) when A is the structured matrix and a column of op(B) when B is; it holds the k values of
+ *  one output element. The ranges apply to every batch and are recompressed in a single launch.
+ *  \p d_compressed must hold a matrix compressed with \p plan, by \ref hipsparseLtSpMMACompress() for example.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  plan               matrix multiplication plan descriptor.
+ *  @param[in]
+ *  d_dense            pointer to the pruned dense matrix.
+ *  @param[inout]
+ *  d_compressed       compressed matrix and metadata.
+ *  @param[in]
+ *  rangeCount         number of row ranges.
+ *  @param[in]
+ *  rowRanges          host array of \p rangeCount pairs of the first and the past-the-end row.
+ *  @param[out]
+ *  d_workList         device buffer of the size given by \ref hipsparseLtSpMMAGroupedWorkListSize() for \p rangeCount.
+ *  @param[in]
+ *  stream             HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p d_dense , \p d_compressed , \p rangeCount , \p rowRanges or \p d_workList is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompressRows(const hipsparseLtHandle_t*     handle,
+                                               const hipsparseLtMatmulPlan_t* plan,
+                                               const void*                    d_dense,
+                                               void*                          d_compressed,
+                                               int                            rangeCount,
+                                               const int64_t*                 rowRanges,
+                                               void*                          d_workList,
+                                               hipStream_t                    stream);
+
+/*! \ingroup helper_module
+ *  \brief compresses a dense matrix that does not reside in device memory.
  *
  *  \details
- *  \p hipsparseLtSpMMAPruneCheck2 checks the correctness of the pruning structure for a given matrix.
- *  Contents in the given matrix must be sparsity 2:4.
+ *  \p hipsparseLtSpMMACompress2Streamed writes the same compressed matrix as
+ *  \ref hipsparseLtSpMMACompress2(), but reads the pruned dense matrix in panels of rows from host
+ *  memory, or from any memory hipMemcpy can read, so a matrix larger than the free device memory
+ *  can be compressed. A row is a row of op(A) when A is the structured matrix and a column of op(B)
+ *  when B is. The panels go through two parts of \p d_panelBuffer in turn, three when it holds
+ *  three panels of 16 rows: a panel is copied on an internal stream while the previous ones are
+ *  compressed on \p stream straight to their place in \p d_compressed. Only the compressed matrix and \p d_panelBuffer are resident on the device.
+ *
+ *  \note
+ *  The copies overlap the compression only when \p dense is pinned host memory, see hipHostMalloc().
+ *  \p dense must stay valid until the work on \p stream completes.
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
  *
  *  @param[in]
- *  handle         hipsparselt library handle
+ *  handle             handle to the hipsparselt library context queue.
  *  @param[in]
- *  sparseMatDescr structured(sparse) matrix descriptor.
+ *  sparseMatDescr     the descriptor of the structured(sparse) matrix.
  *  @param[in]
- *  isSparseA      specify if the structured (sparse) matrix is in the first position (matA or matB) (HIP backend only support matA)
+ *  isSparseA          specify if the structured (sparse) matrix is in the first position (matA or matB)
  *  @param[in]
- *  op             operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  op                 operation that will be applied to the structured (sparse) matrix in the multiplication
  *  @param[in]
- *  d_in           pointer to the matrix to check.
+ *  dense              pointer to the pruned dense matrix, in host or device memory.
  *  @param[out]
- *  d_valid        validation results (0 correct, 1 wrong).
+ *  d_compressed       compressed matrix and metadata, of the size given by \ref hipsparseLtSpMMACompressedSize2().
+ *  @param[out]
+ *  d_panelBuffer      device buffer for the panels.
  *  @param[in]
- *  stream         HIP stream for the computation.
+ *  panelBufferSize    size of \p d_panelBuffer in bytes, at least two rows of k elements; the larger
+ *                     the buffer, the fewer the panels.
+ *  @param[in]
+ *  stream             HIP stream for the computation.
  *
  *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
- *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p sparseMatDescr , \p op , \p d_in or \p d_valid is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p sparseMatDescr , \p op , \p dense , \p d_compressed , \p d_panelBuffer or \p panelBufferSize is invalid.
  *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
  */
 HIPSPARSELT_EXPORT
-hipsparseStatus_t hipsparseLtSpMMAPruneCheck2(const hipsparseLtHandle_t*        handle,
-                                              const hipsparseLtMatDescriptor_t* sparseMatDescr,
-                                              int                               isSparseA,
-                                              hipsparseOperation_t              op,
-                                              const void*                       d_in,
-                                              int*                              d_valid,
-                                              hipStream_t                       stream);
+hipsparseStatus_t
+    hipsparseLtSpMMACompress2Streamed(const hipsparseLtHandle_t*        handle,
+                                      const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                      int                               isSparseA,
+                                      hipsparseOperation_t              op,
+                                      const void*                       dense,
+                                      void*                             d_compressed,
+                                      void*                             d_panelBuffer,
+                                      size_t                            panelBufferSize,
+                                      hipStream_t                       stream);
 
-// compression
 /*! \ingroup helper_module
- *  \brief provide the size of the compressed matrix.
+ *  \brief prunes and compresses a dense matrix that does not reside in device memory.
  *
  *  \details
- *  \p HIPSPARSE_STATUS_INVALID_VALUE provides the size of the compressed matrix
- *  to be allocated before calling \ref hipsparseLtSpMMACompress() or \ref hipsparseLtSpMMACompress2().
+ *  \p hipsparseLtSpMMAPruneAndCompressStreamed loads dense weights the way
+ *  \ref hipsparseLtSpMMACompress2Streamed() does, in panels of rows copied from host memory through
+ *  \p d_panelBuffer, and prunes each panel with \p pruneAlg as it compresses it. The copy of a panel
+ *  on an internal stream overlaps the prune and compress of the previous ones on \p stream, so
+ *  loading a model no longer copies, prunes and compresses each matrix one step after the other,
+ *  and neither the dense nor the pruned matrix is ever resident on the device. The result is the
+ *  same as \ref hipsparseLtSpMMAPrune2() followed by \ref hipsparseLtSpMMACompress2().
+ *  When \p bandwidth is not NULL, the call waits for the work on \p stream and stores the rate of
+ *  the whole pipeline, in GB/s of the dense matrix.
+ *
+ *  \note
+ *  The copies overlap the prune and compress only when \p dense is pinned host memory, see hipHostMalloc().
+ *  \p dense must stay valid until the work on \p stream completes.
+ *  This function supports asynchronous execution with respect to stream, unless \p bandwidth is not NULL.
+ *  This function is only supported by the HIP backend.
  *
  *  @param[in]
- *  handle                hipsparselt library handle
+ *  handle             handle to the hipsparselt library context queue.
  *  @param[in]
- *  plan                  matrix multiplication plan descriptor.
+ *  sparseMatDescr     the descriptor of the structured(sparse) matrix.
+ *  @param[in]
+ *  isSparseA          specify if the structured (sparse) matrix is in the first position (matA or matB)
+ *  @param[in]
+ *  op                 operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  @param[in]
+ *  dense              pointer to the dense matrix, in host or device memory.
  *  @param[out]
- *  compressedSize        size in bytes of the compressed matrix.
+ *  d_compressed       compressed matrix and metadata, of the size given by \ref hipsparseLtSpMMACompressedSize2().
  *  @param[out]
- *  compressBufferSize    size in bytes for the buffer needed for the matrix compression.
+ *  d_panelBuffer      device buffer for the panels.
+ *  @param[in]
+ *  panelBufferSize    size of \p d_panelBuffer in bytes, at least two rows of k elements, eight
+ *                     for \ref HIPSPARSELT_PRUNE_SPMMA_TILE; the larger the buffer, the fewer the panels.
+ *  @param[in]
+ *  pruneAlg           pruning algorithm.
+ *  @param[out]
+ *  bandwidth          host pointer to the achieved GB/s, may be NULL.
+ *  @param[in]
+ *  stream             HIP stream for the computation.
  *
  *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
- *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p compressedSize or \p compressBufferSize is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p sparseMatDescr , \p op , \p dense , \p d_compressed , \p d_panelBuffer or \p panelBufferSize is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem or \p pruneAlg is not support
  */
 HIPSPARSELT_EXPORT
-hipsparseStatus_t hipsparseLtSpMMACompressedSize(const hipsparseLtHandle_t*     handle,
-                                                 const hipsparseLtMatmulPlan_t* plan,
-                                                 size_t*                        compressedSize,
-                                                 size_t*                        compressBufferSize);
+hipsparseStatus_t
+    hipsparseLtSpMMAPruneAndCompressStreamed(const hipsparseLtHandle_t*        handle,
+                                             const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                             int                               isSparseA,
+                                             hipsparseOperation_t              op,
+                                             const void*                       dense,
+                                             void*                             d_compressed,
+                                             void*                             d_panelBuffer,
+                                             size_t                            panelBufferSize,
+                                             hipsparseLtPruneAlg_t             pruneAlg,
+                                             float*                            bandwidth,
+                                             hipStream_t                       stream);
 
 /*! \ingroup helper_module
- *  \brief compresses a dense matrix to structured matrix.
+ *  \brief expands a compressed matrix back to a dense matrix.
  *
  *  \details
- *  \p hipsparseLtSpMMACompress compresses a dense matrix d_dense.
- *  The compressed matrix is intended to be used as the first/second operand A/B
- *  in the \ref hipsparseLtMatmul() function.
+ *  \p hipsparseLtSpMMADecompress is the inverse of \ref hipsparseLtSpMMACompress(), it writes the pruned
+ *  dense matrix from the compressed values and metadata of \p d_compressed, with the zeros in place.
+ *  Only the compressed copy has to stay resident: the dense matrix can be expanded on demand, for a
+ *  dense fallback or to verify results. Only the first batch is written when the structured matrix
+ *  is broadcast.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
  *
  *  @param[in]
  *  handle             handle to the hipsparselt library context queue.
  *  @param[in]
  *  plan               matrix multiplication plan descriptor.
  *  @param[in]
- *  d_dense            pointer to the dense matrix.
- *  @param[out]
  *  d_compressed       compressed matrix and metadata.
  *  @param[out]
- *  d_compressBuffer   temporary buffer for the compression.
+ *  d_dense            pointer to the dense matrix.
  *  @param[in]
  *  stream             HIP stream for the computation.
  *
  *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
- *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p d_dense or \p d_compressed is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p d_compressed or \p d_dense is invalid.
  *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
  */
 HIPSPARSELT_EXPORT
-hipsparseStatus_t hipsparseLtSpMMACompress(const hipsparseLtHandle_t*     handle,
-                                           const hipsparseLtMatmulPlan_t* plan,
-                                           const void*                    d_dense,
-                                           void*                          d_compressed,
-                                           void*                          d_compressBuffer,
-                                           hipStream_t                    stream);
+hipsparseStatus_t hipsparseLtSpMMADecompress(const hipsparseLtHandle_t*     handle,
+                                             const hipsparseLtMatmulPlan_t* plan,
+                                             const void*                    d_compressed,
+                                             void*                          d_dense,
+                                             hipStream_t                    stream);
 
 /*! \ingroup helper_module
- *  \brief provide the size of the compressed matrix.
+ *  \brief expands a compressed matrix back to a dense matrix.
  *
  *  \details
- *  \p hipsparseLtSpMMACompressedSize2 provides the size of the compressed matrix
- *  to be allocated before calling \ref hipsparseLtSpMMACompress or \ref hipsparseLtSpMMACompress2
+ *  \p hipsparseLtSpMMADecompress2 is the inverse of \ref hipsparseLtSpMMACompress2(), it writes the pruned
+ *  dense matrix from the compressed values and metadata of \p d_compressed, with the zeros in place.
+ *  Only the first batch is written when the structured matrix is broadcast.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
  *
  *  @param[in]
- *  handle                hipsparselt library handle
+ *  handle             handle to the hipsparselt library context queue.
  *  @param[in]
- *  sparseMatDescr        structured(sparse) matrix descriptor.
- *  @param[out]
- *  compressedSize        size in bytes of the compressed matrix.
+ *  sparseMatDescr     structured(sparse) matrix descriptor.
+ *  @param[in]
+ *  isSparseA          specify if the structured (sparse) matrix is in the first position (matA or matB)
+ *  @param[in]
+ *  op                 operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  @param[in]
+ *  d_compressed       compressed matrix and metadata.
  *  @param[out]
- *  compressBufferSize    size in bytes for the buffer needed for the matrix compression.
+ *  d_dense            pointer to the dense matrix.
+ *  @param[in]
+ *  stream             HIP stream for the computation.
  *
  *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
- *  \retval     HIPSPARSE_STATUS_NOT_INITIALIZED \p handle , \p sparseMatDescr , \p compressedSize or \p compressBufferSize is invalid.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p sparseMatDescr , \p op , \p d_compressed or \p d_dense is invalid.
  *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
  */
 HIPSPARSELT_EXPORT
-hipsparseStatus_t hipsparseLtSpMMACompressedSize2(const hipsparseLtHandle_t*        handle,
-                                                  const hipsparseLtMatDescriptor_t* sparseMatDescr,
-                                                  size_t*                           compressedSize,
-                                                  size_t* compressBufferSize);
+hipsparseStatus_t hipsparseLtSpMMADecompress2(const hipsparseLtHandle_t*        handle,
+                                              const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                              int                               isSparseA,
+                                              hipsparseOperation_t              op,
+                                              const void*                       d_compressed,
+                                              void*                             d_dense,
+                                              hipStream_t                       stream);
 
 /*! \ingroup helper_module
- *  \brief compresses a dense matrix to structured matrix.
+ *  \brief provide the size of an optimizer state of \ref hipsparseLtSpMMACompressedUpdate.
  *
  *  \details
- *  \p hipsparseLtSpMMACompress2 compresses a dense matrix d_dense.
- *  The compressed matrix is intended to be used as the first/second operand A/B
- *  in the \ref hipsparseLtMatmul() function.
+ *  \p hipsparseLtSpMMACompressedUpdateStateSize returns the bytes of one float state in the layout of the
+ *  compressed values of the structured matrix of the plan, half the size of a dense float state.
  *
  *  @param[in]
  *  handle             handle to the hipsparselt library context queue.
  *  @param[in]
- *  sparseMatDescr     structured(sparse) matrix descriptor.
+ *  plan               matrix multiplication plan descriptor.
+ *  @param[out]
+ *  stateSize          size in bytes of a state buffer.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan or \p stateSize is invalid.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t
+    hipsparseLtSpMMACompressedUpdateStateSize(const hipsparseLtHandle_t*     handle,
+                                              const hipsparseLtMatmulPlan_t* plan,
+                                              size_t*                        stateSize);
+
+/*! \ingroup helper_module
+ *  \brief applies an optimizer step to the values of a compressed matrix.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompressedUpdate updates the values of \p d_compressed in place from
+ *  \p d_grad , a gradient in the dense layout of the structured matrix, with the pattern frozen in
+ *  the metadata: only the gradient elements the metadata points to are read and the metadata is not
+ *  written, so a fine-tuning step needs no decompression, prune or recompression. The update is
+ *  computed in float and rounded to the type of the matrix. \p d_state1 and \p d_state2 are float
+ *  states in the layout of the compressed values, of the size given by
+ *  \ref hipsparseLtSpMMACompressedUpdateStateSize, zeroed before the first step: the momentum of SGD,
+ *  needed when beta1 is not 0, and the two moments of Adam. A kept element which was 0 when the
+ *  matrix was compressed is updated at the position the compression gave its slot. Only
+ *  HIPSPARSELT_R_16F and HIPSPARSELT_R_16BF matrices are supported.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
+ *
  *  @param[in]
- *  isSparseA          specify if the structured (sparse) matrix is in the first position (matA or matB) (HIP backend only support matA)
+ *  handle             handle to the hipsparselt library context queue.
  *  @param[in]
- *  op                 operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  plan               matrix multiplication plan descriptor.
  *  @param[in]
- *  d_dense            pointer to the dense matrix.
+ *  params             optimizer and its parameters.
+ *  @param[inout]
+ *  d_compressed       compressed matrix and metadata.
+ *  @param[in]
+ *  d_grad             pointer to the dense gradient.
+ *  @param[inout]
+ *  d_state1           momentum of SGD or first moment of Adam, may be NULL for SGD without momentum.
+ *  @param[inout]
+ *  d_state2           second moment of Adam, may be NULL for SGD.
+ *  @param[in]
+ *  stream             HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p params , \p d_compressed , \p d_grad , a state the optimizer needs or the step of Adam is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the optimizer or the type of the matrix is not supported.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompressedUpdate(const hipsparseLtHandle_t*          handle,
+                                                   const hipsparseLtMatmulPlan_t*      plan,
+                                                   const hipsparseLtOptimizerParams_t* params,
+                                                   void*                               d_compressed,
+                                                   const void*                         d_grad,
+                                                   float*                              d_state1,
+                                                   float*                              d_state2,
+                                                   hipStream_t                         stream);
+
+/*! \ingroup helper_module
+ *  \brief provide the size of a compressed matrix packed to 4-bit values.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompressedInt4Size returns the bytes \ref hipsparseLtSpMMACompressedInt4Pack writes
+ *  for the structured matrix of the plan: the values as signed 4-bit integers, one float scale for
+ *  each group of \p groupSize compressed values along k, and the metadata.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  plan               matrix multiplication plan descriptor.
+ *  @param[in]
+ *  groupSize          compressed values sharing a scale, even and dividing k / 2.
  *  @param[out]
- *  d_compressed       compressed matrix and metadata
+ *  packedSize         size in bytes of the packed matrix.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p groupSize or \p packedSize is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the type of the matrix is not HIPSPARSELT_R_16F or HIPSPARSELT_R_16BF.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompressedInt4Size(const hipsparseLtHandle_t*     handle,
+                                                     const hipsparseLtMatmulPlan_t* plan,
+                                                     int64_t                        groupSize,
+                                                     size_t*                        packedSize);
+
+/*! \ingroup helper_module
+ *  \brief packs the values of a compressed matrix to 4-bit integers with group scales.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompressedInt4Pack quantizes the values of \p d_compressed , written by
+ *  \ref hipsparseLtSpMMACompress , to signed 4-bit integers: each group of \p groupSize compressed
+ *  values along k gets the scale max|v| / 7 and its values round(v / scale). The 2:4 metadata is copied
+ *  as it is, so a packed weight takes about a quarter of the dense fp16 matrix in memory or on disk.
+ *  \ref hipsparseLtSpMMACompressedInt4Unpack expands it back for \ref hipsparseLtMatmul , which has
+ *  no kernels reading 4-bit values.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  plan               matrix multiplication plan descriptor.
+ *  @param[in]
+ *  groupSize          compressed values sharing a scale, even and dividing k / 2.
+ *  @param[in]
+ *  d_compressed       compressed matrix and metadata.
  *  @param[out]
- *  d_compressBuffer   temporary buffer for the compression.
+ *  d_packed           packed matrix, of the size given by \ref hipsparseLtSpMMACompressedInt4Size.
  *  @param[in]
  *  stream             HIP stream for the computation.
  *
  *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
- *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p sparseMatDescr , \p op , \p d_dense or \p d_compressed is invalid.
- *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the problem is not support
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p groupSize , \p d_compressed or \p d_packed is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the type of the matrix is not HIPSPARSELT_R_16F or HIPSPARSELT_R_16BF.
  */
 HIPSPARSELT_EXPORT
-hipsparseStatus_t hipsparseLtSpMMACompress2(const hipsparseLtHandle_t*        handle,
-                                            const hipsparseLtMatDescriptor_t* sparseMatDescr,
-                                            int                               isSparseA,
-                                            hipsparseOperation_t              op,
-                                            const void*                       d_dense,
-                                            void*                             d_compressed,
-                                            void*                             d_compressBuffer,
-                                            hipStream_t                       stream);
+hipsparseStatus_t hipsparseLtSpMMACompressedInt4Pack(const hipsparseLtHandle_t*     handle,
+                                                     const hipsparseLtMatmulPlan_t* plan,
+                                                     int64_t                        groupSize,
+                                                     const void*                    d_compressed,
+                                                     void*                          d_packed,
+                                                     hipStream_t                    stream);
+
+/*! \ingroup helper_module
+ *  \brief expands a packed 4-bit compressed matrix back to a compressed matrix.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompressedInt4Unpack writes the compressed matrix \ref hipsparseLtMatmul reads
+ *  from a matrix packed by \ref hipsparseLtSpMMACompressedInt4Pack with the same \p groupSize , each
+ *  value being its 4-bit integer times the scale of its group. Only the packed copy has to stay
+ *  resident, a layer can be expanded into a shared buffer right before its matmul.
+ *
+ *  \note
+ *  This function supports asynchronous execution with respect to stream.
+ *  This function is only supported by the HIP backend.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  plan               matrix multiplication plan descriptor.
+ *  @param[in]
+ *  groupSize          compressed values sharing a scale, the one given to the pack.
+ *  @param[in]
+ *  d_packed           packed matrix.
+ *  @param[out]
+ *  d_compressed       compressed matrix and metadata.
+ *  @param[in]
+ *  stream             HIP stream for the computation.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p groupSize , \p d_packed or \p d_compressed is invalid.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the type of the matrix is not HIPSPARSELT_R_16F or HIPSPARSELT_R_16BF.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompressedInt4Unpack(const hipsparseLtHandle_t*     handle,
+                                                       const hipsparseLtMatmulPlan_t* plan,
+                                                       int64_t                        groupSize,
+                                                       const void*                    d_packed,
+                                                       void*                          d_compressed,
+                                                       hipStream_t                    stream);
+
+/*! \ingroup helper_module
+ *  \brief writes a compressed matrix to a file.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompressedSave copies the compressed matrix written by \ref hipsparseLtSpMMACompress()
+ *  to \p path, after a versioned header that records the parameters of the structured matrix of the plan
+ *  and the offset of the metadata. \ref hipsparseLtSpMMACompressedLoad() uploads the file again, so a
+ *  service can skip the prune and the compression on every start.
+ *
+ *  \note
+ *  The function returns when the file is written.
+ *  This function is only supported by the HIP backend.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  plan               matrix multiplication plan descriptor.
+ *  @param[in]
+ *  d_compressed       compressed matrix and metadata.
+ *  @param[in]
+ *  path               path of the file to create or overwrite.
+ *  @param[in]
+ *  stream             HIP stream for the copy.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p d_compressed or \p path is invalid.
+ *  \retval     HIPSPARSE_STATUS_INTERNAL_ERROR the file cannot be written.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the backend does not support it.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompressedSave(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 const void*                    d_compressed,
+                                                 const char*                    path,
+                                                 hipStream_t                    stream);
+
+/*! \ingroup helper_module
+ *  \brief reads a compressed matrix from a file.
+ *
+ *  \details
+ *  \p hipsparseLtSpMMACompressedLoad copies a file written by \ref hipsparseLtSpMMACompressedSave() into
+ *  \p d_compressed, which then holds the bytes \ref hipsparseLtSpMMACompress() would have written. The header
+ *  must match the structured matrix of \p plan. The file is memory mapped and registered with HIP, the
+ *  copy to the device is a DMA from the mapping without reformatting or a staging buffer.
+ *
+ *  \note
+ *  The function returns when the copy is complete.
+ *  This function is only supported by the HIP backend.
+ *
+ *  @param[in]
+ *  handle             handle to the hipsparselt library context queue.
+ *  @param[in]
+ *  plan               matrix multiplication plan descriptor.
+ *  @param[in]
+ *  path               path of the file to read.
+ *  @param[out]
+ *  d_compressed       compressed matrix and metadata, of the size given by \ref hipsparseLtSpMMACompressedSize().
+ *  @param[in]
+ *  stream             HIP stream for the copy.
+ *
+ *  \retval     HIPSPARSE_STATUS_SUCCESS the operation completed successfully.
+ *  \retval     HIPSPARSE_STATUS_INVALID_VALUE \p handle , \p plan , \p path or \p d_compressed is invalid, or the file does not match \p plan.
+ *  \retval     HIPSPARSE_STATUS_INTERNAL_ERROR the file cannot be read.
+ *  \retval     HIPSPARSE_STATUS_NOT_SUPPORTED the file has a newer version, or the backend does not support it.
+ */
+HIPSPARSELT_EXPORT
+hipsparseStatus_t hipsparseLtSpMMACompressedLoad(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 const char*                    path,
+                                                 void*                          d_compressed,
+                                                 hipStream_t                    stream);
 
 #ifdef __cplusplus
 }
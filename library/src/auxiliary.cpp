@@ -31,6 +31,7 @@ const hipsparseLtDatatype_t string_to_hipsparselt_datatype(const std::string& va
         value == "f16_r" || value == "h" ? HIPSPARSELT_R_16F  :
         value == "bf16_r"                ? HIPSPARSELT_R_16BF  :
         value == "i8_r"                  ? HIPSPARSELT_R_8I   :
+        value == "i32_r"                 ? HIPSPARSELT_R_32I  :
         value == "f8_r"                  ? HIPSPARSELT_R_8F   :
         value == "bf8_r"                 ? HIPSPARSELT_R_8BF   :
         static_cast<hipsparseLtDatatype_t>(-1);
@@ -60,6 +61,8 @@ const hipsparselt_activation_type string_to_hipsparselt_activation_type(const st
            : value == "tanh"        ? hipsparselt_activation_type::tanh
            : value == "all"         ? hipsparselt_activation_type::all
            : value == "exp"         ? hipsparselt_activation_type::exp
+           : value == "silu"        ? hipsparselt_activation_type::silu
+           : value == "clamp"       ? hipsparselt_activation_type::clamp
                                     : static_cast<hipsparselt_activation_type>(-1);
 }
 
@@ -84,6 +87,10 @@ const char* hipsparselt_activation_type_to_string(hipsparselt_activation_type ty
         return "sigmoid";
     case hipsparselt_activation_type::tanh:
         return "tanh";
+    case hipsparselt_activation_type::silu:
+        return "silu";
+    case hipsparselt_activation_type::clamp:
+        return "clamp";
     case hipsparselt_activation_type::all:
         return "all";
     case hipsparselt_activation_type::none:
@@ -26,6 +26,7 @@
 
 #include "exceptions.hpp"
 #include "hipsparselt_ostream.hpp"
+#include "roctx_marker.hpp"
 #include "utility.hpp"
 #include <hip/hip_runtime_api.h>
 #include <hipsparselt/hipsparselt.h>
@@ -126,6 +127,9 @@ rocsparselt_datatype_ HIPDatatypeToRocSparseLtDatatype(hipsparseLtDatatype_t typ
     case HIPSPARSELT_R_8I:
         return rocsparselt_datatype_i8_r;
 
+    case HIPSPARSELT_R_32I:
+        return rocsparselt_datatype_i32_r;
+
     case HIPSPARSELT_R_8F:
         return rocsparselt_datatype_f8_r;
 
@@ -153,6 +157,9 @@ hipsparseLtDatatype_t RocSparseLtDatatypeToHIPDatatype(rocsparselt_datatype_ typ
     case rocsparselt_datatype_i8_r:
         return HIPSPARSELT_R_8I;
 
+    case rocsparselt_datatype_i32_r:
+        return HIPSPARSELT_R_32I;
+
     case rocsparselt_datatype_f8_r:
         return HIPSPARSELT_R_8F;
 
@@ -307,6 +314,42 @@ rocsparselt_matmul_descr_attribute_
         return rocsparselt_matmul_activation_tanh_beta;
     case HIPSPARSELT_MATMUL_BIAS_TYPE:
         return rocsparselt_matmul_bias_type;
+    case HIPSPARSELT_MATMUL_SCALE_A:
+        return rocsparselt_matmul_scale_a;
+    case HIPSPARSELT_MATMUL_SCALE_B:
+        return rocsparselt_matmul_scale_b;
+    case HIPSPARSELT_MATMUL_D_SCALE:
+        return rocsparselt_matmul_d_scale;
+    case HIPSPARSELT_MATMUL_D_SATURATE:
+        return rocsparselt_matmul_d_saturate;
+    case HIPSPARSELT_MATMUL_AMAX_D_POINTER:
+        return rocsparselt_matmul_amax_d_pointer;
+    case HIPSPARSELT_MATMUL_RESIDUAL_POINTER:
+        return rocsparselt_matmul_residual_pointer;
+    case HIPSPARSELT_MATMUL_RESIDUAL_STRIDE:
+        return rocsparselt_matmul_residual_stride;
+    case HIPSPARSELT_MATMUL_GATE_POINTER:
+        return rocsparselt_matmul_gate_pointer;
+    case HIPSPARSELT_MATMUL_GATE_STRIDE:
+        return rocsparselt_matmul_gate_stride;
+    case HIPSPARSELT_MATMUL_ACTIVATION_SILU:
+        return rocsparselt_matmul_activation_silu;
+    case HIPSPARSELT_MATMUL_ACTIVATION_CLAMP:
+        return rocsparselt_matmul_activation_clamp;
+    case HIPSPARSELT_MATMUL_ACTIVATION_CLAMP_MIN:
+        return rocsparselt_matmul_activation_clamp_min;
+    case HIPSPARSELT_MATMUL_ACTIVATION_CLAMP_MAX:
+        return rocsparselt_matmul_activation_clamp_max;
+    case HIPSPARSELT_MATMUL_CU_COUNT:
+        return rocsparselt_matmul_cu_count;
+    case HIPSPARSELT_MATMUL_LABEL:
+        return rocsparselt_matmul_label;
+    case HIPSPARSELT_MATMUL_CANDIDATES:
+        return rocsparselt_matmul_candidates;
+    case HIPSPARSELT_MATMUL_BIAS_GRAD_POINTER:
+        return rocsparselt_matmul_bias_grad_pointer;
+    case HIPSPARSELT_MATMUL_SPARSE_DYNAMIC:
+        return rocsparselt_matmul_sparse_dynamic;
     default:
         throw HIPSPARSE_STATUS_NOT_SUPPORTED;
     }
@@ -351,6 +394,42 @@ hipsparseLtMatmulDescAttribute_t
         return HIPSPARSELT_MATMUL_ACTIVATION_TANH_BETA;
     case rocsparselt_matmul_bias_type:
         return HIPSPARSELT_MATMUL_BIAS_TYPE;
+    case rocsparselt_matmul_scale_a:
+        return HIPSPARSELT_MATMUL_SCALE_A;
+    case rocsparselt_matmul_scale_b:
+        return HIPSPARSELT_MATMUL_SCALE_B;
+    case rocsparselt_matmul_d_scale:
+        return HIPSPARSELT_MATMUL_D_SCALE;
+    case rocsparselt_matmul_d_saturate:
+        return HIPSPARSELT_MATMUL_D_SATURATE;
+    case rocsparselt_matmul_amax_d_pointer:
+        return HIPSPARSELT_MATMUL_AMAX_D_POINTER;
+    case rocsparselt_matmul_residual_pointer:
+        return HIPSPARSELT_MATMUL_RESIDUAL_POINTER;
+    case rocsparselt_matmul_residual_stride:
+        return HIPSPARSELT_MATMUL_RESIDUAL_STRIDE;
+    case rocsparselt_matmul_gate_pointer:
+        return HIPSPARSELT_MATMUL_GATE_POINTER;
+    case rocsparselt_matmul_gate_stride:
+        return HIPSPARSELT_MATMUL_GATE_STRIDE;
+    case rocsparselt_matmul_activation_silu:
+        return HIPSPARSELT_MATMUL_ACTIVATION_SILU;
+    case rocsparselt_matmul_activation_clamp:
+        return HIPSPARSELT_MATMUL_ACTIVATION_CLAMP;
+    case rocsparselt_matmul_activation_clamp_min:
+        return HIPSPARSELT_MATMUL_ACTIVATION_CLAMP_MIN;
+    case rocsparselt_matmul_activation_clamp_max:
+        return HIPSPARSELT_MATMUL_ACTIVATION_CLAMP_MAX;
+    case rocsparselt_matmul_cu_count:
+        return HIPSPARSELT_MATMUL_CU_COUNT;
+    case rocsparselt_matmul_label:
+        return HIPSPARSELT_MATMUL_LABEL;
+    case rocsparselt_matmul_candidates:
+        return HIPSPARSELT_MATMUL_CANDIDATES;
+    case rocsparselt_matmul_bias_grad_pointer:
+        return HIPSPARSELT_MATMUL_BIAS_GRAD_POINTER;
+    case rocsparselt_matmul_sparse_dynamic:
+        return HIPSPARSELT_MATMUL_SPARSE_DYNAMIC;
     default:
         throw HIPSPARSE_STATUS_NOT_SUPPORTED;
     }
@@ -423,6 +502,18 @@ rocsparselt_matmul_alg_attribute_
         return rocsparselt_matmul_split_k_mode;
     case HIPSPARSELT_MATMUL_SPLIT_K_BUFFERS:
         return rocsparselt_matmul_split_k_buffers;
+    case HIPSPARSELT_MATMUL_SEARCH_FLUSH_CACHE:
+        return rocsparselt_matmul_search_flush_cache;
+    case HIPSPARSELT_MATMUL_SEARCH_RESULTS:
+        return rocsparselt_matmul_search_results;
+    case HIPSPARSELT_MATMUL_STREAM_K:
+        return rocsparselt_matmul_stream_k;
+    case HIPSPARSELT_MATMUL_SEARCH_DENSE:
+        return rocsparselt_matmul_search_dense;
+    case HIPSPARSELT_MATMUL_DENSE_SELECTED:
+        return rocsparselt_matmul_dense_selected;
+    case HIPSPARSELT_MATMUL_CONFIG_SCORES:
+        return rocsparselt_matmul_config_scores;
     default:
         throw HIPSPARSE_STATUS_NOT_SUPPORTED;
     }
@@ -445,6 +536,18 @@ hipsparseLtMatmulAlgAttribute_t
         return HIPSPARSELT_MATMUL_SPLIT_K_MODE;
     case rocsparselt_matmul_split_k_buffers:
         return HIPSPARSELT_MATMUL_SPLIT_K_BUFFERS;
+    case rocsparselt_matmul_search_flush_cache:
+        return HIPSPARSELT_MATMUL_SEARCH_FLUSH_CACHE;
+    case rocsparselt_matmul_search_results:
+        return HIPSPARSELT_MATMUL_SEARCH_RESULTS;
+    case rocsparselt_matmul_stream_k:
+        return HIPSPARSELT_MATMUL_STREAM_K;
+    case rocsparselt_matmul_search_dense:
+        return HIPSPARSELT_MATMUL_SEARCH_DENSE;
+    case rocsparselt_matmul_dense_selected:
+        return HIPSPARSELT_MATMUL_DENSE_SELECTED;
+    case rocsparselt_matmul_config_scores:
+        return HIPSPARSELT_MATMUL_CONFIG_SCORES;
     default:
         throw HIPSPARSE_STATUS_NOT_SUPPORTED;
     }
@@ -476,6 +579,32 @@ hipsparseLtPruneAlg_t RocSparseLtPruneAlgToHIPPruneAlg(rocsparselt_prune_alg_ al
     }
 }
 
+rocsparselt_optimizer HIPOptimizerToRocSparseLtOptimizer(hipsparseLtOptimizer_t optimizer)
+{
+    switch(optimizer)
+    {
+    case HIPSPARSELT_OPTIMIZER_SGD:
+        return rocsparselt_optimizer_sgd;
+    case HIPSPARSELT_OPTIMIZER_ADAM:
+        return rocsparselt_optimizer_adam;
+    default:
+        throw HIPSPARSE_STATUS_NOT_SUPPORTED;
+    }
+}
+
+rocsparselt_shard_split HIPShardSplitToRocSparseLtShardSplit(hipsparseLtShardSplit_t split)
+{
+    switch(split)
+    {
+    case HIPSPARSELT_SHARD_SPLIT_OUTPUT:
+        return rocsparselt_shard_split_output;
+    case HIPSPARSELT_SHARD_SPLIT_K:
+        return rocsparselt_shard_split_k;
+    default:
+        throw HIPSPARSE_STATUS_NOT_SUPPORTED;
+    }
+}
+
 rocsparselt_split_k_mode HIPSplitKModeToRocSparseLtSplitKMode(hipsparseLtSplitKMode_t mode)
 {
     switch(mode)
@@ -747,6 +876,10 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+// the search results are returned by rocsparselt in place
+static_assert(sizeof(hipsparseLtMatmulSearchResult_t) == sizeof(rocsparselt_matmul_search_result),
+              "hipsparseLtMatmulSearchResult_t must match rocsparselt_matmul_search_result");
+
 hipsparseStatus_t
     hipsparseLtMatmulAlgGetAttribute(const hipsparseLtHandle_t*             handle,
                                      const hipsparseLtMatmulAlgSelection_t* algSelection,
@@ -798,6 +931,50 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+hipsparseStatus_t hipsparseLtMatmulPlanInitAsync(const hipsparseLtHandle_t*           handle,
+                                                 hipsparseLtMatmulPlan_t*             plan,
+                                                 hipsparseLtMatmulAlgSelection_t*     algSelection,
+                                                 const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                                 hipsparseLtMatmulAlg_t               alg)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_plan_init_async((const rocsparselt_handle*)handle,
+                                           (rocsparselt_matmul_plan*)plan,
+                                           (rocsparselt_matmul_alg_selection*)algSelection,
+                                           (const rocsparselt_matmul_descr*)matmulDescr,
+                                           HIPMatmulAlgToRocSparseLtMatmulAlg(alg)));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulPlanInitWait(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan)
+try
+{
+    return RocSparseLtStatusToHIPStatus(rocsparselt_matmul_plan_init_wait(
+        (const rocsparselt_handle*)handle, (const rocsparselt_matmul_plan*)plan));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulPlanInitQuery(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 int*                           ready)
+try
+{
+    return RocSparseLtStatusToHIPStatus(rocsparselt_matmul_plan_init_query(
+        (const rocsparselt_handle*)handle, (const rocsparselt_matmul_plan*)plan, ready));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 hipsparseStatus_t hipsparseLtMatmulPlanDestroy(const hipsparseLtMatmulPlan_t* plan)
 try
 {
@@ -809,6 +986,63 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+hipsparseStatus_t hipsparseLtMatmulPlanSerialize(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 void*                          data,
+                                                 size_t*                        dataSize)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_plan_serialize((const rocsparselt_handle*)handle,
+                                          (const rocsparselt_matmul_plan*)plan,
+                                          data,
+                                          dataSize));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t
+    hipsparseLtMatmulPlanDeserialize(const hipsparseLtHandle_t*           handle,
+                                     hipsparseLtMatmulPlan_t*             plan,
+                                     const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                     hipsparseLtMatmulAlgSelection_t*     algSelection,
+                                     const void*                          data,
+                                     size_t                               dataSize)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_plan_deserialize((const rocsparselt_handle*)handle,
+                                            (rocsparselt_matmul_plan*)plan,
+                                            (const rocsparselt_matmul_descr*)matmulDescr,
+                                            (rocsparselt_matmul_alg_selection*)algSelection,
+                                            data,
+                                            dataSize));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+static_assert(sizeof(hipsparseLtMatmulPlanStats_t) == sizeof(rocsparselt_matmul_plan_stats),
+              "hipsparseLtMatmulPlanStats_t must match rocsparselt_matmul_plan_stats");
+
+hipsparseStatus_t hipsparseLtMatmulPlanGetStats(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan,
+                                                hipsparseLtMatmulPlanStats_t*  stats)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_plan_get_stats((const rocsparselt_handle*)handle,
+                                          (const rocsparselt_matmul_plan*)plan,
+                                          (rocsparselt_matmul_plan_stats*)stats));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 /* matmul execution */
 hipsparseStatus_t hipsparseLtMatmul(const hipsparseLtHandle_t*     handle,
                                     const hipsparseLtMatmulPlan_t* plan,
@@ -823,6 +1057,7 @@ hipsparseStatus_t hipsparseLtMatmul(const hipsparseLtHandle_t*     handle,
                                     int32_t                        numStreams)
 try
 {
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_plan*)plan);
     return RocSparseLtStatusToHIPStatus(rocsparselt_matmul((const rocsparselt_handle*)handle,
                                                            (const rocsparselt_matmul_plan*)plan,
                                                            alpha,
@@ -853,6 +1088,7 @@ hipsparseStatus_t hipsparseLtMatmulSearch(const hipsparseLtHandle_t* handle,
                                           int32_t                    numStreams)
 try
 {
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_plan*)plan);
     return RocSparseLtStatusToHIPStatus(rocsparselt_matmul_search((const rocsparselt_handle*)handle,
                                                                   (rocsparselt_matmul_plan*)plan,
                                                                   alpha,
@@ -870,6 +1106,260 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+hipsparseStatus_t hipsparseLtMatmulSearchAsync(const hipsparseLtHandle_t* handle,
+                                               hipsparseLtMatmulPlan_t*   plan,
+                                               const void*                alpha,
+                                               const void*                d_A,
+                                               const void*                d_B,
+                                               const void*                beta,
+                                               const void*                d_C,
+                                               hipStream_t                stream)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_search_async((const rocsparselt_handle*)handle,
+                                        (rocsparselt_matmul_plan*)plan,
+                                        alpha,
+                                        d_A,
+                                        d_B,
+                                        beta,
+                                        d_C,
+                                        stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulSearchWait(const hipsparseLtHandle_t* handle,
+                                              hipsparseLtMatmulPlan_t*   plan)
+try
+{
+    return RocSparseLtStatusToHIPStatus(rocsparselt_matmul_search_wait(
+        (const rocsparselt_handle*)handle, (rocsparselt_matmul_plan*)plan));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulPlanGetGraph(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan,
+                                                const void*                    alpha,
+                                                const void*                    d_A,
+                                                const void*                    d_B,
+                                                const void*                    beta,
+                                                const void*                    d_C,
+                                                void*                          d_D,
+                                                void*                          workspace,
+                                                hipStream_t                    stream,
+                                                hipGraph_t*                    graph)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_get_graph((const rocsparselt_handle*)handle,
+                                     (const rocsparselt_matmul_plan*)plan,
+                                     alpha,
+                                     d_A,
+                                     d_B,
+                                     beta,
+                                     d_C,
+                                     d_D,
+                                     workspace,
+                                     stream,
+                                     graph));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulGraphLaunch(const hipsparseLtHandle_t* handle,
+                                               hipsparseLtMatmulPlan_t*   plan,
+                                               hipGraphExec_t             graphExec,
+                                               const void*                alpha,
+                                               const void*                d_A,
+                                               const void*                d_B,
+                                               const void*                beta,
+                                               const void*                d_C,
+                                               void*                      d_D,
+                                               void*                      workspace,
+                                               hipStream_t                stream)
+try
+{
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_plan*)plan);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_graph_launch((const rocsparselt_handle*)handle,
+                                        (rocsparselt_matmul_plan*)plan,
+                                        graphExec,
+                                        alpha,
+                                        d_A,
+                                        d_B,
+                                        beta,
+                                        d_C,
+                                        d_D,
+                                        workspace,
+                                        stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulGrouped(const hipsparseLtHandle_t*            handle,
+                                           const hipsparseLtMatmulPlan_t* const* plans,
+                                           int32_t                               groupCount,
+                                           const void*                           alpha,
+                                           const void* const*                    d_A,
+                                           const void* const*                    d_B,
+                                           const void*                           beta,
+                                           const void* const*                    d_C,
+                                           void* const*                          d_D,
+                                           void* const*                          workspaces,
+                                           hipStream_t*                          streams,
+                                           int32_t                               numStreams)
+try
+{
+    rocsparselt_roctx_range range(__func__, groupCount);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_grouped((const rocsparselt_handle*)handle,
+                                   (const rocsparselt_matmul_plan* const*)plans,
+                                   groupCount,
+                                   alpha,
+                                   d_A,
+                                   d_B,
+                                   beta,
+                                   d_C,
+                                   d_D,
+                                   workspaces,
+                                   streams,
+                                   numStreams));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t
+    hipsparseLtMatmulShardedGetWorkspace(const hipsparseLtHandle_t* const*     handles,
+                                         const hipsparseLtMatmulPlan_t* const* plans,
+                                         int32_t                               numShards,
+                                         hipsparseLtShardSplit_t               split,
+                                         size_t*                               workspaceSizes)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_sharded_get_workspace((const rocsparselt_handle* const*)handles,
+                                                 (const rocsparselt_matmul_plan* const*)plans,
+                                                 numShards,
+                                                 HIPShardSplitToRocSparseLtShardSplit(split),
+                                                 workspaceSizes));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulSharded(const hipsparseLtHandle_t* const*     handles,
+                                           const hipsparseLtMatmulPlan_t* const* plans,
+                                           int32_t                               numShards,
+                                           hipsparseLtShardSplit_t               split,
+                                           const void*                           alpha,
+                                           const void* const*                    d_A,
+                                           const void* const*                    d_B,
+                                           const void*                           beta,
+                                           const void* const*                    d_C,
+                                           void* const*                          d_D,
+                                           void* const*                          workspaces,
+                                           hipStream_t*                          streams)
+try
+{
+    rocsparselt_roctx_range range(__func__, numShards);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_sharded((const rocsparselt_handle* const*)handles,
+                                   (const rocsparselt_matmul_plan* const*)plans,
+                                   numShards,
+                                   HIPShardSplitToRocSparseLtShardSplit(split),
+                                   alpha,
+                                   d_A,
+                                   d_B,
+                                   beta,
+                                   d_C,
+                                   d_D,
+                                   workspaces,
+                                   streams));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulPointerArray(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan,
+                                                const void*                    alpha,
+                                                const void*                    d_compressed,
+                                                const void* const*             d_dense,
+                                                const void*                    beta,
+                                                const void* const*             d_C,
+                                                void* const*                   d_D,
+                                                void*                          workspace,
+                                                hipStream_t*                   streams,
+                                                int32_t                        numStreams)
+try
+{
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_plan*)plan);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_pointer_array((const rocsparselt_handle*)handle,
+                                         (const rocsparselt_matmul_plan*)plan,
+                                         alpha,
+                                         d_compressed,
+                                         d_dense,
+                                         beta,
+                                         d_C,
+                                         d_D,
+                                         workspace,
+                                         streams,
+                                         numStreams));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtMatmulDynamicN(const hipsparseLtHandle_t*     handle,
+                                            const hipsparseLtMatmulPlan_t* plan,
+                                            int64_t                        n,
+                                            const void*                    alpha,
+                                            const void*                    d_A,
+                                            const void*                    d_B,
+                                            const void*                    beta,
+                                            const void*                    d_C,
+                                            void*                          d_D,
+                                            void*                          workspace,
+                                            hipStream_t*                   streams,
+                                            int32_t                        numStreams)
+try
+{
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_plan*)plan);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_matmul_dynamic_n((const rocsparselt_handle*)handle,
+                                     (const rocsparselt_matmul_plan*)plan,
+                                     n,
+                                     alpha,
+                                     d_A,
+                                     d_B,
+                                     beta,
+                                     d_C,
+                                     d_D,
+                                     workspace,
+                                     streams,
+                                     numStreams));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 /* helper */
 // prune
 hipsparseStatus_t hipsparseLtSpMMAPrune(const hipsparseLtHandle_t*           handle,
@@ -880,6 +1370,7 @@ hipsparseStatus_t hipsparseLtSpMMAPrune(const hipsparseLtHandle_t*           han
                                         hipStream_t                          stream)
 try
 {
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_descr*)matmulDescr);
     return RocSparseLtStatusToHIPStatus(
         rocsparselt_smfmac_prune((const rocsparselt_handle*)handle,
                                  (const rocsparselt_matmul_descr*)matmulDescr,
@@ -900,6 +1391,7 @@ hipsparseStatus_t hipsparseLtSpMMAPruneCheck(const hipsparseLtHandle_t*
                                              hipStream_t                          stream)
 try
 {
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_descr*)matmulDescr);
     return RocSparseLtStatusToHIPStatus(
         rocsparselt_smfmac_prune_check((const rocsparselt_handle*)handle,
                                        (const rocsparselt_matmul_descr*)matmulDescr,
@@ -922,6 +1414,7 @@ hipsparseStatus_t hipsparseLtSpMMAPrune2(const hipsparseLtHandle_t*        handl
                                          hipStream_t                       stream)
 try
 {
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_mat_descr*)sparseMatDescr);
     return RocSparseLtStatusToHIPStatus(
         rocsparselt_smfmac_prune2((const rocsparselt_handle*)handle,
                                   (const rocsparselt_mat_descr*)sparseMatDescr,
@@ -946,6 +1439,7 @@ hipsparseStatus_t hipsparseLtSpMMAPruneCheck2(const hipsparseLtHandle_t*
                                               hipStream_t                       stream)
 try
 {
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_mat_descr*)sparseMatDescr);
     return RocSparseLtStatusToHIPStatus(
         rocsparselt_smfmac_prune_check2((const rocsparselt_handle*)handle,
                                         (const rocsparselt_mat_descr*)sparseMatDescr,
@@ -960,6 +1454,118 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+hipsparseStatus_t hipsparseLtSpMMAPruneCheckCount(const hipsparseLtHandle_t*           handle,
+                                                  const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                                  const void*                          d_in,
+                                                  int64_t*                             d_count,
+                                                  int64_t*                             d_offsets,
+                                                  int                                  maxOffsets,
+                                                  hipStream_t                          stream)
+try
+{
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_descr*)matmulDescr);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_prune_check_count((const rocsparselt_handle*)handle,
+                                             (const rocsparselt_matmul_descr*)matmulDescr,
+                                             d_in,
+                                             d_count,
+                                             d_offsets,
+                                             maxOffsets,
+                                             stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMAPruneMaskSize(const hipsparseLtHandle_t*           handle,
+                                                const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                                size_t*                              maskSize)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_prune_mask_size((const rocsparselt_handle*)handle,
+                                           (const rocsparselt_matmul_descr*)matmulDescr,
+                                           maskSize));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMAPruneMask(const hipsparseLtHandle_t*           handle,
+                                            const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                            const void*                          d_in,
+                                            void*                                d_out,
+                                            void*                                d_mask,
+                                            hipsparseLtPruneAlg_t                pruneAlg,
+                                            hipStream_t                          stream)
+try
+{
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_descr*)matmulDescr);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_prune_mask((const rocsparselt_handle*)handle,
+                                      (const rocsparselt_matmul_descr*)matmulDescr,
+                                      d_in,
+                                      d_out,
+                                      d_mask,
+                                      HIPPruneAlgToRocSparseLtPruneAlg(pruneAlg),
+                                      stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMAMaskApply(const hipsparseLtHandle_t*           handle,
+                                            const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                            const void*                          d_in,
+                                            void*                                d_out,
+                                            const void*                          d_mask,
+                                            hipStream_t                          stream)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_mask_apply((const rocsparselt_handle*)handle,
+                                      (const rocsparselt_matmul_descr*)matmulDescr,
+                                      d_in,
+                                      d_out,
+                                      d_mask,
+                                      stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMAPruneScored(const hipsparseLtHandle_t*           handle,
+                                              const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                              const void*                          d_in,
+                                              void*                                d_out,
+                                              const float*                         d_score,
+                                              const float*                         d_colScale,
+                                              void*                                d_mask,
+                                              hipsparseLtPruneAlg_t                pruneAlg,
+                                              hipStream_t                          stream)
+try
+{
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_descr*)matmulDescr);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_prune_scored((const rocsparselt_handle*)handle,
+                                        (const rocsparselt_matmul_descr*)matmulDescr,
+                                        d_in,
+                                        d_out,
+                                        d_score,
+                                        d_colScale,
+                                        d_mask,
+                                        HIPPruneAlgToRocSparseLtPruneAlg(pruneAlg),
+                                        stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 // compression
 hipsparseStatus_t hipsparseLtSpMMACompressedSize(const hipsparseLtHandle_t*     handle,
                                                  const hipsparseLtMatmulPlan_t* plan,
@@ -986,6 +1592,7 @@ hipsparseStatus_t hipsparseLtSpMMACompress(const hipsparseLtHandle_t*     handle
                                            hipStream_t                    stream)
 try
 {
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_plan*)plan);
     return RocSparseLtStatusToHIPStatus(
         rocsparselt_smfmac_compress((const rocsparselt_handle*)handle,
                                     (const rocsparselt_matmul_plan*)plan,
@@ -999,6 +1606,33 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+hipsparseStatus_t
+    hipsparseLtSpMMACompressSharded(const hipsparseLtHandle_t* const*     handles,
+                                    const hipsparseLtMatmulPlan_t* const* plans,
+                                    int32_t                               numShards,
+                                    hipsparseLtShardSplit_t               split,
+                                    const void* const*                    d_dense,
+                                    void* const*                          d_compressed,
+                                    void* const*                          d_compressBuffer,
+                                    hipStream_t*                          streams)
+try
+{
+    rocsparselt_roctx_range range(__func__, numShards);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_compress_sharded((const rocsparselt_handle* const*)handles,
+                                            (const rocsparselt_matmul_plan* const*)plans,
+                                            numShards,
+                                            HIPShardSplitToRocSparseLtShardSplit(split),
+                                            d_dense,
+                                            d_compressed,
+                                            d_compressBuffer,
+                                            streams));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 hipsparseStatus_t hipsparseLtSpMMACompressedSize2(const hipsparseLtHandle_t*        handle,
                                                   const hipsparseLtMatDescriptor_t* sparseMatDescr,
                                                   size_t*                           compressedSize,
@@ -1026,6 +1660,7 @@ hipsparseStatus_t hipsparseLtSpMMACompress2(const hipsparseLtHandle_t*        ha
                                             hipStream_t                       stream)
 try
 {
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_mat_descr*)sparseMatDescr);
     return RocSparseLtStatusToHIPStatus(
         rocsparselt_smfmac_compress2((const rocsparselt_handle*)handle,
                                      (const rocsparselt_mat_descr*)sparseMatDescr,
@@ -1041,11 +1676,513 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+hipsparseStatus_t hipsparseLtSpMMAPruneAndCompress(const hipsparseLtHandle_t*     handle,
+                                                   const hipsparseLtMatmulPlan_t* plan,
+                                                   const void*                    d_dense,
+                                                   void*                          d_compressed,
+                                                   void*                          d_compressBuffer,
+                                                   hipsparseLtPruneAlg_t          pruneAlg,
+                                                   hipStream_t                    stream)
+try
+{
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_plan*)plan);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_prune_and_compress((const rocsparselt_handle*)handle,
+                                              (const rocsparselt_matmul_plan*)plan,
+                                              d_dense,
+                                              d_compressed,
+                                              d_compressBuffer,
+                                              HIPPruneAlgToRocSparseLtPruneAlg(pruneAlg),
+                                              stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMAPruneAndCompressTransposable(const hipsparseLtHandle_t*        handle,
+                                                 const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                                 int                               isSparseA,
+                                                 const void*                       d_in,
+                                                 void*                             d_out,
+                                                 void*                             d_compressed,
+                                                 void*                             d_compressedT,
+                                                 hipStream_t                       stream)
+try
+{
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_mat_descr*)sparseMatDescr);
+    return RocSparseLtStatusToHIPStatus(rocsparselt_smfmac_prune_and_compress_transposable(
+        (const rocsparselt_handle*)handle,
+        (const rocsparselt_mat_descr*)sparseMatDescr,
+        isSparseA,
+        d_in,
+        d_out,
+        d_compressed,
+        d_compressedT,
+        stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMAGroupedWorkListSize(const hipsparseLtHandle_t* handle,
+                                                      int                        groupCount,
+                                                      size_t*                    workListSize)
+try
+{
+    return RocSparseLtStatusToHIPStatus(rocsparselt_smfmac_grouped_work_list_size(
+        (const rocsparselt_handle*)handle, groupCount, workListSize));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMAPrune2Grouped(const hipsparseLtHandle_t*               handle,
+                                  int                                      groupCount,
+                                  const hipsparseLtMatDescriptor_t* const* sparseMatDescrs,
+                                  int                                      isSparseA,
+                                  hipsparseOperation_t                     op,
+                                  const void* const*                       d_in,
+                                  void* const*                             d_out,
+                                  hipsparseLtPruneAlg_t                    pruneAlg,
+                                  void*                                    d_workList,
+                                  hipStream_t                              stream)
+try
+{
+    rocsparselt_roctx_range range(__func__, groupCount);
+    return RocSparseLtStatusToHIPStatus(rocsparselt_smfmac_prune2_grouped(
+        (const rocsparselt_handle*)handle,
+        groupCount,
+        (const rocsparselt_mat_descr* const*)sparseMatDescrs,
+        isSparseA,
+        HIPOperationToHCCOperation(op),
+        d_in,
+        d_out,
+        HIPPruneAlgToRocSparseLtPruneAlg(pruneAlg),
+        d_workList,
+        stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMACompress2Grouped(const hipsparseLtHandle_t*               handle,
+                                     int                                      groupCount,
+                                     const hipsparseLtMatDescriptor_t* const* sparseMatDescrs,
+                                     int                                      isSparseA,
+                                     hipsparseOperation_t                     op,
+                                     const void* const*                       d_dense,
+                                     void* const*                             d_compressed,
+                                     void*                                    d_workList,
+                                     hipStream_t                              stream)
+try
+{
+    rocsparselt_roctx_range range(__func__, groupCount);
+    return RocSparseLtStatusToHIPStatus(rocsparselt_smfmac_compress2_grouped(
+        (const rocsparselt_handle*)handle,
+        groupCount,
+        (const rocsparselt_mat_descr* const*)sparseMatDescrs,
+        isSparseA,
+        HIPOperationToHCCOperation(op),
+        d_dense,
+        d_compressed,
+        d_workList,
+        stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedSizeHost(int64_t               rows,
+                                                     int64_t               cols,
+                                                     int64_t               ld,
+                                                     hipsparseLtDatatype_t valueType,
+                                                     int                   numBatches,
+                                                     int64_t               batchStride,
+                                                     int                   isSparseA,
+                                                     hipsparseOperation_t  op,
+                                                     size_t*               compressedSize)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_compressed_size_host(rows,
+                                                cols,
+                                                ld,
+                                                HIPDatatypeToRocSparseLtDatatype(valueType),
+                                                numBatches,
+                                                batchStride,
+                                                isSparseA,
+                                                HIPOperationToHCCOperation(op),
+                                                compressedSize));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMAPruneHost(int64_t               rows,
+                                            int64_t               cols,
+                                            int64_t               ld,
+                                            hipsparseLtDatatype_t valueType,
+                                            int                   numBatches,
+                                            int64_t               batchStride,
+                                            int                   isSparseA,
+                                            hipsparseOperation_t  op,
+                                            const void*           h_in,
+                                            void*                 h_out,
+                                            hipsparseLtPruneAlg_t pruneAlg,
+                                            int                   numThreads)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_prune_host(rows,
+                                      cols,
+                                      ld,
+                                      HIPDatatypeToRocSparseLtDatatype(valueType),
+                                      numBatches,
+                                      batchStride,
+                                      isSparseA,
+                                      HIPOperationToHCCOperation(op),
+                                      h_in,
+                                      h_out,
+                                      HIPPruneAlgToRocSparseLtPruneAlg(pruneAlg),
+                                      numThreads));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressHost(int64_t               rows,
+                                               int64_t               cols,
+                                               int64_t               ld,
+                                               hipsparseLtDatatype_t valueType,
+                                               int                   numBatches,
+                                               int64_t               batchStride,
+                                               int                   isSparseA,
+                                               hipsparseOperation_t  op,
+                                               const void*           h_dense,
+                                               void*                 h_compressed,
+                                               int                   numThreads)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_compress_host(rows,
+                                         cols,
+                                         ld,
+                                         HIPDatatypeToRocSparseLtDatatype(valueType),
+                                         numBatches,
+                                         batchStride,
+                                         isSparseA,
+                                         HIPOperationToHCCOperation(op),
+                                         h_dense,
+                                         h_compressed,
+                                         numThreads));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMADecompress(const hipsparseLtHandle_t*     handle,
+                                             const hipsparseLtMatmulPlan_t* plan,
+                                             const void*                    d_compressed,
+                                             void*                          d_dense,
+                                             hipStream_t                    stream)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_decompress((const rocsparselt_handle*)handle,
+                                      (const rocsparselt_matmul_plan*)plan,
+                                      d_compressed,
+                                      d_dense,
+                                      stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMADecompress2(const hipsparseLtHandle_t*        handle,
+                                              const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                              int                               isSparseA,
+                                              hipsparseOperation_t              op,
+                                              const void*                       d_compressed,
+                                              void*                             d_dense,
+                                              hipStream_t                       stream)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_decompress2((const rocsparselt_handle*)handle,
+                                       (const rocsparselt_mat_descr*)sparseMatDescr,
+                                       isSparseA,
+                                       HIPOperationToHCCOperation(op),
+                                       d_compressed,
+                                       d_dense,
+                                       stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMACompressedUpdateStateSize(const hipsparseLtHandle_t*     handle,
+                                              const hipsparseLtMatmulPlan_t* plan,
+                                              size_t*                        stateSize)
+try
+{
+    return RocSparseLtStatusToHIPStatus(rocsparselt_smfmac_compressed_update_state_size(
+        (const rocsparselt_handle*)handle, (const rocsparselt_matmul_plan*)plan, stateSize));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedUpdate(const hipsparseLtHandle_t*          handle,
+                                                   const hipsparseLtMatmulPlan_t*      plan,
+                                                   const hipsparseLtOptimizerParams_t* params,
+                                                   void*                               d_compressed,
+                                                   const void*                         d_grad,
+                                                   float*                              d_state1,
+                                                   float*                              d_state2,
+                                                   hipStream_t                         stream)
+try
+{
+    if(params == nullptr)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+
+    rocsparselt_optimizer_params rocsparselt_params;
+    rocsparselt_params.optimizer    = HIPOptimizerToRocSparseLtOptimizer(params->optimizer);
+    rocsparselt_params.lr           = params->lr;
+    rocsparselt_params.beta1        = params->beta1;
+    rocsparselt_params.beta2        = params->beta2;
+    rocsparselt_params.eps          = params->eps;
+    rocsparselt_params.weight_decay = params->weight_decay;
+    rocsparselt_params.step         = params->step;
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_compressed_update((const rocsparselt_handle*)handle,
+                                             (const rocsparselt_matmul_plan*)plan,
+                                             &rocsparselt_params,
+                                             d_compressed,
+                                             d_grad,
+                                             d_state1,
+                                             d_state2,
+                                             stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedInt4Size(const hipsparseLtHandle_t*     handle,
+                                                     const hipsparseLtMatmulPlan_t* plan,
+                                                     int64_t                        groupSize,
+                                                     size_t*                        packedSize)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_compressed_int4_size((const rocsparselt_handle*)handle,
+                                                (const rocsparselt_matmul_plan*)plan,
+                                                groupSize,
+                                                packedSize));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedInt4Pack(const hipsparseLtHandle_t*     handle,
+                                                     const hipsparseLtMatmulPlan_t* plan,
+                                                     int64_t                        groupSize,
+                                                     const void*                    d_compressed,
+                                                     void*                          d_packed,
+                                                     hipStream_t                    stream)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_compressed_int4_pack((const rocsparselt_handle*)handle,
+                                                (const rocsparselt_matmul_plan*)plan,
+                                                groupSize,
+                                                d_compressed,
+                                                d_packed,
+                                                stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedInt4Unpack(const hipsparseLtHandle_t*     handle,
+                                                       const hipsparseLtMatmulPlan_t* plan,
+                                                       int64_t                        groupSize,
+                                                       const void*                    d_packed,
+                                                       void*                          d_compressed,
+                                                       hipStream_t                    stream)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_compressed_int4_unpack((const rocsparselt_handle*)handle,
+                                                  (const rocsparselt_matmul_plan*)plan,
+                                                  groupSize,
+                                                  d_packed,
+                                                  d_compressed,
+                                                  stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressRows(const hipsparseLtHandle_t*     handle,
+                                               const hipsparseLtMatmulPlan_t* plan,
+                                               const void*                    d_dense,
+                                               void*                          d_compressed,
+                                               int                            rangeCount,
+                                               const int64_t*                 rowRanges,
+                                               void*                          d_workList,
+                                               hipStream_t                    stream)
+try
+{
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_matmul_plan*)plan);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_compress_rows((const rocsparselt_handle*)handle,
+                                         (const rocsparselt_matmul_plan*)plan,
+                                         d_dense,
+                                         d_compressed,
+                                         rangeCount,
+                                         rowRanges,
+                                         d_workList,
+                                         stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMACompress2Streamed(const hipsparseLtHandle_t*        handle,
+                                      const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                      int                               isSparseA,
+                                      hipsparseOperation_t              op,
+                                      const void*                       dense,
+                                      void*                             d_compressed,
+                                      void*                             d_panelBuffer,
+                                      size_t                            panelBufferSize,
+                                      hipStream_t                       stream)
+try
+{
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_mat_descr*)sparseMatDescr);
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_compress2_streamed((const rocsparselt_handle*)handle,
+                                              (const rocsparselt_mat_descr*)sparseMatDescr,
+                                              isSparseA,
+                                              HIPOperationToHCCOperation(op),
+                                              dense,
+                                              d_compressed,
+                                              d_panelBuffer,
+                                              panelBufferSize,
+                                              stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMAPruneAndCompressStreamed(const hipsparseLtHandle_t*        handle,
+                                             const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                             int                               isSparseA,
+                                             hipsparseOperation_t              op,
+                                             const void*                       dense,
+                                             void*                             d_compressed,
+                                             void*                             d_panelBuffer,
+                                             size_t                            panelBufferSize,
+                                             hipsparseLtPruneAlg_t             pruneAlg,
+                                             float*                            bandwidth,
+                                             hipStream_t                       stream)
+try
+{
+    rocsparselt_roctx_range range(__func__, (const rocsparselt_mat_descr*)sparseMatDescr);
+    return RocSparseLtStatusToHIPStatus(rocsparselt_smfmac_prune_and_compress_streamed(
+        (const rocsparselt_handle*)handle,
+        (const rocsparselt_mat_descr*)sparseMatDescr,
+        isSparseA,
+        HIPOperationToHCCOperation(op),
+        dense,
+        d_compressed,
+        d_panelBuffer,
+        panelBufferSize,
+        HIPPruneAlgToRocSparseLtPruneAlg(pruneAlg),
+        bandwidth,
+        stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedSave(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 const void*                    d_compressed,
+                                                 const char*                    path,
+                                                 hipStream_t                    stream)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_compressed_save((const rocsparselt_handle*)handle,
+                                           (const rocsparselt_matmul_plan*)plan,
+                                           d_compressed,
+                                           path,
+                                           stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedLoad(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 const char*                    path,
+                                                 void*                          d_compressed,
+                                                 hipStream_t                    stream)
+try
+{
+    return RocSparseLtStatusToHIPStatus(
+        rocsparselt_smfmac_compressed_load((const rocsparselt_handle*)handle,
+                                           (const rocsparselt_matmul_plan*)plan,
+                                           path,
+                                           d_compressed,
+                                           stream));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 void hipsparseLtInitialize()
 {
     rocsparselt_initialize();
 }
 
+hipsparseStatus_t hipsparseLtInitDevices(uint64_t deviceMask)
+try
+{
+    return RocSparseLtStatusToHIPStatus(rocsparselt_init_devices(deviceMask));
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 hipsparseStatus_t hipsparseLtGetVersion(const hipsparseLtHandle_t* handle, int* version)
 try
 {
@@ -1059,6 +2196,50 @@ catch(...)
     return exception_to_hipsparselt_status();
 }
 
+hipsparseStatus_t hipsparseLtGetConfigCacheStats(const hipsparseLtHandle_t*     handle,
+                                                 hipsparseLtConfigCacheStats_t* stats)
+try
+{
+    if(stats == nullptr)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+
+    rocsparselt_config_cache_stats rocsparselt_stats;
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_get_config_cache_stats(
+        (const rocsparselt_handle*)handle, &rocsparselt_stats));
+    stats->hits      = rocsparselt_stats.hits;
+    stats->misses    = rocsparselt_stats.misses;
+    stats->evictions = rocsparselt_stats.evictions;
+    stats->entries   = rocsparselt_stats.entries;
+    stats->capacity  = rocsparselt_stats.capacity;
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
+hipsparseStatus_t hipsparseLtGetCodeObjectStats(const hipsparseLtHandle_t*    handle,
+                                                hipsparseLtCodeObjectStats_t* stats)
+try
+{
+    if(stats == nullptr)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+
+    rocsparselt_code_object_stats rocsparselt_stats;
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_get_code_object_stats(
+        (const rocsparselt_handle*)handle, &rocsparselt_stats));
+    stats->bytes     = rocsparselt_stats.bytes;
+    stats->modules   = rocsparselt_stats.modules;
+    stats->pinned    = rocsparselt_stats.pinned;
+    stats->evictions = rocsparselt_stats.evictions;
+    stats->capacity  = rocsparselt_stats.capacity;
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+catch(...)
+{
+    return exception_to_hipsparselt_status();
+}
+
 hipsparseStatus_t hipsparseLtGetPorperty(hipLibraryPropertyType propertyType, int* value)
 try
 {
@@ -384,6 +384,80 @@ rocsparselt_status
                                  const rocsparselt_matmul_descr*         matmulDescr,
                                  const rocsparselt_matmul_alg_selection* algSelection);
 
+/*! \ingroup aux_module
+ *  \brief Initializes the algorithm selection and the plan in the background
+ *  \details
+ *  \p rocsparselt_matmul_plan_init_async runs rocsparselt_matmul_alg_selection_init() and
+ *  rocsparselt_matmul_plan_init() for \p matmulDescr on a thread of the handle, and loads the
+ *  code objects of the selected config, but returns immediately. The initializations of many
+ *  plans run concurrently, on up to HIPSPARSELT_INIT_THREADS threads (the hardware threads by
+ *  default). rocsparselt_matmul_plan_init_wait() waits for the plan and
+ *  rocsparselt_matmul_plan_init_query() polls it.
+ *
+ *  \note
+ *  \p matmulDescr is copied before the function returns. \p algSelection must not be used
+ *  before the plan is ready. The functions given \p plan, rocsparselt_matmul() included, wait
+ *  for it; they return rocsparselt_status_invalid_handle when its initialization failed.
+ *
+ *  @param[in]
+ *  handle          rocsparselt library handle
+ *  @param[out]
+ *  plan            the matrix multiplication plan descriptor
+ *  algSelection    the algorithm selection descriptor
+ *  @param[in]
+ *  matmulDescr     the matrix multiplication descriptor
+ *  alg             the algorithm used to do the matrix multiplication
+ *
+ *  \retval rocsparselt_status_success the initialization was started successfully.
+ *  \retval rocsparselt_status_invalid_pointer \p plan or \p algSelection pointer is invalid.
+ *  \retval rocsparselt_status_invalid_handle \p handle or \p matmulDescr is invalid.
+ *  \retval rocsparselt_status_invalid_value an initialization of \p plan is already running.
+ */
+rocsparselt_status
+    rocsparselt_matmul_plan_init_async(const rocsparselt_handle*         handle,
+                                       rocsparselt_matmul_plan*          plan,
+                                       rocsparselt_matmul_alg_selection* algSelection,
+                                       const rocsparselt_matmul_descr*   matmulDescr,
+                                       rocsparselt_matmul_alg            alg);
+
+/*! \ingroup aux_module
+ *  \brief Wait for the background initialization of a plan
+ *  \details
+ *  \p rocsparselt_matmul_plan_init_wait blocks until the initialization started by
+ *  rocsparselt_matmul_plan_init_async() for \p plan completes, and returns its status.
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plan        the matrix multiplication plan descriptor
+ *
+ *  \retval rocsparselt_status_success the plan was not initialized in the background or its
+ *          initialization completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ */
+rocsparselt_status rocsparselt_matmul_plan_init_wait(const rocsparselt_handle*      handle,
+                                                     const rocsparselt_matmul_plan* plan);
+
+/*! \ingroup aux_module
+ *  \brief Poll the background initialization of a plan
+ *  \details
+ *  \p rocsparselt_matmul_plan_init_query sets \p ready to 1 when the initialization started by
+ *  rocsparselt_matmul_plan_init_async() for \p plan completed, rocsparselt_matmul_plan_init_wait()
+ *  then returns its status at once, and to 0 while it runs.
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plan        the matrix multiplication plan descriptor
+ *  @param[out]
+ *  ready       1 when the plan is ready, 0 otherwise
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval rocsparselt_status_invalid_pointer \p ready pointer is invalid.
+ */
+rocsparselt_status rocsparselt_matmul_plan_init_query(const rocsparselt_handle*      handle,
+                                                      const rocsparselt_matmul_plan* plan,
+                                                      int*                           ready);
+
 /*! \ingroup aux_module
  *  \brief Destroy a matrix multiplication plan descriptor
  *  \details
@@ -399,6 +473,135 @@ rocsparselt_status
  */
 rocsparselt_status rocsparselt_matmul_plan_destroy(const rocsparselt_matmul_plan* plan);
 
+/*! \ingroup aux_module
+ *  \brief Serialize a matrix multiplication plan
+ *  \details
+ *  \p rocsparselt_matmul_plan_serialize writes the signature of the problem of \p plan, the
+ *  configs of its algorithm selection, the selected config and the name of its kernel to \p data,
+ *  after a header which records the version of the library and the architecture of the device.
+ *  When \p data is NULL, only the size of the serialized plan is returned in \p dataSize.
+ *
+ *  @param[in]
+ *  handle   rocsparselt library handle
+ *  plan     the matrix multiplication plan descriptor
+ *
+ *  @param[out]
+ *  data     the serialized plan, or NULL
+ *
+ *  @param[inout]
+ *  dataSize the size of \p data in bytes, which is set to the size of the serialized plan
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval rocsparselt_status_invalid_pointer \p dataSize pointer is invalid.
+ *  \retval rocsparselt_status_invalid_size \p dataSize is smaller than the serialized plan.
+ */
+rocsparselt_status rocsparselt_matmul_plan_serialize(const rocsparselt_handle*      handle,
+                                                     const rocsparselt_matmul_plan* plan,
+                                                     void*                          data,
+                                                     size_t*                        dataSize);
+
+/*! \ingroup aux_module
+ *  \brief Initializes a matrix multiplication plan from a serialized plan
+ *  \details
+ *  \p rocsparselt_matmul_plan_deserialize initializes \p algSelection with the configs saved by
+ *  rocsparselt_matmul_plan_serialize(), without looking them up in the library, and then \p plan
+ *  as rocsparselt_matmul_plan_init() does. \p matmulDescr must describe the problem of the saved
+ *  plan. Only the code object of the selected kernel is loaded. Both \p plan and \p algSelection
+ *  should be destroyed at the end.
+ *
+ *  @param[in]
+ *  handle       rocsparselt library handle
+ *  matmulDescr  the matrix multiplication descriptor
+ *  data         the serialized plan
+ *  dataSize     the size of \p data in bytes
+ *
+ *  @param[out]
+ *  plan         the matrix multiplication plan descriptor
+ *  algSelection the algorithm selection descriptor
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p handle or \p matmulDescr is invalid.
+ *  \retval rocsparselt_status_invalid_pointer \p plan , \p algSelection or \p data pointer is invalid.
+ *  \retval rocsparselt_status_invalid_value \p data is not a serialized plan of \p matmulDescr, or was
+ *  serialized by another version of the library, on another architecture.
+ *  \retval rocsparselt_status_not_implemented \p data has a newer version.
+ */
+rocsparselt_status
+    rocsparselt_matmul_plan_deserialize(const rocsparselt_handle*         handle,
+                                        rocsparselt_matmul_plan*          plan,
+                                        const rocsparselt_matmul_descr*   matmulDescr,
+                                        rocsparselt_matmul_alg_selection* algSelection,
+                                        const void*                       data,
+                                        size_t                            dataSize);
+
+/*! \ingroup aux_module
+ *  \brief Retrieve the counters of the matrix multiplications of a plan
+ *  \details
+ *  \p rocsparselt_matmul_plan_get_stats returns the calls of \p plan, their host time and
+ *  workspace, the GPU time of the sampled calls and the kernel of the selected config.
+ *  The counters are kept when HIPSPARSELT_PLAN_STATS sets a sampling rate N when the plan is
+ *  initialized, one call in N is timed by events read once they completed.
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plan        the matrix multiplication plan descriptor
+ *
+ *  @param[out]
+ *  stats       the counters of \p plan
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval rocsparselt_status_invalid_pointer \p stats pointer is invalid.
+ *  \retval rocsparselt_status_not_implemented the plan keeps no counters.
+ */
+rocsparselt_status rocsparselt_matmul_plan_get_stats(const rocsparselt_handle*      handle,
+                                                     const rocsparselt_matmul_plan* plan,
+                                                     rocsparselt_matmul_plan_stats* stats);
+
+/*! \ingroup aux_module
+ *  \brief Retrieve the statistics of the config cache of a handle
+ *  \details
+ *  \p rocsparselt_get_config_cache_stats returns the hits, misses and evictions of the cache
+ *  which shares the configs found by rocsparselt_matmul_alg_selection_init() and the result
+ *  of rocsparselt_matmul_search() between the plans of identical problems. Its capacity is
+ *  set by the environment variable HIPSPARSELT_CONFIG_CACHE_SIZE.
+ *
+ *  @param[in]
+ *  handle  rocsparselt library handle
+ *
+ *  @param[out]
+ *  stats   statistics of the cache
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p handle is invalid.
+ *  \retval rocsparselt_status_invalid_pointer \p stats pointer is invalid.
+ */
+rocsparselt_status rocsparselt_get_config_cache_stats(const rocsparselt_handle*       handle,
+                                                      rocsparselt_config_cache_stats* stats);
+
+/*! \ingroup aux_module
+ *  \brief Retrieve the statistics of the code objects loaded on the device of a handle
+ *  \details
+ *  \p rocsparselt_get_code_object_stats returns the bytes of the code objects of the kernels
+ *  loaded for all the handles of the device of \p handle. Their capacity is set in MiB by the
+ *  environment variable HIPSPARSELT_CODE_OBJECT_CACHE_SIZE, the least recently used code
+ *  objects of no live plan are unloaded to stay under it.
+ *
+ *  @param[in]
+ *  handle  rocsparselt library handle
+ *
+ *  @param[out]
+ *  stats   statistics of the code objects
+ *
+ *  \retval rocsparselt_status_success the operation completed successfully.
+ *  \retval rocsparselt_status_invalid_handle \p handle is invalid.
+ *  \retval rocsparselt_status_invalid_pointer \p stats pointer is invalid.
+ *  \retval rocsparselt_status_not_implemented the Tensile backend loads its code objects.
+ */
+rocsparselt_status rocsparselt_get_code_object_stats(const rocsparselt_handle*      handle,
+                                                     rocsparselt_code_object_stats* stats);
+
 #ifdef __cplusplus
 }
 #endif
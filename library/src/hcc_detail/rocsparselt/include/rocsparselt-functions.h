@@ -46,6 +46,22 @@ extern "C" {
  ******************************************************************************/
 void rocsparselt_initialize(void);
 
+/*! \brief Initialize rocSPARSELt on several HIP devices at once.
+    \details
+
+    `rocsparselt_init_devices()` performs the initialization of `rocsparselt_initialize()` for every device
+    whose bit is set in \p device_mask, bit i standing for HIP device i and 0 for all the visible devices.
+    The devices are initialized concurrently, the kernel library being loaded only once and shared by them.
+
+    @param[in]
+    device_mask   the devices to initialize.
+
+    \retval rocsparselt_status_success the devices were initialized.
+    \retval rocsparselt_status_invalid_value \p device_mask selects a device which does not exist.
+    \retval rocsparselt_status_internal_error the devices could not be queried or selected.
+ ******************************************************************************/
+rocsparselt_status rocsparselt_init_devices(uint64_t device_mask);
+
 /*
 * ===========================================================================
 *    SPARSE Matrix Multiplication
@@ -58,6 +74,11 @@ void rocsparselt_initialize(void);
  *  \p rocsparselt_matmul_get_workspace determines the required workspace size
  *  associated to the selected algorithm.
  *
+ *  \note
+ *  With HIPSPARSELT_WORKSPACE_POOL_SIZE set, a matrix multiplication given a NULL
+ *  workspace draws up to that size from a stream-ordered pool of the handle, and a
+ *  search given a NULL workspace also times the configs needing up to that size.
+ *
  *  @param[out]
  *  workspaceSize    Workspace size in bytes
  *
@@ -145,6 +166,22 @@ rocsparselt_status rocsparselt_matmul(const rocsparselt_handle*      handle,
  *  \note
  *  The number of iterations for the evaluation can be set by using
  *  rocsparselt_matmul_alg_set_attribute() with rocsparselt_matmul_search_iterations.
+ *  They make a budget of timed runs per algorithm which is spent in rounds of
+ *  successive halving: the clearly slower algorithms are dropped after a few runs and
+ *  the remaining runs go to the close contenders.
+ *
+ *  \note
+ *  The inputs stay in L2 and MALL between the timed runs, set
+ *  rocsparselt_matmul_search_flush_cache to 1 to time them cold like weights in production.
+ *
+ *  \note
+ *  The timings of the fastest configs can be retrieved with
+ *  rocsparselt_matmul_alg_get_attribute() and rocsparselt_matmul_search_results.
+ *
+ *  \note
+ *  With rocsparselt_matmul_search_dense set to 1, the search also times a dense path which
+ *  multiplies the compressed matrix without SMFMAC. When it is faster than the best config,
+ *  rocsparselt_matmul() runs it instead, rocsparselt_matmul_dense_selected then reads 1.
  *
  *  \note
 o*	The selected algorithm id can be retrieved by using
@@ -183,6 +220,424 @@ rocsparselt_status rocsparselt_matmul_search(const rocsparselt_handle* handle,
                                              hipStream_t*              streams,
                                              int32_t                   numStreams);
 
+/*! \ingroup spmm_module
+ *  \brief Start a background search of the fastest algorithm
+ *
+ *  \details
+ *  \p rocsparselt_matmul_search_async behaves as rocsparselt_matmul_search(), but returns
+ *  immediately. The search runs on a private stream and workspace of a host thread, and the
+ *  config_id of the \p plan is replaced atomically by the fastest one when it ends. Until then
+ *  rocsparselt_matmul() keeps using the current config_id.
+ *
+ *  \note
+ *  \p d_A, \p d_B and \p d_C are copied once the work already queued on \p stream is done,
+ *  they can be overwritten afterwards.
+ *
+ *  \note
+ *  Only the algorithms fitting in the workspace of the current config_id are evaluated.
+ *
+ *  \note
+ *  \p handle must stay valid until the search completes. rocsparselt_matmul_plan_destroy()
+ *  waits for it.
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plan        Matrix multiplication plan
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  d_A         Pointer to the structured matrix A
+ *  d_B         Pointer to the dense matrix B
+ *  beta        scalar \f$\beta\f$. (float)
+ *  d_C         Pointer to the dense matrix C
+ *  stream      HIP stream the inputs are ready on
+ *
+ *  \retval     rocsparselt_status_success the search was started successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p alpha, \p A, \p B, \p beta or \p C
+ *              pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value a search of \p plan is already running.
+ *  \retval     rocsparselt_status_memory_error the copies of the inputs cannot be allocated.
+ */
+rocsparselt_status rocsparselt_matmul_search_async(const rocsparselt_handle* handle,
+                                                   rocsparselt_matmul_plan*  plan,
+                                                   const void*               alpha,
+                                                   const void*               d_A,
+                                                   const void*               d_B,
+                                                   const void*               beta,
+                                                   const void*               d_C,
+                                                   hipStream_t               stream);
+
+/*! \ingroup spmm_module
+ *  \brief Wait for the background search of the fastest algorithm
+ *
+ *  \details
+ *  \p rocsparselt_matmul_search_wait blocks until the search started by
+ *  rocsparselt_matmul_search_async() for \p plan completes, and returns its status.
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plan        Matrix multiplication plan
+ *
+ *  \retval     rocsparselt_status_success no search is pending or it completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ */
+rocsparselt_status rocsparselt_matmul_search_wait(const rocsparselt_handle* handle,
+                                                  rocsparselt_matmul_plan*  plan);
+
+/*! \ingroup spmm_module
+ *  \brief Capture a sparse matrix dense matrix multiplication into a HIP graph
+ *
+ *  \details
+ *  \p rocsparselt_matmul_get_graph records the kernels rocsparselt_matmul would launch
+ *  for \p plan on \p stream into a new HIP graph, without executing them. The graph is
+ *  instantiated by the caller and replayed with rocsparselt_matmul_graph_launch().
+ *
+ *  \note
+ *  The caller owns the returned graph and must release it with hipGraphDestroy().
+ *
+ *  \note
+ *  \p stream must not be the null stream and must not be capturing already.
+ *
+ *  @param[out]
+ *  graph       The captured HIP graph.
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plan        Matrix multiplication plan
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  d_A         Pointer to the structured matrix A
+ *  d_B         Pointer to the dense matrix B
+ *  beta        scalar \f$\beta\f$. (float)
+ *  d_C         Pointer to the dense matrix C
+ *  d_D         Pointer to the dense matrix D
+ *  workspace   Pointor to the worksapce
+ *  stream      HIP stream used for the capture
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p alpha, \p A, \p B, \p beta, \p C, \p D
+ *              or \p graph pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value workspace or stream is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problme is not supported
+ */
+rocsparselt_status rocsparselt_matmul_get_graph(const rocsparselt_handle*      handle,
+                                                const rocsparselt_matmul_plan* plan,
+                                                const void*                    alpha,
+                                                const void*                    d_A,
+                                                const void*                    d_B,
+                                                const void*                    beta,
+                                                const void*                    d_C,
+                                                void*                          d_D,
+                                                void*                          workspace,
+                                                hipStream_t                    stream,
+                                                hipGraph_t*                    graph);
+
+/*! \ingroup spmm_module
+ *  \brief Replay a sparse matrix dense matrix multiplication graph
+ *
+ *  \details
+ *  \p rocsparselt_matmul_graph_launch launches \p graphExec, instantiated from a graph
+ *  returned by rocsparselt_matmul_get_graph() for the same \p plan, on \p stream.
+ *  When the arguments or the selected algorithm differ from the ones \p graphExec was
+ *  last launched with, the kernel node parameters of \p graphExec are updated in place
+ *  with hipGraphExecUpdate() before the launch; otherwise the graph is launched as is.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *
+ *  \note
+ *  Launching graphs of the same plan from several threads at once is not supported.
+ *
+ *  @param[out]
+ *  d_D         Pointer to the dense matrix D
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plan        Matrix multiplication plan
+ *  graphExec   Executable graph instantiated from the graph of \p plan
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  d_A         Pointer to the structured matrix A
+ *  d_B         Pointer to the dense matrix B
+ *  beta        scalar \f$\beta\f$. (float)
+ *  d_C         Pointer to the dense matrix C
+ *  workspace   Pointor to the worksapce
+ *  stream      HIP stream for the computation
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p alpha, \p A, \p B, \p beta, \p C, \p D
+ *              or \p graphExec pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value workspace or stream is invalid, or
+ *              \p graphExec can not be updated with the new arguments.
+ *  \retval     rocsparselt_status_not_implemented the problme is not supported
+ */
+rocsparselt_status rocsparselt_matmul_graph_launch(const rocsparselt_handle* handle,
+                                                   rocsparselt_matmul_plan*  plan,
+                                                   hipGraphExec_t            graphExec,
+                                                   const void*               alpha,
+                                                   const void*               d_A,
+                                                   const void*               d_B,
+                                                   const void*               beta,
+                                                   const void*               d_C,
+                                                   void*                     d_D,
+                                                   void*                     workspace,
+                                                   hipStream_t               stream);
+
+/*! \ingroup spmm_module
+ *  \brief Grouped sparse matrix dense matrix multiplication
+ *
+ *  \details
+ *  \p rocsparselt_matmul_grouped runs \p groupCount independent matrix multiplications,
+ *  one per plan of \p plans, with a single call. The plans may describe different
+ *  shapes. All the groups are validated before any of them is launched. The groups are
+ *  distributed over \p streams, the largest ones first, each on the least loaded stream,
+ *  and the other streams are joined back to streams[0] before the function returns.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *
+ *  \note
+ *  Each group is launched with the kernels of its own plan, the groups therefore run
+ *  concurrently only when more than one stream is given.
+ *
+ *  @param[out]
+ *  d_D         Array of \p groupCount pointers to the dense matrices D
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plans       Array of \p groupCount matrix multiplication plans
+ *  groupCount  Number of groups
+ *  alpha       scalar \f$\alpha\f$ of all the groups. (float)
+ *  d_A         Array of \p groupCount pointers to the matrices A
+ *  d_B         Array of \p groupCount pointers to the matrices B
+ *  beta        scalar \f$\beta\f$ of all the groups. (float)
+ *  d_C         Array of \p groupCount pointers to the dense matrices C
+ *  workspaces  Array of \p groupCount pointers to the workspaces, can be NULL when no plan
+ *              needs a workspace
+ *  streams     Pointer to HIP stream array for the computation
+ *  numStreams  Number of HIP streams in \p streams
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or one of \p plans is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p plans, \p alpha, \p A, \p B, \p beta,
+ *              \p C or \p D pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p groupCount, a workspace, streams or
+ *              numStreams are invalid
+ *  \retval     rocsparselt_status_not_implemented the problme is not supported
+ */
+rocsparselt_status rocsparselt_matmul_grouped(const rocsparselt_handle*             handle,
+                                              const rocsparselt_matmul_plan* const* plans,
+                                              int32_t                               groupCount,
+                                              const void*                           alpha,
+                                              const void* const*                    d_A,
+                                              const void* const*                    d_B,
+                                              const void*                           beta,
+                                              const void* const*                    d_C,
+                                              void* const*                          d_D,
+                                              void* const*                          workspaces,
+                                              hipStream_t*                          streams,
+                                              int32_t                               numStreams);
+
+/*! \ingroup spmm_module
+ *  \brief Provide the workspaces of a sharded matrix multiplication
+ *
+ *  \details
+ *  \p rocsparselt_matmul_sharded_get_workspace provides the size of the workspace of every
+ *  shard of the \ref rocsparselt_matmul_sharded of \p plans: the one of its plan, followed
+ *  for the first shard split along k by the partial products of the other shards.
+ *
+ *  @param[out]
+ *  workspaceSizes  Array of \p numShards sizes in bytes of the workspaces.
+ *
+ *  @param[in]
+ *  handles         Array of \p numShards handles, one per shard.
+ *  plans           Array of \p numShards plans, plans[i] created with handles[i].
+ *  numShards       Number of shards.
+ *  split           dimension the matrix multiplication is split along.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle one of \p handles or \p plans is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p workspaceSizes pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_size the shapes of the shards do not make a matrix
+ *              multiplication split along \p split.
+ *  \retval     rocsparselt_status_not_implemented the problem is not supported
+ */
+rocsparselt_status
+    rocsparselt_matmul_sharded_get_workspace(const rocsparselt_handle* const*      handles,
+                                             const rocsparselt_matmul_plan* const* plans,
+                                             int32_t                               numShards,
+                                             rocsparselt_shard_split               split,
+                                             size_t*                               workspaceSizes);
+
+/*! \ingroup spmm_module
+ *  \brief Tensor-parallel sparse matrix dense matrix multiplication over several devices
+ *
+ *  \details
+ *  \p rocsparselt_matmul_sharded runs the matmul of plans[i] on the device of handles[i]
+ *  and streams[i] for every shard of a matrix multiplication split along \p split, with a
+ *  single call. Split along the output, each shard computes its own part of D. Split along
+ *  k, the partial products of the other shards are copied into the workspace of the first
+ *  one as soon as they are done and summed into d_D[0], the sum is then copied to the D of
+ *  every other shard.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *
+ *  @param[out]
+ *  d_D         Array of \p numShards pointers to the dense matrices D
+ *
+ *  @param[in]
+ *  handles     Array of \p numShards handles, one per shard.
+ *  plans       Array of \p numShards plans, plans[i] created with handles[i].
+ *  numShards   Number of shards.
+ *  split       dimension the matrix multiplication is split along.
+ *  alpha       scalar \f$\alpha\f$ of all the shards. (float)
+ *  d_A         Array of \p numShards pointers to the matrices A
+ *  d_B         Array of \p numShards pointers to the matrices B
+ *  beta        scalar \f$\beta\f$, only added by the first shard split along k. (float)
+ *  d_C         Array of \p numShards pointers to the dense matrices C
+ *  workspaces  Array of \p numShards pointers to the workspaces of the sizes given by
+ *              \ref rocsparselt_matmul_sharded_get_workspace, can be NULL when no shard
+ *              needs one
+ *  streams     Array of \p numShards HIP streams, streams[i] on the device of handles[i].
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle one of \p handles or \p plans is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p alpha, \p A, \p B, \p beta, \p C,
+ *              \p D or \p streams pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p numShards or a workspace is invalid.
+ *  \retval     rocsparselt_status_invalid_size the shapes of the shards do not make a matrix
+ *              multiplication split along \p split.
+ *  \retval     rocsparselt_status_not_implemented the problem is not supported
+ */
+rocsparselt_status rocsparselt_matmul_sharded(const rocsparselt_handle* const*      handles,
+                                              const rocsparselt_matmul_plan* const* plans,
+                                              int32_t                               numShards,
+                                              rocsparselt_shard_split               split,
+                                              const void*                           alpha,
+                                              const void* const*                    d_A,
+                                              const void* const*                    d_B,
+                                              const void*                           beta,
+                                              const void* const*                    d_C,
+                                              void* const*                          d_D,
+                                              void* const*                          workspaces,
+                                              hipStream_t*                          streams);
+
+/*! \ingroup spmm_module
+ *  \brief Pointer-array batched sparse matrix dense matrix multiplication
+ *
+ *  \details
+ *  \p rocsparselt_matmul_pointer_array computes the batched matrix multiplication of
+ *  \p plan like \ref rocsparselt_matmul, except that every batch of the dense matrices
+ *  has its own pointer, so the batches need not be at a fixed stride of one allocation.
+ *  The compressed matrix keeps the batch stride of its descriptor. The batch strides of
+ *  the dense matrices are ignored.
+ *
+ *  \note
+ *  The pointer arrays are read on the host, they hold device pointers.
+ *
+ *  \note
+ *  Each batch is launched as its own matrix multiplication. The batches are distributed
+ *  over \p streams, unless the selected algorithm needs a workspace, and the other
+ *  streams are joined back to streams[0] before the function returns.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *
+ *  @param[out]
+ *  d_D          Array of num_batches pointers to the dense matrices D
+ *
+ *  @param[in]
+ *  handle       rocsparselt library handle
+ *  plan         Matrix multiplication plan
+ *  alpha        scalar \f$\alpha\f$. (float)
+ *  d_compressed Pointer to the compressed structured matrix, A or B
+ *  d_dense      Array of num_batches pointers to the dense matrix, B or A
+ *  beta         scalar \f$\beta\f$. (float)
+ *  d_C          Array of num_batches pointers to the dense matrices C
+ *  workspace    Pointor to the worksapce
+ *  streams      Pointer to HIP stream array for the computation
+ *  numStreams   Number of HIP streams in \p streams
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p alpha, \p d_compressed, \p d_dense,
+ *              \p beta, \p d_C, \p d_D or one of their pointers is invalid.
+ *  \retval     rocsparselt_status_invalid_value workspace, streams or numStreams are invalid
+ *  \retval     rocsparselt_status_not_implemented the problme is not supported
+ */
+rocsparselt_status rocsparselt_matmul_pointer_array(const rocsparselt_handle*      handle,
+                                                    const rocsparselt_matmul_plan* plan,
+                                                    const void*                    alpha,
+                                                    const void*                    d_compressed,
+                                                    const void* const*             d_dense,
+                                                    const void*                    beta,
+                                                    const void* const*             d_C,
+                                                    void* const*                   d_D,
+                                                    void*                          workspace,
+                                                    hipStream_t*                   streams,
+                                                    int32_t                        numStreams);
+
+/*! \ingroup spmm_module
+ *  \brief Sparse matrix dense matrix multiplication with a runtime N
+ *
+ *  \details
+ *  \p rocsparselt_matmul_dynamic_n computes the matrix multiplication of \p plan like
+ *  \ref rocsparselt_matmul, for the first \p n columns of B, C and D only. The
+ *  structured matrix A, its compression and the leading dimensions and batch strides of
+ *  the plan are kept, so the matrices allocated for the N of the plan serve every \p n.
+ *
+ *  The configs are selected per bucket of \p n: \p n is rounded up to a power of two,
+ *  and the first call of a bucket selects its configs like
+ *  \ref rocsparselt_matmul_alg_selection_init for that N, from the tuning database when
+ *  there is one. The configs whose workspace is larger than the one of the plan, see
+ *  \ref rocsparselt_matmul_get_workspace, are skipped, so that workspace serves every \p n.
+ *  When \p n is the N of the plan, the selected config of the plan is run.
+ *
+ *  \note
+ *  Only supported when A is the structured matrix. The batch count of the plan is kept.
+ *
+ *  \note
+ *  This function is non blocking and executed asynchronously with respect to the host.
+ *  It can be called from several threads with the same plan.
+ *
+ *  @param[out]
+ *  d_D         Pointer to the dense matrix D
+ *
+ *  @param[in]
+ *  handle      rocsparselt library handle
+ *  plan        Matrix multiplication plan
+ *  n           Number of columns of B, C and D, from 1 to the N of the plan
+ *  alpha       scalar \f$\alpha\f$. (float)
+ *  d_A         Pointer to the compressed structured matrix A
+ *  d_B         Pointer to the dense matrix B
+ *  beta        scalar \f$\beta\f$. (float)
+ *  d_C         Pointer to the dense matrix C
+ *  workspace   Pointor to the worksapce
+ *  streams     Pointer to HIP stream array for the computation
+ *  numStreams  Number of HIP streams in \p streams
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p alpha, \p A, \p B, \p beta, \p C or
+ *              \p D pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_size \p n is not in [1, N of the plan].
+ *  \retval     rocsparselt_status_invalid_value workspace, streams or numStreams are invalid
+ *  \retval     rocsparselt_status_not_implemented B is the structured matrix, or the problem
+ *              is not supported
+ */
+rocsparselt_status rocsparselt_matmul_dynamic_n(const rocsparselt_handle*      handle,
+                                                const rocsparselt_matmul_plan* plan,
+                                                int64_t                        n,
+                                                const void*                    alpha,
+                                                const void*                    d_A,
+                                                const void*                    d_B,
+                                                const void*                    beta,
+                                                const void*                    d_C,
+                                                void*                          d_D,
+                                                void*                          workspace,
+                                                hipStream_t*                   streams,
+                                                int32_t                        numStreams);
+
 /*! \ingroup spmm_module
  *  \brief Purnes a dense matrix.
  *
@@ -403,6 +858,45 @@ rocsparselt_status rocsparselt_smfmac_compress(const rocsparselt_handle*      ha
                                                void*                          d_compressBuffer,
                                                hipStream_t                    stream);
 
+/*! \ingroup spmm_module
+ *  \brief compresses the shards of a sharded matrix multiplication on their devices.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_compress_sharded compresses d_dense[i] with plans[i] on the device
+ *  of handles[i] and streams[i] for every shard of a \ref rocsparselt_matmul_sharded. The
+ *  shards are validated before any of them is launched.
+ *
+ *  @param[out]
+ *  d_compressed       Array of \p numShards pointers to the compressed shards
+ *  @param[out]
+ *  d_compressBuffer   Array of \p numShards pointers to the compress buffers, can be NULL
+ *
+ *  @param[in]
+ *  handles        Array of \p numShards handles, one per shard.
+ *  plans          Array of \p numShards plans, plans[i] created with handles[i].
+ *  numShards      Number of shards.
+ *  split          dimension the matrix multiplication is split along.
+ *  d_dense        Array of \p numShards pointers to the dense shards.
+ *  streams        Array of \p numShards HIP streams, streams[i] on the device of handles[i].
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle one of \p handles or \p plans is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_dense, \p d_compressed or \p streams
+ *              pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_size the shapes of the shards do not make a matrix
+ *              multiplication split along \p split.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support
+ */
+rocsparselt_status
+    rocsparselt_smfmac_compress_sharded(const rocsparselt_handle* const*      handles,
+                                        const rocsparselt_matmul_plan* const* plans,
+                                        int32_t                               numShards,
+                                        rocsparselt_shard_split               split,
+                                        const void* const*                    d_dense,
+                                        void* const*                          d_compressed,
+                                        void* const*                          d_compressBuffer,
+                                        hipStream_t*                          streams);
+
 /*! \ingroup spmm_module
  *  \brief compresses a dense matrix to structured matrix.
  *
@@ -439,6 +933,849 @@ rocsparselt_status rocsparselt_smfmac_compress2(const rocsparselt_handle*    han
                                                 void*                        d_compressBuffer,
                                                 hipStream_t                  stream);
 
+/*! \ingroup spmm_module
+ *  \brief prunes a dense matrix and compresses it to structured matrix in one pass.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_prune_and_compress prunes a dense matrix d_dense according to the
+ *  specified algorithm pruneAlg, \ref rocsparselt_prune_smfmac_tile or
+ *  \ref rocsparselt_prune_smfmac_strip, and writes the compressed matrix and its metadata
+ *  without storing the pruned dense matrix.
+ *
+ *  @param[out]
+ *  d_compressed       compressed matrix and metadata
+ *  @param[out]
+ *  d_compressBuffer   temporary buffer for the compression
+ *
+ *  @param[in]
+ *  handle         handle to the rocsparselt library context queue.
+ *  plan           matrix multiplication plan descriptor.
+ *  d_dense        pointer to the dense matrix.
+ *  pruneAlg       pruning algorithm.
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_dense or \p d_compressed pointer is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problem or \p pruneAlg is not support
+ */
+rocsparselt_status rocsparselt_smfmac_prune_and_compress(const rocsparselt_handle*      handle,
+                                                         const rocsparselt_matmul_plan* plan,
+                                                         const void*                    d_dense,
+                                                         void*                 d_compressed,
+                                                         void*                 d_compressBuffer,
+                                                         rocsparselt_prune_alg pruneAlg,
+                                                         hipStream_t           stream);
+
+/*! \ingroup spmm_module
+ *  \brief prunes a dense matrix for both operations and compresses it for each of them.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_prune_and_compress_transposable prunes d_in with
+ *  \ref rocsparselt_prune_smfmac_tile, which keeps 2 elements in each row and each column of
+ *  every 4x4 tile, so the pruned matrix is 2:4 along both of its dimensions. It is then
+ *  compressed to d_compressed for \ref rocsparselt_operation_none and to d_compressedT for
+ *  \ref rocsparselt_operation_transpose, so that one pruning pass serves a matmul with the
+ *  matrix and one with its transpose, the forward and the backward pass of training for example.
+ *
+ *  @param[out]
+ *  d_out              pointer to the pruned matrix, may be \p d_in.
+ *  d_compressed       compressed matrix and metadata for the matmul with op none.
+ *  d_compressedT      compressed matrix and metadata for the matmul with op transpose.
+ *
+ *  @param[in]
+ *  handle            handle to the rocsparselt library context queue.
+ *  sparseMatDescr    descriptor of the sparse matrix.
+ *  isSparseA         specify if the structured (sparse) matrix is in the first position (matA or matB).
+ *  d_in              pointer to the dense matrix.
+ *  stream            HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p sparseMatDescr is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_in , \p d_out , \p d_compressed or \p d_compressedT pointer is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support
+ */
+rocsparselt_status
+    rocsparselt_smfmac_prune_and_compress_transposable(const rocsparselt_handle*    handle,
+                                                       const rocsparselt_mat_descr* sparseMatDescr,
+                                                       int                          isSparseA,
+                                                       const void*                  d_in,
+                                                       void*                        d_out,
+                                                       void*                        d_compressed,
+                                                       void*                        d_compressedT,
+                                                       hipStream_t                  stream);
+
+/*! \ingroup spmm_module
+ *  \brief counts the groups of a matrix which break the 2:4 sparsity.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_prune_check_count counts the groups of 4 consecutive elements
+ *  along the k dimension of the structured (sparse) matrix that hold more than 2 nonzeros.
+ *  When \p maxOffsets is positive, the element offsets of up to \p maxOffsets offending
+ *  groups are also written to \p d_offsets, in no particular order.
+ *
+ *  @param[out]
+ *  d_count        device pointer to the number of offending groups.
+ *  d_offsets      device pointer to at least \p maxOffsets offsets into \p d_in, can be nullptr
+ *                 when \p maxOffsets is 0.
+ *
+ *  @param[in]
+ *  handle         rocsparselt library handle
+ *  matmulDescr    matrix multiplication descriptor.
+ *  d_in           pointer to the matrix to check.
+ *  maxOffsets     maximum number of offsets to write to \p d_offsets.
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p matmulDescr is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_in or \p d_count pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p maxOffsets or \p d_offsets is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support
+ */
+rocsparselt_status rocsparselt_smfmac_prune_check_count(const rocsparselt_handle*       handle,
+                                                        const rocsparselt_matmul_descr* matmulDescr,
+                                                        const void*                     d_in,
+                                                        int64_t*                        d_count,
+                                                        int64_t*                        d_offsets,
+                                                        int                             maxOffsets,
+                                                        hipStream_t                     stream);
+
+/*! \ingroup spmm_module
+ *  \brief provides the size of the mask written by rocsparselt_smfmac_prune_mask().
+ *
+ *  \details
+ *  The mask has 4 bits for each group of 4 consecutive elements along the k dimension, that is
+ *  k / 8 bytes for each row of op(A) when A is the structured matrix, or column of op(B)
+ *  otherwise, in the layout of the compressed metadata.
+ *
+ *  @param[out]
+ *  maskSize       size in bytes of the mask.
+ *
+ *  @param[in]
+ *  handle         rocsparselt library handle
+ *  matmulDescr    matrix multiplication descriptor.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p matmulDescr is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p maskSize pointer is invalid.
+ */
+rocsparselt_status rocsparselt_smfmac_prune_mask_size(const rocsparselt_handle*       handle,
+                                                      const rocsparselt_matmul_descr* matmulDescr,
+                                                      size_t*                         maskSize);
+
+/*! \ingroup spmm_module
+ *  \brief prunes a dense matrix and writes the mask of the kept elements.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_prune_mask prunes like rocsparselt_smfmac_prune() and also writes the
+ *  pattern it picked to \p d_mask, so that rocsparselt_smfmac_mask_apply() can re-apply it later
+ *  without ranking the elements again. Bit j of a nibble is set when element j of its group is
+ *  kept; the low nibble of a byte holds the first of its two groups. \p d_out may be \p d_in.
+ *
+ *  @param[out]
+ *  d_out          pointer to the pruned matrix.
+ *  d_mask         pointer to the mask, of the size given by rocsparselt_smfmac_prune_mask_size().
+ *
+ *  @param[in]
+ *  handle         rocsparselt library handle
+ *  matmulDescr    matrix multiplication descriptor.
+ *  d_in           pointer to the dense matrix.
+ *  pruneAlg       pruning algorithm.
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p matmulDescr is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_in , \p d_out or \p d_mask pointer is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support
+ */
+rocsparselt_status rocsparselt_smfmac_prune_mask(const rocsparselt_handle*       handle,
+                                                 const rocsparselt_matmul_descr* matmulDescr,
+                                                 const void*                     d_in,
+                                                 void*                           d_out,
+                                                 void*                           d_mask,
+                                                 rocsparselt_prune_alg           pruneAlg,
+                                                 hipStream_t                     stream);
+
+/*! \ingroup spmm_module
+ *  \brief zeros the elements of a dense matrix which a mask does not keep.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_mask_apply copies \p d_in to \p d_out with the elements whose bit of
+ *  \p d_mask is clear set to 0, in a single pass. \p d_out may be \p d_in. It applies to any matrix
+ *  of the shape of the structured matrix, the weights or their gradients for example.
+ *
+ *  @param[out]
+ *  d_out          pointer to the masked matrix.
+ *
+ *  @param[in]
+ *  handle         rocsparselt library handle
+ *  matmulDescr    matrix multiplication descriptor.
+ *  d_in           pointer to the dense matrix.
+ *  d_mask         pointer to a mask written by rocsparselt_smfmac_prune_mask().
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p matmulDescr is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_in , \p d_out or \p d_mask pointer is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support
+ */
+rocsparselt_status rocsparselt_smfmac_mask_apply(const rocsparselt_handle*       handle,
+                                                 const rocsparselt_matmul_descr* matmulDescr,
+                                                 const void*                     d_in,
+                                                 void*                           d_out,
+                                                 const void*                     d_mask,
+                                                 hipStream_t                     stream);
+
+/*! \ingroup spmm_module
+ *  \brief prunes a dense matrix by an importance score instead of the magnitude of its values.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_prune_scored prunes like rocsparselt_smfmac_prune_mask(), but ranks the
+ *  elements by the norm1 of \p d_score , in the layout of \p d_in , or of the values when it is
+ *  NULL, times \p d_colScale[k] when it is not NULL. \p d_mask is optional. \p d_out may be
+ *  \p d_in.
+ *
+ *  @param[out]
+ *  d_out          pointer to the pruned matrix.
+ *  d_mask         pointer to the mask, of the size given by rocsparselt_smfmac_prune_mask_size(), or NULL.
+ *
+ *  @param[in]
+ *  handle         rocsparselt library handle
+ *  matmulDescr    matrix multiplication descriptor.
+ *  d_in           pointer to the dense matrix.
+ *  d_score        pointer to the importance of each element, or NULL.
+ *  d_colScale     pointer to the scale of each element of the k dimension, or NULL.
+ *  pruneAlg       pruning algorithm.
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p matmulDescr is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_in or \p d_out pointer is invalid, or \p d_score and \p d_colScale are both NULL.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support
+ */
+rocsparselt_status rocsparselt_smfmac_prune_scored(const rocsparselt_handle*       handle,
+                                                   const rocsparselt_matmul_descr* matmulDescr,
+                                                   const void*                     d_in,
+                                                   void*                           d_out,
+                                                   const float*                    d_score,
+                                                   const float*                    d_colScale,
+                                                   void*                           d_mask,
+                                                   rocsparselt_prune_alg           pruneAlg,
+                                                   hipStream_t                     stream);
+
+/*! \ingroup spmm_module
+ *  \brief provide the size of the work list of a grouped prune or compression.
+ *
+ *  @param[out]
+ *  workListSize   size in bytes of the work list.
+ *
+ *  @param[in]
+ *  handle         rocsparselt library handle
+ *  groupCount     number of matrices of the group.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle is invalid.
+ *  \retval     rocsparselt_status_invalid_size \p groupCount is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p workListSize pointer is invalid.
+ */
+rocsparselt_status rocsparselt_smfmac_grouped_work_list_size(
+    const rocsparselt_handle* handle, int groupCount, size_t* workListSize);
+
+/*! \ingroup spmm_module
+ *  \brief prunes a group of dense matrices in one kernel launch.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_prune2_grouped prunes every d_in[i] described by sparseMatDescrs[i] into
+ *  d_out[i] as rocsparselt_smfmac_prune2() does, with a single kernel launch driven by a work list
+ *  copied to d_workList. All the matrices must share their datatype.
+ *
+ *  @param[out]
+ *  d_out          host array of the pointers to the pruned matrices.
+ *  d_workList     device buffer of the size given by rocsparselt_smfmac_grouped_work_list_size().
+ *
+ *  @param[in]
+ *  handle          rocsparselt library handle
+ *  groupCount      number of matrices of the group.
+ *  sparseMatDescrs host array of the structured(sparse) matrix descriptors.
+ *  isSparseA       specify if the structured (sparse) matrices are in the first position (matA or matB)
+ *  op              operation that will be applied to the structured (sparse) matrices in the multiplication
+ *  d_in            host array of the pointers to the dense matrices.
+ *  pruneAlg        pruning algorithm.
+ *  stream          HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or a descriptor is invalid.
+ *  \retval     rocsparselt_status_invalid_size \p groupCount is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer a pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p op is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support or the datatypes differ.
+ */
+rocsparselt_status
+    rocsparselt_smfmac_prune2_grouped(const rocsparselt_handle*           handle,
+                                      int                                 groupCount,
+                                      const rocsparselt_mat_descr* const* sparseMatDescrs,
+                                      int                                 isSparseA,
+                                      rocsparselt_operation               op,
+                                      const void* const*                  d_in,
+                                      void* const*                        d_out,
+                                      rocsparselt_prune_alg               pruneAlg,
+                                      void*                               d_workList,
+                                      hipStream_t                         stream);
+
+/*! \ingroup spmm_module
+ *  \brief compresses a group of dense matrices in one kernel launch.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_compress2_grouped compresses every d_dense[i] described by
+ *  sparseMatDescrs[i] into d_compressed[i] as rocsparselt_smfmac_compress2() does, with a single
+ *  kernel launch driven by a work list copied to d_workList. All the matrices must share their
+ *  datatype.
+ *
+ *  @param[out]
+ *  d_compressed   host array of the pointers to the compressed matrices and metadata.
+ *  d_workList     device buffer of the size given by rocsparselt_smfmac_grouped_work_list_size().
+ *
+ *  @param[in]
+ *  handle          rocsparselt library handle
+ *  groupCount      number of matrices of the group.
+ *  sparseMatDescrs host array of the structured(sparse) matrix descriptors.
+ *  isSparseA       specify if the structured (sparse) matrices are in the first position (matA or matB)
+ *  op              operation that will be applied to the structured (sparse) matrices in the multiplication
+ *  d_dense         host array of the pointers to the dense matrices.
+ *  stream          HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or a descriptor is invalid.
+ *  \retval     rocsparselt_status_invalid_size \p groupCount is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer a pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p op is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support or the datatypes differ.
+ */
+rocsparselt_status
+    rocsparselt_smfmac_compress2_grouped(const rocsparselt_handle*           handle,
+                                         int                                 groupCount,
+                                         const rocsparselt_mat_descr* const* sparseMatDescrs,
+                                         int                                 isSparseA,
+                                         rocsparselt_operation               op,
+                                         const void* const*                  d_dense,
+                                         void* const*                        d_compressed,
+                                         void*                               d_workList,
+                                         hipStream_t                         stream);
+
+/*! \ingroup spmm_module
+ *  \brief provides the size of a compressed matrix without a handle.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_compressed_size_host returns the size of the compressed matrix written by
+ *  rocsparselt_smfmac_compress_host(). The matrix is described by the arguments of
+ *  rocsparselt_structured_descr_init(), of its batch attributes and of the matmul it is used in.
+ *
+ *  @param[out]
+ *  compressedSize  size in bytes of the compressed matrix.
+ *
+ *  @param[in]
+ *  rows            number of rows of the structured matrix.
+ *  cols            number of columns of the structured matrix.
+ *  ld              leading dimension of the structured matrix, in column order.
+ *  valueType       data type of the matrix.
+ *  numBatches      number of batches.
+ *  batchStride     stride between the batches, 0 to broadcast the first one.
+ *  isSparseA       specify if the structured (sparse) matrix is in the first position (matA or matB)
+ *  op              operation that will be applied to the structured (sparse) matrix in the multiplication
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_size a size is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p compressedSize pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p op is invalid.
+ *  \retval     rocsparselt_status_not_implemented the datatype is not supported.
+ */
+rocsparselt_status rocsparselt_smfmac_compressed_size_host(int64_t               rows,
+                                                           int64_t               cols,
+                                                           int64_t               ld,
+                                                           rocsparselt_datatype  valueType,
+                                                           int                   numBatches,
+                                                           int64_t               batchStride,
+                                                           int                   isSparseA,
+                                                           rocsparselt_operation op,
+                                                           size_t*               compressedSize);
+
+/*! \ingroup spmm_module
+ *  \brief prunes a dense matrix in host memory.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_prune_host prunes h_in into h_out on the CPU, with the same result as
+ *  rocsparselt_smfmac_prune2() on the device. No GPU is needed. The work is split across
+ *  \p numThreads threads, 0 uses one thread for each core.
+ *
+ *  @param[out]
+ *  h_out           host pointer to the pruned matrix, it may be \p h_in.
+ *
+ *  @param[in]
+ *  rows            number of rows of the structured matrix.
+ *  cols            number of columns of the structured matrix.
+ *  ld              leading dimension of the structured matrix, in column order.
+ *  valueType       data type of the matrix.
+ *  numBatches      number of batches.
+ *  batchStride     stride between the batches, 0 to broadcast the first one.
+ *  isSparseA       specify if the structured (sparse) matrix is in the first position (matA or matB)
+ *  op              operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  h_in            host pointer to the dense matrix.
+ *  pruneAlg        pruning algorithm.
+ *  numThreads      number of threads, 0 for one thread for each core.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_size a size is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p h_in or \p h_out pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p op is invalid.
+ *  \retval     rocsparselt_status_not_implemented the datatype or \p pruneAlg is not supported.
+ */
+rocsparselt_status rocsparselt_smfmac_prune_host(int64_t               rows,
+                                                 int64_t               cols,
+                                                 int64_t               ld,
+                                                 rocsparselt_datatype  valueType,
+                                                 int                   numBatches,
+                                                 int64_t               batchStride,
+                                                 int                   isSparseA,
+                                                 rocsparselt_operation op,
+                                                 const void*           h_in,
+                                                 void*                 h_out,
+                                                 rocsparselt_prune_alg pruneAlg,
+                                                 int                   numThreads);
+
+/*! \ingroup spmm_module
+ *  \brief compresses a pruned matrix in host memory.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_compress_host writes the compressed matrix and metadata of h_dense to
+ *  h_compressed on the CPU. The bytes are those rocsparselt_smfmac_compress() writes for a plan
+ *  of the same matmul, so the result can be copied to the device and used as is.
+ *
+ *  @param[out]
+ *  h_compressed    host pointer to the compressed matrix and metadata, of the size given by
+ *                  rocsparselt_smfmac_compressed_size_host().
+ *
+ *  @param[in]
+ *  rows            number of rows of the structured matrix.
+ *  cols            number of columns of the structured matrix.
+ *  ld              leading dimension of the structured matrix, in column order.
+ *  valueType       data type of the matrix.
+ *  numBatches      number of batches.
+ *  batchStride     stride between the batches, 0 to broadcast the first one.
+ *  isSparseA       specify if the structured (sparse) matrix is in the first position (matA or matB)
+ *  op              operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  h_dense         host pointer to the pruned dense matrix.
+ *  numThreads      number of threads, 0 for one thread for each core.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_size a size is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p h_dense or \p h_compressed pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p op is invalid.
+ *  \retval     rocsparselt_status_not_implemented the datatype is not supported.
+ */
+rocsparselt_status rocsparselt_smfmac_compress_host(int64_t               rows,
+                                                    int64_t               cols,
+                                                    int64_t               ld,
+                                                    rocsparselt_datatype  valueType,
+                                                    int                   numBatches,
+                                                    int64_t               batchStride,
+                                                    int                   isSparseA,
+                                                    rocsparselt_operation op,
+                                                    const void*           h_dense,
+                                                    void*                 h_compressed,
+                                                    int                   numThreads);
+
+/*! \ingroup spmm_module
+ *  \brief recompresses some rows of a dense matrix in place.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_compress_rows compresses the rows [rowRanges[2 * i], rowRanges[2 * i + 1])
+ *  of d_dense into d_compressed, values and metadata, and leaves the other rows untouched. A row is
+ *  a row of op(A) when A is the structured matrix, a column of op(B) otherwise; it holds the k values
+ *  of one output element, and its compressed values and metadata do not depend on the other rows.
+ *  The ranges apply to every batch and are recompressed in a single launch.
+ *
+ *  @param[out]
+ *  d_compressed       compressed matrix and metadata, written by rocsparselt_smfmac_compress() before.
+ *  @param[out]
+ *  d_workList         device buffer of the size given by rocsparselt_smfmac_grouped_work_list_size()
+ *                     for \p rangeCount.
+ *
+ *  @param[in]
+ *  handle         handle to the rocsparselt library context queue.
+ *  plan           matrix multiplication plan descriptor.
+ *  d_dense        pointer to the pruned dense matrix.
+ *  rangeCount     number of row ranges.
+ *  rowRanges      host array of \p rangeCount pairs of the first and the past-the-end row.
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_dense , \p d_compressed , \p rowRanges or \p d_workList pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_size \p rangeCount or a range is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support
+ */
+rocsparselt_status rocsparselt_smfmac_compress_rows(const rocsparselt_handle*      handle,
+                                                    const rocsparselt_matmul_plan* plan,
+                                                    const void*                    d_dense,
+                                                    void*                          d_compressed,
+                                                    int                            rangeCount,
+                                                    const int64_t*                 rowRanges,
+                                                    void*                          d_workList,
+                                                    hipStream_t                    stream);
+
+/*! \ingroup spmm_module
+ *  \brief compresses a dense matrix that does not reside in device memory.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_compress2_streamed writes the same compressed matrix as
+ *  rocsparselt_smfmac_compress2(), but reads the pruned dense matrix from host memory, or from
+ *  any memory hipMemcpy can read, in panels of rows. A row is a row of op(A) when A is the
+ *  structured matrix, a column of op(B) otherwise. The panels go through two parts of
+ *  d_panelBuffer in turn, three when it holds three panels of 16 rows: a panel is copied on an
+ *  internal stream while the previous ones are compressed on \p stream, so only the compressed
+ *  matrix and d_panelBuffer are resident in device memory. The copies overlap the compression only when \p dense is pinned host memory.
+ *  \p dense must stay valid until the work on \p stream completes.
+ *
+ *  @param[out]
+ *  d_compressed       compressed matrix and metadata.
+ *  @param[out]
+ *  d_panelBuffer      device buffer of \p panelBufferSize bytes, at least two rows of k elements.
+ *
+ *  @param[in]
+ *  handle            handle to the rocsparselt library context queue.
+ *  sparseMatDescr    descriptor of the sparse matrix.
+ *  isSparseA         specify if the structured (sparse) matrix is in the first position (matA or matB).
+ *  op                matrix operation of the structured matrix.
+ *  dense             pointer to the pruned dense matrix.
+ *  panelBufferSize   size of \p d_panelBuffer in bytes, the larger the fewer panels.
+ *  stream            HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p sparseMatDescr is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p op is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p dense , \p d_compressed or \p d_panelBuffer pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_size \p panelBufferSize is smaller than two rows.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support
+ */
+rocsparselt_status
+    rocsparselt_smfmac_compress2_streamed(const rocsparselt_handle*    handle,
+                                          const rocsparselt_mat_descr* sparseMatDescr,
+                                          int                          isSparseA,
+                                          rocsparselt_operation        op,
+                                          const void*                  dense,
+                                          void*                        d_compressed,
+                                          void*                        d_panelBuffer,
+                                          size_t                       panelBufferSize,
+                                          hipStream_t                  stream);
+
+/*! \ingroup spmm_module
+ *  \brief prunes and compresses a dense matrix that does not reside in device memory.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_prune_and_compress_streamed reads the dense weights from host memory in
+ *  panels of rows through d_panelBuffer, as rocsparselt_smfmac_compress2_streamed() does, and
+ *  prunes each panel with \p pruneAlg while compressing it, so the copy of a panel overlaps the
+ *  prune and compress of the previous ones. The result is the same as pruning the whole matrix
+ *  with rocsparselt_smfmac_prune2() and compressing it with rocsparselt_smfmac_compress2(), and
+ *  neither the dense nor the pruned matrix is ever resident in device memory.
+ *  When \p bandwidth is not NULL, the call waits for the work on \p stream and stores the rate
+ *  of the whole pipeline in GB/s of the dense matrix.
+ *
+ *  @param[out]
+ *  d_compressed       compressed matrix and metadata.
+ *  @param[out]
+ *  d_panelBuffer      device buffer of \p panelBufferSize bytes, at least two rows of k elements,
+ *                     eight for \ref rocsparselt_prune_smfmac_tile.
+ *  @param[out]
+ *  bandwidth          host pointer to the achieved GB/s, may be NULL.
+ *
+ *  @param[in]
+ *  handle            handle to the rocsparselt library context queue.
+ *  sparseMatDescr    descriptor of the sparse matrix.
+ *  isSparseA         specify if the structured (sparse) matrix is in the first position (matA or matB).
+ *  op                matrix operation of the structured matrix.
+ *  dense             pointer to the dense matrix.
+ *  panelBufferSize   size of \p d_panelBuffer in bytes, the larger the fewer panels.
+ *  pruneAlg          pruning algorithm.
+ *  stream            HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p sparseMatDescr is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p op is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p dense , \p d_compressed or \p d_panelBuffer pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_size \p panelBufferSize is too small for two panels.
+ *  \retval     rocsparselt_status_not_implemented the problem or \p pruneAlg is not support
+ */
+rocsparselt_status
+    rocsparselt_smfmac_prune_and_compress_streamed(const rocsparselt_handle*    handle,
+                                                   const rocsparselt_mat_descr* sparseMatDescr,
+                                                   int                          isSparseA,
+                                                   rocsparselt_operation        op,
+                                                   const void*                  dense,
+                                                   void*                        d_compressed,
+                                                   void*                        d_panelBuffer,
+                                                   size_t                       panelBufferSize,
+                                                   rocsparselt_prune_alg        pruneAlg,
+                                                   float*                       bandwidth,
+                                                   hipStream_t                  stream);
+
+/*! \ingroup spmm_module
+ *  \brief expands a compressed matrix back to a dense matrix.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_decompress is the inverse of rocsparselt_smfmac_compress(), it writes
+ *  the pruned dense matrix from the compressed values and metadata of d_compressed, with the zeros
+ *  in place. Only the first batch is written when the structured matrix is broadcast.
+ *
+ *  @param[out]
+ *  d_dense        pointer to the dense matrix.
+ *
+ *  @param[in]
+ *  handle         handle to the rocsparselt library context queue.
+ *  plan           matrix multiplication plan descriptor.
+ *  d_compressed   compressed matrix and metadata.
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_compressed or \p d_dense pointer is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support
+ */
+rocsparselt_status rocsparselt_smfmac_decompress(const rocsparselt_handle*      handle,
+                                                 const rocsparselt_matmul_plan* plan,
+                                                 const void*                    d_compressed,
+                                                 void*                          d_dense,
+                                                 hipStream_t                    stream);
+
+/*! \ingroup spmm_module
+ *  \brief expands a compressed matrix back to a dense matrix.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_decompress2 is the inverse of rocsparselt_smfmac_compress2(), it writes
+ *  the pruned dense matrix from the compressed values and metadata of d_compressed, with the zeros
+ *  in place. Only the first batch is written when the structured matrix is broadcast.
+ *
+ *  @param[out]
+ *  d_dense        pointer to the dense matrix.
+ *
+ *  @param[in]
+ *  handle         handle to the rocsparselt library context queue.
+ *  sparseMatDescr structured(sparse) matrix descriptor.
+ *  isSparseA      specify if the structured (sparse) matrix is in the first position (matA or matB)
+ *  op             operation that will be applied to the structured (sparse) matrix in the multiplication
+ *  d_compressed   compressed matrix and metadata.
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p sparseMatDescr is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_compressed or \p d_dense pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p op is invalid.
+ *  \retval     rocsparselt_status_not_implemented the problem is not support
+ */
+rocsparselt_status rocsparselt_smfmac_decompress2(const rocsparselt_handle*    handle,
+                                                  const rocsparselt_mat_descr* sparseMatDescr,
+                                                  int                          isSparseA,
+                                                  rocsparselt_operation        op,
+                                                  const void*                  d_compressed,
+                                                  void*                        d_dense,
+                                                  hipStream_t                  stream);
+
+/*! \ingroup spmm_module
+ *  \brief provide the size of an optimizer state of rocsparselt_smfmac_compressed_update().
+ *
+ *  @param[out]
+ *  stateSize      size in bytes of a float state in the layout of the compressed values.
+ *
+ *  @param[in]
+ *  handle         handle to the rocsparselt library context queue.
+ *  plan           matrix multiplication plan descriptor.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p stateSize pointer is invalid.
+ */
+rocsparselt_status
+    rocsparselt_smfmac_compressed_update_state_size(const rocsparselt_handle*      handle,
+                                                    const rocsparselt_matmul_plan* plan,
+                                                    size_t*                        stateSize);
+
+/*! \ingroup spmm_module
+ *  \brief applies an optimizer step to the values of a compressed matrix.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_compressed_update updates the values of \p d_compressed in place from the
+ *  elements of the dense gradient \p d_grad which its metadata points to, the metadata is left
+ *  untouched. The states are floats in the layout of the compressed values: the momentum of SGD,
+ *  read when beta1 is not 0, and the first and second moments of Adam.
+ *
+ *  @param[out]
+ *  d_compressed   compressed matrix and metadata, updated in place.
+ *  d_state1       momentum of SGD or first moment of Adam, may be NULL for SGD without momentum.
+ *  d_state2       second moment of Adam, may be NULL for SGD.
+ *
+ *  @param[in]
+ *  handle         handle to the rocsparselt library context queue.
+ *  plan           matrix multiplication plan descriptor.
+ *  params         optimizer and its parameters.
+ *  d_grad         pointer to the dense gradient.
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p params , \p d_compressed , \p d_grad or a state the optimizer needs is invalid.
+ *  \retval     rocsparselt_status_invalid_value the optimizer or the step of Adam is invalid.
+ *  \retval     rocsparselt_status_not_implemented the type of the matrix is not supported.
+ */
+rocsparselt_status
+    rocsparselt_smfmac_compressed_update(const rocsparselt_handle*           handle,
+                                         const rocsparselt_matmul_plan*      plan,
+                                         const rocsparselt_optimizer_params* params,
+                                         void*                               d_compressed,
+                                         const void*                         d_grad,
+                                         float*                              d_state1,
+                                         float*                              d_state2,
+                                         hipStream_t                         stream);
+
+/*! \ingroup spmm_module
+ *  \brief provide the size of a compressed matrix packed to 4-bit values.
+ *
+ *  @param[out]
+ *  packedSize     size in bytes of the packed values, group scales and metadata.
+ *
+ *  @param[in]
+ *  handle         handle to the rocsparselt library context queue.
+ *  plan           matrix multiplication plan descriptor.
+ *  groupSize      compressed values sharing a scale, even and dividing k / 2.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p packedSize pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p groupSize is invalid.
+ *  \retval     rocsparselt_status_not_implemented the type of the matrix is not supported.
+ */
+rocsparselt_status
+    rocsparselt_smfmac_compressed_int4_size(const rocsparselt_handle*      handle,
+                                            const rocsparselt_matmul_plan* plan,
+                                            int64_t                        groupSize,
+                                            size_t*                        packedSize);
+
+/*! \ingroup spmm_module
+ *  \brief packs the values of a compressed matrix to 4-bit integers with group scales.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_compressed_int4_pack quantizes each group of \p groupSize compressed
+ *  values along k to round(v / scale) in [-8, 7] with scale = max|v| / 7, and copies the metadata.
+ *
+ *  @param[out]
+ *  d_packed       packed matrix, of the size given by rocsparselt_smfmac_compressed_int4_size().
+ *
+ *  @param[in]
+ *  handle         handle to the rocsparselt library context queue.
+ *  plan           matrix multiplication plan descriptor.
+ *  groupSize      compressed values sharing a scale.
+ *  d_compressed   compressed matrix and metadata.
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_compressed or \p d_packed pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p groupSize is invalid.
+ *  \retval     rocsparselt_status_not_implemented the type of the matrix is not supported.
+ */
+rocsparselt_status
+    rocsparselt_smfmac_compressed_int4_pack(const rocsparselt_handle*      handle,
+                                            const rocsparselt_matmul_plan* plan,
+                                            int64_t                        groupSize,
+                                            const void*                    d_compressed,
+                                            void*                          d_packed,
+                                            hipStream_t                    stream);
+
+/*! \ingroup spmm_module
+ *  \brief expands a packed 4-bit compressed matrix back to a compressed matrix.
+ *
+ *  @param[out]
+ *  d_compressed   compressed matrix and metadata.
+ *
+ *  @param[in]
+ *  handle         handle to the rocsparselt library context queue.
+ *  plan           matrix multiplication plan descriptor.
+ *  groupSize      compressed values sharing a scale, the one given to the pack.
+ *  d_packed       packed matrix.
+ *  stream         HIP stream for the computation.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_packed or \p d_compressed pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value \p groupSize is invalid.
+ *  \retval     rocsparselt_status_not_implemented the type of the matrix is not supported.
+ */
+rocsparselt_status
+    rocsparselt_smfmac_compressed_int4_unpack(const rocsparselt_handle*      handle,
+                                              const rocsparselt_matmul_plan* plan,
+                                              int64_t                        groupSize,
+                                              const void*                    d_packed,
+                                              void*                          d_compressed,
+                                              hipStream_t                    stream);
+
+/*! \ingroup spmm_module
+ *  \brief writes a compressed matrix to a file.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_compressed_save copies the compressed matrix written by
+ *  rocsparselt_smfmac_compress() to \p path, after a versioned header that records the parameters
+ *  of the structured matrix of the plan and the offset of the metadata. The file is mapped and the
+ *  copy goes from the device straight into the mapping. The function returns when the file is written.
+ *
+ *  @param[in]
+ *  handle         handle to the rocsparselt library context queue.
+ *  plan           matrix multiplication plan descriptor.
+ *  d_compressed   compressed matrix and metadata.
+ *  path           path of the file to create or overwrite.
+ *  stream         HIP stream for the copy.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_compressed or \p path pointer is invalid.
+ *  \retval     rocsparselt_status_internal_error the file cannot be written.
+ */
+rocsparselt_status rocsparselt_smfmac_compressed_save(const rocsparselt_handle*      handle,
+                                                      const rocsparselt_matmul_plan* plan,
+                                                      const void*                    d_compressed,
+                                                      const char*                    path,
+                                                      hipStream_t                    stream);
+
+/*! \ingroup spmm_module
+ *  \brief reads a compressed matrix from a file.
+ *
+ *  \details
+ *  \p rocsparselt_smfmac_compressed_load copies a file written by rocsparselt_smfmac_compressed_save()
+ *  into \p d_compressed, which then holds what rocsparselt_smfmac_compress() would have written. The
+ *  header must match the structured matrix of the plan. The file is mapped and registered with HIP, so
+ *  the bytes are copied to the device without reformatting or staging. The function returns when the
+ *  copy is complete.
+ *
+ *  @param[out]
+ *  d_compressed   compressed matrix and metadata, of the size given by rocsparselt_smfmac_compressed_size().
+ *
+ *  @param[in]
+ *  handle         handle to the rocsparselt library context queue.
+ *  plan           matrix multiplication plan descriptor.
+ *  path           path of the file to read.
+ *  stream         HIP stream for the copy.
+ *
+ *  \retval     rocsparselt_status_success the operation completed successfully.
+ *  \retval     rocsparselt_status_invalid_handle \p handle or \p plan is invalid.
+ *  \retval     rocsparselt_status_invalid_pointer \p d_compressed or \p path pointer is invalid.
+ *  \retval     rocsparselt_status_invalid_value the file is not a compressed matrix of the plan.
+ *  \retval     rocsparselt_status_not_implemented the file has a newer version.
+ *  \retval     rocsparselt_status_internal_error the file cannot be read.
+ */
+rocsparselt_status rocsparselt_smfmac_compressed_load(const rocsparselt_handle*      handle,
+                                                      const rocsparselt_matmul_plan* plan,
+                                                      const char*                    path,
+                                                      void*                          d_compressed,
+                                                      hipStream_t                    stream);
+
 #ifdef __cplusplus
 }
 #endif
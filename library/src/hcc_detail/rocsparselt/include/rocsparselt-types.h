@@ -242,6 +242,7 @@ typedef enum rocsparselt_datatype_
     rocsparselt_datatype_f16_r  = 150, /**< 16 bit floating point, real */
     rocsparselt_datatype_f32_r  = 151, /**< 32 bit floating point, real */
     rocsparselt_datatype_i8_r   = 160, /**<  8 bit signed integer, real */
+    rocsparselt_datatype_i32_r  = 162, /**< 32 bit signed integer, real */
     rocsparselt_datatype_bf16_r = 168, /**< 16 bit bfloat, real */
     rocsparselt_datatype_f8_r   = 170, /**< 8 bit floating point, real */
     rocsparselt_datatype_bf8_r  = 171, /**< 8 bit bfloat, real */
@@ -309,6 +310,29 @@ typedef enum rocsparselt_matmul_descr_attribute_
     = 15, /**< Beta value of the Tanh activation function. */
     rocsparselt_matmul_bias_type = 16, /**< Precision of bias >*/
     rocsparselt_matmul_activation_none, /**< activation function is disabled. */
+    rocsparselt_matmul_scale_a = 18, /**< Scale of the matrix A, applied with alpha. */
+    rocsparselt_matmul_scale_b = 19, /**< Scale of the matrix B, applied with alpha. */
+    rocsparselt_matmul_d_scale = 20, /**< Scale of the matrix D, applied after the activation. */
+    rocsparselt_matmul_d_saturate = 21, /**< Saturate the scaled D to the range of its type. */
+    rocsparselt_matmul_amax_d_pointer = 22, /**< Device pointer receiving the amax of D. */
+    rocsparselt_matmul_residual_pointer = 23, /**< Device pointer to the residual added to D. */
+    rocsparselt_matmul_residual_stride = 24, /**< Stride between consecutive residual matrices. */
+    rocsparselt_matmul_gate_pointer = 25, /**< Device pointer to the gate multiplying D. */
+    rocsparselt_matmul_gate_stride = 26, /**< Stride between consecutive gate matrices. */
+    rocsparselt_matmul_activation_silu = 27, /**< SiLU (Swish) activation function. */
+    rocsparselt_matmul_activation_clamp = 28, /**< Clamp activation function. */
+    rocsparselt_matmul_activation_clamp_min
+    = 29, /**< Lower bound of the clamp activation function. */
+    rocsparselt_matmul_activation_clamp_max
+    = 30, /**< Upper bound of the clamp activation function. */
+    rocsparselt_matmul_cu_count = 31, /**< CUs the configs are selected for. */
+    rocsparselt_matmul_label    = 32, /**< Label naming the roctx ranges of the matmul. */
+    rocsparselt_matmul_candidates
+    = 33, /**< Configs kept of the ones ranked by the selection heuristic, 0 for the default. */
+    rocsparselt_matmul_bias_grad_pointer
+    = 34, /**< Device pointer to the vector receiving the sums of the rows of D. */
+    rocsparselt_matmul_sparse_dynamic
+    = 35, /**< Prune and compress the dense structured operand within the matmul. */
 } rocsparselt_matmul_descr_attribute;
 
 /*! \ingroup types_module
@@ -342,6 +366,18 @@ typedef enum rocsparselt_matmul_alg_attribute_
     = 4, /**< Number of kernels to call for Split-K. Values are specified in rocsparselt_split_k_mode. */
     rocsparselt_matmul_split_k_buffers
     = 5, /**< Device memory buffers to store partial results for the reduction. The valid range is [1, SplitK - 1] */
+    rocsparselt_matmul_search_flush_cache
+    = 6, /**< Flush L2 and MALL before each timed run of rocsparselt_matmul_search, 0 or 1, default=0. */
+    rocsparselt_matmul_search_results
+    = 7, /**< Timings of the fastest configs measured by the last rocsparselt_matmul_search, an array of rocsparselt_matmul_search_result (query only). */
+    rocsparselt_matmul_stream_k
+    = 8, /**< Stream-K schedule, 0 or 1, default=not set. 1 restricts the configs to the Stream-K ones, 0 leaves them out. Reads 1 when the current config is a Stream-K one. */
+    rocsparselt_matmul_search_dense
+    = 9, /**< Also time the dense path, a kernel without SMFMAC on the compressed matrix, in rocsparselt_matmul_search, 0 or 1, default=0. */
+    rocsparselt_matmul_dense_selected
+    = 10, /**< 1 when the last rocsparselt_matmul_search found the dense path faster than the best config, rocsparselt_matmul then runs it (query only). */
+    rocsparselt_matmul_config_scores
+    = 11, /**< Fractions of the peak the selection heuristic predicts for the configs, an array of config_max_id floats in the order of the config ids (query only). */
 } rocsparselt_matmul_alg_attribute;
 
 /*! \ingroup types_module
@@ -374,6 +410,115 @@ typedef enum rocsparselt_split_k_mode_
     rocsparselt_split_k_mode_two_kernels = 1, /**< Use anoghter kernel to do the final reduction */
 } rocsparselt_split_k_mode;
 
+/*! \ingroup types_module
+ *  \brief Statistics of the config cache of a handle.
+ *
+ *  \details
+ *  The \ref rocsparselt_config_cache_stats is filled by the
+ *  \ref rocsparselt_get_config_cache_stats function.
+ */
+typedef struct rocsparselt_config_cache_stats_
+{
+    int64_t hits; /**< initializations of an algorithm selection served by the cache. */
+    int64_t misses; /**< initializations of an algorithm selection which queried the backend. */
+    int64_t evictions; /**< entries dropped to make room for a new problem. */
+    int64_t entries; /**< problems currently held by the cache. */
+    int64_t capacity; /**< maximum number of problems held by the cache. */
+} rocsparselt_config_cache_stats;
+
+/*! \ingroup types_module
+ *  \brief Statistics of the code objects loaded on a device.
+ *
+ *  \details
+ *  The \ref rocsparselt_code_object_stats is filled by the
+ *  \ref rocsparselt_get_code_object_stats function.
+ */
+typedef struct rocsparselt_code_object_stats_
+{
+    int64_t bytes; /**< bytes of the code objects currently loaded. */
+    int64_t modules; /**< code objects currently loaded. */
+    int64_t pinned; /**< code objects of the kernels bound for a live plan, never evicted. */
+    int64_t evictions; /**< code objects unloaded to keep bytes under capacity. */
+    int64_t capacity; /**< maximum bytes of the code objects, 0 for no limit. */
+} rocsparselt_code_object_stats;
+
+/*! \ingroup types_module
+ *  \brief Timings of a config measured by rocsparselt_matmul_search.
+ *
+ *  \details
+ *  An array of \ref rocsparselt_matmul_search_result is returned by
+ *  \ref rocsparselt_matmul_alg_get_attribute with rocsparselt_matmul_search_results.
+ */
+typedef struct rocsparselt_matmul_search_result_
+{
+    int    config_id; /**< config of the entry, -1 after the last measured config. */
+    int    samples; /**< timed runs of the config, the warm up excluded. */
+    float  mean_ms; /**< mean time of a run in milliseconds. */
+    float  min_ms; /**< fastest run in milliseconds. */
+    size_t max_workspace_bytes; /**< workspace required by the config. */
+    char   kernel_name[256]; /**< name of the kernel, truncated to fit. */
+} rocsparselt_matmul_search_result;
+
+/*! \ingroup types_module
+ *  \brief Counters of the matrix multiplications of a plan.
+ *
+ *  \details
+ *  The \ref rocsparselt_matmul_plan_stats is filled by the
+ *  \ref rocsparselt_matmul_plan_get_stats function.
+ */
+typedef struct rocsparselt_matmul_plan_stats_
+{
+    int64_t calls; /**< matrix multiplications run with the plan, the searches excluded. */
+    int64_t timed_calls; /**< sampled calls whose GPU time was measured. */
+    double  gpu_time_ms; /**< GPU time of the timed calls in milliseconds. */
+    double  host_time_ms; /**< host time spent in the calls in milliseconds. */
+    size_t  workspace_bytes; /**< workspace used by the last call. */
+    size_t  max_workspace_bytes; /**< largest workspace used by a call. */
+    int     sample_rate; /**< one call in sample_rate is timed. */
+    int     config_id; /**< selected config of the plan. */
+    int     config_index; /**< index of the kernel of the selected config in the backend. */
+    int     dense_selected; /**< 1 when the plan runs the dense path. */
+    char    kernel_name[256]; /**< name of the kernel of the selected config, truncated to fit. */
+} rocsparselt_matmul_plan_stats;
+
+/*! \ingroup types_module
+ *  \brief Specify the update rule of rocsparselt_smfmac_compressed_update.
+ */
+typedef enum rocsparselt_optimizer_
+{
+    rocsparselt_optimizer_sgd = 0, /**< w -= lr * g, with a momentum buffer when beta1 is not 0. */
+    rocsparselt_optimizer_adam = 1, /**< Adam with the first and second moments. */
+} rocsparselt_optimizer;
+
+/*! \ingroup types_module
+ *  \brief Parameters of an optimizer step on a compressed matrix.
+ *
+ *  \details
+ *  The \ref rocsparselt_optimizer_params is used in the
+ *  \ref rocsparselt_smfmac_compressed_update function.
+ */
+typedef struct rocsparselt_optimizer_params_
+{
+    rocsparselt_optimizer optimizer; /**< update rule. */
+    float                 lr; /**< learning rate. */
+    float                 beta1; /**< momentum of SGD, decay of the first moment of Adam. */
+    float                 beta2; /**< decay of the second moment of Adam. */
+    float                 eps; /**< added to the square root of the second moment of Adam. */
+    float                 weight_decay; /**< L2 penalty, added to the gradient. */
+    int64_t               step; /**< step of Adam, from 1, for the bias correction. */
+} rocsparselt_optimizer_params;
+
+/*! \ingroup types_module
+ *  \brief Specify the dimension a sharded matrix multiplication is split along.
+ */
+typedef enum rocsparselt_shard_split_
+{
+    /*! \brief The outer dimension of the sparse matrix, each device computes its part of D */
+    rocsparselt_shard_split_output = 0,
+    /*! \brief k, the partial products of the devices are summed into the D of every device */
+    rocsparselt_shard_split_k = 1,
+} rocsparselt_shard_split;
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,117 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "async_logger.hpp"
+
+#include <chrono>
+#include <iostream>
+
+rocsparselt_log_line& rocsparselt_log_line::thread_line()
+{
+    thread_local rocsparselt_log_line line;
+    line.str().clear();
+    return line;
+}
+
+_rocsparselt_async_logger::_rocsparselt_async_logger(size_t capacity)
+{
+    size_t size = 1;
+    while(size < capacity)
+        size <<= 1;
+    mask  = size - 1;
+    slots = std::unique_ptr<slot[]>(new slot[size]);
+    for(size_t i = 0; i < size; i++)
+        slots[i].sequence.store(i, std::memory_order_relaxed);
+    flusher = std::thread(&_rocsparselt_async_logger::flush_loop, this);
+}
+
+_rocsparselt_async_logger::~_rocsparselt_async_logger()
+{
+    stop.store(true, std::memory_order_release);
+    flusher.join();
+    drain();
+    if(size_t lines = dropped())
+        std::cerr << "hipSPARSELt: " << lines
+                  << " log lines dropped, raise HIPSPARSELT_LOG_ASYNC to keep them" << std::endl;
+}
+
+// A bounded multi-producer ring: the sequence of a slot tells whether it is free for the
+// position claimed by a producer, or holds the line the flusher writes next.
+void _rocsparselt_async_logger::push(std::ostream& os, std::string& line)
+{
+    size_t pos = head.load(std::memory_order_relaxed);
+    slot*  s;
+    for(;;)
+    {
+        s             = &slots[pos & mask];
+        size_t   seq  = s->sequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if(diff == 0)
+        {
+            if(head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if(diff < 0)
+        {
+            dropped_lines.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+            pos = head.load(std::memory_order_relaxed);
+    }
+    s->os = &os;
+    s->line.swap(line);
+    s->sequence.store(pos + 1, std::memory_order_release);
+}
+
+size_t _rocsparselt_async_logger::drain()
+{
+    size_t        lines = 0;
+    std::ostream* last  = nullptr;
+    for(;; tail++, lines++)
+    {
+        slot& s = slots[tail & mask];
+        if(s.sequence.load(std::memory_order_acquire) != tail + 1)
+            break;
+        if(last != nullptr && last != s.os)
+            last->flush();
+        last = s.os;
+        last->write(s.line.data(), s.line.size());
+        s.line.clear();
+        s.sequence.store(tail + mask + 1, std::memory_order_release);
+    }
+    if(last != nullptr)
+        last->flush();
+    return lines;
+}
+
+void _rocsparselt_async_logger::flush_loop()
+{
+    while(!stop.load(std::memory_order_acquire))
+    {
+        if(drain() == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
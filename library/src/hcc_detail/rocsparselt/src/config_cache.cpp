@@ -0,0 +1,92 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "utility.hpp"
+#include "config_cache.hpp"
+
+#include <algorithm>
+
+bool _rocsparselt_config_cache::find(const std::string&          signature,
+                                     _rocsparselt_matmul_config* configs,
+                                     int*                        config_max_id,
+                                     int*                        best_config_id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto                        it = lookup.find(signature);
+    if(it == lookup.end())
+    {
+        misses++;
+        return false;
+    }
+    hits++;
+    entries.splice(entries.begin(), entries, it->second);
+
+    const auto& entry = *it->second;
+    std::copy(entry.configs.begin(), entry.configs.end(), configs);
+    *config_max_id  = entry.configs.size();
+    *best_config_id = entry.best_config_id;
+    return true;
+}
+
+void _rocsparselt_config_cache::insert(const std::string&                signature,
+                                       const _rocsparselt_matmul_config* configs,
+                                       int                               config_max_id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if(capacity == 0 || lookup.count(signature))
+        return;
+
+    if(entries.size() == capacity)
+    {
+        lookup.erase(entries.back().signature);
+        entries.pop_back();
+        evictions++;
+    }
+
+    entries.emplace_front();
+    auto& entry     = entries.front();
+    entry.signature = signature;
+    entry.configs.resize(config_max_id);
+    std::copy(configs, configs + config_max_id, entry.configs.begin());
+    lookup[signature] = entries.begin();
+}
+
+void _rocsparselt_config_cache::set_best(const std::string& signature, int config_id)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto                        it = lookup.find(signature);
+    if(it != lookup.end())
+        it->second->best_config_id = config_id;
+}
+
+void _rocsparselt_config_cache::get_stats(rocsparselt_config_cache_stats* stats) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    stats->hits      = hits;
+    stats->misses    = misses;
+    stats->evictions = evictions;
+    stats->entries   = entries.size();
+    stats->capacity  = capacity;
+}
@@ -25,11 +25,16 @@
  *******************************************************************************/
 
 #include "handle.h"
+#include "async_logger.hpp"
+#include "config_cache.hpp"
 #include "definitions.h"
 #include "logging.h"
+#include "resource_pool.hpp"
 #include "status.h"
+#include "tracing.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
 #include <hip/hip_runtime.h>
 
 ROCSPARSELT_KERNEL void init_kernel(){};
@@ -74,6 +79,28 @@ void _rocsparselt_handle::init()
         log_bench = (atoi(str_layer_mode) > 0);
     }
 
+    // Code object loading
+    lazy_loading     = false;
+    prefetch_kernels = 0;
+    if((str_layer_mode = getenv("HIPSPARSELT_LAZY_LOADING")) != NULL)
+    {
+        lazy_loading = (atoi(str_layer_mode) > 0);
+    }
+    if((str_layer_mode = getenv("HIPSPARSELT_PREFETCH_KERNELS")) != NULL)
+    {
+        prefetch_kernels = std::max(atoi(str_layer_mode), 0);
+    }
+
+    // Stats of the plans, one matmul in plan_stats_sample_rate is timed
+    plan_stats_sample_rate = 0;
+    if((str_layer_mode = getenv("HIPSPARSELT_PLAN_STATS")) != NULL)
+    {
+        plan_stats_sample_rate = std::max(atoi(str_layer_mode), 0);
+    }
+
+    if((layer_mode & 0xff) || log_bench)
+        log_mutex = new std::mutex;
+
     // Open log file
     if(layer_mode & 0xff)
     {
@@ -88,6 +115,18 @@ void _rocsparselt_handle::init()
         open_log_stream(&log_bench_os, log_bench_ofs, "HIPSPARSELT_LOG_BENCH_FILE");
     }
 
+    // Lines held by the asynchronous logger, 0 writes them on the calling thread
+    if((layer_mode & 0xff) || log_bench)
+    {
+        size_t async_log_lines = 0;
+        if((str_layer_mode = getenv("HIPSPARSELT_LOG_ASYNC")) != NULL)
+        {
+            async_log_lines = strtoul(str_layer_mode, nullptr, 0);
+        }
+        if(async_log_lines > 0)
+            async_logger = new _rocsparselt_async_logger(async_log_lines);
+    }
+
     // Default device is active device
     THROW_IF_HIP_ERROR(hipGetDevice(&device));
     log_trace(this, "handle::init", "hipGetDevice");
@@ -105,14 +144,74 @@ void _rocsparselt_handle::init()
     asic_rev = 0;
 #endif
 
+    // the sparse MFMA instructions of the SMFMAC kernels, HIPSPARSELT_DISABLE_SMFMAC runs a
+    // device with them as one without
+    std::string arch(properties.gcnArchName);
+    smfmac = arch.compare(0, 5, "gfx94") == 0 || arch.compare(0, 5, "gfx95") == 0;
+    if((str_layer_mode = getenv("HIPSPARSELT_DISABLE_SMFMAC")) != NULL && atoi(str_layer_mode))
+        smfmac = false;
+
+    // the matmuls of unsupported sizes are padded instead of not implemented
+    if((str_layer_mode = getenv("HIPSPARSELT_PAD_SHAPES")) != NULL && atoi(str_layer_mode))
+        pad_shapes = true;
+
     is_init = (uintptr_t)(this);
 
     alg_selections = std::make_shared<std::vector<rocsparselt_matmul_alg_selection*>>();
+
+    // Launch variant of the prune and compress kernels, see launch_table.hpp
+    if((str_layer_mode = getenv("HIPSPARSELT_LAUNCH_VARIANT")) != NULL)
+    {
+        launch_variant = atoi(str_layer_mode);
+    }
+
+    // Capacity of the config cache, 0 disables it
+    size_t config_cache_size = 256;
+    if((str_layer_mode = getenv("HIPSPARSELT_CONFIG_CACHE_SIZE")) != NULL)
+    {
+        config_cache_size = strtoul(str_layer_mode, nullptr, 0);
+    }
+    config_cache = new _rocsparselt_config_cache(config_cache_size);
+
+    resource_pool = new _rocsparselt_resource_pool;
+
+    // Threads of the plan initializations in the background, the hardware threads by default
+    size_t init_threads = std::max(1u, std::thread::hardware_concurrency());
+    if((str_layer_mode = getenv("HIPSPARSELT_INIT_THREADS")) != NULL)
+    {
+        init_threads = std::max<size_t>(1, strtoul(str_layer_mode, nullptr, 0));
+    }
+    init_pool = new _rocsparselt_init_pool(device, init_threads);
+
+    // Size of the workspace pool, 0 disables it
+    size_t workspace_pool_size = 0;
+    if((str_layer_mode = getenv("HIPSPARSELT_WORKSPACE_POOL_SIZE")) != NULL)
+    {
+        workspace_pool_size = strtoull(str_layer_mode, nullptr, 0);
+    }
+    if(workspace_pool_size > 0)
+    {
+        workspace_pool = new _rocsparselt_workspace_pool(workspace_pool_size);
+        THROW_IF_HIP_ERROR(workspace_pool->init(device));
+    }
 }
 
 void _rocsparselt_handle::destroy()
 {
-    is_init = 0;
+    // the queued plan initializations run with the handle still valid
+    delete init_pool;
+    init_pool = nullptr;
+    is_init   = 0;
+    delete config_cache;
+    config_cache = nullptr;
+    delete resource_pool;
+    resource_pool = nullptr;
+    delete workspace_pool;
+    workspace_pool = nullptr;
+    // Write the pending GPU spans of the trace and the pending lines before closing the log files
+    rocsparselt_trace_flush();
+    delete async_logger;
+    async_logger = nullptr;
     // Close log files
     if(log_trace_ofs)
     {
@@ -128,6 +227,8 @@ void _rocsparselt_handle::destroy()
         delete log_bench_ofs;
         log_bench_ofs = nullptr;
     }
+    delete log_mutex;
+    log_mutex = nullptr;
 }
 
 std::ostream& operator<<(std::ostream& stream, const _rocsparselt_mat_descr& t)
@@ -160,9 +261,20 @@ std::ostream& operator<<(std::ostream& stream, const _rocsparselt_matmul_descr&
            << ", activation_tanh_alpha=" << t.activation_tanh_alpha
            << ", activation_tanh_beta=" << t.activation_tanh_beta
            << ", activation_gelu_scaling=" << t.activation_gelu_scaling
+           << ", activation_clamp_min=" << t.activation_clamp_min
+           << ", activation_clamp_max=" << t.activation_clamp_max
            << ", bias_pointer=" << t.bias_pointer << ", bias_stride=" << t.bias_stride
            << ", bias_type=" << rocsparselt_datatype_to_string(t.bias_type) << ", m=" << t.m
-           << ", n=" << t.n << ", k=" << t.k << ", is_sparse_a=" << t.is_sparse_a << "}";
+           << ", n=" << t.n << ", k=" << t.k << ", is_sparse_a=" << t.is_sparse_a
+           << ", alpha_vector_scaling=" << t.alpha_vector_scaling
+           << ", beta_vector_scaling=" << t.beta_vector_scaling << ", scale_a=" << t.scale_a
+           << ", scale_b=" << t.scale_b << ", d_scale=" << t.d_scale
+           << ", d_saturate=" << t.d_saturate << ", amax_d_pointer=" << t.amax_d_pointer
+           << ", residual_pointer=" << t.residual_pointer
+           << ", residual_stride=" << t.residual_stride << ", gate_pointer=" << t.gate_pointer
+           << ", gate_stride=" << t.gate_stride << ", bias_grad_pointer=" << t.bias_grad_pointer
+           << ", sparse_dynamic=" << t.sparse_dynamic << ", cu_count=" << t.cu_count
+           << ", candidates=" << t.candidates << ", label=" << t.label << "}";
     return stream;
 }
 
@@ -171,7 +283,8 @@ std::ostream& operator<<(std::ostream& stream, const _rocsparselt_matmul_alg_sel
     stream << "{"
            << "ptr=" << (&t) << ", alg=" << t.alg << ", config_id=" << t.config_id
            << ", config_max_id=" << t.config_max_id << ", search_iterations=" << t.search_iterations
-           << "}";
+           << ", search_flush_cache=" << t.search_flush_cache
+           << ", search_dense=" << t.search_dense << ", dense_selected=" << t.dense_selected << "}";
     return stream;
 }
 
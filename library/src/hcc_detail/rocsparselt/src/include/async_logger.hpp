@@ -0,0 +1,125 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+#ifndef ASYNC_LOGGER_HPP
+#define ASYNC_LOGGER_HPP
+
+#include <atomic>
+#include <memory>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+
+/*******************************************************************************
+ * rocsparselt_log_line is a line being formatted on the calling thread. Its
+ * stream appends to a string which keeps its capacity, so that formatting the
+ * lines of a thread stops allocating once it has seen its longest line.
+ ******************************************************************************/
+class rocsparselt_log_line : private std::streambuf
+{
+public:
+    rocsparselt_log_line()
+        : os(this)
+    {
+    }
+
+    // the line of the calling thread, cleared
+    static rocsparselt_log_line& thread_line();
+
+    std::ostream& stream()
+    {
+        return os;
+    }
+    std::string& str()
+    {
+        return line;
+    }
+
+private:
+    int_type overflow(int_type c) override
+    {
+        if(c != traits_type::eof())
+            line.push_back(traits_type::to_char_type(c));
+        return c;
+    }
+    std::streamsize xsputn(const char* s, std::streamsize n) override
+    {
+        line.append(s, n);
+        return n;
+    }
+
+    std::string  line;
+    std::ostream os;
+};
+
+/*******************************************************************************
+ * _rocsparselt_async_logger writes the lines logged on a handle to their
+ * stream from a background thread. The calling threads hand their formatted
+ * line over to a bounded ring without taking a lock and return at once; a
+ * line logged while the ring is full is dropped and counted. The lines of a
+ * thread keep their order, the lines of concurrent threads do not interleave.
+ * The ring is drained when the logger is destroyed.
+ ******************************************************************************/
+struct _rocsparselt_async_logger
+{
+    // capacity is rounded up to a power of two
+    explicit _rocsparselt_async_logger(size_t capacity);
+    ~_rocsparselt_async_logger();
+
+    // hands line over to the flusher, line gets back the storage of a flushed line
+    void push(std::ostream& os, std::string& line);
+
+    size_t dropped() const
+    {
+        return dropped_lines.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct slot
+    {
+        std::atomic<size_t> sequence{0};
+        std::ostream*       os = nullptr;
+        std::string         line;
+    };
+
+    // writes the lines pushed so far, returns how many
+    size_t drain();
+    void   flush_loop();
+
+    size_t                  mask;
+    std::unique_ptr<slot[]> slots;
+    // next position to push, claimed by the calling threads
+    std::atomic<size_t> head{0};
+    // next position to write, owned by the flusher
+    size_t              tail = 0;
+    std::atomic<size_t> dropped_lines{0};
+    std::atomic<bool>   stop{false};
+    std::thread         flusher;
+};
+
+#endif // ASYNC_LOGGER_HPP
@@ -0,0 +1,84 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef CONFIG_CACHE_HPP
+#define CONFIG_CACHE_HPP
+
+#include "handle.h"
+#include "utility.hpp"
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/*******************************************************************************
+ * _rocsparselt_config_cache maps the signature of a problem (see
+ * rocsparselt_tuning_signature()) to the configs found for it and to the
+ * config_id selected by the last search, so plans of identical problems skip
+ * the lookup of the backend. The least recently used entry is evicted once
+ * the cache holds capacity entries.
+ ******************************************************************************/
+struct _rocsparselt_config_cache
+{
+    explicit _rocsparselt_config_cache(size_t capacity)
+        : capacity(capacity)
+    {
+    }
+
+    // copies the configs of signature, best_config_id is -1 when it was never searched
+    bool find(const std::string&          signature,
+              _rocsparselt_matmul_config* configs,
+              int*                        config_max_id,
+              int*                        best_config_id);
+
+    void insert(const std::string&                signature,
+                const _rocsparselt_matmul_config* configs,
+                int                               config_max_id);
+
+    void set_best(const std::string& signature, int config_id);
+
+    void get_stats(rocsparselt_config_cache_stats* stats) const;
+
+private:
+    struct entry_t
+    {
+        std::string                             signature;
+        std::vector<_rocsparselt_matmul_config> configs;
+        int                                     best_config_id = -1;
+    };
+
+    mutable std::mutex                                            mutex;
+    size_t                                                        capacity;
+    std::list<entry_t>                                            entries;
+    std::unordered_map<std::string, std::list<entry_t>::iterator> lookup;
+    int64_t                                                       hits      = 0;
+    int64_t                                                       misses    = 0;
+    int64_t                                                       evictions = 0;
+};
+
+#endif
@@ -0,0 +1,116 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef CONFIG_HEURISTIC_HPP
+#define CONFIG_HEURISTIC_HPP
+
+#include "handle.h"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+/*******************************************************************************
+ * The selection heuristic ranks the configs of a problem before any of them
+ * runs, so that the default config 0 of a problem outside the tuned sizes is
+ * not only the first one the kernel library lists. It models the time of a
+ * kernel from its macro tile, its unroll of K and its Split-K factor on the
+ * CUs the matmul runs on: the tiles run in waves of one tile per CU, the last
+ * partial wave idles the other CUs, every tile runs whole unrolls of its slice
+ * of K, a small tile loads more of A and B per MAC, and the reduce kernel of a
+ * Split-K config reads the partial tiles of D back. The score of a config is
+ * the fraction of the peak MAC rate this time predicts; the constants are
+ * coarse, the scores only compare the configs of one problem.
+ ******************************************************************************/
+struct rocsparselt_config_shape
+{
+    int64_t macro_tile0   = 0;
+    int64_t macro_tile1   = 0;
+    int64_t depth_u       = 1;
+    int64_t split_k       = 1;
+    bool    reduce_kernel = false; // the partial results are reduced by a second kernel
+};
+
+/*! \brief predicted time of the kernel of shape on the m x n x k problem of batch_count
+ *         matrices over cus CUs, in MACs of one CU */
+inline double rocsparselt_config_time(const rocsparselt_config_shape& shape,
+                                      int64_t                         m,
+                                      int64_t                         n,
+                                      int64_t                         k,
+                                      int64_t                         batch_count,
+                                      int                             cus)
+{
+    // loads of A and B per MAC of a tile, relative to its area, and reads of a partial tile
+    // of D per MAC by the reduce kernel
+    constexpr double load_cost   = 32.0;
+    constexpr double reduce_cost = 64.0;
+
+    if(m <= 0 || n <= 0 || batch_count <= 0)
+        return 0.0;
+    const int64_t mt0     = std::max<int64_t>(shape.macro_tile0, 1);
+    const int64_t mt1     = std::max<int64_t>(shape.macro_tile1, 1);
+    const int64_t depth_u = std::max<int64_t>(shape.depth_u, 1);
+    const int64_t split_k = std::max<int64_t>(shape.split_k, 1);
+
+    auto ceil_div = [](int64_t num, int64_t den) { return (num + den - 1) / den; };
+
+    const int64_t tiles  = ceil_div(m, mt0) * ceil_div(n, mt1) * batch_count * split_k;
+    const int64_t waves  = ceil_div(tiles, std::max(cus, 1));
+    const int64_t k_loop = ceil_div(ceil_div(std::max<int64_t>(k, 1), split_k), depth_u) * depth_u;
+
+    double time = double(waves) * double(mt0 * mt1) * double(k_loop)
+                  * (1.0 + load_cost * double(mt0 + mt1) / double(mt0 * mt1));
+    if(shape.reduce_kernel && split_k > 1)
+        time += reduce_cost * double(m * n * batch_count * split_k) / std::max(cus, 1);
+    return time;
+}
+
+/*! \brief the score of a config whose predicted time is time, the fraction of the peak MAC rate
+ *         of cus CUs it reaches on the m x n x k problem of batch_count matrices */
+inline float rocsparselt_config_score(
+    double time, int64_t m, int64_t n, int64_t k, int64_t batch_count, int cus)
+{
+    if(time <= 0.0)
+        return 0.0f;
+    return float(double(m) * double(n) * double(std::max<int64_t>(k, 1)) * double(batch_count)
+                 / (double(std::max(cus, 1)) * time));
+}
+
+/*! \brief order the count configs by decreasing score, the configs of equal scores keep their
+ *         order, and keep the first candidates of them when candidates is positive */
+inline void
+    rocsparselt_rank_configs(_rocsparselt_matmul_config* configs, int* count, int candidates)
+{
+    std::stable_sort(configs,
+                     configs + *count,
+                     [](const _rocsparselt_matmul_config& a, const _rocsparselt_matmul_config& b) {
+                         return a.score > b.score;
+                     });
+    if(candidates > 0)
+        *count = std::min(*count, candidates);
+}
+
+#endif
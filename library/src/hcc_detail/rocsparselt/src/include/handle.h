@@ -26,12 +26,16 @@
 #ifndef HANDLE_H
 #define HANDLE_H
 
+#include "init_pool.hpp"
 #include "rocsparselt.h"
 
+#include <atomic>
 #include <fstream>
 #include <hip/hip_runtime_api.h>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 /********************************************************************************
@@ -41,6 +45,12 @@
  * to all subsequent library function calls.
  * It should be destroyed at the end using rocsparse_destroy_handle().
  *******************************************************************************/
+struct _rocsparselt_async_logger;
+struct _rocsparselt_config_cache;
+struct _rocsparselt_init_pool;
+struct _rocsparselt_resource_pool;
+struct _rocsparselt_workspace_pool;
+
 struct _rocsparselt_handle
 {
     // constructor
@@ -64,6 +74,12 @@ struct _rocsparselt_handle
     int wavefront_size = 0;
     // asic revision
     int asic_rev;
+    // whether the device has the SMFMAC instructions of the sparse kernels, gfx940 and later;
+    // without them every matmul runs the dense path, see rocsparselt_spmm_dense.hpp
+    bool smfmac = true;
+    // plan the matmuls of the sizes the kernels do not support for zero-padded matrices,
+    // HIPSPARSELT_PAD_SHAPES, see rocsparselt_pad.hpp
+    bool pad_shapes = false;
 
     // pointer mode ; default mode is host
     rocsparselt_pointer_mode pointer_mode = rocsparselt_pointer_mode_host;
@@ -71,6 +87,16 @@ struct _rocsparselt_handle
     int  layer_mode;
     bool log_bench = false;
 
+    // load the code objects of the kernel launcher on first use, but the first prefetch_kernels
+    bool lazy_loading     = false;
+    int  prefetch_kernels = 0;
+
+    // one matmul in plan_stats_sample_rate of the plans is timed on the GPU, 0 for no stats
+    int plan_stats_sample_rate = 0;
+
+    // the launch variant of the prune and compress kernels, -1 for the one of the launch table
+    int launch_variant = -1;
+
     // device buffer
     size_t    buffer_size;
     void*     buffer;
@@ -81,9 +107,22 @@ struct _rocsparselt_handle
     std::ofstream* log_bench_ofs = nullptr;
     std::ostream*  log_trace_os  = nullptr;
     std::ostream*  log_bench_os  = nullptr;
+    // serializes the lines written to the logging streams by concurrent calls
+    std::mutex* log_mutex = nullptr;
+    // writes the lines to the logging streams from a background thread, nullptr when disabled
+    _rocsparselt_async_logger* async_logger = nullptr;
 
     // hold pointers to alg_selection objects for releasing algo configs inside them.
     std::shared_ptr<std::vector<rocsparselt_matmul_alg_selection*>> alg_selections;
+
+    // configs found for the problems of the plans created with this handle
+    _rocsparselt_config_cache* config_cache = nullptr;
+    // events, streams and scratch buffers reused by the search and the checks
+    _rocsparselt_resource_pool* resource_pool = nullptr;
+    // workspaces of the matmuls given a NULL one, nullptr when disabled
+    _rocsparselt_workspace_pool* workspace_pool = nullptr;
+    // threads of rocsparselt_matmul_plan_init_async()
+    _rocsparselt_init_pool* init_pool = nullptr;
 };
 
 /********************************************************************************
@@ -207,6 +246,8 @@ struct _rocsparselt_matmul_descr
         , activation_tanh_alpha(rhs.activation_tanh_alpha)
         , activation_tanh_beta(rhs.activation_tanh_beta)
         , activation_gelu_scaling(rhs.activation_gelu_scaling)
+        , activation_clamp_min(rhs.activation_clamp_min)
+        , activation_clamp_max(rhs.activation_clamp_max)
         , bias_pointer(rhs.bias_pointer)
         , bias_stride(rhs.bias_stride)
         , bias_type(rhs.bias_type)
@@ -214,7 +255,23 @@ struct _rocsparselt_matmul_descr
         , n(rhs.n)
         , k(rhs.k)
         , is_sparse_a(rhs.is_sparse_a)
+        , alpha_vector_scaling(rhs.alpha_vector_scaling)
+        , beta_vector_scaling(rhs.beta_vector_scaling)
+        , scale_a(rhs.scale_a)
+        , scale_b(rhs.scale_b)
+        , d_scale(rhs.d_scale)
+        , d_saturate(rhs.d_saturate)
+        , amax_d_pointer(rhs.amax_d_pointer)
+        , residual_pointer(rhs.residual_pointer)
+        , residual_stride(rhs.residual_stride)
+        , gate_pointer(rhs.gate_pointer)
+        , gate_stride(rhs.gate_stride)
+        , bias_grad_pointer(rhs.bias_grad_pointer)
+        , sparse_dynamic(rhs.sparse_dynamic)
+        , cu_count(rhs.cu_count)
+        , candidates(rhs.candidates)
     {
+        memcpy(label, rhs.label, sizeof(label));
         matrix_A     = rhs.matrix_A->clone();
         matrix_B     = rhs.matrix_B->clone();
         matrix_C     = rhs.matrix_C->clone();
@@ -267,6 +324,8 @@ struct _rocsparselt_matmul_descr
     float                activation_tanh_alpha      = 1.0f;
     float                activation_tanh_beta       = 1.0f;
     float                activation_gelu_scaling    = 1.0f;
+    float                activation_clamp_min       = -std::numeric_limits<float>::infinity();
+    float                activation_clamp_max       = std::numeric_limits<float>::infinity();
     float*               bias_pointer               = nullptr;
     int64_t              bias_stride                = 0;
     rocsparselt_datatype bias_type;
@@ -274,6 +333,70 @@ struct _rocsparselt_matmul_descr
     int64_t              n           = 0;
     int64_t              k           = 0;
     bool                 is_sparse_a = true;
+    // alpha and beta of the matmul are device vectors of m scales when set
+    int alpha_vector_scaling = 0;
+    int beta_vector_scaling  = 0;
+    // scales of A and B, they multiply alpha when the matmul runs
+    float scale_a = 1.0f;
+    float scale_b = 1.0f;
+    // scale and saturation of D, and the device float receiving amax(D), applied by the
+    // reduce kernel of the Split-K configs
+    float  d_scale        = 1.0f;
+    int    d_saturate     = 0;
+    float* amax_d_pointer = nullptr;
+    // residual matrix of the type and the layout of D added after the activation, also applied
+    // by the reduce kernel
+    void*   residual_pointer = nullptr;
+    int64_t residual_stride  = 0;
+    // gate matrix of the type and the layout of D multiplying the activated result, before the
+    // residual, also applied by the reduce kernel
+    void*   gate_pointer = nullptr;
+    int64_t gate_stride  = 0;
+    // device vector of m floats receiving the sums of the rows of D over its columns and its
+    // batches, the gradient of the bias, summed by the reduce kernel too
+    float* bias_grad_pointer = nullptr;
+    // the structured operand of the matmul is dense, pruned and compressed to the workspace by
+    // the matmul before it multiplies
+    int sparse_dynamic = 0;
+    // CUs the configs are selected and scheduled for, as on a CU-masked stream, 0 for all the
+    // CUs of the device
+    int cu_count = 0;
+    // configs the algorithm selection keeps of the ones ranked by the selection heuristic,
+    // 0 for the default count of the backend
+    int candidates = 0;
+    // names the roctx ranges of the matmul, NUL-terminated
+    char label[64] = {};
+
+    int effective_cu_count() const
+    {
+        return cu_count > 0 ? cu_count : handle->properties.multiProcessorCount;
+    }
+
+    // columns of D, over all its batches, a thread of the reduce kernel sums into the partial
+    // sums of the bias gradient
+    static constexpr size_t bias_grad_columns = 64;
+
+    // bytes of the partial sums of the bias gradient, which follow the buffers of the splits
+    // in the workspace of a Split-K config
+    size_t bias_grad_workspace_bytes() const
+    {
+        if(bias_grad_pointer == nullptr)
+            return 0;
+        size_t columns = size_t(n) * matrix_D->num_batches;
+        return size_t(m) * ((columns + bias_grad_columns - 1) / bias_grad_columns)
+               * sizeof(float);
+    }
+
+    // whether the matmul needs the epilogue of the reduce kernel of a Split-K config, the
+    // compiled kernels have no SiLU nor clamp activation either and write no int32 D
+    bool needs_reduce_epilogue() const
+    {
+        return alpha_vector_scaling || d_scale != 1.0f || d_saturate || amax_d_pointer
+               || residual_pointer || gate_pointer || bias_grad_pointer
+               || activation == rocsparselt_matmul_activation_silu
+               || activation == rocsparselt_matmul_activation_clamp
+               || matrix_D->type == rocsparselt_datatype_i32_r;
+    }
 
 private:
     bool      is_reference = true;
@@ -289,11 +412,27 @@ struct __attribute__((packed, aligned(8))) _rocsparselt_matmul_config
     {
         this->index               = rhs.index;
         this->max_workspace_bytes = rhs.max_workspace_bytes;
+        this->split_k             = rhs.split_k;
+        this->split_k_mode        = rhs.split_k_mode;
+        this->stream_k_index      = rhs.stream_k_index;
+        this->stream_k_columns    = rhs.stream_k_columns;
+        this->score               = rhs.score;
     }
 
     int    index;
     int    use_bias            = 0;
     size_t max_workspace_bytes = 0;
+    // the Split-K factor of the kernel and how its partial results are reduced
+    int split_k      = 1;
+    int split_k_mode = rocsparselt_split_k_mode_two_kernels;
+    // a Stream-K config runs the first stream_k_columns columns of D on the kernel of index
+    // and the others, the last partial wave of tiles, on the Split-K kernel stream_k_index
+    int stream_k_index   = -1;
+    int stream_k_columns = 0;
+    // left out of the search by the Split-K attributes of the algorithm selection
+    bool excluded = false;
+    // fraction of the peak the selection heuristic predicts, see config_heuristic.hpp
+    float score = 0.0f;
 };
 
 /********************************************************************************
@@ -309,6 +448,8 @@ struct _rocsparselt_matmul_alg_selection
         : handle(handle)
     {
         is_init = (uintptr_t)handle;
+        for(auto& result : search_results)
+            result.config_id = -1;
     };
     // destructor
     ~_rocsparselt_matmul_alg_selection()
@@ -331,10 +472,398 @@ struct _rocsparselt_matmul_alg_selection
 
     rocsparselt_matmul_alg alg;
     //data of rocsparselt_matmul_alg_attribute
-    int       config_id         = 0;
-    int       config_max_id     = 0;
-    int       search_iterations = 10;
-    uintptr_t is_init           = 0;
+    int       config_id          = 0;
+    int       config_max_id      = 0;
+    int       search_iterations  = 10;
+    int       search_flush_cache = 0;
+    uintptr_t is_init            = 0;
+    // Split-K factor, mode and Stream-K schedule the configs are restricted to,
+    // 0, -1 and -1 when not set
+    int split_k      = 0;
+    int split_k_mode = -1;
+    int stream_k     = -1;
+    // only the configs which run the epilogue of D in their reduce kernel, for the vector
+    // scaling, the scale and saturation of D and amax(D)
+    bool reduce_epilogue = false;
+
+    // whether the search also times the dense path, and whether it was faster than the best
+    // config: the matmul then runs the dense path, see rocsparselt_spmm_dense.hpp
+    int search_dense   = 0;
+    int dense_selected = 0;
+    // the device has no SMFMAC instructions and there are no configs: the matmul always runs
+    // the dense path, dense_selected is set and the search times nothing else
+    int dense_only = 0;
+
+    // the fastest configs measured by the last search, see rocsparselt_search_store_results
+    static constexpr int             max_search_results = 16;
+    rocsparselt_matmul_search_result search_results[max_search_results] = {};
+};
+
+/********************************************************************************
+ * \brief _rocsparselt_solution_cache holds the backend objects (problem,
+ * solution) resolved for a plan, so they are not rebuilt on every matmul.
+ * Its content is defined by the backend (tensile_host.cpp or kernel_launcher.cpp).
+ *******************************************************************************/
+struct _rocsparselt_solution_cache;
+
+_rocsparselt_solution_cache* rocsparselt_solution_cache_create();
+void                         rocsparselt_solution_cache_destroy(_rocsparselt_solution_cache* cache);
+
+/********************************************************************************
+ * \brief _rocsparselt_stream_events holds the events used to fork the batches of
+ * a matmul from streams[0] to the other streams and to join them back. A call
+ * leases a set of events with acquire(), forks and joins with it, and gives it
+ * back when the lease goes out of scope, so that the calls of several threads
+ * on one plan do not wait for each other. The sets are created on the first
+ * multi-stream calls and reused afterwards.
+ *******************************************************************************/
+struct _rocsparselt_stream_events
+{
+    struct set_t
+    {
+        ~set_t()
+        {
+            for(auto event : events)
+                (void)hipEventDestroy(event);
+        }
+
+        // makes sure that at least n events exist
+        hipError_t reserve(size_t n)
+        {
+            while(events.size() < n)
+            {
+                hipEvent_t event;
+                hipError_t status = hipEventCreateWithFlags(&event, hipEventDisableTiming);
+                if(status != hipSuccess)
+                    return status;
+                events.push_back(event);
+            }
+            return hipSuccess;
+        }
+
+        // makes streams[1..n) wait for the work queued on streams[0]
+        hipError_t fork(hipStream_t* streams, size_t n)
+        {
+            hipError_t status = reserve(n);
+            if(status == hipSuccess)
+                status = hipEventRecord(events[0], streams[0]);
+            for(size_t i = 1; i < n && status == hipSuccess; i++)
+                status = hipStreamWaitEvent(streams[i], events[0], 0);
+            return status;
+        }
+
+        // makes streams[0] wait for the work queued on streams[1..n), after fork()
+        hipError_t join(hipStream_t* streams, size_t n)
+        {
+            hipError_t status = hipSuccess;
+            for(size_t i = 1; i < n && status == hipSuccess; i++)
+            {
+                status = hipEventRecord(events[i], streams[i]);
+                if(status == hipSuccess)
+                    status = hipStreamWaitEvent(streams[0], events[i], 0);
+            }
+            return status;
+        }
+
+        std::vector<hipEvent_t> events;
+    };
+
+    // a set of events used by one call, given back to the pool when it goes out of scope
+    class lease
+    {
+    public:
+        lease() = default;
+        lease(_rocsparselt_stream_events* pool, std::unique_ptr<set_t> set)
+            : pool(pool)
+            , set(std::move(set))
+        {
+        }
+        lease(lease&&)            = default;
+        lease& operator=(lease&&) = default;
+        ~lease()
+        {
+            if(set)
+                pool->release(std::move(set));
+        }
+
+        set_t* operator->() const
+        {
+            return set.get();
+        }
+
+    private:
+        _rocsparselt_stream_events* pool = nullptr;
+        std::unique_ptr<set_t>      set;
+    };
+
+    lease acquire()
+    {
+        std::unique_ptr<set_t> set;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!free_sets.empty())
+            {
+                set = std::move(free_sets.back());
+                free_sets.pop_back();
+            }
+        }
+        if(!set)
+            set = std::make_unique<set_t>();
+        return lease(this, std::move(set));
+    }
+
+private:
+    void release(std::unique_ptr<set_t> set)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        free_sets.push_back(std::move(set));
+    }
+
+    // the mutex is only held to take a set from the free list or to give one back
+    std::mutex                          mutex;
+    std::vector<std::unique_ptr<set_t>> free_sets;
+};
+
+/********************************************************************************
+ * \brief _rocsparselt_search_worker runs rocsparselt_matmul_search_async() of a
+ * plan on a background thread. Destroying it waits for the search to finish.
+ *******************************************************************************/
+struct _rocsparselt_search_worker
+{
+    ~_rocsparselt_search_worker()
+    {
+        wait();
+    }
+
+    // waits for the running search, if any, and returns the status of the last one
+    rocsparselt_status wait()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(thread.joinable())
+            thread.join();
+        return status;
+    }
+
+    std::mutex         mutex;
+    std::thread        thread;
+    std::atomic<bool>  running{false};
+    rocsparselt_status status = rocsparselt_status_success;
+};
+
+/********************************************************************************
+ * \brief _rocsparselt_matmul_graph_args records the arguments a graph executable
+ * was last captured with by rocsparselt_matmul_graph_launch(), so replaying it
+ * with the same arguments does not need to update the graph nodes.
+ *******************************************************************************/
+struct _rocsparselt_matmul_graph_args
+{
+    bool operator==(const _rocsparselt_matmul_graph_args& rhs) const
+    {
+        return exec == rhs.exec && config_id == rhs.config_id && d_A == rhs.d_A
+               && d_B == rhs.d_B && d_C == rhs.d_C && d_D == rhs.d_D
+               && workspace == rhs.workspace && alpha == rhs.alpha && beta == rhs.beta;
+    }
+
+    hipGraphExec_t exec      = nullptr;
+    int            config_id = -1;
+    const void*    d_A       = nullptr;
+    const void*    d_B       = nullptr;
+    const void*    d_C       = nullptr;
+    void*          d_D       = nullptr;
+    void*          workspace = nullptr;
+    float          alpha     = 0.0f;
+    float          beta      = 0.0f;
+};
+
+/********************************************************************************
+ * \brief _rocsparselt_n_buckets holds the configs of a plan for the N given to
+ * rocsparselt_matmul_dynamic_n(). N is rounded up to a power of two, its bucket,
+ * whose configs are looked up on its first call, as the algorithm selection of a
+ * descriptor of that N would be, so the tuning database and the searches of plans
+ * of that N also select the config of the bucket.
+ *******************************************************************************/
+struct _rocsparselt_n_buckets
+{
+    static constexpr int max_buckets = 64;
+
+    ~_rocsparselt_n_buckets()
+    {
+        for(auto& bucket : buckets)
+            delete bucket.load();
+    }
+
+    // the bucket of the N in (2^(i-1), 2^i]
+    static int index(int64_t n)
+    {
+        int i = 0;
+        while((int64_t(1) << i) < n)
+            i++;
+        return i;
+    }
+
+    // published once complete, the mutex is only held to create a bucket
+    std::atomic<_rocsparselt_matmul_alg_selection*> buckets[max_buckets] = {};
+    std::mutex                                      mutex;
+};
+
+/********************************************************************************
+ * \brief _rocsparselt_plan_stats holds the counters of a plan when the handle
+ * samples the matmuls, see HIPSPARSELT_PLAN_STATS. Every call counts its host time
+ * and its workspace, and one call in sample_rate is timed on streams[0] by a pair
+ * of events. The events are only read once they completed, by a later sampled
+ * call or by rocsparselt_matmul_plan_get_stats(), so no stream is synchronized.
+ *******************************************************************************/
+struct _rocsparselt_plan_stats
+{
+    // timed calls whose events did not complete yet, a sample is dropped beyond them
+    static constexpr size_t max_pending = 64;
+
+    explicit _rocsparselt_plan_stats(int sample_rate)
+        : sample_rate(sample_rate)
+    {
+    }
+    ~_rocsparselt_plan_stats()
+    {
+        for(auto& sample : pending)
+        {
+            (void)hipEventDestroy(sample.first);
+            (void)hipEventDestroy(sample.second);
+        }
+        for(auto event : free_events)
+            (void)hipEventDestroy(event);
+    }
+
+    // starts the call number call, the start event of a timed call is recorded on stream
+    hipError_t start(int64_t call, hipStream_t stream, hipEvent_t* event)
+    {
+        *event = nullptr;
+        if(call % sample_rate != 0)
+            return hipSuccess;
+        std::lock_guard<std::mutex> lock(mutex);
+        collect_locked();
+        if(pending.size() >= max_pending)
+            return hipSuccess;
+        hipError_t status = acquire_locked(event);
+        if(status == hipSuccess)
+            status = hipEventRecord(*event, stream);
+        if(status != hipSuccess && *event != nullptr)
+        {
+            free_events.push_back(*event);
+            *event = nullptr;
+        }
+        return status;
+    }
+
+    // ends a timed call, its GPU time is counted once the stop event recorded on stream
+    // completed, or drops it when the call failed
+    hipError_t stop(hipEvent_t start, hipStream_t stream, bool success)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        hipEvent_t                  stop   = nullptr;
+        hipError_t                  status = success ? acquire_locked(&stop) : hipSuccess;
+        if(success && status == hipSuccess)
+            status = hipEventRecord(stop, stream);
+        if(success && status == hipSuccess)
+        {
+            pending.emplace_back(start, stop);
+            return hipSuccess;
+        }
+        free_events.push_back(start);
+        if(stop != nullptr)
+            free_events.push_back(stop);
+        return status;
+    }
+
+    void collect()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        collect_locked();
+    }
+
+    // counts the host time and the workspace of a call
+    void count(int64_t host_ns, size_t workspace)
+    {
+        host_time_ns.fetch_add(host_ns, std::memory_order_relaxed);
+        workspace_bytes.store(workspace, std::memory_order_relaxed);
+        size_t max_bytes = max_workspace_bytes.load(std::memory_order_relaxed);
+        while(max_bytes < workspace
+              && !max_workspace_bytes.compare_exchange_weak(max_bytes, workspace))
+        {
+        }
+    }
+
+    const int sample_rate;
+
+    std::atomic<int64_t> calls{0};
+    std::atomic<int64_t> host_time_ns{0};
+    std::atomic<size_t>  workspace_bytes{0};
+    std::atomic<size_t>  max_workspace_bytes{0};
+
+    // under the mutex
+    std::mutex mutex;
+    int64_t    timed_calls = 0;
+    double     gpu_time_ms = 0.0;
+
+private:
+    hipError_t acquire_locked(hipEvent_t* event)
+    {
+        if(free_events.empty())
+            return hipEventCreate(event);
+        *event = free_events.back();
+        free_events.pop_back();
+        return hipSuccess;
+    }
+
+    // counts the timed calls whose stop event completed, in the order they were queued
+    void collect_locked()
+    {
+        size_t done = 0;
+        for(; done < pending.size(); done++)
+        {
+            auto& sample = pending[done];
+            if(hipEventQuery(sample.second) != hipSuccess)
+                break;
+            float ms = 0.0f;
+            if(hipEventElapsedTime(&ms, sample.first, sample.second) == hipSuccess)
+            {
+                timed_calls++;
+                gpu_time_ms += ms;
+            }
+            free_events.push_back(sample.first);
+            free_events.push_back(sample.second);
+        }
+        pending.erase(pending.begin(), pending.begin() + done);
+    }
+
+    std::vector<std::pair<hipEvent_t, hipEvent_t>> pending;
+    std::vector<hipEvent_t>                        free_events;
+};
+
+/********************************************************************************
+ * \brief _rocsparselt_widened_operand keeps the compressed int8 matrix of a mixed
+ * input plan widened to the type of its kernels. A matmul widens the compressed
+ * matrix it is given once, and the following matmuls given the same matrix read
+ * the copy. A mixed input thus only saves the storage of the int8 weights, the
+ * device holds their widened copy as well. The copy is widened again after any
+ * function of the library wrote a compressed matrix, see
+ * rocsparselt_compressed_matrix_written(). The values of the compressed matrix
+ * changed otherwise, by a copy of the caller, are not seen by the plan.
+ *******************************************************************************/
+struct _rocsparselt_widened_operand
+{
+    ~_rocsparselt_widened_operand()
+    {
+        if(ready != nullptr)
+            (void)hipEventDestroy(ready);
+        if(data != nullptr)
+            (void)hipFree(data);
+    }
+
+    std::mutex  mutex;
+    const void* source = nullptr; // the compressed matrix data holds widened
+    uint64_t    writes = 0;       // the compressed matrix writes counted when source was widened
+    void*       data   = nullptr;
+    hipEvent_t  ready  = nullptr; // recorded once data holds source widened
 };
 
 /********************************************************************************
@@ -360,16 +889,63 @@ struct _rocsparselt_matmul_plan
     bool isInit() const
     {
         if(is_init != 0 && is_init == (uintptr_t)handle)
+        {
+            // a plan of rocsparselt_matmul_plan_init_async() is used once it is ready
+            if(init_task != nullptr)
+                init_task->wait();
             return (matmul_descr == nullptr || alg_selection == nullptr) ? false : true;
+        }
         return false;
     }
 
+    // moves the objects of rhs, a plan initialized in the background, to the plan
+    void take(_rocsparselt_matmul_plan& rhs)
+    {
+        matmul_descr       = rhs.matmul_descr;
+        alg_selection      = rhs.alg_selection;
+        solution_cache     = rhs.solution_cache;
+        stream_events      = rhs.stream_events;
+        search_worker      = rhs.search_worker;
+        n_buckets          = rhs.n_buckets;
+        unpadded_descr     = rhs.unpadded_descr;
+        stats              = rhs.stats;
+        widened            = rhs.widened;
+        rhs.matmul_descr   = nullptr;
+        rhs.alg_selection  = nullptr;
+        rhs.solution_cache = nullptr;
+        rhs.stream_events  = nullptr;
+        rhs.search_worker  = nullptr;
+        rhs.n_buckets      = nullptr;
+        rhs.unpadded_descr = nullptr;
+        rhs.stats          = nullptr;
+        rhs.widened        = nullptr;
+        rhs.is_init        = 0;
+    }
+
     void clear()
     {
+        // the background search still uses the plan
+        delete search_worker;
+        delete init_task;
         delete matmul_descr;
-        matmul_descr  = nullptr;
-        alg_selection = nullptr;
-        is_init       = 0;
+        delete unpadded_descr;
+        rocsparselt_solution_cache_destroy(solution_cache);
+        delete stream_events;
+        delete n_buckets;
+        delete stats;
+        delete widened;
+        matmul_descr   = nullptr;
+        alg_selection  = nullptr;
+        solution_cache = nullptr;
+        stream_events  = nullptr;
+        search_worker  = nullptr;
+        init_task      = nullptr;
+        n_buckets      = nullptr;
+        unpadded_descr = nullptr;
+        stats          = nullptr;
+        widened        = nullptr;
+        graph_args     = {};
+        is_init        = 0;
     }
 
     friend std::ostream& operator<<(std::ostream& stream, const _rocsparselt_matmul_plan& t);
@@ -379,6 +955,26 @@ struct _rocsparselt_matmul_plan
     _rocsparselt_matmul_descr* matmul_descr = nullptr;
     //
     _rocsparselt_matmul_alg_selection* alg_selection = nullptr;
+    // backend objects resolved for the selected config
+    _rocsparselt_solution_cache* solution_cache = nullptr;
+    // events joining the streams of a batched matmul
+    _rocsparselt_stream_events* stream_events = nullptr;
+    // background search started by rocsparselt_matmul_search_async(), created with the
+    // plan so that concurrent calls on the plan find the same worker
+    _rocsparselt_search_worker* search_worker = nullptr;
+    // background initialization started by rocsparselt_matmul_plan_init_async()
+    _rocsparselt_plan_init_task* init_task = nullptr;
+    // arguments of the last graph replayed by rocsparselt_matmul_graph_launch()
+    _rocsparselt_matmul_graph_args graph_args;
+
+    // configs of the N of rocsparselt_matmul_dynamic_n()
+    _rocsparselt_n_buckets* n_buckets = nullptr;
+    // the matmul of the caller when matmul_descr is its padded problem, nullptr otherwise
+    _rocsparselt_matmul_descr* unpadded_descr = nullptr;
+    // counters of the matmuls, nullptr unless the handle samples them
+    _rocsparselt_plan_stats* stats = nullptr;
+    // the widened compressed matrix of a mixed input plan, nullptr otherwise
+    _rocsparselt_widened_operand* widened = nullptr;
 
     //
     uintptr_t is_init = 0;
@@ -30,12 +30,35 @@
 #include "kernel_arguments.hpp"
 #include <hip/hip_runtime.h>
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 
 class SolutionAdapter
 {
+    struct module_entry;
+
 public:
+    // A pin keeps the code object of a kernel loaded, the kernels of the invocations bound
+    // for a plan are pinned as long as the plan keeps them.
+    class ModulePin
+    {
+    public:
+        ModulePin() = default;
+        ModulePin(ModulePin&& rhs) noexcept = default;
+        ModulePin& operator=(ModulePin&& rhs) noexcept;
+        ~ModulePin();
+
+        void reset();
+
+    private:
+        friend class SolutionAdapter;
+        std::shared_ptr<module_entry> m_entry;
+    };
+
     SolutionAdapter();
     SolutionAdapter(std::string const& name);
     ~SolutionAdapter();
@@ -47,10 +70,13 @@ public:
     hipError_t    loadCodeObject(const _rocsparselt_handle* handle, std::string const& name);
     hipError_t    loadCodeObject(const _rocsparselt_handle* handle,
                                  const void*                image,
-                                 std::string const&         name);
+                                 std::string const&         name,
+                                 size_t                     size = 0);
     hipError_t    loadCodeObjectBytes(const _rocsparselt_handle*  handle,
                                       std::vector<uint8_t> const& bytes,
                                       std::string const&          name);
+    hipError_t    loadCodeObjects(const _rocsparselt_handle*      handle,
+                                  std::vector<std::string> const& names);
     hipError_t    launchKernel(const _rocsparselt_handle* handle, KernelInvocation const& kernel);
     hipError_t    launchKernel(const _rocsparselt_handle* handle,
                                KernelInvocation const&    kernel,
@@ -58,6 +84,11 @@ public:
                                hipEvent_t                 startEvent,
                                hipEvent_t                 stopEvent,
                                int                        iter = 1);
+    hipError_t    launchKernel(const _rocsparselt_handle*   handle,
+                               BoundKernelInvocation const& kernel,
+                               ModulePin const&             pin,
+                               const void*                  args,
+                               hipStream_t                  stream);
     hipError_t    launchKernels(const _rocsparselt_handle*           handle,
                                 std::vector<KernelInvocation> const& kernels);
     hipError_t    launchKernels(const _rocsparselt_handle*           handle,
@@ -71,21 +102,80 @@ public:
                                 std::vector<hipEvent_t> const&       startEvents,
                                 std::vector<hipEvent_t> const&       stopEvents);
     hipError_t    initKernel(std::string const& name);
+    hipError_t    resolveKernel(const _rocsparselt_handle* handle,
+                                std::string const&         name,
+                                hipFunction_t&             function,
+                                ModulePin&                 pin);
     size_t        getKernelCounts(std::string const& category);
     KernelParams* getKernelParams(std::string const& category);
 
+    // The bytes of the loaded code objects are kept under limit by unloading the least recently
+    // used modules which are not pinned, 0 for no limit.
+    void setCodeObjectLimit(size_t limit);
+    void getCodeObjectStats(rocsparselt_code_object_stats* stats);
+
 private:
     using function_table = std::map<std::string, void*>;
+    using module_table   = std::unordered_map<std::string, std::shared_ptr<module_entry>>;
+
+    // A module is unloaded only once it is no longer published, not loaded and not pinned. A
+    // reader pins it before it checks loaded, the eviction clears loaded before it checks pins.
+    // Each launch records the event of its stream while the module is pinned, an evicted module
+    // is retired until the events of its last launches complete. A module a launch was captured
+    // from is never evicted, the graph may be replayed at any time after the capture.
+    struct module_entry
+    {
+        hipModule_t                                     module = nullptr;
+        std::atomic<hipFunction_t>                      function{nullptr};
+        size_t                                          bytes = 0;
+        std::atomic<int>                                pins{0};
+        std::atomic<bool>                               loaded{true};
+        std::atomic<bool>                               captured{false};
+        std::atomic<uint64_t>                           last_use{0};
+        std::mutex                                      events_access;
+        std::vector<std::pair<hipStream_t, hipEvent_t>> events;
+    };
 
     hipError_t getKernel(hipFunction_t& rv, std::string const& name);
+    bool       isLoaded(std::string const& name);
+    bool       pinModule(std::string const& name, ModulePin& pin);
+    hipError_t getFunction(ModulePin const& pin, std::string const& name, hipFunction_t& rv);
+    hipError_t recordUse(const _rocsparselt_handle* handle,
+                         ModulePin const&           pin,
+                         hipStream_t                stream);
+
+    // Must be called with m_access held, unpublishes the modules to retire
+    void evict(std::string const& keep);
+    // unloads the retired modules whose launches completed, without waiting for the others
+    void reap(const _rocsparselt_handle* handle);
+
+    template <typename Table>
+    static typename Table::mapped_type find(std::shared_ptr<const Table> const& table,
+                                            std::string const&                  name);
+    template <typename Table>
+    static void publish(std::shared_ptr<const Table>& table,
+                        std::string const&            name,
+                        typename Table::mapped_type   value);
+    template <typename Table>
+    static void publish(std::shared_ptr<const Table>& table, std::shared_ptr<const Table> snapshot);
+
     std::mutex m_access;
-    std::unordered_map<std::string, hipModule_t>   m_modules;
-    std::unordered_map<std::string, hipFunction_t> m_kernels;
-    std::string                                    m_name = "HipSolutionAdapter";
-    std::vector<std::string>                       m_loadedModuleNames;
-    std::vector<void*>                             m_lib_handles;
-    std::vector<function_table>                    m_lib_functions;
-    std::vector<std::string>                       m_loadedLibNames;
+    // The module table is read-mostly. Readers take the published snapshot with an atomic load
+    // without locking, writers copy it under m_access and publish the copy with an atomic
+    // store. A replaced snapshot is freed by its last reader.
+    std::shared_ptr<const module_table> m_modules;
+    // the code objects loaded, their limit, and the evicted modules whose unloading waits for
+    // their launched kernels, all under m_access
+    size_t                                     m_bytes     = 0;
+    size_t                                     m_limit     = 0;
+    int64_t                                    m_evictions = 0;
+    std::vector<std::shared_ptr<module_entry>> m_retired;
+    std::atomic<uint64_t>                      m_clock{0};
+    std::string                                m_name = "HipSolutionAdapter";
+    std::vector<std::string>                   m_loadedModuleNames;
+    std::vector<void*>                         m_lib_handles;
+    std::vector<function_table>                m_lib_functions;
+    std::vector<std::string>                   m_loadedLibNames;
     friend std::ostream& operator<<(std::ostream& stream, SolutionAdapter const& adapter);
 };
 std::ostream& operator<<(std::ostream& stream, SolutionAdapter const& adapter);
@@ -0,0 +1,105 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef INIT_POOL_HPP
+#define INIT_POOL_HPP
+
+#include "rocsparselt.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*******************************************************************************
+ * _rocsparselt_plan_init_task is the state of a plan initialized by
+ * rocsparselt_matmul_plan_init_async(), the functions given the plan wait for
+ * it to finish.
+ ******************************************************************************/
+struct _rocsparselt_plan_init_task
+{
+    // blocks until the initialization finished, and returns its status
+    rocsparselt_status wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [this] { return finished; });
+        return status;
+    }
+
+    bool done()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return finished;
+    }
+
+    // the waiters may destroy the task as soon as the lock is released
+    void finish(rocsparselt_status result)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        status   = result;
+        finished = true;
+        cv.notify_all();
+    }
+
+private:
+    std::mutex              mutex;
+    std::condition_variable cv;
+    bool                    finished = false;
+    rocsparselt_status      status   = rocsparselt_status_success;
+};
+
+/*******************************************************************************
+ * _rocsparselt_init_pool runs the initializations of the plans of a handle on
+ * up to max_threads threads, started on demand with the device of the handle
+ * current. Destroying it runs the queued initializations and joins the threads.
+ ******************************************************************************/
+struct _rocsparselt_init_pool
+{
+    _rocsparselt_init_pool(int device, size_t max_threads)
+        : device(device)
+        , max_threads(max_threads)
+    {
+    }
+    ~_rocsparselt_init_pool();
+
+    void submit(std::function<void()> task);
+
+private:
+    void run();
+
+    int                               device;
+    size_t                            max_threads;
+    std::mutex                        mutex;
+    std::condition_variable           cv;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::thread>          threads;
+    size_t                            idle     = 0;
+    bool                              stopping = false;
+};
+
+#endif // INIT_POOL_HPP
@@ -52,6 +52,9 @@ public:
 
     bool isFullyBound() const;
 
+    // byte offset of an argument inside data(), requires logging
+    size_t offset(std::string const& name) const;
+
     void const* data() const;
     size_t      size() const;
 
@@ -267,6 +270,53 @@ public:
     KernelArguments args;
 };
 
+/**
+ * \ingroup Launching
+ * A KernelInvocation prepared once for a plan and config. The argument blob
+ * is stored together with the byte offsets of the arguments that change between
+ * calls (matrix pointers, alpha and beta), so that a launch only needs to copy
+ * the blob and patch those fields.
+ */
+struct BoundKernelInvocation
+{
+    static constexpr size_t MaxArgsBytes = 1024;
+    static constexpr size_t NoOffset     = ~size_t{0};
+
+    std::string kernelName;
+    // resolved when the invocation is bound, so launches skip the name lookup
+    hipFunction_t function = nullptr;
+
+    dim3   workGroupSize;
+    dim3   numWorkItems;
+    size_t sharedMemBytes = 0;
+
+    size_t offsetA        = NoOffset;
+    size_t offsetB        = NoOffset;
+    size_t offsetC        = NoOffset;
+    size_t offsetD        = NoOffset;
+    size_t offsetMetadata = NoOffset;
+    size_t offsetAlpha    = NoOffset;
+    size_t offsetBeta     = NoOffset;
+
+    size_t argsSize = 0;
+    alignas(8) uint8_t args[MaxArgsBytes];
+
+    template <typename T>
+    static void patch(uint8_t* dst, size_t offset, T value)
+    {
+        if(offset != NoOffset)
+            std::memcpy(dst + offset, &value, sizeof(T));
+    }
+};
+
+// values of KernelParams::GlobalAccumulation, how the splits of a GlobalSplitU kernel are summed
+enum KernelGlobalAccumulation
+{
+    GlobalAccumulationNone           = 0,
+    GlobalAccumulationSingleBuffer   = 1, // atomically added to D by the kernel
+    GlobalAccumulationMultipleBuffer = 2, // one workspace buffer per split, reduced afterwards
+};
+
 struct KernelParams
 {
     char         SolutionNameMin[256];
@@ -163,6 +163,27 @@ struct RocsparseltContractionProblem
     const void*                 bias_vector;
     int64_t                     bias_stride;
 
+    // per-row scales of alpha and beta in device memory, nullptr when not enabled
+    const float* alpha_vector = nullptr;
+    const float* beta_vector  = nullptr;
+    // scale and saturation of D and the device float receiving amax(D), 1, false and nullptr
+    // when not enabled
+    float  d_scale    = 1.f;
+    bool   d_saturate = false;
+    float* amax_d     = nullptr;
+    // residual of the layout of D added after the activation, nullptr when not enabled
+    const To* residual              = nullptr;
+    size_t    batch_stride_residual = 0;
+    // gate of the layout of D multiplying the activated result, nullptr when not enabled, it
+    // may alias D
+    const To* gate              = nullptr;
+    size_t    batch_stride_gate = 0;
+    // device vector of m floats receiving the sums of the rows of D over the columns and the
+    // batches, nullptr when not enabled
+    float* bias_grad = nullptr;
+    // CUs the problem runs on, 0 for all the CUs of the device
+    int cu_count = 0;
+
     void *workspace;
     size_t workspaceSize;
 
@@ -504,17 +525,44 @@ struct RocsparseltContractionProblem
 
 template <typename Ti, typename To, typename Tc>
 rocsparselt_status runContractionProblem(RocsparseltContractionProblem<Ti, To, Tc> const& problem,
+                                         _rocsparselt_matmul_config*                      configs,
                                          int*                                             config_id,
-                                         const int config_max_id,
-                                         const int search_iterations);
+                                         const int                         config_max_id,
+                                         const int                         search_iterations,
+                                         const bool                        search_flush_cache,
+                                         rocsparselt_matmul_search_result* search_results,
+                                         _rocsparselt_solution_cache*      solution_cache = nullptr);
 template <typename Ti, typename To, typename Tc>
-rocsparselt_status initSolutions(const _rocsparselt_handle* handle,
-                                 rocsparselt_operation      opA,
-                                 rocsparselt_operation      opB,
-                                 int*                       kernel_counts);
+rocsparselt_status initSolutions(const _rocsparselt_handle*  handle,
+                                 rocsparselt_operation       opA,
+                                 rocsparselt_operation       opB,
+                                 bool                        sparseA,
+                                 size_t                      m,
+                                 size_t                      n,
+                                 size_t                      k,
+                                 size_t                      batch_count,
+                                 int                         cu_count,
+                                 int                         candidates,
+                                 _rocsparselt_matmul_config* configs,
+                                 int*                        kernel_counts);
 
+/*! \brief the category of the kernels of the types and the operations, the kernels of a
+ *         structured B being in the categories of suffix _SPB */
 template <typename Ti, typename To, typename Tc>
-std::string generate_kernel_category_str(rocsparselt_operation opA, rocsparselt_operation opB);
+std::string generate_kernel_category_str(rocsparselt_operation opA,
+                                         rocsparselt_operation opB,
+                                         bool                  sparseA);
+
+/*! \brief the name of the kernel of config index, empty when the library has no such kernel */
+std::string getSolutionName(const _rocsparselt_handle*       handle,
+                            const _rocsparselt_matmul_descr* matmul_descr,
+                            int                              index);
+
+/*! \brief load the code object of the kernel name, and of no other kernel */
+rocsparselt_status loadSolution(const _rocsparselt_handle* handle, const std::string& name);
+
+/*! \brief the code objects loaded on the device of handle, by all its handles */
+void getCodeObjectStats(const _rocsparselt_handle* handle, rocsparselt_code_object_stats* stats);
 
 /***********************************************************************************
  * Whether Kernel Launcher has been initialized for at least one device (used for testing) *
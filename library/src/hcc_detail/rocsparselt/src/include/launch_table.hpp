@@ -0,0 +1,64 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef LAUNCH_TABLE_HPP
+#define LAUNCH_TABLE_HPP
+
+#include "handle.h"
+#include "utility.hpp"
+
+/*******************************************************************************
+ * The launch table maps the arch of the device, the type and the contiguous
+ * dimension of the matrix to the launch variant of the prune and compress
+ * kernels, the workgroup and tile sizes they run with. The rows built in the
+ * library come first, the lines "<arch> <kernel> <type> <k|m> <variant>" of the
+ * file pointed to by HIPSPARSELT_LAUNCH_TABLE override them, and
+ * HIPSPARSELT_LAUNCH_VARIANT makes every kernel run one variant, which is how
+ * hipsparselt-bench --tune_launch times them. A kernel without a row runs its
+ * variant 0, the launch of the kernels before the table.
+ ******************************************************************************/
+enum class rocsparselt_launch_kernel
+{
+    prune_strip, // variants: 0 16x4 threads, 1 64x4, 2 16x16, 3 32x8, each thread prunes 1x4
+    prune_tile, // variants: 0 16x16 threads, 1 8x8, 2 16x4
+    compress, // vectorized kernels, variants: 0 4 wavefronts, 1 2 wavefronts, 2 8 wavefronts
+};
+
+constexpr int rocsparselt_launch_variant_count(rocsparselt_launch_kernel kernel)
+{
+    return kernel == rocsparselt_launch_kernel::prune_strip  ? 4
+           : kernel == rocsparselt_launch_kernel::prune_tile ? 3
+                                                              : 3;
+}
+
+/*! \brief the launch variant of kernel on the device of handle for a matrix of type whose k is
+ *         contiguous or not */
+int rocsparselt_launch_variant(const _rocsparselt_handle* handle,
+                               rocsparselt_launch_kernel  kernel,
+                               rocsparselt_datatype       type,
+                               bool                       k_contiguous);
+
+#endif
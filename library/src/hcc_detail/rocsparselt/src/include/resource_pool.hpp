@@ -0,0 +1,243 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef RESOURCE_POOL_HPP
+#define RESOURCE_POOL_HPP
+
+#include <hip/hip_runtime_api.h>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/*******************************************************************************
+ * _rocsparselt_resource_pool keeps the events, streams and device scratch
+ * buffers used internally by the search and the checks of a handle, so that
+ * repeated calls reuse them instead of creating and destroying driver objects.
+ * Released events and streams stay in the pool until the handle is destroyed,
+ * the free scratch buffers are kept up to max_free_scratch bytes. The pool is
+ * thread-safe, its objects belong to the device of the handle.
+ ******************************************************************************/
+struct _rocsparselt_resource_pool
+{
+    // the bytes of the free scratch buffers kept, the largest ones are freed beyond
+    static constexpr size_t max_free_scratch = size_t(256) << 20;
+
+    ~_rocsparselt_resource_pool();
+
+    // timing events measure elapsed times, the others, created with hipEventDisableTiming,
+    // only order the streams
+    hipError_t acquire_event(hipEvent_t* event, bool timing = false);
+    void       release_event(hipEvent_t event, bool timing = false);
+
+    // non-blocking streams
+    hipError_t acquire_stream(hipStream_t* stream);
+    void       release_stream(hipStream_t stream);
+
+    // the smallest free buffer of at least bytes, or a new one. A buffer released without keep
+    // is freed at once, for the large buffers of a single call. It must not be in use by a
+    // stream anymore when it is released.
+    hipError_t acquire_scratch(size_t bytes, void** ptr);
+    void       release_scratch(void* ptr, bool keep = true);
+
+private:
+    std::mutex                        mutex;
+    std::vector<hipEvent_t>           events;
+    std::vector<hipEvent_t>           timing_events;
+    std::vector<hipStream_t>          streams;
+    std::multimap<size_t, void*>      free_scratch;
+    size_t                            free_scratch_bytes = 0;
+    std::unordered_map<void*, size_t> used_scratch;
+};
+
+/*******************************************************************************
+ * rocsparselt_pooled_event, rocsparselt_pooled_stream, rocsparselt_pooled_scratch:
+ * an event, a stream and a buffer of a pool, given back to it when they go out
+ * of scope.
+ ******************************************************************************/
+class rocsparselt_pooled_event
+{
+public:
+    explicit rocsparselt_pooled_event(_rocsparselt_resource_pool* pool, bool timing = false)
+        : pool(pool)
+        , timing(timing)
+    {
+    }
+    ~rocsparselt_pooled_event()
+    {
+        if(event != nullptr)
+            pool->release_event(event, timing);
+    }
+    rocsparselt_pooled_event(const rocsparselt_pooled_event&) = delete;
+    rocsparselt_pooled_event& operator=(const rocsparselt_pooled_event&) = delete;
+
+    hipError_t acquire()
+    {
+        return pool->acquire_event(&event, timing);
+    }
+
+    operator hipEvent_t() const
+    {
+        return event;
+    }
+
+private:
+    _rocsparselt_resource_pool* pool;
+    bool                        timing;
+    hipEvent_t                  event = nullptr;
+};
+
+class rocsparselt_pooled_stream
+{
+public:
+    explicit rocsparselt_pooled_stream(_rocsparselt_resource_pool* pool)
+        : pool(pool)
+    {
+    }
+    ~rocsparselt_pooled_stream()
+    {
+        if(stream != nullptr)
+            pool->release_stream(stream);
+    }
+    rocsparselt_pooled_stream(const rocsparselt_pooled_stream&) = delete;
+    rocsparselt_pooled_stream& operator=(const rocsparselt_pooled_stream&) = delete;
+
+    hipError_t acquire()
+    {
+        return pool->acquire_stream(&stream);
+    }
+
+    operator hipStream_t() const
+    {
+        return stream;
+    }
+
+private:
+    _rocsparselt_resource_pool* pool;
+    hipStream_t                 stream = nullptr;
+};
+
+class rocsparselt_pooled_scratch
+{
+public:
+    explicit rocsparselt_pooled_scratch(_rocsparselt_resource_pool* pool)
+        : pool(pool)
+    {
+    }
+    ~rocsparselt_pooled_scratch()
+    {
+        if(ptr != nullptr)
+            pool->release_scratch(ptr, keep);
+    }
+    rocsparselt_pooled_scratch(const rocsparselt_pooled_scratch&) = delete;
+    rocsparselt_pooled_scratch& operator=(const rocsparselt_pooled_scratch&) = delete;
+
+    // without keep, the buffer is freed rather than given back to the pool
+    hipError_t acquire(size_t bytes, bool keep = true)
+    {
+        this->keep = keep;
+        return pool->acquire_scratch(bytes, &ptr);
+    }
+
+    void* get() const
+    {
+        return ptr;
+    }
+
+private:
+    _rocsparselt_resource_pool* pool;
+    void*                       ptr  = nullptr;
+    bool                        keep = true;
+};
+
+/*******************************************************************************
+ * _rocsparselt_workspace_pool is the stream-ordered memory pool a handle draws
+ * the workspace of a matmul from when it is given a NULL one, enabled by
+ * HIPSPARSELT_WORKSPACE_POOL_SIZE. The size caps the workspace of one matmul
+ * and the memory the pool keeps between the matmuls. A workspace is allocated
+ * and freed on the stream of its matmul, so it is reused as soon as the kernels
+ * queued before the free have run, without a synchronization.
+ ******************************************************************************/
+struct _rocsparselt_workspace_pool
+{
+    explicit _rocsparselt_workspace_pool(size_t size)
+        : max_size(size)
+    {
+    }
+    ~_rocsparselt_workspace_pool();
+
+    hipError_t init(int device);
+
+    size_t size() const
+    {
+        return max_size;
+    }
+
+    hipError_t allocate(size_t bytes, hipStream_t stream, void** ptr);
+    hipError_t free(void* ptr, hipStream_t stream);
+
+private:
+    hipMemPool_t pool = nullptr;
+    size_t       max_size;
+};
+
+/*******************************************************************************
+ * rocsparselt_pooled_workspace: a workspace of a workspace pool, freed on its
+ * stream when it goes out of scope.
+ ******************************************************************************/
+class rocsparselt_pooled_workspace
+{
+public:
+    explicit rocsparselt_pooled_workspace(_rocsparselt_workspace_pool* pool)
+        : pool(pool)
+    {
+    }
+    ~rocsparselt_pooled_workspace()
+    {
+        if(ptr != nullptr)
+            (void)pool->free(ptr, stream);
+    }
+    rocsparselt_pooled_workspace(const rocsparselt_pooled_workspace&) = delete;
+    rocsparselt_pooled_workspace& operator=(const rocsparselt_pooled_workspace&) = delete;
+
+    hipError_t acquire(size_t bytes, hipStream_t stream)
+    {
+        this->stream = stream;
+        return pool->allocate(bytes, stream, &ptr);
+    }
+
+    void* get() const
+    {
+        return ptr;
+    }
+
+private:
+    _rocsparselt_workspace_pool* pool;
+    void*                        ptr    = nullptr;
+    hipStream_t                  stream = nullptr;
+};
+
+#endif
@@ -0,0 +1,399 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef ROCSPARSELT_COMPRESS_HPP
+#define ROCSPARSELT_COMPRESS_HPP
+#include "definitions.h"
+#include "handle.h"
+#include "status.h"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <hip/hip_fp8.h>
+#include <hip/hip_runtime.h>
+#include <vector>
+
+template <typename Ti>
+__host__ __device__ inline bool compress_is_nonzero(Ti value)
+{
+    return value != static_cast<Ti>(0.0f);
+}
+
+// the FNUZ formats have no negative zero, an FP8 value is 0 iff all its bits are
+__host__ __device__ inline bool compress_is_nonzero(__hip_fp8_e4m3_fnuz value)
+{
+    return value.__x != 0;
+}
+
+__host__ __device__ inline bool compress_is_nonzero(__hip_fp8_e5m2_fnuz value)
+{
+    return value.__x != 0;
+}
+
+/*******************************************************************************
+ * Pack 8 consecutive k elements of a 2:4 pruned row into the 4 values and the
+ * metadata byte of the compressed matrix. Each group of 4 keeps its first two
+ * nonzeros, the unused slots stay zero with the default indices of 0xEE.
+ ******************************************************************************/
+template <typename Ti>
+__host__ __device__ inline unsigned char compress_2_4_x8(const Ti (&in)[8], Ti (&values)[4])
+{
+    constexpr int metadata_tiles_y = 8;
+    constexpr int tiles_y          = 4;
+
+    unsigned char md = 0xEE;
+#pragma unroll
+    for(int k = 0; k < tiles_y; k++)
+        values[k] = static_cast<Ti>(0.0f);
+
+    for(int t = 0; t < metadata_tiles_y / tiles_y; t++)
+    {
+        int m_idx = 0;
+        for(int k = 0; k < tiles_y; k++)
+        {
+            Ti value = in[k + t * tiles_y];
+            if(compress_is_nonzero(value))
+            {
+                if(m_idx == 0 && k == 3)
+                    m_idx++;
+                auto midx    = m_idx + t * (tiles_y >> 1);
+                values[midx] = value;
+                auto shift   = midx << 1;
+                md           = (md & (~(0x03 << shift))) | ((k & 0x03) << shift);
+                m_idx++;
+                if(m_idx > 1)
+                    break;
+            }
+        }
+    }
+    return md;
+}
+
+/*******************************************************************************
+ * Expand the 4 values and the metadata byte written by compress_2_4_x8() back to
+ * the 8 consecutive k elements of the pruned row. The unused slots hold zeros,
+ * so only the nonzero values are placed and the other elements stay zero.
+ ******************************************************************************/
+template <typename Ti>
+__host__ __device__ inline void
+    decompress_2_4_x8(const Ti (&values)[4], unsigned char md, Ti (&out)[8])
+{
+    constexpr int metadata_tiles_y = 8;
+    constexpr int tiles_y          = 4;
+
+#pragma unroll
+    for(int k = 0; k < metadata_tiles_y; k++)
+        out[k] = static_cast<Ti>(0.0f);
+
+#pragma unroll
+    for(int midx = 0; midx < tiles_y; midx++)
+    {
+        int k = (md >> (midx << 1)) & 0x03;
+        if(compress_is_nonzero(values[midx]))
+            out[k + (midx >> 1) * tiles_y] = values[midx];
+    }
+}
+
+/*******************************************************************************
+ * Get the sizes and strides of the dense matrix and of the compressed matrix,
+ * in the k-contiguous view the compress kernels work on. The strides of the
+ * dense matrix follow its order, the ones of the compressed matrix its op.
+ ******************************************************************************/
+inline void get_compress_matrix_size(bool                    is_sparse_a,
+                                     rocsparselt_operation   op,
+                                     _rocsparselt_mat_descr* _sparseMatDescr,
+                                     int64_t&                m,
+                                     int64_t&                n,
+                                     int64_t&                stride0,
+                                     int64_t&                stride1,
+                                     int64_t&                c_stride0,
+                                     int64_t&                c_stride1)
+{
+    if(is_sparse_a)
+    {
+        m         = op == rocsparselt_operation_transpose ? _sparseMatDescr->n : _sparseMatDescr->m;
+        n         = op == rocsparselt_operation_transpose ? _sparseMatDescr->m : _sparseMatDescr->n;
+        stride0   = (op == rocsparselt_operation_transpose) ? _sparseMatDescr->ld : 1;
+        stride1   = (op == rocsparselt_operation_transpose) ? 1 : _sparseMatDescr->ld;
+        c_stride0 = (op == rocsparselt_operation_transpose) ? _sparseMatDescr->c_ld : 1;
+        c_stride1 = (op == rocsparselt_operation_transpose) ? 1 : _sparseMatDescr->c_ld;
+    }
+    else
+    {
+        m         = op == rocsparselt_operation_transpose ? _sparseMatDescr->m : _sparseMatDescr->n;
+        n         = op == rocsparselt_operation_transpose ? _sparseMatDescr->n : _sparseMatDescr->m;
+        stride0   = (op == rocsparselt_operation_transpose) ? 1 : _sparseMatDescr->ld;
+        stride1   = (op == rocsparselt_operation_transpose) ? _sparseMatDescr->ld : 1;
+        c_stride0 = (op == rocsparselt_operation_transpose) ? 1 : _sparseMatDescr->c_ld;
+        c_stride1 = (op == rocsparselt_operation_transpose) ? _sparseMatDescr->c_ld : 1;
+    }
+    // a row ordered dense matrix is the transpose of the column ordered one in memory, the
+    // kernels read it in the layout the compressed matrix is written in, in the same pass.
+    if(_sparseMatDescr->order == rocsparselt_order_row)
+        std::swap(stride0, stride1);
+}
+
+/*******************************************************************************
+ * Set the compressed matrix size of a structured matrix for the operation it
+ * will have in the matmul, as rocsparselt_matmul_descr_init() does.
+ ******************************************************************************/
+inline void set_compressed_layout(_rocsparselt_mat_descr& matrix,
+                                  bool                    is_sparse_a,
+                                  rocsparselt_operation   op)
+{
+    bool transpose = op == rocsparselt_operation_transpose;
+    if(is_sparse_a)
+    {
+        int64_t m   = transpose ? matrix.n : matrix.m;
+        matrix.c_k  = (transpose ? matrix.m : matrix.n) / 2;
+        matrix.c_ld = transpose ? matrix.c_k : m;
+        matrix.c_n  = transpose ? m : matrix.c_k;
+    }
+    else
+    {
+        int64_t n   = transpose ? matrix.m : matrix.n;
+        matrix.c_k  = (transpose ? matrix.n : matrix.m) / 2;
+        matrix.c_ld = transpose ? n : matrix.c_k;
+        matrix.c_n  = transpose ? matrix.c_k : n;
+    }
+}
+
+// compress the k-contiguous view of a pruned matrix, see rocsparselt_compress.cpp.
+rocsparselt_status rocsparselt_smfmac_compress_impl(const _rocsparselt_handle*    handle,
+                                                    const _rocsparselt_mat_descr* matrix,
+                                                    int64_t                       m,
+                                                    int64_t                       n,
+                                                    int64_t                       stride0,
+                                                    int64_t                       stride1,
+                                                    int64_t                       ld,
+                                                    int64_t                       c_stride0,
+                                                    int64_t                       c_stride1,
+                                                    int64_t                       m_stride0,
+                                                    int64_t                       m_stride1,
+                                                    int64_t                       c_batch_stride,
+                                                    int64_t                       m_batch_stride,
+                                                    const void*                   d_in,
+                                                    void*                         d_out,
+                                                    void*                         d_ws,
+                                                    hipStream_t                   stream);
+
+// prune and compress a single panel of rows, a block of the k-contiguous view of a dense
+// matrix, to its place in a compressed matrix, see rocsparselt_prune.cpp.
+rocsparselt_status
+    rocsparselt_smfmac_prune_compress_panel_impl(const _rocsparselt_handle* handle,
+                                                 rocsparselt_datatype       type,
+                                                 rocsparselt_order          order,
+                                                 int64_t                    m,
+                                                 int64_t                    n,
+                                                 int64_t                    stride0,
+                                                 int64_t                    stride1,
+                                                 int64_t                    c_stride0,
+                                                 int64_t                    c_stride1,
+                                                 int64_t                    m_stride0,
+                                                 int64_t                    m_stride1,
+                                                 const void*                d_in,
+                                                 void*                      d_out,
+                                                 unsigned char*             d_metadata,
+                                                 rocsparselt_prune_alg      pruneAlg,
+                                                 hipStream_t                stream);
+
+// prune the dense structured operand of the matmul descr and compress it to d_compressed in a
+// single kernel, for rocsparselt_smfmac_prune_and_compress() and the prologue of a matmul with
+// a dynamic sparse operand, see rocsparselt_prune.cpp.
+rocsparselt_status
+    rocsparselt_smfmac_prune_compress_operand(const _rocsparselt_handle*       handle,
+                                              const _rocsparselt_matmul_descr* descr,
+                                              const void*                      d_dense,
+                                              void*                            d_compressed,
+                                              rocsparselt_prune_alg            pruneAlg,
+                                              hipStream_t                      stream);
+
+// counts a write of a compressed matrix, by the functions of the library writing one, so that the
+// widened copies of the mixed input plans are widened again on their next matmul
+void rocsparselt_compressed_matrix_written();
+
+// the int8 compressed matrix of a mixed input plan widened to the type of its dense matrix,
+// with the metadata copied behind the widened values. It is widened on stream when the plan
+// holds no copy of d_compressed, see _rocsparselt_widened_operand and rocsparselt_compress.cpp.
+rocsparselt_status rocsparselt_smfmac_widened_operand(const _rocsparselt_handle*      handle,
+                                                      const _rocsparselt_matmul_plan* plan,
+                                                      const void*                     d_compressed,
+                                                      const void**                    d_widened,
+                                                      hipStream_t                     stream);
+
+/*******************************************************************************
+ * One matrix of a grouped prune or compress, in the k-contiguous view the
+ * kernels work on. The work list is an array of them in device memory, sorted
+ * by block_start, the workgroups of the single launch look their matrix up in
+ * it. The compressed and metadata fields are unused by the prune.
+ ******************************************************************************/
+struct rocsparselt_grouped_work
+{
+    const void*    in;
+    void*          out;
+    unsigned char* metadata;
+    int64_t        m;
+    int64_t        n;
+    int64_t        stride1;
+    int64_t        stride2;
+    int64_t        batch_stride;
+    int64_t        c_stride1;
+    int64_t        c_stride2;
+    int64_t        c_batch_stride;
+    int64_t        m_stride1;
+    int64_t        m_stride2;
+    int64_t        m_batch_stride;
+    int64_t        block_start; // the first workgroup of the matrix in the launch
+    int            blocks_x;
+    int            blocks_y;
+    int            num_batches;
+};
+
+__device__ inline const rocsparselt_grouped_work*
+    grouped_work_find(const rocsparselt_grouped_work* works, int count, int64_t block)
+{
+    int lo = 0;
+    int hi = count - 1;
+    while(lo < hi)
+    {
+        int mid = (lo + hi + 1) / 2;
+        if(works[mid].block_start <= block)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+    return &works[lo];
+}
+
+/*******************************************************************************
+ * Set block_start of the work list and copy it to d_works, return the total
+ * number of workgroups. The host copy is pageable, hipMemcpyAsync has read it
+ * when it returns.
+ ******************************************************************************/
+inline rocsparselt_status grouped_work_upload(std::vector<rocsparselt_grouped_work>& works,
+                                              void*                                  d_works,
+                                              int64_t&                               blocks,
+                                              hipStream_t                            stream)
+{
+    blocks = 0;
+    for(auto& work : works)
+    {
+        work.block_start = blocks;
+        blocks += static_cast<int64_t>(work.blocks_x) * work.blocks_y * work.num_batches;
+    }
+    RETURN_IF_HIP_ERROR(hipMemcpyAsync(d_works,
+                                       works.data(),
+                                       works.size() * sizeof(rocsparselt_grouped_work),
+                                       hipMemcpyHostToDevice,
+                                       stream));
+    return rocsparselt_status_success;
+}
+
+/*******************************************************************************
+ * The prune and compress kernels loop over the tiles of all the batches of
+ * their matrix with a grid-stride loop on a 1-dimensional grid, so that neither
+ * the number of tiles nor the number of batches is bound by the 32-bit and the
+ * gridDim.y and gridDim.z limits of a grid of one workgroup per tile. The grid
+ * has as many workgroups of threads threads as the CUs of the device run at
+ * once, or one per tile when there are fewer tiles, and never less than one.
+ ******************************************************************************/
+inline int64_t grid_stride_blocks(const _rocsparselt_handle* handle, int64_t tiles, int threads)
+{
+    int64_t per_cu   = std::max(handle->properties.maxThreadsPerMultiProcessor / threads, 1);
+    int64_t resident = handle->properties.multiProcessorCount * per_cu;
+    return std::max<int64_t>(std::min(tiles, resident), 1);
+}
+
+/*******************************************************************************
+ * Check the arguments of a grouped prune or compress, all the matrices must be
+ * structured matrices of the same datatype.
+ ******************************************************************************/
+inline rocsparselt_status validateGroupedArgs(const _rocsparselt_handle*          handle,
+                                              const char*                         caller,
+                                              int                                 groupCount,
+                                              const rocsparselt_mat_descr* const* sparseMatDescrs,
+                                              rocsparselt_operation               op,
+                                              const void* const*                  d_in,
+                                              void* const*                        d_out,
+                                              const void*                         d_workList,
+                                              std::vector<const _rocsparselt_mat_descr*>& descrs)
+{
+    if(groupCount < 0)
+    {
+        log_error(handle, caller, "groupCount", groupCount, "is invalid");
+        return rocsparselt_status_invalid_size;
+    }
+    if(groupCount == 0)
+        return rocsparselt_status_success;
+
+    if(sparseMatDescrs == nullptr)
+    {
+        log_error(handle, caller, "sparseMatDescrs is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(op != rocsparselt_operation_none && op != rocsparselt_operation_transpose)
+    {
+        log_error(handle, caller, "op is invalid");
+        return rocsparselt_status_invalid_value;
+    }
+
+    if(d_in == nullptr || d_out == nullptr || d_workList == nullptr)
+    {
+        log_error(handle, caller, "d_in, d_out or d_workList is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    descrs.resize(groupCount);
+    for(int i = 0; i < groupCount; i++)
+    {
+        auto descr = reinterpret_cast<const _rocsparselt_mat_descr*>(sparseMatDescrs[i]);
+        if(descr == nullptr || !descr->isInit())
+        {
+            log_error(handle, caller, "sparseMatDescrs", i, "is invalid");
+            return rocsparselt_status_invalid_handle;
+        }
+        if(d_in[i] == nullptr || d_out[i] == nullptr)
+        {
+            log_error(handle, caller, "the pointers of group", i, "are NULL");
+            return rocsparselt_status_invalid_pointer;
+        }
+        if(descr->m_type != rocsparselt_matrix_type_structured)
+        {
+            log_error(handle, caller, "Matrix", i, "is not a structured matrix");
+            return rocsparselt_status_not_implemented;
+        }
+        if(i > 0 && descr->type != descrs[0]->type)
+        {
+            log_error(handle, caller, "Matrix", i, "has a different datatype than matrix 0");
+            return rocsparselt_status_not_implemented;
+        }
+        descrs[i] = descr;
+    }
+    return rocsparselt_status_success;
+}
+
+#endif // ROCSPARSELT_COMPRESS_HPP
@@ -0,0 +1,129 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef ROCSPARSELT_PAD_HPP
+#define ROCSPARSELT_PAD_HPP
+
+#include "handle.h"
+
+#include <hip/hip_runtime_api.h>
+
+/*******************************************************************************
+ * The padding of the shapes the kernels do not support. The kernels need the
+ * rows and the cols of every matrix to be a multiple of 8, of 16 for the 8-bit
+ * types. With HIPSPARSELT_PAD_SHAPES set, a matmul of other sizes is planned
+ * for m, n and k rounded up to the multiples of all its matrices: the dense
+ * input, C and D are copied to zero-padded matrices in the workspace before
+ * the matmul and D is copied back after it, the compress of a plan writes the
+ * padded compressed matrix. The zeros of the padding add nothing to the sums,
+ * the padded rows and cols of D are dropped.
+ ******************************************************************************/
+
+// the multiple of the rows and the cols of a matrix of type the kernels need
+inline int64_t rocsparselt_pad_multiple(rocsparselt_datatype type)
+{
+    switch(type)
+    {
+    case rocsparselt_datatype_i8_r:
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
+        return 16;
+    default:
+        return 8;
+    }
+}
+
+inline bool rocsparselt_needs_padding(const _rocsparselt_mat_descr* matrix)
+{
+    int64_t multiple = rocsparselt_pad_multiple(matrix->type);
+    return matrix->m % multiple != 0 || matrix->n % multiple != 0;
+}
+
+inline bool rocsparselt_needs_padding(const _rocsparselt_matmul_descr* descr)
+{
+    return rocsparselt_needs_padding(descr->matrix_A) || rocsparselt_needs_padding(descr->matrix_B)
+           || rocsparselt_needs_padding(descr->matrix_C)
+           || rocsparselt_needs_padding(descr->matrix_D);
+}
+
+// the matmul descr of the padded problem of descr, owned by the caller
+_rocsparselt_matmul_descr* rocsparselt_padded_descr(const _rocsparselt_matmul_descr* descr);
+
+// rocsparselt_status_not_implemented for a matmul with vectors or matrices of the sizes of m or
+// D other than its operands, the bias, the vector scaling, the residual and the gate, with
+// amax(D), which would see the padding, or with a row ordered structured matrix
+rocsparselt_status rocsparselt_check_paddable(const _rocsparselt_handle*       handle,
+                                              const _rocsparselt_matmul_descr* descr,
+                                              const char*                      caller);
+
+// rocsparselt_status_not_implemented for a matrix or a matmul the kernels cannot run without
+// the padding of a plan, the functions taking a descr do not pad
+rocsparselt_status rocsparselt_check_aligned(const _rocsparselt_handle*    handle,
+                                             const _rocsparselt_mat_descr* matrix,
+                                             const char*                   caller);
+
+rocsparselt_status rocsparselt_check_aligned(const _rocsparselt_handle*       handle,
+                                             const _rocsparselt_matmul_descr* descr,
+                                             const char*                      caller);
+
+// rocsparselt_status_not_implemented for a padded plan, for the functions which do not pad
+rocsparselt_status rocsparselt_check_unpadded(const _rocsparselt_handle*      handle,
+                                              const _rocsparselt_matmul_plan* plan,
+                                              const char*                     caller);
+
+// the offset of the padded matrices in the workspace of a padded plan, behind the workspace
+// of the config needing the largest one, so that any config can run
+size_t rocsparselt_pad_workspace_offset(const _rocsparselt_matmul_alg_selection* alg_selection);
+
+// the bytes of the padded dense input and the padded D of a matmul of padded_descr
+size_t rocsparselt_pad_staging_bytes(const _rocsparselt_matmul_descr* padded_descr);
+
+// the bytes of the padded sparse matrix, the compress buffer of a padded plan
+size_t rocsparselt_pad_sparse_bytes(const _rocsparselt_matmul_descr* padded_descr);
+
+// copies the sparse matrix of the caller of plan to its padded matrix in buffer
+rocsparselt_status rocsparselt_pad_sparse(const _rocsparselt_matmul_plan* plan,
+                                          const void*                     d_dense,
+                                          void*                           buffer,
+                                          hipStream_t                     stream);
+
+// copies the dense input and C of the caller of plan to their padded matrices in staging, the
+// padded C being the padded D, and points d_A or d_B, d_C and d_D to them
+rocsparselt_status rocsparselt_pad_operands(const _rocsparselt_matmul_plan* plan,
+                                            void*                           staging,
+                                            const void**                    d_A,
+                                            const void**                    d_B,
+                                            const void**                    d_C,
+                                            void**                          d_D,
+                                            hipStream_t                     stream);
+
+// copies the padded D of staging to the D of the caller of plan
+rocsparselt_status rocsparselt_unpad_result(const _rocsparselt_matmul_plan* plan,
+                                            const void*                     staging,
+                                            void*                           d_D,
+                                            hipStream_t                     stream);
+
+#endif // ROCSPARSELT_PAD_HPP
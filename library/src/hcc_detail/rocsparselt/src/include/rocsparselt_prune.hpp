@@ -0,0 +1,167 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef ROCSPARSELT_PRUNE_HPP
+#define ROCSPARSELT_PRUNE_HPP
+
+#include <cmath>
+#include <hip/hip_runtime.h>
+
+/*******************************************************************************
+ * The pattern selection of the strip and tile prune. The device kernels and the
+ * host prune share it, so both pick the same elements, ties included.
+ ******************************************************************************/
+template <typename Ti, typename Tc>
+__host__ __device__ inline Tc norm1(Ti a, Ti b)
+{
+    Tc ac = static_cast<Tc>(a);
+    Tc bc = static_cast<Tc>(b);
+    return static_cast<Tc>(std::abs(ac) + std::abs(bc));
+}
+
+// pick the two elements of a group of 4 which have the largest norm1, the first pair wins a tie.
+template <typename Ti, typename Tc>
+__host__ __device__ inline void prune_strip_select(const Ti (&values)[4], int& pos_a, int& pos_b)
+{
+    auto max_norm1 = static_cast<Tc>(-1.0);
+    pos_a          = 0;
+    pos_b          = 0;
+
+#pragma unroll 4
+    for(int a = 0; a < 4; a++)
+    {
+        for(int b = a + 1; b < 4; b++)
+        {
+            auto norm1_v = norm1<Ti, Tc>(values[a], values[b]);
+            bool update  = norm1_v > max_norm1;
+            pos_a        = update ? a : pos_a;
+            pos_b        = update ? b : pos_b;
+            max_norm1    = update ? norm1_v : max_norm1;
+        }
+    }
+}
+
+// the 6 pairs of a group of 4 as element indices and as a mask, and for two rows of a 4x4 tile,
+// the index of the column counts (each 0, 1 or 2, 4 in total) their pairs give. The 19 counts
+// are listed so that the pairs of the two other rows complete a pattern, which keeps 2 elements
+// in each column, iff their index is 18 minus it.
+constexpr int          prune_tile_pairs[6][2]   = {{0, 1}, {0, 2}, {0, 3}, {1, 2}, {1, 3}, {2, 3}};
+constexpr unsigned int prune_tile_pair_masks[6] = {0x3, 0x5, 0x9, 0x6, 0xA, 0xC};
+constexpr int          prune_tile_counts[6][6]  = {{18, 17, 16, 12, 11, 9},
+                                                   {17, 15, 14, 10, 9, 7},
+                                                   {16, 14, 13, 9, 8, 6},
+                                                   {12, 10, 9, 5, 4, 2},
+                                                   {11, 9, 8, 4, 3, 1},
+                                                   {9, 7, 6, 2, 1, 0}};
+
+// pick the pattern of a 4x4 tile, 2 elements in each row and each column, which has the largest
+// norm1. Rather than summing all 90 patterns, rows 2 and 3 keep their best pairs for each of the
+// 19 column counts, then each choice of pairs of rows 0 and 1 is matched with the one that
+// completes it. Everything stays in registers, the returned mask has bit x * 4 + y set when the
+// element of row x and column y is kept.
+template <typename Tc>
+__host__ __device__ inline unsigned int prune_tile_select(const Tc (&value_abs)[16])
+{
+    Tc pair_norm1[4][6];
+#pragma unroll
+    for(int x = 0; x < 4; x++)
+    {
+#pragma unroll
+        for(int p = 0; p < 6; p++)
+            pair_norm1[x][p] = value_abs[x * 4 + prune_tile_pairs[p][0]]
+                               + value_abs[x * 4 + prune_tile_pairs[p][1]];
+    }
+
+    Tc           hi_norm1[19];
+    unsigned int hi_mask[19];
+#pragma unroll
+    for(int c = 0; c < 19; c++)
+    {
+        hi_norm1[c] = static_cast<Tc>(-1.f);
+        hi_mask[c]  = 0;
+    }
+
+#pragma unroll
+    for(int p = 0; p < 6; p++)
+    {
+#pragma unroll
+        for(int q = 0; q < 6; q++)
+        {
+            const int    c      = prune_tile_counts[p][q];
+            unsigned int pairs  = prune_tile_pair_masks[p] << 8 | prune_tile_pair_masks[q] << 12;
+            Tc           norm1  = pair_norm1[2][p] + pair_norm1[3][q];
+            bool         update = norm1 > hi_norm1[c];
+            hi_norm1[c]         = update ? norm1 : hi_norm1[c];
+            hi_mask[c]          = update ? pairs : hi_mask[c];
+        }
+    }
+
+    Tc           max_norm1 = static_cast<Tc>(-1.f);
+    unsigned int mask      = 0;
+#pragma unroll
+    for(int p = 0; p < 6; p++)
+    {
+#pragma unroll
+        for(int q = 0; q < 6; q++)
+        {
+            const int    c      = 18 - prune_tile_counts[p][q];
+            unsigned int pairs  = prune_tile_pair_masks[p] | prune_tile_pair_masks[q] << 4;
+            Tc           norm1  = pair_norm1[0][p] + pair_norm1[1][q] + hi_norm1[c];
+            bool         update = norm1 > max_norm1;
+            max_norm1           = update ? norm1 : max_norm1;
+            mask                = update ? pairs | hi_mask[c] : mask;
+        }
+    }
+    return mask;
+}
+
+// read a 4x4 tile into registers, the elements outside the matrix are 0.
+template <typename Ti, typename Tc>
+__host__ __device__ inline void prune_tile_load(const Ti* in,
+                                                int64_t   offset,
+                                                int64_t   rows,
+                                                int64_t   cols,
+                                                int64_t   stride1,
+                                                int64_t   stride2,
+                                                Ti (&values)[16],
+                                                Tc (&value_abs)[16])
+{
+#pragma unroll
+    for(int x = 0; x < 4; x++)
+    {
+#pragma unroll
+        for(int y = 0; y < 4; y++)
+        {
+            Ti value = static_cast<Ti>(0.0f);
+            if(x < rows && y < cols)
+                value = in[offset + x * stride1 + y * stride2];
+            values[x * 4 + y]    = value;
+            value_abs[x * 4 + y] = std::abs(static_cast<Tc>(value));
+        }
+    }
+}
+
+#endif // ROCSPARSELT_PRUNE_HPP
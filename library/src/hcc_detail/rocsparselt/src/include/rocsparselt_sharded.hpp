@@ -0,0 +1,89 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef ROCSPARSELT_SHARDED_HPP
+#define ROCSPARSELT_SHARDED_HPP
+
+#include "handle.h"
+
+#include <hip/hip_runtime_api.h>
+
+/*******************************************************************************
+ * The shards of a tensor-parallel matmul. Shard i runs the plan i on the device
+ * of its handle. Split along the output, the shards are independent matmuls
+ * sharing the dense input. Split along k, the partial D of every other shard is
+ * copied into the workspace of the first one behind the workspace of its plan,
+ * summed into the D of the first shard, and the sum copied back to the D of
+ * every other shard.
+ ******************************************************************************/
+
+// makes the device of a shard current for the scope, the device current at its start is made
+// current again at its end
+class rocsparselt_device_scope
+{
+public:
+    rocsparselt_device_scope()
+    {
+        if(hipGetDevice(&device) != hipSuccess)
+            device = -1;
+    }
+    ~rocsparselt_device_scope()
+    {
+        if(device >= 0)
+            (void)hipSetDevice(device);
+    }
+    rocsparselt_device_scope(const rocsparselt_device_scope&) = delete;
+    rocsparselt_device_scope& operator=(const rocsparselt_device_scope&) = delete;
+
+    hipError_t set(const _rocsparselt_handle* handle)
+    {
+        return hipSetDevice(handle->device);
+    }
+
+private:
+    int device = -1;
+};
+
+// checks that the plans of numShards shards, created with their handles, make one matmul split
+// along split, with an epilogue which can be split
+rocsparselt_status rocsparselt_check_shards(const rocsparselt_handle* const*      handles,
+                                            const rocsparselt_matmul_plan* const* plans,
+                                            int32_t                               numShards,
+                                            rocsparselt_shard_split               split,
+                                            const char*                           caller);
+
+// the bytes of the partial D of a shard split along k in the workspace of the first shard, by
+// which the partial D of the shards follow each other
+size_t rocsparselt_shard_partial_bytes(const _rocsparselt_matmul_descr* descr);
+
+// adds the partial D of a shard split along k to d_sum, of the layout of the D of descr
+rocsparselt_status rocsparselt_shard_reduce(const _rocsparselt_handle*       handle,
+                                            const _rocsparselt_matmul_descr* descr,
+                                            void*                            d_sum,
+                                            const void*                      d_partial,
+                                            hipStream_t                      stream);
+
+#endif // ROCSPARSELT_SHARDED_HPP
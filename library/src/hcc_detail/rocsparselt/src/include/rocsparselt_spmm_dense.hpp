@@ -0,0 +1,73 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef ROCSPARSELT_SPMM_DENSE_HPP
+#define ROCSPARSELT_SPMM_DENSE_HPP
+
+#include "handle.h"
+
+#include <hip/hip_runtime_api.h>
+
+#if BUILD_WITH_TENSILE
+#include "tensile_host.hpp"
+#else
+#include "kernel_launcher.hpp"
+#endif
+
+/*******************************************************************************
+ * The dense path of a matmul: a kernel which reads the compressed matrix and its
+ * metadata directly and multiplies the expanded rows with plain FMAs instead of
+ * SMFMAC instructions. It has no tiling constraints, so it can beat the sparse
+ * kernels on small or skinny problems. The search times it against the best
+ * config when rocsparselt_matmul_search_dense is set, see spmm_typecasting.
+ ******************************************************************************/
+
+// the dense path has the epilogue of a GEMM only, alpha and beta
+template <typename Ti, typename To, typename Tc>
+inline bool
+    rocsparselt_spmm_dense_supported(const RocsparseltContractionProblem<Ti, To, Tc>& prob)
+{
+    return prob.act_type == hipsparselt_activation_type::none && prob.bias_vector == nullptr
+           && prob.alpha_vector == nullptr && prob.beta_vector == nullptr && prob.d_scale == 1.f
+           && !prob.d_saturate && prob.amax_d == nullptr && prob.residual == nullptr
+           && prob.gate == nullptr && prob.bias_grad == nullptr && prob.metadata != nullptr;
+}
+
+// runs the dense path of prob on stream, all the batches in a single launch
+template <typename Ti, typename To, typename Tc>
+hipError_t rocsparselt_spmm_dense(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                  hipStream_t                                      stream);
+
+// the mean time of search_iterations runs of the dense path, after a warm up
+template <typename Ti, typename To, typename Tc>
+hipError_t
+    rocsparselt_spmm_dense_time(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                hipStream_t                                      stream,
+                                int                                              search_iterations,
+                                bool                                             flush_cache,
+                                float*                                           mean_ms);
+
+#endif // ROCSPARSELT_SPMM_DENSE_HPP
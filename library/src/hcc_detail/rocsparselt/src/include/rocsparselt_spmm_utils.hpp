@@ -35,6 +35,8 @@
 #include "kernel_launcher.hpp"
 #endif
 #include <cxxabi.h>
+#include <new>
+#include <type_traits>
 
 inline rocsparselt_status getOriginalSizes(rocsparselt_operation opA,
                                            rocsparselt_operation opB,
@@ -61,6 +63,28 @@ inline rocsparselt_status getOriginalSizes(rocsparselt_operation opA,
     return rocsparselt_status_success;
 }
 
+/*******************************************************************************
+ * Get the size of an element of the datatype (in bytes)
+ ******************************************************************************/
+inline int64_t rocsparselt_datatype_bytes(rocsparselt_datatype type)
+{
+    switch(type)
+    {
+    case rocsparselt_datatype_f32_r:
+    case rocsparselt_datatype_i32_r:
+        return 4;
+    case rocsparselt_datatype_f16_r:
+    case rocsparselt_datatype_bf16_r:
+        return 2;
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
+    case rocsparselt_datatype_i8_r:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
 /*******************************************************************************
  * Get the offset of the metatdata (in bytes)
  ******************************************************************************/
@@ -71,28 +95,108 @@ inline int64_t rocsparselt_metadata_offset_in_compressed_matrix(int64_t
 {
     int64_t batch_stride = ld * num_cols;
 
-    auto datatype_bpe = [&] {
-        switch(type)
-        {
-        case rocsparselt_datatype_f32_r:
-            return 4;
-        case rocsparselt_datatype_f16_r:
-        case rocsparselt_datatype_bf16_r:
-            return 2;
-        case rocsparselt_datatype_f8_r:
-        case rocsparselt_datatype_bf8_r:
-        case rocsparselt_datatype_i8_r:
-            return 1;
-        default:
-            return 0;
-        }
-    };
-
-    auto    bpe    = datatype_bpe();
+    auto    bpe    = rocsparselt_datatype_bytes(type);
     int64_t offset = num_batches * batch_stride * bpe;
     return offset;
 }
 
+/*******************************************************************************
+ * The elements of one matrix of a batch of a dense matrix with the leading
+ * dimension ld, which strides the cols of a column ordered matrix and the rows
+ * of a row ordered matrix.
+ ******************************************************************************/
+inline int64_t rocsparselt_matrix_elems(const _rocsparselt_mat_descr* matrix, int64_t ld)
+{
+    return (matrix->order == rocsparselt_order_column ? matrix->n : matrix->m) * ld;
+}
+
+/*******************************************************************************
+ * Get the size of a dense matrix, including all its batches (in bytes)
+ ******************************************************************************/
+inline int64_t rocsparselt_dense_matrix_bytes(const _rocsparselt_mat_descr* matrix)
+{
+    int64_t elems = std::max(rocsparselt_matrix_elems(matrix, matrix->ld),
+                             matrix->batch_stride * matrix->num_batches);
+    return elems * rocsparselt_datatype_bytes(matrix->type);
+}
+
+/*******************************************************************************
+ * Get the size of the compressed matrix and its metadata of a structured
+ * matrix, including all its batches (in bytes)
+ ******************************************************************************/
+inline size_t rocsparselt_compressed_matrix_bytes(const _rocsparselt_mat_descr* matrix,
+                                                  rocsparselt_datatype          type)
+{
+    // a broadcast matrix is compressed once
+    int num_batches = matrix->batch_stride == 0 ? 1 : matrix->num_batches;
+    return matrix->c_ld * matrix->c_n / 4 * num_batches
+           + rocsparselt_metadata_offset_in_compressed_matrix(
+               matrix->c_n, matrix->c_ld, num_batches, type);
+}
+
+inline size_t rocsparselt_compressed_matrix_bytes(const _rocsparselt_mat_descr* matrix)
+{
+    return rocsparselt_compressed_matrix_bytes(matrix, matrix->type);
+}
+
+/*******************************************************************************
+ * A mixed input matmul multiplies an int8 structured matrix with a f16 or bf16
+ * dense matrix. The plan keeps the compressed int8 values widened to the type
+ * of the dense matrix, the metadata do not depend on the type, and the matmul
+ * runs the kernels of that type, see _rocsparselt_widened_operand. The per row
+ * scales of the int8 values are the alpha vector of
+ * rocsparselt_matmul_alpha_vector_scaling.
+ ******************************************************************************/
+inline bool rocsparselt_is_mixed_input(rocsparselt_datatype sparse_type,
+                                       rocsparselt_datatype dense_type)
+{
+    return sparse_type == rocsparselt_datatype_i8_r
+           && (dense_type == rocsparselt_datatype_f16_r
+               || dense_type == rocsparselt_datatype_bf16_r);
+}
+
+inline bool rocsparselt_is_mixed_input(const _rocsparselt_matmul_descr* descr)
+{
+    return descr->is_sparse_a
+               ? rocsparselt_is_mixed_input(descr->matrix_A->type, descr->matrix_B->type)
+               : rocsparselt_is_mixed_input(descr->matrix_B->type, descr->matrix_A->type);
+}
+
+/*******************************************************************************
+ * The type the kernels of the matmul read A and B in, the type of the dense
+ * matrix of a mixed input matmul.
+ ******************************************************************************/
+inline rocsparselt_datatype rocsparselt_matmul_input_type(const _rocsparselt_matmul_descr* descr)
+{
+    if(rocsparselt_is_mixed_input(descr))
+        return (descr->is_sparse_a ? descr->matrix_B : descr->matrix_A)->type;
+    return descr->matrix_A->type;
+}
+
+/*******************************************************************************
+ * The name of the kernel of the selected config, empty for the dense path. The
+ * Tensile backend only knows it once the config was measured by a search.
+ ******************************************************************************/
+inline std::string
+    rocsparselt_selected_kernel_name(const _rocsparselt_handle*               handle,
+                                     const _rocsparselt_matmul_descr*         matmul_descr,
+                                     const _rocsparselt_matmul_alg_selection* alg_selection)
+{
+    if(alg_selection->dense_selected || alg_selection->config_max_id == 0)
+        return "";
+#if BUILD_WITH_TENSILE
+    (void)handle;
+    (void)matmul_descr;
+    for(auto& result : alg_selection->search_results)
+        if(result.config_id == alg_selection->config_id)
+            return result.kernel_name;
+    return "";
+#else
+    return getSolutionName(
+        handle, matmul_descr, alg_selection->configs[alg_selection->config_id].index);
+#endif
+}
+
 template <typename T>
 inline rocsparselt_status validateSetAttributeDataSize(size_t dataSize,
                                                        size_t expectedSize = sizeof(T))
@@ -183,7 +287,9 @@ inline rocsparselt_status validateMatrixArgs(const _rocsparselt_handle* handle,
         break;
     }
 
-    if(num_rows < num_elements || num_cols < num_elements)
+    // the plans pad the matrices of other sizes with HIPSPARSELT_PAD_SHAPES, see
+    // rocsparselt_pad.hpp
+    if(!handle->pad_shapes && (num_rows < num_elements || num_cols < num_elements))
     {
         hipsparselt_cerr << "row and col must larger than " << num_elements << ", current are "
                          << num_rows << " and " << num_cols << std::endl;
@@ -196,7 +302,7 @@ inline rocsparselt_status validateMatrixArgs(const _rocsparselt_handle* handle,
         return rocsparselt_status_not_implemented;
     }
 
-    if(num_rows % num_elements != 0 || num_cols % num_elements)
+    if(!handle->pad_shapes && (num_rows % num_elements != 0 || num_cols % num_elements))
     {
         hipsparselt_cerr << "row and col must be a multiple of " << num_elements << std::endl;
         if(handle->layer_mode & rocsparselt_layer_mode_log_error)
@@ -208,16 +314,20 @@ inline rocsparselt_status validateMatrixArgs(const _rocsparselt_handle* handle,
         return rocsparselt_status_not_implemented;
     }
 
-    // leading dimensions must be valid
-    if(num_rows > ld)
+    // leading dimensions must be valid, the ld of a row ordered matrix strides its rows
+    int64_t ld_elems = order == rocsparselt_order_row ? num_cols : num_rows;
+    if(ld_elems > ld)
     {
-        hipsparselt_cerr << "number of rows(" << num_rows << ") is larger than leading dimension("
-                         << ld << ")" << std::endl;
+        hipsparselt_cerr << "number of " << (order == rocsparselt_order_row ? "cols(" : "rows(")
+                         << ld_elems << ") is larger than leading dimension(" << ld << ")"
+                         << std::endl;
         log_error(handle, __func__, "row and col must >= ld");
         return rocsparselt_status_invalid_size;
     }
 
-    if(order == rocsparselt_order_row)
+    // the dense layout of a structured matrix is only read by the prune and the compress and
+    // written by the decompress, the compressed matrix has the layout of the matmul either way.
+    if(order == rocsparselt_order_row && matrixType != rocsparselt_matrix_type_structured)
     {
         hipsparselt_cerr << "rocsparselt_order_row is not supported" << std::endl;
         log_error(handle, __func__, "rocsparselt_order_row is not supported");
@@ -230,7 +340,17 @@ inline rocsparselt_status validateMatrixArgs(const _rocsparselt_handle* handle,
     case rocsparselt_datatype_f16_r:
     case rocsparselt_datatype_bf16_r:
     case rocsparselt_datatype_i8_r:
+    case rocsparselt_datatype_i32_r:
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
         break;
+    // the C and D of a fp8 matmul may be fp32, a structured matrix may not
+    case rocsparselt_datatype_f32_r:
+        if(matrixType != rocsparselt_matrix_type_structured)
+            break;
+        hipsparselt_cerr << "a structured matrix cannot be f32_r" << std::endl;
+        log_error(handle, __func__, "a structured matrix cannot be f32_r");
+        return rocsparselt_status_not_implemented;
     default:
         hipsparselt_cerr << "datatype (" << rocsparselt_datatype_to_string(valueType)
                          << ") is not supported" << std::endl;
@@ -314,7 +434,23 @@ inline rocsparselt_status validateMatmulDescrArgs(const _rocsparselt_handle* han
         return rocsparselt_status_invalid_size;
     }
 
-    switch(type_a)
+    // a mixed input matmul computes in the type of its dense matrix
+    rocsparselt_datatype type_in = type_a;
+    if(matrix_type_a == rocsparselt_matrix_type_structured
+           ? rocsparselt_is_mixed_input(type_a, type_b)
+           : rocsparselt_is_mixed_input(type_b, type_a))
+    {
+        type_in = matrix_type_a == rocsparselt_matrix_type_structured ? type_b : type_a;
+        if(type_c != type_in || type_d != type_in)
+        {
+            log_error(handle,
+                      __func__,
+                      "C and D of a mixed input matmul must have the type of the dense matrix");
+            return rocsparselt_status_not_implemented;
+        }
+    }
+
+    switch(type_in)
     {
     case rocsparselt_datatype_bf16_r:
     case rocsparselt_datatype_f16_r:
@@ -337,7 +473,7 @@ inline rocsparselt_status validateMatmulDescrArgs(const _rocsparselt_handle* han
         log_error(handle,
                   __func__,
                   "datatype",
-                  rocsparselt_datatype_to_string(type_a),
+                  rocsparselt_datatype_to_string(type_in),
                   "is not supported");
         return rocsparselt_status_not_implemented;
     }
@@ -362,9 +498,27 @@ inline rocsparselt_status validateMatmulDescrArgs(const _rocsparselt_handle* han
     return rocsparselt_status_success;
 }
 
+/*******************************************************************************
+ * Uninitialized storage for a RocsparseltContractionProblem, so that callers *
+ * can hold the problem on the stack and ConstructRocSparseLtProblem can      *
+ * build it in place without a heap allocation.                               *
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+struct RocsparseltContractionProblemStorage
+{
+    RocsparseltContractionProblem<Ti, To, Tc>* get()
+    {
+        return reinterpret_cast<RocsparseltContractionProblem<Ti, To, Tc>*>(&data);
+    }
+
+private:
+    typename std::aligned_storage<sizeof(RocsparseltContractionProblem<Ti, To, Tc>),
+                                  alignof(RocsparseltContractionProblem<Ti, To, Tc>)>::type data;
+};
+
 template <typename Ti, typename To, typename Tc>
 rocsparselt_status ConstructRocSparseLtProblem(const char*                                 caller,
-                                               RocsparseltContractionProblem<Ti, To, Tc>** prob,
+                                               RocsparseltContractionProblem<Ti, To, Tc>*  prob,
                                                const _rocsparselt_matmul_descr*            matDescr,
                                                const Tc*    alpha         = nullptr,
                                                const Tc*    beta          = nullptr,
@@ -384,15 +538,15 @@ rocsparselt_status findTopConfigs(const _rocsparselt_matmul_descr* matmulDescr,
                                   int*                             config_max_id,
                                   const int                        requestConfigs = 10)
 {
-    RocsparseltContractionProblem<Ti, To, Tc>* prob;
-    Tc                                         alpha = static_cast<Tc>(1.0f);
-    Tc                                         beta  = static_cast<Tc>(1.0f);
-    auto                                       status
-        = ConstructRocSparseLtProblem<Ti, To, Tc>(__func__, &prob, matmulDescr, &alpha, &beta);
+    RocsparseltContractionProblemStorage<Ti, To, Tc> storage;
+    Tc                                               alpha = static_cast<Tc>(1.0f);
+    Tc                                               beta  = static_cast<Tc>(1.0f);
+
+    auto status = ConstructRocSparseLtProblem<Ti, To, Tc>(
+        __func__, storage.get(), matmulDescr, &alpha, &beta);
     if(status != rocsparselt_status_success)
         return status;
-    getBestSolutions<Ti, To, Tc>(*prob, requestConfigs, configs, config_max_id);
-    delete prob;
+    getBestSolutions<Ti, To, Tc>(*storage.get(), requestConfigs, configs, config_max_id);
     return status;
 }
 #endif
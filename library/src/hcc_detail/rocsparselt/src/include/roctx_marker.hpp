@@ -0,0 +1,101 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+#ifndef ROCTX_MARKER_HPP
+#define ROCTX_MARKER_HPP
+
+#include "rocsparselt.h"
+
+#include <cstdlib>
+
+/*******************************************************************************
+ * A library built with HIPSPARSELT_ENABLE_MARKER pushes a roctx range around
+ * the public matmul, prune and compress calls once HIPSPARSELT_ENABLE_MARKER=1
+ * is set at run time, so that rocprof and omnitrace show the kernels of a call
+ * under its sizes, types, config and label. Otherwise a range costs a check of
+ * a static flag.
+ ******************************************************************************/
+inline bool rocsparselt_markers()
+{
+#if HIPSPARSELT_ENABLE_MARKER
+    static const bool enabled = [] {
+        const char* env = getenv("HIPSPARSELT_ENABLE_MARKER");
+        return env != nullptr && atoi(env) > 0;
+    }();
+    return enabled;
+#else
+    return false;
+#endif
+}
+
+class rocsparselt_roctx_range
+{
+public:
+    // a range named after func, describing the problem and the config of plan
+    rocsparselt_roctx_range(const char* func, const rocsparselt_matmul_plan* plan)
+    {
+        if(rocsparselt_markers())
+            push(func, plan);
+    }
+    // a range named after func, describing the problem of matmul
+    rocsparselt_roctx_range(const char* func, const rocsparselt_matmul_descr* matmul)
+    {
+        if(rocsparselt_markers())
+            push(func, matmul);
+    }
+    // a range named after func, describing the matrix
+    rocsparselt_roctx_range(const char* func, const rocsparselt_mat_descr* matrix)
+    {
+        if(rocsparselt_markers())
+            push(func, matrix);
+    }
+    // a range named after func, over groups matrices
+    rocsparselt_roctx_range(const char* func, int groups)
+    {
+        if(rocsparselt_markers())
+            push(func, groups);
+    }
+    ~rocsparselt_roctx_range()
+    {
+        if(pushed)
+            pop();
+    }
+
+    rocsparselt_roctx_range(const rocsparselt_roctx_range&) = delete;
+    rocsparselt_roctx_range& operator=(const rocsparselt_roctx_range&) = delete;
+
+private:
+    void push(const char* func, const rocsparselt_matmul_plan* plan);
+    void push(const char* func, const rocsparselt_matmul_descr* matmul);
+    void push(const char* func, const rocsparselt_mat_descr* matrix);
+    void push(const char* func, int groups);
+    void pop();
+
+    bool pushed = false;
+};
+
+#endif // ROCTX_MARKER_HPP
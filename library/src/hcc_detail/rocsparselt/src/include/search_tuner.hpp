@@ -0,0 +1,292 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef SEARCH_TUNER_HPP
+#define SEARCH_TUNER_HPP
+
+#include "handle.h"
+#include "resource_pool.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <hip/hip_runtime_api.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*******************************************************************************
+ * Timings of one config collected by the search.
+ ******************************************************************************/
+struct rocsparselt_search_timing
+{
+    int    config_id = 0;
+    int    samples   = 0;
+    double sum_ms    = 0.0;
+    double sum_sq_ms = 0.0;
+    double min_ms    = 0.0;
+
+    void add(double ms)
+    {
+        min_ms = samples ? std::min(min_ms, ms) : ms;
+        samples++;
+        sum_ms += ms;
+        sum_sq_ms += ms * ms;
+    }
+
+    double mean_ms() const
+    {
+        return samples ? sum_ms / samples : 0.0;
+    }
+
+    // half width of the 95% confidence interval of the mean
+    double ci95_ms() const
+    {
+        if(samples < 2)
+            return 0.0;
+        double var = (sum_sq_ms - sum_ms * sum_ms / samples) / (samples - 1);
+        return 1.96 * std::sqrt(std::max(var, 0.0) / samples);
+    }
+};
+
+/*******************************************************************************
+ * rocsparselt_search_cache_flush evicts the inputs of the search from L2 and
+ * MALL (Infinity Cache) before a timed run by overwriting a scratch buffer
+ * larger than both, so the timings reflect weights which are cold in
+ * production. It does nothing unless it was initialized with enabled. The
+ * buffer comes from the resource pool of the handle and is freed with the
+ * flush, at the end of the search.
+ ******************************************************************************/
+struct rocsparselt_search_cache_flush
+{
+    explicit rocsparselt_search_cache_flush(const _rocsparselt_handle* handle)
+        : handle(handle)
+        , buffer(handle->resource_pool)
+    {
+    }
+
+    hipError_t init(bool enabled)
+    {
+        if(!enabled)
+            return hipSuccess;
+        // hipDeviceProp_t does not report the MALL, 512 MiB covers the 256 MiB of MI300
+        bytes = std::max<size_t>(size_t(handle->properties.l2CacheSize) * 4, size_t(512) << 20);
+        return buffer.acquire(bytes, false);
+    }
+
+    hipError_t operator()(hipStream_t stream) const
+    {
+        return buffer.get() != nullptr ? hipMemsetAsync(buffer.get(), 0, bytes, stream)
+                                       : hipSuccess;
+    }
+
+private:
+    const _rocsparselt_handle* handle;
+    rocsparselt_pooled_scratch buffer;
+    size_t                     bytes = 0;
+};
+
+/*******************************************************************************
+ * rocsparselt_search_timer times up to max_runs runs queued on a stream at once,
+ * each run between its own pair of events from the resource pool of the handle,
+ * and only waits for the last one, so that the runs are not separated by host
+ * synchronizations.
+ ******************************************************************************/
+struct rocsparselt_search_timer
+{
+    static constexpr int max_runs = 16;
+
+    explicit rocsparselt_search_timer(const _rocsparselt_handle* handle)
+    {
+        for(int i = 0; i < 2 * max_runs; i++)
+            events.push_back(
+                std::make_unique<rocsparselt_pooled_event>(handle->resource_pool, true));
+    }
+
+    hipError_t init()
+    {
+        for(auto& event : events)
+        {
+            hipError_t err = event->acquire();
+            if(err != hipSuccess)
+                return err;
+        }
+        return hipSuccess;
+    }
+
+    hipEvent_t start(int run) const
+    {
+        return *events[2 * run];
+    }
+
+    hipEvent_t stop(int run) const
+    {
+        return *events[2 * run + 1];
+    }
+
+    // the elapsed times of the runs [0, runs) to ms, once the last one completed
+    hipError_t elapsed(int runs, float* ms) const
+    {
+        hipError_t err = runs > 0 ? hipEventSynchronize(stop(runs - 1)) : hipSuccess;
+        for(int i = 0; i < runs && err == hipSuccess; i++)
+            err = hipEventElapsedTime(&ms[i], start(i), stop(i));
+        return err;
+    }
+
+private:
+    std::vector<std::unique_ptr<rocsparselt_pooled_event>> events;
+};
+
+/*******************************************************************************
+ * rocsparselt_search_successive_halving selects the fastest of candidates with
+ * the budget of the former brute-force search, search_iterations timed runs
+ * per candidate. Every round times all the remaining candidates the same
+ * number of times, then keeps at most half of them, dropping at once those
+ * whose confidence interval lies entirely above the one of the fastest. The
+ * budget left is spent on the close contenders.
+ *
+ * time_run(config_id, int runs, float* ms) launches config_id runs times, at
+ * most rocsparselt_search_timer::max_runs, and returns the elapsed time of each
+ * run to ms. The first run of each candidate is a warm up.
+ *
+ * ranking receives the timings of all the candidates, the ones which survived
+ * the longest first, and the fastest first among those dropped together.
+ ******************************************************************************/
+template <typename TimeRun>
+hipError_t
+    rocsparselt_search_successive_halving(const _rocsparselt_handle*              handle,
+                                          const std::vector<int>&                 candidates,
+                                          int                                     search_iterations,
+                                          TimeRun&&                               time_run,
+                                          int*                                    best_config_id,
+                                          std::vector<rocsparselt_search_timing>* ranking)
+{
+    std::vector<rocsparselt_search_timing> alive;
+    ranking->clear();
+    float                                  ms[rocsparselt_search_timer::max_runs];
+    for(int id : candidates)
+    {
+        hipError_t err = time_run(id, 1, ms);
+        if(err != hipSuccess)
+            return err;
+        alive.push_back({});
+        alive.back().config_id = id;
+    }
+    if(alive.empty())
+        return hipSuccess;
+
+    const int     rounds = std::max(1, int(std::ceil(std::log2(double(alive.size())))));
+    const int64_t budget = int64_t(search_iterations) * alive.size();
+    // a single candidate is still timed, its results are reported
+    for(int round = 0; round < rounds && (round == 0 || alive.size() > 1); round++)
+    {
+        const int64_t reps = std::max<int64_t>(2, budget / rounds / alive.size());
+        for(auto& timing : alive)
+        {
+            for(int64_t i = 0; i < reps; i += rocsparselt_search_timer::max_runs)
+            {
+                int runs
+                    = int(std::min<int64_t>(reps - i, rocsparselt_search_timer::max_runs));
+                hipError_t err = time_run(timing.config_id, runs, ms);
+                if(err != hipSuccess)
+                    return err;
+                for(int run = 0; run < runs; run++)
+                    timing.add(ms[run]);
+            }
+        }
+
+        std::sort(alive.begin(), alive.end(), [](const auto& a, const auto& b) {
+            return a.mean_ms() < b.mean_ms();
+        });
+
+        const double bound = alive[0].mean_ms() + alive[0].ci95_ms();
+        const size_t keep  = (alive.size() + 1) / 2;
+        size_t       kept  = 1;
+        while(kept < keep && alive[kept].mean_ms() - alive[kept].ci95_ms() <= bound)
+            kept++;
+
+        for(size_t i = kept; i < alive.size(); i++)
+            log_info(handle,
+                     "rocsparselt_matmul_search",
+                     "dropped config_id",
+                     alive[i].config_id,
+                     "mean_ms",
+                     alive[i].mean_ms(),
+                     "ci95_ms",
+                     alive[i].ci95_ms(),
+                     "samples",
+                     alive[i].samples);
+        ranking->insert(ranking->begin(), alive.begin() + kept, alive.end());
+        alive.resize(kept);
+    }
+    ranking->insert(ranking->begin(), alive.begin(), alive.end());
+
+    *best_config_id = alive[0].config_id;
+    log_info(handle,
+             "rocsparselt_matmul_search",
+             "selected config_id",
+             alive[0].config_id,
+             "mean_ms",
+             alive[0].mean_ms(),
+             "ci95_ms",
+             alive[0].ci95_ms(),
+             "samples",
+             alive[0].samples);
+    return hipSuccess;
+}
+
+/*******************************************************************************
+ * rocsparselt_search_store_results copies the head of ranking to results,
+ * which holds max_results entries, kernel_name(config_id) returns the name of
+ * the kernel of a config. The entries left have config_id -1.
+ ******************************************************************************/
+template <typename KernelName>
+void rocsparselt_search_store_results(const std::vector<rocsparselt_search_timing>& ranking,
+                                      KernelName&&                                  kernel_name,
+                                      rocsparselt_matmul_search_result*             results,
+                                      int                                           max_results)
+{
+    for(int i = 0; i < max_results; i++)
+    {
+        auto& result = results[i];
+        result       = {};
+        if(i >= int(ranking.size()))
+        {
+            result.config_id = -1;
+            continue;
+        }
+        result.config_id = ranking[i].config_id;
+        result.samples   = ranking[i].samples;
+        result.mean_ms   = float(ranking[i].mean_ms());
+        result.min_ms    = float(ranking[i].min_ms);
+
+        const std::string name = kernel_name(ranking[i].config_id);
+        strncpy(result.kernel_name, name.c_str(), sizeof(result.kernel_name) - 1);
+    }
+}
+
+#endif
@@ -107,6 +107,27 @@ struct RocsparseltContractionProblem
     int64_t                     bias_stride;
     rocsparselt_datatype        bias_type;
 
+    // per-row scales of alpha and beta in device memory, nullptr when not enabled
+    const float* alpha_vector = nullptr;
+    const float* beta_vector  = nullptr;
+    // scale and saturation of D and the device float receiving amax(D), 1, false and nullptr
+    // when not enabled
+    float  d_scale    = 1.f;
+    bool   d_saturate = false;
+    float* amax_d     = nullptr;
+    // residual of the layout of D added after the activation, nullptr when not enabled
+    const To* residual              = nullptr;
+    size_t    batch_stride_residual = 0;
+    // gate of the layout of D multiplying the activated result, nullptr when not enabled, it
+    // may alias D
+    const To* gate              = nullptr;
+    size_t    batch_stride_gate = 0;
+    // device vector of m floats receiving the sums of the rows of D over the columns and the
+    // batches, nullptr when not enabled
+    float* bias_grad = nullptr;
+    // CUs the problem runs on, 0 for all the CUs of the device
+    int cu_count = 0;
+
     void*  workspace;
     size_t workspaceSize;
 
@@ -466,13 +487,20 @@ struct RocsparseltContractionProblem
 
 /*******************************************************************************
  * runContractionProblem() solves a RocsparseltContractionProblem                  *
+ * When solution_cache is given, the Tensile problem and solution resolved for *
+ * the selected config are kept there and reused by the following calls.      *
+ * When search_results is given, a search stores the timings of the fastest    *
+ * configs there.                                                              *
  *******************************************************************************/
 template <typename Ti, typename To, typename Tc>
 rocsparselt_status runContractionProblem(RocsparseltContractionProblem<Ti, To, Tc> const& problem,
                                          _rocsparselt_matmul_config*                      configs,
                                          int*                                             config_id,
-                                         const int config_max_id,
-                                         const int search_iterations);
+                                         const int                         config_max_id,
+                                         const int                         search_iterations,
+                                         const bool                        search_flush_cache,
+                                         rocsparselt_matmul_search_result* search_results,
+                                         _rocsparselt_solution_cache*      solution_cache = nullptr);
 
 template <typename Ti, typename To, typename Tc>
 rocsparselt_status getBestSolutions(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
@@ -480,6 +508,15 @@ rocsparselt_status getBestSolutions(const RocsparseltContractionProblem<Ti, To,
                                     _rocsparselt_matmul_config*                      configs,
                                     int*                                             foundConfigs);
 
+/*******************************************************************************
+ * Whether the Tensile library of the device of the handle of matmulDescr has   *
+ * the solution of config for the problem of matmulDescr. The Tensile configs   *
+ * have no Stream-K partner. With HIPSPARSELT_TENSILE_LAZY_LOAD the library of  *
+ * the problem type is loaded to look the solution up.                          *
+ *******************************************************************************/
+bool hasSolution(const _rocsparselt_matmul_descr*  matmulDescr,
+                 const _rocsparselt_matmul_config& config);
+
 /***********************************************************************************
  * Whether Tensile has been initialized for at least one device (used for testing) *
  ***********************************************************************************/
@@ -0,0 +1,126 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+#ifndef TRACING_HPP
+#define TRACING_HPP
+
+#include <cstdint>
+#include <cstdlib>
+#include <hip/hip_runtime_api.h>
+#include <string>
+
+/*******************************************************************************
+ * HIPSPARSELT_TRACE_FILE names a file which receives a timeline of the library
+ * activity in the Chrome trace event format, opened with chrome://tracing or
+ * Perfetto. %i in the name is replaced by the process id. The host spans are
+ * shown per thread, with the stream of the call in their arguments; the GPU
+ * spans are shown per stream and get an arrow from the host call which
+ * launched them. The GPU spans are written once their events completed, the
+ * pending ones when a handle is destroyed.
+ ******************************************************************************/
+inline bool rocsparselt_tracing()
+{
+    static const bool enabled = getenv("HIPSPARSELT_TRACE_FILE") != nullptr;
+    return enabled;
+}
+
+// writes the GPU spans still pending, waiting for their events
+void rocsparselt_trace_flush();
+
+// records the GPU span between the completed events start and stop of stream,
+// on a device which already has a GPU span
+void rocsparselt_trace_gpu_events(const std::string& name,
+                                  hipStream_t        stream,
+                                  hipEvent_t         start,
+                                  hipEvent_t         stop);
+
+/*******************************************************************************
+ * rocsparselt_trace_span records a host span from its construction to its
+ * destruction. name must outlive the span; detail is copied.
+ ******************************************************************************/
+class rocsparselt_trace_span
+{
+public:
+    explicit rocsparselt_trace_span(const char* name,
+                                    hipStream_t stream = nullptr,
+                                    const char* detail = nullptr)
+    {
+        if(rocsparselt_tracing())
+            begin(name, stream, detail);
+    }
+    ~rocsparselt_trace_span()
+    {
+        if(start_us >= 0)
+            end();
+    }
+
+    rocsparselt_trace_span(const rocsparselt_trace_span&) = delete;
+    rocsparselt_trace_span& operator=(const rocsparselt_trace_span&) = delete;
+
+private:
+    void begin(const char* name, hipStream_t stream, const char* detail);
+    void end();
+
+    const char* name     = nullptr;
+    hipStream_t stream   = nullptr;
+    double      start_us = -1;
+    std::string detail;
+};
+
+/*******************************************************************************
+ * rocsparselt_trace_gpu_span records the work queued on stream from its
+ * construction to its destruction as a GPU span, timed with a pair of events.
+ * The work captured into a graph gets no GPU span.
+ ******************************************************************************/
+class rocsparselt_trace_gpu_span
+{
+public:
+    rocsparselt_trace_gpu_span(const char* name, hipStream_t stream)
+    {
+        if(rocsparselt_tracing())
+            begin(name, stream);
+    }
+    ~rocsparselt_trace_gpu_span()
+    {
+        if(start != nullptr)
+            end();
+    }
+
+    rocsparselt_trace_gpu_span(const rocsparselt_trace_gpu_span&) = delete;
+    rocsparselt_trace_gpu_span& operator=(const rocsparselt_trace_gpu_span&) = delete;
+
+private:
+    void begin(const char* name, hipStream_t stream);
+    void end();
+
+    const char* name   = nullptr;
+    hipStream_t stream = nullptr;
+    hipEvent_t  start  = nullptr;
+    uint64_t    flow   = 0;
+};
+
+#endif // TRACING_HPP
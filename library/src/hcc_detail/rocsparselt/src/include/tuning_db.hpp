@@ -0,0 +1,52 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#pragma once
+#ifndef TUNING_DB_HPP
+#define TUNING_DB_HPP
+
+#include "handle.h"
+#include "utility.hpp"
+
+#include <string>
+
+/*******************************************************************************
+ * The tuning database keeps the result of rocsparselt_matmul_search() across
+ * processes. Its entries are the "hip" lines "hip <problem signature> <config
+ * index>" of the file shared with the CUDA backend, see
+ * hipsparselt_tuning_db.hpp.
+ ******************************************************************************/
+
+/*! \brief the key of a problem: device, types, operations, sizes, epilogue and candidates */
+std::string rocsparselt_tuning_signature(const _rocsparselt_handle*       handle,
+                                         const _rocsparselt_matmul_descr* matmul_descr);
+
+/*! \brief look up the config index (_rocsparselt_matmul_config::index) tuned for signature */
+bool rocsparselt_tuning_db_find(const std::string& signature, int* index);
+
+/*! \brief record the config index tuned for signature, unless the database is read only */
+void rocsparselt_tuning_db_store(const std::string& signature, int index);
+
+#endif
@@ -29,11 +29,15 @@
 #ifndef UTILITY_HPP
 #define UTILITY_HPP
 
+#include "async_logger.hpp"
 #include "auxiliary.hpp"
 #include "handle.h"
 #include "logging.h"
 #include <algorithm>
 #include <exception>
+#include <functional>
+#include <mutex>
+#include <sstream>
 
 #pragma STDC CX_LIMITED_RANGE ON
 
@@ -106,6 +110,41 @@ const char* rocsparselt_layer_mode2string(rocsparselt_layer_mode layer_mode);
 
 const char* rocsparselt_activation_type_to_string(rocsparselt_matmul_descr_attribute type);
 
+// Run fn(device) for each device of device_mask, bit i standing for device i and
+// 0 for all the devices, on one thread per device with that device current.
+// Returns the first failing status of fn, an exception thrown by fn counts as
+// its status (rocsparselt_status_internal_error when it is not a status).
+rocsparselt_status
+    rocsparselt_run_on_devices(uint64_t                                      device_mask,
+                               const std::function<rocsparselt_status(int)>& fn);
+
+// log_line formats a line with log_arguments and writes it to os at once, so
+// that the lines logged by concurrent calls on a handle do not interleave.
+// With HIPSPARSELT_LOG_ASYNC the line is formatted into a buffer of the
+// calling thread and written by the asynchronous logger of the handle.
+template <typename H, typename... Ts>
+void log_line(const _rocsparselt_handle* handle,
+              std::ostream&              os,
+              std::string&               separator,
+              std::string&               prefix,
+              H                          head,
+              Ts&&... xs)
+{
+    if(handle->async_logger != nullptr)
+    {
+        auto& line = rocsparselt_log_line::thread_line();
+        log_arguments(line.stream(), separator, prefix, head, std::forward<Ts>(xs)...);
+        handle->async_logger->push(os, line.str());
+        return;
+    }
+
+    std::ostringstream line;
+    log_arguments(line, separator, prefix, head, std::forward<Ts>(xs)...);
+
+    std::lock_guard<std::mutex> lock(*handle->log_mutex);
+    os << line.str();
+}
+
 // if trace logging is turned on with
 // (handle->layer_mode & rocsparselt_layer_mode_log_trace) == true
 // then
@@ -128,7 +167,7 @@ void log_base(const _rocsparselt_handle* handle,
 
             std::string prefix_str = prefix(rocsparselt_layer_mode2string(layer_mode), func);
 
-            log_arguments(*os, comma_separator, prefix_str, head, std::forward<Ts>(xs)...);
+            log_line(handle, *os, comma_separator, prefix_str, head, std::forward<Ts>(xs)...);
         }
     }
 }
@@ -194,8 +233,7 @@ void log_api(const _rocsparselt_handle* handle, const char* func, H head, Ts&&..
 // log_bench will call log_arguments to log a string that
 // can be input to the executable rocsparselt-bench.
 template <typename H, typename... Ts>
-void log_bench(
-    const _rocsparselt_handle* handle, const char* func, H head, std::string precision, Ts&&... xs)
+void log_bench(const _rocsparselt_handle* handle, const char* func, H head, Ts&&... xs)
 {
     if(nullptr != handle && nullptr != handle->log_bench_os)
     {
@@ -207,7 +245,7 @@ void log_bench(
 
             std::string prefix_str = prefix("Bench", func);
 
-            log_arguments(*os, comma_separator, prefix_str, head, std::forward<Ts>(xs)...);
+            log_line(handle, *os, comma_separator, prefix_str, head, std::forward<Ts>(xs)...);
         }
     }
 }
@@ -0,0 +1,121 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "launch_table.hpp"
+#include "hipsparselt_ostream.hpp"
+#include "utility.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct launch_row
+    {
+        std::string               arch;
+        rocsparselt_launch_kernel kernel;
+        std::string               type;
+        bool                      k_contiguous;
+        int                       variant;
+    };
+
+    // the rows measured with hipsparselt-bench --tune_launch whose best variant is not 0, none
+    // yet: a kernel runs its variant 0 unless $HIPSPARSELT_LAUNCH_TABLE has a row for it
+    const std::vector<launch_row> builtin_rows = {};
+
+    const char* kernel_name(rocsparselt_launch_kernel kernel)
+    {
+        switch(kernel)
+        {
+        case rocsparselt_launch_kernel::prune_strip:
+            return "prune_strip";
+        case rocsparselt_launch_kernel::prune_tile:
+            return "prune_tile";
+        case rocsparselt_launch_kernel::compress:
+            return "compress";
+        }
+        return "";
+    }
+
+    // the built-in rows followed by those of $HIPSPARSELT_LAUNCH_TABLE, read once
+    const std::vector<launch_row>& launch_rows()
+    {
+        static const std::vector<launch_row> rows = [] {
+            std::vector<launch_row> rows = builtin_rows;
+
+            const char* path = getenv("HIPSPARSELT_LAUNCH_TABLE");
+            if(path == nullptr || *path == '\0')
+                return rows;
+            std::ifstream ifs(path);
+            std::string   line;
+            while(std::getline(ifs, line))
+            {
+                std::istringstream iss(line);
+                std::string        arch, kernel, type, layout;
+                int                variant;
+                if(line.empty() || line[0] == '#'
+                   || !(iss >> arch >> kernel >> type >> layout >> variant))
+                    continue;
+                for(auto k : {rocsparselt_launch_kernel::prune_strip,
+                              rocsparselt_launch_kernel::prune_tile,
+                              rocsparselt_launch_kernel::compress})
+                {
+                    if(kernel == kernel_name(k) && (layout == "k" || layout == "m") && variant >= 0
+                       && variant < rocsparselt_launch_variant_count(k))
+                        rows.push_back({arch, k, type, layout == "k", variant});
+                }
+            }
+            return rows;
+        }();
+        return rows;
+    }
+}
+
+int rocsparselt_launch_variant(const _rocsparselt_handle* handle,
+                               rocsparselt_launch_kernel  kernel,
+                               rocsparselt_datatype       type,
+                               bool                       k_contiguous)
+{
+    if(handle->launch_variant >= 0)
+        return handle->launch_variant < rocsparselt_launch_variant_count(kernel)
+                   ? handle->launch_variant
+                   : 0;
+
+    // the arch without its features, the last matching row wins
+    const char* arch     = handle->properties.gcnArchName;
+    size_t      arch_len = strcspn(arch, ":");
+    const char* type_str = rocsparselt_datatype_to_string(type);
+    int         variant  = 0;
+    for(const auto& row : launch_rows())
+    {
+        if(row.kernel == kernel && row.k_contiguous == k_contiguous && row.type == type_str
+           && row.arch.size() == arch_len && row.arch.compare(0, arch_len, arch, arch_len) == 0)
+            variant = row.variant;
+    }
+    return variant;
+}
@@ -0,0 +1,448 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "config_cache.hpp"
+#include "definitions.h"
+#include "handle.h"
+#include "hipsparselt_ostream.hpp"
+#include "rocsparselt.h"
+#include "rocsparselt_pad.hpp"
+#include "rocsparselt_spmm_utils.hpp"
+#include "tuning_db.hpp"
+#include "utility.hpp"
+
+#include <cstring>
+#include <hipsparselt/hipsparselt-version.h>
+#include <string>
+
+/*******************************************************************************
+ * A serialized plan is a fixed header followed by the signature of its problem
+ * (see rocsparselt_tuning_signature()), the configs of its algorithm selection
+ * and the name of the kernel of the selected config. The pointers of the matmul
+ * descriptor are only valid in the process which set them, so the descriptor is
+ * rebuilt by the caller and its signature must match the saved one.
+ * All the fields are little endian.
+ ******************************************************************************/
+namespace
+{
+    constexpr char     plan_blob_magic[8] = {'H', 'S', 'L', 'T', 'P', 'L', 'N', '\0'};
+    constexpr uint32_t plan_blob_version  = 1;
+    constexpr uint32_t library_version    = hipsparseltVersionMajor * 100000
+                                         + hipsparseltVersionMinor * 100 + hipsparseltVersionPatch;
+    constexpr int32_t  backend            = BUILD_WITH_TENSILE ? 1 : 0;
+
+    struct plan_blob_header
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t header_size;
+        uint32_t library_version;
+        int32_t  backend;
+        char     arch[64];
+        uint32_t signature_size;
+        uint32_t kernel_name_size;
+        int32_t  config_max_id;
+        int32_t  config_id;
+        int32_t  split_k;
+        int32_t  split_k_mode;
+        int32_t  stream_k;
+        int32_t  reduce_epilogue;
+        int32_t  search_dense;
+        int32_t  dense_selected;
+        uint64_t blob_size;
+    };
+
+    struct plan_blob_config
+    {
+        int32_t  index;
+        int32_t  use_bias;
+        uint64_t max_workspace_bytes;
+        int32_t  split_k;
+        int32_t  split_k_mode;
+        int32_t  stream_k_index;
+        int32_t  stream_k_columns;
+        int32_t  excluded;
+        int32_t  reserved;
+    };
+
+    constexpr int max_configs
+        = sizeof(_rocsparselt_matmul_alg_selection::configs) / sizeof(_rocsparselt_matmul_config);
+
+    std::string arch_name(const _rocsparselt_handle* handle)
+    {
+        std::string arch(handle->properties.gcnArchName);
+        return arch.substr(0, arch.find(':'));
+    }
+
+    rocsparselt_status validate_handle(const rocsparselt_handle*   handle,
+                                       const _rocsparselt_handle*& _handle)
+    {
+        if(handle == nullptr)
+        {
+            hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+            return rocsparselt_status_invalid_handle;
+        }
+        _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+        if(!_handle->isInit())
+        {
+            hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+            return rocsparselt_status_invalid_handle;
+        }
+        return rocsparselt_status_success;
+    }
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************************************************************************
+ * \brief writes the problem of plan, the configs of its algorithm selection and
+ * the selected one to data, or the size of the blob to dataSize when data is
+ * nullptr.
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_plan_serialize(const rocsparselt_handle*      handle,
+                                                     const rocsparselt_matmul_plan* plan,
+                                                     void*                          data,
+                                                     size_t*                        dataSize)
+{
+    const _rocsparselt_handle* _handle;
+    RETURN_IF_ROCSPARSELT_ERROR(validate_handle(handle, _handle));
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, __func__));
+    if(dataSize == nullptr)
+    {
+        log_error(_handle, __func__, "dataSize is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    try
+    {
+        auto matmul        = _plan->matmul_descr;
+        auto alg_selection = _plan->alg_selection;
+
+        const std::string signature = rocsparselt_tuning_signature(_handle, matmul);
+        const std::string kernel_name
+            = rocsparselt_selected_kernel_name(_handle, matmul, alg_selection);
+        const std::string arch = arch_name(_handle);
+
+        plan_blob_header header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, plan_blob_magic, sizeof(header.magic));
+        header.version          = plan_blob_version;
+        header.header_size      = sizeof(header);
+        header.library_version  = library_version;
+        header.backend          = backend;
+        header.signature_size   = signature.size();
+        header.kernel_name_size = kernel_name.size();
+        header.config_max_id    = alg_selection->config_max_id;
+        header.config_id        = alg_selection->config_id;
+        header.split_k          = alg_selection->split_k;
+        header.split_k_mode     = alg_selection->split_k_mode;
+        header.stream_k         = alg_selection->stream_k;
+        header.reduce_epilogue  = alg_selection->reduce_epilogue;
+        header.search_dense     = alg_selection->search_dense;
+        header.dense_selected   = alg_selection->dense_selected;
+        header.blob_size        = sizeof(header) + signature.size()
+                           + sizeof(plan_blob_config) * alg_selection->config_max_id
+                           + kernel_name.size();
+        strncpy(header.arch, arch.c_str(), sizeof(header.arch) - 1);
+
+        log_api(_handle,
+                __func__,
+                "plan[in]",
+                *_plan,
+                "data[out]",
+                data,
+                "dataSize[inout]",
+                *dataSize);
+
+        // a NULL data only queries the size
+        if(data == nullptr)
+        {
+            *dataSize = header.blob_size;
+            return rocsparselt_status_success;
+        }
+        if(*dataSize < header.blob_size)
+        {
+            log_error(
+                _handle, __func__, "dataSize", *dataSize, "is smaller than", header.blob_size);
+            *dataSize = header.blob_size;
+            return rocsparselt_status_invalid_size;
+        }
+
+        char* out = static_cast<char*>(data);
+        memcpy(out, &header, sizeof(header));
+        out += sizeof(header);
+        memcpy(out, signature.data(), signature.size());
+        out += signature.size();
+        for(int i = 0; i < alg_selection->config_max_id; i++)
+        {
+            const auto&      config = alg_selection->configs[i];
+            plan_blob_config record;
+            memset(&record, 0, sizeof(record));
+            record.index               = config.index;
+            record.use_bias            = config.use_bias;
+            record.max_workspace_bytes = config.max_workspace_bytes;
+            record.split_k             = config.split_k;
+            record.split_k_mode        = config.split_k_mode;
+            record.stream_k_index      = config.stream_k_index;
+            record.stream_k_columns    = config.stream_k_columns;
+            record.excluded            = config.excluded;
+            memcpy(out, &record, sizeof(record));
+            out += sizeof(record);
+        }
+        memcpy(out, kernel_name.data(), kernel_name.size());
+        *dataSize = header.blob_size;
+    }
+    catch(const rocsparselt_status& status)
+    {
+        log_info(_handle, __func__, "status", status);
+        return status;
+    }
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief initializes plan and algSelection from a blob of
+ * rocsparselt_matmul_plan_serialize(), after checking that it was written for
+ * the problem of matmulDescr and that its configs are solutions of the library.
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_matmul_plan_deserialize(const rocsparselt_handle*         handle,
+                                        rocsparselt_matmul_plan*          plan,
+                                        const rocsparselt_matmul_descr*   matmulDescr,
+                                        rocsparselt_matmul_alg_selection* algSelection,
+                                        const void*                       data,
+                                        size_t                            dataSize)
+{
+    const _rocsparselt_handle* _handle;
+    RETURN_IF_ROCSPARSELT_ERROR(validate_handle(handle, _handle));
+
+    if(matmulDescr == nullptr)
+    {
+        log_error(_handle, __func__, "matmulDescr is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _matmulDescr = reinterpret_cast<const _rocsparselt_matmul_descr*>(matmulDescr);
+    if(!_matmulDescr->isInit())
+    {
+        log_error(_handle, __func__, "matmulDescr did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    if(algSelection == nullptr)
+    {
+        log_error(_handle, __func__, "algSelection is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    if(data == nullptr)
+    {
+        log_error(_handle, __func__, "data is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    log_api(_handle,
+            __func__,
+            "plan[out]",
+            plan,
+            "matmulDescr[in]",
+            *_matmulDescr,
+            "algSelection[out]",
+            algSelection,
+            "data[in]",
+            data,
+            "dataSize[in]",
+            dataSize);
+
+    try
+    {
+        plan_blob_header header;
+        if(dataSize < sizeof(header))
+        {
+            log_error(_handle, __func__, "data is not a serialized plan");
+            return rocsparselt_status_invalid_value;
+        }
+        const char* in = static_cast<const char*>(data);
+        memcpy(&header, in, sizeof(header));
+
+        // the sizes are added in 64 bits, each one within the bytes which remain
+        uint64_t remaining = dataSize;
+        auto     take      = [&](uint64_t bytes) {
+            if(bytes > remaining)
+                return false;
+            remaining -= bytes;
+            return true;
+        };
+        if(memcmp(header.magic, plan_blob_magic, sizeof(header.magic)) != 0
+           || header.header_size < sizeof(header) || header.config_max_id < 0
+           || header.config_max_id > max_configs || header.config_id < 0
+           || (header.config_max_id > 0 ? header.config_id >= header.config_max_id
+                                        : header.config_id != 0 || !header.dense_selected)
+           || !take(header.header_size) || !take(header.signature_size)
+           || !take(uint64_t(sizeof(plan_blob_config)) * header.config_max_id)
+           || !take(header.kernel_name_size) || header.blob_size != dataSize - remaining)
+        {
+            log_error(_handle, __func__, "data is not a serialized plan");
+            return rocsparselt_status_invalid_value;
+        }
+        if(header.version > plan_blob_version)
+        {
+            log_error(
+                _handle, __func__, "the serialized plan has an unsupported version", header.version);
+            return rocsparselt_status_not_implemented;
+        }
+        // the configs index the kernels of the library which found them
+        if(header.library_version != library_version || header.backend != backend)
+        {
+            log_error(_handle,
+                      __func__,
+                      "the plan was serialized by library version",
+                      header.library_version,
+                      "backend",
+                      header.backend);
+            return rocsparselt_status_invalid_value;
+        }
+        header.arch[sizeof(header.arch) - 1] = '\0';
+        if(arch_name(_handle) != header.arch)
+        {
+            log_error(_handle, __func__, "the plan was serialized on", header.arch);
+            return rocsparselt_status_invalid_value;
+        }
+
+        in += header.header_size;
+        const std::string signature(in, header.signature_size);
+        in += header.signature_size;
+        if(signature != rocsparselt_tuning_signature(_handle, _matmulDescr))
+        {
+            log_error(_handle, __func__, "the serialized plan does not match matmulDescr");
+            return rocsparselt_status_invalid_value;
+        }
+
+        _rocsparselt_matmul_alg_selection tmpAlgSelection(_handle);
+        for(int i = 0; i < header.config_max_id; i++)
+        {
+            plan_blob_config record;
+            memcpy(&record, in, sizeof(record));
+            in += sizeof(record);
+
+            auto& config               = tmpAlgSelection.configs[i];
+            config.index               = record.index;
+            config.use_bias            = record.use_bias;
+            config.max_workspace_bytes = record.max_workspace_bytes;
+            config.split_k             = record.split_k;
+            config.split_k_mode        = record.split_k_mode;
+            config.stream_k_index      = record.stream_k_index;
+            config.stream_k_columns    = record.stream_k_columns;
+            config.excluded            = record.excluded != 0;
+
+            // the configs index the solutions of the library
+            bool found = true;
+#if BUILD_WITH_TENSILE
+            found = hasSolution(_matmulDescr, config);
+#else
+            found = !getSolutionName(_handle, _matmulDescr, config.index).empty()
+                    && (config.stream_k_index < 0
+                        || !getSolutionName(_handle, _matmulDescr, config.stream_k_index).empty());
+#endif
+            if(!found)
+            {
+                log_error(_handle, __func__, "config", i, "has no solution", config.index);
+                return rocsparselt_status_invalid_value;
+            }
+        }
+        const std::string kernel_name(in, header.kernel_name_size);
+
+        tmpAlgSelection.alg             = rocsparselt_matmul_alg_default;
+        tmpAlgSelection.config_max_id   = header.config_max_id;
+        tmpAlgSelection.config_id       = header.config_id;
+        tmpAlgSelection.split_k         = header.split_k;
+        tmpAlgSelection.split_k_mode    = header.split_k_mode;
+        tmpAlgSelection.stream_k        = header.stream_k;
+        tmpAlgSelection.reduce_epilogue = header.reduce_epilogue != 0;
+        tmpAlgSelection.search_dense    = header.search_dense;
+        tmpAlgSelection.dense_selected  = header.dense_selected;
+        // only the plans of a device without SMFMAC instructions have no configs
+        tmpAlgSelection.dense_only = header.config_max_id == 0;
+
+#if !BUILD_WITH_TENSILE
+        // only the kernels of the selected config are loaded, the others are loaded at their
+        // first launch if the config is changed later
+        if(!tmpAlgSelection.dense_selected)
+        {
+            const auto& config = tmpAlgSelection.configs[tmpAlgSelection.config_id];
+            if(getSolutionName(_handle, _matmulDescr, config.index) != kernel_name)
+            {
+                log_error(_handle, __func__, "the kernel", kernel_name, "is not in the library");
+                return rocsparselt_status_invalid_value;
+            }
+            RETURN_IF_ROCSPARSELT_ERROR(loadSolution(_handle, kernel_name));
+            if(config.stream_k_index >= 0)
+                RETURN_IF_ROCSPARSELT_ERROR(loadSolution(
+                    _handle, getSolutionName(_handle, _matmulDescr, config.stream_k_index)));
+        }
+#else
+        // the Tensile backend loads the code objects of a problem type with its solutions
+        (void)kernel_name;
+#endif
+
+        // later plans of the same problem share the configs
+        if(tmpAlgSelection.config_max_id > 0)
+        {
+            _handle->config_cache->insert(
+                signature, &(tmpAlgSelection.configs[0]), tmpAlgSelection.config_max_id);
+            _handle->config_cache->set_best(signature, tmpAlgSelection.config_id);
+        }
+
+        memcpy(algSelection, &tmpAlgSelection, sizeof(_rocsparselt_matmul_alg_selection));
+        log_info(_handle, __func__, "config_id", tmpAlgSelection.config_id, "kernel", kernel_name);
+    }
+    catch(const rocsparselt_status& status)
+    {
+        log_info(_handle, __func__, "status", status);
+        return status;
+    }
+    return rocsparselt_matmul_plan_init(handle, plan, matmulDescr, algSelection);
+}
+
+#ifdef __cplusplus
+}
+#endif
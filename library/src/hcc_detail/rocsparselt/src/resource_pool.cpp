@@ -0,0 +1,173 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "resource_pool.hpp"
+
+_rocsparselt_resource_pool::~_rocsparselt_resource_pool()
+{
+    for(auto event : events)
+        (void)hipEventDestroy(event);
+    for(auto event : timing_events)
+        (void)hipEventDestroy(event);
+    for(auto stream : streams)
+        (void)hipStreamDestroy(stream);
+    for(auto& buffer : free_scratch)
+        (void)hipFree(buffer.second);
+    // buffers still in use are freed as well, their owners may not outlive the handle
+    for(auto& buffer : used_scratch)
+        (void)hipFree(buffer.first);
+}
+
+hipError_t _rocsparselt_resource_pool::acquire_event(hipEvent_t* event, bool timing)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto&                       pooled = timing ? timing_events : events;
+        if(!pooled.empty())
+        {
+            *event = pooled.back();
+            pooled.pop_back();
+            return hipSuccess;
+        }
+    }
+    return timing ? hipEventCreate(event) : hipEventCreateWithFlags(event, hipEventDisableTiming);
+}
+
+void _rocsparselt_resource_pool::release_event(hipEvent_t event, bool timing)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    (timing ? timing_events : events).push_back(event);
+}
+
+hipError_t _rocsparselt_resource_pool::acquire_stream(hipStream_t* stream)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!streams.empty())
+        {
+            *stream = streams.back();
+            streams.pop_back();
+            return hipSuccess;
+        }
+    }
+    return hipStreamCreateWithFlags(stream, hipStreamNonBlocking);
+}
+
+void _rocsparselt_resource_pool::release_stream(hipStream_t stream)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    streams.push_back(stream);
+}
+
+hipError_t _rocsparselt_resource_pool::acquire_scratch(size_t bytes, void** ptr)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto                        it = free_scratch.lower_bound(bytes);
+        if(it != free_scratch.end())
+        {
+            *ptr = it->second;
+            used_scratch.emplace(it->second, it->first);
+            free_scratch_bytes -= it->first;
+            free_scratch.erase(it);
+            return hipSuccess;
+        }
+    }
+
+    hipError_t status = hipMalloc(ptr, bytes);
+    if(status == hipSuccess)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        used_scratch.emplace(*ptr, bytes);
+    }
+    return status;
+}
+
+void _rocsparselt_resource_pool::release_scratch(void* ptr, bool keep)
+{
+    std::vector<void*> freed;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto                        it = used_scratch.find(ptr);
+        if(it == used_scratch.end())
+            return;
+        if(keep)
+        {
+            free_scratch.emplace(it->second, it->first);
+            free_scratch_bytes += it->second;
+        }
+        else
+            freed.push_back(ptr);
+        used_scratch.erase(it);
+
+        // the largest free buffers first
+        while(free_scratch_bytes > max_free_scratch)
+        {
+            auto largest = std::prev(free_scratch.end());
+            free_scratch_bytes -= largest->first;
+            freed.push_back(largest->second);
+            free_scratch.erase(largest);
+        }
+    }
+    for(auto buffer : freed)
+        (void)hipFree(buffer);
+}
+
+_rocsparselt_workspace_pool::~_rocsparselt_workspace_pool()
+{
+    // the memory of the frees still queued is released once they have run
+    if(pool != nullptr)
+        (void)hipMemPoolDestroy(pool);
+}
+
+hipError_t _rocsparselt_workspace_pool::init(int device)
+{
+    hipMemPoolProps props = {};
+    props.allocType       = hipMemAllocationTypePinned;
+    props.location.type   = hipMemLocationTypeDevice;
+    props.location.id     = device;
+    hipError_t status     = hipMemPoolCreate(&pool, &props);
+    if(status != hipSuccess)
+    {
+        pool = nullptr;
+        return status;
+    }
+
+    // keep up to the size of the pool allocated between the matmuls
+    uint64_t threshold = max_size;
+    return hipMemPoolSetAttribute(pool, hipMemPoolAttrReleaseThreshold, &threshold);
+}
+
+hipError_t _rocsparselt_workspace_pool::allocate(size_t bytes, hipStream_t stream, void** ptr)
+{
+    if(bytes > max_size)
+        return hipErrorOutOfMemory;
+    return hipMallocFromPoolAsync(ptr, bytes, pool, stream);
+}
+
+hipError_t _rocsparselt_workspace_pool::free(void* ptr, hipStream_t stream)
+{
+    return hipFreeAsync(ptr, stream);
+}
@@ -24,6 +24,7 @@
  *
  *******************************************************************************/
 
+#include "config_cache.hpp"
 #include "definitions.h"
 #include "handle.h"
 #if BUILD_WITH_TENSILE
@@ -32,11 +33,15 @@
 #include "kernel_launcher.hpp"
 #endif
 #include "rocsparselt.h"
+#include "rocsparselt_pad.hpp"
 #include "rocsparselt_spmm_utils.hpp"
 #include "status.h"
+#include "tracing.hpp"
+#include "tuning_db.hpp"
 #include "utility.hpp"
 
 #include <hip/hip_runtime_api.h>
+#include <memory>
 
 #ifdef __cplusplus
 extern "C" {
@@ -262,7 +267,7 @@ rocsparselt_status rocsparselt_structured_descr_init(const rocsparselt_handle* h
             _matDescr->order        = order;
             _matDescr->sparsity     = sparsity;
             _matDescr->num_batches  = 1;
-            _matDescr->batch_stride = cols * ld;
+            _matDescr->batch_stride = rocsparselt_matrix_elems(_matDescr, ld);
             log_api(_handle,
                     __func__,
                     "_matDescr[out]",
@@ -406,14 +411,18 @@ rocsparselt_status rocsparselt_mat_descr_set_attribute(const rocsparselt_handle*
                 auto batch_stride = reinterpret_cast<const int64_t*>(data);
                 if(*batch_stride != 0)
                 {
-                    int64_t expected_batch_stride = _matDescr->n * _matDescr->ld;
+                    int64_t expected_batch_stride
+                        = rocsparselt_matrix_elems(_matDescr, _matDescr->ld);
                     if(*batch_stride < expected_batch_stride)
                     {
-                        hipsparselt_cerr << "The batch stride must be 0 or at least cols * ld ("
+                        hipsparselt_cerr << "The batch stride must be 0 or at least the elements "
+                                            "of a matrix ("
                                          << expected_batch_stride << "), current: " << *batch_stride
                                          << std::endl;
-                        log_error(
-                            _handle, __func__, "The batch stride must be 0 or at least cols * ld");
+                        log_error(_handle,
+                                  __func__,
+                                  "The batch stride must be 0 or at least the elements of a "
+                                  "matrix");
                         return rocsparselt_status_invalid_value;
                     }
                 }
@@ -699,11 +708,12 @@ rocsparselt_status rocsparselt_matmul_descr_init(const rocsparselt_handle*    ha
             _matmulDescr->m            = m;
             _matmulDescr->n            = n;
             _matmulDescr->k            = k;
-            switch(_matA->type)
+            // the bias of a mixed input matmul has the type of its dense matrix
+            switch(rocsparselt_matmul_input_type(_matmulDescr))
             {
             case rocsparselt_datatype_bf16_r:
             case rocsparselt_datatype_f16_r:
-                _matmulDescr->bias_type = _matA->type;
+                _matmulDescr->bias_type = rocsparselt_matmul_input_type(_matmulDescr);
                 break;
             default:
                 _matmulDescr->bias_type = rocsparselt_datatype_f32_r;
@@ -820,6 +830,8 @@ rocsparselt_status
             case rocsparselt_matmul_activation_leakyrelu:
             case rocsparselt_matmul_activation_sigmoid:
             case rocsparselt_matmul_activation_tanh:
+            case rocsparselt_matmul_activation_silu:
+            case rocsparselt_matmul_activation_clamp:
                 assign_activation(matmulAttribute);
                 break;
             case rocsparselt_matmul_activation_relu_upperbound:
@@ -837,6 +849,12 @@ rocsparselt_status
             case rocsparselt_matmul_activation_tanh_beta:
                 assign_data(&_matmulDescr->activation_tanh_beta);
                 break;
+            case rocsparselt_matmul_activation_clamp_min:
+                assign_data(&_matmulDescr->activation_clamp_min);
+                break;
+            case rocsparselt_matmul_activation_clamp_max:
+                assign_data(&_matmulDescr->activation_clamp_max);
+                break;
             case rocsparselt_matmul_activation_gelu_scaling:
                 assign_data(&_matmulDescr->activation_gelu_scaling);
                 if(status == rocsparselt_status_success)
@@ -877,6 +895,175 @@ rocsparselt_status
                 assign_data(&_matmulDescr->bias_type);
                 break;
             }
+            case rocsparselt_matmul_alpha_vector_scaling:
+                assign_data(&_matmulDescr->alpha_vector_scaling);
+                break;
+            case rocsparselt_matmul_beta_vector_scaling:
+                assign_data(&_matmulDescr->beta_vector_scaling);
+                break;
+            case rocsparselt_matmul_scale_a:
+                assign_data(&_matmulDescr->scale_a);
+                break;
+            case rocsparselt_matmul_scale_b:
+                assign_data(&_matmulDescr->scale_b);
+                break;
+            case rocsparselt_matmul_d_scale:
+                assign_data(&_matmulDescr->d_scale);
+                break;
+            case rocsparselt_matmul_d_saturate:
+                assign_data(&_matmulDescr->d_saturate);
+                break;
+            case rocsparselt_matmul_sparse_dynamic:
+                assign_data(&_matmulDescr->sparse_dynamic);
+                break;
+            case rocsparselt_matmul_amax_d_pointer:
+            {
+                if((status = validateGetAttributeDataSize<void*>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+                memcpy(&_matmulDescr->amax_d_pointer, data, dataSize);
+                status = rocsparselt_status_success;
+                break;
+            }
+            case rocsparselt_matmul_residual_pointer:
+            {
+                if((status = validateGetAttributeDataSize<void*>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+                memcpy(&_matmulDescr->residual_pointer, data, dataSize);
+                status = rocsparselt_status_success;
+                break;
+            }
+            case rocsparselt_matmul_residual_stride:
+            {
+                assign_data(&_matmulDescr->residual_stride);
+                auto    matrix_D = _matmulDescr->matrix_D;
+                int64_t size_D   = matrix_D->ld
+                                 * (matrix_D->order == rocsparselt_order_column ? matrix_D->n
+                                                                                : matrix_D->m);
+                if(_matmulDescr->residual_stride != 0 && _matmulDescr->residual_stride < size_D)
+                {
+                    hipsparselt_cerr << "The residual stride must be 0 or at least the size of the "
+                                        "output matrix (D) ("
+                                     << size_D << "), current: " << _matmulDescr->residual_stride
+                                     << std::endl;
+                    log_error(_handle,
+                              __func__,
+                              "The residual stride must be 0 or at least the size of the output "
+                              "matrix (D)");
+                    return rocsparselt_status_invalid_value;
+                }
+                break;
+            }
+            case rocsparselt_matmul_gate_pointer:
+            {
+                if((status = validateGetAttributeDataSize<void*>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+                memcpy(&_matmulDescr->gate_pointer, data, dataSize);
+                status = rocsparselt_status_success;
+                break;
+            }
+            case rocsparselt_matmul_gate_stride:
+            {
+                assign_data(&_matmulDescr->gate_stride);
+                auto    matrix_D = _matmulDescr->matrix_D;
+                int64_t size_D   = matrix_D->ld
+                                 * (matrix_D->order == rocsparselt_order_column ? matrix_D->n
+                                                                                : matrix_D->m);
+                if(_matmulDescr->gate_stride != 0 && _matmulDescr->gate_stride < size_D)
+                {
+                    hipsparselt_cerr << "The gate stride must be 0 or at least the size of the "
+                                        "output matrix (D) ("
+                                     << size_D << "), current: " << _matmulDescr->gate_stride
+                                     << std::endl;
+                    log_error(_handle,
+                              __func__,
+                              "The gate stride must be 0 or at least the size of the output "
+                              "matrix (D)");
+                    return rocsparselt_status_invalid_value;
+                }
+                break;
+            }
+            case rocsparselt_matmul_cu_count:
+            {
+                int cu_count = 0;
+                assign_data(&cu_count);
+                if(status != rocsparselt_status_success)
+                    break;
+                if(cu_count < 0 || cu_count > _handle->properties.multiProcessorCount)
+                {
+                    hipsparselt_cerr << "The CU count must be between 0 and the CUs of the device ("
+                                     << _handle->properties.multiProcessorCount
+                                     << "), current: " << cu_count << std::endl;
+                    log_error(_handle,
+                              __func__,
+                              "The CU count must be between 0 and the CUs of the device");
+                    return rocsparselt_status_invalid_value;
+                }
+                _matmulDescr->cu_count = cu_count;
+                break;
+            }
+            case rocsparselt_matmul_candidates:
+            {
+                constexpr int max_configs
+                    = sizeof(_rocsparselt_matmul_alg_selection::configs)
+                      / sizeof(_rocsparselt_matmul_config);
+                int candidates = 0;
+                assign_data(&candidates);
+                if(status != rocsparselt_status_success)
+                    break;
+                if(candidates < 0 || candidates > max_configs)
+                {
+                    hipsparselt_cerr << "The candidates must be between 0 and " << max_configs
+                                     << ", current: " << candidates << std::endl;
+                    log_error(_handle,
+                              __func__,
+                              "The candidates must be between 0 and the configs of an "
+                              "algorithm selection");
+                    return rocsparselt_status_invalid_value;
+                }
+                _matmulDescr->candidates = candidates;
+                break;
+            }
+            case rocsparselt_matmul_bias_grad_pointer:
+            {
+                if((status = validateGetAttributeDataSize<void*>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+                memcpy(&_matmulDescr->bias_grad_pointer, data, dataSize);
+                status = rocsparselt_status_success;
+                break;
+            }
+            case rocsparselt_matmul_label:
+            {
+                const char* label = reinterpret_cast<const char*>(data);
+                size_t      len   = strnlen(label, dataSize);
+                if(len >= sizeof(_matmulDescr->label))
+                {
+                    hipsparselt_cerr << "The label must be shorter than "
+                                     << sizeof(_matmulDescr->label)
+                                     << " characters, current: " << len << std::endl;
+                    log_error(_handle, __func__, "The label is too long");
+                    return rocsparselt_status_invalid_size;
+                }
+                memset(_matmulDescr->label, 0, sizeof(_matmulDescr->label));
+                memcpy(_matmulDescr->label, label, len);
+                status = rocsparselt_status_success;
+                break;
+            }
             default:
                 log_error(
                     _handle, __func__, "matmulAttribute", matmulAttribute, "is not implemented");
@@ -980,6 +1167,8 @@ rocsparselt_status
             case rocsparselt_matmul_activation_leakyrelu:
             case rocsparselt_matmul_activation_sigmoid:
             case rocsparselt_matmul_activation_tanh:
+            case rocsparselt_matmul_activation_silu:
+            case rocsparselt_matmul_activation_clamp:
                 retrive_activation(matmulAttribute);
                 break;
             case rocsparselt_matmul_activation_relu_upperbound:
@@ -997,6 +1186,12 @@ rocsparselt_status
             case rocsparselt_matmul_activation_tanh_beta:
                 retrive_data(_matmulDescr->activation_tanh_beta);
                 break;
+            case rocsparselt_matmul_activation_clamp_min:
+                retrive_data(_matmulDescr->activation_clamp_min);
+                break;
+            case rocsparselt_matmul_activation_clamp_max:
+                retrive_data(_matmulDescr->activation_clamp_max);
+                break;
 
             case rocsparselt_matmul_bias_pointer:
                 if((status = validateGetAttributeDataSize<void*>(dataSize))
@@ -1016,6 +1211,91 @@ rocsparselt_status
                 retrive_data(_matmulDescr->bias_type);
                 break;
             }
+            case rocsparselt_matmul_alpha_vector_scaling:
+                retrive_data(_matmulDescr->alpha_vector_scaling);
+                break;
+            case rocsparselt_matmul_beta_vector_scaling:
+                retrive_data(_matmulDescr->beta_vector_scaling);
+                break;
+            case rocsparselt_matmul_scale_a:
+                retrive_data(_matmulDescr->scale_a);
+                break;
+            case rocsparselt_matmul_scale_b:
+                retrive_data(_matmulDescr->scale_b);
+                break;
+            case rocsparselt_matmul_d_scale:
+                retrive_data(_matmulDescr->d_scale);
+                break;
+            case rocsparselt_matmul_d_saturate:
+                retrive_data(_matmulDescr->d_saturate);
+                break;
+            case rocsparselt_matmul_sparse_dynamic:
+                retrive_data(_matmulDescr->sparse_dynamic);
+                break;
+            case rocsparselt_matmul_amax_d_pointer:
+                if((status = validateGetAttributeDataSize<void*>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+                memcpy(data, &_matmulDescr->amax_d_pointer, dataSize);
+                status = rocsparselt_status_success;
+                break;
+            case rocsparselt_matmul_residual_pointer:
+                if((status = validateGetAttributeDataSize<void*>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+                memcpy(data, &_matmulDescr->residual_pointer, dataSize);
+                status = rocsparselt_status_success;
+                break;
+            case rocsparselt_matmul_residual_stride:
+                retrive_data(_matmulDescr->residual_stride);
+                break;
+            case rocsparselt_matmul_gate_pointer:
+                if((status = validateGetAttributeDataSize<void*>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+                memcpy(data, &_matmulDescr->gate_pointer, dataSize);
+                status = rocsparselt_status_success;
+                break;
+            case rocsparselt_matmul_gate_stride:
+                retrive_data(_matmulDescr->gate_stride);
+                break;
+            case rocsparselt_matmul_cu_count:
+                retrive_data(_matmulDescr->cu_count);
+                break;
+            case rocsparselt_matmul_candidates:
+                retrive_data(_matmulDescr->candidates);
+                break;
+            case rocsparselt_matmul_bias_grad_pointer:
+                if((status = validateGetAttributeDataSize<void*>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+                memcpy(data, &_matmulDescr->bias_grad_pointer, dataSize);
+                status = rocsparselt_status_success;
+                break;
+            case rocsparselt_matmul_label:
+            {
+                size_t len = strlen(_matmulDescr->label);
+                if(dataSize <= len)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return rocsparselt_status_invalid_size;
+                }
+                memcpy(data, _matmulDescr->label, len + 1);
+                status = rocsparselt_status_success;
+                break;
+            }
             default:
                 log_error(
                     _handle, __func__, "matmulAttribute", matmulAttribute, "is not implemented");
@@ -1043,6 +1323,286 @@ rocsparselt_status
     }
 }
 
+/********************************************************************************
+ * \brief find the configs of the backend which solve the problem of matmulDescr.
+ *******************************************************************************/
+static rocsparselt_status find_matmul_configs(const _rocsparselt_handle*       handle,
+                                              const _rocsparselt_matmul_descr* matmulDescr,
+                                              _rocsparselt_matmul_config*      configs,
+                                              int*                             config_max_id)
+{
+    // a mixed input matmul runs the kernels of the type of its dense matrix
+    auto in_type      = rocsparselt_matmul_input_type(matmulDescr);
+    auto out_type     = matmulDescr->matrix_D->type;
+    auto compute_type = matmulDescr->compute_type;
+
+    rocsparselt_status status = rocsparselt_status_success;
+#if BUILD_WITH_TENSILE
+    rocsparselt_trace_span trace("findTopConfigs");
+
+    // the top 10 configs by default, the ranking of the heuristic picks them
+    const int requestConfigs = matmulDescr->candidates > 0 ? matmulDescr->candidates : 10;
+
+    if(in_type == rocsparselt_datatype_f16_r && out_type == rocsparselt_datatype_f16_r
+       && compute_type == rocsparselt_compute_f32)
+    {
+        status = findTopConfigs<__half, __half, float>(
+            matmulDescr, configs, config_max_id, requestConfigs);
+    }
+    else if(in_type == rocsparselt_datatype_bf16_r && out_type == rocsparselt_datatype_bf16_r
+            && compute_type == rocsparselt_compute_f32)
+    {
+        status = findTopConfigs<hip_bfloat16, hip_bfloat16, float>(
+            matmulDescr, configs, config_max_id, requestConfigs);
+    }
+    else if(in_type == rocsparselt_datatype_i8_r && out_type == rocsparselt_datatype_i8_r
+            && compute_type == rocsparselt_compute_i32)
+    {
+        status = findTopConfigs<int8_t, int8_t, float>(
+            matmulDescr, configs, config_max_id, requestConfigs);
+    }
+    else if(in_type == rocsparselt_datatype_i8_r && out_type == rocsparselt_datatype_f16_r
+            && compute_type == rocsparselt_compute_i32)
+    {
+        status = findTopConfigs<int8_t, __half, float>(
+            matmulDescr, configs, config_max_id, requestConfigs);
+    }
+    else if(in_type == rocsparselt_datatype_i8_r && out_type == rocsparselt_datatype_i32_r
+            && compute_type == rocsparselt_compute_i32)
+    {
+        status = findTopConfigs<int8_t, int32_t, float>(
+            matmulDescr, configs, config_max_id, requestConfigs);
+    }
+    else if(in_type == rocsparselt_datatype_f8_r && out_type == rocsparselt_datatype_f16_r
+            && compute_type == rocsparselt_compute_f32)
+    {
+        status = findTopConfigs<__hip_fp8_e4m3_fnuz, __half, float>(
+            matmulDescr, configs, config_max_id, requestConfigs);
+    }
+    else if(in_type == rocsparselt_datatype_f8_r && out_type == rocsparselt_datatype_bf16_r
+            && compute_type == rocsparselt_compute_f32)
+    {
+        status = findTopConfigs<__hip_fp8_e4m3_fnuz, hip_bfloat16, float>(
+            matmulDescr, configs, config_max_id, requestConfigs);
+    }
+    else if(in_type == rocsparselt_datatype_f8_r && out_type == rocsparselt_datatype_f32_r
+            && compute_type == rocsparselt_compute_f32)
+    {
+        status = findTopConfigs<__hip_fp8_e4m3_fnuz, float, float>(
+            matmulDescr, configs, config_max_id, requestConfigs);
+    }
+    else if(in_type == rocsparselt_datatype_bf8_r && out_type == rocsparselt_datatype_f16_r
+            && compute_type == rocsparselt_compute_f32)
+    {
+        status = findTopConfigs<__hip_fp8_e5m2_fnuz, __half, float>(
+            matmulDescr, configs, config_max_id, requestConfigs);
+    }
+    else if(in_type == rocsparselt_datatype_bf8_r && out_type == rocsparselt_datatype_bf16_r
+            && compute_type == rocsparselt_compute_f32)
+    {
+        status = findTopConfigs<__hip_fp8_e5m2_fnuz, hip_bfloat16, float>(
+            matmulDescr, configs, config_max_id, requestConfigs);
+    }
+    else if(in_type == rocsparselt_datatype_bf8_r && out_type == rocsparselt_datatype_f32_r
+            && compute_type == rocsparselt_compute_f32)
+    {
+        status = findTopConfigs<__hip_fp8_e5m2_fnuz, float, float>(
+            matmulDescr, configs, config_max_id, requestConfigs);
+    }
+#else
+    rocsparselt_trace_span trace("initSolutions");
+
+    const size_t m           = matmulDescr->m;
+    const size_t n           = matmulDescr->n;
+    const size_t k           = matmulDescr->k;
+    const size_t batch_count = matmulDescr->matrix_D->num_batches;
+
+    if(in_type == rocsparselt_datatype_f16_r && out_type == rocsparselt_datatype_f16_r
+       && compute_type == rocsparselt_compute_f32)
+        initSolutions<__half, __half, float>(handle,
+                                             matmulDescr->op_A,
+                                             matmulDescr->op_B,
+                                             matmulDescr->is_sparse_a,
+                                             m,
+                                             n,
+                                             k,
+                                             batch_count,
+                                             matmulDescr->effective_cu_count(),
+                                             matmulDescr->candidates,
+                                             configs,
+                                             config_max_id);
+    else if(in_type == rocsparselt_datatype_bf16_r && out_type == rocsparselt_datatype_bf16_r
+            && compute_type == rocsparselt_compute_f32)
+        initSolutions<hip_bfloat16, hip_bfloat16, float>(handle,
+                                                         matmulDescr->op_A,
+                                                         matmulDescr->op_B,
+                                                         matmulDescr->is_sparse_a,
+                                                         m,
+                                                         n,
+                                                         k,
+                                                         batch_count,
+                                                         matmulDescr->effective_cu_count(),
+                                                         matmulDescr->candidates,
+                                                         configs,
+                                                         config_max_id);
+    else if(in_type == rocsparselt_datatype_i8_r && out_type == rocsparselt_datatype_i8_r
+            && compute_type == rocsparselt_compute_i32)
+        initSolutions<int8_t, int8_t, float>(handle,
+                                             matmulDescr->op_A,
+                                             matmulDescr->op_B,
+                                             matmulDescr->is_sparse_a,
+                                             m,
+                                             n,
+                                             k,
+                                             batch_count,
+                                             matmulDescr->effective_cu_count(),
+                                             matmulDescr->candidates,
+                                             configs,
+                                             config_max_id);
+    else if(in_type == rocsparselt_datatype_i8_r && out_type == rocsparselt_datatype_i32_r
+            && compute_type == rocsparselt_compute_i32)
+        initSolutions<int8_t, int32_t, float>(handle,
+                                              matmulDescr->op_A,
+                                              matmulDescr->op_B,
+                                              matmulDescr->is_sparse_a,
+                                              m,
+                                              n,
+                                              k,
+                                              batch_count,
+                                              matmulDescr->effective_cu_count(),
+                                              matmulDescr->candidates,
+                                              configs,
+                                              config_max_id);
+    else if(in_type == rocsparselt_datatype_f8_r && out_type == rocsparselt_datatype_f16_r
+            && compute_type == rocsparselt_compute_f32)
+        initSolutions<__hip_fp8_e4m3_fnuz, __half, float>(handle,
+                                                          matmulDescr->op_A,
+                                                          matmulDescr->op_B,
+                                                          matmulDescr->is_sparse_a,
+                                                          m,
+                                                          n,
+                                                          k,
+                                                          batch_count,
+                                                          matmulDescr->effective_cu_count(),
+                                                          matmulDescr->candidates,
+                                                          configs,
+                                                          config_max_id);
+    else if(in_type == rocsparselt_datatype_f8_r && out_type == rocsparselt_datatype_bf16_r
+            && compute_type == rocsparselt_compute_f32)
+        initSolutions<__hip_fp8_e4m3_fnuz, hip_bfloat16, float>(handle,
+                                                                matmulDescr->op_A,
+                                                                matmulDescr->op_B,
+                                                                matmulDescr->is_sparse_a,
+                                                                m,
+                                                                n,
+                                                                k,
+                                                                batch_count,
+                                                                matmulDescr->effective_cu_count(),
+                                                                matmulDescr->candidates,
+                                                                configs,
+                                                                config_max_id);
+    else if(in_type == rocsparselt_datatype_f8_r && out_type == rocsparselt_datatype_f32_r
+            && compute_type == rocsparselt_compute_f32)
+        initSolutions<__hip_fp8_e4m3_fnuz, float, float>(handle,
+                                                         matmulDescr->op_A,
+                                                         matmulDescr->op_B,
+                                                         matmulDescr->is_sparse_a,
+                                                         m,
+                                                         n,
+                                                         k,
+                                                         batch_count,
+                                                         matmulDescr->effective_cu_count(),
+                                                         matmulDescr->candidates,
+                                                         configs,
+                                                         config_max_id);
+    else if(in_type == rocsparselt_datatype_bf8_r && out_type == rocsparselt_datatype_f16_r
+            && compute_type == rocsparselt_compute_f32)
+        initSolutions<__hip_fp8_e5m2_fnuz, __half, float>(handle,
+                                                          matmulDescr->op_A,
+                                                          matmulDescr->op_B,
+                                                          matmulDescr->is_sparse_a,
+                                                          m,
+                                                          n,
+                                                          k,
+                                                          batch_count,
+                                                          matmulDescr->effective_cu_count(),
+                                                          matmulDescr->candidates,
+                                                          configs,
+                                                          config_max_id);
+    else if(in_type == rocsparselt_datatype_bf8_r && out_type == rocsparselt_datatype_bf16_r
+            && compute_type == rocsparselt_compute_f32)
+        initSolutions<__hip_fp8_e5m2_fnuz, hip_bfloat16, float>(handle,
+                                                                matmulDescr->op_A,
+                                                                matmulDescr->op_B,
+                                                                matmulDescr->is_sparse_a,
+                                                                m,
+                                                                n,
+                                                                k,
+                                                                batch_count,
+                                                                matmulDescr->effective_cu_count(),
+                                                                matmulDescr->candidates,
+                                                                configs,
+                                                                config_max_id);
+    else if(in_type == rocsparselt_datatype_bf8_r && out_type == rocsparselt_datatype_f32_r
+            && compute_type == rocsparselt_compute_f32)
+        initSolutions<__hip_fp8_e5m2_fnuz, float, float>(handle,
+                                                         matmulDescr->op_A,
+                                                         matmulDescr->op_B,
+                                                         matmulDescr->is_sparse_a,
+                                                         m,
+                                                         n,
+                                                         k,
+                                                         batch_count,
+                                                         matmulDescr->effective_cu_count(),
+                                                         matmulDescr->candidates,
+                                                         configs,
+                                                         config_max_id);
+#endif
+    return status;
+}
+
+/********************************************************************************
+ * \brief restrict the configs of algSelection to the ones which match its Split-K
+ * factor and mode and its Stream-K schedule. The config id moves to the first
+ * matching config when the current one is left out.
+ *******************************************************************************/
+static bool restrict_split_k_configs(_rocsparselt_matmul_alg_selection* algSelection,
+                                     int                                split_k,
+                                     int                                split_k_mode,
+                                     int                                stream_k)
+{
+    auto matches = [&](const _rocsparselt_matmul_config& config) {
+        if(split_k != 0 && config.split_k != split_k)
+            return false;
+        if(stream_k >= 0 && (config.stream_k_index >= 0) != (stream_k == 1))
+            return false;
+        // the reduce kernel of a two-kernel Split-K config runs the epilogue of D
+        if(algSelection->reduce_epilogue
+           && (config.split_k == 1 || config.split_k_mode != rocsparselt_split_k_mode_two_kernels
+               || config.stream_k_index >= 0))
+            return false;
+        // the mode only tells apart the configs which split K
+        return split_k_mode < 0 || config.split_k == 1 || config.split_k_mode == split_k_mode;
+    };
+
+    int first = -1;
+    for(int i = 0; i < algSelection->config_max_id && first < 0; i++)
+        if(matches(algSelection->configs[i]))
+            first = i;
+    if(first < 0)
+        return false;
+
+    for(int i = 0; i < algSelection->config_max_id; i++)
+        algSelection->configs[i].excluded = !matches(algSelection->configs[i]);
+    if(algSelection->configs[algSelection->config_id].excluded)
+        algSelection->config_id = first;
+
+    algSelection->split_k      = split_k;
+    algSelection->split_k_mode = split_k_mode;
+    algSelection->stream_k     = stream_k;
+    return true;
+}
+
 /********************************************************************************
  * \brief
  *******************************************************************************/
@@ -1091,70 +1651,117 @@ rocsparselt_status
 
             auto _algSelection = reinterpret_cast<_rocsparselt_matmul_alg_selection*>(algSelection);
 
-            auto in_type      = _matmulDescr->matrix_A->type;
-            auto out_type     = _matmulDescr->matrix_D->type;
-            auto compute_type = _matmulDescr->compute_type;
+            // the configs of a matmul of unsupported sizes are the ones of its padded problem
+            std::unique_ptr<_rocsparselt_matmul_descr> padded;
+            if(_handle->pad_shapes && rocsparselt_needs_padding(_matmulDescr))
+            {
+                auto status = rocsparselt_check_paddable(_handle, _matmulDescr, __func__);
+                if(status != rocsparselt_status_success)
+                    return status;
+                padded.reset(rocsparselt_padded_descr(_matmulDescr));
+                _matmulDescr = padded.get();
+                log_info(_handle,
+                         __func__,
+                         "padded m",
+                         _matmulDescr->m,
+                         "n",
+                         _matmulDescr->n,
+                         "k",
+                         _matmulDescr->k);
+            }
 
             int                               config_max_id = 0;
             _rocsparselt_matmul_alg_selection tmpAlgSelection(_handle);
 
-#if BUILD_WITH_TENSILE
-            constexpr int requestConfigs = 10; // find top 10 configs.
-
-            rocsparselt_status status = rocsparselt_status_success;
-
-            if(in_type == rocsparselt_datatype_f16_r && out_type == rocsparselt_datatype_f16_r
-               && compute_type == rocsparselt_compute_f32)
+            // plans of identical problems share the configs found by the first one
+            const std::string signature      = rocsparselt_tuning_signature(_handle, _matmulDescr);
+            int               best_config_id = -1;
+            if(!_handle->smfmac)
+            {
+                // the dense path multiplies the compressed matrix with FMAs, the GEMM epilogue
+                // of alpha and beta is all it has
+                if(_matmulDescr->activation != rocsparselt_matmul_activation_none
+                   || _matmulDescr->bias_pointer != nullptr || _matmulDescr->alpha_vector_scaling
+                   || _matmulDescr->needs_reduce_epilogue())
+                {
+                    hipsparselt_cerr << "The device has no SMFMAC instructions, its matmul has "
+                                        "no activation, bias, vector scaling nor epilogue of D"
+                                     << std::endl;
+                    log_error(_handle, __func__, "no epilogue without SMFMAC instructions");
+                    return rocsparselt_status_not_implemented;
+                }
+                tmpAlgSelection.dense_only     = 1;
+                tmpAlgSelection.dense_selected = 1;
+                log_info(_handle, __func__, "no SMFMAC instructions, dense path only");
+            }
+            else if(!_handle->config_cache->find(
+                        signature, &(tmpAlgSelection.configs[0]), &config_max_id, &best_config_id))
+            {
+                auto status = find_matmul_configs(
+                    _handle, _matmulDescr, &(tmpAlgSelection.configs[0]), &config_max_id);
+                if(status != rocsparselt_status_success)
+                    return status;
+                if(config_max_id)
+                    _handle->config_cache->insert(
+                        signature, &(tmpAlgSelection.configs[0]), config_max_id);
+            }
+            if(!config_max_id && !tmpAlgSelection.dense_only)
             {
-                status = findTopConfigs<__half, __half, float>(
-                    _matmulDescr, &(tmpAlgSelection.configs[0]), &config_max_id, requestConfigs);
+                hipsparselt_cerr << "There are no solutions for this problem size" << std::endl;
+                log_error(_handle, __func__, "There are no solutions for this problem size");
+                return rocsparselt_status_not_implemented;
             }
-            else if(in_type == rocsparselt_datatype_bf16_r
-                    && out_type == rocsparselt_datatype_bf16_r
-                    && compute_type == rocsparselt_compute_f32)
+
+            // start from the config a previous search selected for the same problem
+            int tuned_index = -1;
+            if(best_config_id >= 0 && best_config_id < config_max_id)
             {
-                status = findTopConfigs<hip_bfloat16, hip_bfloat16, float>(
-                    _matmulDescr, &(tmpAlgSelection.configs[0]), &config_max_id, requestConfigs);
+                tmpAlgSelection.config_id = best_config_id;
+                log_info(_handle, __func__, "cached config_id", best_config_id);
             }
-            else if(in_type == rocsparselt_datatype_i8_r && out_type == rocsparselt_datatype_i8_r
-                    && compute_type == rocsparselt_compute_i32)
+            else if(rocsparselt_tuning_db_find(signature, &tuned_index))
             {
-                status = findTopConfigs<int8_t, int8_t, float>(
-                    _matmulDescr, &(tmpAlgSelection.configs[0]), &config_max_id, requestConfigs);
+                for(int i = 0; i < config_max_id; i++)
+                    if(tmpAlgSelection.configs[i].index == tuned_index)
+                    {
+                        tmpAlgSelection.config_id = i;
+                        log_info(_handle, __func__, "tuned config_id", i);
+                        break;
+                    }
             }
-            else if(in_type == rocsparselt_datatype_i8_r && out_type == rocsparselt_datatype_f16_r
-                    && compute_type == rocsparselt_compute_i32)
+
+            if(_matmulDescr->beta_vector_scaling && !_matmulDescr->alpha_vector_scaling)
             {
-                status = findTopConfigs<int8_t, __half, float>(
-                    _matmulDescr, &(tmpAlgSelection.configs[0]), &config_max_id, requestConfigs);
+                hipsparselt_cerr << "The beta vector scaling needs the alpha vector scaling"
+                                 << std::endl;
+                log_error(_handle, __func__, "beta vector scaling needs alpha vector scaling");
+                return rocsparselt_status_invalid_value;
             }
-            if(status != rocsparselt_status_success)
-                return status;
+            if(_matmulDescr->needs_reduce_epilogue() && !tmpAlgSelection.dense_only)
+            {
+#if BUILD_WITH_TENSILE
+                bool found = false;
 #else
-            if(in_type == rocsparselt_datatype_f16_r && out_type == rocsparselt_datatype_f16_r
-               && compute_type == rocsparselt_compute_f32)
-                initSolutions<__half, __half, float>(
-                    _handle, _matmulDescr->op_A, _matmulDescr->op_B, &config_max_id);
-            else if(in_type == rocsparselt_datatype_bf16_r
-                    && out_type == rocsparselt_datatype_bf16_r
-                    && compute_type == rocsparselt_compute_f32)
-                initSolutions<hip_bfloat16, hip_bfloat16, float>(
-                    _handle, _matmulDescr->op_A, _matmulDescr->op_B, &config_max_id);
-            else if(in_type == rocsparselt_datatype_i8_r && out_type == rocsparselt_datatype_i8_r
-                    && compute_type == rocsparselt_compute_i32)
-                initSolutions<int8_t, int8_t, float>(
-                    _handle, _matmulDescr->op_A, _matmulDescr->op_B, &config_max_id);
-            for(int i = 0; i < config_max_id; i++)
-            {
-                configs[i].max_workspace_bytes = 0;
-            }
+                tmpAlgSelection.config_max_id   = config_max_id;
+                tmpAlgSelection.reduce_epilogue = true;
+                bool found = restrict_split_k_configs(&tmpAlgSelection, 0, -1, -1);
 #endif
-            if(!config_max_id)
-            {
-                hipsparselt_cerr << "There are no solutions for this problem size" << std::endl;
-                log_error(_handle, __func__, "There are no solutions for this problem size");
-                return rocsparselt_status_not_implemented;
+                if(!found)
+                {
+                    hipsparselt_cerr << "No config of this problem supports the vector scaling, "
+                                        "the scale and saturation of D, amax(D), the gate, the "
+                                        "residual, the bias gradient, the SiLU and clamp "
+                                        "activations or an int32 D"
+                                     << std::endl;
+                    log_error(_handle, __func__, "no config supports the epilogue of D");
+                    return rocsparselt_status_not_implemented;
+                }
+                // the partial sums of the bias gradient follow the buffers of the splits
+                for(int i = 0; i < config_max_id; i++)
+                    tmpAlgSelection.configs[i].max_workspace_bytes
+                        += _matmulDescr->bias_grad_workspace_bytes();
             }
+
             memcpy(_algSelection, &tmpAlgSelection, sizeof(_rocsparselt_matmul_alg_selection));
             _algSelection->alg           = alg;
             _algSelection->config_max_id = config_max_id;
@@ -1243,6 +1850,8 @@ rocsparselt_status
                 }
 
                 _algSelection->config_id = *config_id;
+                // a config chosen by the caller runs, not the dense path of the last search
+                __atomic_store_n(&_algSelection->dense_selected, 0, __ATOMIC_RELEASE);
                 break;
             }
             case rocsparselt_matmul_alg_config_max_id:
@@ -1252,6 +1861,20 @@ rocsparselt_status
                 log_error(_handle, __func__, "config_max_id is only for query");
                 return rocsparselt_status_invalid_value;
             }
+            case rocsparselt_matmul_search_results:
+            {
+                hipsparselt_cerr << "rocsparselt_matmul_search_results is only for query."
+                                 << std::endl;
+                log_error(_handle, __func__, "search_results is only for query");
+                return rocsparselt_status_invalid_value;
+            }
+            case rocsparselt_matmul_config_scores:
+            {
+                hipsparselt_cerr << "rocsparselt_matmul_config_scores is only for query."
+                                 << std::endl;
+                log_error(_handle, __func__, "config_scores is only for query");
+                return rocsparselt_status_invalid_value;
+            }
             case rocsparselt_matmul_search_iterations:
             {
                 if((status = validateSetAttributeDataSize<int>(dataSize))
@@ -1273,32 +1896,178 @@ rocsparselt_status
                 _algSelection->search_iterations = *search_iterations;
                 break;
             }
-            default:
-                return rocsparselt_status_not_implemented;
-            }
-            log_api(_handle,
-                    __func__,
-                    "algSelection[out]",
-                    algSelection,
-                    "attribute[in]",
-                    attribute,
-                    "data[in]",
-                    data,
-                    "dataSize[in]",
-                    dataSize);
-        }
-        catch(const rocsparselt_status& status)
-        {
-            log_info(_handle, __func__, "status", status);
-            return status;
-        }
-        return rocsparselt_status_success;
-    }
-}
+            case rocsparselt_matmul_search_flush_cache:
+            {
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
 
-/********************************************************************************
- * \brief
- *******************************************************************************/
+                const int* flush_cache = reinterpret_cast<const int*>(data);
+                if(*flush_cache != 0 && *flush_cache != 1)
+                {
+                    hipsparselt_cerr << "The search flush cache must be 0 or 1, current: "
+                                     << *flush_cache << std::endl;
+                    log_error(_handle, __func__, "search flush cache must be 0 or 1");
+                    return rocsparselt_status_invalid_value;
+                }
+                _algSelection->search_flush_cache = *flush_cache;
+                break;
+            }
+            case rocsparselt_matmul_search_dense:
+            {
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+
+                const int* search_dense = reinterpret_cast<const int*>(data);
+                if(*search_dense != 0 && *search_dense != 1)
+                {
+                    hipsparselt_cerr << "The search dense must be 0 or 1, current: "
+                                     << *search_dense << std::endl;
+                    log_error(_handle, __func__, "search dense must be 0 or 1");
+                    return rocsparselt_status_invalid_value;
+                }
+                _algSelection->search_dense = *search_dense;
+                if(*search_dense == 0 && !_algSelection->dense_only)
+                    __atomic_store_n(&_algSelection->dense_selected, 0, __ATOMIC_RELEASE);
+                break;
+            }
+            case rocsparselt_matmul_dense_selected:
+            {
+                hipsparselt_cerr << "rocsparselt_matmul_dense_selected is only for query."
+                                 << std::endl;
+                log_error(_handle, __func__, "dense_selected is only for query");
+                return rocsparselt_status_invalid_value;
+            }
+            case rocsparselt_matmul_split_k:
+            {
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+
+                const int* split_k = reinterpret_cast<const int*>(data);
+                if(*split_k < 1)
+                {
+                    hipsparselt_cerr
+                        << "The Split-K factor must be greater or equal to 1, current: "
+                        << *split_k << std::endl;
+                    log_error(_handle, __func__, "split k must >= 1");
+                    return rocsparselt_status_invalid_value;
+                }
+                if(!restrict_split_k_configs(_algSelection,
+                                             *split_k,
+                                             _algSelection->split_k_mode,
+                                             _algSelection->stream_k))
+                {
+                    hipsparselt_cerr << "No config uses the Split-K factor " << *split_k
+                                     << " for this problem" << std::endl;
+                    log_error(_handle, __func__, "no config uses the split k factor");
+                    return rocsparselt_status_not_implemented;
+                }
+                break;
+            }
+            case rocsparselt_matmul_split_k_mode:
+            {
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+
+                const int* split_k_mode = reinterpret_cast<const int*>(data);
+                if(*split_k_mode != rocsparselt_splik_k_mode_one_kernel
+                   && *split_k_mode != rocsparselt_split_k_mode_two_kernels)
+                {
+                    hipsparselt_cerr << "The Split-K mode must be 0 or 1, current: "
+                                     << *split_k_mode << std::endl;
+                    log_error(_handle, __func__, "split k mode must be 0 or 1");
+                    return rocsparselt_status_invalid_value;
+                }
+                if(!restrict_split_k_configs(_algSelection,
+                                             _algSelection->split_k,
+                                             *split_k_mode,
+                                             _algSelection->stream_k))
+                {
+                    hipsparselt_cerr << "No config uses the Split-K mode " << *split_k_mode
+                                     << " for this problem" << std::endl;
+                    log_error(_handle, __func__, "no config uses the split k mode");
+                    return rocsparselt_status_not_implemented;
+                }
+                break;
+            }
+            case rocsparselt_matmul_split_k_buffers:
+            {
+                hipsparselt_cerr << "The Split-K buffers are set by the kernel of a config, "
+                                    "rocsparselt_matmul_split_k_buffers is only for query."
+                                 << std::endl;
+                log_error(_handle, __func__, "split k buffers is only for query");
+                return rocsparselt_status_not_implemented;
+            }
+            case rocsparselt_matmul_stream_k:
+            {
+                if((status = validateSetAttributeDataSize<int>(dataSize))
+                   != rocsparselt_status_success)
+                {
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return status;
+                }
+
+                const int* stream_k = reinterpret_cast<const int*>(data);
+                if(*stream_k != 0 && *stream_k != 1)
+                {
+                    hipsparselt_cerr << "The Stream-K schedule must be 0 or 1, current: "
+                                     << *stream_k << std::endl;
+                    log_error(_handle, __func__, "stream k must be 0 or 1");
+                    return rocsparselt_status_invalid_value;
+                }
+                if(!restrict_split_k_configs(_algSelection,
+                                             _algSelection->split_k,
+                                             _algSelection->split_k_mode,
+                                             *stream_k))
+                {
+                    hipsparselt_cerr << "No config uses the Stream-K schedule " << *stream_k
+                                     << " for this problem" << std::endl;
+                    log_error(_handle, __func__, "no config uses the stream k schedule");
+                    return rocsparselt_status_not_implemented;
+                }
+                break;
+            }
+            default:
+                return rocsparselt_status_not_implemented;
+            }
+            log_api(_handle,
+                    __func__,
+                    "algSelection[out]",
+                    algSelection,
+                    "attribute[in]",
+                    attribute,
+                    "data[in]",
+                    data,
+                    "dataSize[in]",
+                    dataSize);
+        }
+        catch(const rocsparselt_status& status)
+        {
+            log_info(_handle, __func__, "status", status);
+            return status;
+        }
+        return rocsparselt_status_success;
+    }
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
 rocsparselt_status
     rocsparselt_matmul_alg_get_attribute(const rocsparselt_handle*               handle,
                                          const rocsparselt_matmul_alg_selection* algSelection,
@@ -1343,7 +2112,33 @@ rocsparselt_status
             }
 
             rocsparselt_status status;
-            if((status = validateGetAttributeDataSize<int>(dataSize)) != rocsparselt_status_success)
+            if(attribute == rocsparselt_matmul_search_results)
+            {
+                // an array of results, the caller chooses how many
+                const size_t result_size = sizeof(rocsparselt_matmul_search_result);
+                if(dataSize < result_size || dataSize % result_size != 0)
+                {
+                    hipsparselt_cerr << "The parameter number 5 (dataSize) had an illegal value: "
+                                     << dataSize << " bytes is not a multiple of " << result_size
+                                     << " bytes" << std::endl;
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return rocsparselt_status_invalid_size;
+                }
+            }
+            else if(attribute == rocsparselt_matmul_config_scores)
+            {
+                // an array of scores, the caller chooses how many
+                if(dataSize < sizeof(float) || dataSize % sizeof(float) != 0)
+                {
+                    hipsparselt_cerr << "The parameter number 5 (dataSize) had an illegal value: "
+                                     << dataSize << " bytes is not a multiple of "
+                                     << sizeof(float) << " bytes" << std::endl;
+                    log_error(_handle, __func__, "dataSize is invalid");
+                    return rocsparselt_status_invalid_size;
+                }
+            }
+            else if((status = validateGetAttributeDataSize<int>(dataSize))
+                    != rocsparselt_status_success)
             {
                 log_error(_handle, __func__, "dataSize is invalid");
                 return status;
@@ -1360,6 +2155,63 @@ rocsparselt_status
             case rocsparselt_matmul_search_iterations:
                 *reinterpret_cast<int*>(data) = _algSelection->search_iterations;
                 break;
+            case rocsparselt_matmul_search_flush_cache:
+                *reinterpret_cast<int*>(data) = _algSelection->search_flush_cache;
+                break;
+            case rocsparselt_matmul_search_dense:
+                *reinterpret_cast<int*>(data) = _algSelection->search_dense;
+                break;
+            case rocsparselt_matmul_dense_selected:
+                *reinterpret_cast<int*>(data)
+                    = __atomic_load_n(&_algSelection->dense_selected, __ATOMIC_ACQUIRE);
+                break;
+            case rocsparselt_matmul_split_k:
+            case rocsparselt_matmul_split_k_mode:
+            case rocsparselt_matmul_split_k_buffers:
+            {
+                // the values of the current config, a config which does not split K
+                // uses a factor of 1 and no buffers
+                const auto& config = _algSelection->configs[_algSelection->config_id];
+                if(attribute == rocsparselt_matmul_split_k)
+                    *reinterpret_cast<int*>(data) = config.split_k;
+                else if(attribute == rocsparselt_matmul_split_k_mode)
+                    *reinterpret_cast<int*>(data) = config.split_k_mode;
+                else
+                    *reinterpret_cast<int*>(data)
+                        = config.split_k_mode == rocsparselt_split_k_mode_two_kernels
+                                  && config.split_k > 1
+                              ? config.split_k
+                              : 0;
+                break;
+            }
+            case rocsparselt_matmul_stream_k:
+                *reinterpret_cast<int*>(data)
+                    = _algSelection->configs[_algSelection->config_id].stream_k_index >= 0;
+                break;
+            case rocsparselt_matmul_search_results:
+            {
+                auto results = reinterpret_cast<rocsparselt_matmul_search_result*>(data);
+                for(size_t i = 0; i < dataSize / sizeof(rocsparselt_matmul_search_result); i++)
+                {
+                    if(i < _rocsparselt_matmul_alg_selection::max_search_results)
+                        results[i] = _algSelection->search_results[i];
+                    else
+                    {
+                        results[i]           = {};
+                        results[i].config_id = -1;
+                    }
+                }
+                break;
+            }
+            case rocsparselt_matmul_config_scores:
+            {
+                auto scores = reinterpret_cast<float*>(data);
+                for(size_t i = 0; i < dataSize / sizeof(float); i++)
+                    scores[i] = i < size_t(_algSelection->config_max_id)
+                                    ? _algSelection->configs[i].score
+                                    : 0.0f;
+                break;
+            }
             default:
                 log_error(_handle, __func__, "attribute", attribute, "is not supported");
                 return rocsparselt_status_not_implemented;
@@ -1394,6 +2246,8 @@ rocsparselt_status
                                  const rocsparselt_matmul_alg_selection* algSelection)
 
 {
+    rocsparselt_trace_span trace("plan_init");
+
     // Check if plan is valid
     if(handle == nullptr)
     {
@@ -1454,12 +2308,35 @@ rocsparselt_status
             return rocsparselt_status_invalid_size;
         }
 
+        bool pad = _handle->pad_shapes && rocsparselt_needs_padding(_matmulDescr);
+        if(pad)
+        {
+            auto status = rocsparselt_check_paddable(_handle, _matmulDescr, __func__);
+            if(status != rocsparselt_status_success)
+                return status;
+        }
+
         auto                     _plan = reinterpret_cast<_rocsparselt_matmul_plan*>(plan);
         _rocsparselt_matmul_plan tmpPlan(_handle);
         memcpy(_plan, &tmpPlan, sizeof(_rocsparselt_matmul_plan));
 
-        _plan->matmul_descr  = new _rocsparselt_matmul_descr(*_matmulDescr);
-        _plan->alg_selection = const_cast<_rocsparselt_matmul_alg_selection*>(_algSelection);
+        // a padded plan runs the padded problem its algorithm selection has the configs of
+        if(pad)
+        {
+            _plan->matmul_descr   = rocsparselt_padded_descr(_matmulDescr);
+            _plan->unpadded_descr = new _rocsparselt_matmul_descr(*_matmulDescr);
+        }
+        else
+            _plan->matmul_descr = new _rocsparselt_matmul_descr(*_matmulDescr);
+        _plan->alg_selection  = const_cast<_rocsparselt_matmul_alg_selection*>(_algSelection);
+        _plan->solution_cache = rocsparselt_solution_cache_create();
+        _plan->stream_events  = new _rocsparselt_stream_events;
+        _plan->n_buckets      = new _rocsparselt_n_buckets;
+        _plan->search_worker  = new _rocsparselt_search_worker;
+        if(_handle->plan_stats_sample_rate > 0)
+            _plan->stats = new _rocsparselt_plan_stats(_handle->plan_stats_sample_rate);
+        if(rocsparselt_is_mixed_input(_matmulDescr))
+            _plan->widened = new _rocsparselt_widened_operand;
         log_api(_handle,
                 __func__,
                 "plan[out]",
@@ -1477,6 +2354,222 @@ rocsparselt_status
     return rocsparselt_status_success;
 }
 
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_matmul_plan_init_async(const rocsparselt_handle*         handle,
+                                       rocsparselt_matmul_plan*          plan,
+                                       rocsparselt_matmul_alg_selection* algSelection,
+                                       const rocsparselt_matmul_descr*   matmulDescr,
+                                       rocsparselt_matmul_alg            alg)
+{
+    // Check if plan is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(matmulDescr == nullptr)
+    {
+        log_error(_handle, __func__, "matmulDescr is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    else if(algSelection == nullptr)
+    {
+        log_error(_handle, __func__, "algSelection is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    else if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    auto _matmulDescr = reinterpret_cast<const _rocsparselt_matmul_descr*>(matmulDescr);
+    if(!_matmulDescr->isInit())
+    {
+        log_error(_handle, __func__, "matmulDescr did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    auto _plan = reinterpret_cast<_rocsparselt_matmul_plan*>(plan);
+    if(_plan->is_init != 0 && _plan->is_init == (uintptr_t)_handle && _plan->init_task != nullptr
+       && !_plan->init_task->done())
+    {
+        log_error(_handle, __func__, "an initialization of the plan is already running");
+        return rocsparselt_status_invalid_value;
+    }
+
+    log_api(_handle,
+            __func__,
+            "plan[out]",
+            plan,
+            "algSelection[out]",
+            algSelection,
+            "matmulDescr[in]",
+            *_matmulDescr,
+            "alg[in]",
+            alg);
+
+    try
+    {
+        // the plan waits for its task from now on, the caller may change or destroy the
+        // descriptor as soon as this returns
+        auto descr = std::make_shared<_rocsparselt_matmul_descr>(*_matmulDescr);
+        auto task  = new _rocsparselt_plan_init_task;
+
+        // a plan whose earlier initialization finished owns that task and its objects
+        if(_plan->is_init != 0 && _plan->is_init == (uintptr_t)_handle
+           && _plan->init_task != nullptr)
+            _plan->clear();
+
+        _rocsparselt_matmul_plan tmpPlan(_handle);
+        memcpy(_plan, &tmpPlan, sizeof(_rocsparselt_matmul_plan));
+        _plan->init_task = task;
+
+        _handle->init_pool->submit([=]() {
+            rocsparselt_trace_span trace("plan_init_async");
+
+            auto staged_descr = reinterpret_cast<const rocsparselt_matmul_descr*>(descr.get());
+            rocsparselt_matmul_plan staged;
+            rocsparselt_status      status = rocsparselt_status_success;
+            try
+            {
+                status = rocsparselt_matmul_alg_selection_init(
+                    handle, algSelection, staged_descr, alg);
+                if(status == rocsparselt_status_success)
+                    status = rocsparselt_matmul_plan_init(
+                        handle, &staged, staged_descr, algSelection);
+#if !BUILD_WITH_TENSILE
+                // the kernels of the selected config are loaded now rather than by the first
+                // matmul, the Tensile backend loads them with the solutions of the problem type
+                auto _staged = reinterpret_cast<_rocsparselt_matmul_plan*>(&staged);
+                auto _algSelection
+                    = reinterpret_cast<const _rocsparselt_matmul_alg_selection*>(algSelection);
+                if(status == rocsparselt_status_success && !_algSelection->dense_selected
+                   && _algSelection->config_max_id > 0)
+                {
+                    const auto& config = _algSelection->configs[_algSelection->config_id];
+                    status             = loadSolution(
+                        _handle, getSolutionName(_handle, _staged->matmul_descr, config.index));
+                    if(status == rocsparselt_status_success && config.stream_k_index >= 0)
+                        status = loadSolution(
+                            _handle,
+                            getSolutionName(_handle, _staged->matmul_descr, config.stream_k_index));
+                    if(status != rocsparselt_status_success)
+                        _staged->clear();
+                }
+#endif
+                if(status == rocsparselt_status_success)
+                    _plan->take(*reinterpret_cast<_rocsparselt_matmul_plan*>(&staged));
+            }
+            catch(const rocsparselt_status& e)
+            {
+                status = e;
+            }
+            catch(...)
+            {
+                status = rocsparselt_status_internal_error;
+            }
+            log_info(_handle, "rocsparselt_matmul_plan_init_async", "status", status);
+            task->finish(status);
+        });
+    }
+    catch(const rocsparselt_status& status)
+    {
+        log_info(_handle, __func__, "status", status);
+        return status;
+    }
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_plan_init_wait(const rocsparselt_handle*      handle,
+                                                     const rocsparselt_matmul_plan* plan)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    // a plan whose initialization failed is not initialized, its task has the status
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(_plan->is_init == 0 || _plan->is_init != (uintptr_t)_handle)
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    log_api(_handle, __func__, "plan[in]", plan);
+    if(_plan->init_task == nullptr)
+        return rocsparselt_status_success;
+    return _plan->init_task->wait();
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_plan_init_query(const rocsparselt_handle*      handle,
+                                                      const rocsparselt_matmul_plan* plan,
+                                                      int*                           ready)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    else if(ready == nullptr)
+    {
+        log_error(_handle, __func__, "ready is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(_plan->is_init == 0 || _plan->is_init != (uintptr_t)_handle)
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    *ready = _plan->init_task == nullptr || _plan->init_task->done() ? 1 : 0;
+    return rocsparselt_status_success;
+}
+
 /********************************************************************************
  * \brief destroy matrix multiplication plan descriptor
  *******************************************************************************/
@@ -1490,6 +2583,14 @@ rocsparselt_status rocsparselt_matmul_plan_destroy(const rocsparselt_matmul_plan
 
     auto _plan
         = reinterpret_cast<_rocsparselt_matmul_plan*>(const_cast<rocsparselt_matmul_plan*>(plan));
+    // a plan whose initialization in the background failed only holds the task
+    if(_plan->is_init != 0 && _plan->is_init == (uintptr_t)_plan->handle
+       && _plan->init_task != nullptr
+       && _plan->init_task->wait() != rocsparselt_status_success)
+    {
+        _plan->clear();
+        return rocsparselt_status_success;
+    }
     if(!_plan->isInit())
     {
         hipsparselt_cerr << "plan did not initialized or already destroyed" << std::endl;
@@ -1510,6 +2611,183 @@ rocsparselt_status rocsparselt_matmul_plan_destroy(const rocsparselt_matmul_plan
     return rocsparselt_status_success;
 }
 
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_get_config_cache_stats(const rocsparselt_handle*       handle,
+                                                      rocsparselt_config_cache_stats* stats)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(stats == nullptr)
+    {
+        log_error(_handle, __func__, "stats is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    _handle->config_cache->get_stats(stats);
+    log_api(_handle,
+            __func__,
+            "hits[out]",
+            stats->hits,
+            "misses[out]",
+            stats->misses,
+            "evictions[out]",
+            stats->evictions,
+            "entries[out]",
+            stats->entries);
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_get_code_object_stats(const rocsparselt_handle*      handle,
+                                                     rocsparselt_code_object_stats* stats)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(stats == nullptr)
+    {
+        log_error(_handle, __func__, "stats is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+#if BUILD_WITH_TENSILE
+    log_error(_handle, __func__, "the Tensile backend loads its code objects itself");
+    return rocsparselt_status_not_implemented;
+#else
+    getCodeObjectStats(_handle, stats);
+    log_api(_handle,
+            __func__,
+            "bytes[out]",
+            stats->bytes,
+            "modules[out]",
+            stats->modules,
+            "pinned[out]",
+            stats->pinned,
+            "evictions[out]",
+            stats->evictions);
+    return rocsparselt_status_success;
+#endif
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_plan_get_stats(const rocsparselt_handle*      handle,
+                                                     const rocsparselt_matmul_plan* plan,
+                                                     rocsparselt_matmul_plan_stats* stats)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(stats == nullptr)
+    {
+        log_error(_handle, __func__, "stats is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    auto plan_stats = _plan->stats;
+    if(plan_stats == nullptr)
+    {
+        log_error(_handle, __func__, "HIPSPARSELT_PLAN_STATS was not set for the plan");
+        return rocsparselt_status_not_implemented;
+    }
+
+    try
+    {
+        // count the timed calls which completed since the last sampled call
+        plan_stats->collect();
+
+        memset(stats, 0, sizeof(rocsparselt_matmul_plan_stats));
+        constexpr auto relaxed     = std::memory_order_relaxed;
+        stats->calls               = plan_stats->calls.load(relaxed);
+        stats->host_time_ms        = plan_stats->host_time_ns.load(relaxed) * 1e-6;
+        stats->workspace_bytes     = plan_stats->workspace_bytes.load(relaxed);
+        stats->max_workspace_bytes = plan_stats->max_workspace_bytes.load(relaxed);
+        stats->sample_rate         = plan_stats->sample_rate;
+        {
+            std::lock_guard<std::mutex> lock(plan_stats->mutex);
+            stats->timed_calls = plan_stats->timed_calls;
+            stats->gpu_time_ms = plan_stats->gpu_time_ms;
+        }
+
+        auto alg              = _plan->alg_selection;
+        stats->config_id      = __atomic_load_n(&alg->config_id, __ATOMIC_ACQUIRE);
+        stats->config_index   = alg->config_max_id == 0 ? -1 : alg->configs[stats->config_id].index;
+        stats->dense_selected = __atomic_load_n(&alg->dense_selected, __ATOMIC_ACQUIRE);
+
+        const std::string kernel_name
+            = rocsparselt_selected_kernel_name(_handle, _plan->matmul_descr, alg);
+        strncpy(stats->kernel_name, kernel_name.c_str(), sizeof(stats->kernel_name) - 1);
+
+        log_api(_handle,
+                __func__,
+                "plan[in]",
+                *_plan,
+                "calls[out]",
+                stats->calls,
+                "timed_calls[out]",
+                stats->timed_calls,
+                "gpu_time_ms[out]",
+                stats->gpu_time_ms,
+                "host_time_ms[out]",
+                stats->host_time_ms,
+                "kernel_name[out]",
+                stats->kernel_name);
+    }
+    catch(const rocsparselt_status& status)
+    {
+        return status;
+    }
+    return rocsparselt_status_success;
+}
+
 #ifdef __cplusplus
 }
 #endif
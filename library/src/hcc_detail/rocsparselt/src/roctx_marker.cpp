@@ -0,0 +1,109 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "roctx_marker.hpp"
+#include "handle.h"
+#include "utility.hpp"
+
+#if HIPSPARSELT_ENABLE_MARKER
+#include <roctracer/roctx.h>
+#endif
+
+#include <sstream>
+
+namespace
+{
+    void describe(std::ostream& os, const _rocsparselt_matmul_descr* matmul)
+    {
+        if(matmul == nullptr || !matmul->isInit())
+            return;
+        os << " m=" << matmul->m << " n=" << matmul->n << " k=" << matmul->k
+           << " opA=" << rocsparselt_transpose_letter(matmul->op_A)
+           << " opB=" << rocsparselt_transpose_letter(matmul->op_B)
+           << " A=" << rocsparselt_datatype_to_string(matmul->matrix_A->type)
+           << " B=" << rocsparselt_datatype_to_string(matmul->matrix_B->type)
+           << " D=" << rocsparselt_datatype_to_string(matmul->matrix_D->type)
+           << " compute=" << rocsparselt_compute_type_to_string(matmul->compute_type)
+           << " batches=" << matmul->matrix_D->num_batches;
+        if(matmul->label[0] != '\0')
+            os << " label=" << matmul->label;
+    }
+
+    void push_range(bool* pushed, const std::ostringstream& msg)
+    {
+#if HIPSPARSELT_ENABLE_MARKER
+        *pushed = roctxRangePushA(msg.str().c_str()) >= 0;
+#endif
+    }
+}
+
+void rocsparselt_roctx_range::push(const char* func, const rocsparselt_matmul_plan* plan)
+{
+    std::ostringstream msg;
+    msg << func;
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(_plan != nullptr && _plan->isInit())
+    {
+        describe(msg, _plan->matmul_descr);
+        msg << " config_id="
+            << __atomic_load_n(&_plan->alg_selection->config_id, __ATOMIC_ACQUIRE);
+    }
+    push_range(&pushed, msg);
+}
+
+void rocsparselt_roctx_range::push(const char* func, const rocsparselt_matmul_descr* matmul)
+{
+    std::ostringstream msg;
+    msg << func;
+    describe(msg, reinterpret_cast<const _rocsparselt_matmul_descr*>(matmul));
+    push_range(&pushed, msg);
+}
+
+void rocsparselt_roctx_range::push(const char* func, const rocsparselt_mat_descr* matrix)
+{
+    std::ostringstream msg;
+    msg << func;
+    auto _matrix = reinterpret_cast<const _rocsparselt_mat_descr*>(matrix);
+    if(_matrix != nullptr && _matrix->isInit())
+        msg << " rows=" << _matrix->m << " cols=" << _matrix->n << " ld=" << _matrix->ld
+            << " type=" << rocsparselt_datatype_to_string(_matrix->type)
+            << " order=" << rocsparselt_order_to_string(_matrix->order)
+            << " batches=" << _matrix->num_batches;
+    push_range(&pushed, msg);
+}
+
+void rocsparselt_roctx_range::push(const char* func, int groups)
+{
+    std::ostringstream msg;
+    msg << func << " groups=" << groups;
+    push_range(&pushed, msg);
+}
+
+void rocsparselt_roctx_range::pop()
+{
+#if HIPSPARSELT_ENABLE_MARKER
+    roctxRangePop();
+#endif
+}
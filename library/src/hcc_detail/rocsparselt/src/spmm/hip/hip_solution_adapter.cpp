@@ -27,12 +27,17 @@
 #include <hip/hip_ext.h>
 #include <hip/hip_runtime.h>
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <dlfcn.h>
+#include <elf.h>
+#include <thread>
 
 #include "definitions.h"
 #include "hip_solution_adapter.hpp"
 #include "hipsparselt_ostream.hpp"
+#include "tracing.hpp"
 #include "utility.hpp"
 
 #define HIP_CHECK_RETURN(expr)                \
@@ -55,12 +60,88 @@ SolutionAdapter::SolutionAdapter(std::string const& name)
 
 SolutionAdapter::~SolutionAdapter()
 {
-    for(auto& module : m_modules)
-        PRINT_IF_HIP_ERROR_2(hipModuleUnload(module.second));
+    // a module is unloaded once the kernels launched from it complete
+    auto release = [](module_entry& module) {
+        for(auto& event : module.events)
+        {
+            PRINT_IF_HIP_ERROR_2(hipEventSynchronize(event.second));
+            PRINT_IF_HIP_ERROR_2(hipEventDestroy(event.second));
+        }
+        PRINT_IF_HIP_ERROR_2(hipModuleUnload(module.module));
+    };
+    if(m_modules)
+        for(auto& module : *m_modules)
+            release(*module.second);
+    for(auto& module : m_retired)
+        release(*module);
     for(auto handle : m_lib_handles)
         dlclose(handle);
 }
 
+SolutionAdapter::ModulePin& SolutionAdapter::ModulePin::operator=(ModulePin&& rhs) noexcept
+{
+    if(this != &rhs)
+    {
+        reset();
+        m_entry = std::move(rhs.m_entry);
+    }
+    return *this;
+}
+
+SolutionAdapter::ModulePin::~ModulePin()
+{
+    reset();
+}
+
+void SolutionAdapter::ModulePin::reset()
+{
+    if(m_entry)
+        m_entry->pins.fetch_sub(1);
+    m_entry.reset();
+}
+
+template <typename Table>
+typename Table::mapped_type SolutionAdapter::find(std::shared_ptr<const Table> const& table,
+                                                  std::string const&                  name)
+{
+    auto snapshot = std::atomic_load_explicit(&table, std::memory_order_acquire);
+    if(!snapshot)
+        return {};
+    auto it = snapshot->find(name);
+    return it == snapshot->end() ? typename Table::mapped_type{} : it->second;
+}
+
+// Must be called with m_access held
+template <typename Table>
+void SolutionAdapter::publish(std::shared_ptr<const Table>& table,
+                              std::string const&            name,
+                              typename Table::mapped_type   value)
+{
+    auto snapshot     = table ? std::make_shared<Table>(*table) : std::make_shared<Table>();
+    (*snapshot)[name] = value;
+    publish<Table>(table, std::move(snapshot));
+}
+
+// Must be called with m_access held
+template <typename Table>
+void SolutionAdapter::publish(std::shared_ptr<const Table>& table,
+                              std::shared_ptr<const Table>  snapshot)
+{
+    std::atomic_store_explicit(&table, std::move(snapshot), std::memory_order_release);
+}
+
+// the bytes of a code object, the end of its section or program header table, which an ELF
+// file ends with
+static size_t code_object_bytes(const void* image)
+{
+    Elf64_Ehdr header;
+    std::memcpy(&header, image, sizeof(header));
+    if(std::memcmp(header.e_ident, ELFMAG, SELFMAG) != 0 || header.e_ident[EI_CLASS] != ELFCLASS64)
+        return 0;
+    return std::max<size_t>(header.e_shoff + size_t(header.e_shnum) * header.e_shentsize,
+                            header.e_phoff + size_t(header.e_phnum) * header.e_phentsize);
+}
+
 inline hipError_t load_lib_functions(void* handle, const char* name, void** func)
 {
 
@@ -105,6 +186,9 @@ hipError_t SolutionAdapter::loadLibrary(std::string const& path)
         if((status = load_lib_functions(handle, func.first.c_str(), &func.second)) != hipSuccess)
             return status;
     }
+    // the indexed lookup of the code objects, missing from the libraries built before it
+    funcs["get_kernel_entry"] = dlsym(handle, "get_kernel_entry");
+    dlerror();
 
     {
         std::lock_guard<std::mutex> guard(m_access);
@@ -126,11 +210,25 @@ hipError_t SolutionAdapter::loadCodeObject(const _rocsparselt_handle* handle,
                                            std::string const&         name)
 {
     //check if the module already exist.
-    if(m_modules.find(name) != m_modules.end())
+    if(isLoaded(name))
         return hipSuccess;
 
     for(auto& fucs : m_lib_functions)
     {
+        // The code object is used in place, in the read-only pages of the library
+        auto entry = fucs.find("get_kernel_entry");
+        if(entry != fucs.end() && entry->second != NULL)
+        {
+            const unsigned char* (*get_kernel_entry)(const char*, size_t*);
+            *(void**)(&get_kernel_entry) = entry->second;
+            size_t size                  = 0;
+            auto   k_bytes               = get_kernel_entry(name.c_str(), &size);
+
+            if(k_bytes != NULL && size != 0)
+                return loadCodeObject(handle, k_bytes, name, size);
+            continue;
+        }
+
         auto it = fucs.find("get_kernel_byte");
         if(it == fucs.end())
             continue;
@@ -149,59 +247,308 @@ hipError_t SolutionAdapter::loadCodeObject(const _rocsparselt_handle* handle,
 
 hipError_t SolutionAdapter::loadCodeObject(const _rocsparselt_handle* handle,
                                            const void*                image,
-                                           std::string const&         name)
+                                           std::string const&         name,
+                                           size_t                     size)
 {
-    std::lock_guard<std::mutex> guard(m_access);
-    auto                        it = m_modules.find(name);
-    if(it == m_modules.end())
+    if(isLoaded(name))
+        return hipSuccess;
+
+    // loaded outside of the lock so that several code objects can be loaded in parallel
+    rocsparselt_trace_span trace("loadCodeObject", nullptr, name.c_str());
+
+    hipModule_t module;
+    HIP_CHECK_RETURN(hipModuleLoadData(&module, image));
+
+    bool retired = false;
     {
-        hipModule_t module;
-        HIP_CHECK_RETURN(hipModuleLoadData(&module, image));
+        std::lock_guard<std::mutex> guard(m_access);
+        if(find(m_modules, name))
+        {
+            // another thread loaded it meanwhile
+            PRINT_IF_HIP_ERROR(handle, hipModuleUnload(module));
+            return hipSuccess;
+        }
         //hipsparselt_cout << "load module " << name << " success" << std::endl;
-        m_modules[name] = module;
+        auto entry      = std::make_shared<module_entry>();
+        entry->module   = module;
+        entry->bytes    = size != 0 ? size : code_object_bytes(image);
+        entry->last_use = ++m_clock;
+        m_bytes += entry->bytes;
+        publish(m_modules, name, entry);
+        evict(name);
+        retired = !m_retired.empty();
     }
+    if(retired)
+        reap(handle);
     return hipSuccess;
 }
 
-hipError_t SolutionAdapter::initKernel(std::string const& name)
+bool SolutionAdapter::isLoaded(std::string const& name)
 {
-    hipFunction_t function;
-    return getKernel(function, name);
+    // a module being evicted is still published until the eviction completes
+    auto module = find(m_modules, name);
+    return module && module->loaded.load();
 }
 
-hipError_t SolutionAdapter::getKernel(hipFunction_t& rv, std::string const& name)
+bool SolutionAdapter::pinModule(std::string const& name, ModulePin& pin)
 {
-    std::unique_lock<std::mutex> guard(m_access);
-    hipError_t                   err = hipSuccess;
-
-    auto it_k = m_kernels.find(name);
-    if(it_k != m_kernels.end())
+    auto module = find(m_modules, name);
+    if(!module)
+        return false;
+    module->pins.fetch_add(1);
+    if(!module->loaded.load())
     {
-        rv = it_k->second;
-        //hipsparselt_cout << "load function " << name << " success" << std::endl;
-        return err;
+        // evicted meanwhile
+        module->pins.fetch_sub(1);
+        return false;
     }
+    module->last_use.store(++m_clock, std::memory_order_relaxed);
+    pin.reset();
+    pin.m_entry = std::move(module);
+    return true;
+}
 
-    hipModule_t module;
-    auto        it_m = m_modules.find(name);
-    if(it_m != m_modules.end())
+void SolutionAdapter::evict(std::string const& keep)
+{
+    auto current = m_modules;
+    if(m_limit == 0 || m_bytes <= m_limit || current == nullptr)
+        return;
+
+    // the least recently used first
+    std::vector<std::pair<uint64_t, std::string const*>> unpinned;
+    for(auto& module : *current)
+        if(module.first != keep && module.second->pins.load() == 0
+           && !module.second->captured.load())
+            unpinned.emplace_back(module.second->last_use.load(), &module.first);
+    std::sort(unpinned.begin(), unpinned.end());
+
+    auto   snapshot = std::make_shared<module_table>(*current);
+    size_t retired  = m_retired.size();
+    for(auto& candidate : unpinned)
     {
-        module = it_m->second;
-        err    = hipModuleGetFunction(&rv, module, name.c_str());
-        if(err == hipSuccess)
+        if(m_bytes <= m_limit)
+            break;
+        auto it     = snapshot->find(*candidate.second);
+        auto module = it->second;
+        module->loaded.store(false);
+        if(module->pins.load() != 0 || module->captured.load())
         {
-            m_kernels[name] = rv;
-            //hipsparselt_cout << "load function " << name << " success" << std::endl;
-            return err;
+            // pinned or captured meanwhile, a capture marks the module while it is pinned
+            module->loaded.store(true);
+            continue;
         }
-        else if(err != hipErrorNotFound)
+        m_bytes -= module->bytes;
+        m_evictions++;
+        m_retired.push_back(std::move(module));
+        snapshot->erase(it);
+    }
+    if(m_retired.size() != retired)
+        publish<module_table>(m_modules, std::move(snapshot));
+}
+
+void SolutionAdapter::reap(const _rocsparselt_handle* handle)
+{
+    // the thread may query the events and unload while another thread captures a stream
+    hipStreamCaptureMode mode = hipStreamCaptureModeRelaxed;
+    PRINT_IF_HIP_ERROR(handle, hipThreadExchangeStreamCaptureMode(&mode));
+
+    std::vector<std::shared_ptr<module_entry>> completed;
+    {
+        std::lock_guard<std::mutex> guard(m_access);
+        auto                        pending = m_retired.begin();
+        for(auto& module : m_retired)
         {
+            bool done = true;
+            {
+                std::lock_guard<std::mutex> events_guard(module->events_access);
+                for(auto& event : module->events)
+                {
+                    hipError_t err = hipEventQuery(event.second);
+                    if(err != hipSuccess)
+                    {
+                        // an error keeps the module until the adapter is destroyed
+                        if(err != hipErrorNotReady)
+                            PRINT_IF_HIP_ERROR(handle, err);
+                        done = false;
+                        break;
+                    }
+                }
+            }
+            if(done)
+                completed.push_back(std::move(module));
+            else
+                *pending++ = std::move(module);
+        }
+        m_retired.erase(pending, m_retired.end());
+    }
+    for(auto& module : completed)
+    {
+        for(auto& event : module->events)
+            PRINT_IF_HIP_ERROR(handle, hipEventDestroy(event.second));
+        module->events.clear();
+        PRINT_IF_HIP_ERROR(handle, hipModuleUnload(module->module));
+    }
+
+    PRINT_IF_HIP_ERROR(handle, hipThreadExchangeStreamCaptureMode(&mode));
+}
+
+void SolutionAdapter::setCodeObjectLimit(size_t limit)
+{
+    std::lock_guard<std::mutex> guard(m_access);
+    m_limit = limit;
+}
+
+void SolutionAdapter::getCodeObjectStats(rocsparselt_code_object_stats* stats)
+{
+    std::lock_guard<std::mutex> guard(m_access);
+    auto                        current = m_modules;
+
+    stats->bytes   = m_bytes;
+    stats->modules = current ? current->size() : 0;
+    stats->pinned  = 0;
+    if(current)
+        for(auto& module : *current)
+            if(module.second->pins.load() != 0 || module.second->captured.load())
+                stats->pinned++;
+    stats->evictions = m_evictions;
+    stats->capacity  = m_limit;
+}
+
+hipError_t SolutionAdapter::loadCodeObjects(const _rocsparselt_handle*      handle,
+                                            std::vector<std::string> const& names)
+{
+    // a few threads are enough to hide the latency of hipModuleLoadData
+    const size_t num_threads = std::min<size_t>(
+        names.size(), std::min(8u, std::max(1u, std::thread::hardware_concurrency())));
+
+    std::atomic<size_t>      next{0};
+    std::vector<hipError_t>  errors(num_threads, hipSuccess);
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < num_threads; t++)
+        threads.emplace_back([&, t]() {
+            hipError_t err = hipSetDevice(handle->device);
+            if(err != hipSuccess)
+            {
+                errors[t] = err;
+                return;
+            }
+            // a code object which fails to load does not stop the others
+            for(size_t i = next++; i < names.size(); i = next++)
+            {
+                err = loadCodeObject(handle, names[i]);
+                if(err != hipSuccess && errors[t] == hipSuccess)
+                    errors[t] = err;
+            }
+        });
+    for(auto& thread : threads)
+        thread.join();
+
+    for(auto err : errors)
+        if(err != hipSuccess)
             return err;
+    return hipSuccess;
+}
+
+hipError_t SolutionAdapter::initKernel(std::string const& name)
+{
+    hipFunction_t function;
+    return getKernel(function, name);
+}
+
+hipError_t SolutionAdapter::resolveKernel(const _rocsparselt_handle* handle,
+                                          std::string const&         name,
+                                          hipFunction_t&             function,
+                                          ModulePin&                 pin)
+{
+    // the module can be evicted between its load and its pin, it is loaded again then. A pin
+    // without the lock fails on a module being evicted, a pin under the lock, which the
+    // eviction holds, only fails on a module which is not published.
+    for(int attempt = 0; !pinModule(name, pin); attempt++)
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_access);
+            if(pinModule(name, pin))
+                break;
         }
+        if(attempt == 2)
+            return hipErrorNotFound;
+        HIP_CHECK_RETURN(loadCodeObject(handle, name));
     }
+    HIP_CHECK_RETURN(getFunction(pin, name, function));
+    return hipSuccess;
+}
+
+hipError_t SolutionAdapter::getKernel(hipFunction_t& rv, std::string const& name)
+{
+    ModulePin pin;
+    if(!pinModule(name, pin))
+        return hipErrorNotFound;
+    return getFunction(pin, name, rv);
+}
+
+hipError_t SolutionAdapter::getFunction(ModulePin const&   pin,
+                                        std::string const& name,
+                                        hipFunction_t&     rv)
+{
+    // fast path, the kernel was already resolved
+    auto& module = *pin.m_entry;
+    if((rv = module.function.load(std::memory_order_acquire)) != nullptr)
+        return hipSuccess;
+
+    std::lock_guard<std::mutex> guard(m_access);
+    if((rv = module.function.load(std::memory_order_relaxed)) != nullptr)
+        return hipSuccess;
+
+    hipError_t err = hipModuleGetFunction(&rv, module.module, name.c_str());
+    if(err == hipSuccess)
+        module.function.store(rv, std::memory_order_release);
+    //hipsparselt_cout << "load function " << name << " success" << std::endl;
     return err;
 }
 
+hipError_t SolutionAdapter::recordUse(const _rocsparselt_handle* handle,
+                                      ModulePin const&           pin,
+                                      hipStream_t                stream)
+{
+    // a captured launch runs with the graph, which may outlive any pin, so the module is marked
+    // while pinned and is never evicted
+    auto&                  module  = *pin.m_entry;
+    hipStreamCaptureStatus capture = hipStreamCaptureStatusNone;
+    HIP_CHECK_RETURN(hipStreamIsCapturing(stream, &capture));
+    if(capture != hipStreamCaptureStatusNone)
+    {
+        module.captured.store(true);
+        return hipSuccess;
+    }
+
+    // one event per stream, recorded again by each launch. The event of a stream whose launches
+    // completed is taken over by a new stream, so the events do not grow with the streams used.
+    std::lock_guard<std::mutex> guard(module.events_access);
+    auto it = std::find_if(module.events.begin(), module.events.end(), [&](auto const& event) {
+        return event.first == stream;
+    });
+    if(it == module.events.end())
+    {
+        // the events are queried while another thread may capture a stream
+        hipStreamCaptureMode mode = hipStreamCaptureModeRelaxed;
+        HIP_CHECK_RETURN(hipThreadExchangeStreamCaptureMode(&mode));
+        it = std::find_if(module.events.begin(), module.events.end(), [](auto const& event) {
+            return hipEventQuery(event.second) == hipSuccess;
+        });
+        HIP_CHECK_RETURN(hipThreadExchangeStreamCaptureMode(&mode));
+        if(it != module.events.end())
+            it->first = stream;
+    }
+    if(it == module.events.end())
+    {
+        hipEvent_t event;
+        HIP_CHECK_RETURN(hipEventCreateWithFlags(&event, hipEventDisableTiming));
+        it = module.events.emplace(module.events.end(), stream, event);
+    }
+    HIP_CHECK_RETURN(hipEventRecord(it->second, stream));
+    return hipSuccess;
+}
+
 hipError_t SolutionAdapter::launchKernel(const _rocsparselt_handle* handle,
                                          KernelInvocation const&    kernel)
 {
@@ -232,10 +579,11 @@ hipError_t SolutionAdapter::launchKernel(const _rocsparselt_handle* handle,
         log_trace(handle, __func__, stream.str());
     }
 
-    HIP_CHECK_RETURN(loadCodeObject(handle, kernel.kernelName));
-
+    // pinned until the kernel is launched and its use recorded, an evicted module is unloaded
+    // once the recorded launches complete
     hipFunction_t function;
-    HIP_CHECK_RETURN(getKernel(function, kernel.kernelName));
+    ModulePin     pin;
+    HIP_CHECK_RETURN(resolveKernel(handle, kernel.kernelName, function, pin));
 
     void*  kernelArgs = const_cast<void*>(kernel.args.data());
     size_t argsSize   = kernel.args.size();
@@ -265,7 +613,45 @@ hipError_t SolutionAdapter::launchKernel(const _rocsparselt_handle* handle,
                                                   ));
     if(stopEvent != nullptr)
         HIP_CHECK_RETURN(hipEventRecord(stopEvent, stream));
-    return hipSuccess;
+    return recordUse(handle, pin, stream);
+}
+
+hipError_t SolutionAdapter::launchKernel(const _rocsparselt_handle*   handle,
+                                         BoundKernelInvocation const& kernel,
+                                         ModulePin const&             pin,
+                                         const void*                  args,
+                                         hipStream_t                  stream)
+{
+    // the bound function is pinned by the caller, otherwise it is pinned for the launch
+    hipFunction_t function = kernel.function;
+    ModulePin     local;
+    if(function == nullptr || !pin.m_entry)
+        HIP_CHECK_RETURN(resolveKernel(handle, kernel.kernelName, function, local));
+    ModulePin const& used = local.m_entry ? local : pin;
+
+    size_t argsSize = kernel.argsSize;
+
+    void* hipLaunchParams[] = {HIP_LAUNCH_PARAM_BUFFER_POINTER,
+                               const_cast<void*>(args),
+                               HIP_LAUNCH_PARAM_BUFFER_SIZE,
+                               &argsSize,
+                               HIP_LAUNCH_PARAM_END};
+
+    HIP_CHECK_RETURN(hipExtModuleLaunchKernel(function,
+                                              kernel.numWorkItems.x,
+                                              kernel.numWorkItems.y,
+                                              kernel.numWorkItems.z,
+                                              kernel.workGroupSize.x,
+                                              kernel.workGroupSize.y,
+                                              kernel.workGroupSize.z,
+                                              kernel.sharedMemBytes, // sharedMem
+                                              stream, // stream
+                                              nullptr,
+                                              (void**)&hipLaunchParams,
+                                              nullptr, // event
+                                              nullptr // event
+                                              ));
+    return recordUse(handle, used, stream);
 }
 
 hipError_t SolutionAdapter::launchKernels(const _rocsparselt_handle*           handle,
@@ -358,8 +744,9 @@ std::ostream& operator<<(std::ostream& stream, SolutionAdapter const& adapter)
 {
     stream << "hip::SolutionAdapter";
 
-    stream << " (" << adapter.name() << ", " << adapter.m_modules.size() << " total modules)"
-           << std::endl;
+    auto modules = std::atomic_load_explicit(&adapter.m_modules, std::memory_order_acquire);
+    stream << " (" << adapter.name() << ", " << (modules ? modules->size() : 0)
+           << " total modules)" << std::endl;
 
     return stream;
 }
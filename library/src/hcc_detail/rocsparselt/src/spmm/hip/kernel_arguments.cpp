@@ -110,6 +110,18 @@ bool KernelArguments::isFullyBound() const
     return true;
 }
 
+size_t KernelArguments::offset(std::string const& name) const
+{
+    if(!m_log)
+        throw std::runtime_error("Argument offsets are not recorded without logging.");
+
+    auto it = m_argRecords.find(name);
+    if(it == m_argRecords.end())
+        throw std::runtime_error("Argument " + name + " not found in record.");
+
+    return std::get<ArgOffset>(it->second);
+}
+
 void const* KernelArguments::data() const
 {
     if(!isFullyBound())
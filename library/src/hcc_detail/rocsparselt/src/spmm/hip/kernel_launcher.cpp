@@ -25,17 +25,25 @@
  *******************************************************************************/
 #include "kernel_launcher.hpp"
 #include "activation.hpp"
+#include "config_heuristic.hpp"
 #include "definitions.h"
 #include "handle.h"
 #include "hip_solution_adapter.hpp"
 #include "hipsparselt_ostream.hpp"
 #include "rocsparselt-types.h"
 #include "rocsparselt.h"
+#include "rocsparselt_spmm_utils.hpp"
+#include "search_tuner.hpp"
 #include "status.h"
+#include "tracing.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
+#include <array>
 #include <atomic>
+#include <cfloat>
 #include <complex>
+#include <cstring>
 #include <exception>
 #include <iomanip>
 #include <memory>
@@ -68,9 +76,10 @@ namespace
     }
 #endif
 
-    size_t totalAllcoatedElement(std::vector<size_t>& sizes,
-                                 std::vector<size_t>& strides,
-                                 size_t               offset)
+    // Sizes and strides of the a, b, c, d tensors: (free/bound, free/bound, batch)
+    using TensorDims = std::array<size_t, 3>;
+
+    size_t totalAllcoatedElement(const TensorDims& sizes, const TensorDims& strides, size_t offset)
     {
 
         size_t totalAllocatedElements = 1;
@@ -80,9 +89,10 @@ namespace
         return totalAllocatedElements;
     }
 
-    size_t totalAllcoatedElementNonBatch(std::vector<size_t>& sizes,
-                                         std::vector<size_t>& strides,
-                                         BatchIndices&        batchIndex)
+    template <size_t NumBatch>
+    size_t totalAllcoatedElementNonBatch(const TensorDims&                       sizes,
+                                         const TensorDims&                       strides,
+                                         const std::array<BatchIndex, NumBatch>& batchIndex)
     {
         size_t totalAllocatedElementsNonBatch = 1;
         for(int idx = 0; idx < sizes.size(); idx++)
@@ -116,10 +126,11 @@ namespace
         ki.numWorkGroups.x = 1;
         ki.numWorkGroups.y = 1;
 
-        // Indices for contraction problem
-        FreeIndices  freeIndex(2);
-        BoundIndices boundIndex(1);
-        BatchIndices batchIndex{{2, 2, 2, 2}};
+        // Indices for contraction problem, a GEMM always has two free indices,
+        // one bound index and one batch index, so fixed-size arrays are used
+        std::array<FreeIndex, 2>  freeIndex{};
+        std::array<BoundIndex, 1> boundIndex;
+        std::array<BatchIndex, 1> batchIndex{{{2, 2, 2, 2}}};
 
         // Set up GEMM indices
         freeIndex[0].isA = true;
@@ -130,19 +141,21 @@ namespace
         // We set K=0 when alpha==0.
         // This makes alpha==0 a change in the problem, and not just a change in the inputs.
         // It optimizes all problems with alpha==0 into K=0 and alpha=(don't care)
-        auto k  = prob.k && *prob.alpha ? prob.k : 0;
-        auto ck = prob.sparseA ? k / 2 : k;
+        // the structured matrix is the compressed one, of half the k of the other
+        auto k   = prob.k && *prob.alpha ? prob.k : 0;
+        auto cka = prob.sparseA ? k / 2 : k;
+        auto ckb = prob.sparseA ? k : k / 2;
 
-        std::vector<size_t> sizes_a(3), sizes_b(3), sizes_c(3), sizes_d(3);
-        std::vector<size_t> strides_a = {prob.row_stride_a, prob.col_stride_a, prob.batch_stride_a};
-        std::vector<size_t> strides_b = {prob.row_stride_b, prob.col_stride_b, prob.batch_stride_b};
-        std::vector<size_t> strides_c = {prob.row_stride_c, prob.col_stride_c, prob.batch_stride_c};
-        std::vector<size_t> strides_d = {prob.row_stride_d, prob.col_stride_d, prob.batch_stride_d};
+        TensorDims sizes_a, sizes_b, sizes_c, sizes_d;
+        TensorDims strides_a = {prob.row_stride_a, prob.col_stride_a, prob.batch_stride_a};
+        TensorDims strides_b = {prob.row_stride_b, prob.col_stride_b, prob.batch_stride_b};
+        TensorDims strides_c = {prob.row_stride_c, prob.col_stride_c, prob.batch_stride_c};
+        TensorDims strides_d = {prob.row_stride_d, prob.col_stride_d, prob.batch_stride_d};
 
         // If A is transposed, swap the free and bound dimensions and their ranks
         if(prob.trans_a != rocsparselt_operation_none)
         {
-            sizes_a[0] = ck;
+            sizes_a[0] = cka;
             sizes_a[1] = prob.m;
             sizes_a[2] = prob.batch_count;
 
@@ -152,7 +165,7 @@ namespace
         else
         {
             sizes_a[0] = prob.m;
-            sizes_a[1] = ck;
+            sizes_a[1] = cka;
             sizes_a[2] = prob.batch_count;
 
             freeIndex[0].i  = 0;
@@ -163,7 +176,7 @@ namespace
         if(prob.trans_b != rocsparselt_operation_none)
         {
             sizes_b[0] = prob.n;
-            sizes_b[1] = k;
+            sizes_b[1] = ckb;
             sizes_b[2] = prob.batch_count;
 
             freeIndex[1].i  = 0;
@@ -171,7 +184,7 @@ namespace
         }
         else
         {
-            sizes_b[0] = k;
+            sizes_b[0] = ckb;
             sizes_b[1] = prob.n;
             sizes_b[2] = prob.batch_count;
 
@@ -187,48 +200,32 @@ namespace
         sizes_d[1] = prob.n;
         sizes_d[2] = prob.batch_count;
 
-        FreeIndices         freeIndicesA;
-        FreeIndices         freeIndicesB;
-        std::vector<size_t> freeSizesA;
-        std::vector<size_t> freeSizesB;
-
-        freeIndicesA.reserve(freeIndex.size());
-        freeIndicesB.reserve(freeIndex.size());
-        freeSizesA.reserve(freeIndex.size());
-        freeSizesB.reserve(freeIndex.size());
-        for(int i = 0; i < freeIndex.size(); i++)
+        // CD always contain index0.  if this is in the B free indices, then need to
+        // transposing the output tensor.
+        bool transposeC01 = false;
+        for(size_t i = 0; i < freeIndex.size(); i++)
         {
             size_t mySize = sizes_d[freeIndex[i].d];
             if(freeIndex[i].isA)
             {
-                freeIndicesA.push_back(freeIndex[i]);
-                freeSizesA.push_back(mySize);
+                ki.numWorkGroups.x *= mySize;
             }
             else
             {
-                freeIndicesB.push_back(freeIndex[i]);
-                freeSizesB.push_back(mySize);
+                ki.numWorkGroups.y *= mySize;
+                transposeC01 |= freeIndex[i].c == 0 /*idx0*/;
             }
         }
 
-        for(size_t i = 0; i < freeIndicesA.size(); i++)
-        {
-            ki.numWorkGroups.x *= freeSizesA[i];
-        }
-        for(size_t i = 0; i < freeIndicesB.size(); i++)
-        {
-            ki.numWorkGroups.y *= freeSizesB[i];
-        }
-
         ki.numWorkGroups.z = 1;
 
-        std::vector<size_t> batchSizes(batchIndex.size());
-        std::vector<size_t> boundSizes(boundIndex.size());
+        std::array<size_t, 1> batchSizes;
+        std::array<size_t, 1> boundSizes;
         for(int i = 0; i < batchIndex.size(); i++)
         {
             batchSizes[i] = std::max({sizes_a[batchIndex[i].a],
                                       sizes_b[batchIndex[i].b],
-                                      sizes_c.empty() ? 0 : sizes_c[batchIndex[i].c],
+                                      sizes_c[batchIndex[i].c],
                                       sizes_d[batchIndex[i].d]});
         }
 
@@ -247,13 +244,6 @@ namespace
                 ki.numWorkGroups.z *= batchSizes[i];
         }
 
-        // CD always contain index0.  if this is in the B free indices, then need to
-        // transposing the output tensor.
-        bool transposeC01 = freeIndicesB.end()
-                            != std::find_if(freeIndicesB.begin(),
-                                            freeIndicesB.end(),
-                                            [](const FreeIndex& fi) { return fi.c == 0 /*idx0*/; });
-
         if(transposeC01)
             std::swap(ki.numWorkGroups.x, ki.numWorkGroups.y);
 
@@ -290,8 +280,8 @@ namespace
         ki.args.append<Ti const*>("a", prob.A);
         ki.args.append<Ti const*>("b", prob.B);
 
-        if(prob.sparseA)
-            ki.args.append<unsigned char const*>("metadata", prob.metadata);
+        // the kernels of SPA and of SPB take the metadata of the structured matrix after b
+        ki.args.append<unsigned char const*>("metadata", prob.metadata);
 
         ki.args.append<float>("alpha", *prob.alpha);
         ki.args.append<float>("beta", *prob.beta);
@@ -330,14 +320,13 @@ namespace
         for(size_t i = startStrideAB; i < sizes_b.size(); i++)
             ki.args.append<uint32_t>(concatenate_if<true>("strideB", i), strides_b[i]);
 
-        std::vector<size_t> problemSizes;
-        problemSizes.resize(0);
-        problemSizes.reserve(sizes_c.size() + boundSizes.size());
-        problemSizes.insert(problemSizes.end(), sizes_c.begin(), sizes_c.end());
-        problemSizes.insert(problemSizes.end(), boundSizes.begin(), boundSizes.end());
-
         int idx = 0;
-        for(auto size : problemSizes)
+        for(auto size : sizes_c)
+        {
+            ki.args.append<uint32_t>(concatenate_if<true>("size_", idx), size);
+            idx++;
+        }
+        for(auto size : boundSizes)
         {
             ki.args.append<uint32_t>(concatenate_if<true>("size_", idx), size);
             idx++;
@@ -400,19 +389,588 @@ namespace
         return ki;
     }
 
+    /******************************************************************************
+     * BindKernelInvoke builds the kernel invocation once and records where the   *
+     * per-call arguments are located in the argument blob, pin keeps its code    *
+     * object loaded                                                              *
+     ******************************************************************************/
+    template <typename Ti, typename To, typename Tc>
+    void BindKernelInvoke(SolutionAdapter&                                 adapter,
+                          const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                          const KernelParams&                              kernel,
+                          BoundKernelInvocation&                           bound,
+                          SolutionAdapter::ModulePin&                      pin)
+    {
+        auto ki = ConstructKernelInvoke<Ti, To, Tc>(prob, kernel);
+
+        if(ki.args.size() > BoundKernelInvocation::MaxArgsBytes)
+            throw std::runtime_error(concatenate("Kernel arguments of ",
+                                                 ki.kernelName,
+                                                 " exceed ",
+                                                 BoundKernelInvocation::MaxArgsBytes,
+                                                 " bytes."));
+
+        bound.kernelName     = ki.kernelName;
+        bound.workGroupSize  = ki.workGroupSize;
+        bound.numWorkItems   = ki.numWorkItems;
+        bound.sharedMemBytes = ki.sharedMemBytes;
+        bound.argsSize       = ki.args.size();
+        std::memcpy(bound.args, ki.args.data(), bound.argsSize);
+
+        bound.offsetA     = ki.args.offset("a");
+        bound.offsetB     = ki.args.offset("b");
+        bound.offsetC     = ki.args.offset("c");
+        bound.offsetD     = ki.args.offset("d");
+        bound.offsetAlpha = ki.args.offset("alpha");
+        bound.offsetBeta  = ki.args.offset("beta");
+        bound.offsetMetadata = ki.args.offset("metadata");
+
+        THROW_IF_HIP_ERROR(
+            adapter.resolveKernel(prob.handle, bound.kernelName, bound.function, pin));
+    }
+
+    /******************************************************************************
+     * LaunchBoundKernel copies the bound arguments, patches the per-call ones    *
+     * and launches the kernel                                                    *
+     ******************************************************************************/
+    template <typename Ti, typename To, typename Tc>
+    hipError_t LaunchBoundKernel(SolutionAdapter&                                 adapter,
+                                 const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                 const BoundKernelInvocation&                     bound,
+                                 const SolutionAdapter::ModulePin&                pin)
+    {
+        alignas(8) uint8_t args[BoundKernelInvocation::MaxArgsBytes];
+        std::memcpy(args, bound.args, bound.argsSize);
+
+        BoundKernelInvocation::patch<To const*>(args, bound.offsetD, prob.D);
+        BoundKernelInvocation::patch<To const*>(args, bound.offsetC, prob.C);
+        BoundKernelInvocation::patch<Ti const*>(args, bound.offsetA, prob.A);
+        BoundKernelInvocation::patch<Ti const*>(args, bound.offsetB, prob.B);
+        BoundKernelInvocation::patch<unsigned char const*>(
+            args, bound.offsetMetadata, prob.metadata);
+        BoundKernelInvocation::patch<float>(args, bound.offsetAlpha, *prob.alpha);
+        BoundKernelInvocation::patch<float>(args, bound.offsetBeta, *prob.beta);
+
+        return adapter.launchKernel(prob.handle, bound, pin, args, prob.streams[0]);
+    }
+
+    /******************************************************************************
+     * Split-K kernels (GlobalSplitU > 1) split the K loop over GlobalSplitU work  *
+     * groups per tile. With GlobalAccumulationSingleBuffer they atomically add    *
+     * their part to D, which SplitKScaleC first sets to beta * C. With            *
+     * GlobalAccumulationMultipleBuffer they write the part of each split to its   *
+     * own m x n x batch_count buffer of the workspace, in the compute type, and   *
+     * SplitKReduce sums the buffers into D, applying alpha, beta and activation.  *
+     ******************************************************************************/
+    bool IsSplitKOneKernel(const KernelParams& kernel)
+    {
+        return kernel.GlobalSplitU > 1
+               && kernel.GlobalAccumulation == GlobalAccumulationSingleBuffer;
+    }
+
+    bool IsSplitKTwoKernels(const KernelParams& kernel)
+    {
+        return kernel.GlobalSplitU > 1
+               && kernel.GlobalAccumulation == GlobalAccumulationMultipleBuffer;
+    }
+
+    template <typename Tc>
+    size_t SplitKWorkspaceBytes(const KernelParams& kernel, size_t output_elements)
+    {
+        return IsSplitKTwoKernels(kernel) ? output_elements * kernel.GlobalSplitU * sizeof(Tc) : 0;
+    }
+
+    __device__ inline float
+        SplitKActivation(float x, hipsparselt_activation_type type, float arg0, float arg1)
+    {
+        switch(type)
+        {
+        case hipsparselt_activation_type::abs:
+            return fabsf(x);
+        case hipsparselt_activation_type::clippedrelu:
+            return x > arg0 ? fminf(x, arg1) : 0.f;
+        case hipsparselt_activation_type::gelu:
+        {
+            float y = 0.5f * x * (1.f + tanhf(0.7978845608f * x * (1.f + 0.044715f * x * x)));
+            return arg0 != 1.f ? y * arg0 : y;
+        }
+        case hipsparselt_activation_type::leakyrelu:
+            return x > 0.f ? x : x * arg0;
+        case hipsparselt_activation_type::relu:
+            return fmaxf(x, 0.f);
+        case hipsparselt_activation_type::sigmoid:
+            return 1.f / (1.f + expf(-x));
+        case hipsparselt_activation_type::tanh:
+            return tanhf(x * arg0) * arg1;
+        case hipsparselt_activation_type::silu:
+            return x / (1.f + expf(-x));
+        case hipsparselt_activation_type::clamp:
+            return fminf(fmaxf(x, arg0), arg1);
+        default:
+            return x;
+        }
+    }
+
+    template <typename To>
+    __device__ inline To SplitKSaturate(float x)
+    {
+        if constexpr(std::is_same<To, int8_t>{})
+            return static_cast<To>(fminf(fmaxf(rintf(x), -128.f), 127.f));
+        else if constexpr(std::is_same<To, int32_t>{})
+            // 2147483520 is the largest float below 2^31
+            return static_cast<To>(fminf(fmaxf(rintf(x), -2147483648.f), 2147483520.f));
+        else
+            return static_cast<To>(x);
+    }
+
+    // The largest finite value of To, the bound of the saturation of D
+    template <typename To>
+    __device__ inline float SplitKMaxFinite()
+    {
+        if constexpr(std::is_same<To, __half>{})
+            return 65504.f;
+        else if constexpr(std::is_same<To, hip_bfloat16>{})
+            return 3.38953139e38f;
+        else if constexpr(std::is_same<To, int32_t>{})
+            return 2147483520.f;
+        else
+            return FLT_MAX;
+    }
+
+    template <typename To, typename Tc>
+    __global__ void SplitKReduceKernel(const Tc* __restrict__       ws,
+                                       const To*                   C,
+                                       To*                         D,
+                                       size_t                      m,
+                                       size_t                      n,
+                                       size_t                      batch_count,
+                                       size_t                      split_k,
+                                       size_t                      row_stride_c,
+                                       size_t                      col_stride_c,
+                                       size_t                      batch_stride_c,
+                                       size_t                      row_stride_d,
+                                       size_t                      col_stride_d,
+                                       size_t                      batch_stride_d,
+                                       float                       alpha,
+                                       float                       beta,
+                                       const float*                alpha_vector,
+                                       const float*                beta_vector,
+                                       hipsparselt_activation_type act_type,
+                                       float                       act_arg0,
+                                       float                       act_arg1,
+                                       float                       d_scale,
+                                       bool                        d_saturate,
+                                       float*                      amax_d,
+                                       const To*                   residual,
+                                       size_t                      batch_stride_residual,
+                                       const To*                   gate,
+                                       size_t                      batch_stride_gate,
+                                       size_t                      columns,
+                                       float*                      bias_grad_partial)
+    {
+        // a thread reduces the elements of row i of columns consecutive columns, over all the
+        // batches, and sums them into its partial sum of the bias gradient
+        size_t elements = m * n * batch_count;
+        size_t thread   = size_t(hipBlockIdx_x) * hipBlockDim_x + hipThreadIdx_x;
+        size_t i        = thread % m;
+        size_t first    = (thread / m) * columns;
+        size_t last     = first + columns < n * batch_count ? first + columns : n * batch_count;
+        float  amax     = 0.f;
+        float  grad     = 0.f;
+        if(first < last)
+        {
+            if(alpha_vector)
+                alpha *= alpha_vector[i];
+            if(beta_vector)
+                beta *= beta_vector[i];
+        }
+        for(size_t column = first; column < last; column++)
+        {
+            size_t idx = i + column * m;
+            size_t j   = column % n;
+            size_t b   = column / n;
+
+            float sum = 0.f;
+            for(size_t s = 0; s < split_k; s++)
+                sum += static_cast<float>(ws[s * elements + idx]);
+
+            size_t c_pos = i * row_stride_c + j * col_stride_c + b * batch_stride_c;
+            float  value = alpha * sum;
+            if(beta != 0.f)
+                value += beta * static_cast<float>(C[c_pos]);
+            value = SplitKActivation(value, act_type, act_arg0, act_arg1);
+            // the gate and the residual have the layout of D, the gate is read before D is
+            // written by the same thread so it may alias D
+            if(gate)
+                value *= static_cast<float>(
+                    gate[i * row_stride_d + j * col_stride_d + b * batch_stride_gate]);
+            if(residual)
+                value += static_cast<float>(
+                    residual[i * row_stride_d + j * col_stride_d + b * batch_stride_residual]);
+            amax = fmaxf(amax, fabsf(value));
+            value *= d_scale;
+            if(d_saturate && !isnan(value))
+                value = fminf(fmaxf(value, -SplitKMaxFinite<To>()), SplitKMaxFinite<To>());
+            grad += value;
+            D[i * row_stride_d + j * col_stride_d + b * batch_stride_d] = SplitKSaturate<To>(value);
+        }
+        // thread is the index of its partial sum, row i of the columns from first on
+        if(bias_grad_partial && first < last)
+            bias_grad_partial[thread] = grad;
+
+        // amax_d is uniform, so every lane of the wavefront takes part in the reduction and
+        // a single atomic per wavefront updates it; the bits of non-negative floats order
+        // like unsigned integers
+        if(amax_d)
+        {
+            for(int offset = warpSize / 2; offset > 0; offset /= 2)
+                amax = fmaxf(amax, __shfl_xor(amax, offset));
+            if(hipThreadIdx_x % warpSize == 0)
+                atomicMax(reinterpret_cast<unsigned int*>(amax_d), __float_as_uint(amax));
+        }
+    }
+
+    // Sums the partial sums of the bias gradient of the reduce kernel, slabs of m floats
+    __global__ void SplitKBiasGradKernel(const float* __restrict__ partial,
+                                         float*                    bias_grad,
+                                         size_t                    m,
+                                         size_t                    slabs)
+    {
+        size_t i = size_t(hipBlockIdx_x) * hipBlockDim_x + hipThreadIdx_x;
+        if(i >= m)
+            return;
+
+        float sum = 0.f;
+        for(size_t s = 0; s < slabs; s++)
+            sum += partial[s * m + i];
+        bias_grad[i] = sum;
+    }
+
+    template <typename To>
+    __global__ void SplitKScaleCKernel(const To* C,
+                                       To*       D,
+                                       size_t    m,
+                                       size_t    n,
+                                       size_t    batch_count,
+                                       size_t    row_stride_c,
+                                       size_t    col_stride_c,
+                                       size_t    batch_stride_c,
+                                       size_t    row_stride_d,
+                                       size_t    col_stride_d,
+                                       size_t    batch_stride_d,
+                                       float     beta)
+    {
+        size_t idx = size_t(hipBlockIdx_x) * hipBlockDim_x + hipThreadIdx_x;
+        if(idx >= m * n * batch_count)
+            return;
+
+        size_t i = idx % m;
+        size_t j = (idx / m) % n;
+        size_t b = idx / (m * n);
+
+        size_t c_pos = i * row_stride_c + j * col_stride_c + b * batch_stride_c;
+        float  value = beta == 0.f ? 0.f : beta * static_cast<float>(C[c_pos]);
+        D[i * row_stride_d + j * col_stride_d + b * batch_stride_d] = SplitKSaturate<To>(value);
+    }
+
+    // The problem solved by the kernel of a two-kernel Split-K config: the plain product
+    // of A and B, written to the buffers of the workspace
+    template <typename Ti, typename To, typename Tc>
+    RocsparseltContractionProblem<Ti, To, Tc>
+        SplitKPartialProblem(const RocsparseltContractionProblem<Ti, To, Tc>& prob)
+    {
+        static const Tc one = 1, zero = 0;
+
+        auto partial            = prob;
+        partial.alpha           = prob.k && *prob.alpha ? &one : &zero;
+        partial.beta            = &zero;
+        partial.C               = reinterpret_cast<To*>(prob.workspace);
+        partial.D               = reinterpret_cast<To*>(prob.workspace);
+        partial.row_stride_c    = 1;
+        partial.row_stride_d    = 1;
+        partial.col_stride_c    = prob.m;
+        partial.col_stride_d    = prob.m;
+        partial.batch_stride_c  = prob.m * prob.n;
+        partial.batch_stride_d  = prob.m * prob.n;
+        partial.buffer_offset_c = 0;
+        partial.buffer_offset_d = 0;
+        partial.act_type        = hipsparselt_activation_type::none;
+        return partial;
+    }
+
+    template <typename Ti, typename To, typename Tc>
+    hipError_t LaunchSplitKReduce(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                  const KernelParams&                              kernel)
+    {
+        constexpr unsigned threads  = 256;
+        size_t             elements = prob.m * prob.n * prob.batch_count;
+        if(prob.amax_d)
+        {
+            // amax(D) of an empty D is 0
+            hipError_t err = hipMemsetAsync(prob.amax_d, 0, sizeof(float), prob.streams[0]);
+            if(err != hipSuccess)
+                return err;
+        }
+        if(prob.bias_grad && !elements)
+        {
+            // and so are the sums of its rows
+            hipError_t err
+                = hipMemsetAsync(prob.bias_grad, 0, prob.m * sizeof(float), prob.streams[0]);
+            if(err != hipSuccess)
+                return err;
+        }
+        if(!elements)
+            return hipSuccess;
+
+        // with a bias gradient a thread reduces several columns so that few partial sums
+        // follow the buffers of the splits in the workspace
+        size_t columns = prob.bias_grad ? _rocsparselt_matmul_descr::bias_grad_columns : 1;
+        size_t slabs   = CeilDivide<size_t>(prob.n * prob.batch_count, columns);
+        float* partial = nullptr;
+        if(prob.bias_grad)
+            partial = reinterpret_cast<float*>(reinterpret_cast<char*>(prob.workspace)
+                                               + SplitKWorkspaceBytes<Tc>(kernel, elements));
+
+        hipLaunchKernelGGL((SplitKReduceKernel<To, Tc>),
+                           dim3(CeilDivide<size_t>(prob.m * slabs, threads)),
+                           dim3(threads),
+                           0,
+                           prob.streams[0],
+                           reinterpret_cast<const Tc*>(prob.workspace),
+                           prob.C,
+                           prob.D,
+                           prob.m,
+                           prob.n,
+                           prob.batch_count,
+                           kernel.GlobalSplitU,
+                           prob.row_stride_c,
+                           prob.col_stride_c,
+                           prob.batch_stride_c,
+                           prob.row_stride_d,
+                           prob.col_stride_d,
+                           prob.batch_stride_d,
+                           prob.k ? static_cast<float>(*prob.alpha) : 0.f,
+                           static_cast<float>(*prob.beta),
+                           prob.alpha_vector,
+                           prob.beta_vector,
+                           prob.act_type,
+                           prob.act_arg0,
+                           prob.act_arg1,
+                           prob.d_scale,
+                           prob.d_saturate,
+                           prob.amax_d,
+                           prob.residual,
+                           prob.batch_stride_residual,
+                           prob.gate,
+                           prob.batch_stride_gate,
+                           columns,
+                           partial);
+        if(!prob.bias_grad)
+            return hipGetLastError();
+
+        hipError_t err = hipGetLastError();
+        if(err != hipSuccess)
+            return err;
+        hipLaunchKernelGGL(SplitKBiasGradKernel,
+                           dim3(CeilDivide<size_t>(prob.m, threads)),
+                           dim3(threads),
+                           0,
+                           prob.streams[0],
+                           partial,
+                           prob.bias_grad,
+                           prob.m,
+                           slabs);
+        return hipGetLastError();
+    }
+
+    template <typename Ti, typename To, typename Tc>
+    hipError_t LaunchSplitKScaleC(const RocsparseltContractionProblem<Ti, To, Tc>& prob)
+    {
+        constexpr unsigned threads  = 256;
+        size_t             elements = prob.m * prob.n * prob.batch_count;
+        if(!elements)
+            return hipSuccess;
+
+        hipLaunchKernelGGL((SplitKScaleCKernel<To>),
+                           dim3(CeilDivide<size_t>(elements, threads)),
+                           dim3(threads),
+                           0,
+                           prob.streams[0],
+                           prob.C,
+                           prob.D,
+                           prob.m,
+                           prob.n,
+                           prob.batch_count,
+                           prob.row_stride_c,
+                           prob.col_stride_c,
+                           prob.batch_stride_c,
+                           prob.row_stride_d,
+                           prob.col_stride_d,
+                           prob.batch_stride_d,
+                           static_cast<float>(*prob.beta));
+        return hipGetLastError();
+    }
+
+    /******************************************************************************
+     * LaunchSplitK runs a Split-K config, its kernel between the kernels which    *
+     * prepare D or reduce the splits. The events, when given, are recorded       *
+     * around all of them.                                                         *
+     ******************************************************************************/
+    template <typename Ti, typename To, typename Tc>
+    hipError_t LaunchSplitK(SolutionAdapter&                                 adapter,
+                            const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                            const KernelParams&                              kernel,
+                            const KernelInvocation&                          invocation,
+                            hipEvent_t                                       startEvent,
+                            hipEvent_t                                       stopEvent)
+    {
+        hipStream_t stream = prob.streams[0];
+        hipError_t  err    = hipSuccess;
+        if(startEvent)
+            err = hipEventRecord(startEvent, stream);
+        if(err == hipSuccess && IsSplitKOneKernel(kernel))
+            err = LaunchSplitKScaleC(prob);
+        if(err == hipSuccess)
+            err = adapter.launchKernel(prob.handle, invocation, stream, nullptr, nullptr);
+        if(err == hipSuccess && IsSplitKTwoKernels(kernel))
+            err = LaunchSplitKReduce(prob, kernel);
+        if(err == hipSuccess && stopEvent)
+            err = hipEventRecord(stopEvent, stream);
+        return err;
+    }
+
+    // Whether a config can run the epilogue of D of prob, the vector scaling, the scale and
+    // saturation of D, amax(D), the gate, the residual, the bias gradient, the SiLU and clamp
+    // activations and an int32 D: only the reduce kernel of a two-kernel Split-K config has it
+    template <typename Ti, typename To, typename Tc>
+    bool SupportsReduceEpilogue(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                const _rocsparselt_matmul_config&                config,
+                                const KernelParams&                              kernel)
+    {
+        bool epilogue = prob.alpha_vector || prob.beta_vector || prob.d_scale != 1.f
+                        || prob.d_saturate || prob.amax_d || prob.residual || prob.gate
+                        || prob.bias_grad || prob.act_type == hipsparselt_activation_type::silu
+                        || prob.act_type == hipsparselt_activation_type::clamp
+                        || std::is_same<To, int32_t>{};
+        return !epilogue || (IsSplitKTwoKernels(kernel) && config.stream_k_index < 0);
+    }
+
+    // The invocation of the kernel of a config, on the workspace for a two-kernel Split-K one
+    template <typename Ti, typename To, typename Tc>
+    KernelInvocation ConstructConfigInvoke(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                           const KernelParams&                              kernel)
+    {
+        if(IsSplitKTwoKernels(kernel))
+            return ConstructKernelInvoke<Ti, To, Tc>(SplitKPartialProblem(prob), kernel);
+        return ConstructKernelInvoke<Ti, To, Tc>(prob, kernel);
+    }
+
+    /******************************************************************************
+     * A Stream-K schedule runs the columns of tiles which fill whole waves of the *
+     * CUs on a data-parallel kernel and the remaining ones, the last partial wave,*
+     * on a Split-K kernel of the same macro tile, so that the splits of its K     *
+     * loop keep the otherwise idle CUs busy.                                      *
+     ******************************************************************************/
+    struct StreamKSchedule
+    {
+        int tail_kernel = -1; // the Split-K kernel of the last columns, -1 for no schedule
+        int columns     = 0; // columns of D computed by the data-parallel kernel
+    };
+
+    StreamKSchedule ScheduleStreamK(const KernelParams* solution,
+                                    int                 kernel_count,
+                                    int                 kernel,
+                                    size_t              m,
+                                    size_t              n,
+                                    size_t              batch_count,
+                                    int                 cus)
+    {
+        StreamKSchedule     schedule;
+        const KernelParams& dp = solution[kernel];
+        if(dp.GlobalSplitU > 1 || cus <= 0)
+            return schedule;
+
+        size_t column_tiles = CeilDivide<size_t>(m, dp.MacroTile[0]) * batch_count;
+        size_t block_tiles  = CeilDivide<size_t>(n, dp.MacroTile[1]);
+        size_t tiles        = column_tiles * block_tiles;
+        size_t full_blocks  = tiles / cus * cus / column_tiles;
+        if(tiles % cus == 0 || full_blocks == 0 || full_blocks >= block_tiles)
+            return schedule;
+
+        // the largest split which still fits the tail in a single wave
+        size_t tail_tiles = (block_tiles - full_blocks) * column_tiles;
+        size_t best_split = 1;
+        for(int i = 0; i < kernel_count; i++)
+        {
+            const KernelParams& sk = solution[i];
+            if(!IsSplitKTwoKernels(sk) || sk.MacroTile[0] != dp.MacroTile[0]
+               || sk.MacroTile[1] != dp.MacroTile[1] || sk.GlobalSplitU <= best_split
+               || tail_tiles * sk.GlobalSplitU > size_t(cus))
+                continue;
+            best_split           = sk.GlobalSplitU;
+            schedule.tail_kernel = i;
+        }
+        schedule.columns = full_blocks * dp.MacroTile[1];
+        return schedule;
+    }
+
+    /******************************************************************************
+     * LaunchStreamK runs a Stream-K config: the data-parallel kernel on the first *
+     * columns of D, then the Split-K kernel on the others.                        *
+     ******************************************************************************/
+    template <typename Ti, typename To, typename Tc>
+    hipError_t LaunchStreamK(SolutionAdapter&                                 adapter,
+                             const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                             const _rocsparselt_matmul_config&                config,
+                             const KernelParams*                              solution,
+                             hipEvent_t                                       startEvent,
+                             hipEvent_t                                       stopEvent)
+    {
+        const KernelParams& dp   = solution[config.index];
+        const KernelParams& tail = solution[config.stream_k_index];
+        const size_t        cols = std::min<size_t>(config.stream_k_columns, prob.n);
+
+        auto head_prob = prob;
+        head_prob.n    = cols;
+
+        // B is n x k when transposed, k x n otherwise
+        size_t column_stride_b
+            = prob.trans_b != rocsparselt_operation_none ? prob.row_stride_b : prob.col_stride_b;
+
+        auto tail_prob = prob;
+        tail_prob.n    = prob.n - cols;
+        tail_prob.B    = prob.B + cols * column_stride_b;
+        tail_prob.C    = prob.C + cols * prob.col_stride_c;
+        tail_prob.D    = prob.D + cols * prob.col_stride_d;
+
+        // both invocations are built before the first launch, not between the two kernels
+        auto head_invocation = ConstructKernelInvoke<Ti, To, Tc>(head_prob, dp);
+        auto tail_invocation = ConstructConfigInvoke<Ti, To, Tc>(tail_prob, tail);
+
+        hipError_t err = adapter.launchKernel(
+            prob.handle, head_invocation, prob.streams[0], startEvent, nullptr);
+        if(err == hipSuccess && tail_prob.n)
+            err = LaunchSplitK<Ti, To, Tc>(
+                adapter, tail_prob, tail, tail_invocation, nullptr, stopEvent);
+        else if(err == hipSuccess && stopEvent)
+            err = hipEventRecord(stopEvent, prob.streams[0]);
+        return err;
+    }
+
     /**************************************************
      * The KernelLauncher struct interfaces           *
      **************************************************/
     class KernelLauncher
     {
-        std::shared_ptr<hipDeviceProp_t> m_deviceProp;
-
         // The adapter object. mutable is used to allow adapters to be modified
-        // even when they are stored in a const vector which is immutable in size
+        // even when they are stored in a const vector which is immutable in size.
+        // The device property is kept next to its adapter since several devices
+        // may be initialized concurrently.
         struct adapter_s
         {
-            mutable std::atomic<SolutionAdapter*> adapter{nullptr};
-            mutable std::mutex                    mutex;
+            mutable std::atomic<SolutionAdapter*>    adapter{nullptr};
+            mutable std::mutex                       mutex;
+            mutable std::shared_ptr<hipDeviceProp_t> deviceProp;
         };
 
         // Each device contains an adapter
@@ -451,11 +1009,6 @@ namespace
                 delete a.adapter;
         }
 
-        auto& get_device_property() const
-        {
-            return m_deviceProp;
-        }
-
         auto& get_adapters() const
         {
             return m_adapters;
@@ -533,11 +1086,15 @@ namespace
                       << std::endl;
             }
 
+            // the MiB of the code objects kept loaded, HIPSPARSELT_CODE_OBJECT_CACHE_SIZE
+            if(const char* limit = getenv("HIPSPARSELT_CODE_OBJECT_CACHE_SIZE"))
+                adapter.setCodeObjectLimit(size_t(strtoul(limit, nullptr, 0)) << 20);
+
             hipDeviceProp_t prop;
 
             THROW_IF_HIP_ERROR(hipGetDeviceProperties(&prop, deviceId));
 
-            m_deviceProp = std::make_shared<hipDeviceProp_t>(prop);
+            m_adapters.at(deviceId).deviceProp = std::make_shared<hipDeviceProp_t>(prop);
         }
     };
 
@@ -577,7 +1134,7 @@ namespace
             }
 
             if(deviceProp)
-                *deviceProp = host.get_device_property();
+                *deviceProp = a.deviceProp;
 
             return *adapter;
         }
@@ -617,83 +1174,289 @@ namespace
             hipsparselt_cerr << msg << std::endl;
     }
 
+    // the data type of a kernel category, see the GENERATE_DEFINITIONS below. The kernels
+    // of an int32 D are the int8 ones.
+    const char* kernel_category_type(rocsparselt_datatype type)
+    {
+        switch(type)
+        {
+        case rocsparselt_datatype_f16_r:
+            return "4";
+        case rocsparselt_datatype_bf16_r:
+            return "7";
+        case rocsparselt_datatype_i8_r:
+        case rocsparselt_datatype_i32_r:
+            return "8";
+        case rocsparselt_datatype_f8_r:
+            return "11";
+        case rocsparselt_datatype_bf8_r:
+            return "12";
+        case rocsparselt_datatype_f32_r:
+            return "0";
+        }
+        return nullptr;
+    }
+
 } // namespace
 
+/******************************************************************************
+ * _rocsparselt_solution_cache keeps the adapter and the kernel parameters    *
+ * resolved for a plan, so that they are only looked up once, and the kernel  *
+ * invocation bound for the selected config. A published invocation entry is *
+ * never modified; it is replaced when the config, alpha==0 or the batch      *
+ * count changes. The entry pins the code object of its kernel.               *
+ ******************************************************************************/
+struct _rocsparselt_solution_cache
+{
+    struct key_t
+    {
+        int    config_id;
+        bool   alpha_zero;
+        size_t batch_count;
+
+        bool operator==(const key_t& rhs) const
+        {
+            return config_id == rhs.config_id && alpha_zero == rhs.alpha_zero
+                   && batch_count == rhs.batch_count;
+        }
+    };
+
+    struct entry_t
+    {
+        key_t                      key;
+        BoundKernelInvocation      invocation;
+        SolutionAdapter::ModulePin pin;
+    };
+
+    std::atomic<SolutionAdapter*> adapter{nullptr};
+    KernelParams*                 solution = nullptr;
+    size_t                        max_cid  = 0;
+    std::mutex                    mutex;
+
+    std::shared_ptr<const entry_t> get() const
+    {
+        return std::atomic_load(&entry);
+    }
+
+    void set(std::shared_ptr<const entry_t> e)
+    {
+        std::atomic_store(&entry, std::move(e));
+    }
+
+private:
+    std::shared_ptr<const entry_t> entry;
+};
+
+_rocsparselt_solution_cache* rocsparselt_solution_cache_create()
+{
+    return new _rocsparselt_solution_cache;
+}
+
+void rocsparselt_solution_cache_destroy(_rocsparselt_solution_cache* cache)
+{
+    delete cache;
+}
+
 /******************************************************************************
  * runContractionProblem used to run a contraction problem described          *
  * by RocsparseltContractionProblem                                           *
  ******************************************************************************/
 template <typename Ti, typename To, typename Tc>
 rocsparselt_status runContractionProblem(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                         _rocsparselt_matmul_config*                      configs,
                                          int*                                             config_id,
-                                         const int config_max_id,
-                                         const int search_iterations)
+                                         const int                         config_max_id,
+                                         const int                         search_iterations,
+                                         const bool                        search_flush_cache,
+                                         rocsparselt_matmul_search_result* search_results,
+                                         _rocsparselt_solution_cache*      solution_cache)
 {
     rocsparselt_status status  = rocsparselt_status_internal_error;
     size_t             max_cid = 0;
     try
     {
-        std::shared_ptr<hipDeviceProp_t> deviceProp;
+        SolutionAdapter* adapter
+            = solution_cache ? solution_cache->adapter.load(std::memory_order_acquire) : nullptr;
+        KernelParams* solution = nullptr;
+
+        // the kernel category of a plan never changes, look it up only once
+        if(adapter)
+        {
+            solution = solution_cache->solution;
+            max_cid  = solution_cache->max_cid;
+        }
+        else
+        {
+            std::shared_ptr<hipDeviceProp_t> deviceProp;
 
-        auto&       adapter = get_adapter(&deviceProp, prob.handle->device);
-        std::string str     = generate_kernel_category_str<Ti, To, Tc>(prob.trans_a, prob.trans_b);
-        max_cid             = adapter.getKernelCounts(str);
-        KernelParams* solution = adapter.getKernelParams(str);
+            adapter = &get_adapter(&deviceProp, prob.handle->device);
+            std::string str = generate_kernel_category_str<Ti, To, Tc>(
+                prob.trans_a, prob.trans_b, prob.sparseA);
+            max_cid         = adapter->getKernelCounts(str);
+            solution        = adapter->getKernelParams(str);
 
-        if(config_max_id != max_cid)
+            if(solution_cache && max_cid)
+            {
+                std::lock_guard<std::mutex> lock(solution_cache->mutex);
+                solution_cache->solution = solution;
+                solution_cache->max_cid  = max_cid;
+                solution_cache->adapter.store(adapter, std::memory_order_release);
+            }
+        }
+
+        // the Stream-K configs follow the ones of the kernels
+        if(config_max_id < max_cid)
         {
             hipsparselt_cerr << "config_max_id (" << config_max_id << ") is out of range ("
                              << max_cid << ") used this value to instead." << std::endl;
         }
 
-        if(!max_cid)
+        // a config which needs more workspace than given is skipped
+        auto has_workspace = [&](int id) {
+            return configs[id].max_workspace_bytes <= prob.workspaceSize
+                   && (configs[id].max_workspace_bytes == 0 || prob.workspace != nullptr);
+        };
+
+        if(!max_cid || configs == nullptr)
         {
             hipsparselt_internal_ostream msg;
             print_once(msg << "\nrocsparselt error: No solution found for " << prob);
             status = rocsparselt_status_not_implemented;
         }
+        else if(!search_iterations
+                && !SupportsReduceEpilogue(
+                    prob, configs[*config_id], solution[configs[*config_id].index]))
+        {
+            hipsparselt_cerr << "config " << *config_id << " does not support the epilogue of D"
+                             << std::endl;
+            return rocsparselt_status_not_implemented;
+        }
+        else if(!search_iterations && !has_workspace(*config_id))
+        {
+            hipsparselt_cerr << "config " << *config_id << " need extra workspace "
+                             << configs[*config_id].max_workspace_bytes << " bytes - skip."
+                             << std::endl;
+            return rocsparselt_status_internal_error;
+        }
         else
         {
-            if(!search_iterations)
+            const KernelParams& kernel = solution[configs[*config_id].index];
+            if(!search_iterations && configs[*config_id].stream_k_index >= 0)
+            {
+                RETURN_IF_HIP_ERROR(LaunchStreamK<Ti, To, Tc>(
+                    *adapter, prob, configs[*config_id], solution, nullptr, nullptr));
+            }
+            else if(!search_iterations && kernel.GlobalSplitU > 1)
             {
-                RETURN_IF_HIP_ERROR(adapter.launchKernel(
-                    prob.handle,
-                    ConstructKernelInvoke<Ti, To, Tc>(prob, solution[*config_id]),
-                    prob.streams[0],
-                    nullptr,
-                    nullptr));
+                // the solution cache binds a single kernel, a Split-K config launches more
+                RETURN_IF_HIP_ERROR(
+                    LaunchSplitK<Ti, To, Tc>(*adapter,
+                                             prob,
+                                             kernel,
+                                             ConstructConfigInvoke<Ti, To, Tc>(prob, kernel),
+                                             nullptr,
+                                             nullptr));
+            }
+            else if(!search_iterations
+                    && (prob.handle->layer_mode & rocsparselt_layer_mode_log_trace))
+            {
+                // trace logging prints every argument by name, use the full invocation
+                RETURN_IF_HIP_ERROR(
+                    adapter->launchKernel(prob.handle,
+                                          ConstructKernelInvoke<Ti, To, Tc>(prob, kernel),
+                                          prob.streams[0],
+                                          nullptr,
+                                          nullptr));
+            }
+            else if(!search_iterations)
+            {
+                _rocsparselt_solution_cache::key_t key{
+                    *config_id, !(prob.k && *prob.alpha), prob.batch_count};
+
+                auto entry = solution_cache ? solution_cache->get() : nullptr;
+                if(!entry || !(entry->key == key))
+                {
+                    auto e = std::make_shared<_rocsparselt_solution_cache::entry_t>();
+                    e->key = key;
+                    BindKernelInvoke<Ti, To, Tc>(*adapter, prob, kernel, e->invocation, e->pin);
+                    entry = e;
+                    if(solution_cache)
+                        solution_cache->set(entry);
+                }
+
+                RETURN_IF_HIP_ERROR(LaunchBoundKernel<Ti, To, Tc>(
+                    *adapter, prob, entry->invocation, entry->pin));
             }
             else
             {
-                float      min_ms = std::numeric_limits<float>::max();
-                hipEvent_t startEvent, stopEvent;
-                float      ms;
-                RETURN_IF_HIP_ERROR(hipEventCreate(&startEvent));
-                RETURN_IF_HIP_ERROR(hipEventCreate(&stopEvent));
-                for(int id = 0; id < max_cid; id++)
+                std::vector<KernelInvocation> invocations(config_max_id);
+                std::vector<int>              candidates;
+                for(int id = 0; id < config_max_id; id++)
                 {
-                    auto ki = ConstructKernelInvoke<Ti, To, Tc>(prob, solution[id]);
-                    //warm up
-                    RETURN_IF_HIP_ERROR(
-                        adapter.launchKernel(prob.handle, ki, prob.streams[0], nullptr, nullptr));
-
-                    RETURN_IF_HIP_ERROR(adapter.launchKernel(prob.handle,
-                                                             ki,
-                                                             prob.streams[0],
-                                                             startEvent,
-                                                             stopEvent,
-                                                             search_iterations));
-                    RETURN_IF_HIP_ERROR(hipEventSynchronize(stopEvent));
-                    RETURN_IF_HIP_ERROR(hipEventElapsedTime(&ms, startEvent, stopEvent));
-                    if(ms < min_ms)
+                    if(configs[id].excluded
+                       || !SupportsReduceEpilogue(prob, configs[id], solution[configs[id].index]))
+                        continue;
+                    if(!has_workspace(id))
                     {
-                        *config_id = id;
-                        min_ms = ms;
+                        hipsparselt_cerr << "config " << id << " need extra workspace "
+                                         << configs[id].max_workspace_bytes << " bytes - skip."
+                                         << std::endl;
+                        continue;
                     }
-
+                    // a Stream-K config builds its two invocations at each launch
+                    if(configs[id].stream_k_index < 0)
+                        invocations[id] = ConstructConfigInvoke<Ti, To, Tc>(
+                            prob, solution[configs[id].index]);
+                    candidates.push_back(id);
                 }
-                RETURN_IF_HIP_ERROR(hipEventDestroy(startEvent));
-                RETURN_IF_HIP_ERROR(hipEventDestroy(stopEvent));
+
+                if(candidates.empty())
+                    return rocsparselt_status_internal_error;
+
+                rocsparselt_search_cache_flush flush_cache(prob.handle);
+                RETURN_IF_HIP_ERROR(flush_cache.init(search_flush_cache));
+
+                rocsparselt_search_timer timer(prob.handle);
+                RETURN_IF_HIP_ERROR(timer.init());
+                auto time_run = [&](int id, int runs, float* ms) {
+                    const KernelParams& candidate = solution[configs[id].index];
+
+                    hipError_t err = hipSuccess;
+                    for(int run = 0; run < runs && err == hipSuccess; run++)
+                    {
+                        hipEvent_t start = timer.start(run), stop = timer.stop(run);
+                        err              = flush_cache(prob.streams[0]);
+                        if(err == hipSuccess && configs[id].stream_k_index >= 0)
+                            err = LaunchStreamK<Ti, To, Tc>(
+                                *adapter, prob, configs[id], solution, start, stop);
+                        else if(err == hipSuccess && candidate.GlobalSplitU > 1)
+                            err = LaunchSplitK<Ti, To, Tc>(
+                                *adapter, prob, candidate, invocations[id], start, stop);
+                        else if(err == hipSuccess)
+                            err = adapter->launchKernel(
+                                prob.handle, invocations[id], prob.streams[0], start, stop);
+                    }
+                    if(err == hipSuccess)
+                        err = timer.elapsed(runs, ms);
+                    if(err == hipSuccess && rocsparselt_tracing())
+                        for(int run = 0; run < runs; run++)
+                            rocsparselt_trace_gpu_events("search config " + std::to_string(id),
+                                                         prob.streams[0],
+                                                         timer.start(run),
+                                                         timer.stop(run));
+                    return err;
+                };
+                std::vector<rocsparselt_search_timing> ranking;
+                hipError_t                             err = rocsparselt_search_successive_halving(
+                    prob.handle, candidates, search_iterations, time_run, config_id, &ranking);
+                RETURN_IF_HIP_ERROR(err);
+
+                if(search_results)
+                    rocsparselt_search_store_results(
+                        ranking,
+                        [&](int id) { return invocations[id].kernelName; },
+                        search_results,
+                        _rocsparselt_matmul_alg_selection::max_search_results);
             }
             status = rocsparselt_status_success;
         }
@@ -718,25 +1481,139 @@ rocsparselt_status runContractionProblem(const RocsparseltContractionProblem<Ti,
  * initSolutions used to initialize specific type's solutions at the early stage.               *
  * ****************************************************************************/
 template <typename Ti, typename To, typename Tc>
-rocsparselt_status initSolutions(const _rocsparselt_handle* handle,
-                                 rocsparselt_operation      opA,
-                                 rocsparselt_operation      opB,
-                                 int*                       kernel_counts)
+rocsparselt_status initSolutions(const _rocsparselt_handle*  handle,
+                                 rocsparselt_operation       opA,
+                                 rocsparselt_operation       opB,
+                                 bool                        sparseA,
+                                 size_t                      m,
+                                 size_t                      n,
+                                 size_t                      k,
+                                 size_t                      batch_count,
+                                 int                         cu_count,
+                                 int                         candidates,
+                                 _rocsparselt_matmul_config* configs,
+                                 int*                        kernel_counts)
 {
-    std::shared_ptr<hipDeviceProp_t> deviceProp;
-    auto&                            adapter = get_adapter(&deviceProp, handle->device);
-    std::string                      str     = generate_kernel_category_str<Ti, To, Tc>(opA, opB);
+    auto&       adapter = get_adapter(nullptr, handle->device);
+    std::string str     = generate_kernel_category_str<Ti, To, Tc>(opA, opB, sparseA);
 
     *kernel_counts = adapter.getKernelCounts(str);
     if(*kernel_counts <= 0)
         return rocsparselt_status_not_implemented;
 
     KernelParams* solution = adapter.getKernelParams(str);
+    const int     kernels  = *kernel_counts;
+    for(int i = 0; i < kernels; i++)
+    {
+        configs[i].index               = i;
+        configs[i].max_workspace_bytes = SplitKWorkspaceBytes<Tc>(solution[i], m * n * batch_count);
+        configs[i].split_k             = std::max<int>(1, solution[i].GlobalSplitU);
+        configs[i].split_k_mode        = IsSplitKOneKernel(solution[i])
+                                             ? rocsparselt_splik_k_mode_one_kernel
+                                             : rocsparselt_split_k_mode_two_kernels;
+        configs[i].stream_k_index      = -1;
+    }
+
+    // the Stream-K configs follow the ones of the kernels until they are all ranked
+    constexpr int maxConfigs
+        = sizeof(_rocsparselt_matmul_alg_selection::configs) / sizeof(_rocsparselt_matmul_config);
+    for(int i = 0; i < kernels && *kernel_counts < maxConfigs; i++)
+    {
+        StreamKSchedule schedule = ScheduleStreamK(
+            solution, kernels, i, m, n, batch_count, cu_count);
+        if(schedule.tail_kernel < 0)
+            continue;
+
+        auto& config            = configs[(*kernel_counts)++];
+        config                  = configs[i];
+        config.stream_k_index   = schedule.tail_kernel;
+        config.stream_k_columns = schedule.columns;
+        config.max_workspace_bytes
+            = SplitKWorkspaceBytes<Tc>(solution[schedule.tail_kernel],
+                                       m * (n - schedule.columns) * batch_count);
+    }
+
+    // config 0 is the one the selection heuristic predicts fastest
+    auto shape_of = [&](int kernel) {
+        rocsparselt_config_shape shape;
+        shape.macro_tile0   = solution[kernel].MacroTile[0];
+        shape.macro_tile1   = solution[kernel].MacroTile[1];
+        shape.depth_u       = solution[kernel].DepthU;
+        shape.split_k       = std::max<int64_t>(1, solution[kernel].GlobalSplitU);
+        shape.reduce_kernel = !IsSplitKOneKernel(solution[kernel]);
+        return shape;
+    };
     for(int i = 0; i < *kernel_counts; i++)
-        PRINT_IF_HIP_ERROR(handle, adapter.loadCodeObject(handle, solution[i].SolutionNameMin));
+    {
+        auto&  config  = configs[i];
+        size_t columns = config.stream_k_index < 0 ? n : config.stream_k_columns;
+        double time
+            = rocsparselt_config_time(shape_of(config.index), m, columns, k, batch_count, cu_count);
+        if(config.stream_k_index >= 0)
+            time += rocsparselt_config_time(
+                shape_of(config.stream_k_index), m, n - columns, k, batch_count, cu_count);
+        config.score = rocsparselt_config_score(time, m, n, k, batch_count, cu_count);
+    }
+    rocsparselt_rank_configs(configs, kernel_counts, candidates);
+
+    // With lazy loading, the code object of a kernel is loaded at its first launch and
+    // only the kernels of the first prefetch_kernels configs, the best ranked, are loaded here.
+    std::vector<std::string> names;
+    if(!handle->lazy_loading)
+        for(int i = 0; i < kernels; i++)
+            names.push_back(solution[i].SolutionNameMin);
+    else
+    {
+        int prefetch = std::min(handle->prefetch_kernels, *kernel_counts);
+        for(int i = 0; i < prefetch; i++)
+            for(int kernel : {configs[i].index, configs[i].stream_k_index})
+                if(kernel >= 0
+                   && std::find(names.begin(), names.end(), solution[kernel].SolutionNameMin)
+                          == names.end())
+                    names.push_back(solution[kernel].SolutionNameMin);
+    }
+    if(!names.empty())
+        PRINT_IF_HIP_ERROR(handle, adapter.loadCodeObjects(handle, names));
     return rocsparselt_status_success;
 }
 
+/*******************************************************************************
+ * The name of the kernel of config index of the problem of matmul_descr, so that
+ * a plan saved by rocsparselt_matmul_plan_serialize() loads only that kernel.
+ ******************************************************************************/
+std::string getSolutionName(const _rocsparselt_handle*       handle,
+                            const _rocsparselt_matmul_descr* matmul_descr,
+                            int                              index)
+{
+    const char* in_type  = kernel_category_type(rocsparselt_matmul_input_type(matmul_descr));
+    const char* out_type = kernel_category_type(matmul_descr->matrix_D->type);
+    if(in_type == nullptr || out_type == nullptr || index < 0)
+        return "";
+
+    std::string str = std::string(in_type) + "_" + out_type + "_0_";
+    str += (matmul_descr->op_A == rocsparselt_operation_none ? "N" : "T");
+    str += "_";
+    str += (matmul_descr->op_B == rocsparselt_operation_none ? "N" : "T");
+    if(!matmul_descr->is_sparse_a)
+        str += "_SPB";
+
+    auto& adapter = get_adapter(nullptr, handle->device);
+    if(index >= static_cast<int>(adapter.getKernelCounts(str)))
+        return "";
+    return adapter.getKernelParams(str)[index].SolutionNameMin;
+}
+
+rocsparselt_status loadSolution(const _rocsparselt_handle* handle, const std::string& name)
+{
+    auto& adapter = get_adapter(nullptr, handle->device);
+    return get_rocsparselt_status_for_hip_status(adapter.loadCodeObject(handle, name));
+}
+
+void getCodeObjectStats(const _rocsparselt_handle* handle, rocsparselt_code_object_stats* stats)
+{
+    get_adapter(nullptr, handle->device).getCodeObjectStats(stats);
+}
+
 /***************************************************************
  * ! \brief  Initialize rocsparselt for the current HIP device, to *
  * avoid costly startup time at the first call on that device. *
@@ -746,6 +1623,19 @@ extern "C" void rocsparselt_initialize()
     get_adapter();
 }
 
+/***********************************************************************
+ * ! \brief  Initialize rocsparselt for the devices of device_mask, one *
+ * thread per device, so that the kernel libraries of all the devices   *
+ * are loaded concurrently.                                             *
+ ***********************************************************************/
+extern "C" rocsparselt_status rocsparselt_init_devices(uint64_t device_mask)
+{
+    return rocsparselt_run_on_devices(device_mask, [](int device) {
+        get_adapter(nullptr, device);
+        return rocsparselt_status_success;
+    });
+}
+
 /*******************************************************************************************
  * Whether Kernel Launcher has been initialized for at least one device (used for testing) *
  *******************************************************************************************/
@@ -761,21 +1651,48 @@ std::atomic_bool& rocsparselt_internal_kl_is_initialized()
  ******************************************************************************/
 #define GENERATE_DEFINITIONS(Ti, To, Tc, Ca)                                           \
     template <>                                                                        \
-    std::string generate_kernel_category_str<Ti, To, Tc>(rocsparselt_operation opA,    \
-                                                         rocsparselt_operation opB)    \
+    std::string generate_kernel_category_str<Ti, To, Tc>(                              \
+        rocsparselt_operation opA, rocsparselt_operation opB, bool sparseA)            \
     {                                                                                  \
         std::string str = Ca;                                                          \
         str += "_";                                                                    \
         str += (opA == rocsparselt_operation_none ? "N" : "T");                        \
         str += "_";                                                                    \
         str += (opB == rocsparselt_operation_none ? "N" : "T");                        \
+        if(!sparseA)                                                                   \
+            str += "_SPB";                                                             \
         return str;                                                                    \
     }                                                                                  \
     template rocsparselt_status runContractionProblem<Ti, To, Tc>(                     \
-        const RocsparseltContractionProblem<Ti, To, Tc>&, int*, const int, const int); \
-    template rocsparselt_status initSolutions<Ti, To, Tc>(                             \
-        const _rocsparselt_handle*, rocsparselt_operation, rocsparselt_operation, int*);
+        const RocsparseltContractionProblem<Ti, To, Tc>&,                              \
+        _rocsparselt_matmul_config*,                                                   \
+        int*,                                                                          \
+        const int,                                                                     \
+        const int,                                                                     \
+        const bool,                                                                    \
+        rocsparselt_matmul_search_result*,                                             \
+        _rocsparselt_solution_cache*);                                                 \
+    template rocsparselt_status initSolutions<Ti, To, Tc>(const _rocsparselt_handle*,  \
+                                                          rocsparselt_operation,       \
+                                                          rocsparselt_operation,       \
+                                                          bool,                        \
+                                                          size_t,                      \
+                                                          size_t,                      \
+                                                          size_t,                      \
+                                                          size_t,                      \
+                                                          int,                         \
+                                                          int,                         \
+                                                          _rocsparselt_matmul_config*, \
+                                                          int*);
 
 GENERATE_DEFINITIONS(__half, __half, float, "4_4_0")
 GENERATE_DEFINITIONS(hip_bfloat16, hip_bfloat16, float, "7_7_0")
 GENERATE_DEFINITIONS(int8_t, int8_t, float, "8_8_0")
+// the int8 kernels compute an int32 D through their float Split-K partial sums
+GENERATE_DEFINITIONS(int8_t, int32_t, float, "8_8_0")
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, __half, float, "11_4_0")
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, hip_bfloat16, float, "11_7_0")
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, float, float, "11_0_0")
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, __half, float, "12_4_0")
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, hip_bfloat16, float, "12_7_0")
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, float, float, "12_0_0")
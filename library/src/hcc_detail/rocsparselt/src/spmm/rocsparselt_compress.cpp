@@ -27,31 +27,38 @@
 #include "definitions.h"
 #include "handle.h"
 #include "hipsparselt_ostream.hpp"
+#include "launch_table.hpp"
 #include "rocsparselt.h"
+#include "rocsparselt_compress.hpp"
+#include "resource_pool.hpp"
+#include "rocsparselt_pad.hpp"
+#include "rocsparselt_sharded.hpp"
 #include "rocsparselt_spmm_utils.hpp"
+#include "tracing.hpp"
 #include "utility.hpp"
 
+#include <atomic>
 #include <hip/hip_runtime_api.h>
 
 template <typename Ti, int SG0I, int SG1J, int TT0I, int TT1J>
-__global__ void compress_kernel(const Ti*      in,
-                                Ti*            out,
-                                unsigned char* metadata,
-                                int64_t        m,
-                                int64_t        n,
-                                int64_t        stride1,
-                                int64_t        stride2,
-                                int64_t        batch_stride,
-                                int64_t        c_stride1,
-                                int64_t        c_stride2,
-                                int64_t        c_batch_stride,
-                                int64_t        m_stride1,
-                                int64_t        m_stride2,
-                                int64_t        m_batch_stride,
-                                int            num_batches,
-                                int64_t        sizes,
-                                int64_t        c_sizes,
-                                int64_t        m_sizes)
+__device__ inline void compress_block(const Ti*      in,
+                                      Ti*            out,
+                                      unsigned char* metadata,
+                                      int64_t        m,
+                                      int64_t        n,
+                                      int64_t        stride1,
+                                      int64_t        stride2,
+                                      int64_t        batch_stride,
+                                      int64_t        c_stride1,
+                                      int64_t        c_stride2,
+                                      int64_t        c_batch_stride,
+                                      int64_t        m_stride1,
+                                      int64_t        m_stride2,
+                                      int64_t        m_batch_stride,
+                                      int64_t        sizes,
+                                      int64_t        wg0I, // M / MT0I
+                                      int64_t        wg1J, // N / MT0J
+                                      int64_t        batchId)
 {
     constexpr int metadata_tiles_y = 8;
     constexpr int tiles_y          = 4;
@@ -63,10 +70,6 @@ __global__ void compress_kernel(const Ti*      in,
     unsigned int sg0I   = serial % SG0I;
     unsigned int sg1J   = serial / SG0I;
 
-    unsigned int wg0I    = hc_get_group_id(0); // M / MT0I
-    unsigned int wg1J    = hc_get_group_id(1); // N / MT0J
-    unsigned int batchId = hc_get_group_id(2);
-
     if((MT1J * wg1J + sg1J * TT1J) >= n || (MT0I * wg0I + sg0I * TT0I) >= m)
         return;
 
@@ -96,38 +99,17 @@ __global__ void compress_kernel(const Ti*      in,
         {
             int64_t offset = globalReadOffset + i * stride1 + j * stride2;
 
-            Ti            values[] = {static_cast<Ti>(0.0f),
-                                      static_cast<Ti>(0.0f),
-                                      static_cast<Ti>(0.0f),
-                                      static_cast<Ti>(0.0f)};
-            unsigned char md       = 0xEE;
-
-            for(int t = 0; t < metadata_tiles_y / tiles_y; t++)
+            Ti in_values[metadata_tiles_y];
+#pragma unroll
+            for(int k = 0; k < metadata_tiles_y; k++)
             {
-                int m_idx = 0;
-                for(int k = 0; k < tiles_y; k++)
-                {
-                    int64_t pos = offset + (k + t * tiles_y) * stride2;
-                    //TODO pos is always lower than sizes by pre-conditions, maybe can remove this check.
-                    if(pos > sizes)
-                        break;
-
-                    Ti value = in[pos];
-                    if(value != static_cast<Ti>(0.0f))
-                    {
-                        if(m_idx == 0 && k == 3)
-                            m_idx++;
-                        auto midx    = m_idx + t * (tiles_y >> 1);
-                        values[midx] = value;
-                        auto shift   = midx << 1;
-                        md           = (md & (~(0x03 << shift))) | ((k & 0x03) << shift);
-                        m_idx++;
-                        if(m_idx > 1)
-                            break;
-                    }
-                }
+                int64_t pos  = offset + k * stride2;
+                in_values[k] = pos < sizes ? in[pos] : static_cast<Ti>(0.0f);
             }
 
+            Ti            values[tiles_y];
+            unsigned char md = compress_2_4_x8(in_values, values);
+
             int64_t c_offset = globalWriteOffset + i * c_stride1 + (j >> 1) * c_stride2;
 #pragma unroll
             for(int k = 0; k < tiles_y; k++)
@@ -141,6 +123,294 @@ __global__ void compress_kernel(const Ti*      in,
     }
 }
 
+// the blocks_x x blocks_y tiles of every batch are visited by a grid-stride loop, see
+// grid_stride_blocks()
+template <typename Ti, int SG0I, int SG1J, int TT0I, int TT1J>
+__global__ void compress_kernel(const Ti*      in,
+                                Ti*            out,
+                                unsigned char* metadata,
+                                int64_t        m,
+                                int64_t        n,
+                                int64_t        stride1,
+                                int64_t        stride2,
+                                int64_t        batch_stride,
+                                int64_t        c_stride1,
+                                int64_t        c_stride2,
+                                int64_t        c_batch_stride,
+                                int64_t        m_stride1,
+                                int64_t        m_stride2,
+                                int64_t        m_batch_stride,
+                                int            num_batches,
+                                int64_t        sizes,
+                                int64_t        c_sizes,
+                                int64_t        m_sizes,
+                                int64_t        blocks_x,
+                                int64_t        blocks_y)
+{
+    const int64_t blocks = blocks_x * blocks_y;
+    for(int64_t tile = hc_get_group_id(0); tile < blocks * num_batches; tile += gridDim.x)
+        compress_block<Ti, SG0I, SG1J, TT0I, TT1J>(in,
+                                                   out,
+                                                   metadata,
+                                                   m,
+                                                   n,
+                                                   stride1,
+                                                   stride2,
+                                                   batch_stride,
+                                                   c_stride1,
+                                                   c_stride2,
+                                                   c_batch_stride,
+                                                   m_stride1,
+                                                   m_stride2,
+                                                   m_batch_stride,
+                                                   sizes,
+                                                   tile % blocks_x,
+                                                   tile % blocks / blocks_x,
+                                                   tile / blocks);
+}
+
+// compress all the matrices of a work list, the workgroups of every matrix are laid out along x.
+template <typename Ti, int SG0I, int SG1J, int TT0I, int TT1J>
+__global__ void compress_grouped_kernel(const rocsparselt_grouped_work* works, int count)
+{
+    const int64_t                   block = hc_get_group_id(0);
+    const rocsparselt_grouped_work* work  = grouped_work_find(works, count, block);
+
+    const int64_t local  = block - work->block_start;
+    const int64_t blocks = static_cast<int64_t>(work->blocks_x) * work->blocks_y;
+    compress_block<Ti, SG0I, SG1J, TT0I, TT1J>(reinterpret_cast<const Ti*>(work->in),
+                                               reinterpret_cast<Ti*>(work->out),
+                                               work->metadata,
+                                               work->m,
+                                               work->n,
+                                               work->stride1,
+                                               work->stride2,
+                                               work->batch_stride,
+                                               work->c_stride1,
+                                               work->c_stride2,
+                                               work->c_batch_stride,
+                                               work->m_stride1,
+                                               work->m_stride2,
+                                               work->m_batch_stride,
+                                               work->num_batches * work->batch_stride,
+                                               local % work->blocks_x,
+                                               local % blocks / work->blocks_x,
+                                               local / blocks);
+}
+
+// k is contiguous: each thread compresses 32 bytes of a row, read with two 128-bit loads, and
+// stores its 16 bytes of values and its metadata bytes with one write each.
+template <typename Ti, int SG0I, int SG1J>
+__device__ inline void compress_vec_k_block(const Ti*      in,
+                                            Ti*            out,
+                                            unsigned char* metadata,
+                                            int64_t        m,
+                                            int64_t        n,
+                                            int64_t        stride1,
+                                            int64_t        batch_stride,
+                                            int64_t        c_stride1,
+                                            int64_t        c_batch_stride,
+                                            int64_t        m_stride1,
+                                            int64_t        m_batch_stride,
+                                            int64_t        wg0I,
+                                            int64_t        wg1J,
+                                            int64_t        batchId)
+{
+    constexpr int TT1J     = 32 / sizeof(Ti);
+    constexpr int MD_BYTES = TT1J / 8;
+
+    unsigned int serial = hc_get_workitem_id(0);
+    unsigned int sg1J   = serial % SG1J; // neighbouring threads read neighbouring chunks
+    unsigned int sg0I   = serial / SG1J;
+
+    int64_t row = SG0I * wg0I + sg0I;
+    int64_t col = (SG1J * wg1J + sg1J) * TT1J;
+    if(row >= m || col >= n)
+        return;
+
+    const uint4* src
+        = reinterpret_cast<const uint4*>(in + batchId * batch_stride + row * stride1 + col);
+    uint4     raw[2] = {src[0], src[1]};
+    const Ti* vals   = reinterpret_cast<const Ti*>(raw);
+
+    uint4    c_raw;
+    Ti*      c_vals = reinterpret_cast<Ti*>(&c_raw);
+    uint32_t md     = 0;
+#pragma unroll
+    for(int g = 0; g < MD_BYTES; g++)
+    {
+        Ti in_values[8];
+#pragma unroll
+        for(int k = 0; k < 8; k++)
+            in_values[k] = vals[g * 8 + k];
+
+        Ti values[4];
+        md |= static_cast<uint32_t>(compress_2_4_x8(in_values, values)) << (g * 8);
+#pragma unroll
+        for(int k = 0; k < 4; k++)
+            c_vals[g * 4 + k] = values[k];
+    }
+
+    *reinterpret_cast<uint4*>(out + batchId * c_batch_stride + row * c_stride1 + (col >> 1))
+        = c_raw;
+
+    unsigned char* md_ptr = metadata + batchId * m_batch_stride + row * m_stride1 + (col >> 3);
+    if constexpr(MD_BYTES == 4)
+        *reinterpret_cast<uint32_t*>(md_ptr) = md;
+    else
+        *reinterpret_cast<uint16_t*>(md_ptr) = static_cast<uint16_t>(md);
+}
+
+template <typename Ti, int SG0I, int SG1J>
+__global__ __launch_bounds__(SG0I* SG1J) void compress_kernel_vec_k(const Ti*      in,
+                                                                    Ti*            out,
+                                                                    unsigned char* metadata,
+                                                                    int64_t        m,
+                                                                    int64_t        n,
+                                                                    int64_t        stride1,
+                                                                    int64_t        batch_stride,
+                                                                    int64_t        c_stride1,
+                                                                    int64_t        c_batch_stride,
+                                                                    int64_t        m_stride1,
+                                                                    int64_t        m_batch_stride,
+                                                                    int            num_batches,
+                                                                    int64_t        blocks_x,
+                                                                    int64_t        blocks_y)
+{
+    const int64_t blocks = blocks_x * blocks_y;
+    for(int64_t tile = hc_get_group_id(0); tile < blocks * num_batches; tile += gridDim.x)
+        compress_vec_k_block<Ti, SG0I, SG1J>(in,
+                                             out,
+                                             metadata,
+                                             m,
+                                             n,
+                                             stride1,
+                                             batch_stride,
+                                             c_stride1,
+                                             c_batch_stride,
+                                             m_stride1,
+                                             m_batch_stride,
+                                             tile % blocks_x,
+                                             tile % blocks / blocks_x,
+                                             tile / blocks);
+}
+
+// m is contiguous: each thread compresses the 16 bytes of rows it reads with a 128-bit load for
+// each of 8 k, and the metadata bytes of the workgroup are transposed through LDS so that every
+// row of metadata is stored with one 8-byte write instead of 8 scattered bytes.
+template <typename Ti, int SG0I, int SG1J>
+__device__ inline void compress_vec_m_block(const Ti*      in,
+                                            Ti*            out,
+                                            unsigned char* metadata,
+                                            int64_t        m,
+                                            int64_t        n,
+                                            int64_t        stride2,
+                                            int64_t        batch_stride,
+                                            int64_t        c_stride2,
+                                            int64_t        c_batch_stride,
+                                            int64_t        m_stride1,
+                                            int64_t        m_batch_stride,
+                                            int64_t        wg0I,
+                                            int64_t        wg1J,
+                                            int64_t        batchId)
+{
+    static_assert(SG1J == 8, "a row of metadata in LDS is read as one uint2");
+    constexpr int TT0I = 16 / sizeof(Ti);
+    constexpr int MT0I = SG0I * TT0I;
+
+    __shared__ uint2 md_lds[MT0I];
+    unsigned char*   md_bytes = reinterpret_cast<unsigned char*>(md_lds);
+
+    unsigned int serial = hc_get_workitem_id(0);
+    unsigned int sg0I   = serial % SG0I;
+    unsigned int sg1J   = serial / SG0I;
+
+    int64_t row0 = MT0I * wg0I + sg0I * TT0I;
+    int64_t col0 = SG1J * wg1J * 8;
+    int64_t col  = col0 + sg1J * 8;
+
+    if(row0 < m && col < n)
+    {
+        const Ti* src = in + batchId * batch_stride + row0 + col * stride2;
+        uint4     raw[8];
+#pragma unroll
+        for(int k = 0; k < 8; k++)
+            raw[k] = *reinterpret_cast<const uint4*>(src + k * stride2);
+
+        uint4 c_raw[4];
+#pragma unroll
+        for(int r = 0; r < TT0I; r++)
+        {
+            Ti in_values[8];
+#pragma unroll
+            for(int k = 0; k < 8; k++)
+                in_values[k] = reinterpret_cast<const Ti*>(&raw[k])[r];
+
+            Ti values[4];
+            md_bytes[(sg0I * TT0I + r) * SG1J + sg1J] = compress_2_4_x8(in_values, values);
+#pragma unroll
+            for(int k = 0; k < 4; k++)
+                reinterpret_cast<Ti*>(&c_raw[k])[r] = values[k];
+        }
+
+        Ti* dst = out + batchId * c_batch_stride + row0 + (col >> 1) * c_stride2;
+#pragma unroll
+        for(int k = 0; k < 4; k++)
+            *reinterpret_cast<uint4*>(dst + k * c_stride2) = c_raw[k];
+    }
+    __syncthreads(); // wait until md_lds[] ready
+
+    int64_t cols = min(static_cast<int64_t>(SG1J), (n - col0) >> 3);
+    for(int r = serial; r < MT0I; r += SG0I * SG1J)
+    {
+        int64_t row = MT0I * wg0I + r;
+        if(row >= m)
+            break;
+        unsigned char* md_ptr = metadata + batchId * m_batch_stride + row * m_stride1 + (col0 >> 3);
+        if(cols == SG1J)
+            *reinterpret_cast<uint2*>(md_ptr) = md_lds[r];
+        else
+            for(int k = 0; k < cols; k++)
+                md_ptr[k] = md_bytes[r * SG1J + k];
+    }
+    __syncthreads(); // md_lds[] is written again by the next tile of the workgroup
+}
+
+template <typename Ti, int SG0I, int SG1J>
+__global__ __launch_bounds__(SG0I* SG1J) void compress_kernel_vec_m(const Ti*      in,
+                                                                    Ti*            out,
+                                                                    unsigned char* metadata,
+                                                                    int64_t        m,
+                                                                    int64_t        n,
+                                                                    int64_t        stride2,
+                                                                    int64_t        batch_stride,
+                                                                    int64_t        c_stride2,
+                                                                    int64_t        c_batch_stride,
+                                                                    int64_t        m_stride1,
+                                                                    int64_t        m_batch_stride,
+                                                                    int            num_batches,
+                                                                    int64_t        blocks_x,
+                                                                    int64_t        blocks_y)
+{
+    // the loop is uniform across the workgroup, for the barriers of the block
+    const int64_t blocks = blocks_x * blocks_y;
+    for(int64_t tile = hc_get_group_id(0); tile < blocks * num_batches; tile += gridDim.x)
+        compress_vec_m_block<Ti, SG0I, SG1J>(in,
+                                             out,
+                                             metadata,
+                                             m,
+                                             n,
+                                             stride2,
+                                             batch_stride,
+                                             c_stride2,
+                                             c_batch_stride,
+                                             m_stride1,
+                                             m_batch_stride,
+                                             tile % blocks_x,
+                                             tile % blocks / blocks_x,
+                                             tile / blocks);
+}
+
 template <typename Ti>
 rocsparselt_status rocsparselt_smfmac_compress_template(const _rocsparselt_handle* handle,
                                                         int64_t                    m,
@@ -156,11 +426,133 @@ rocsparselt_status rocsparselt_smfmac_compress_template(const _rocsparselt_handl
                                                         int64_t                    m_batch_stride,
                                                         int                        num_batches,
                                                         rocsparselt_order          order,
+                                                        rocsparselt_datatype       type,
                                                         const Ti*                  d_in,
                                                         Ti*                        d_out,
                                                         unsigned char*             d_metadata,
                                                         hipStream_t                stream)
 {
+    auto aligned = [](const void* p, size_t bytes) {
+        return reinterpret_cast<uintptr_t>(p) % bytes == 0;
+    };
+    auto aligned_elems
+        = [](int64_t elems, size_t bytes) { return elems * sizeof(Ti) % bytes == 0; };
+
+    // the vectorized kernels run 4, 2 or 8 wavefronts per workgroup, the variants of
+    // launch_table.hpp, 4 wavefronts are 256 threads on wave64 and 128 threads on wave32 archs.
+    static constexpr int waves_of_variant[] = {4, 2, 8};
+
+    int waves   = waves_of_variant[rocsparselt_launch_variant(
+        handle, rocsparselt_launch_kernel::compress, type, stride1 == 1)];
+    int threads = waves * handle->wavefront_size;
+
+    constexpr int VEC_K_TT1J     = 32 / sizeof(Ti);
+    constexpr int VEC_K_MD_BYTES = VEC_K_TT1J / 8;
+    if(stride1 == 1 && c_stride1 == 1 && m_stride1 == 1 && n % VEC_K_TT1J == 0
+       && aligned(d_in, 16) && aligned(d_out, 16) && aligned(d_metadata, VEC_K_MD_BYTES)
+       && aligned_elems(stride0, 16) && aligned_elems(batch_stride, 16)
+       && aligned_elems(c_stride0, 16) && aligned_elems(c_batch_stride, 16)
+       && m_stride0 % VEC_K_MD_BYTES == 0 && m_batch_stride % VEC_K_MD_BYTES == 0)
+    {
+        constexpr int SG1J = 16;
+        int           SG0I = threads / SG1J;
+
+        decltype(&compress_kernel_vec_k<Ti, 16, SG1J>) func;
+        switch(SG0I)
+        {
+        case 4:
+            func = compress_kernel_vec_k<Ti, 4, SG1J>;
+            break;
+        case 8:
+            func = compress_kernel_vec_k<Ti, 8, SG1J>;
+            break;
+        case 32:
+            func = compress_kernel_vec_k<Ti, 32, SG1J>;
+            break;
+        default:
+            func = compress_kernel_vec_k<Ti, 16, SG1J>;
+            break;
+        }
+
+        int64_t block_x = m / SG0I + (m % SG0I > 0 ? 1 : 0);
+        int64_t block_y = n / (SG1J * VEC_K_TT1J) + (n % (SG1J * VEC_K_TT1J) > 0 ? 1 : 0);
+        int64_t blocks  = grid_stride_blocks(handle, block_x * block_y * num_batches, threads);
+        hipLaunchKernelGGL(func,
+                           dim3(blocks),
+                           dim3(SG0I * SG1J),
+                           0 /*dynamic shared*/,
+                           stream,
+                           d_in,
+                           d_out,
+                           d_metadata,
+                           m,
+                           n,
+                           stride0,
+                           batch_stride,
+                           c_stride0,
+                           c_batch_stride,
+                           m_stride0,
+                           m_batch_stride,
+                           num_batches,
+                           block_x,
+                           block_y);
+        return rocsparselt_status_success;
+    }
+
+    constexpr int VEC_M_TT0I = 16 / sizeof(Ti);
+    if(stride0 == 1 && c_stride0 == 1 && m_stride1 == 1 && m % VEC_M_TT0I == 0 && n % 8 == 0
+       && aligned(d_in, 16) && aligned(d_out, 16) && aligned(d_metadata, 8)
+       && aligned_elems(stride1, 16) && aligned_elems(batch_stride, 16)
+       && aligned_elems(c_stride1, 16) && aligned_elems(c_batch_stride, 16) && m_stride0 % 8 == 0
+       && m_batch_stride % 8 == 0)
+    {
+        constexpr int SG1J = 8;
+        int           SG0I = threads / SG1J;
+        int           MT0I = SG0I * VEC_M_TT0I;
+
+        decltype(&compress_kernel_vec_m<Ti, 32, SG1J>) func;
+        switch(SG0I)
+        {
+        case 8:
+            func = compress_kernel_vec_m<Ti, 8, SG1J>;
+            break;
+        case 16:
+            func = compress_kernel_vec_m<Ti, 16, SG1J>;
+            break;
+        case 64:
+            func = compress_kernel_vec_m<Ti, 64, SG1J>;
+            break;
+        default:
+            func = compress_kernel_vec_m<Ti, 32, SG1J>;
+            break;
+        }
+
+        int64_t block_x = m / MT0I + (m % MT0I > 0 ? 1 : 0);
+        int64_t block_y = n / (SG1J * 8) + (n % (SG1J * 8) > 0 ? 1 : 0);
+        int64_t blocks  = grid_stride_blocks(handle, block_x * block_y * num_batches, threads);
+        hipLaunchKernelGGL(func,
+                           dim3(blocks),
+                           dim3(SG0I * SG1J),
+                           0 /*dynamic shared*/,
+                           stream,
+                           d_in,
+                           d_out,
+                           d_metadata,
+                           m,
+                           n,
+                           stride1,
+                           batch_stride,
+                           c_stride1,
+                           c_batch_stride,
+                           m_stride0,
+                           m_batch_stride,
+                           num_batches,
+                           block_x,
+                           block_y);
+        return rocsparselt_status_success;
+    }
+
+    // unaligned or odd sized matrices.
     constexpr int SG0I = 16;
     constexpr int SG1J = 2;
     constexpr int TT0I = 1;
@@ -168,10 +560,11 @@ rocsparselt_status rocsparselt_smfmac_compress_template(const _rocsparselt_handl
     constexpr int MT0I = SG0I * TT0I;
     constexpr int MT1J = SG1J * TT1J;
 
-    int block_x = m / MT0I + (m % MT0I > 0 ? 1 : 0);
-    int block_y = n / MT1J + (n % MT1J > 0 ? 1 : 0);
+    int64_t block_x = m / MT0I + (m % MT0I > 0 ? 1 : 0);
+    int64_t block_y = n / MT1J + (n % MT1J > 0 ? 1 : 0);
+    int64_t blocks  = grid_stride_blocks(handle, block_x * block_y * num_batches, SG0I * SG1J);
     hipLaunchKernelGGL((compress_kernel<Ti, SG0I, SG1J, TT0I, TT1J>), /* compute kernel*/
-                       dim3(block_x, block_y, num_batches),
+                       dim3(blocks),
                        dim3(SG0I * SG1J),
                        0 /*dynamic shared*/,
                        stream,
@@ -192,7 +585,44 @@ rocsparselt_status rocsparselt_smfmac_compress_template(const _rocsparselt_handl
                        num_batches,
                        num_batches * batch_stride,
                        num_batches * c_batch_stride,
-                       num_batches * m_batch_stride);
+                       num_batches * m_batch_stride,
+                       block_x,
+                       block_y);
+    return rocsparselt_status_success;
+}
+
+template <typename Ti>
+rocsparselt_status
+    rocsparselt_smfmac_compress_grouped_template(std::vector<rocsparselt_grouped_work>& works,
+                                                 void*                                  d_works,
+                                                 hipStream_t                            stream)
+{
+    // the matrices of a group do not share their alignment, use the generic kernel.
+    constexpr int SG0I = 16;
+    constexpr int SG1J = 2;
+    constexpr int TT0I = 1;
+    constexpr int TT1J = 8; //must be the multiplication of 8.
+    constexpr int MT0I = SG0I * TT0I;
+    constexpr int MT1J = SG1J * TT1J;
+
+    for(auto& work : works)
+    {
+        work.blocks_x = work.m / MT0I + (work.m % MT0I > 0 ? 1 : 0);
+        work.blocks_y = work.n / MT1J + (work.n % MT1J > 0 ? 1 : 0);
+    }
+
+    int64_t blocks;
+    RETURN_IF_ROCSPARSELT_ERROR(grouped_work_upload(works, d_works, blocks, stream));
+    if(blocks == 0)
+        return rocsparselt_status_success;
+
+    hipLaunchKernelGGL((compress_grouped_kernel<Ti, SG0I, SG1J, TT0I, TT1J>), /* compute kernel*/
+                       dim3(blocks),
+                       dim3(SG0I * SG1J),
+                       0 /*dynamic shared*/,
+                       stream,
+                       reinterpret_cast<const rocsparselt_grouped_work*>(d_works),
+                       static_cast<int>(works.size()));
     return rocsparselt_status_success;
 }
 
@@ -214,17 +644,19 @@ rocsparselt_status rocsparselt_smfmac_compress_impl(const _rocsparselt_handle*
                                                     void*                         d_ws,
                                                     hipStream_t                   stream)
 {
+    rocsparselt_trace_span     trace("compress", stream);
+    rocsparselt_trace_gpu_span gpu_trace("compress", stream);
 
     rocsparselt_order    order = matrix->order;
     rocsparselt_datatype type  = matrix->type;
 
     int     num_batches  = matrix->num_batches;
     int64_t batch_stride = matrix->batch_stride;
-    //set number of batches to 1, since we only care the first batch under the boradcast case.
+    // a broadcast matrix only stores its first batch
     if(batch_stride == 0)
     {
         num_batches  = 1;
-        batch_stride = matrix->n * ld;
+        batch_stride = rocsparselt_matrix_elems(matrix, ld);
     }
 
     unsigned char* d_metadata = reinterpret_cast<unsigned char*>(d_out)
@@ -233,7 +665,7 @@ rocsparselt_status rocsparselt_smfmac_compress_impl(const _rocsparselt_handle*
 
 #define COMPRESS_PARAMS(T)                                                                         \
     handle, m, n, stride0, stride1, batch_stride, c_stride0, c_stride1, c_batch_stride, m_stride0, \
-        m_stride1, m_batch_stride, num_batches, order, reinterpret_cast<const T*>(d_in),           \
+        m_stride1, m_batch_stride, num_batches, order, type, reinterpret_cast<const T*>(d_in),     \
         reinterpret_cast<T*>(d_out), d_metadata, stream
 
     switch(type)
@@ -243,6 +675,9 @@ rocsparselt_status rocsparselt_smfmac_compress_impl(const _rocsparselt_handle*
     case rocsparselt_datatype_bf16_r:
         return rocsparselt_smfmac_compress_template<hip_bfloat16>(COMPRESS_PARAMS(hip_bfloat16));
     case rocsparselt_datatype_i8_r:
+    // compressing only moves bytes and tests for zero, which FP8 shares with int8
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
         return rocsparselt_smfmac_compress_template<int8_t>(COMPRESS_PARAMS(int8_t));
     default:
         log_error(handle,
@@ -254,6 +689,534 @@ rocsparselt_status rocsparselt_smfmac_compress_impl(const _rocsparselt_handle*
     }
 }
 
+// fill the work of a whole structured matrix, in the k-contiguous view of the compress kernels.
+void compress_grouped_work_init(const _rocsparselt_mat_descr* matrix,
+                                int                           isSparseA,
+                                rocsparselt_operation         op,
+                                const void*                   d_in,
+                                void*                         d_out,
+                                rocsparselt_grouped_work&     work)
+{
+    int64_t stride0, stride1, c_stride0, c_stride1;
+    get_compress_matrix_size(isSparseA,
+                             op,
+                             const_cast<_rocsparselt_mat_descr*>(matrix),
+                             work.m,
+                             work.n,
+                             stride0,
+                             stride1,
+                             c_stride0,
+                             c_stride1);
+
+    work.num_batches  = matrix->num_batches;
+    work.batch_stride = matrix->batch_stride;
+    //set number of batches to 1, since we only care the first batch under the boradcast case.
+    if(work.batch_stride == 0)
+    {
+        work.num_batches  = 1;
+        work.batch_stride = rocsparselt_matrix_elems(matrix, matrix->ld);
+    }
+
+    int64_t metadata_offset = rocsparselt_metadata_offset_in_compressed_matrix(
+        matrix->c_n, matrix->c_ld, work.num_batches, matrix->type);
+
+    work.in             = d_in;
+    work.out            = d_out;
+    work.metadata       = reinterpret_cast<unsigned char*>(d_out) + metadata_offset;
+    work.stride1        = stride0;
+    work.stride2        = stride1;
+    work.c_stride1      = c_stride0;
+    work.c_stride2      = c_stride1;
+    work.c_batch_stride = matrix->c_ld * matrix->c_n;
+    work.m_stride1      = matrix->c_k / 4;
+    work.m_stride2      = 1;
+    work.m_batch_stride = matrix->c_ld * matrix->c_n / 4;
+}
+
+rocsparselt_status compress_grouped_dispatch(const _rocsparselt_handle*             handle,
+                                             const char*                            caller,
+                                             rocsparselt_datatype                   type,
+                                             std::vector<rocsparselt_grouped_work>& works,
+                                             void*                                  d_workList,
+                                             hipStream_t                            stream)
+{
+    switch(type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return rocsparselt_smfmac_compress_grouped_template<__half>(works, d_workList, stream);
+    case rocsparselt_datatype_bf16_r:
+        return rocsparselt_smfmac_compress_grouped_template<hip_bfloat16>(
+            works, d_workList, stream);
+    case rocsparselt_datatype_i8_r:
+    // compressing only moves bytes and tests for zero, which FP8 shares with int8
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
+        return rocsparselt_smfmac_compress_grouped_template<int8_t>(works, d_workList, stream);
+    default:
+        log_error(
+            handle, caller, "datatype", rocsparselt_datatype_to_string(type), "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+rocsparselt_status rocsparselt_smfmac_compress_grouped_impl(
+    const _rocsparselt_handle*                        handle,
+    const std::vector<const _rocsparselt_mat_descr*>& descrs,
+    int                                               isSparseA,
+    rocsparselt_operation                             op,
+    const void* const*                                d_in,
+    void* const*                                      d_out,
+    void*                                             d_workList,
+    hipStream_t                                       stream)
+{
+    if(descrs.empty())
+        return rocsparselt_status_success;
+
+    std::vector<rocsparselt_grouped_work> works(descrs.size());
+    for(size_t i = 0; i < descrs.size(); i++)
+        compress_grouped_work_init(descrs[i], isSparseA, op, d_in[i], d_out[i], works[i]);
+
+    return compress_grouped_dispatch(handle,
+                                     "rocsparselt_smfmac_compress2_grouped",
+                                     descrs[0]->type,
+                                     works,
+                                     d_workList,
+                                     stream);
+}
+
+/*******************************************************************************
+ * Recompress the rows [begin, end) of every range. A row of the k-contiguous
+ * view is independent of the others in the values and in the metadata, so each
+ * range is a work of the grouped kernel whose pointers start at its first row,
+ * and all the ranges go in one launch.
+ ******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_compress_rows_impl(const _rocsparselt_handle*    handle,
+                                                         const _rocsparselt_mat_descr* matrix,
+                                                         int                           isSparseA,
+                                                         rocsparselt_operation         op,
+                                                         const void*                   d_in,
+                                                         void*                         d_out,
+                                                         int                           rangeCount,
+                                                         const int64_t*                rowRanges,
+                                                         void*                         d_workList,
+                                                         hipStream_t                   stream)
+{
+    rocsparselt_grouped_work whole;
+    compress_grouped_work_init(matrix, isSparseA, op, d_in, d_out, whole);
+
+    int64_t bytes = rocsparselt_datatype_bytes(matrix->type);
+
+    std::vector<rocsparselt_grouped_work> works;
+    works.reserve(rangeCount);
+    for(int i = 0; i < rangeCount; i++)
+    {
+        int64_t begin = rowRanges[2 * i];
+        int64_t end   = rowRanges[2 * i + 1];
+        if(begin < 0 || end > whole.m || begin > end)
+        {
+            log_error(handle, "rocsparselt_smfmac_compress_rows", "range", i, "is invalid");
+            return rocsparselt_status_invalid_size;
+        }
+        if(begin == end)
+            continue;
+
+        rocsparselt_grouped_work work = whole;
+        work.in       = reinterpret_cast<const char*>(d_in) + begin * whole.stride1 * bytes;
+        work.out      = reinterpret_cast<char*>(d_out) + begin * whole.c_stride1 * bytes;
+        work.metadata = whole.metadata + begin * whole.m_stride1;
+        work.m        = end - begin;
+        works.push_back(work);
+    }
+    if(works.empty())
+        return rocsparselt_status_success;
+
+    return compress_grouped_dispatch(
+        handle, "rocsparselt_smfmac_compress_rows", matrix->type, works, d_workList, stream);
+}
+
+/*******************************************************************************
+ * Compress a matrix whose dense values are not resident in device memory, in
+ * panels of rows of the k-contiguous view. The panels go through the two
+ * halves of d_panelBuffer in turn: a panel is copied into one half on a stream
+ * of the pool while the previous one is compressed from the other half on
+ * stream, straight to its final offsets in d_compressed. Only the compressed
+ * matrix and the buffer are resident, whatever the size of the dense matrix.
+ ******************************************************************************/
+template <typename Ti>
+rocsparselt_status
+    rocsparselt_smfmac_compress_streamed_template(const _rocsparselt_handle*    handle,
+                                                  const _rocsparselt_mat_descr* matrix,
+                                                  int                           isSparseA,
+                                                  rocsparselt_operation         op,
+                                                  const void*                   dense,
+                                                  void*                         d_compressed,
+                                                  void*                         d_panelBuffer,
+                                                  size_t                        panelBufferSize,
+                                                  const rocsparselt_prune_alg*  pruneAlg,
+                                                  float*                        bandwidth,
+                                                  hipStream_t                   stream)
+{
+    const char* func_name = pruneAlg != nullptr ? "rocsparselt_smfmac_prune_and_compress_streamed"
+                                                : "rocsparselt_smfmac_compress2_streamed";
+    int64_t     m, n, stride0, stride1, c_stride0, c_stride1;
+    get_compress_matrix_size(isSparseA,
+                             op,
+                             const_cast<_rocsparselt_mat_descr*>(matrix),
+                             m,
+                             n,
+                             stride0,
+                             stride1,
+                             c_stride0,
+                             c_stride1);
+    int64_t m_stride0 = matrix->c_k / 4;
+    int64_t m_stride1 = 1;
+
+    int     num_batches  = matrix->num_batches;
+    int64_t batch_stride = matrix->batch_stride;
+    // a broadcast matrix only stores its first batch
+    if(batch_stride == 0)
+    {
+        num_batches  = 1;
+        batch_stride = rocsparselt_matrix_elems(matrix, matrix->ld);
+    }
+    int64_t c_batch_stride = matrix->c_ld * matrix->c_n;
+    int64_t m_batch_stride = matrix->c_ld * matrix->c_n / 4;
+
+    Ti*            d_out      = reinterpret_cast<Ti*>(d_compressed);
+    unsigned char* d_metadata = reinterpret_cast<unsigned char*>(d_compressed)
+                                + rocsparselt_metadata_offset_in_compressed_matrix(
+                                    matrix->c_n, matrix->c_ld, num_batches, matrix->type);
+
+    // a buffer which holds three panels of 16 rows is split in three, so that a late copy or
+    // compress does not stall the other stream, a smaller one in two
+    int     slots      = panelBufferSize >= 3 * 16 * n * sizeof(Ti) ? 3 : 2;
+    int64_t panel_rows = static_cast<int64_t>(panelBufferSize / slots / (n * sizeof(Ti)));
+    // the rows of a panel are packed, a multiple of 16 of them keeps the vectorized kernels,
+    // and the tile prune needs whole tiles of 4 rows
+    if(panel_rows >= 16)
+        panel_rows -= panel_rows % 16;
+    else if(pruneAlg != nullptr && *pruneAlg == rocsparselt_prune_smfmac_tile)
+        panel_rows -= panel_rows % 4;
+    int64_t rows = std::min(panel_rows, m);
+    if(rows == 0)
+    {
+        log_error(
+            handle, func_name, "panelBufferSize", panelBufferSize, "is too small for two panels");
+        return rocsparselt_status_invalid_size;
+    }
+
+    rocsparselt_pooled_stream copy_stream(handle->resource_pool);
+    rocsparselt_pooled_event  ready(handle->resource_pool, true);
+    rocsparselt_pooled_event  done(handle->resource_pool, true);
+    rocsparselt_pooled_event  copied_0(handle->resource_pool);
+    rocsparselt_pooled_event  copied_1(handle->resource_pool);
+    rocsparselt_pooled_event  copied_2(handle->resource_pool);
+    rocsparselt_pooled_event  compressed_0(handle->resource_pool);
+    rocsparselt_pooled_event  compressed_1(handle->resource_pool);
+    rocsparselt_pooled_event  compressed_2(handle->resource_pool);
+    RETURN_IF_HIP_ERROR(copy_stream.acquire());
+    RETURN_IF_HIP_ERROR(ready.acquire());
+    RETURN_IF_HIP_ERROR(done.acquire());
+    RETURN_IF_HIP_ERROR(copied_0.acquire());
+    RETURN_IF_HIP_ERROR(copied_1.acquire());
+    RETURN_IF_HIP_ERROR(copied_2.acquire());
+    RETURN_IF_HIP_ERROR(compressed_0.acquire());
+    RETURN_IF_HIP_ERROR(compressed_1.acquire());
+    RETURN_IF_HIP_ERROR(compressed_2.acquire());
+    hipEvent_t copied[3]     = {copied_0, copied_1, copied_2};
+    hipEvent_t compressed[3] = {compressed_0, compressed_1, compressed_2};
+
+    // the buffer may still be read by the work queued on stream before
+    RETURN_IF_HIP_ERROR(hipEventRecord(ready, stream));
+    RETURN_IF_HIP_ERROR(hipStreamWaitEvent(copy_stream, ready, 0));
+
+    const char* src   = reinterpret_cast<const char*>(dense);
+    int64_t     panel = 0;
+    for(int b = 0; b < num_batches; b++)
+    {
+        for(int64_t begin = 0; begin < m; begin += rows, panel++)
+        {
+            int64_t count = std::min(rows, m - begin);
+            int     slot  = panel % slots;
+            Ti*     d_in  = reinterpret_cast<Ti*>(d_panelBuffer) + slot * rows * n;
+
+            // the slot is free once the panel compressed from it slots panels ago is done
+            if(panel >= slots)
+                RETURN_IF_HIP_ERROR(hipStreamWaitEvent(copy_stream, compressed[slot], 0));
+
+            // a panel holds count rows of n elements, copied as a 2D block: the rows are the
+            // contiguous dimension of the dense matrix (stride0 == 1) or its columns
+            const char* panel_src = src + (b * batch_stride + begin * stride0) * sizeof(Ti);
+            int64_t     p_stride0 = stride0 == 1 ? 1 : n;
+            int64_t     p_stride1 = stride0 == 1 ? count : 1;
+            if(stride0 == 1)
+                RETURN_IF_HIP_ERROR(hipMemcpy2DAsync(d_in,
+                                                     count * sizeof(Ti),
+                                                     panel_src,
+                                                     stride1 * sizeof(Ti),
+                                                     count * sizeof(Ti),
+                                                     n,
+                                                     hipMemcpyDefault,
+                                                     copy_stream));
+            else
+                RETURN_IF_HIP_ERROR(hipMemcpy2DAsync(d_in,
+                                                     n * sizeof(Ti),
+                                                     panel_src,
+                                                     stride0 * sizeof(Ti),
+                                                     n * sizeof(Ti),
+                                                     count,
+                                                     hipMemcpyDefault,
+                                                     copy_stream));
+            RETURN_IF_HIP_ERROR(hipEventRecord(copied[slot], copy_stream));
+
+            RETURN_IF_HIP_ERROR(hipStreamWaitEvent(stream, copied[slot], 0));
+            Ti*            p_out      = d_out + b * c_batch_stride + begin * c_stride0;
+            unsigned char* p_metadata = d_metadata + b * m_batch_stride + begin * m_stride0;
+            auto           status     = rocsparselt_status_success;
+            if(pruneAlg != nullptr)
+                status = rocsparselt_smfmac_prune_compress_panel_impl(handle,
+                                                                      matrix->type,
+                                                                      matrix->order,
+                                                                      count,
+                                                                      n,
+                                                                      p_stride0,
+                                                                      p_stride1,
+                                                                      c_stride0,
+                                                                      c_stride1,
+                                                                      m_stride0,
+                                                                      m_stride1,
+                                                                      d_in,
+                                                                      p_out,
+                                                                      p_metadata,
+                                                                      *pruneAlg,
+                                                                      stream);
+            else
+                status = rocsparselt_smfmac_compress_template<Ti>(handle,
+                                                                  count,
+                                                                  n,
+                                                                  p_stride0,
+                                                                  p_stride1,
+                                                                  count * n,
+                                                                  c_stride0,
+                                                                  c_stride1,
+                                                                  c_batch_stride,
+                                                                  m_stride0,
+                                                                  m_stride1,
+                                                                  m_batch_stride,
+                                                                  1,
+                                                                  matrix->order,
+                                                                  matrix->type,
+                                                                  d_in,
+                                                                  p_out,
+                                                                  p_metadata,
+                                                                  stream);
+            if(status != rocsparselt_status_success)
+                return status;
+            RETURN_IF_HIP_ERROR(hipEventRecord(compressed[slot], stream));
+        }
+    }
+
+    // the rate of the whole pipeline, from the first copy to the last compress, over the bytes
+    // of the dense matrix; measuring it waits for the work on stream
+    if(bandwidth != nullptr)
+    {
+        float ms = 0.f;
+        RETURN_IF_HIP_ERROR(hipEventRecord(done, stream));
+        RETURN_IF_HIP_ERROR(hipEventSynchronize(done));
+        RETURN_IF_HIP_ERROR(hipEventElapsedTime(&ms, ready, done));
+        double bytes = static_cast<double>(num_batches) * m * n * sizeof(Ti);
+        *bandwidth   = ms > 0.f ? static_cast<float>(bytes / (ms * 1.e6)) : 0.f;
+    }
+    return rocsparselt_status_success;
+}
+
+rocsparselt_status
+    rocsparselt_smfmac_compress_streamed_impl(const _rocsparselt_handle*    handle,
+                                              const _rocsparselt_mat_descr* matrix,
+                                              int                           isSparseA,
+                                              rocsparselt_operation         op,
+                                              const void*                   dense,
+                                              void*                         d_compressed,
+                                              void*                         d_panelBuffer,
+                                              size_t                        panelBufferSize,
+                                              const rocsparselt_prune_alg*  pruneAlg,
+                                              float*                        bandwidth,
+                                              hipStream_t                   stream)
+{
+#define COMPRESS_STREAMED_PARAMS                                                                   \
+    handle, matrix, isSparseA, op, dense, d_compressed, d_panelBuffer, panelBufferSize, pruneAlg,  \
+        bandwidth, stream
+
+    switch(matrix->type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return rocsparselt_smfmac_compress_streamed_template<__half>(COMPRESS_STREAMED_PARAMS);
+    case rocsparselt_datatype_bf16_r:
+        return rocsparselt_smfmac_compress_streamed_template<hip_bfloat16>(
+            COMPRESS_STREAMED_PARAMS);
+    case rocsparselt_datatype_i8_r:
+    // compressing only moves bytes and tests for zero, which FP8 shares with int8
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
+        return rocsparselt_smfmac_compress_streamed_template<int8_t>(COMPRESS_STREAMED_PARAMS);
+    default:
+        log_error(handle,
+                  pruneAlg != nullptr ? "rocsparselt_smfmac_prune_and_compress_streamed"
+                                      : "rocsparselt_smfmac_compress2_streamed",
+                  "datatype",
+                  rocsparselt_datatype_to_string(matrix->type),
+                  "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+// each thread widens one int8 value of a batch of the compressed matrix, the values and the
+// padding of the leading dimension keep their place in the widened matrix
+template <typename To, int BLOCK>
+__global__ __launch_bounds__(BLOCK) void widen_compressed_kernel(const int8_t* in,
+                                                                 To*           out,
+                                                                 int64_t       batch_stride)
+{
+    int64_t i = static_cast<int64_t>(hc_get_group_id(0)) * BLOCK + hc_get_workitem_id(0);
+    if(i >= batch_stride)
+        return;
+    int64_t offset = hc_get_group_id(1) * batch_stride + i;
+    out[offset]    = static_cast<To>(static_cast<float>(in[offset]));
+}
+
+template <typename To>
+rocsparselt_status rocsparselt_smfmac_widen_compressed_template(const int8_t* in,
+                                                                To*           out,
+                                                                int64_t       batch_stride,
+                                                                int           num_batches,
+                                                                hipStream_t   stream)
+{
+    constexpr int BLOCK   = 256;
+    int           block_x = batch_stride / BLOCK + (batch_stride % BLOCK > 0 ? 1 : 0);
+    hipLaunchKernelGGL((widen_compressed_kernel<To, BLOCK>),
+                       dim3(block_x, num_batches),
+                       dim3(BLOCK),
+                       0 /*dynamic shared*/,
+                       stream,
+                       in,
+                       out,
+                       batch_stride);
+    RETURN_IF_HIP_ERROR(hipGetLastError());
+    return rocsparselt_status_success;
+}
+
+static rocsparselt_status
+    rocsparselt_smfmac_widen_compressed_operand(const _rocsparselt_handle*       handle,
+                                                const _rocsparselt_matmul_descr* descr,
+                                                const void*                      d_compressed,
+                                                void*                            d_widened,
+                                                hipStream_t                      stream)
+{
+    rocsparselt_trace_span trace("widen", stream);
+
+    const _rocsparselt_mat_descr* matrix = descr->is_sparse_a ? descr->matrix_A : descr->matrix_B;
+    rocsparselt_datatype          type   = rocsparselt_matmul_input_type(descr);
+    int     num_batches  = matrix->batch_stride == 0 ? 1 : matrix->num_batches;
+    int64_t batch_stride = matrix->c_ld * matrix->c_n;
+
+    // the metadata do not depend on the type of the values, they are copied unchanged
+    auto in  = reinterpret_cast<const unsigned char*>(d_compressed);
+    auto out = reinterpret_cast<unsigned char*>(d_widened);
+    RETURN_IF_HIP_ERROR(
+        hipMemcpyAsync(out
+                           + rocsparselt_metadata_offset_in_compressed_matrix(
+                               matrix->c_n, matrix->c_ld, num_batches, type),
+                       in
+                           + rocsparselt_metadata_offset_in_compressed_matrix(
+                               matrix->c_n, matrix->c_ld, num_batches, matrix->type),
+                       batch_stride / 4 * num_batches,
+                       hipMemcpyDeviceToDevice,
+                       stream));
+
+    auto values = reinterpret_cast<const int8_t*>(d_compressed);
+    switch(type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return rocsparselt_smfmac_widen_compressed_template<__half>(
+            values, reinterpret_cast<__half*>(d_widened), batch_stride, num_batches, stream);
+    case rocsparselt_datatype_bf16_r:
+        return rocsparselt_smfmac_widen_compressed_template<hip_bfloat16>(
+            values, reinterpret_cast<hip_bfloat16*>(d_widened), batch_stride, num_batches, stream);
+    default:
+        log_error(handle,
+                  "rocsparselt_matmul",
+                  "datatype",
+                  rocsparselt_datatype_to_string(type),
+                  "is not a type to widen int8 to");
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+namespace
+{
+    std::atomic<uint64_t> compressed_matrix_writes{0};
+}
+
+void rocsparselt_compressed_matrix_written()
+{
+    compressed_matrix_writes.fetch_add(1, std::memory_order_acq_rel);
+}
+
+rocsparselt_status rocsparselt_smfmac_widened_operand(const _rocsparselt_handle*      handle,
+                                                      const _rocsparselt_matmul_plan* plan,
+                                                      const void*                     d_compressed,
+                                                      const void**                    d_widened,
+                                                      hipStream_t                     stream)
+{
+    const _rocsparselt_matmul_descr* descr   = plan->matmul_descr;
+    _rocsparselt_widened_operand*    widened = plan->widened;
+    std::lock_guard<std::mutex>      guard(widened->mutex);
+
+    // the copy is stale once any compressed matrix was written since it was widened
+    uint64_t writes = compressed_matrix_writes.load(std::memory_order_acquire);
+    bool     cached = widened->source == d_compressed && widened->writes == writes;
+
+    // a captured matmul can neither widen, which would only run with the graph, nor wait for
+    // an event recorded outside of the capture
+    hipStreamCaptureStatus capture = hipStreamCaptureStatusNone;
+    RETURN_IF_HIP_ERROR(hipStreamIsCapturing(stream, &capture));
+    if(capture != hipStreamCaptureStatusNone
+       && (!cached || hipEventQuery(widened->ready) != hipSuccess))
+    {
+        log_error(handle,
+                  "rocsparselt_matmul",
+                  "a captured mixed input matmul needs its compressed matrix widened by a "
+                  "matmul completed before the capture");
+        return rocsparselt_status_not_implemented;
+    }
+
+    if(cached)
+    {
+        // the copy may have been widened on another stream
+        if(capture == hipStreamCaptureStatusNone)
+            RETURN_IF_HIP_ERROR(hipStreamWaitEvent(stream, widened->ready, 0));
+        *d_widened = widened->data;
+        return rocsparselt_status_success;
+    }
+
+    if(widened->ready == nullptr)
+        RETURN_IF_HIP_ERROR(hipEventCreateWithFlags(&widened->ready, hipEventDisableTiming));
+    if(widened->data == nullptr)
+        RETURN_IF_HIP_ERROR(hipMalloc(&widened->data,
+                                      rocsparselt_compressed_matrix_bytes(
+                                          descr->is_sparse_a ? descr->matrix_A : descr->matrix_B,
+                                          rocsparselt_matmul_input_type(descr))));
+
+    widened->source = nullptr;
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_smfmac_widen_compressed_operand(
+        handle, descr, d_compressed, widened->data, stream));
+    RETURN_IF_HIP_ERROR(hipEventRecord(widened->ready, stream));
+    widened->source = d_compressed;
+    widened->writes = writes;
+    *d_widened      = widened->data;
+    return rocsparselt_status_success;
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -283,28 +1246,6 @@ rocsparselt_status rocsparselt_smfmac_compressed_size_impl(_rocsparselt_mat_desc
     return rocsparselt_status_success;
 }
 
-void get_compress_matrix_size(bool is_sparse_a, rocsparselt_operation op,  _rocsparselt_mat_descr *_sparseMatDescr, int64_t &m, int64_t &n, int64_t &stride0, int64_t &stride1, int64_t &c_stride0, int64_t &c_stride1)
-{
-    if(is_sparse_a)
-    {
-        m         = op == rocsparselt_operation_transpose ? _sparseMatDescr->n : _sparseMatDescr->m;
-        n         = op == rocsparselt_operation_transpose ? _sparseMatDescr->m : _sparseMatDescr->n;
-        stride0   = (op == rocsparselt_operation_transpose) ? _sparseMatDescr->ld : 1;
-        stride1   = (op == rocsparselt_operation_transpose) ? 1 : _sparseMatDescr->ld;
-        c_stride0 = (op == rocsparselt_operation_transpose) ? _sparseMatDescr->c_ld : 1;
-        c_stride1 = (op == rocsparselt_operation_transpose) ? 1 : _sparseMatDescr->c_ld;
-    }
-    else
-    {
-        m         = op == rocsparselt_operation_transpose ? _sparseMatDescr->m : _sparseMatDescr->n;
-        n         = op == rocsparselt_operation_transpose ? _sparseMatDescr->n : _sparseMatDescr->m;
-        stride0   = (op == rocsparselt_operation_transpose) ? 1 : _sparseMatDescr->ld;
-        stride1   = (op == rocsparselt_operation_transpose) ? _sparseMatDescr->ld : 1;
-        c_stride0 = (op == rocsparselt_operation_transpose) ? 1 : _sparseMatDescr->c_ld;
-        c_stride1 = (op == rocsparselt_operation_transpose) ? _sparseMatDescr->c_ld : 1;
-    }
-}
-
 /********************************************************************************
  * \brief
  *******************************************************************************/
@@ -363,11 +1304,15 @@ rocsparselt_status rocsparselt_smfmac_compressed_size(const rocsparselt_handle*
 
         _rocsparselt_mat_descr *_sparseMatDescr = _plan->matmul_descr->is_sparse_a ? _plan->matmul_descr->matrix_A : _plan->matmul_descr->matrix_B;
 
-        return rocsparselt_smfmac_compressed_size_impl(_sparseMatDescr,
-                                                       _sparseMatDescr->c_n,
-                                                       _sparseMatDescr->c_ld,
-                                                       compressedSize,
-                                                       compressBufferSize);
+        auto status = rocsparselt_smfmac_compressed_size_impl(_sparseMatDescr,
+                                                              _sparseMatDescr->c_n,
+                                                              _sparseMatDescr->c_ld,
+                                                              compressedSize,
+                                                              compressBufferSize);
+        // a padded plan pads the sparse matrix to the compress buffer before compressing it
+        if(status == rocsparselt_status_success && _plan->unpadded_descr != nullptr)
+            *compressBufferSize = rocsparselt_pad_sparse_bytes(_plan->matmul_descr);
+        return status;
     }
 }
 
@@ -475,6 +1420,8 @@ rocsparselt_status rocsparselt_smfmac_compress(const rocsparselt_handle*      ha
                                                hipStream_t                    stream)
 
 {
+    rocsparselt_compressed_matrix_written();
+
     // Check if handle is valid
     if(handle == nullptr)
     {
@@ -526,6 +1473,18 @@ rocsparselt_status rocsparselt_smfmac_compress(const rocsparselt_handle*      ha
             "stream[in]",
             stream);
 
+    if(_plan->unpadded_descr != nullptr)
+    {
+        if(d_compressBuffer == nullptr)
+        {
+            log_error(_handle, __func__, "d_compressBuffer of a padded plan is a NULL pointer");
+            return rocsparselt_status_invalid_pointer;
+        }
+        RETURN_IF_ROCSPARSELT_ERROR(
+            rocsparselt_pad_sparse(_plan, d_dense, d_compressBuffer, stream));
+        d_dense = d_compressBuffer;
+    }
+
     rocsparselt_operation   op              = _plan->matmul_descr->is_sparse_a ? _plan->matmul_descr->op_A : _plan->matmul_descr->op_B;
     _rocsparselt_mat_descr *_sparseMatDescr = _plan->matmul_descr->is_sparse_a ? _plan->matmul_descr->matrix_A : _plan->matmul_descr->matrix_B;
     auto ld = _sparseMatDescr->ld;
@@ -553,6 +1512,69 @@ rocsparselt_status rocsparselt_smfmac_compress(const rocsparselt_handle*      ha
                                             stream);
 }
 
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_compress_sharded(const rocsparselt_handle* const*      handles,
+                                        const rocsparselt_matmul_plan* const* plans,
+                                        int32_t                               numShards,
+                                        rocsparselt_shard_split               split,
+                                        const void* const*                    d_dense,
+                                        void* const*                          d_compressed,
+                                        void* const*                          d_compressBuffer,
+                                        hipStream_t*                          streams)
+{
+    if(numShards < 0)
+    {
+        hipsparselt_cerr << "numShards should >= 0" << std::endl;
+        return rocsparselt_status_invalid_value;
+    }
+    if(numShards == 0)
+        return rocsparselt_status_success;
+    RETURN_IF_ROCSPARSELT_ERROR(
+        rocsparselt_check_shards(handles, plans, numShards, split, __func__));
+
+    auto first = reinterpret_cast<const _rocsparselt_handle*>(handles[0]);
+    if(d_dense == nullptr || d_compressed == nullptr || streams == nullptr)
+    {
+        log_error(first, __func__, "d_dense, d_compressed or streams is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    for(int32_t i = 0; i < numShards; i++)
+    {
+        if(d_dense[i] == nullptr || d_compressed[i] == nullptr)
+        {
+            log_error(first, __func__, "a matrix of shard", i, "is a NULL pointer");
+            return rocsparselt_status_invalid_pointer;
+        }
+    }
+
+    log_api(first,
+            __func__,
+            "numShards[in]",
+            numShards,
+            "split[in]",
+            split,
+            "streams[in]",
+            streams);
+
+    // every shard is compressed on its device, the launches of the devices run concurrently
+    rocsparselt_device_scope device;
+    for(int32_t i = 0; i < numShards; i++)
+    {
+        RETURN_IF_HIP_ERROR(device.set(reinterpret_cast<const _rocsparselt_handle*>(handles[i])));
+        RETURN_IF_ROCSPARSELT_ERROR(
+            rocsparselt_smfmac_compress(handles[i],
+                                        plans[i],
+                                        d_dense[i],
+                                        d_compressed[i],
+                                        d_compressBuffer ? d_compressBuffer[i] : nullptr,
+                                        streams[i]));
+    }
+    return rocsparselt_status_success;
+}
+
 /********************************************************************************
  * \brief
  *******************************************************************************/
@@ -566,6 +1588,8 @@ rocsparselt_status rocsparselt_smfmac_compress2(const rocsparselt_handle*    han
                                                 hipStream_t                  stream)
 
 {
+    rocsparselt_compressed_matrix_written();
+
     // Check if handle is valid
     if(handle == nullptr)
     {
@@ -591,6 +1615,7 @@ rocsparselt_status rocsparselt_smfmac_compress2(const rocsparselt_handle*    han
         log_error(_handle, __func__, "sparseMatDescr did not initialized or already destroyed");
         return rocsparselt_status_invalid_handle;
     }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(_handle, _sparseMatDescr, __func__));
 
     if(op != rocsparselt_operation_none && op != rocsparselt_operation_transpose)
     {
@@ -660,6 +1685,399 @@ rocsparselt_status rocsparselt_smfmac_compress2(const rocsparselt_handle*    han
                                             stream);
 }
 
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_grouped_work_list_size(
+    const rocsparselt_handle* handle, int groupCount, size_t* workListSize)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(groupCount < 0)
+    {
+        log_error(_handle, __func__, "groupCount", groupCount, "is invalid");
+        return rocsparselt_status_invalid_size;
+    }
+
+    // Check if pointer is valid
+    if(workListSize == nullptr)
+    {
+        log_error(_handle, __func__, "workListSize is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    log_api(_handle, __func__, "groupCount[in]", groupCount, "workListSize[out]", workListSize);
+
+    *workListSize = groupCount * sizeof(rocsparselt_grouped_work);
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_compress2_grouped(const rocsparselt_handle*           handle,
+                                         int                                 groupCount,
+                                         const rocsparselt_mat_descr* const* sparseMatDescrs,
+                                         int                                 isSparseA,
+                                         rocsparselt_operation               op,
+                                         const void* const*                  d_dense,
+                                         void* const*                        d_compressed,
+                                         void*                               d_workList,
+                                         hipStream_t                         stream)
+{
+    rocsparselt_compressed_matrix_written();
+
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    std::vector<const _rocsparselt_mat_descr*> descrs;
+    RETURN_IF_ROCSPARSELT_ERROR(validateGroupedArgs(_handle,
+                                                    __func__,
+                                                    groupCount,
+                                                    sparseMatDescrs,
+                                                    op,
+                                                    d_dense,
+                                                    d_compressed,
+                                                    d_workList,
+                                                    descrs));
+    for(const _rocsparselt_mat_descr* descr : descrs)
+        RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(_handle, descr, __func__));
+
+    log_api(_handle,
+            __func__,
+            "groupCount[in]",
+            groupCount,
+            "isSparseA[in]",
+            isSparseA,
+            "op[in]",
+            rocsparselt_operation_to_string(op),
+            "d_dense[in]",
+            d_dense,
+            "d_compressed[out]",
+            d_compressed,
+            "d_workList[out]",
+            d_workList,
+            "stream[in]",
+            stream);
+
+    return rocsparselt_smfmac_compress_grouped_impl(
+        _handle, descrs, isSparseA, op, d_dense, d_compressed, d_workList, stream);
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_compress_rows(const rocsparselt_handle*      handle,
+                                                    const rocsparselt_matmul_plan* plan,
+                                                    const void*                    d_dense,
+                                                    void*                          d_compressed,
+                                                    int                            rangeCount,
+                                                    const int64_t*                 rowRanges,
+                                                    void*                          d_workList,
+                                                    hipStream_t                    stream)
+{
+    rocsparselt_compressed_matrix_written();
+
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, __func__));
+
+    if(rangeCount < 0)
+    {
+        log_error(_handle, __func__, "rangeCount", rangeCount, "is invalid");
+        return rocsparselt_status_invalid_size;
+    }
+    if(rangeCount == 0)
+        return rocsparselt_status_success;
+
+    // Check if pointer is valid
+    if(d_dense == nullptr || d_compressed == nullptr)
+    {
+        log_error(_handle, __func__, "d_dense or d_compressed is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    if(rowRanges == nullptr || d_workList == nullptr)
+    {
+        log_error(_handle, __func__, "rowRanges or d_workList is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    log_api(_handle,
+            __func__,
+            "plan[in]",
+            *_plan,
+            "d_dense[in]",
+            d_dense,
+            "d_compressed[out]",
+            d_compressed,
+            "rangeCount[in]",
+            rangeCount,
+            "rowRanges[in]",
+            rowRanges,
+            "d_workList[out]",
+            d_workList,
+            "stream[in]",
+            stream);
+
+    auto matmul = _plan->matmul_descr;
+    return rocsparselt_smfmac_compress_rows_impl(
+        _handle,
+        matmul->is_sparse_a ? matmul->matrix_A : matmul->matrix_B,
+        matmul->is_sparse_a,
+        matmul->is_sparse_a ? matmul->op_A : matmul->op_B,
+        d_dense,
+        d_compressed,
+        rangeCount,
+        rowRanges,
+        d_workList,
+        stream);
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_compress2_streamed(const rocsparselt_handle*    handle,
+                                          const rocsparselt_mat_descr* sparseMatDescr,
+                                          int                          isSparseA,
+                                          rocsparselt_operation        op,
+                                          const void*                  dense,
+                                          void*                        d_compressed,
+                                          void*                        d_panelBuffer,
+                                          size_t                       panelBufferSize,
+                                          hipStream_t                  stream)
+{
+    rocsparselt_compressed_matrix_written();
+
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(sparseMatDescr == nullptr)
+    {
+        log_error(_handle, __func__, "sparseMatDescr is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _sparseMatDescr = reinterpret_cast<const _rocsparselt_mat_descr*>(sparseMatDescr);
+    if(!_sparseMatDescr->isInit())
+    {
+        log_error(_handle, __func__, "sparseMatDescr did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(_handle, _sparseMatDescr, __func__));
+
+    if(op != rocsparselt_operation_none && op != rocsparselt_operation_transpose)
+    {
+        log_error(_handle, __func__, "op is invalid");
+        return rocsparselt_status_invalid_value;
+    }
+
+    // Check if pointer is valid
+    if(dense == nullptr || d_compressed == nullptr || d_panelBuffer == nullptr)
+    {
+        log_error(_handle, __func__, "dense, d_compressed or d_panelBuffer is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    // Check if matrix A is a structured matrix
+    if(_sparseMatDescr->m_type != rocsparselt_matrix_type_structured)
+    {
+        log_error(_handle, __func__, "Matrix is not a structured matrix");
+        return rocsparselt_status_not_implemented;
+    }
+
+    log_api(_handle,
+            __func__,
+            "sparseMatDescr[in]",
+            *_sparseMatDescr,
+            "isSparseA[in]",
+            isSparseA,
+            "op[in]",
+            rocsparselt_operation_to_string(op),
+            "dense[in]",
+            dense,
+            "d_compressed[out]",
+            d_compressed,
+            "d_panelBuffer[out]",
+            d_panelBuffer,
+            "panelBufferSize[in]",
+            panelBufferSize,
+            "stream[in]",
+            stream);
+
+    return rocsparselt_smfmac_compress_streamed_impl(_handle,
+                                                     _sparseMatDescr,
+                                                     isSparseA,
+                                                     op,
+                                                     dense,
+                                                     d_compressed,
+                                                     d_panelBuffer,
+                                                     panelBufferSize,
+                                                     nullptr,
+                                                     nullptr,
+                                                     stream);
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_prune_and_compress_streamed(const rocsparselt_handle*    handle,
+                                                   const rocsparselt_mat_descr* sparseMatDescr,
+                                                   int                          isSparseA,
+                                                   rocsparselt_operation        op,
+                                                   const void*                  dense,
+                                                   void*                        d_compressed,
+                                                   void*                        d_panelBuffer,
+                                                   size_t                       panelBufferSize,
+                                                   rocsparselt_prune_alg        pruneAlg,
+                                                   float*                       bandwidth,
+                                                   hipStream_t                  stream)
+{
+    rocsparselt_compressed_matrix_written();
+
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(sparseMatDescr == nullptr)
+    {
+        log_error(_handle, __func__, "sparseMatDescr is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _sparseMatDescr = reinterpret_cast<const _rocsparselt_mat_descr*>(sparseMatDescr);
+    if(!_sparseMatDescr->isInit())
+    {
+        log_error(_handle, __func__, "sparseMatDescr did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(_handle, _sparseMatDescr, __func__));
+
+    if(op != rocsparselt_operation_none && op != rocsparselt_operation_transpose)
+    {
+        log_error(_handle, __func__, "op is invalid");
+        return rocsparselt_status_invalid_value;
+    }
+
+    // Check if pointer is valid
+    if(dense == nullptr || d_compressed == nullptr || d_panelBuffer == nullptr)
+    {
+        log_error(_handle, __func__, "dense, d_compressed or d_panelBuffer is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    // Check if prune alg is valid
+    if(pruneAlg != rocsparselt_prune_smfmac_strip && pruneAlg != rocsparselt_prune_smfmac_tile)
+    {
+        log_error(_handle, __func__, "pruneAlg", pruneAlg, "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+
+    // Check if matrix A is a structured matrix
+    if(_sparseMatDescr->m_type != rocsparselt_matrix_type_structured)
+    {
+        log_error(_handle, __func__, "Matrix is not a structured matrix");
+        return rocsparselt_status_not_implemented;
+    }
+
+    log_api(_handle,
+            __func__,
+            "sparseMatDescr[in]",
+            *_sparseMatDescr,
+            "isSparseA[in]",
+            isSparseA,
+            "op[in]",
+            rocsparselt_operation_to_string(op),
+            "dense[in]",
+            dense,
+            "d_compressed[out]",
+            d_compressed,
+            "d_panelBuffer[out]",
+            d_panelBuffer,
+            "panelBufferSize[in]",
+            panelBufferSize,
+            "pruneAlg[in]",
+            pruneAlg,
+            "bandwidth[out]",
+            bandwidth,
+            "stream[in]",
+            stream);
+
+    return rocsparselt_smfmac_compress_streamed_impl(_handle,
+                                                     _sparseMatDescr,
+                                                     isSparseA,
+                                                     op,
+                                                     dense,
+                                                     d_compressed,
+                                                     d_panelBuffer,
+                                                     panelBufferSize,
+                                                     &pruneAlg,
+                                                     bandwidth,
+                                                     stream);
+}
+
 #ifdef __cplusplus
 }
 #endif
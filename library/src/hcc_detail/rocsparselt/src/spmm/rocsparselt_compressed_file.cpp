@@ -0,0 +1,350 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "definitions.h"
+#include "handle.h"
+#include "hipsparselt_ostream.hpp"
+#include "rocsparselt.h"
+#include "rocsparselt_compress.hpp"
+#include "rocsparselt_pad.hpp"
+#include "rocsparselt_spmm_utils.hpp"
+#include "utility.hpp"
+
+#include <cstring>
+#include <fcntl.h>
+#include <hip/hip_runtime_api.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*******************************************************************************
+ * The file is a fixed header followed by the bytes of the compressed matrix,
+ * exactly as rocsparselt_smfmac_compress() wrote them. The data starts on a
+ * page boundary so the mapping of the file can be registered with HIP and
+ * copied by DMA without a staging buffer. All the fields are little endian.
+ ******************************************************************************/
+namespace
+{
+    constexpr char     compressed_file_magic[8]  = {'H', 'S', 'L', 'T', 'C', 'M', 'P', '\0'};
+    constexpr uint32_t compressed_file_version   = 1;
+    constexpr uint64_t compressed_file_alignment = 4096;
+
+    struct compressed_file_header
+    {
+        char     magic[8];
+        uint32_t version;
+        uint32_t header_size;
+        int32_t  type;
+        int32_t  order;
+        int32_t  op;
+        int32_t  is_sparse_a;
+        int32_t  num_batches;
+        int32_t  reserved;
+        int64_t  m;
+        int64_t  n;
+        int64_t  ld;
+        int64_t  batch_stride;
+        int64_t  c_k;
+        int64_t  c_ld;
+        int64_t  c_n;
+        uint64_t compressed_size;
+        uint64_t metadata_offset;
+        uint64_t data_offset;
+    };
+
+    void fill_header(const _rocsparselt_matmul_plan* plan, compressed_file_header& header)
+    {
+        auto matmul = plan->matmul_descr;
+        auto matrix = matmul->is_sparse_a ? matmul->matrix_A : matmul->matrix_B;
+
+        //set the number of batches to 1 since in the broadcast case, we only care about contents in first batch.
+        int num_batches = matrix->batch_stride == 0 ? 1 : matrix->num_batches;
+
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, compressed_file_magic, sizeof(header.magic));
+        header.version         = compressed_file_version;
+        header.header_size     = sizeof(header);
+        header.type            = matrix->type;
+        header.order           = matrix->order;
+        header.op              = matmul->is_sparse_a ? matmul->op_A : matmul->op_B;
+        header.is_sparse_a     = matmul->is_sparse_a;
+        header.num_batches     = matrix->num_batches;
+        header.m               = matrix->m;
+        header.n               = matrix->n;
+        header.ld              = matrix->ld;
+        header.batch_stride    = matrix->batch_stride;
+        header.c_k             = matrix->c_k;
+        header.c_ld            = matrix->c_ld;
+        header.c_n             = matrix->c_n;
+        header.metadata_offset = rocsparselt_metadata_offset_in_compressed_matrix(
+            matrix->c_n, matrix->c_ld, num_batches, matrix->type);
+        header.compressed_size = rocsparselt_compressed_matrix_bytes(matrix);
+        header.data_offset     = compressed_file_alignment;
+    }
+
+    // the fields that decide the layout of the compressed matrix must match the plan.
+    bool header_matches(const compressed_file_header& file, const compressed_file_header& plan)
+    {
+        return file.type == plan.type && file.order == plan.order && file.op == plan.op
+               && file.is_sparse_a == plan.is_sparse_a && file.num_batches == plan.num_batches
+               && file.m == plan.m && file.n == plan.n && file.ld == plan.ld
+               && file.batch_stride == plan.batch_stride && file.c_k == plan.c_k
+               && file.c_ld == plan.c_ld && file.c_n == plan.c_n
+               && file.compressed_size == plan.compressed_size
+               && file.metadata_offset == plan.metadata_offset;
+    }
+
+    /***************************************************************************
+     * Copy between the mapping of the file and the device. The mapping is
+     * registered so the copy is a DMA straight from or into the page cache,
+     * when the registration is refused (e.g. by the filesystem) the copy goes
+     * through the pageable path. The mapping is released by the caller, so the
+     * copy has to be complete when this returns.
+     **************************************************************************/
+    rocsparselt_status copy_mapped(void*         mapped,
+                                   size_t        mapped_size,
+                                   void*         dst,
+                                   const void*   src,
+                                   size_t        size,
+                                   hipMemcpyKind kind,
+                                   hipStream_t   stream)
+    {
+        unsigned int flags = kind == hipMemcpyHostToDevice ? hipHostRegisterReadOnly
+                                                           : hipHostRegisterDefault;
+        bool registered = hipHostRegister(mapped, mapped_size, flags) == hipSuccess;
+        if(!registered)
+            (void)hipGetLastError();
+
+        hipError_t err = hipMemcpyAsync(dst, src, size, kind, stream);
+        if(err == hipSuccess)
+            err = hipStreamSynchronize(stream);
+        if(registered)
+            (void)hipHostUnregister(mapped);
+        return get_rocsparselt_status_for_hip_status(err);
+    }
+
+    rocsparselt_status validate_args(const rocsparselt_handle*        handle,
+                                     const char*                      caller,
+                                     const rocsparselt_matmul_plan*   plan,
+                                     const void*                      d_compressed,
+                                     const char*                      path,
+                                     const _rocsparselt_handle*&      _handle,
+                                     const _rocsparselt_matmul_plan*& _plan)
+    {
+        // Check if handle is valid
+        if(handle == nullptr)
+        {
+            hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+            return rocsparselt_status_invalid_handle;
+        }
+        _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+        if(!_handle->isInit())
+        {
+            hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+            return rocsparselt_status_invalid_handle;
+        }
+
+        if(plan == nullptr)
+        {
+            log_error(_handle, caller, "plan is a NULL pointer");
+            return rocsparselt_status_invalid_handle;
+        }
+        _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+        if(!_plan->isInit())
+        {
+            log_error(_handle, caller, "plan did not initialized or already destroyed");
+            return rocsparselt_status_invalid_handle;
+        }
+        RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, caller));
+
+        // Check if pointer is valid
+        if(d_compressed == nullptr)
+        {
+            log_error(_handle, caller, "d_compressed is a NULL pointer");
+            return rocsparselt_status_invalid_pointer;
+        }
+        if(path == nullptr)
+        {
+            log_error(_handle, caller, "path is a NULL pointer");
+            return rocsparselt_status_invalid_pointer;
+        }
+        return rocsparselt_status_success;
+    }
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_compressed_save(const rocsparselt_handle*      handle,
+                                                      const rocsparselt_matmul_plan* plan,
+                                                      const void*                    d_compressed,
+                                                      const char*                    path,
+                                                      hipStream_t                    stream)
+{
+    const _rocsparselt_handle*      _handle;
+    const _rocsparselt_matmul_plan* _plan;
+    RETURN_IF_ROCSPARSELT_ERROR(
+        validate_args(handle, __func__, plan, d_compressed, path, _handle, _plan));
+
+    log_api(_handle,
+            __func__,
+            "plan[in]",
+            *_plan,
+            "d_compressed[in]",
+            d_compressed,
+            "path[in]",
+            path,
+            "stream[in]",
+            stream);
+
+    compressed_file_header header;
+    fill_header(_plan, header);
+    size_t file_size = header.data_offset + header.compressed_size;
+
+    int fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+    {
+        log_error(_handle, __func__, "cannot create", path);
+        return rocsparselt_status_internal_error;
+    }
+    if(ftruncate(fd, file_size) != 0)
+    {
+        log_error(_handle, __func__, "cannot resize", path);
+        close(fd);
+        return rocsparselt_status_internal_error;
+    }
+    void* mapped = mmap(nullptr, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mapped == MAP_FAILED)
+    {
+        log_error(_handle, __func__, "cannot map", path);
+        return rocsparselt_status_internal_error;
+    }
+
+    memcpy(mapped, &header, sizeof(header));
+    auto status = copy_mapped(mapped,
+                              file_size,
+                              static_cast<char*>(mapped) + header.data_offset,
+                              d_compressed,
+                              header.compressed_size,
+                              hipMemcpyDeviceToHost,
+                              stream);
+    munmap(mapped, file_size);
+    return status;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_compressed_load(const rocsparselt_handle*      handle,
+                                                      const rocsparselt_matmul_plan* plan,
+                                                      const char*                    path,
+                                                      void*                          d_compressed,
+                                                      hipStream_t                    stream)
+{
+    rocsparselt_compressed_matrix_written();
+
+    const _rocsparselt_handle*      _handle;
+    const _rocsparselt_matmul_plan* _plan;
+    RETURN_IF_ROCSPARSELT_ERROR(
+        validate_args(handle, __func__, plan, d_compressed, path, _handle, _plan));
+
+    log_api(_handle,
+            __func__,
+            "plan[in]",
+            *_plan,
+            "path[in]",
+            path,
+            "d_compressed[out]",
+            d_compressed,
+            "stream[in]",
+            stream);
+
+    int fd = open(path, O_RDONLY);
+    if(fd < 0)
+    {
+        log_error(_handle, __func__, "cannot open", path);
+        return rocsparselt_status_internal_error;
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(compressed_file_header))
+    {
+        log_error(_handle, __func__, path, "is not a compressed matrix file");
+        close(fd);
+        return rocsparselt_status_invalid_value;
+    }
+    size_t file_size = st.st_size;
+    void*  mapped    = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if(mapped == MAP_FAILED)
+    {
+        log_error(_handle, __func__, "cannot map", path);
+        return rocsparselt_status_internal_error;
+    }
+
+    compressed_file_header file, expected;
+    memcpy(&file, mapped, sizeof(file));
+    fill_header(_plan, expected);
+
+    rocsparselt_status status = rocsparselt_status_success;
+    if(memcmp(file.magic, compressed_file_magic, sizeof(file.magic)) != 0
+       || file.header_size < sizeof(file)
+       || file.data_offset > file_size || file.compressed_size > file_size - file.data_offset)
+    {
+        log_error(_handle, __func__, path, "is not a compressed matrix file");
+        status = rocsparselt_status_invalid_value;
+    }
+    else if(file.version > compressed_file_version)
+    {
+        log_error(_handle, __func__, path, "has an unsupported version", file.version);
+        status = rocsparselt_status_not_implemented;
+    }
+    else if(!header_matches(file, expected))
+    {
+        log_error(_handle, __func__, path, "does not match the structured matrix of the plan");
+        status = rocsparselt_status_invalid_value;
+    }
+    else
+    {
+        status = copy_mapped(mapped,
+                             file_size,
+                             d_compressed,
+                             static_cast<const char*>(mapped) + file.data_offset,
+                             file.compressed_size,
+                             hipMemcpyHostToDevice,
+                             stream);
+    }
+    munmap(mapped, file_size);
+    return status;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,461 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "definitions.h"
+#include "handle.h"
+#include "hipsparselt_ostream.hpp"
+#include "rocsparselt.h"
+#include "rocsparselt_compress.hpp"
+#include "rocsparselt_pad.hpp"
+#include "rocsparselt_spmm_utils.hpp"
+#include "utility.hpp"
+
+#include <hip/hip_runtime_api.h>
+
+/*******************************************************************************
+ * The packed matrix holds the compressed values as signed 4-bit integers, two
+ * to a byte with the first in the low nibble, then one float scale for each
+ * group of groupSize consecutive compressed values along k, then the metadata
+ * of the compressed matrix unchanged. The values and the scales are row major
+ * along k for any operation: a batch holds m rows of c_k values, the low nibble
+ * of byte (batch, row, kc / 2) is the value kc of the row when kc is even.
+ * A value is round(v / scale), clamped to [-8, 7], with scale = max|v| / 7 of
+ * its group.
+ ******************************************************************************/
+namespace
+{
+    struct int4_layout
+    {
+        int64_t m;
+        int64_t c_k;
+        int64_t c_stride0;
+        int64_t c_stride1;
+        int64_t c_batch_stride;
+        int64_t groups;
+        int     num_batches;
+        int64_t scale_offset;
+        int64_t metadata_offset;
+        int64_t metadata_bytes;
+        int64_t compressed_metadata_offset;
+    };
+
+    void get_int4_layout(const _rocsparselt_matmul_plan* plan, int64_t groupSize, int4_layout& l)
+    {
+        auto matmul = plan->matmul_descr;
+        auto matrix = matmul->is_sparse_a ? matmul->matrix_A : matmul->matrix_B;
+
+        int64_t n, stride0, stride1;
+        get_compress_matrix_size(matmul->is_sparse_a,
+                                 matmul->is_sparse_a ? matmul->op_A : matmul->op_B,
+                                 matrix,
+                                 l.m,
+                                 n,
+                                 stride0,
+                                 stride1,
+                                 l.c_stride0,
+                                 l.c_stride1);
+        l.c_k            = n / 2;
+        l.c_batch_stride = matrix->c_ld * matrix->c_n;
+        l.groups         = l.c_k / groupSize;
+        l.num_batches    = matrix->batch_stride == 0 ? 1 : matrix->num_batches;
+
+        // the scales start on a 16-byte boundary
+        int64_t value_bytes = l.num_batches * l.m * l.c_k / 2;
+        l.scale_offset      = (value_bytes + 15) / 16 * 16;
+        l.metadata_offset   = l.scale_offset + l.num_batches * l.m * l.groups * sizeof(float);
+        l.metadata_bytes    = l.c_batch_stride / 4 * l.num_batches;
+        l.compressed_metadata_offset = rocsparselt_metadata_offset_in_compressed_matrix(
+            matrix->c_n, matrix->c_ld, l.num_batches, matrix->type);
+    }
+
+    rocsparselt_status validate_args(const rocsparselt_handle*        handle,
+                                     const char*                      caller,
+                                     const rocsparselt_matmul_plan*   plan,
+                                     int64_t                          groupSize,
+                                     const _rocsparselt_handle*&      _handle,
+                                     const _rocsparselt_matmul_plan*& _plan)
+    {
+        // Check if handle is valid
+        if(handle == nullptr)
+        {
+            hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+            return rocsparselt_status_invalid_handle;
+        }
+        _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+        if(!_handle->isInit())
+        {
+            hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+            return rocsparselt_status_invalid_handle;
+        }
+
+        if(plan == nullptr)
+        {
+            log_error(_handle, caller, "plan is a NULL pointer");
+            return rocsparselt_status_invalid_handle;
+        }
+        _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+        if(!_plan->isInit())
+        {
+            log_error(_handle, caller, "plan did not initialized or already destroyed");
+            return rocsparselt_status_invalid_handle;
+        }
+        RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, caller));
+
+        // a group covers whole bytes of values and divides the compressed k
+        auto    matmul = _plan->matmul_descr;
+        auto    matrix = matmul->is_sparse_a ? matmul->matrix_A : matmul->matrix_B;
+        int64_t c_k    = matrix->c_k;
+        if(groupSize <= 0 || groupSize % 2 != 0 || c_k % groupSize != 0)
+        {
+            log_error(_handle, caller, "groupSize", groupSize, "does not divide k / 2 =", c_k);
+            return rocsparselt_status_invalid_value;
+        }
+        return rocsparselt_status_success;
+    }
+
+    // the values are rounded from float, only the 16-bit float types are packed
+    rocsparselt_status validate_type(const _rocsparselt_handle*      handle,
+                                     const char*                     caller,
+                                     const _rocsparselt_matmul_plan* plan)
+    {
+        auto matmul = plan->matmul_descr;
+        auto type   = (matmul->is_sparse_a ? matmul->matrix_A : matmul->matrix_B)->type;
+        if(type != rocsparselt_datatype_f16_r && type != rocsparselt_datatype_bf16_r)
+        {
+            log_error(handle,
+                      caller,
+                      "datatype",
+                      rocsparselt_datatype_to_string(type),
+                      "is not supported");
+            return rocsparselt_status_not_implemented;
+        }
+        return rocsparselt_status_success;
+    }
+}
+
+// each thread quantizes one group of a row, neighbouring threads take the neighbouring values of
+// the compressed matrix: neighbouring rows when m is contiguous, neighbouring groups otherwise.
+template <typename Ti, int BLOCK>
+__global__ __launch_bounds__(BLOCK) void int4_pack_kernel(const Ti*      in,
+                                                          unsigned char* packed,
+                                                          float*         scales,
+                                                          int64_t        m,
+                                                          int64_t        c_k,
+                                                          int64_t        groups,
+                                                          int64_t        group_size,
+                                                          int64_t        c_stride0,
+                                                          int64_t        c_stride1,
+                                                          int64_t        c_batch_stride)
+{
+    unsigned int batchId = hc_get_group_id(1);
+    int64_t      t       = static_cast<int64_t>(hc_get_group_id(0)) * BLOCK + hc_get_workitem_id(0);
+
+    int64_t row   = c_stride0 == 1 ? t % m : t / groups;
+    int64_t group = c_stride0 == 1 ? t / m : t % groups;
+    if(row >= m || group >= groups)
+        return;
+
+    const Ti* ptr
+        = in + batchId * c_batch_stride + row * c_stride0 + group * group_size * c_stride1;
+
+    float max_abs = 0.0f;
+    for(int64_t k = 0; k < group_size; k++)
+        max_abs = fmaxf(max_abs, fabsf(static_cast<float>(ptr[k * c_stride1])));
+    float scale = max_abs / 7.0f;
+
+    int64_t row_id                  = batchId * m + row;
+    scales[row_id * groups + group] = scale;
+
+    unsigned char* dst = packed + row_id * (c_k / 2) + group * group_size / 2;
+    for(int64_t k = 0; k < group_size; k += 2)
+    {
+        unsigned char nibbles[2];
+#pragma unroll
+        for(int j = 0; j < 2; j++)
+        {
+            float v    = static_cast<float>(ptr[(k + j) * c_stride1]);
+            int   q    = scale == 0.0f ? 0 : static_cast<int>(rintf(v / scale));
+            nibbles[j] = static_cast<unsigned char>(max(-8, min(7, q)) & 0xF);
+        }
+        dst[k / 2] = nibbles[0] | (nibbles[1] << 4);
+    }
+}
+
+// the inverse of int4_pack_kernel, with the same threads.
+template <typename Ti, int BLOCK>
+__global__ __launch_bounds__(BLOCK) void int4_unpack_kernel(const unsigned char* packed,
+                                                            const float*         scales,
+                                                            Ti*                  out,
+                                                            int64_t              m,
+                                                            int64_t              c_k,
+                                                            int64_t              groups,
+                                                            int64_t              group_size,
+                                                            int64_t              c_stride0,
+                                                            int64_t              c_stride1,
+                                                            int64_t              c_batch_stride)
+{
+    unsigned int batchId = hc_get_group_id(1);
+    int64_t      t       = static_cast<int64_t>(hc_get_group_id(0)) * BLOCK + hc_get_workitem_id(0);
+
+    int64_t row   = c_stride0 == 1 ? t % m : t / groups;
+    int64_t group = c_stride0 == 1 ? t / m : t % groups;
+    if(row >= m || group >= groups)
+        return;
+
+    int64_t              row_id = batchId * m + row;
+    float                scale  = scales[row_id * groups + group];
+    const unsigned char* src    = packed + row_id * (c_k / 2) + group * group_size / 2;
+
+    Ti* ptr = out + batchId * c_batch_stride + row * c_stride0 + group * group_size * c_stride1;
+    for(int64_t k = 0; k < group_size; k += 2)
+    {
+        unsigned char byte = src[k / 2];
+#pragma unroll
+        for(int j = 0; j < 2; j++)
+        {
+            // sign extend the nibble
+            int q                    = static_cast<int>((byte >> (j * 4)) & 0xF);
+            q                        = q >= 8 ? q - 16 : q;
+            ptr[(k + j) * c_stride1] = static_cast<Ti>(static_cast<float>(q) * scale);
+        }
+    }
+}
+
+template <typename Ti>
+rocsparselt_status rocsparselt_smfmac_int4_pack_template(const int4_layout& l,
+                                                         int64_t            groupSize,
+                                                         const Ti*          d_compressed,
+                                                         unsigned char*     d_packed,
+                                                         hipStream_t        stream)
+{
+    constexpr int BLOCK   = 256;
+    int64_t       threads = l.m * l.groups;
+    int           block_x = threads / BLOCK + (threads % BLOCK > 0 ? 1 : 0);
+    hipLaunchKernelGGL((int4_pack_kernel<Ti, BLOCK>),
+                       dim3(block_x, l.num_batches),
+                       dim3(BLOCK),
+                       0 /*dynamic shared*/,
+                       stream,
+                       d_compressed,
+                       d_packed,
+                       reinterpret_cast<float*>(d_packed + l.scale_offset),
+                       l.m,
+                       l.c_k,
+                       l.groups,
+                       groupSize,
+                       l.c_stride0,
+                       l.c_stride1,
+                       l.c_batch_stride);
+    return rocsparselt_status_success;
+}
+
+template <typename Ti>
+rocsparselt_status rocsparselt_smfmac_int4_unpack_template(const int4_layout&   l,
+                                                           int64_t              groupSize,
+                                                           const unsigned char* d_packed,
+                                                           Ti*                  d_compressed,
+                                                           hipStream_t          stream)
+{
+    constexpr int BLOCK   = 256;
+    int64_t       threads = l.m * l.groups;
+    int           block_x = threads / BLOCK + (threads % BLOCK > 0 ? 1 : 0);
+    hipLaunchKernelGGL((int4_unpack_kernel<Ti, BLOCK>),
+                       dim3(block_x, l.num_batches),
+                       dim3(BLOCK),
+                       0 /*dynamic shared*/,
+                       stream,
+                       d_packed,
+                       reinterpret_cast<const float*>(d_packed + l.scale_offset),
+                       d_compressed,
+                       l.m,
+                       l.c_k,
+                       l.groups,
+                       groupSize,
+                       l.c_stride0,
+                       l.c_stride1,
+                       l.c_batch_stride);
+    return rocsparselt_status_success;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************************************************************************
+ * \brief provide the size of a compressed matrix packed to 4-bit values.
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_compressed_int4_size(const rocsparselt_handle*      handle,
+                                            const rocsparselt_matmul_plan* plan,
+                                            int64_t                        groupSize,
+                                            size_t*                        packedSize)
+{
+    const _rocsparselt_handle*      _handle;
+    const _rocsparselt_matmul_plan* _plan;
+    RETURN_IF_ROCSPARSELT_ERROR(validate_args(handle, __func__, plan, groupSize, _handle, _plan));
+
+    // Check if pointer is valid
+    if(packedSize == nullptr)
+    {
+        log_error(_handle, __func__, "packedSize is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(validate_type(_handle, __func__, _plan));
+
+    int4_layout l;
+    get_int4_layout(_plan, groupSize, l);
+    *packedSize = l.metadata_offset + l.metadata_bytes;
+
+    log_api(_handle,
+            __func__,
+            "plan[in]",
+            *_plan,
+            "groupSize[in]",
+            groupSize,
+            "packedSize[out]",
+            *packedSize);
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief packs the values of a compressed matrix to 4-bit values and group
+ * scales.
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_compressed_int4_pack(const rocsparselt_handle*      handle,
+                                            const rocsparselt_matmul_plan* plan,
+                                            int64_t                        groupSize,
+                                            const void*                    d_compressed,
+                                            void*                          d_packed,
+                                            hipStream_t                    stream)
+{
+    const _rocsparselt_handle*      _handle;
+    const _rocsparselt_matmul_plan* _plan;
+    RETURN_IF_ROCSPARSELT_ERROR(validate_args(handle, __func__, plan, groupSize, _handle, _plan));
+
+    // Check if pointer is valid
+    if(d_compressed == nullptr || d_packed == nullptr)
+    {
+        log_error(_handle, __func__, "d_compressed or d_packed is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(validate_type(_handle, __func__, _plan));
+
+    log_api(_handle,
+            __func__,
+            "plan[in]",
+            *_plan,
+            "groupSize[in]",
+            groupSize,
+            "d_compressed[in]",
+            d_compressed,
+            "d_packed[out]",
+            d_packed,
+            "stream[in]",
+            stream);
+
+    int4_layout l;
+    get_int4_layout(_plan, groupSize, l);
+
+    auto packed = reinterpret_cast<unsigned char*>(d_packed);
+    RETURN_IF_HIP_ERROR(hipMemcpyAsync(packed + l.metadata_offset,
+                                       reinterpret_cast<const unsigned char*>(d_compressed)
+                                           + l.compressed_metadata_offset,
+                                       l.metadata_bytes,
+                                       hipMemcpyDeviceToDevice,
+                                       stream));
+
+    auto matmul = _plan->matmul_descr;
+    auto type   = (matmul->is_sparse_a ? matmul->matrix_A : matmul->matrix_B)->type;
+    if(type == rocsparselt_datatype_f16_r)
+        return rocsparselt_smfmac_int4_pack_template<__half>(
+            l, groupSize, reinterpret_cast<const __half*>(d_compressed), packed, stream);
+    return rocsparselt_smfmac_int4_pack_template<hip_bfloat16>(
+        l, groupSize, reinterpret_cast<const hip_bfloat16*>(d_compressed), packed, stream);
+}
+
+/********************************************************************************
+ * \brief expands a packed 4-bit compressed matrix back to the compressed
+ * matrix the matmul reads.
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_compressed_int4_unpack(const rocsparselt_handle*      handle,
+                                              const rocsparselt_matmul_plan* plan,
+                                              int64_t                        groupSize,
+                                              const void*                    d_packed,
+                                              void*                          d_compressed,
+                                              hipStream_t                    stream)
+{
+    rocsparselt_compressed_matrix_written();
+
+    const _rocsparselt_handle*      _handle;
+    const _rocsparselt_matmul_plan* _plan;
+    RETURN_IF_ROCSPARSELT_ERROR(validate_args(handle, __func__, plan, groupSize, _handle, _plan));
+
+    // Check if pointer is valid
+    if(d_packed == nullptr || d_compressed == nullptr)
+    {
+        log_error(_handle, __func__, "d_packed or d_compressed is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(validate_type(_handle, __func__, _plan));
+
+    log_api(_handle,
+            __func__,
+            "plan[in]",
+            *_plan,
+            "groupSize[in]",
+            groupSize,
+            "d_packed[in]",
+            d_packed,
+            "d_compressed[out]",
+            d_compressed,
+            "stream[in]",
+            stream);
+
+    int4_layout l;
+    get_int4_layout(_plan, groupSize, l);
+
+    auto packed = reinterpret_cast<const unsigned char*>(d_packed);
+    auto compressed = reinterpret_cast<unsigned char*>(d_compressed);
+    RETURN_IF_HIP_ERROR(hipMemcpyAsync(compressed + l.compressed_metadata_offset,
+                                       packed + l.metadata_offset,
+                                       l.metadata_bytes,
+                                       hipMemcpyDeviceToDevice,
+                                       stream));
+
+    auto matmul = _plan->matmul_descr;
+    auto type   = (matmul->is_sparse_a ? matmul->matrix_A : matmul->matrix_B)->type;
+    if(type == rocsparselt_datatype_f16_r)
+        return rocsparselt_smfmac_int4_unpack_template<__half>(
+            l, groupSize, packed, reinterpret_cast<__half*>(compressed), stream);
+    return rocsparselt_smfmac_int4_unpack_template<hip_bfloat16>(
+        l, groupSize, packed, reinterpret_cast<hip_bfloat16*>(compressed), stream);
+}
+
+#ifdef __cplusplus
+}
+#endif
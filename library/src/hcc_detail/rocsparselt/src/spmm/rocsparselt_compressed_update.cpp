@@ -0,0 +1,431 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "definitions.h"
+#include "handle.h"
+#include "hipsparselt_ostream.hpp"
+#include "rocsparselt.h"
+#include "rocsparselt_compress.hpp"
+#include "rocsparselt_pad.hpp"
+#include "rocsparselt_spmm_utils.hpp"
+#include "utility.hpp"
+
+#include <cmath>
+#include <hip/hip_runtime_api.h>
+
+// the scalars of one optimizer step, with the bias corrections of Adam computed on the host.
+struct compressed_update_step
+{
+    float lr;
+    float beta1;
+    float beta2;
+    float eps;
+    float weight_decay;
+    float correction1;
+    float correction2;
+};
+
+// each thread updates the 4 values of one metadata byte, which cover 8 k elements of a row, from
+// the elements of the dense gradient the metadata points to. The pattern is the one of the
+// metadata, the pruned elements of the gradient are never read. The states are in the layout of
+// the compressed values, neighbouring threads take neighbouring rows.
+template <typename Ti, bool Adam, int SG0I, int SG1J>
+__global__ __launch_bounds__(SG0I* SG1J) void
+    compressed_update_kernel(Ti*                    values,
+                             const unsigned char*   metadata,
+                             const Ti*              grad,
+                             float*                 state1,
+                             float*                 state2,
+                             compressed_update_step step,
+                             int64_t                m,
+                             int64_t                n,
+                             int64_t                stride1,
+                             int64_t                stride2,
+                             int64_t                batch_stride,
+                             int64_t                c_stride1,
+                             int64_t                c_stride2,
+                             int64_t                c_batch_stride,
+                             int64_t                m_stride1,
+                             int64_t                m_stride2,
+                             int64_t                m_batch_stride)
+{
+    constexpr int tiles_y = 4;
+
+    unsigned int serial = hc_get_workitem_id(0);
+    unsigned int sg0I   = serial % SG0I;
+    unsigned int sg1J   = serial / SG0I;
+
+    int64_t row = SG0I * hc_get_group_id(0) + sg0I;
+    int64_t col = (SG1J * hc_get_group_id(1) + sg1J) * 8;
+    if(row >= m || col >= n)
+        return;
+
+    int64_t   batchId  = hc_get_group_id(2);
+    int64_t   c_offset = batchId * c_batch_stride + row * c_stride1 + (col >> 1) * c_stride2;
+    const Ti* g_ptr    = grad + batchId * batch_stride + row * stride1 + col * stride2;
+
+    unsigned char md
+        = metadata[batchId * m_batch_stride + row * m_stride1 + (col >> 3) * m_stride2];
+
+#pragma unroll
+    for(int midx = 0; midx < tiles_y; midx++)
+    {
+        int     k   = ((md >> (midx << 1)) & 0x03) + (midx >> 1) * tiles_y;
+        int64_t pos = c_offset + midx * c_stride2;
+
+        float w = static_cast<float>(values[pos]);
+        float g = static_cast<float>(g_ptr[k * stride2]) + step.weight_decay * w;
+        if constexpr(Adam)
+        {
+            float m1    = step.beta1 * state1[pos] + (1.0f - step.beta1) * g;
+            float m2    = step.beta2 * state2[pos] + (1.0f - step.beta2) * g * g;
+            state1[pos] = m1;
+            state2[pos] = m2;
+            w -= step.lr * (m1 / step.correction1) / (sqrtf(m2 / step.correction2) + step.eps);
+        }
+        else
+        {
+            if(state1 != nullptr)
+            {
+                g           = step.beta1 * state1[pos] + g;
+                state1[pos] = g;
+            }
+            w -= step.lr * g;
+        }
+        values[pos] = static_cast<Ti>(w);
+    }
+}
+
+template <typename Ti>
+rocsparselt_status
+    rocsparselt_smfmac_compressed_update_template(const _rocsparselt_handle*    handle,
+                                                  int64_t                       m,
+                                                  int64_t                       n,
+                                                  int64_t                       stride0,
+                                                  int64_t                       stride1,
+                                                  int64_t                       batch_stride,
+                                                  int64_t                       c_stride0,
+                                                  int64_t                       c_stride1,
+                                                  int64_t                       c_batch_stride,
+                                                  int64_t                       m_stride0,
+                                                  int64_t                       m_stride1,
+                                                  int64_t                       m_batch_stride,
+                                                  int                           num_batches,
+                                                  Ti*                           d_values,
+                                                  const unsigned char*          d_metadata,
+                                                  const Ti*                     d_grad,
+                                                  float*                        d_state1,
+                                                  float*                        d_state2,
+                                                  bool                          adam,
+                                                  const compressed_update_step& step,
+                                                  hipStream_t                   stream)
+{
+    // 4 wavefronts per workgroup, 256 threads on wave64 and 128 threads on wave32 archs.
+    bool          wave32 = handle->wavefront_size == 32;
+    constexpr int SG1J   = 4;
+    int           SG0I   = (wave32 ? 128 : 256) / SG1J;
+
+    int block_x = m / SG0I + (m % SG0I > 0 ? 1 : 0);
+    int block_y = n / (SG1J * 8) + (n % (SG1J * 8) > 0 ? 1 : 0);
+
+    auto kernel = adam ? (wave32 ? compressed_update_kernel<Ti, true, 32, SG1J>
+                                 : compressed_update_kernel<Ti, true, 64, SG1J>)
+                       : (wave32 ? compressed_update_kernel<Ti, false, 32, SG1J>
+                                 : compressed_update_kernel<Ti, false, 64, SG1J>);
+    hipLaunchKernelGGL(kernel,
+                       dim3(block_x, block_y, num_batches),
+                       dim3(SG0I * SG1J),
+                       0 /*dynamic shared*/,
+                       stream,
+                       d_values,
+                       d_metadata,
+                       d_grad,
+                       d_state1,
+                       d_state2,
+                       step,
+                       m,
+                       n,
+                       stride0,
+                       stride1,
+                       batch_stride,
+                       c_stride0,
+                       c_stride1,
+                       c_batch_stride,
+                       m_stride0,
+                       m_stride1,
+                       m_batch_stride);
+    return rocsparselt_status_success;
+}
+
+rocsparselt_status
+    rocsparselt_smfmac_compressed_update_impl(const _rocsparselt_handle*          handle,
+                                              _rocsparselt_mat_descr*             matrix,
+                                              int                                 isSparseA,
+                                              rocsparselt_operation               op,
+                                              const rocsparselt_optimizer_params& params,
+                                              void*                               d_compressed,
+                                              const void*                         d_grad,
+                                              float*                              d_state1,
+                                              float*                              d_state2,
+                                              hipStream_t                         stream)
+{
+    rocsparselt_datatype type = matrix->type;
+
+    int64_t m, n, stride0, stride1, c_stride0, c_stride1;
+    get_compress_matrix_size(isSparseA, op, matrix, m, n, stride0, stride1, c_stride0, c_stride1);
+    int64_t m_stride0 = matrix->c_k / 4;
+    int64_t m_stride1 = 1;
+
+    int     num_batches  = matrix->num_batches;
+    int64_t batch_stride = matrix->batch_stride;
+    //set number of batches to 1, since we only care the first batch under the boradcast case.
+    if(batch_stride == 0)
+    {
+        num_batches  = 1;
+        batch_stride = rocsparselt_matrix_elems(matrix, matrix->ld);
+    }
+    int64_t c_batch_stride = matrix->c_ld * matrix->c_n;
+    int64_t m_batch_stride = matrix->c_ld * matrix->c_n / 4;
+
+    bool                   adam = params.optimizer == rocsparselt_optimizer_adam;
+    compressed_update_step step;
+    step.lr           = params.lr;
+    step.beta1        = params.beta1;
+    step.beta2        = params.beta2;
+    step.eps          = params.eps;
+    step.weight_decay = params.weight_decay;
+    step.correction1  = adam ? 1.0f - std::pow(params.beta1, float(params.step)) : 1.0f;
+    step.correction2  = adam ? 1.0f - std::pow(params.beta2, float(params.step)) : 1.0f;
+
+    unsigned char* d_metadata = reinterpret_cast<unsigned char*>(d_compressed)
+                                + rocsparselt_metadata_offset_in_compressed_matrix(
+                                    matrix->c_n, matrix->c_ld, num_batches, type);
+
+#define COMPRESSED_UPDATE_PARAMS(T)                                                                \
+    handle, m, n, stride0, stride1, batch_stride, c_stride0, c_stride1, c_batch_stride, m_stride0, \
+        m_stride1, m_batch_stride, num_batches, reinterpret_cast<T*>(d_compressed), d_metadata,    \
+        reinterpret_cast<const T*>(d_grad), d_state1, d_state2, adam, step, stream
+
+    // the update is computed in float and rounded back, only the 16-bit float types train
+    switch(type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return rocsparselt_smfmac_compressed_update_template<__half>(
+            COMPRESSED_UPDATE_PARAMS(__half));
+    case rocsparselt_datatype_bf16_r:
+        return rocsparselt_smfmac_compressed_update_template<hip_bfloat16>(
+            COMPRESSED_UPDATE_PARAMS(hip_bfloat16));
+    default:
+        log_error(handle,
+                  "rocsparselt_smfmac_compressed_update",
+                  "datatype",
+                  rocsparselt_datatype_to_string(type),
+                  "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+#undef COMPRESSED_UPDATE_PARAMS
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************************************************************************
+ * \brief provide the size of an optimizer state in the layout of the compressed
+ * values.
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_compressed_update_state_size(const rocsparselt_handle*      handle,
+                                                    const rocsparselt_matmul_plan* plan,
+                                                    size_t*                        stateSize)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, __func__));
+
+    // Check if pointer is valid
+    if(stateSize == nullptr)
+    {
+        log_error(_handle, __func__, "stateSize is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    auto matmul = _plan->matmul_descr;
+    auto matrix = matmul->is_sparse_a ? matmul->matrix_A : matmul->matrix_B;
+
+    int num_batches = matrix->batch_stride == 0 ? 1 : matrix->num_batches;
+    *stateSize      = num_batches * matrix->c_ld * matrix->c_n * sizeof(float);
+
+    log_api(_handle, __func__, "plan[in]", *_plan, "stateSize[out]", *stateSize);
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief applies an optimizer step to the values of a compressed matrix.
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_compressed_update(const rocsparselt_handle*           handle,
+                                         const rocsparselt_matmul_plan*      plan,
+                                         const rocsparselt_optimizer_params* params,
+                                         void*                               d_compressed,
+                                         const void*                         d_grad,
+                                         float*                              d_state1,
+                                         float*                              d_state2,
+                                         hipStream_t                         stream)
+{
+    rocsparselt_compressed_matrix_written();
+
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, __func__));
+
+    // Check if pointer is valid
+    if(params == nullptr || d_compressed == nullptr || d_grad == nullptr)
+    {
+        log_error(_handle, __func__, "params, d_compressed or d_grad is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    switch(params->optimizer)
+    {
+    case rocsparselt_optimizer_sgd:
+        if(params->beta1 != 0.0f && d_state1 == nullptr)
+        {
+            log_error(_handle, __func__, "d_state1 is a NULL pointer, SGD with momentum needs it");
+            return rocsparselt_status_invalid_pointer;
+        }
+        break;
+    case rocsparselt_optimizer_adam:
+        if(d_state1 == nullptr || d_state2 == nullptr)
+        {
+            log_error(_handle, __func__, "d_state1 or d_state2 is a NULL pointer, Adam needs both");
+            return rocsparselt_status_invalid_pointer;
+        }
+        if(params->step < 1)
+        {
+            log_error(_handle, __func__, "step", params->step, "is invalid, Adam starts from 1");
+            return rocsparselt_status_invalid_value;
+        }
+        break;
+    default:
+        log_error(_handle, __func__, "optimizer", params->optimizer, "is not supported");
+        return rocsparselt_status_invalid_value;
+    }
+
+    log_api(_handle,
+            __func__,
+            "plan[in]",
+            *_plan,
+            "optimizer[in]",
+            params->optimizer,
+            "lr[in]",
+            params->lr,
+            "beta1[in]",
+            params->beta1,
+            "beta2[in]",
+            params->beta2,
+            "eps[in]",
+            params->eps,
+            "weight_decay[in]",
+            params->weight_decay,
+            "step[in]",
+            params->step,
+            "d_compressed[in/out]",
+            d_compressed,
+            "d_grad[in]",
+            d_grad,
+            "d_state1[in/out]",
+            d_state1,
+            "d_state2[in/out]",
+            d_state2,
+            "stream[in]",
+            stream);
+
+    // SGD without momentum reads no state
+    if(params->optimizer == rocsparselt_optimizer_sgd && params->beta1 == 0.0f)
+        d_state1 = nullptr;
+
+    auto matmul = _plan->matmul_descr;
+    return rocsparselt_smfmac_compressed_update_impl(
+        _handle,
+        matmul->is_sparse_a ? matmul->matrix_A : matmul->matrix_B,
+        matmul->is_sparse_a,
+        matmul->is_sparse_a ? matmul->op_A : matmul->op_B,
+        *params,
+        d_compressed,
+        d_grad,
+        d_state1,
+        d_state2,
+        stream);
+}
+
+#ifdef __cplusplus
+}
+#endif
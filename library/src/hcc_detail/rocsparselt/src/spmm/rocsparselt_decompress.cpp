@@ -0,0 +1,576 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "definitions.h"
+#include "handle.h"
+#include "hipsparselt_ostream.hpp"
+#include "rocsparselt.h"
+#include "rocsparselt_compress.hpp"
+#include "rocsparselt_pad.hpp"
+#include "rocsparselt_spmm_utils.hpp"
+#include "utility.hpp"
+
+#include <hip/hip_runtime_api.h>
+
+// the inverse of compress_kernel: each thread expands one metadata byte and its 4 values into
+// 8 k elements of a row, neighbouring threads take neighbouring rows.
+template <typename Ti, int SG0I, int SG1J>
+__global__ __launch_bounds__(SG0I* SG1J) void
+    decompress_kernel(const Ti*            in,
+                      const unsigned char* metadata,
+                      Ti*                  out,
+                      int64_t              m,
+                      int64_t              n,
+                      int64_t              stride1,
+                      int64_t              stride2,
+                      int64_t              batch_stride,
+                      int64_t              c_stride1,
+                      int64_t              c_stride2,
+                      int64_t              c_batch_stride,
+                      int64_t              m_stride1,
+                      int64_t              m_stride2,
+                      int64_t              m_batch_stride)
+{
+    unsigned int serial = hc_get_workitem_id(0);
+    unsigned int sg0I   = serial % SG0I;
+    unsigned int sg1J   = serial / SG0I;
+
+    int64_t row = SG0I * hc_get_group_id(0) + sg0I;
+    int64_t col = (SG1J * hc_get_group_id(1) + sg1J) * 8;
+    if(row >= m || col >= n)
+        return;
+
+    int64_t   batchId = hc_get_group_id(2);
+    const Ti* c_ptr   = in + batchId * c_batch_stride + row * c_stride1 + (col >> 1) * c_stride2;
+
+    unsigned char md
+        = metadata[batchId * m_batch_stride + row * m_stride1 + (col >> 3) * m_stride2];
+
+    Ti values[4];
+#pragma unroll
+    for(int k = 0; k < 4; k++)
+        values[k] = c_ptr[k * c_stride2];
+
+    Ti out_values[8];
+    decompress_2_4_x8(values, md, out_values);
+
+    Ti* ptr = out + batchId * batch_stride + row * stride1 + col * stride2;
+#pragma unroll
+    for(int k = 0; k < 8; k++)
+        ptr[k * stride2] = out_values[k];
+}
+
+// k is contiguous: each thread expands the 16 bytes of values and the metadata bytes it reads
+// with one load each into 32 bytes of a row, written with two 128-bit stores.
+template <typename Ti, int SG0I, int SG1J>
+__global__ __launch_bounds__(SG0I* SG1J) void
+    decompress_kernel_vec_k(const Ti*            in,
+                            const unsigned char* metadata,
+                            Ti*                  out,
+                            int64_t              m,
+                            int64_t              n,
+                            int64_t              stride1,
+                            int64_t              batch_stride,
+                            int64_t              c_stride1,
+                            int64_t              c_batch_stride,
+                            int64_t              m_stride1,
+                            int64_t              m_batch_stride)
+{
+    constexpr int TT1J     = 32 / sizeof(Ti);
+    constexpr int MD_BYTES = TT1J / 8;
+
+    unsigned int serial = hc_get_workitem_id(0);
+    unsigned int sg1J   = serial % SG1J; // neighbouring threads write neighbouring chunks
+    unsigned int sg0I   = serial / SG1J;
+
+    unsigned int wg0I    = hc_get_group_id(0);
+    unsigned int wg1J    = hc_get_group_id(1);
+    unsigned int batchId = hc_get_group_id(2);
+
+    int64_t row = SG0I * wg0I + sg0I;
+    int64_t col = (SG1J * wg1J + sg1J) * TT1J;
+    if(row >= m || col >= n)
+        return;
+
+    uint4 c_raw = *reinterpret_cast<const uint4*>(in + batchId * c_batch_stride + row * c_stride1
+                                                  + (col >> 1));
+    const Ti* c_vals = reinterpret_cast<const Ti*>(&c_raw);
+
+    const unsigned char* md_ptr
+        = metadata + batchId * m_batch_stride + row * m_stride1 + (col >> 3);
+    uint32_t md;
+    if constexpr(MD_BYTES == 4)
+        md = *reinterpret_cast<const uint32_t*>(md_ptr);
+    else
+        md = *reinterpret_cast<const uint16_t*>(md_ptr);
+
+    uint4 raw[2];
+    Ti*   vals = reinterpret_cast<Ti*>(raw);
+#pragma unroll
+    for(int g = 0; g < MD_BYTES; g++)
+    {
+        Ti values[4];
+#pragma unroll
+        for(int k = 0; k < 4; k++)
+            values[k] = c_vals[g * 4 + k];
+
+        Ti out_values[8];
+        decompress_2_4_x8(values, static_cast<unsigned char>(md >> (g * 8)), out_values);
+#pragma unroll
+        for(int k = 0; k < 8; k++)
+            vals[g * 8 + k] = out_values[k];
+    }
+
+    uint4* dst = reinterpret_cast<uint4*>(out + batchId * batch_stride + row * stride1 + col);
+    dst[0]     = raw[0];
+    dst[1]     = raw[1];
+}
+
+// m is contiguous: the metadata rows of the workgroup are read with one 8-byte load each into
+// LDS, then each thread expands 16 bytes of rows for 8 k, read with a 128-bit load for each of
+// the 4 values and written with a 128-bit store for each k.
+template <typename Ti, int SG0I, int SG1J>
+__global__ __launch_bounds__(SG0I* SG1J) void
+    decompress_kernel_vec_m(const Ti*            in,
+                            const unsigned char* metadata,
+                            Ti*                  out,
+                            int64_t              m,
+                            int64_t              n,
+                            int64_t              stride2,
+                            int64_t              batch_stride,
+                            int64_t              c_stride2,
+                            int64_t              c_batch_stride,
+                            int64_t              m_stride1,
+                            int64_t              m_batch_stride)
+{
+    static_assert(SG1J == 8, "a row of metadata in LDS is written as one uint2");
+    constexpr int TT0I = 16 / sizeof(Ti);
+    constexpr int MT0I = SG0I * TT0I;
+
+    __shared__ uint2     md_lds[MT0I];
+    const unsigned char* md_bytes = reinterpret_cast<const unsigned char*>(md_lds);
+
+    unsigned int serial = hc_get_workitem_id(0);
+    unsigned int sg0I   = serial % SG0I;
+    unsigned int sg1J   = serial / SG0I;
+
+    unsigned int wg0I    = hc_get_group_id(0);
+    unsigned int wg1J    = hc_get_group_id(1);
+    unsigned int batchId = hc_get_group_id(2);
+
+    int64_t row0 = MT0I * wg0I + sg0I * TT0I;
+    int64_t col0 = SG1J * wg1J * 8;
+    int64_t col  = col0 + sg1J * 8;
+
+    int64_t cols = min(static_cast<int64_t>(SG1J), (n - col0) >> 3);
+    for(int r = serial; r < MT0I; r += SG0I * SG1J)
+    {
+        int64_t row = MT0I * wg0I + r;
+        if(row >= m)
+            break;
+        const unsigned char* md_ptr
+            = metadata + batchId * m_batch_stride + row * m_stride1 + (col0 >> 3);
+        if(cols == SG1J)
+            md_lds[r] = *reinterpret_cast<const uint2*>(md_ptr);
+        else
+            for(int k = 0; k < cols; k++)
+                reinterpret_cast<unsigned char*>(md_lds)[r * SG1J + k] = md_ptr[k];
+    }
+    __syncthreads(); // wait until md_lds[] ready
+
+    if(row0 >= m || col >= n)
+        return;
+
+    const Ti* src = in + batchId * c_batch_stride + row0 + (col >> 1) * c_stride2;
+    uint4     c_raw[4];
+#pragma unroll
+    for(int k = 0; k < 4; k++)
+        c_raw[k] = *reinterpret_cast<const uint4*>(src + k * c_stride2);
+
+    uint4 raw[8];
+#pragma unroll
+    for(int r = 0; r < TT0I; r++)
+    {
+        Ti values[4];
+#pragma unroll
+        for(int k = 0; k < 4; k++)
+            values[k] = reinterpret_cast<const Ti*>(&c_raw[k])[r];
+
+        Ti out_values[8];
+        decompress_2_4_x8(values, md_bytes[(sg0I * TT0I + r) * SG1J + sg1J], out_values);
+#pragma unroll
+        for(int k = 0; k < 8; k++)
+            reinterpret_cast<Ti*>(&raw[k])[r] = out_values[k];
+    }
+
+    Ti* dst = out + batchId * batch_stride + row0 + col * stride2;
+#pragma unroll
+    for(int k = 0; k < 8; k++)
+        *reinterpret_cast<uint4*>(dst + k * stride2) = raw[k];
+}
+
+template <typename Ti>
+rocsparselt_status
+    rocsparselt_smfmac_decompress_template(const _rocsparselt_handle* handle,
+                                           int64_t                    m,
+                                           int64_t                    n,
+                                           int64_t                    stride0,
+                                           int64_t                    stride1,
+                                           int64_t                    batch_stride,
+                                           int64_t                    c_stride0,
+                                           int64_t                    c_stride1,
+                                           int64_t                    c_batch_stride,
+                                           int64_t                    m_stride0,
+                                           int64_t                    m_stride1,
+                                           int64_t                    m_batch_stride,
+                                           int                        num_batches,
+                                           const Ti*                  d_in,
+                                           const unsigned char*       d_metadata,
+                                           Ti*                        d_out,
+                                           hipStream_t                stream)
+{
+    auto aligned = [](const void* p, size_t bytes) {
+        return reinterpret_cast<uintptr_t>(p) % bytes == 0;
+    };
+    auto aligned_elems
+        = [](int64_t elems, size_t bytes) { return elems * sizeof(Ti) % bytes == 0; };
+
+    // 4 wavefronts per workgroup, 256 threads on wave64 and 128 threads on wave32 archs.
+    bool wave32 = handle->wavefront_size == 32;
+
+    // the same layouts as rocsparselt_smfmac_compress_template() vectorizes, read and written
+    // the other way around.
+    constexpr int VEC_K_TT1J     = 32 / sizeof(Ti);
+    constexpr int VEC_K_MD_BYTES = VEC_K_TT1J / 8;
+    if(stride1 == 1 && c_stride1 == 1 && m_stride1 == 1 && n % VEC_K_TT1J == 0
+       && aligned(d_in, 16) && aligned(d_out, 16) && aligned(d_metadata, VEC_K_MD_BYTES)
+       && aligned_elems(stride0, 16) && aligned_elems(batch_stride, 16)
+       && aligned_elems(c_stride0, 16) && aligned_elems(c_batch_stride, 16)
+       && m_stride0 % VEC_K_MD_BYTES == 0 && m_batch_stride % VEC_K_MD_BYTES == 0)
+    {
+        constexpr int SG1J = 16;
+        int           SG0I = (wave32 ? 128 : 256) / SG1J;
+
+        int block_x = m / SG0I + (m % SG0I > 0 ? 1 : 0);
+        int block_y = n / (SG1J * VEC_K_TT1J) + (n % (SG1J * VEC_K_TT1J) > 0 ? 1 : 0);
+        hipLaunchKernelGGL((wave32 ? decompress_kernel_vec_k<Ti, 8, SG1J>
+                                   : decompress_kernel_vec_k<Ti, 16, SG1J>),
+                           dim3(block_x, block_y, num_batches),
+                           dim3(SG0I * SG1J),
+                           0 /*dynamic shared*/,
+                           stream,
+                           d_in,
+                           d_metadata,
+                           d_out,
+                           m,
+                           n,
+                           stride0,
+                           batch_stride,
+                           c_stride0,
+                           c_batch_stride,
+                           m_stride0,
+                           m_batch_stride);
+        return rocsparselt_status_success;
+    }
+
+    constexpr int VEC_M_TT0I = 16 / sizeof(Ti);
+    if(stride0 == 1 && c_stride0 == 1 && m_stride1 == 1 && m % VEC_M_TT0I == 0 && n % 8 == 0
+       && aligned(d_in, 16) && aligned(d_out, 16) && aligned(d_metadata, 8)
+       && aligned_elems(stride1, 16) && aligned_elems(batch_stride, 16)
+       && aligned_elems(c_stride1, 16) && aligned_elems(c_batch_stride, 16) && m_stride0 % 8 == 0
+       && m_batch_stride % 8 == 0)
+    {
+        constexpr int SG1J = 8;
+        int           SG0I = (wave32 ? 128 : 256) / SG1J;
+        int           MT0I = SG0I * VEC_M_TT0I;
+
+        int block_x = m / MT0I + (m % MT0I > 0 ? 1 : 0);
+        int block_y = n / (SG1J * 8) + (n % (SG1J * 8) > 0 ? 1 : 0);
+        hipLaunchKernelGGL((wave32 ? decompress_kernel_vec_m<Ti, 16, SG1J>
+                                   : decompress_kernel_vec_m<Ti, 32, SG1J>),
+                           dim3(block_x, block_y, num_batches),
+                           dim3(SG0I * SG1J),
+                           0 /*dynamic shared*/,
+                           stream,
+                           d_in,
+                           d_metadata,
+                           d_out,
+                           m,
+                           n,
+                           stride1,
+                           batch_stride,
+                           c_stride1,
+                           c_batch_stride,
+                           m_stride0,
+                           m_batch_stride);
+        return rocsparselt_status_success;
+    }
+
+    // unaligned matrices.
+    constexpr int SG1J = 4;
+    int           SG0I = (wave32 ? 128 : 256) / SG1J;
+
+    int block_x = m / SG0I + (m % SG0I > 0 ? 1 : 0);
+    int block_y = n / (SG1J * 8) + (n % (SG1J * 8) > 0 ? 1 : 0);
+    hipLaunchKernelGGL((wave32 ? decompress_kernel<Ti, 32, SG1J> : decompress_kernel<Ti, 64, SG1J>),
+                       dim3(block_x, block_y, num_batches),
+                       dim3(SG0I * SG1J),
+                       0 /*dynamic shared*/,
+                       stream,
+                       d_in,
+                       d_metadata,
+                       d_out,
+                       m,
+                       n,
+                       stride0,
+                       stride1,
+                       batch_stride,
+                       c_stride0,
+                       c_stride1,
+                       c_batch_stride,
+                       m_stride0,
+                       m_stride1,
+                       m_batch_stride);
+    return rocsparselt_status_success;
+}
+
+rocsparselt_status rocsparselt_smfmac_decompress_impl(const _rocsparselt_handle* handle,
+                                                      _rocsparselt_mat_descr*    matrix,
+                                                      int                        isSparseA,
+                                                      rocsparselt_operation      op,
+                                                      const void*                d_in,
+                                                      void*                      d_out,
+                                                      hipStream_t                stream)
+{
+    rocsparselt_datatype type = matrix->type;
+
+    int64_t m, n, stride0, stride1, c_stride0, c_stride1;
+    get_compress_matrix_size(isSparseA, op, matrix, m, n, stride0, stride1, c_stride0, c_stride1);
+    int64_t m_stride0 = matrix->c_k / 4;
+    int64_t m_stride1 = 1;
+
+    int     num_batches  = matrix->num_batches;
+    int64_t batch_stride = matrix->batch_stride;
+    //set number of batches to 1, since we only care the first batch under the boradcast case.
+    if(batch_stride == 0)
+    {
+        num_batches  = 1;
+        batch_stride = rocsparselt_matrix_elems(matrix, matrix->ld);
+    }
+    int64_t c_batch_stride = matrix->c_ld * matrix->c_n;
+    int64_t m_batch_stride = matrix->c_ld * matrix->c_n / 4;
+
+    const unsigned char* d_metadata = reinterpret_cast<const unsigned char*>(d_in)
+                                      + rocsparselt_metadata_offset_in_compressed_matrix(
+                                          matrix->c_n, matrix->c_ld, num_batches, type);
+
+#define DECOMPRESS_PARAMS(T)                                                                       \
+    handle, m, n, stride0, stride1, batch_stride, c_stride0, c_stride1, c_batch_stride, m_stride0, \
+        m_stride1, m_batch_stride, num_batches, reinterpret_cast<const T*>(d_in), d_metadata,      \
+        reinterpret_cast<T*>(d_out), stream
+
+    switch(type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return rocsparselt_smfmac_decompress_template<__half>(DECOMPRESS_PARAMS(__half));
+    case rocsparselt_datatype_bf16_r:
+        return rocsparselt_smfmac_decompress_template<hip_bfloat16>(
+            DECOMPRESS_PARAMS(hip_bfloat16));
+    case rocsparselt_datatype_i8_r:
+    // decompressing only moves bytes and tests for zero, which FP8 shares with int8
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
+        return rocsparselt_smfmac_decompress_template<int8_t>(DECOMPRESS_PARAMS(int8_t));
+    default:
+        log_error(handle,
+                  "rocsparselt_smfmac_decompress",
+                  "datatype",
+                  rocsparselt_datatype_to_string(type),
+                  "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+#undef DECOMPRESS_PARAMS
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_decompress(const rocsparselt_handle*      handle,
+                                                 const rocsparselt_matmul_plan* plan,
+                                                 const void*                    d_compressed,
+                                                 void*                          d_dense,
+                                                 hipStream_t                    stream)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, __func__));
+
+    // Check if pointer is valid
+    if(d_compressed == nullptr)
+    {
+        log_error(_handle, __func__, "d_compressed is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(d_dense == nullptr)
+    {
+        log_error(_handle, __func__, "d_dense is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    log_api(_handle,
+            __func__,
+            "plan[in]",
+            *_plan,
+            "d_compressed[in]",
+            d_compressed,
+            "d_dense[out]",
+            d_dense,
+            "stream[in]",
+            stream);
+
+    auto matmul = _plan->matmul_descr;
+    return rocsparselt_smfmac_decompress_impl(
+        _handle,
+        matmul->is_sparse_a ? matmul->matrix_A : matmul->matrix_B,
+        matmul->is_sparse_a,
+        matmul->is_sparse_a ? matmul->op_A : matmul->op_B,
+        d_compressed,
+        d_dense,
+        stream);
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_decompress2(const rocsparselt_handle*    handle,
+                                                  const rocsparselt_mat_descr* sparseMatDescr,
+                                                  int                          isSparseA,
+                                                  rocsparselt_operation        op,
+                                                  const void*                  d_compressed,
+                                                  void*                        d_dense,
+                                                  hipStream_t                  stream)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(sparseMatDescr == nullptr)
+    {
+        log_error(_handle, __func__, "sparseMatDescr is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _sparseMatDescr = reinterpret_cast<_rocsparselt_mat_descr*>(
+        const_cast<rocsparselt_mat_descr*>(sparseMatDescr));
+    if(!_sparseMatDescr->isInit())
+    {
+        log_error(_handle, __func__, "sparseMatDescr did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(op != rocsparselt_operation_none && op != rocsparselt_operation_transpose)
+    {
+        log_error(_handle, __func__, "op is invalid");
+        return rocsparselt_status_invalid_value;
+    }
+
+    // Check if pointer is valid
+    if(d_compressed == nullptr)
+    {
+        log_error(_handle, __func__, "d_compressed is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(d_dense == nullptr)
+    {
+        log_error(_handle, __func__, "d_dense is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    // Check if matrix A is a structured matrix
+    if(_sparseMatDescr->m_type != rocsparselt_matrix_type_structured)
+    {
+        log_error(_handle, __func__, "Matrix is not a structured matrix");
+        return rocsparselt_status_not_implemented;
+    }
+
+    log_api(_handle,
+            __func__,
+            "sparseMatDescr[in]",
+            *_sparseMatDescr,
+            "isSparseA[in]",
+            isSparseA,
+            "op[in]",
+            rocsparselt_operation_to_string(op),
+            "d_compressed[in]",
+            d_compressed,
+            "d_dense[out]",
+            d_dense,
+            "stream[in]",
+            stream);
+
+    return rocsparselt_smfmac_decompress_impl(
+        _handle, _sparseMatDescr, isSparseA, op, d_compressed, d_dense, stream);
+}
+
+#ifdef __cplusplus
+}
+#endif
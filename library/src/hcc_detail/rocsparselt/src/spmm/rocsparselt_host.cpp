@@ -0,0 +1,512 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+/*******************************************************************************
+ * Host prune and compress. They write the same bytes as the device kernels, the
+ * pattern selection and the packing are shared with them, so compressed
+ * matrices can be produced on machines without a GPU. No handle is needed, the
+ * layout is given by the arguments of the structured descriptor and of the
+ * matmul descriptor.
+ ******************************************************************************/
+
+#include "definitions.h"
+#include "handle.h"
+#include "rocsparselt.h"
+#include "rocsparselt_compress.hpp"
+#include "rocsparselt_prune.hpp"
+#include "rocsparselt_spmm_utils.hpp"
+#include "status.h"
+#include "utility.hpp"
+
+#include "hipsparselt_ostream.hpp"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+// the row loops are built once for each instruction set and picked at run time, the device
+// compilation only sees the portable build.
+#if defined(__x86_64__) && !defined(__HIP_DEVICE_COMPILE__)
+#define ROCSPARSELT_HOST_SIMD 1
+#define ROCSPARSELT_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,f16c,fma")))
+#define ROCSPARSELT_TARGET_AVX2 __attribute__((target("avx2,f16c,fma")))
+#else
+#define ROCSPARSELT_HOST_SIMD 0
+#define ROCSPARSELT_TARGET_AVX512
+#define ROCSPARSELT_TARGET_AVX2
+#endif
+
+#define ROCSPARSELT_HOST_INLINE inline __attribute__((always_inline))
+
+enum class host_op
+{
+    prune_strip,
+    prune_tile,
+    compress
+};
+
+// a unit is a row of the matrix, or 4 rows for the tile prune, a group the k elements which are
+// handled together along it.
+template <host_op Op>
+constexpr int host_unit_rows = Op == host_op::prune_tile ? 4 : 1;
+
+template <host_op Op>
+constexpr int host_group_cols = Op == host_op::compress ? 8 : 4;
+
+template <typename Ti, typename Tc, host_op Op>
+ROCSPARSELT_HOST_INLINE void
+    host_group(const rocsparselt_grouped_work& work, int64_t batch, int64_t x, int64_t y)
+{
+    const Ti* in     = reinterpret_cast<const Ti*>(work.in);
+    Ti*       out    = reinterpret_cast<Ti*>(work.out);
+    int64_t   offset = batch * work.batch_stride + x * work.stride1 + y * work.stride2;
+
+    if constexpr(Op == host_op::prune_strip)
+    {
+        Ti values[4];
+#pragma unroll
+        for(int k = 0; k < 4; k++)
+            values[k] = in[offset + k * work.stride2];
+
+        int pos_a, pos_b;
+        prune_strip_select<Ti, Tc>(values, pos_a, pos_b);
+
+#pragma unroll
+        for(int k = 0; k < 4; k++)
+            out[offset + k * work.stride2]
+                = k != pos_a && k != pos_b ? static_cast<Ti>(0.0f) : values[k];
+    }
+    else if constexpr(Op == host_op::prune_tile)
+    {
+        Ti values[16];
+        Tc value_abs[16];
+        prune_tile_load(in, offset, 4, 4, work.stride1, work.stride2, values, value_abs);
+
+        unsigned int mask = prune_tile_select(value_abs);
+
+#pragma unroll
+        for(int x = 0; x < 4; x++)
+        {
+#pragma unroll
+            for(int y = 0; y < 4; y++)
+                out[offset + x * work.stride1 + y * work.stride2]
+                    = ((mask >> (x * 4 + y)) & 1) == 0 ? static_cast<Ti>(0.0f) : values[x * 4 + y];
+        }
+    }
+    else
+    {
+        Ti in_values[8];
+#pragma unroll
+        for(int k = 0; k < 8; k++)
+            in_values[k] = in[offset + k * work.stride2];
+
+        Ti            values[4];
+        unsigned char md = compress_2_4_x8(in_values, values);
+
+        int64_t c_offset
+            = batch * work.c_batch_stride + x * work.c_stride1 + (y >> 1) * work.c_stride2;
+#pragma unroll
+        for(int k = 0; k < 4; k++)
+            out[c_offset + k * work.c_stride2] = values[k];
+
+        int64_t m_offset
+            = batch * work.m_batch_stride + x * work.m_stride1 + (y >> 3) * work.m_stride2;
+        work.metadata[m_offset] = md;
+    }
+}
+
+// handle the units [begin, end) of all the batches. The inner loop runs along the unit stride
+// of the dense matrix, across the groups of a row or across the rows of a group.
+template <typename Ti, typename Tc, host_op Op>
+ROCSPARSELT_HOST_INLINE void
+    host_rows(const rocsparselt_grouped_work& work, int64_t begin, int64_t end)
+{
+    constexpr int rows = host_unit_rows<Op>;
+    constexpr int cols = host_group_cols<Op>;
+
+    const int64_t units  = work.m / rows;
+    const int64_t groups = work.n / cols;
+    const bool    across = work.stride1 == 1 && work.stride2 != 1;
+
+    for(int64_t u = begin; u < end;)
+    {
+        const int64_t batch = u / units;
+        const int64_t first = u % units;
+        const int64_t last  = std::min(units, first + end - u);
+        if(across)
+        {
+            for(int64_t g = 0; g < groups; g++)
+                for(int64_t r = first; r < last; r++)
+                    host_group<Ti, Tc, Op>(work, batch, r * rows, g * cols);
+        }
+        else
+        {
+            for(int64_t r = first; r < last; r++)
+                for(int64_t g = 0; g < groups; g++)
+                    host_group<Ti, Tc, Op>(work, batch, r * rows, g * cols);
+        }
+        u += last - first;
+    }
+}
+
+template <typename Ti, typename Tc, host_op Op>
+ROCSPARSELT_TARGET_AVX512 void
+    host_rows_avx512(const rocsparselt_grouped_work& work, int64_t begin, int64_t end)
+{
+    host_rows<Ti, Tc, Op>(work, begin, end);
+}
+
+template <typename Ti, typename Tc, host_op Op>
+ROCSPARSELT_TARGET_AVX2 void
+    host_rows_avx2(const rocsparselt_grouped_work& work, int64_t begin, int64_t end)
+{
+    host_rows<Ti, Tc, Op>(work, begin, end);
+}
+
+template <typename Ti, typename Tc, host_op Op>
+void host_rows_generic(const rocsparselt_grouped_work& work, int64_t begin, int64_t end)
+{
+    host_rows<Ti, Tc, Op>(work, begin, end);
+}
+
+enum class host_simd
+{
+    generic,
+    avx2,
+    avx512
+};
+
+inline host_simd get_host_simd()
+{
+#if ROCSPARSELT_HOST_SIMD
+    static const host_simd simd = [] {
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+           && __builtin_cpu_supports("avx512vl"))
+            return host_simd::avx512;
+        if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("f16c")
+           && __builtin_cpu_supports("fma"))
+            return host_simd::avx2;
+        return host_simd::generic;
+    }();
+    return simd;
+#else
+    return host_simd::generic;
+#endif
+}
+
+// split the units of all the batches into contiguous ranges, one for each thread.
+template <typename Ti, typename Tc, host_op Op>
+rocsparselt_status host_run(const rocsparselt_grouped_work& work, int numThreads)
+{
+    using rows_fn = void (*)(const rocsparselt_grouped_work&, int64_t, int64_t);
+
+    rows_fn fn = host_rows_generic<Ti, Tc, Op>;
+    switch(get_host_simd())
+    {
+    case host_simd::avx512:
+        fn = host_rows_avx512<Ti, Tc, Op>;
+        break;
+    case host_simd::avx2:
+        fn = host_rows_avx2<Ti, Tc, Op>;
+        break;
+    default:
+        break;
+    }
+
+    const int64_t units = work.num_batches * (work.m / host_unit_rows<Op>);
+    int64_t       num_threads
+        = numThreads > 0 ? numThreads : std::max(1u, std::thread::hardware_concurrency());
+    num_threads = std::max<int64_t>(1, std::min(num_threads, units));
+
+    if(num_threads == 1)
+    {
+        fn(work, 0, units);
+        return rocsparselt_status_success;
+    }
+
+    const int64_t            chunk = (units + num_threads - 1) / num_threads;
+    std::vector<std::thread> threads;
+    for(int64_t begin = 0; begin < units; begin += chunk)
+        threads.emplace_back(fn, std::cref(work), begin, std::min(units, begin + chunk));
+    for(auto& thread : threads)
+        thread.join();
+    return rocsparselt_status_success;
+}
+
+/*******************************************************************************
+ * Fill a descriptor without a handle the way rocsparselt_structured_descr_init()
+ * and rocsparselt_matmul_descr_init() would, and check its arguments.
+ ******************************************************************************/
+rocsparselt_status host_matrix_init(const char*             caller,
+                                    _rocsparselt_mat_descr& matrix,
+                                    int64_t                 rows,
+                                    int64_t                 cols,
+                                    int64_t                 ld,
+                                    rocsparselt_datatype    valueType,
+                                    int                     numBatches,
+                                    int64_t                 batchStride,
+                                    int                     isSparseA,
+                                    rocsparselt_operation   op)
+{
+    int num_elements = 8;
+    switch(valueType)
+    {
+    case rocsparselt_datatype_f16_r:
+    case rocsparselt_datatype_bf16_r:
+        break;
+    case rocsparselt_datatype_i8_r:
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
+        num_elements = 16;
+        break;
+    default:
+        hipsparselt_cerr << caller << ": datatype " << rocsparselt_datatype_to_string(valueType)
+                         << " is not supported" << std::endl;
+        return rocsparselt_status_not_implemented;
+    }
+
+    if(rows <= 0 || cols <= 0 || rows % num_elements != 0 || cols % num_elements != 0)
+    {
+        hipsparselt_cerr << caller << ": row and col must be a positive multiple of "
+                         << num_elements << ", current are " << rows << " and " << cols
+                         << std::endl;
+        return rocsparselt_status_invalid_size;
+    }
+
+    if(ld < rows)
+    {
+        hipsparselt_cerr << caller << ": ld must be larger than or equal to rows" << std::endl;
+        return rocsparselt_status_invalid_size;
+    }
+
+    if(numBatches < 1 || (batchStride != 0 && batchStride < ld * cols))
+    {
+        hipsparselt_cerr << caller << ": numBatches or batchStride is invalid" << std::endl;
+        return rocsparselt_status_invalid_size;
+    }
+
+    if(op != rocsparselt_operation_none && op != rocsparselt_operation_transpose)
+    {
+        hipsparselt_cerr << caller << ": op is invalid" << std::endl;
+        return rocsparselt_status_invalid_value;
+    }
+
+    matrix.m_type       = rocsparselt_matrix_type_structured;
+    matrix.m            = rows;
+    matrix.n            = cols;
+    matrix.ld           = ld;
+    matrix.type         = valueType;
+    matrix.order        = rocsparselt_order_column;
+    matrix.num_batches  = numBatches;
+    matrix.batch_stride = batchStride;
+
+    set_compressed_layout(matrix, isSparseA, op);
+    return rocsparselt_status_success;
+}
+
+// the k-contiguous view of the matrix and, for the compress, of its compressed matrix.
+rocsparselt_grouped_work host_work_init(_rocsparselt_mat_descr& matrix,
+                                        int                     isSparseA,
+                                        rocsparselt_operation   op,
+                                        const void*             in,
+                                        void*                   out)
+{
+    rocsparselt_grouped_work work = {};
+    int64_t                  stride0, stride1, c_stride0, c_stride1;
+    get_compress_matrix_size(
+        isSparseA, op, &matrix, work.m, work.n, stride0, stride1, c_stride0, c_stride1);
+
+    work.num_batches  = matrix.num_batches;
+    work.batch_stride = matrix.batch_stride;
+    //set number of batches to 1, since we only care the first batch under the boradcast case.
+    if(work.batch_stride == 0)
+    {
+        work.num_batches  = 1;
+        work.batch_stride = matrix.n * matrix.ld;
+    }
+
+    int64_t metadata_offset = rocsparselt_metadata_offset_in_compressed_matrix(
+        matrix.c_n, matrix.c_ld, work.num_batches, matrix.type);
+
+    work.in             = in;
+    work.out            = out;
+    work.metadata       = reinterpret_cast<unsigned char*>(out) + metadata_offset;
+    work.stride1        = stride0;
+    work.stride2        = stride1;
+    work.c_stride1      = c_stride0;
+    work.c_stride2      = c_stride1;
+    work.c_batch_stride = matrix.c_ld * matrix.c_n;
+    work.m_stride1      = matrix.c_k / 4;
+    work.m_stride2      = 1;
+    work.m_batch_stride = matrix.c_ld * matrix.c_n / 4;
+    return work;
+}
+
+template <typename Ti, typename Tc>
+rocsparselt_status host_prune_template(const rocsparselt_grouped_work& work,
+                                       rocsparselt_prune_alg           pruneAlg,
+                                       int                             numThreads)
+{
+    if(pruneAlg == rocsparselt_prune_smfmac_strip)
+        return host_run<Ti, Tc, host_op::prune_strip>(work, numThreads);
+    return host_run<Ti, Tc, host_op::prune_tile>(work, numThreads);
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_compressed_size_host(int64_t               rows,
+                                                           int64_t               cols,
+                                                           int64_t               ld,
+                                                           rocsparselt_datatype  valueType,
+                                                           int                   numBatches,
+                                                           int64_t               batchStride,
+                                                           int                   isSparseA,
+                                                           rocsparselt_operation op,
+                                                           size_t*               compressedSize)
+{
+    if(compressedSize == nullptr)
+    {
+        hipsparselt_cerr << __func__ << ": compressedSize is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    _rocsparselt_mat_descr matrix(nullptr);
+    RETURN_IF_ROCSPARSELT_ERROR(host_matrix_init(
+        __func__, matrix, rows, cols, ld, valueType, numBatches, batchStride, isSparseA, op));
+
+    //set the number of batches to 1 since in the broadcast case, we only care about contents in first batch.
+    int num_batches = batchStride == 0 ? 1 : numBatches;
+
+    int64_t metadata_offset = rocsparselt_metadata_offset_in_compressed_matrix(
+        matrix.c_n, matrix.c_ld, num_batches, valueType);
+
+    *compressedSize = matrix.c_ld * matrix.c_n / 4 * num_batches + metadata_offset;
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_prune_host(int64_t               rows,
+                                                 int64_t               cols,
+                                                 int64_t               ld,
+                                                 rocsparselt_datatype  valueType,
+                                                 int                   numBatches,
+                                                 int64_t               batchStride,
+                                                 int                   isSparseA,
+                                                 rocsparselt_operation op,
+                                                 const void*           h_in,
+                                                 void*                 h_out,
+                                                 rocsparselt_prune_alg pruneAlg,
+                                                 int                   numThreads)
+{
+    if(h_in == nullptr || h_out == nullptr)
+    {
+        hipsparselt_cerr << __func__ << ": h_in or h_out is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(pruneAlg != rocsparselt_prune_smfmac_strip && pruneAlg != rocsparselt_prune_smfmac_tile)
+    {
+        hipsparselt_cerr << __func__ << ": prune algorithm is not supported" << std::endl;
+        return rocsparselt_status_not_implemented;
+    }
+
+    _rocsparselt_mat_descr matrix(nullptr);
+    RETURN_IF_ROCSPARSELT_ERROR(host_matrix_init(
+        __func__, matrix, rows, cols, ld, valueType, numBatches, batchStride, isSparseA, op));
+
+    auto work = host_work_init(matrix, isSparseA, op, h_in, h_out);
+
+    switch(valueType)
+    {
+    case rocsparselt_datatype_f16_r:
+        return host_prune_template<__half, float>(work, pruneAlg, numThreads);
+    case rocsparselt_datatype_bf16_r:
+        return host_prune_template<hip_bfloat16, float>(work, pruneAlg, numThreads);
+    case rocsparselt_datatype_i8_r:
+        return host_prune_template<int8_t, float>(work, pruneAlg, numThreads);
+    case rocsparselt_datatype_f8_r:
+        return host_prune_template<__hip_fp8_e4m3_fnuz, float>(work, pruneAlg, numThreads);
+    case rocsparselt_datatype_bf8_r:
+        return host_prune_template<__hip_fp8_e5m2_fnuz, float>(work, pruneAlg, numThreads);
+    default:
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_compress_host(int64_t               rows,
+                                                    int64_t               cols,
+                                                    int64_t               ld,
+                                                    rocsparselt_datatype  valueType,
+                                                    int                   numBatches,
+                                                    int64_t               batchStride,
+                                                    int                   isSparseA,
+                                                    rocsparselt_operation op,
+                                                    const void*           h_dense,
+                                                    void*                 h_compressed,
+                                                    int                   numThreads)
+{
+    if(h_dense == nullptr || h_compressed == nullptr)
+    {
+        hipsparselt_cerr << __func__ << ": h_dense or h_compressed is a NULL pointer"
+                         << std::endl;
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    _rocsparselt_mat_descr matrix(nullptr);
+    RETURN_IF_ROCSPARSELT_ERROR(host_matrix_init(
+        __func__, matrix, rows, cols, ld, valueType, numBatches, batchStride, isSparseA, op));
+
+    auto work = host_work_init(matrix, isSparseA, op, h_dense, h_compressed);
+
+    switch(valueType)
+    {
+    case rocsparselt_datatype_f16_r:
+        return host_run<__half, float, host_op::compress>(work, numThreads);
+    case rocsparselt_datatype_bf16_r:
+        return host_run<hip_bfloat16, float, host_op::compress>(work, numThreads);
+    case rocsparselt_datatype_i8_r:
+    // compressing only moves bytes and tests for zero, which FP8 shares with int8
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
+        return host_run<int8_t, float, host_op::compress>(work, numThreads);
+    default:
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,361 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "rocsparselt_pad.hpp"
+#include "definitions.h"
+#include "handle.h"
+#include "hipsparselt_ostream.hpp"
+#include "rocsparselt_compress.hpp"
+#include "rocsparselt_spmm_utils.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <hip/hip_runtime.h>
+
+namespace
+{
+    constexpr int pad_threads = 256;
+
+    int64_t round_up(int64_t value, int64_t multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    // gives matrix the rows and the cols of its operand of a padded problem, packed
+    void pad_shape(_rocsparselt_mat_descr* matrix, int64_t rows, int64_t cols)
+    {
+        matrix->m  = rows;
+        matrix->n  = cols;
+        matrix->ld = rows;
+        if(matrix->batch_stride != 0)
+            matrix->batch_stride = rows * cols;
+    }
+
+    // the out_rows x out_cols matrices of out, with the values of in inside its in_rows x
+    // in_cols matrices and zeros outside of them. A workgroup row of the grid per batch.
+    template <typename T>
+    __global__ __launch_bounds__(pad_threads) void pad_copy_kernel(const T* in,
+                                                                   T*       out,
+                                                                   int64_t  in_rows,
+                                                                   int64_t  in_cols,
+                                                                   int64_t  in_ld,
+                                                                   int64_t  in_stride,
+                                                                   int64_t  out_rows,
+                                                                   int64_t  out_cols,
+                                                                   int64_t  out_ld,
+                                                                   int64_t  out_stride)
+    {
+        const T* in_batch  = in + int64_t(blockIdx.y) * in_stride;
+        T*       out_batch = out + int64_t(blockIdx.y) * out_stride;
+        const int64_t size = out_rows * out_cols;
+        for(int64_t idx = int64_t(blockIdx.x) * blockDim.x + threadIdx.x; idx < size;
+            idx += int64_t(gridDim.x) * blockDim.x)
+        {
+            int64_t i = idx % out_rows;
+            int64_t j = idx / out_rows;
+            out_batch[i + j * out_ld]
+                = i < in_rows && j < in_cols ? in_batch[i + j * in_ld] : static_cast<T>(0);
+        }
+    }
+
+    template <typename T>
+    hipError_t pad_copy(const _rocsparselt_handle*    handle,
+                        const _rocsparselt_mat_descr* from,
+                        const _rocsparselt_mat_descr* to,
+                        int64_t                       rows,
+                        int64_t                       cols,
+                        int                           num_batches,
+                        const void*                   in,
+                        void*                         out,
+                        hipStream_t                   stream)
+    {
+        int64_t blocks = grid_stride_blocks(
+            handle, (rows * cols + pad_threads - 1) / pad_threads, pad_threads);
+        hipLaunchKernelGGL((pad_copy_kernel<T>),
+                           dim3(blocks, num_batches),
+                           dim3(pad_threads),
+                           0,
+                           stream,
+                           static_cast<const T*>(in),
+                           static_cast<T*>(out),
+                           from->m,
+                           from->n,
+                           from->ld,
+                           from->batch_stride,
+                           rows,
+                           cols,
+                           to->ld,
+                           to->batch_stride);
+        return hipGetLastError();
+    }
+
+    // the kernels only move the bits of the elements, by their size. Copies the rows x cols
+    // matrices of to, a batch stride of 0 of from copies its first matrix to all of them.
+    rocsparselt_status pad_copy_dispatch(const _rocsparselt_mat_descr* from,
+                                         const _rocsparselt_mat_descr* to,
+                                         int64_t                       rows,
+                                         int64_t                       cols,
+                                         const void*                   in,
+                                         void*                         out,
+                                         hipStream_t                   stream)
+    {
+        // a broadcast matrix is padded once, the padded matrix is broadcast as well
+        int num_batches = to->batch_stride == 0 ? 1 : to->num_batches;
+        if(rows == 0 || cols == 0)
+            return rocsparselt_status_success;
+        const _rocsparselt_handle* handle = from->handle;
+        switch(rocsparselt_datatype_bytes(from->type))
+        {
+        case 1:
+            RETURN_IF_HIP_ERROR(
+                pad_copy<uint8_t>(handle, from, to, rows, cols, num_batches, in, out, stream));
+            break;
+        case 2:
+            RETURN_IF_HIP_ERROR(
+                pad_copy<uint16_t>(handle, from, to, rows, cols, num_batches, in, out, stream));
+            break;
+        case 4:
+            RETURN_IF_HIP_ERROR(
+                pad_copy<uint32_t>(handle, from, to, rows, cols, num_batches, in, out, stream));
+            break;
+        default:
+            return rocsparselt_status_not_implemented;
+        }
+        return rocsparselt_status_success;
+    }
+
+    // the zero-padded matrices of to, with the matrices of from at their start
+    rocsparselt_status pad_matrix(const _rocsparselt_mat_descr* from,
+                                  const _rocsparselt_mat_descr* to,
+                                  const void*                   in,
+                                  void*                         out,
+                                  hipStream_t                   stream)
+    {
+        return pad_copy_dispatch(from, to, to->m, to->n, in, out, stream);
+    }
+
+    // the padded dense input comes first in the staging, the padded D follows it
+    size_t padded_d_offset(const _rocsparselt_matmul_descr* padded_descr)
+    {
+        const _rocsparselt_mat_descr* dense
+            = padded_descr->is_sparse_a ? padded_descr->matrix_B : padded_descr->matrix_A;
+        return (rocsparselt_dense_matrix_bytes(dense) + 255) / 256 * 256;
+    }
+}
+
+_rocsparselt_matmul_descr* rocsparselt_padded_descr(const _rocsparselt_matmul_descr* descr)
+{
+    auto* padded = new _rocsparselt_matmul_descr(*descr);
+
+    int64_t mult_a = rocsparselt_pad_multiple(descr->matrix_A->type);
+    int64_t mult_b = rocsparselt_pad_multiple(descr->matrix_B->type);
+    int64_t mult_c = rocsparselt_pad_multiple(descr->matrix_C->type);
+    int64_t mult_d = rocsparselt_pad_multiple(descr->matrix_D->type);
+
+    int64_t m = round_up(descr->m, std::max({mult_a, mult_c, mult_d}));
+    int64_t n = round_up(descr->n, std::max({mult_b, mult_c, mult_d}));
+    int64_t k = round_up(descr->k, std::max(mult_a, mult_b));
+
+    bool trans_a = descr->op_A == rocsparselt_operation_transpose;
+    bool trans_b = descr->op_B == rocsparselt_operation_transpose;
+    pad_shape(padded->matrix_A, trans_a ? k : m, trans_a ? m : k);
+    pad_shape(padded->matrix_B, trans_b ? n : k, trans_b ? k : n);
+    pad_shape(padded->matrix_C, m, n);
+    pad_shape(padded->matrix_D, m, n);
+    padded->m = m;
+    padded->n = n;
+    padded->k = k;
+
+    // the info of the compressed matrix, as rocsparselt_matmul_descr_init() fills it
+    if(descr->is_sparse_a)
+    {
+        padded->matrix_A->c_k  = k / 2;
+        padded->matrix_A->c_ld = trans_a ? k / 2 : m;
+        padded->matrix_A->c_n  = trans_a ? m : k / 2;
+    }
+    else
+    {
+        padded->matrix_B->c_k  = k / 2;
+        padded->matrix_B->c_ld = trans_b ? n : k / 2;
+        padded->matrix_B->c_n  = trans_b ? k / 2 : n;
+    }
+    return padded;
+}
+
+rocsparselt_status rocsparselt_check_paddable(const _rocsparselt_handle*       handle,
+                                              const _rocsparselt_matmul_descr* descr,
+                                              const char*                      caller)
+{
+    // the pad copies the sparse matrix in column order
+    const _rocsparselt_mat_descr* sparse = descr->is_sparse_a ? descr->matrix_A : descr->matrix_B;
+    if(sparse->order == rocsparselt_order_row)
+    {
+        hipsparselt_cerr << "A padded matmul has a column ordered structured matrix" << std::endl;
+        log_error(handle, caller, "a row ordered structured matrix cannot be padded");
+        return rocsparselt_status_not_implemented;
+    }
+    // the compressed matrix of a dynamic sparse matmul takes the place of the padded matrices
+    if(descr->sparse_dynamic)
+    {
+        hipsparselt_cerr << "A padded matmul has a compressed structured matrix" << std::endl;
+        log_error(handle, caller, "a dynamic sparse matmul cannot be padded");
+        return rocsparselt_status_not_implemented;
+    }
+    // so does the widened compressed matrix of a mixed input matmul
+    if(rocsparselt_is_mixed_input(descr))
+    {
+        hipsparselt_cerr << "A padded matmul has a single input type" << std::endl;
+        log_error(handle, caller, "a mixed input matmul cannot be padded");
+        return rocsparselt_status_not_implemented;
+    }
+    if(descr->bias_pointer == nullptr && !descr->alpha_vector_scaling
+       && !descr->beta_vector_scaling && descr->amax_d_pointer == nullptr
+       && descr->residual_pointer == nullptr && descr->gate_pointer == nullptr
+       && descr->bias_grad_pointer == nullptr)
+        return rocsparselt_status_success;
+    hipsparselt_cerr << "A padded matmul has no bias, vector scaling, amax(D), residual, gate nor "
+                        "bias gradient"
+                     << std::endl;
+    log_error(handle, caller, "the epilogue of D cannot be padded");
+    return rocsparselt_status_not_implemented;
+}
+
+rocsparselt_status rocsparselt_check_aligned(const _rocsparselt_handle*    handle,
+                                             const _rocsparselt_mat_descr* matrix,
+                                             const char*                   caller)
+{
+    if(!rocsparselt_needs_padding(matrix))
+        return rocsparselt_status_success;
+    hipsparselt_cerr << "The rows and cols of the matrix must be a multiple of "
+                     << rocsparselt_pad_multiple(matrix->type)
+                     << ", only the functions taking a plan pad them" << std::endl;
+    log_error(handle, caller, "the matrix needs the padding of a plan");
+    return rocsparselt_status_not_implemented;
+}
+
+rocsparselt_status rocsparselt_check_aligned(const _rocsparselt_handle*       handle,
+                                             const _rocsparselt_matmul_descr* descr,
+                                             const char*                      caller)
+{
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(handle, descr->matrix_A, caller));
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(handle, descr->matrix_B, caller));
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(handle, descr->matrix_C, caller));
+    return rocsparselt_check_aligned(handle, descr->matrix_D, caller);
+}
+
+rocsparselt_status rocsparselt_check_unpadded(const _rocsparselt_handle*      handle,
+                                              const _rocsparselt_matmul_plan* plan,
+                                              const char*                     caller)
+{
+    if(plan->unpadded_descr == nullptr)
+        return rocsparselt_status_success;
+    hipsparselt_cerr << "The plan pads the shapes of its matmul, which this function does not "
+                        "support"
+                     << std::endl;
+    log_error(handle, caller, "not supported by a padded plan");
+    return rocsparselt_status_not_implemented;
+}
+
+size_t rocsparselt_pad_workspace_offset(const _rocsparselt_matmul_alg_selection* alg_selection)
+{
+    size_t bytes = 0;
+    for(int i = 0; i < alg_selection->config_max_id; i++)
+        bytes = std::max<size_t>(bytes, alg_selection->configs[i].max_workspace_bytes);
+    // the padded matrices start on an aligned address
+    return (bytes + 255) / 256 * 256;
+}
+
+size_t rocsparselt_pad_staging_bytes(const _rocsparselt_matmul_descr* padded_descr)
+{
+    return padded_d_offset(padded_descr) + rocsparselt_dense_matrix_bytes(padded_descr->matrix_D);
+}
+
+size_t rocsparselt_pad_sparse_bytes(const _rocsparselt_matmul_descr* padded_descr)
+{
+    return rocsparselt_dense_matrix_bytes(padded_descr->is_sparse_a ? padded_descr->matrix_A
+                                                                    : padded_descr->matrix_B);
+}
+
+rocsparselt_status rocsparselt_pad_sparse(const _rocsparselt_matmul_plan* plan,
+                                          const void*                     d_dense,
+                                          void*                           buffer,
+                                          hipStream_t                     stream)
+{
+    const _rocsparselt_matmul_descr* user   = plan->unpadded_descr;
+    const _rocsparselt_matmul_descr* padded = plan->matmul_descr;
+    return user->is_sparse_a
+               ? pad_matrix(user->matrix_A, padded->matrix_A, d_dense, buffer, stream)
+               : pad_matrix(user->matrix_B, padded->matrix_B, d_dense, buffer, stream);
+}
+
+rocsparselt_status rocsparselt_pad_operands(const _rocsparselt_matmul_plan* plan,
+                                            void*                           staging,
+                                            const void**                    d_A,
+                                            const void**                    d_B,
+                                            const void**                    d_C,
+                                            void**                          d_D,
+                                            hipStream_t                     stream)
+{
+    const _rocsparselt_matmul_descr* user   = plan->unpadded_descr;
+    const _rocsparselt_matmul_descr* padded = plan->matmul_descr;
+
+    void* padded_d = static_cast<char*>(staging) + padded_d_offset(padded);
+    if(user->is_sparse_a)
+    {
+        RETURN_IF_ROCSPARSELT_ERROR(
+            pad_matrix(user->matrix_B, padded->matrix_B, *d_B, staging, stream));
+        *d_B = staging;
+    }
+    else
+    {
+        RETURN_IF_ROCSPARSELT_ERROR(
+            pad_matrix(user->matrix_A, padded->matrix_A, *d_A, staging, stream));
+        *d_A = staging;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(
+        pad_matrix(user->matrix_C, padded->matrix_D, *d_C, padded_d, stream));
+    *d_C = padded_d;
+    *d_D = padded_d;
+    return rocsparselt_status_success;
+}
+
+rocsparselt_status rocsparselt_unpad_result(const _rocsparselt_matmul_plan* plan,
+                                            const void*                     staging,
+                                            void*                           d_D,
+                                            hipStream_t                     stream)
+{
+    const _rocsparselt_mat_descr* padded_d = plan->matmul_descr->matrix_D;
+    const _rocsparselt_mat_descr* user_d   = plan->unpadded_descr->matrix_D;
+    // the copy of the matrices of the caller drops the padded rows and cols
+    return pad_copy_dispatch(padded_d,
+                             user_d,
+                             user_d->m,
+                             user_d->n,
+                             static_cast<const char*>(staging)
+                                 + padded_d_offset(plan->matmul_descr),
+                             d_D,
+                             stream);
+}
@@ -26,8 +26,14 @@
 
 #include "definitions.h"
 #include "handle.h"
+#include "launch_table.hpp"
 #include "rocsparselt.h"
+#include "rocsparselt_compress.hpp"
+#include "rocsparselt_pad.hpp"
+#include "rocsparselt_prune.hpp"
+#include "rocsparselt_spmm_utils.hpp"
 #include "status.h"
+#include "tracing.hpp"
 #include "utility.hpp"
 
 #include "hipsparselt_ostream.hpp"
@@ -57,7 +63,9 @@ __global__ void prune_check_kernel(const Ti* in,
     unsigned int wg1J    = hc_get_group_id(1);
     unsigned int batchId = hc_get_group_id(2);
 
-    if((MT1J * wg1J + sg1J * TT1J) >= n || (MT0I * wg0I + sg0I * TT0I) >= m)
+    const int64_t row = MT0I * wg0I + sg0I * TT0I;
+    const int64_t col = MT1J * wg1J + sg1J * TT1J;
+    if(col >= n || row >= m)
         return;
 
     int64_t wg_stride = MT1J * wg1J * stride2 + MT0I * wg0I * stride1;
@@ -65,9 +73,9 @@ __global__ void prune_check_kernel(const Ti* in,
 
     int64_t globalReadOffset = b_stride + wg_stride + stride;
 
-    for(int i = 0; i < TT0I; i++)
+    for(int i = 0; i < TT0I && row + i < m; i++)
     {
-        for(int j = 0; j < TT1J; j += 4)
+        for(int j = 0; j < TT1J && col + j < n; j += 4)
         {
             if(*out)
                 return;
@@ -79,7 +87,7 @@ __global__ void prune_check_kernel(const Ti* in,
             for(int k = 0; k < 4; k++)
             {
                 int64_t pos = globalReadOffset + offset + k * stride2;
-                if(pos < sizes)
+                if(pos < sizes && col + j + k < n)
                 {
                     if(in[pos] != static_cast<Ti>(0.0))
                     {
@@ -96,31 +104,82 @@ __global__ void prune_check_kernel(const Ti* in,
     }
 }
 
-template <typename Ti, typename Tc>
-__host__ __device__ inline Tc norm1(Ti a, Ti b)
+// Counts the groups of 4 along k which have more than 2 nonzeros. With VEC each thread reads 16
+// bytes of a k contiguous row, otherwise one group with neighbouring threads on neighbouring rows.
+// The counts are scanned across the wavefront, which then claims a range of the offset list and
+// adds its total to the counter with a single atomic.
+template <typename Ti, int BLOCK, bool VEC>
+__global__ __launch_bounds__(BLOCK) void prune_check_count_kernel(const Ti* in,
+                                                                  int64_t*  count,
+                                                                  int64_t*  offsets,
+                                                                  int       max_offsets,
+                                                                  int64_t   m,
+                                                                  int64_t   n,
+                                                                  int64_t   stride1,
+                                                                  int64_t   stride2,
+                                                                  int64_t   batch_stride)
 {
-    Tc ac = static_cast<Tc>(a);
-    Tc bc = static_cast<Tc>(b);
-    return static_cast<Tc>(abs(ac) + abs(bc));
-}
+    constexpr int GROUPS = VEC ? 16 / (4 * sizeof(Ti)) : 1;
 
-template <typename T>
-__host__ __device__ inline T sum(T a, T b, T c, T d, T e, T f, T g, T h)
-{
-    return a + b + c + d + e + f + g + h;
-}
+    unsigned int serial  = hc_get_workitem_id(0);
+    unsigned int batchId = hc_get_group_id(1);
+    int64_t      t       = static_cast<int64_t>(hc_get_group_id(0)) * BLOCK + serial;
 
-template <typename T>
-__host__ __device__ inline T acc_sum8(T* v, uint8_t* p, int v_offset, int p_offset)
-{
-    return sum<T>(v[v_offset + p[p_offset]],
-                  v[v_offset + p[p_offset + 1]],
-                  v[v_offset + 1 * 4 + p[p_offset + 2]],
-                  v[v_offset + 1 * 4 + p[p_offset + 3]],
-                  v[v_offset + 2 * 4 + p[p_offset + 4]],
-                  v[v_offset + 2 * 4 + p[p_offset + 5]],
-                  v[v_offset + 3 * 4 + p[p_offset + 6]],
-                  v[v_offset + 3 * 4 + p[p_offset + 7]]);
+    int64_t groups_per_row = VEC ? n / (4 * GROUPS) : (n + 3) / 4;
+    int64_t row = VEC ? t / groups_per_row : t % m;
+    int64_t col = (VEC ? t % groups_per_row : t / m) * 4 * GROUPS;
+
+    int64_t offset = batchId * batch_stride + row * stride1 + col * stride2;
+    int     nz[GROUPS];
+    int     c = 0;
+    if(row < m && col < n)
+    {
+        Ti values[4 * GROUPS];
+        if constexpr(VEC)
+        {
+            *reinterpret_cast<uint4*>(values) = *reinterpret_cast<const uint4*>(in + offset);
+        }
+        else
+        {
+#pragma unroll
+            for(int k = 0; k < 4; k++)
+                values[k] = col + k < n ? in[offset + k * stride2] : static_cast<Ti>(0.0f);
+        }
+#pragma unroll
+        for(int g = 0; g < GROUPS; g++)
+        {
+            nz[g] = 0;
+#pragma unroll
+            for(int k = 0; k < 4; k++)
+                nz[g] += values[g * 4 + k] != static_cast<Ti>(0.0f) ? 1 : 0;
+            c += nz[g] > 2 ? 1 : 0;
+        }
+    }
+
+    int lane   = serial % warpSize;
+    int prefix = c;
+    for(int d = 1; d < warpSize; d <<= 1)
+    {
+        int v = __shfl_up(prefix, d);
+        prefix += lane >= d ? v : 0;
+    }
+    int                total = __shfl(prefix, warpSize - 1);
+    unsigned long long base  = 0;
+    if(lane == warpSize - 1 && total > 0)
+        base = atomicAdd(reinterpret_cast<unsigned long long*>(count),
+                         static_cast<unsigned long long>(total));
+
+    base = __shfl(base, warpSize - 1);
+
+    if(offsets == nullptr || c == 0)
+        return;
+    int64_t slot = static_cast<int64_t>(base) + prefix - c;
+#pragma unroll
+    for(int g = 0; g < GROUPS; g++)
+    {
+        if(nz[g] > 2 && slot < max_offsets)
+            offsets[slot++] = offset + g * 4 * stride2;
+    }
 }
 
 template <typename T, bool InPlace, typename = void>
@@ -136,15 +195,17 @@ __host__ __device__ inline void prune_if(bool prune, T* a, T b)
 }
 
 template <typename Ti, typename Tc, int SG0I, int SG1J, int TT0I, int TT1J, bool InPlace>
-__global__ void prune_strip_kernel(const Ti* in,
-                                   Ti*       out,
-                                   int64_t   m,
-                                   int64_t   n,
-                                   int64_t   stride1,
-                                   int64_t   stride2,
-                                   int       num_batches,
-                                   int64_t   batch_stride,
-                                   int64_t   sizes)
+__device__ inline void prune_strip_block(const Ti*    in,
+                                         Ti*          out,
+                                         int64_t      m,
+                                         int64_t      n,
+                                         int64_t      stride1,
+                                         int64_t      stride2,
+                                         int64_t      batch_stride,
+                                         int64_t      sizes,
+                                         int64_t      wg0I,
+                                         int64_t      wg1J,
+                                         int64_t      batchId)
 {
     constexpr unsigned int MT0I = SG0I * TT0I;
     constexpr unsigned int MT1J = SG1J * TT1J;
@@ -154,11 +215,9 @@ __global__ void prune_strip_kernel(const Ti* in,
     unsigned int sg1J   = serial / SG0I;
     int64_t      stride = sg0I * stride1 + sg1J * TT1J * stride2;
 
-    unsigned int wg0I    = hc_get_group_id(0);
-    unsigned int wg1J    = hc_get_group_id(1);
-    unsigned int batchId = hc_get_group_id(2);
-
-    if((MT1J * wg1J + sg1J * TT1J) >= n || (MT0I * wg0I + sg0I * TT0I) >= m)
+    const int64_t row = MT0I * wg0I + sg0I * TT0I;
+    const int64_t col = MT1J * wg1J + sg1J * TT1J;
+    if(col >= n || row >= m)
         return;
 
     int64_t wg_stride = MT1J * wg1J * stride2 + MT0I * wg0I * stride1;
@@ -166,9 +225,11 @@ __global__ void prune_strip_kernel(const Ti* in,
 
     int64_t globalReadOffset = b_stride + wg_stride + stride;
 
-    for(int i = 0; i < TT0I; i++)
+    // the elements past the last row or col are zeros which are never written, a group cut by
+    // the last col is pruned as if it were zero-extended
+    for(int i = 0; i < TT0I && row + i < m; i++)
     {
-        for(int j = 0; j < TT1J; j += 4)
+        for(int j = 0; j < TT1J && col + j < n; j += 4)
         {
             int64_t offset = globalReadOffset + i * stride1 + j * stride2;
             Ti      values[4];
@@ -176,194 +237,473 @@ __global__ void prune_strip_kernel(const Ti* in,
             for(int k = 0; k < 4; k++)
             {
                 int64_t pos    = offset + k * stride2;
-                bool    update = pos >= sizes;
+                bool    update = pos >= sizes || col + j + k >= n;
                 values[k]      = update ? static_cast<Ti>(0.0f) : in[pos];
             }
 
-            auto max_norm1 = static_cast<Tc>(-1.0);
-            int  pos_a = 0, pos_b = 0;
+            int pos_a, pos_b;
+            prune_strip_select<Ti, Tc>(values, pos_a, pos_b);
 
 #pragma unroll 4
-            for(int a = 0; a < 4; a++)
+            for(int k = 0; k < 4; k++)
             {
-                for(int b = a + 1; b < 4; b++)
-                {
-                    auto norm1_v = norm1<Ti, Tc>(values[a], values[b]);
-                    bool update  = norm1_v > max_norm1;
-                    pos_a        = update ? a : pos_a;
-                    pos_b        = update ? b : pos_b;
-                    max_norm1    = update ? norm1_v : max_norm1;
-                }
+                int64_t pos = offset + k * stride2;
+                if(col + j + k < n)
+                    prune_if<Ti, InPlace>(k != pos_a && k != pos_b, &out[pos], values[k]);
             }
+        }
+    }
+}
 
-#pragma unroll 4
-            for(int k = 0; k < 4; k++)
+// the blocks_x x blocks_y tiles of every batch are visited by a grid-stride loop, see
+// grid_stride_blocks()
+template <typename Ti, typename Tc, int SG0I, int SG1J, int TT0I, int TT1J, bool InPlace>
+__global__ void prune_strip_kernel(const Ti* in,
+                                   Ti*       out,
+                                   int64_t   m,
+                                   int64_t   n,
+                                   int64_t   stride1,
+                                   int64_t   stride2,
+                                   int       num_batches,
+                                   int64_t   batch_stride,
+                                   int64_t   sizes,
+                                   int64_t   blocks_x,
+                                   int64_t   blocks_y)
+{
+    const int64_t blocks = blocks_x * blocks_y;
+    for(int64_t tile = hc_get_group_id(0); tile < blocks * num_batches; tile += gridDim.x)
+        prune_strip_block<Ti, Tc, SG0I, SG1J, TT0I, TT1J, InPlace>(in,
+                                                                   out,
+                                                                   m,
+                                                                   n,
+                                                                   stride1,
+                                                                   stride2,
+                                                                   batch_stride,
+                                                                   sizes,
+                                                                   tile % blocks_x,
+                                                                   tile % blocks / blocks_x,
+                                                                   tile / blocks);
+}
+
+// one thread prunes a whole 4x4 tile, the tile is read before any of it is written.
+template <typename Ti, typename Tc, int SG0I, int SG1J, bool InPlace>
+__device__ inline void prune_tile_block(const Ti*    in,
+                                        Ti*          out,
+                                        int64_t      m,
+                                        int64_t      n,
+                                        int64_t      stride1,
+                                        int64_t      stride2,
+                                        int64_t      batch_stride,
+                                        int64_t      wg0I,
+                                        int64_t      wg1J,
+                                        int64_t      batchId)
+{
+    constexpr unsigned int MT0I = SG0I * 4;
+    constexpr unsigned int MT1J = SG1J * 4;
+
+    const unsigned int serial = hc_get_workitem_id(0);
+    const unsigned int sg0I   = serial % SG0I;
+    const unsigned int sg1J   = serial / SG0I;
+
+    const int64_t tile_x = MT0I * wg0I + sg0I * 4;
+    const int64_t tile_y = MT1J * wg1J + sg1J * 4;
+    if(tile_y >= n || tile_x >= m)
+        return;
+
+    const int64_t offset = batchId * batch_stride + tile_x * stride1 + tile_y * stride2;
+
+    Ti values[16];
+    Tc value_abs[16];
+    prune_tile_load(in, offset, m - tile_x, n - tile_y, stride1, stride2, values, value_abs);
+
+    unsigned int mask = prune_tile_select(value_abs);
+
+#pragma unroll
+    for(int x = 0; x < 4; x++)
+    {
+#pragma unroll
+        for(int y = 0; y < 4; y++)
+        {
+            if(tile_x + x < m && tile_y + y < n)
+                prune_if<Ti, InPlace>(((mask >> (x * 4 + y)) & 1) == 0,
+                                      &out[offset + x * stride1 + y * stride2],
+                                      values[x * 4 + y]);
+        }
+    }
+}
+
+template <typename Ti, typename Tc, int SG0I, int SG1J, bool InPlace>
+__global__ __launch_bounds__(SG0I* SG1J) void prune_tile_kernel(const Ti* in,
+                                                                Ti*       out,
+                                                                int64_t   m,
+                                                                int64_t   n,
+                                                                int64_t   stride1,
+                                                                int64_t   stride2,
+                                                                int       num_batches,
+                                                                int64_t   batch_stride,
+                                                                int64_t   sizes,
+                                                                int64_t   blocks_x,
+                                                                int64_t   blocks_y)
+{
+    const int64_t blocks = blocks_x * blocks_y;
+    for(int64_t tile = hc_get_group_id(0); tile < blocks * num_batches; tile += gridDim.x)
+        prune_tile_block<Ti, Tc, SG0I, SG1J, InPlace>(in,
+                                                      out,
+                                                      m,
+                                                      n,
+                                                      stride1,
+                                                      stride2,
+                                                      batch_stride,
+                                                      tile % blocks_x,
+                                                      tile % blocks / blocks_x,
+                                                      tile / blocks);
+}
+
+// prune all the matrices of a work list, the workgroups of every matrix are laid out along x.
+// A thread only writes the elements it has read, so the inputs may be pruned in place.
+template <typename Ti, typename Tc, int SG0I, int SG1J, int TT0I, int TT1J, bool Tile>
+__global__ __launch_bounds__(SG0I* SG1J) void prune_grouped_kernel(
+    const rocsparselt_grouped_work* works, int count)
+{
+    const int64_t                   block = hc_get_group_id(0);
+    const rocsparselt_grouped_work* work  = grouped_work_find(works, count, block);
+
+    const int64_t local   = block - work->block_start;
+    const int64_t blocks  = static_cast<int64_t>(work->blocks_x) * work->blocks_y;
+    unsigned int  wg0I    = local % work->blocks_x;
+    unsigned int  wg1J    = local % blocks / work->blocks_x;
+    unsigned int  batchId = local / blocks;
+
+    const Ti* in  = reinterpret_cast<const Ti*>(work->in);
+    Ti*       out = reinterpret_cast<Ti*>(work->out);
+    if constexpr(Tile)
+        prune_tile_block<Ti, Tc, SG0I, SG1J, false>(in,
+                                                    out,
+                                                    work->m,
+                                                    work->n,
+                                                    work->stride1,
+                                                    work->stride2,
+                                                    work->batch_stride,
+                                                    wg0I,
+                                                    wg1J,
+                                                    batchId);
+    else
+        prune_strip_block<Ti, Tc, SG0I, SG1J, TT0I, TT1J, false>(in,
+                                                                 out,
+                                                                 work->m,
+                                                                 work->n,
+                                                                 work->stride1,
+                                                                 work->stride2,
+                                                                 work->batch_stride,
+                                                                 work->num_batches
+                                                                     * work->batch_stride,
+                                                                 wg0I,
+                                                                 wg1J,
+                                                                 batchId);
+}
+
+// prune 4 rows and 8 k elements, two groups of each row or two 4x4 tiles, and write the 4 bytes
+// of the mask they cover when mask is not null. Bit j of a nibble is set when element j of the
+// group is kept, the low nibble holds the first group of a byte. The elements are ranked by the
+// norm1 of their score: score, in the layout of in, or the value itself, times col_scale[k] when
+// col_scale is not null. The whole block is read before any of it is written.
+template <typename Ti, typename Tc, int BLOCK, bool Tile>
+__global__ __launch_bounds__(BLOCK) void prune_mask_kernel(const Ti*      in,
+                                                           Ti*            out,
+                                                           unsigned char* mask,
+                                                           const float*   score,
+                                                           const float*   col_scale,
+                                                           int64_t        m,
+                                                           int64_t        n,
+                                                           int64_t        stride1,
+                                                           int64_t        stride2,
+                                                           int64_t        batch_stride,
+                                                           int64_t        mask_batch_stride)
+{
+    unsigned int batchId = hc_get_group_id(1);
+    int64_t      t       = static_cast<int64_t>(hc_get_group_id(0)) * BLOCK + hc_get_workitem_id(0);
+
+    // neighbouring threads on the contiguous dimension
+    int64_t row_blocks = (m + 3) / 4;
+    int64_t col_blocks = n / 8;
+    int64_t row        = (stride1 == 1 ? t % row_blocks : t / col_blocks) * 4;
+    int64_t col        = (stride1 == 1 ? t / row_blocks : t % col_blocks) * 8;
+    if(row >= m || col >= n)
+        return;
+
+    int64_t offset = batchId * batch_stride + row * stride1 + col * stride2;
+    int64_t rows   = m - row;
+
+    // the rows outside the matrix are 0 and never kept by the tile selection
+    Ti values[4][8];
+    Tc ranks[4][8];
+#pragma unroll
+    for(int x = 0; x < 4; x++)
+    {
+#pragma unroll
+        for(int y = 0; y < 8; y++)
+        {
+            int64_t pos  = offset + x * stride1 + y * stride2;
+            values[x][y] = static_cast<Ti>(0.0f);
+            ranks[x][y]  = static_cast<Tc>(0.0f);
+            if(x >= rows)
+                continue;
+            values[x][y] = in[pos];
+            Tc rank = std::abs(score != nullptr ? static_cast<Tc>(score[pos])
+                                                : static_cast<Tc>(values[x][y]));
+            ranks[x][y] = col_scale != nullptr ? rank * col_scale[col + y] : rank;
+        }
+    }
+
+    unsigned char bits[4] = {0, 0, 0, 0};
+#pragma unroll
+    for(int h = 0; h < 2; h++)
+    {
+        if constexpr(Tile)
+        {
+            Tc tile_abs[16];
+#pragma unroll
+            for(int x = 0; x < 4; x++)
             {
-                int64_t pos = offset + k * stride2;
-                prune_if<Ti, InPlace>(k != pos_a && k != pos_b, &out[pos], values[k]);
+#pragma unroll
+                for(int y = 0; y < 4; y++)
+                    tile_abs[x * 4 + y] = ranks[x][h * 4 + y];
+            }
+            unsigned int tile_mask = prune_tile_select(tile_abs);
+#pragma unroll
+            for(int x = 0; x < 4; x++)
+                bits[x] |= ((tile_mask >> (x * 4)) & 0xF) << (h * 4);
+        }
+        else
+        {
+#pragma unroll
+            for(int x = 0; x < 4; x++)
+            {
+                Tc group[4] = {
+                    ranks[x][h * 4], ranks[x][h * 4 + 1], ranks[x][h * 4 + 2], ranks[x][h * 4 + 3]};
+                int pos_a, pos_b;
+                prune_strip_select<Tc, Tc>(group, pos_a, pos_b);
+                bits[x] |= ((1 << pos_a) | (1 << pos_b)) << (h * 4);
             }
         }
     }
+
+#pragma unroll
+    for(int x = 0; x < 4; x++)
+    {
+        if(x >= rows)
+            break;
+#pragma unroll
+        for(int y = 0; y < 8; y++)
+            out[offset + x * stride1 + y * stride2]
+                = (bits[x] >> y) & 1 ? values[x][y] : static_cast<Ti>(0.0f);
+        if(mask != nullptr)
+            mask[batchId * mask_batch_stride + (row + x) * (n / 8) + col / 8] = bits[x];
+    }
 }
 
-template <typename Ti,
-          typename Tc,
-          int  SG0I,
-          int  SG1J,
-          int  TT0I,
-          int  TT1J,
-          int  PATTERNS_COUNT,
-          int  THREADS_PER_SG,
-          int  PATTERNS_PER_THREAD,
-          bool InPlace>
-__global__
-    __launch_bounds__(SG0I* SG1J* THREADS_PER_SG) void prune_tile_kernel(const Ti* in,
-                                                                         Ti*       out,
-                                                                         int64_t   m,
-                                                                         int64_t   n,
-                                                                         int64_t   stride1,
-                                                                         int64_t   stride2,
-                                                                         int       num_batches,
-                                                                         int64_t   batch_stride,
-                                                                         int64_t   sizes)
-{
-    constexpr int  PAD = 0;
-    __shared__ Tc  value_abs[(16 + PAD) * SG0I * SG1J];
-    __shared__ Tc  norm_res[THREADS_PER_SG * SG0I * SG1J];
-    __shared__ int norm_idx[THREADS_PER_SG * SG0I * SG1J];
-
-    // 90 patterns, that pick 2 elements from each row and column from a 4x4 tile, total pick 8 elements.
-    // the first pattern: 0, 2, 0, 2, 1, 3, 1, 3 => COL#(ROW#,ROW#) = 0(0,2), 1(0,2), 2(1,3), 3(1,3)
-    __constant__ static uint8_t pos_patterns[90 * 4 * 2] = {
-        0, 2, 0, 2, 1, 3, 1, 3, 0, 2, 0, 3, 1, 3, 1, 2, 0, 2, 0, 3, 1, 2, 1, 3, 0, 2, 0, 1, 1, 3,
-        2, 3, 0, 2, 0, 1, 2, 3, 1, 3, 0, 2, 1, 3, 0, 2, 1, 3, 0, 2, 1, 3, 0, 3, 1, 2, 0, 2, 1, 3,
-        0, 1, 2, 3, 0, 2, 1, 3, 1, 3, 0, 2, 0, 2, 1, 3, 1, 2, 0, 3, 0, 2, 1, 3, 2, 3, 0, 1, 0, 2,
-        1, 2, 0, 3, 1, 3, 0, 2, 1, 2, 1, 3, 0, 3, 0, 2, 2, 3, 0, 1, 1, 3, 0, 2, 2, 3, 1, 3, 0, 1,
-        0, 3, 0, 2, 1, 3, 1, 2, 0, 3, 0, 2, 1, 2, 1, 3, 0, 3, 0, 3, 1, 2, 1, 2, 0, 3, 0, 1, 1, 2,
-        2, 3, 0, 3, 0, 1, 2, 3, 1, 2, 0, 3, 1, 3, 0, 2, 1, 2, 0, 3, 1, 3, 1, 2, 0, 2, 0, 3, 1, 2,
-        0, 2, 1, 3, 0, 3, 1, 2, 0, 3, 1, 2, 0, 3, 1, 2, 0, 1, 2, 3, 0, 3, 1, 2, 1, 3, 0, 2, 0, 3,
-        1, 2, 1, 2, 0, 3, 0, 3, 1, 2, 2, 3, 0, 1, 0, 3, 2, 3, 0, 1, 1, 2, 0, 3, 2, 3, 1, 2, 0, 1,
-        0, 1, 0, 2, 1, 3, 2, 3, 0, 1, 0, 2, 2, 3, 1, 3, 0, 1, 0, 3, 1, 2, 2, 3, 0, 1, 0, 3, 2, 3,
-        1, 2, 0, 1, 0, 1, 2, 3, 2, 3, 0, 1, 1, 3, 0, 2, 2, 3, 0, 1, 1, 3, 2, 3, 0, 2, 0, 1, 1, 2,
-        0, 3, 2, 3, 0, 1, 1, 2, 2, 3, 0, 3, 0, 1, 2, 3, 0, 2, 1, 3, 0, 1, 2, 3, 0, 3, 1, 2, 0, 1,
-        2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 1, 3, 0, 2, 0, 1, 2, 3, 1, 2, 0, 3, 0, 1, 2, 3, 2, 3, 0, 1,
-        1, 3, 0, 2, 0, 2, 1, 3, 1, 3, 0, 2, 0, 3, 1, 2, 1, 3, 0, 2, 0, 1, 2, 3, 1, 3, 0, 2, 1, 3,
-        0, 2, 1, 3, 0, 2, 1, 2, 0, 3, 1, 3, 0, 2, 2, 3, 0, 1, 1, 3, 0, 3, 0, 2, 1, 2, 1, 3, 0, 3,
-        1, 2, 0, 2, 1, 3, 0, 1, 0, 2, 2, 3, 1, 3, 0, 1, 2, 3, 0, 2, 1, 3, 1, 3, 0, 2, 0, 2, 1, 3,
-        1, 2, 0, 2, 0, 3, 1, 3, 1, 2, 0, 3, 0, 2, 1, 3, 2, 3, 0, 2, 0, 1, 1, 3, 2, 3, 0, 1, 0, 2,
-        1, 2, 0, 2, 0, 3, 1, 3, 1, 2, 0, 2, 1, 3, 0, 3, 1, 2, 0, 3, 0, 2, 1, 3, 1, 2, 0, 3, 0, 3,
-        1, 2, 1, 2, 0, 3, 0, 1, 2, 3, 1, 2, 0, 3, 1, 3, 0, 2, 1, 2, 0, 3, 1, 2, 0, 3, 1, 2, 0, 3,
-        2, 3, 0, 1, 1, 2, 0, 1, 0, 3, 2, 3, 1, 2, 0, 1, 2, 3, 0, 3, 1, 2, 1, 3, 0, 2, 0, 3, 1, 2,
-        1, 3, 0, 3, 0, 2, 1, 2, 1, 2, 0, 3, 0, 3, 1, 2, 2, 3, 0, 3, 0, 1, 1, 2, 2, 3, 0, 1, 0, 3,
-        2, 3, 0, 2, 0, 1, 1, 3, 2, 3, 0, 2, 1, 3, 0, 1, 2, 3, 0, 3, 0, 1, 1, 2, 2, 3, 0, 3, 1, 2,
-        0, 1, 2, 3, 0, 1, 0, 2, 1, 3, 2, 3, 0, 1, 0, 3, 1, 2, 2, 3, 0, 1, 0, 1, 2, 3, 2, 3, 0, 1,
-        1, 3, 0, 2, 2, 3, 0, 1, 1, 2, 0, 3, 2, 3, 0, 1, 2, 3, 0, 1, 2, 3, 1, 3, 0, 2, 0, 1, 2, 3,
-        1, 3, 0, 1, 0, 2, 2, 3, 1, 2, 0, 3, 0, 1, 2, 3, 1, 2, 0, 1, 0, 3, 2, 3, 2, 3, 0, 1, 0, 1,
-    };
+// zero the elements of 8 k elements of a row whose bit of the mask byte is clear.
+template <typename Ti, int BLOCK>
+__global__ __launch_bounds__(BLOCK) void mask_apply_kernel(const Ti*            in,
+                                                           Ti*                  out,
+                                                           const unsigned char* mask,
+                                                           int64_t              m,
+                                                           int64_t              n,
+                                                           int64_t              stride1,
+                                                           int64_t              stride2,
+                                                           int64_t              batch_stride,
+                                                           int64_t              mask_batch_stride)
+{
+    unsigned int batchId = hc_get_group_id(1);
+    int64_t      t       = static_cast<int64_t>(hc_get_group_id(0)) * BLOCK + hc_get_workitem_id(0);
+
+    int64_t col_blocks = n / 8;
+    int64_t row        = stride1 == 1 ? t % m : t / col_blocks;
+    int64_t col        = (stride1 == 1 ? t / m : t % col_blocks) * 8;
+    if(row >= m || col >= n)
+        return;
+
+    int64_t       offset = batchId * batch_stride + row * stride1 + col * stride2;
+    unsigned char bits   = mask[batchId * mask_batch_stride + row * col_blocks + col / 8];
+#pragma unroll
+    for(int y = 0; y < 8; y++)
+    {
+        int64_t pos = offset + y * stride2;
+        out[pos]    = (bits >> y) & 1 ? in[pos] : static_cast<Ti>(0.0f);
+    }
+}
+
+template <typename Ti, typename Tc, int SG0I, int SG1J, int TT0I, int TT1J>
+__global__ void prune_strip_compress_kernel(const Ti*      in,
+                                            Ti*            out,
+                                            unsigned char* metadata,
+                                            int64_t        m,
+                                            int64_t        n,
+                                            int64_t        stride1,
+                                            int64_t        stride2,
+                                            int64_t        batch_stride,
+                                            int64_t        c_stride1,
+                                            int64_t        c_stride2,
+                                            int64_t        c_batch_stride,
+                                            int64_t        m_stride1,
+                                            int64_t        m_stride2,
+                                            int64_t        m_batch_stride,
+                                            int            num_batches,
+                                            int64_t        sizes)
+{
+    constexpr int metadata_tiles_y = 8;
+    constexpr int tiles_y          = 4;
 
     constexpr unsigned int MT0I = SG0I * TT0I;
     constexpr unsigned int MT1J = SG1J * TT1J;
 
-    const unsigned int serial
-        = hc_get_workitem_id(0); //total has SG0I * SG1J * (THREADS_PER_SG) threads.
-    const unsigned int serial_g  = serial / THREADS_PER_SG; //work idx of SG
-    const unsigned int serial_gt = serial % THREADS_PER_SG; //thread idx in SG
-    const unsigned int sg0I      = serial_g % SG0I;
-    const unsigned int sg1J      = serial_g / SG0I;
-    const int64_t      stride    = sg0I * TT0I * stride1 + sg1J * TT1J * stride2;
+    unsigned int serial = hc_get_workitem_id(0);
+    unsigned int sg0I   = serial % SG0I;
+    unsigned int sg1J   = serial / SG0I;
 
-    const unsigned int wg0I    = hc_get_group_id(0);
-    const unsigned int wg1J    = hc_get_group_id(1);
-    const unsigned int batchId = hc_get_group_id(2);
+    unsigned int wg0I    = hc_get_group_id(0);
+    unsigned int wg1J    = hc_get_group_id(1);
+    unsigned int batchId = hc_get_group_id(2);
 
-    const int64_t wg_pos_x = MT0I * wg0I + sg0I * TT0I;
-    const int64_t wg_pos_y = MT1J * wg1J + sg1J * TT1J;
-    if((wg_pos_y) >= n || (wg_pos_x) >= m)
+    if((MT1J * wg1J + sg1J * TT1J) >= n || (MT0I * wg0I + sg0I * TT0I) >= m)
         return;
 
-    const int64_t wg_stride      = MT1J * wg1J * stride2 + MT0I * wg0I * stride1;
-    const int64_t b_stride       = batchId * batch_stride;
-    int           serial_gt_     = serial_gt > 15 ? 15 : serial_gt;
-    const int     x              = (serial_gt_) % 4;
-    const int     y              = (serial_gt_) / 4;
-    const int     value_offset   = serial_g * (16 + PAD);
-    const int     c_value_offset = value_offset + (serial_gt_);
+    int64_t stride           = sg0I * stride1 + sg1J * TT1J * stride2;
+    int64_t wg_stride        = MT1J * wg1J * stride2 + MT0I * wg0I * stride1;
+    int64_t globalReadOffset = batchId * batch_stride + wg_stride + stride;
 
-    const int norm_res_offset   = serial_g * THREADS_PER_SG;
-    const int c_norm_res_offset = norm_res_offset + serial_gt;
-    int64_t   globalReadOffset  = b_stride + wg_stride + stride + x * stride1 + y * stride2;
+    int64_t c_stride          = (sg0I * TT0I * c_stride1) + (sg1J * TT1J * c_stride2 >> 1);
+    int64_t c_wg_stride       = (MT0I * wg0I * c_stride1) + (MT1J * wg1J * c_stride2 >> 1);
+    int64_t globalWriteOffset = batchId * c_batch_stride + c_wg_stride + c_stride;
 
-    int64_t pos;
-    for(int j = 0; j < TT1J; j += 4)
+    int64_t m_stride    = (sg0I * m_stride1) + (sg1J * TT1J * m_stride2 >> 3);
+    int64_t m_wg_stride = (MT0I * wg0I * m_stride1) + (MT1J * wg1J * m_stride2 >> 3);
+    int64_t globalWriteMetadataOffset = batchId * m_batch_stride + m_wg_stride + m_stride;
+
+    for(int i = 0; i < TT0I; i++)
     {
-        pos = globalReadOffset;
-        for(int i = 0; i < TT0I; i += 4)
+        for(int j = 0; j < TT1J; j += metadata_tiles_y)
         {
-            Ti c_value = static_cast<Ti>(0.0f);
-            // read 4x4 from the in matrix.
+            int64_t offset = globalReadOffset + i * stride1 + j * stride2;
+
+            // prune the two groups of 4 in registers, the pruned matrix is never written.
+            Ti pruned[metadata_tiles_y];
+#pragma unroll
+            for(int t = 0; t < metadata_tiles_y / tiles_y; t++)
             {
-                if((wg_pos_x + i + x) < m && (wg_pos_y + j + y) < n)
+                Ti values[tiles_y];
+#pragma unroll
+                for(int k = 0; k < tiles_y; k++)
                 {
-                    c_value = in[pos];
+                    int64_t pos = offset + (k + t * tiles_y) * stride2;
+                    values[k]   = pos >= sizes ? static_cast<Ti>(0.0f) : in[pos];
                 }
-                value_abs[c_value_offset] = abs(static_cast<Tc>(c_value));
+
+                int pos_a, pos_b;
+                prune_strip_select<Ti, Tc>(values, pos_a, pos_b);
+
+#pragma unroll
+                for(int k = 0; k < tiles_y; k++)
+                    pruned[k + t * tiles_y]
+                        = (k != pos_a && k != pos_b) ? static_cast<Ti>(0.0f) : values[k];
             }
 
-            {
-                int  offset             = min(serial_gt, PATTERNS_COUNT - 1);
-                auto pos_pattern_offset = offset << 3;
-                Tc   max_norm           = static_cast<Tc>(-1.f);
-                int  max_norm_idx_      = 0;
+            Ti            values[tiles_y];
+            unsigned char md = compress_2_4_x8(pruned, values);
 
-                __syncthreads(); //wait until value_abs[] ready
+            int64_t c_offset = globalWriteOffset + i * c_stride1 + (j >> 1) * c_stride2;
+#pragma unroll
+            for(int k = 0; k < tiles_y; k++)
+                out[c_offset + k * c_stride2] = values[k];
+            metadata[globalWriteMetadataOffset + i * m_stride1 + (j >> 3) * m_stride2] = md;
+        }
+    }
+}
 
-                // caculate norm1 result for each pattern
-#pragma unroll PATTERNS_PER_THREAD
-                for(int k = 0; k < PATTERNS_PER_THREAD; k++)
-                {
-                    Tc tmp_norm = acc_sum8(
-                        &value_abs[0], &pos_patterns[0], value_offset, pos_pattern_offset);
-                    bool update   = max_norm < tmp_norm;
-                    max_norm      = update ? tmp_norm : max_norm;
-                    max_norm_idx_ = update ? pos_pattern_offset : max_norm_idx_;
-                    offset += THREADS_PER_SG;
-                    offset             = min(offset, PATTERNS_COUNT - 1);
-                    pos_pattern_offset = offset << 3;
-                }
+// Each thread prunes the two 4x4 tiles of a 4x8 block in registers the same way prune_tile_kernel
+// does, then compresses the 4 rows of the block.
+template <typename Ti, typename Tc, int SG0I, int SG1J>
+__global__ __launch_bounds__(SG0I* SG1J) void prune_tile_compress_kernel(const Ti*      in,
+                                                                         Ti*            out,
+                                                                         unsigned char* metadata,
+                                                                         int64_t        m,
+                                                                         int64_t        n,
+                                                                         int64_t        stride1,
+                                                                         int64_t        stride2,
+                                                                         int64_t batch_stride,
+                                                                         int64_t c_stride1,
+                                                                         int64_t c_stride2,
+                                                                         int64_t c_batch_stride,
+                                                                         int64_t m_stride1,
+                                                                         int64_t m_stride2,
+                                                                         int64_t m_batch_stride,
+                                                                         int     num_batches,
+                                                                         int64_t sizes)
+{
+    constexpr int TT0I = 4;
+    constexpr int TT1J = 8;
 
-                norm_res[c_norm_res_offset] = max_norm;
-                norm_idx[c_norm_res_offset] = max_norm_idx_;
-                __syncthreads(); //wait until norm_res[], norm_idx[] ready
-            }
+    constexpr unsigned int MT0I = SG0I * TT0I;
+    constexpr unsigned int MT1J = SG1J * TT1J;
 
-// find the pattern who has the largest norm1 value
-#pragma unroll 5 //log2(THREADS_PER_SG)
-            for(int tidxs = THREADS_PER_SG >> 1; tidxs > 0; tidxs >>= 1)
-            {
-                Tc   a                      = norm_res[c_norm_res_offset];
-                Tc   b                      = norm_res[c_norm_res_offset + tidxs];
-                int  b_idx                  = norm_idx[c_norm_res_offset + tidxs];
-                bool update                 = serial_gt < tidxs && a < b;
-                norm_res[c_norm_res_offset] = update ? b : norm_res[c_norm_res_offset];
-                norm_idx[c_norm_res_offset] = update ? b_idx : norm_idx[c_norm_res_offset];
-                __syncthreads(); //wait until norm_res[], norm_idx[] ready
-            };
-
-            // write 4x4 to the out matrix.
-            {
-                if((wg_pos_x + i + x) < m && (wg_pos_y + j + y) < n)
-                {
-                    prune_if<Ti, InPlace>(pos_patterns[norm_idx[norm_res_offset] + y * 2] != x
-                                              && pos_patterns[norm_idx[norm_res_offset] + y * 2 + 1]
-                                                     != x,
-                                          &out[pos],
-                                          c_value);
-                }
-            }
-            pos += (stride1 << 2);
-            __syncthreads(); // wait until norm_res[], norm_idx[] use completed.
+    const unsigned int serial = hc_get_workitem_id(0);
+    const unsigned int sg0I   = serial % SG0I;
+    const unsigned int sg1J   = serial / SG0I;
+
+    const unsigned int wg0I    = hc_get_group_id(0);
+    const unsigned int wg1J    = hc_get_group_id(1);
+    const unsigned int batchId = hc_get_group_id(2);
+
+    const int64_t tile_x = MT0I * wg0I + sg0I * TT0I;
+    const int64_t tile_y = MT1J * wg1J + sg1J * TT1J;
+    if(tile_y >= n || tile_x >= m)
+        return;
+
+    const int64_t offset = batchId * batch_stride + tile_x * stride1 + tile_y * stride2;
+
+    // the surviving values of the block, row by row.
+    Ti pruned[TT0I][TT1J];
+#pragma unroll
+    for(int j = 0; j < TT1J; j += 4)
+    {
+        Ti values[16];
+        Tc value_abs[16];
+        prune_tile_load(in,
+                        offset + j * stride2,
+                        m - tile_x,
+                        n - tile_y - j,
+                        stride1,
+                        stride2,
+                        values,
+                        value_abs);
+
+        unsigned int mask = prune_tile_select(value_abs);
+#pragma unroll
+        for(int x = 0; x < 4; x++)
+        {
+#pragma unroll
+            for(int y = 0; y < 4; y++)
+                pruned[x][j + y] = ((mask >> (x * 4 + y)) & 1) ? values[x * 4 + y]
+                                                               : static_cast<Ti>(0.0f);
+        }
+    }
+
+#pragma unroll
+    for(int x = 0; x < TT0I; x++)
+    {
+        const int64_t row = tile_x + x;
+        if(row < m)
+        {
+            Ti            values[4];
+            unsigned char md = compress_2_4_x8(pruned[x], values);
+
+            int64_t c_offset
+                = batchId * c_batch_stride + row * c_stride1 + (tile_y >> 1) * c_stride2;
+#pragma unroll
+            for(int k = 0; k < 4; k++)
+                out[c_offset + k * c_stride2] = values[k];
+            metadata[batchId * m_batch_stride + row * m_stride1 + (tile_y >> 3) * m_stride2] = md;
         }
-        globalReadOffset += (stride2 << 2);
     }
 }
 
@@ -383,7 +723,116 @@ void get_prune_matrix_size(bool is_sparse_a, rocsparselt_operation op,  _rocspar
         stride0 = (op == rocsparselt_operation_transpose) ? 1 : _sparseMatDescr->ld;
         stride1 = (op == rocsparselt_operation_transpose) ? _sparseMatDescr->ld : 1;
     }
+    // a row ordered matrix is the transpose of the column ordered one in memory
+    if(_sparseMatDescr->order == rocsparselt_order_row)
+        std::swap(stride0, stride1);
+}
+template <typename Ti, typename Tc, int SG0I, int SG1J>
+void prune_strip_launch(const _rocsparselt_handle* handle,
+                        int64_t                    m,
+                        int64_t                    n,
+                        int64_t                    stride0,
+                        int64_t                    stride1,
+                        int                        num_batches,
+                        int64_t                    batch_stride,
+                        const Ti*                  d_in,
+                        Ti*                        d_out,
+                        hipStream_t                stream)
+{
+    constexpr int TT0I = 1;
+    constexpr int TT1J = 4;
+    constexpr int MT0I = SG0I * TT0I;
+    constexpr int MT1J = SG1J * TT1J;
+
+    int64_t block_x = m / MT0I + (m % MT0I > 0 ? 1 : 0);
+    int64_t block_y = n / MT1J + (n % MT1J > 0 ? 1 : 0);
+    int64_t blocks  = grid_stride_blocks(handle, block_x * block_y * num_batches, SG0I * SG1J);
+
+    void (*func)(const Ti* in,
+                 Ti*       out,
+                 int64_t   m,
+                 int64_t   n,
+                 int64_t   stride1,
+                 int64_t   stride2,
+                 int       num_batches,
+                 int64_t   batch_stride,
+                 int64_t   sizes,
+                 int64_t   blocks_x,
+                 int64_t   blocks_y);
+    if(d_in == d_out)
+        func = prune_strip_kernel<Ti, Tc, SG0I, SG1J, TT0I, TT1J, true>;
+    else
+        func = prune_strip_kernel<Ti, Tc, SG0I, SG1J, TT0I, TT1J, false>;
+    hipLaunchKernelGGL(func, /* compute kernel*/
+                       dim3(blocks),
+                       dim3(SG0I * SG1J),
+                       0 /*dynamic shared*/,
+                       stream,
+                       d_in,
+                       d_out,
+                       m,
+                       n,
+                       stride0,
+                       stride1,
+                       num_batches,
+                       batch_stride,
+                       num_batches * batch_stride,
+                       block_x,
+                       block_y);
 }
+
+template <typename Ti, typename Tc, int SG0I, int SG1J>
+void prune_tile_launch(const _rocsparselt_handle* handle,
+                       int64_t                    m,
+                       int64_t                    n,
+                       int64_t                    stride0,
+                       int64_t                    stride1,
+                       int                        num_batches,
+                       int64_t                    batch_stride,
+                       const Ti*                  d_in,
+                       Ti*                        d_out,
+                       hipStream_t                stream)
+{
+    constexpr int MT0I = SG0I * 4;
+    constexpr int MT1J = SG1J * 4;
+
+    int64_t block_x = m / MT0I + (m % MT0I > 0 ? 1 : 0);
+    int64_t block_y = n / MT1J + (n % MT1J > 0 ? 1 : 0);
+    int64_t blocks  = grid_stride_blocks(handle, block_x * block_y * num_batches, SG0I * SG1J);
+
+    void (*func)(const Ti* in,
+                 Ti*       out,
+                 int64_t   m,
+                 int64_t   n,
+                 int64_t   stride1,
+                 int64_t   stride2,
+                 int       num_batches,
+                 int64_t   batch_stride,
+                 int64_t   sizes,
+                 int64_t   blocks_x,
+                 int64_t   blocks_y);
+    if(d_in == d_out)
+        func = prune_tile_kernel<Ti, Tc, SG0I, SG1J, true>;
+    else
+        func = prune_tile_kernel<Ti, Tc, SG0I, SG1J, false>;
+    hipLaunchKernelGGL(func, /* compute kernel*/
+                       dim3(blocks),
+                       dim3(SG0I * SG1J),
+                       0 /*dynamic shared*/,
+                       stream,
+                       d_in,
+                       d_out,
+                       m,
+                       n,
+                       stride0,
+                       stride1,
+                       num_batches,
+                       batch_stride,
+                       num_batches * batch_stride,
+                       block_x,
+                       block_y);
+}
+
 template <typename Ti, typename Tc>
 rocsparselt_status rocsparselt_smfmac_prune_template(const _rocsparselt_handle* handle,
                                                      int64_t                    m,
@@ -393,115 +842,53 @@ rocsparselt_status rocsparselt_smfmac_prune_template(const _rocsparselt_handle*
                                                      int                        num_batches,
                                                      int64_t                    batch_stride,
                                                      rocsparselt_order          order,
+                                                     rocsparselt_datatype       type,
                                                      const Ti*                  d_in,
                                                      Ti*                        d_out,
                                                      rocsparselt_prune_alg      pruneAlg,
                                                      hipStream_t                stream)
 {
+#define PRUNE_LAUNCH_PARAMS                                                        \
+    handle, m, n, stride0, stride1, num_batches, batch_stride, d_in, d_out, stream
+    // the workgroup sizes of the variants of launch_table.hpp
     if(pruneAlg == rocsparselt_prune_smfmac_strip)
     {
-        constexpr int SG0I = 16;
-        constexpr int SG1J = 4;
-        constexpr int TT0I = 1;
-        constexpr int TT1J = 4;
-        constexpr int MT0I = SG0I * TT0I;
-        constexpr int MT1J = SG1J * TT1J;
-
-        int block_x = m / MT0I + (m % MT0I > 0 ? 1 : 0);
-        int block_y = n / MT1J + (n % MT1J > 0 ? 1 : 0);
-
-        void (*func)(const Ti* in,
-                     Ti*       out,
-                     int64_t   m,
-                     int64_t   n,
-                     int64_t   stride1,
-                     int64_t   stride2,
-                     int       num_batches,
-                     int64_t   batch_stride,
-                     int64_t   sizes);
-        if(d_in == d_out)
-            func = prune_strip_kernel<Ti, Tc, SG0I, SG1J, TT0I, TT1J, true>;
-        else
-            func = prune_strip_kernel<Ti, Tc, SG0I, SG1J, TT0I, TT1J, false>;
-        hipLaunchKernelGGL(func, /* compute kernel*/
-                           dim3(block_x, block_y, num_batches),
-                           dim3(SG0I * SG1J),
-                           0 /*dynamic shared*/,
-                           stream,
-                           d_in,
-                           d_out,
-                           m,
-                           n,
-                           stride0,
-                           stride1,
-                           num_batches,
-                           batch_stride,
-                           num_batches * batch_stride);
+        switch(rocsparselt_launch_variant(
+            handle, rocsparselt_launch_kernel::prune_strip, type, stride1 == 1))
+        {
+        case 1:
+            prune_strip_launch<Ti, Tc, 64, 4>(PRUNE_LAUNCH_PARAMS);
+            break;
+        case 2:
+            prune_strip_launch<Ti, Tc, 16, 16>(PRUNE_LAUNCH_PARAMS);
+            break;
+        case 3:
+            prune_strip_launch<Ti, Tc, 32, 8>(PRUNE_LAUNCH_PARAMS);
+            break;
+        default:
+            prune_strip_launch<Ti, Tc, 16, 4>(PRUNE_LAUNCH_PARAMS);
+            break;
+        }
         return rocsparselt_status_success;
     }
     else if(pruneAlg == rocsparselt_prune_smfmac_tile)
     {
-        constexpr int SG0I           = 4;
-        constexpr int SG1J           = 4;
-        constexpr int TT0I           = 4;
-        constexpr int TT1J           = 4;
-        constexpr int MT0I           = SG0I * TT0I;
-        constexpr int MT1J           = SG1J * TT1J;
-        constexpr int PATTERNS_COUNT = 90; // 90 pre-gernated pattens.
-        constexpr int THREADS_PER_SG = 32; // fix at 16
-        constexpr int PATTERNS_PER_THREAD
-            = PATTERNS_COUNT / THREADS_PER_SG + (PATTERNS_COUNT % THREADS_PER_SG != 0 ? 1 : 0);
-
-        int block_x = m / MT0I + (m % MT0I > 0 ? 1 : 0);
-        int block_y = n / MT1J + (n % MT1J > 0 ? 1 : 0);
-
-        void (*func)(const Ti* in,
-                     Ti*       out,
-                     int64_t   m,
-                     int64_t   n,
-                     int64_t   stride1,
-                     int64_t   stride2,
-                     int       num_batches,
-                     int64_t   batch_stride,
-                     int64_t   sizes);
-        if(d_in == d_out)
-            func = prune_tile_kernel<Ti,
-                                     Tc,
-                                     SG0I,
-                                     SG1J,
-                                     TT0I,
-                                     TT1J,
-                                     PATTERNS_COUNT,
-                                     THREADS_PER_SG,
-                                     PATTERNS_PER_THREAD,
-                                     true>;
-        else
-            func = prune_tile_kernel<Ti,
-                                     Tc,
-                                     SG0I,
-                                     SG1J,
-                                     TT0I,
-                                     TT1J,
-                                     PATTERNS_COUNT,
-                                     THREADS_PER_SG,
-                                     PATTERNS_PER_THREAD,
-                                     false>;
-        hipLaunchKernelGGL(func, /* compute kernel*/
-                           dim3(block_x, block_y, num_batches),
-                           dim3(SG0I * SG1J * THREADS_PER_SG),
-                           0 /*dynamic shared*/,
-                           stream,
-                           d_in,
-                           d_out,
-                           m,
-                           n,
-                           stride0,
-                           stride1,
-                           num_batches,
-                           batch_stride,
-                           num_batches * batch_stride);
+        switch(rocsparselt_launch_variant(
+            handle, rocsparselt_launch_kernel::prune_tile, type, stride1 == 1))
+        {
+        case 1:
+            prune_tile_launch<Ti, Tc, 8, 8>(PRUNE_LAUNCH_PARAMS);
+            break;
+        case 2:
+            prune_tile_launch<Ti, Tc, 16, 4>(PRUNE_LAUNCH_PARAMS);
+            break;
+        default:
+            prune_tile_launch<Ti, Tc, 16, 16>(PRUNE_LAUNCH_PARAMS);
+            break;
+        }
         return rocsparselt_status_success;
     }
+#undef PRUNE_LAUNCH_PARAMS
     return rocsparselt_status_not_implemented;
 }
 
@@ -546,11 +933,395 @@ rocsparselt_status rocsparselt_smfmac_prune_check_template(const _rocsparselt_ha
     return rocsparselt_status_success;
 }
 
-#ifdef __cplusplus
-extern "C" {
-#endif
+template <typename Ti>
+rocsparselt_status rocsparselt_smfmac_prune_check_count_template(const _rocsparselt_handle* handle,
+                                                                 int64_t                    m,
+                                                                 int64_t                    n,
+                                                                 int64_t                    stride0,
+                                                                 int64_t                    stride1,
+                                                                 int     num_batches,
+                                                                 int64_t batch_stride,
+                                                                 const Ti* d_in,
+                                                                 int64_t*  d_count,
+                                                                 int64_t*  d_offsets,
+                                                                 int       max_offsets,
+                                                                 hipStream_t stream)
+{
+    constexpr int BLOCK    = 256;
+    constexpr int VEC_ELEM = 16 / sizeof(Ti);
 
-rocsparselt_status rocsparselt_smfmac_prune_impl(const _rocsparselt_handle*    handle,
+    bool vec = stride1 == 1 && n % VEC_ELEM == 0 && reinterpret_cast<uintptr_t>(d_in) % 16 == 0
+               && stride0 * sizeof(Ti) % 16 == 0 && batch_stride * sizeof(Ti) % 16 == 0;
+
+    int64_t threads = vec ? m * (n / VEC_ELEM) : m * ((n + 3) / 4);
+    int     block_x = threads / BLOCK + (threads % BLOCK > 0 ? 1 : 0);
+
+    RETURN_IF_HIP_ERROR(hipMemsetAsync(d_count, 0, sizeof(int64_t), stream));
+    hipLaunchKernelGGL((vec ? prune_check_count_kernel<Ti, BLOCK, true>
+                            : prune_check_count_kernel<Ti, BLOCK, false>), /* compute kernel*/
+                       dim3(block_x, num_batches),
+                       dim3(BLOCK),
+                       0 /*dynamic shared*/,
+                       stream,
+                       d_in,
+                       d_count,
+                       d_offsets,
+                       max_offsets,
+                       m,
+                       n,
+                       stride0,
+                       stride1,
+                       batch_stride);
+    return rocsparselt_status_success;
+}
+
+template <typename Ti, typename Tc>
+rocsparselt_status rocsparselt_smfmac_prune_mask_template(const _rocsparselt_handle* handle,
+                                                          int64_t                    m,
+                                                          int64_t                    n,
+                                                          int64_t                    stride0,
+                                                          int64_t                    stride1,
+                                                          int                        num_batches,
+                                                          int64_t                    batch_stride,
+                                                          const Ti*                  d_in,
+                                                          Ti*                        d_out,
+                                                          unsigned char*             d_mask,
+                                                          const float*               d_score,
+                                                          const float*               d_colScale,
+                                                          rocsparselt_prune_alg      pruneAlg,
+                                                          hipStream_t                stream)
+{
+    constexpr int BLOCK = 256;
+
+    int64_t threads = (m + 3) / 4 * (n / 8);
+    int     block_x = threads / BLOCK + (threads % BLOCK > 0 ? 1 : 0);
+
+    hipLaunchKernelGGL((pruneAlg == rocsparselt_prune_smfmac_tile
+                            ? prune_mask_kernel<Ti, Tc, BLOCK, true>
+                            : prune_mask_kernel<Ti, Tc, BLOCK, false>), /* compute kernel*/
+                       dim3(block_x, num_batches),
+                       dim3(BLOCK),
+                       0 /*dynamic shared*/,
+                       stream,
+                       d_in,
+                       d_out,
+                       d_mask,
+                       d_score,
+                       d_colScale,
+                       m,
+                       n,
+                       stride0,
+                       stride1,
+                       batch_stride,
+                       m * (n / 8));
+    return rocsparselt_status_success;
+}
+
+template <typename Ti>
+rocsparselt_status rocsparselt_smfmac_mask_apply_template(const _rocsparselt_handle* handle,
+                                                          int64_t                    m,
+                                                          int64_t                    n,
+                                                          int64_t                    stride0,
+                                                          int64_t                    stride1,
+                                                          int                        num_batches,
+                                                          int64_t                    batch_stride,
+                                                          const Ti*                  d_in,
+                                                          Ti*                        d_out,
+                                                          const unsigned char*       d_mask,
+                                                          hipStream_t                stream)
+{
+    constexpr int BLOCK = 256;
+
+    int64_t threads = m * (n / 8);
+    int     block_x = threads / BLOCK + (threads % BLOCK > 0 ? 1 : 0);
+
+    hipLaunchKernelGGL((mask_apply_kernel<Ti, BLOCK>), /* compute kernel*/
+                       dim3(block_x, num_batches),
+                       dim3(BLOCK),
+                       0 /*dynamic shared*/,
+                       stream,
+                       d_in,
+                       d_out,
+                       d_mask,
+                       m,
+                       n,
+                       stride0,
+                       stride1,
+                       batch_stride,
+                       m * (n / 8));
+    return rocsparselt_status_success;
+}
+
+template <typename Ti, typename Tc>
+rocsparselt_status rocsparselt_smfmac_prune_compress_template(const _rocsparselt_handle* handle,
+                                                              int64_t                    m,
+                                                              int64_t                    n,
+                                                              int64_t                    stride0,
+                                                              int64_t                    stride1,
+                                                              int64_t               batch_stride,
+                                                              int64_t               c_stride0,
+                                                              int64_t               c_stride1,
+                                                              int64_t               c_batch_stride,
+                                                              int64_t               m_stride0,
+                                                              int64_t               m_stride1,
+                                                              int64_t               m_batch_stride,
+                                                              int                   num_batches,
+                                                              rocsparselt_order     order,
+                                                              const Ti*             d_in,
+                                                              Ti*                   d_out,
+                                                              unsigned char*        d_metadata,
+                                                              rocsparselt_prune_alg pruneAlg,
+                                                              hipStream_t           stream)
+{
+    void (*func)(const Ti*      in,
+                 Ti*            out,
+                 unsigned char* metadata,
+                 int64_t        m,
+                 int64_t        n,
+                 int64_t        stride1,
+                 int64_t        stride2,
+                 int64_t        batch_stride,
+                 int64_t        c_stride1,
+                 int64_t        c_stride2,
+                 int64_t        c_batch_stride,
+                 int64_t        m_stride1,
+                 int64_t        m_stride2,
+                 int64_t        m_batch_stride,
+                 int            num_batches,
+                 int64_t        sizes);
+    dim3 grid, block;
+
+    if(pruneAlg == rocsparselt_prune_smfmac_strip)
+    {
+        constexpr int SG0I = 16;
+        constexpr int SG1J = 4;
+        constexpr int TT0I = 1;
+        constexpr int TT1J = 8; //must be the multiplication of 8.
+        constexpr int MT0I = SG0I * TT0I;
+        constexpr int MT1J = SG1J * TT1J;
+
+        int block_x = m / MT0I + (m % MT0I > 0 ? 1 : 0);
+        int block_y = n / MT1J + (n % MT1J > 0 ? 1 : 0);
+
+        func  = prune_strip_compress_kernel<Ti, Tc, SG0I, SG1J, TT0I, TT1J>;
+        grid  = dim3(block_x, block_y, num_batches);
+        block = dim3(SG0I * SG1J);
+    }
+    else if(pruneAlg == rocsparselt_prune_smfmac_tile)
+    {
+        constexpr int SG0I = 16;
+        constexpr int SG1J = 16;
+        constexpr int MT0I = SG0I * 4;
+        constexpr int MT1J = SG1J * 8;
+
+        int block_x = m / MT0I + (m % MT0I > 0 ? 1 : 0);
+        int block_y = n / MT1J + (n % MT1J > 0 ? 1 : 0);
+
+        func  = prune_tile_compress_kernel<Ti, Tc, SG0I, SG1J>;
+        grid  = dim3(block_x, block_y, num_batches);
+        block = dim3(SG0I * SG1J);
+    }
+    else
+        return rocsparselt_status_not_implemented;
+
+    hipLaunchKernelGGL(func, /* compute kernel*/
+                       grid,
+                       block,
+                       0 /*dynamic shared*/,
+                       stream,
+                       d_in,
+                       d_out,
+                       d_metadata,
+                       m,
+                       n,
+                       stride0,
+                       stride1,
+                       batch_stride,
+                       c_stride0,
+                       c_stride1,
+                       c_batch_stride,
+                       m_stride0,
+                       m_stride1,
+                       m_batch_stride,
+                       num_batches,
+                       num_batches * batch_stride);
+    return rocsparselt_status_success;
+}
+
+template <typename Ti, typename Tc>
+rocsparselt_status
+    rocsparselt_smfmac_prune_grouped_template(std::vector<rocsparselt_grouped_work>& works,
+                                              void*                                  d_works,
+                                              rocsparselt_prune_alg                  pruneAlg,
+                                              hipStream_t                            stream)
+{
+    auto launch = [&](auto func, int MT0I, int MT1J, int threads) {
+        for(auto& work : works)
+        {
+            work.blocks_x = work.m / MT0I + (work.m % MT0I > 0 ? 1 : 0);
+            work.blocks_y = work.n / MT1J + (work.n % MT1J > 0 ? 1 : 0);
+        }
+
+        int64_t blocks;
+        RETURN_IF_ROCSPARSELT_ERROR(grouped_work_upload(works, d_works, blocks, stream));
+        if(blocks == 0)
+            return rocsparselt_status_success;
+
+        hipLaunchKernelGGL(func, /* compute kernel*/
+                           dim3(blocks),
+                           dim3(threads),
+                           0 /*dynamic shared*/,
+                           stream,
+                           reinterpret_cast<const rocsparselt_grouped_work*>(d_works),
+                           static_cast<int>(works.size()));
+        return rocsparselt_status_success;
+    };
+
+    if(pruneAlg == rocsparselt_prune_smfmac_strip)
+    {
+        constexpr int SG0I = 16;
+        constexpr int SG1J = 4;
+        constexpr int TT0I = 1;
+        constexpr int TT1J = 4;
+        return launch(prune_grouped_kernel<Ti, Tc, SG0I, SG1J, TT0I, TT1J, false>,
+                      SG0I * TT0I,
+                      SG1J * TT1J,
+                      SG0I * SG1J);
+    }
+    else if(pruneAlg == rocsparselt_prune_smfmac_tile)
+    {
+        constexpr int SG0I = 16;
+        constexpr int SG1J = 16;
+        return launch(prune_grouped_kernel<Ti, Tc, SG0I, SG1J, 4, 4, true>,
+                      SG0I * 4,
+                      SG1J * 4,
+                      SG0I * SG1J);
+    }
+    return rocsparselt_status_not_implemented;
+}
+
+rocsparselt_status rocsparselt_smfmac_prune_grouped_impl(
+    const _rocsparselt_handle*                        handle,
+    const std::vector<const _rocsparselt_mat_descr*>& descrs,
+    int                                               isSparseA,
+    rocsparselt_operation                             op,
+    const void* const*                                d_in,
+    void* const*                                      d_out,
+    rocsparselt_prune_alg                             pruneAlg,
+    void*                                             d_workList,
+    hipStream_t                                       stream)
+{
+    if(descrs.empty())
+        return rocsparselt_status_success;
+
+    std::vector<rocsparselt_grouped_work> works(descrs.size());
+    for(size_t i = 0; i < descrs.size(); i++)
+    {
+        auto    matrix = const_cast<_rocsparselt_mat_descr*>(descrs[i]);
+        auto&   work   = works[i];
+        int64_t stride0, stride1;
+        get_prune_matrix_size(isSparseA, op, matrix, work.m, work.n, stride0, stride1);
+
+        work.num_batches  = matrix->num_batches;
+        work.batch_stride = matrix->batch_stride;
+        //set the number of batches to 1, only the first batch matters in the broadcast case.
+        if(work.batch_stride == 0)
+        {
+            work.num_batches  = 1;
+            work.batch_stride = rocsparselt_matrix_elems(matrix, matrix->ld);
+        }
+
+        work.in      = d_in[i];
+        work.out     = d_out[i];
+        work.stride1 = stride0;
+        work.stride2 = stride1;
+    }
+
+    rocsparselt_datatype type = descrs[0]->type;
+
+#define PRUNE_GROUPED_PARAMS works, d_workList, pruneAlg, stream
+
+    switch(type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return rocsparselt_smfmac_prune_grouped_template<__half, float>(PRUNE_GROUPED_PARAMS);
+    case rocsparselt_datatype_bf16_r:
+        return rocsparselt_smfmac_prune_grouped_template<hip_bfloat16, float>(
+            PRUNE_GROUPED_PARAMS);
+    case rocsparselt_datatype_i8_r:
+        return rocsparselt_smfmac_prune_grouped_template<int8_t, float>(PRUNE_GROUPED_PARAMS);
+    case rocsparselt_datatype_f8_r:
+        return rocsparselt_smfmac_prune_grouped_template<__hip_fp8_e4m3_fnuz, float>(
+            PRUNE_GROUPED_PARAMS);
+    case rocsparselt_datatype_bf8_r:
+        return rocsparselt_smfmac_prune_grouped_template<__hip_fp8_e5m2_fnuz, float>(
+            PRUNE_GROUPED_PARAMS);
+    default:
+        log_error(handle,
+                  "rocsparselt_smfmac_prune2_grouped",
+                  "datatype",
+                  rocsparselt_datatype_to_string(type),
+                  "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+rocsparselt_status
+    rocsparselt_smfmac_prune_compress_panel_impl(const _rocsparselt_handle* handle,
+                                                 rocsparselt_datatype       type,
+                                                 rocsparselt_order          order,
+                                                 int64_t                    m,
+                                                 int64_t                    n,
+                                                 int64_t                    stride0,
+                                                 int64_t                    stride1,
+                                                 int64_t                    c_stride0,
+                                                 int64_t                    c_stride1,
+                                                 int64_t                    m_stride0,
+                                                 int64_t                    m_stride1,
+                                                 const void*                d_in,
+                                                 void*                      d_out,
+                                                 unsigned char*             d_metadata,
+                                                 rocsparselt_prune_alg      pruneAlg,
+                                                 hipStream_t                stream)
+{
+    // a panel is a single batch, its batch strides are never used
+#define PRUNE_COMPRESS_PANEL_PARAMS(T)                                                             \
+    handle, m, n, stride0, stride1, m * n, c_stride0, c_stride1, 0, m_stride0, m_stride1, 0, 1,    \
+        order, reinterpret_cast<const T*>(d_in), reinterpret_cast<T*>(d_out), d_metadata,          \
+        pruneAlg, stream
+
+    switch(type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return rocsparselt_smfmac_prune_compress_template<__half, float>(
+            PRUNE_COMPRESS_PANEL_PARAMS(__half));
+    case rocsparselt_datatype_bf16_r:
+        return rocsparselt_smfmac_prune_compress_template<hip_bfloat16, float>(
+            PRUNE_COMPRESS_PANEL_PARAMS(hip_bfloat16));
+    case rocsparselt_datatype_i8_r:
+        return rocsparselt_smfmac_prune_compress_template<int8_t, float>(
+            PRUNE_COMPRESS_PANEL_PARAMS(int8_t));
+    case rocsparselt_datatype_f8_r:
+        return rocsparselt_smfmac_prune_compress_template<__hip_fp8_e4m3_fnuz, float>(
+            PRUNE_COMPRESS_PANEL_PARAMS(__hip_fp8_e4m3_fnuz));
+    case rocsparselt_datatype_bf8_r:
+        return rocsparselt_smfmac_prune_compress_template<__hip_fp8_e5m2_fnuz, float>(
+            PRUNE_COMPRESS_PANEL_PARAMS(__hip_fp8_e5m2_fnuz));
+    default:
+        log_error(handle,
+                  "rocsparselt_smfmac_prune_and_compress_streamed",
+                  "datatype",
+                  rocsparselt_datatype_to_string(type),
+                  "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+rocsparselt_status rocsparselt_smfmac_prune_impl(const _rocsparselt_handle*    handle,
                                                  const _rocsparselt_mat_descr* matrix,
                                                  int64_t                       m,
                                                  int64_t                       n,
@@ -562,6 +1333,8 @@ rocsparselt_status rocsparselt_smfmac_prune_impl(const _rocsparselt_handle*    h
                                                  rocsparselt_prune_alg         pruneAlg,
                                                  hipStream_t                   stream)
 {
+    rocsparselt_trace_span     trace("prune", stream);
+    rocsparselt_trace_gpu_span gpu_trace("prune", stream);
 
     rocsparselt_order    order = matrix->order;
     rocsparselt_datatype type  = matrix->type;
@@ -573,11 +1346,11 @@ rocsparselt_status rocsparselt_smfmac_prune_impl(const _rocsparselt_handle*    h
     if(batch_stride == 0) //boardcast case.
     {
         num_batches  = 1;
-        batch_stride = matrix->n * ld;
+        batch_stride = rocsparselt_matrix_elems(matrix, ld);
     }
 
-#define PRUNE_PARAMS(T)                                               \
-    handle, m, n, stride0, stride1, num_batches, batch_stride, order, \
+#define PRUNE_PARAMS(T)                                                     \
+    handle, m, n, stride0, stride1, num_batches, batch_stride, order, type, \
         reinterpret_cast<const T*>(d_in), reinterpret_cast<T*>(d_out), pruneAlg, stream
 
     switch(type)
@@ -588,6 +1361,12 @@ rocsparselt_status rocsparselt_smfmac_prune_impl(const _rocsparselt_handle*    h
         return rocsparselt_smfmac_prune_template<hip_bfloat16, float>(PRUNE_PARAMS(hip_bfloat16));
     case rocsparselt_datatype_i8_r:
         return rocsparselt_smfmac_prune_template<int8_t, float>(PRUNE_PARAMS(int8_t));
+    case rocsparselt_datatype_f8_r:
+        return rocsparselt_smfmac_prune_template<__hip_fp8_e4m3_fnuz, float>(
+            PRUNE_PARAMS(__hip_fp8_e4m3_fnuz));
+    case rocsparselt_datatype_bf8_r:
+        return rocsparselt_smfmac_prune_template<__hip_fp8_e5m2_fnuz, float>(
+            PRUNE_PARAMS(__hip_fp8_e5m2_fnuz));
     default:
         log_error(handle,
                   "rocsparselt_smfmac_prune",
@@ -620,7 +1399,7 @@ rocsparselt_status rocsparselt_smfmac_prune_check_impl(const _rocsparselt_handle
     if(batch_stride == 0) //boardcast case.
     {
         num_batches  = 1;
-        batch_stride = matrix->n * ld;
+        batch_stride = rocsparselt_matrix_elems(matrix, ld);
     }
 
 #define PRUNE_CHECK_PARAMS(T)                                         \
@@ -635,6 +1414,9 @@ rocsparselt_status rocsparselt_smfmac_prune_check_impl(const _rocsparselt_handle
         return rocsparselt_smfmac_prune_check_template<hip_bfloat16>(
             PRUNE_CHECK_PARAMS(hip_bfloat16));
     case rocsparselt_datatype_i8_r:
+    // the FNUZ formats have no negative zero, an FP8 value is 0 iff all its bits are
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
         return rocsparselt_smfmac_prune_check_template<int8_t>(PRUNE_CHECK_PARAMS(int8_t));
     default:
         log_error(handle,
@@ -646,16 +1428,794 @@ rocsparselt_status rocsparselt_smfmac_prune_check_impl(const _rocsparselt_handle
     }
 }
 
+rocsparselt_status rocsparselt_smfmac_prune_check_count_impl(const _rocsparselt_handle*    handle,
+                                                             const _rocsparselt_mat_descr* matrix,
+                                                             int64_t                       m,
+                                                             int64_t                       n,
+                                                             int64_t     stride0,
+                                                             int64_t     stride1,
+                                                             int64_t     ld,
+                                                             const void* d_in,
+                                                             int64_t*    d_count,
+                                                             int64_t*    d_offsets,
+                                                             int         max_offsets,
+                                                             hipStream_t stream)
+{
+    rocsparselt_datatype type = matrix->type;
+
+    int     num_batches  = matrix->num_batches;
+    int64_t batch_stride = matrix->batch_stride;
+
+    //set the number of batches to 1 since in the broadcast case, we only care about contents in first batch.
+    if(batch_stride == 0) //boardcast case.
+    {
+        num_batches  = 1;
+        batch_stride = rocsparselt_matrix_elems(matrix, ld);
+    }
+
+#define PRUNE_CHECK_COUNT_PARAMS(T)                                                          \
+    handle, m, n, stride0, stride1, num_batches, batch_stride, reinterpret_cast<const T*>(d_in), \
+        d_count, d_offsets, max_offsets, stream
+
+    switch(type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return rocsparselt_smfmac_prune_check_count_template<__half>(
+            PRUNE_CHECK_COUNT_PARAMS(__half));
+    case rocsparselt_datatype_bf16_r:
+        return rocsparselt_smfmac_prune_check_count_template<hip_bfloat16>(
+            PRUNE_CHECK_COUNT_PARAMS(hip_bfloat16));
+    case rocsparselt_datatype_i8_r:
+    // the FNUZ formats have no negative zero, an FP8 value is 0 iff all its bits are
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
+        return rocsparselt_smfmac_prune_check_count_template<int8_t>(
+            PRUNE_CHECK_COUNT_PARAMS(int8_t));
+    default:
+        log_error(handle,
+                  "rocsparselt_smfmac_prune_check_count",
+                  "datatype",
+                  rocsparselt_datatype_to_string(type),
+                  "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+rocsparselt_status rocsparselt_smfmac_prune_mask_impl(const _rocsparselt_handle*    handle,
+                                                      const _rocsparselt_mat_descr* matrix,
+                                                      int64_t                       m,
+                                                      int64_t                       n,
+                                                      int64_t                       stride0,
+                                                      int64_t                       stride1,
+                                                      int64_t                       ld,
+                                                      const void*                   d_in,
+                                                      void*                         d_out,
+                                                      void*                         d_mask,
+                                                      const void*                   d_score,
+                                                      const void*                   d_colScale,
+                                                      rocsparselt_prune_alg         pruneAlg,
+                                                      hipStream_t                   stream)
+{
+    rocsparselt_datatype type = matrix->type;
+
+    int     num_batches  = matrix->num_batches;
+    int64_t batch_stride = matrix->batch_stride;
+
+    // a broadcast matrix only stores its first batch
+    if(batch_stride == 0)
+    {
+        num_batches  = 1;
+        batch_stride = rocsparselt_matrix_elems(matrix, ld);
+    }
+
+#define PRUNE_MASK_PARAMS(T)                                                                       \
+    handle, m, n, stride0, stride1, num_batches, batch_stride, reinterpret_cast<const T*>(d_in),   \
+        reinterpret_cast<T*>(d_out), reinterpret_cast<unsigned char*>(d_mask),                     \
+        reinterpret_cast<const float*>(d_score), reinterpret_cast<const float*>(d_colScale),       \
+        pruneAlg, stream
+
+    switch(type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return rocsparselt_smfmac_prune_mask_template<__half, float>(PRUNE_MASK_PARAMS(__half));
+    case rocsparselt_datatype_bf16_r:
+        return rocsparselt_smfmac_prune_mask_template<hip_bfloat16, float>(
+            PRUNE_MASK_PARAMS(hip_bfloat16));
+    case rocsparselt_datatype_i8_r:
+        return rocsparselt_smfmac_prune_mask_template<int8_t, float>(PRUNE_MASK_PARAMS(int8_t));
+    case rocsparselt_datatype_f8_r:
+        return rocsparselt_smfmac_prune_mask_template<__hip_fp8_e4m3_fnuz, float>(
+            PRUNE_MASK_PARAMS(__hip_fp8_e4m3_fnuz));
+    case rocsparselt_datatype_bf8_r:
+        return rocsparselt_smfmac_prune_mask_template<__hip_fp8_e5m2_fnuz, float>(
+            PRUNE_MASK_PARAMS(__hip_fp8_e5m2_fnuz));
+    default:
+        log_error(handle,
+                  "rocsparselt_smfmac_prune_mask",
+                  "datatype",
+                  rocsparselt_datatype_to_string(type),
+                  "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+rocsparselt_status rocsparselt_smfmac_mask_apply_impl(const _rocsparselt_handle*    handle,
+                                                      const _rocsparselt_mat_descr* matrix,
+                                                      int64_t                       m,
+                                                      int64_t                       n,
+                                                      int64_t                       stride0,
+                                                      int64_t                       stride1,
+                                                      int64_t                       ld,
+                                                      const void*                   d_in,
+                                                      void*                         d_out,
+                                                      const void*                   d_mask,
+                                                      hipStream_t                   stream)
+{
+    rocsparselt_datatype type = matrix->type;
+
+    int     num_batches  = matrix->num_batches;
+    int64_t batch_stride = matrix->batch_stride;
+
+    // a broadcast matrix only stores its first batch
+    if(batch_stride == 0)
+    {
+        num_batches  = 1;
+        batch_stride = rocsparselt_matrix_elems(matrix, ld);
+    }
+
+#define MASK_APPLY_PARAMS(T)                                                                       \
+    handle, m, n, stride0, stride1, num_batches, batch_stride, reinterpret_cast<const T*>(d_in),   \
+        reinterpret_cast<T*>(d_out), reinterpret_cast<const unsigned char*>(d_mask), stream
+
+    // applying a mask only copies or clears elements, and 0 is all zero bits in every datatype
+    switch(type)
+    {
+    case rocsparselt_datatype_f16_r:
+    case rocsparselt_datatype_bf16_r:
+        return rocsparselt_smfmac_mask_apply_template<uint16_t>(MASK_APPLY_PARAMS(uint16_t));
+    case rocsparselt_datatype_i8_r:
+    case rocsparselt_datatype_f8_r:
+    case rocsparselt_datatype_bf8_r:
+        return rocsparselt_smfmac_mask_apply_template<uint8_t>(MASK_APPLY_PARAMS(uint8_t));
+    default:
+        log_error(handle,
+                  "rocsparselt_smfmac_mask_apply",
+                  "datatype",
+                  rocsparselt_datatype_to_string(type),
+                  "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+rocsparselt_status rocsparselt_smfmac_prune_compress_impl(const _rocsparselt_handle*    handle,
+                                                          const _rocsparselt_mat_descr* matrix,
+                                                          int64_t                       m,
+                                                          int64_t                       n,
+                                                          int64_t                       stride0,
+                                                          int64_t                       stride1,
+                                                          int64_t                       ld,
+                                                          int64_t                       c_stride0,
+                                                          int64_t                       c_stride1,
+                                                          int64_t                       m_stride0,
+                                                          int64_t                       m_stride1,
+                                                          int64_t               c_batch_stride,
+                                                          int64_t               m_batch_stride,
+                                                          const void*           d_in,
+                                                          void*                 d_out,
+                                                          rocsparselt_prune_alg pruneAlg,
+                                                          hipStream_t           stream)
+{
+    rocsparselt_order    order = matrix->order;
+    rocsparselt_datatype type  = matrix->type;
+
+    int     num_batches  = matrix->num_batches;
+    int64_t batch_stride = matrix->batch_stride;
+
+    //set the number of batches to 1 since in the broadcast case, we only care about contents in first batch.
+    if(batch_stride == 0) //boardcast case.
+    {
+        num_batches  = 1;
+        batch_stride = rocsparselt_matrix_elems(matrix, ld);
+    }
+
+    unsigned char* d_metadata = reinterpret_cast<unsigned char*>(d_out)
+                                + rocsparselt_metadata_offset_in_compressed_matrix(
+                                    matrix->c_n, matrix->c_ld, num_batches, type);
+
+#define PRUNE_COMPRESS_PARAMS(T)                                                                   \
+    handle, m, n, stride0, stride1, batch_stride, c_stride0, c_stride1, c_batch_stride, m_stride0, \
+        m_stride1, m_batch_stride, num_batches, order, reinterpret_cast<const T*>(d_in),           \
+        reinterpret_cast<T*>(d_out), d_metadata, pruneAlg, stream
+
+    switch(type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return rocsparselt_smfmac_prune_compress_template<__half, float>(
+            PRUNE_COMPRESS_PARAMS(__half));
+    case rocsparselt_datatype_bf16_r:
+        return rocsparselt_smfmac_prune_compress_template<hip_bfloat16, float>(
+            PRUNE_COMPRESS_PARAMS(hip_bfloat16));
+    case rocsparselt_datatype_i8_r:
+        return rocsparselt_smfmac_prune_compress_template<int8_t, float>(
+            PRUNE_COMPRESS_PARAMS(int8_t));
+    case rocsparselt_datatype_f8_r:
+        return rocsparselt_smfmac_prune_compress_template<__hip_fp8_e4m3_fnuz, float>(
+            PRUNE_COMPRESS_PARAMS(__hip_fp8_e4m3_fnuz));
+    case rocsparselt_datatype_bf8_r:
+        return rocsparselt_smfmac_prune_compress_template<__hip_fp8_e5m2_fnuz, float>(
+            PRUNE_COMPRESS_PARAMS(__hip_fp8_e5m2_fnuz));
+    default:
+        log_error(handle,
+                  "rocsparselt_smfmac_prune_and_compress",
+                  "datatype",
+                  rocsparselt_datatype_to_string(type),
+                  "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+/********************************************************************************
+ * \brief prunes a dense matrix according to the specified algorithm.
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_prune(const rocsparselt_handle*       handle,
+                                            const rocsparselt_matmul_descr* matmulDescr,
+                                            const void*                     d_in,
+                                            void*                           d_out,
+                                            rocsparselt_prune_alg           pruneAlg,
+                                            hipStream_t                     stream)
+
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(matmulDescr == nullptr)
+    {
+        log_error(_handle, __func__, "matmulDescr is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _matmulDescr = reinterpret_cast<const _rocsparselt_matmul_descr*>(matmulDescr);
+    if(!_matmulDescr->isInit())
+    {
+        log_error(_handle, __func__, "matmulDescr did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    // Check if pointer is valid
+    if(d_in == nullptr)
+    {
+        log_error(_handle, __func__, "d_in is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(d_out == nullptr)
+    {
+        log_error(_handle, __func__, "d_out is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    // Check if prune alg is valid
+    if(pruneAlg != rocsparselt_prune_smfmac_strip && pruneAlg != rocsparselt_prune_smfmac_tile)
+    {
+        log_error(_handle, __func__, "pruneAlg", pruneAlg, "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+
+    rocsparselt_operation   op     = _matmulDescr->is_sparse_a ? _matmulDescr->op_A : _matmulDescr->op_B;
+    _rocsparselt_mat_descr *_sparseMatDescr = _matmulDescr->is_sparse_a ? _matmulDescr->matrix_A : _matmulDescr->matrix_B;
+    int64_t m, n, stride0, stride1;
+    int64_t ld = _sparseMatDescr->ld;
+    get_prune_matrix_size(_matmulDescr->is_sparse_a, op, _sparseMatDescr, m, n, stride0, stride1);
+
+    log_api(_handle,
+            __func__,
+            "matmulDescr[in]",
+            *_matmulDescr,
+            "d_in[in]",
+            d_in,
+            "d_out[out]",
+            d_out,
+            "pruneAlg[in]",
+            pruneAlg,
+            "stream[in]",
+            stream);
+    return rocsparselt_smfmac_prune_impl(_handle,
+                                         _sparseMatDescr,
+                                         m,
+                                         n,
+                                         stride0,
+                                         stride1,
+                                         ld,
+                                         d_in,
+                                         d_out,
+                                         pruneAlg,
+                                         stream);
+}
+
+/********************************************************************************
+ * \brief prunes a dense matrix according to the specified algorithm.
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_prune2(const rocsparselt_handle*    handle,
+                                             const rocsparselt_mat_descr* sparseMatDescr,
+                                             int                          isSparseA,
+                                             rocsparselt_operation        op,
+                                             const void*                  d_in,
+                                             void*                        d_out,
+                                             rocsparselt_prune_alg        pruneAlg,
+                                             hipStream_t                  stream)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(sparseMatDescr == nullptr)
+    {
+        log_error(_handle, __func__, "sparseMatDescr is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _sparseMatDescr = reinterpret_cast<_rocsparselt_mat_descr*>(
+        const_cast<rocsparselt_mat_descr*>(sparseMatDescr));
+    if(!_sparseMatDescr->isInit())
+    {
+        log_error(_handle, __func__, "sparseMatDescr did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(op != rocsparselt_operation_none && op != rocsparselt_operation_transpose)
+    {
+        log_error(_handle, __func__, "op is invalid");
+        return rocsparselt_status_invalid_value;
+    }
+
+    // Check if pointer is valid
+    if(d_in == nullptr)
+    {
+        log_error(_handle, __func__, "d_in is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(d_out == nullptr)
+    {
+        log_error(_handle, __func__, "d_out is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    // Check if prune alg is valid
+    if(pruneAlg != rocsparselt_prune_smfmac_strip && pruneAlg != rocsparselt_prune_smfmac_tile)
+    {
+        log_error(_handle, __func__, "pruneAlg", pruneAlg, "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+
+    // Check if matrix A is a structured matrix
+    if(_sparseMatDescr->m_type != rocsparselt_matrix_type_structured)
+    {
+        log_error(_handle, __func__, "Matrix is not a structured matrix");
+        return rocsparselt_status_not_implemented;
+    }
+
+    log_api(_handle,
+            __func__,
+            "sparseMatDescr[in]",
+            *_sparseMatDescr,
+            "isSparseA[in]",
+            isSparseA,
+            "op[in]",
+            rocsparselt_operation_to_string(op),
+            "d_in[in]",
+            d_in,
+            "d_out[out]",
+            d_out,
+            "pruneAlg[in]",
+            pruneAlg,
+            "stream[in]",
+            stream);
+
+    int64_t m, n, stride0, stride1;
+    int64_t ld = _sparseMatDescr->ld;
+    get_prune_matrix_size(isSparseA, op, _sparseMatDescr, m, n, stride0, stride1);
+
+    return rocsparselt_smfmac_prune_impl(
+        _handle, _sparseMatDescr, m, n, stride0, stride1, ld, d_in, d_out, pruneAlg, stream);
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_prune_check(const rocsparselt_handle*       handle,
+                                                  const rocsparselt_matmul_descr* matmulDescr,
+                                                  const void*                     d_in,
+                                                  int*                            d_out,
+                                                  hipStream_t                     stream)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(matmulDescr == nullptr)
+    {
+        log_error(_handle, __func__, "matmulDescr is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _matmulDescr = reinterpret_cast<const _rocsparselt_matmul_descr*>(matmulDescr);
+    if(!_matmulDescr->isInit())
+    {
+        log_error(_handle, __func__, "matmulDescr did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    // Check if pointer is valid
+    if(d_in == nullptr)
+    {
+        log_error(_handle, __func__, "d_in is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(d_out == nullptr)
+    {
+        log_error(_handle, __func__, "d_out is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    rocsparselt_operation   op     = _matmulDescr->is_sparse_a ? _matmulDescr->op_A : _matmulDescr->op_B;
+    _rocsparselt_mat_descr *_sparseMatDescr = _matmulDescr->is_sparse_a ? _matmulDescr->matrix_A : _matmulDescr->matrix_B;
+    int64_t m, n, stride0, stride1;
+    int64_t ld = _sparseMatDescr->ld;
+    get_prune_matrix_size(_matmulDescr->is_sparse_a, op, _sparseMatDescr, m, n, stride0, stride1);
+
+    log_api(_handle,
+            __func__,
+            "matmulDescr[in]",
+            *_matmulDescr,
+            "d_in[in]",
+            d_in,
+            "d_out[out]",
+            d_out,
+            "stream[in]",
+            stream);
+    return rocsparselt_smfmac_prune_check_impl(_handle,
+                                               _sparseMatDescr,
+                                               m,
+                                               n,
+                                               stride0,
+                                               stride1,
+                                               ld,
+                                               d_in,
+                                               d_out,
+                                               stream);
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_prune_check2(const rocsparselt_handle*    handle,
+                                                   const rocsparselt_mat_descr* sparseMatDescr,
+                                                   int                          isSparseA,
+                                                   rocsparselt_operation        op,
+                                                   const void*                  d_in,
+                                                   int*                         d_out,
+                                                   hipStream_t                  stream)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(sparseMatDescr == nullptr)
+    {
+        log_error(_handle, __func__, "sparseMatDescr is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _sparseMatDescr = reinterpret_cast<_rocsparselt_mat_descr*>(
+        const_cast<rocsparselt_mat_descr*>(sparseMatDescr));
+    if(!_sparseMatDescr->isInit())
+    {
+        log_error(_handle, __func__, "sparseMatDescr did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(op != rocsparselt_operation_none && op != rocsparselt_operation_transpose)
+    {
+        log_error(_handle, __func__, "op is invalid");
+        return rocsparselt_status_invalid_value;
+    }
+
+    // Check if pointer is valid
+    if(d_in == nullptr)
+    {
+        log_error(_handle, __func__, "d_in is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(d_out == nullptr)
+    {
+        log_error(_handle, __func__, "d_out is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    // Check if matrix A is a structured matrix
+    if(_sparseMatDescr->m_type != rocsparselt_matrix_type_structured)
+    {
+        log_error(_handle, __func__, "Matrix is not a structured matrix");
+        return rocsparselt_status_not_implemented;
+    }
+
+    log_api(_handle,
+            __func__,
+            "sparseMatDescr[in]",
+            *_sparseMatDescr,
+            "isSparseA[in]",
+            isSparseA,
+            "op[in]",
+            rocsparselt_operation_to_string(op),
+            "d_in[in]",
+            d_in,
+            "d_out[out]",
+            d_out,
+            "stream[in]",
+            stream);
+
+    int64_t m, n, stride0, stride1;
+    int64_t ld = _sparseMatDescr->ld;
+    get_prune_matrix_size(isSparseA, op, _sparseMatDescr, m, n, stride0, stride1);
+
+    return rocsparselt_smfmac_prune_check_impl(
+        _handle, _sparseMatDescr, m, n, stride0, stride1, ld, d_in, d_out, stream);
+}
+
+/********************************************************************************
+ * \brief prunes a dense matrix and writes it straight into the compressed format.
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_prune_and_compress(const rocsparselt_handle*      handle,
+                                                         const rocsparselt_matmul_plan* plan,
+                                                         const void*                    d_dense,
+                                                         void*                 d_compressed,
+                                                         void*                 d_compressBuffer,
+                                                         rocsparselt_prune_alg pruneAlg,
+                                                         hipStream_t           stream)
+{
+    rocsparselt_compressed_matrix_written();
+
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, __func__));
+
+    // Check if pointer is valid
+    if(d_dense == nullptr)
+    {
+        log_error(_handle, __func__, "d_dense is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(d_compressed == nullptr)
+    {
+        log_error(_handle, __func__, "d_compressed is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    // Check if prune alg is valid
+    if(pruneAlg != rocsparselt_prune_smfmac_strip && pruneAlg != rocsparselt_prune_smfmac_tile)
+    {
+        log_error(_handle, __func__, "pruneAlg", pruneAlg, "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+
+    log_api(_handle,
+            __func__,
+            "plan[in]",
+            *_plan,
+            "d_dense[in]",
+            d_dense,
+            "d_compressed[out]",
+            d_compressed,
+            "d_compressBuffer[out]",
+            d_compressBuffer,
+            "pruneAlg[in]",
+            pruneAlg,
+            "stream[in]",
+            stream);
+
+    return rocsparselt_smfmac_prune_compress_operand(
+        _handle, _plan->matmul_descr, d_dense, d_compressed, pruneAlg, stream);
+}
+
+/********************************************************************************
+ * \brief prunes a dense matrix to a pattern which is 2:4 along both dimensions, and
+ * compresses it for both operations.
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_prune_and_compress_transposable(const rocsparselt_handle*    handle,
+                                                       const rocsparselt_mat_descr* sparseMatDescr,
+                                                       int                          isSparseA,
+                                                       const void*                  d_in,
+                                                       void*                        d_out,
+                                                       void*                        d_compressed,
+                                                       void*                        d_compressedT,
+                                                       hipStream_t                  stream)
+{
+    rocsparselt_compressed_matrix_written();
+
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(sparseMatDescr == nullptr)
+    {
+        log_error(_handle, __func__, "sparseMatDescr is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _sparseMatDescr = reinterpret_cast<const _rocsparselt_mat_descr*>(sparseMatDescr);
+    if(!_sparseMatDescr->isInit())
+    {
+        log_error(_handle, __func__, "sparseMatDescr did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(_handle, _sparseMatDescr, __func__));
+
+    // Check if pointer is valid
+    if(d_in == nullptr || d_out == nullptr)
+    {
+        log_error(_handle, __func__, "d_in or d_out is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(d_compressed == nullptr || d_compressedT == nullptr)
+    {
+        log_error(_handle, __func__, "d_compressed or d_compressedT is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    // Check if matrix A is a structured matrix
+    if(_sparseMatDescr->m_type != rocsparselt_matrix_type_structured)
+    {
+        log_error(_handle, __func__, "Matrix is not a structured matrix");
+        return rocsparselt_status_not_implemented;
+    }
+
+    log_api(_handle,
+            __func__,
+            "sparseMatDescr[in]",
+            *_sparseMatDescr,
+            "isSparseA[in]",
+            isSparseA,
+            "d_in[in]",
+            d_in,
+            "d_out[out]",
+            d_out,
+            "d_compressed[out]",
+            d_compressed,
+            "d_compressedT[out]",
+            d_compressedT,
+            "stream[in]",
+            stream);
+
+    // The tile prune keeps 2 elements in each row and each column of every 4x4 tile, so the
+    // pruned matrix is 2:4 along k whichever dimension k is, and a single prune serves both
+    // operations. Each compress works on a copy of the descriptor with the compressed layout of
+    // its operation, the layout the matmul descriptor would give it.
+    _rocsparselt_mat_descr matrix(*_sparseMatDescr);
+    int64_t                ld = matrix.ld;
+    int64_t                m, n, stride0, stride1, c_stride0, c_stride1;
+    get_prune_matrix_size(isSparseA, rocsparselt_operation_none, &matrix, m, n, stride0, stride1);
+    auto status = rocsparselt_smfmac_prune_impl(_handle,
+                                                &matrix,
+                                                m,
+                                                n,
+                                                stride0,
+                                                stride1,
+                                                ld,
+                                                d_in,
+                                                d_out,
+                                                rocsparselt_prune_smfmac_tile,
+                                                stream);
+    if(status != rocsparselt_status_success)
+        return status;
+
+    for(auto op : {rocsparselt_operation_none, rocsparselt_operation_transpose})
+    {
+        set_compressed_layout(matrix, isSparseA, op);
+        get_compress_matrix_size(
+            isSparseA, op, &matrix, m, n, stride0, stride1, c_stride0, c_stride1);
+        status = rocsparselt_smfmac_compress_impl(
+            _handle,
+            &matrix,
+            m,
+            n,
+            stride0,
+            stride1,
+            ld,
+            c_stride0,
+            c_stride1,
+            matrix.c_k / 4,
+            1,
+            matrix.c_ld * matrix.c_n,
+            matrix.c_ld * matrix.c_n / 4,
+            d_out,
+            op == rocsparselt_operation_none ? d_compressed : d_compressedT,
+            nullptr,
+            stream);
+        if(status != rocsparselt_status_success)
+            return status;
+    }
+    return rocsparselt_status_success;
+}
+
 /********************************************************************************
- * \brief prunes a dense matrix according to the specified algorithm.
+ * \brief counts the groups of a matrix which are not 2:4 sparse.
  *******************************************************************************/
-rocsparselt_status rocsparselt_smfmac_prune(const rocsparselt_handle*       handle,
-                                            const rocsparselt_matmul_descr* matmulDescr,
-                                            const void*                     d_in,
-                                            void*                           d_out,
-                                            rocsparselt_prune_alg           pruneAlg,
-                                            hipStream_t                     stream)
-
+rocsparselt_status rocsparselt_smfmac_prune_check_count(const rocsparselt_handle*       handle,
+                                                        const rocsparselt_matmul_descr* matmulDescr,
+                                                        const void*                     d_in,
+                                                        int64_t*                        d_count,
+                                                        int64_t*                        d_offsets,
+                                                        int                             maxOffsets,
+                                                        hipStream_t                     stream)
 {
     // Check if handle is valid
     if(handle == nullptr)
@@ -689,24 +2249,25 @@ rocsparselt_status rocsparselt_smfmac_prune(const rocsparselt_handle*       hand
         return rocsparselt_status_invalid_pointer;
     }
 
-    if(d_out == nullptr)
+    if(d_count == nullptr)
     {
-        log_error(_handle, __func__, "d_out is a NULL pointer");
+        log_error(_handle, __func__, "d_count is a NULL pointer");
         return rocsparselt_status_invalid_pointer;
     }
 
-    // Check if prune alg is valid
-    if(pruneAlg != rocsparselt_prune_smfmac_strip && pruneAlg != rocsparselt_prune_smfmac_tile)
+    if(maxOffsets < 0 || (maxOffsets > 0 && d_offsets == nullptr))
     {
-        log_error(_handle, __func__, "pruneAlg", pruneAlg, "is not supported");
-        return rocsparselt_status_not_implemented;
+        log_error(_handle, __func__, "maxOffsets", maxOffsets, "is invalid");
+        return rocsparselt_status_invalid_value;
     }
 
-    rocsparselt_operation   op     = _matmulDescr->is_sparse_a ? _matmulDescr->op_A : _matmulDescr->op_B;
-    _rocsparselt_mat_descr *_sparseMatDescr = _matmulDescr->is_sparse_a ? _matmulDescr->matrix_A : _matmulDescr->matrix_B;
+    bool                    is_sparse_a = _matmulDescr->is_sparse_a;
+    rocsparselt_operation   op          = is_sparse_a ? _matmulDescr->op_A : _matmulDescr->op_B;
+    _rocsparselt_mat_descr* _sparseMatDescr
+        = is_sparse_a ? _matmulDescr->matrix_A : _matmulDescr->matrix_B;
     int64_t m, n, stride0, stride1;
     int64_t ld = _sparseMatDescr->ld;
-    get_prune_matrix_size(_matmulDescr->is_sparse_a, op, _sparseMatDescr, m, n, stride0, stride1);
+    get_prune_matrix_size(is_sparse_a, op, _sparseMatDescr, m, n, stride0, stride1);
 
     log_api(_handle,
             __func__,
@@ -714,36 +2275,95 @@ rocsparselt_status rocsparselt_smfmac_prune(const rocsparselt_handle*       hand
             *_matmulDescr,
             "d_in[in]",
             d_in,
+            "d_count[out]",
+            d_count,
+            "d_offsets[out]",
+            d_offsets,
+            "maxOffsets[in]",
+            maxOffsets,
+            "stream[in]",
+            stream);
+    return rocsparselt_smfmac_prune_check_count_impl(_handle,
+                                                     _sparseMatDescr,
+                                                     m,
+                                                     n,
+                                                     stride0,
+                                                     stride1,
+                                                     ld,
+                                                     d_in,
+                                                     d_count,
+                                                     maxOffsets > 0 ? d_offsets : nullptr,
+                                                     maxOffsets,
+                                                     stream);
+}
+
+/********************************************************************************
+ * \brief prunes a group of dense matrices in a single launch.
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_prune2_grouped(const rocsparselt_handle*           handle,
+                                      int                                 groupCount,
+                                      const rocsparselt_mat_descr* const* sparseMatDescrs,
+                                      int                                 isSparseA,
+                                      rocsparselt_operation               op,
+                                      const void* const*                  d_in,
+                                      void* const*                        d_out,
+                                      rocsparselt_prune_alg               pruneAlg,
+                                      void*                               d_workList,
+                                      hipStream_t                         stream)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(pruneAlg != rocsparselt_prune_smfmac_strip && pruneAlg != rocsparselt_prune_smfmac_tile)
+    {
+        log_error(_handle, __func__, "pruneAlg", pruneAlg, "is not supported");
+        return rocsparselt_status_not_implemented;
+    }
+
+    std::vector<const _rocsparselt_mat_descr*> descrs;
+    RETURN_IF_ROCSPARSELT_ERROR(validateGroupedArgs(
+        _handle, __func__, groupCount, sparseMatDescrs, op, d_in, d_out, d_workList, descrs));
+
+    log_api(_handle,
+            __func__,
+            "groupCount[in]",
+            groupCount,
+            "isSparseA[in]",
+            isSparseA,
+            "op[in]",
+            rocsparselt_operation_to_string(op),
+            "d_in[in]",
+            d_in,
             "d_out[out]",
             d_out,
             "pruneAlg[in]",
             pruneAlg,
+            "d_workList[out]",
+            d_workList,
             "stream[in]",
             stream);
-    return rocsparselt_smfmac_prune_impl(_handle,
-                                         _sparseMatDescr,
-                                         m,
-                                         n,
-                                         stride0,
-                                         stride1,
-                                         ld,
-                                         d_in,
-                                         d_out,
-                                         pruneAlg,
-                                         stream);
+
+    return rocsparselt_smfmac_prune_grouped_impl(
+        _handle, descrs, isSparseA, op, d_in, d_out, pruneAlg, d_workList, stream);
 }
 
 /********************************************************************************
- * \brief prunes a dense matrix according to the specified algorithm.
+ * \brief provides the size of the mask written by rocsparselt_smfmac_prune_mask.
  *******************************************************************************/
-rocsparselt_status rocsparselt_smfmac_prune2(const rocsparselt_handle*    handle,
-                                             const rocsparselt_mat_descr* sparseMatDescr,
-                                             int                          isSparseA,
-                                             rocsparselt_operation        op,
-                                             const void*                  d_in,
-                                             void*                        d_out,
-                                             rocsparselt_prune_alg        pruneAlg,
-                                             hipStream_t                  stream)
+rocsparselt_status rocsparselt_smfmac_prune_mask_size(const rocsparselt_handle*       handle,
+                                                      const rocsparselt_matmul_descr* matmulDescr,
+                                                      size_t*                         maskSize)
 {
     // Check if handle is valid
     if(handle == nullptr)
@@ -758,35 +2378,82 @@ rocsparselt_status rocsparselt_smfmac_prune2(const rocsparselt_handle*    handle
         return rocsparselt_status_invalid_handle;
     }
 
-    if(sparseMatDescr == nullptr)
+    if(matmulDescr == nullptr)
     {
-        log_error(_handle, __func__, "sparseMatDescr is a NULL pointer");
+        log_error(_handle, __func__, "matmulDescr is a NULL pointer");
         return rocsparselt_status_invalid_handle;
     }
-    auto _sparseMatDescr = reinterpret_cast<_rocsparselt_mat_descr*>(
-        const_cast<rocsparselt_mat_descr*>(sparseMatDescr));
-    if(!_sparseMatDescr->isInit())
+    auto _matmulDescr = reinterpret_cast<const _rocsparselt_matmul_descr*>(matmulDescr);
+    if(!_matmulDescr->isInit())
     {
-        log_error(_handle, __func__, "sparseMatDescr did not initialized or already destroyed");
+        log_error(_handle, __func__, "matmulDescr did not initialized or already destroyed");
         return rocsparselt_status_invalid_handle;
     }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(_handle, _matmulDescr, __func__));
 
-    if(op != rocsparselt_operation_none && op != rocsparselt_operation_transpose)
+    // Check if pointer is valid
+    if(maskSize == nullptr)
     {
-        log_error(_handle, __func__, "op is invalid");
-        return rocsparselt_status_invalid_value;
+        log_error(_handle, __func__, "maskSize is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
     }
 
-    // Check if pointer is valid
-    if(d_in == nullptr)
+    bool                    is_sparse_a = _matmulDescr->is_sparse_a;
+    rocsparselt_operation   op          = is_sparse_a ? _matmulDescr->op_A : _matmulDescr->op_B;
+    _rocsparselt_mat_descr* _sparseMatDescr
+        = is_sparse_a ? _matmulDescr->matrix_A : _matmulDescr->matrix_B;
+    int64_t m, n, stride0, stride1;
+    get_prune_matrix_size(is_sparse_a, op, _sparseMatDescr, m, n, stride0, stride1);
+
+    // a broadcast matrix only has the mask of its first batch
+    int num_batches = _sparseMatDescr->batch_stride == 0 ? 1 : _sparseMatDescr->num_batches;
+    *maskSize       = num_batches * m * (n / 8);
+
+    log_api(_handle, __func__, "matmulDescr[in]", *_matmulDescr, "maskSize[out]", *maskSize);
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief prunes a dense matrix and writes the mask of the kept elements.
+ *******************************************************************************/
+rocsparselt_status rocsparselt_smfmac_prune_mask(const rocsparselt_handle*       handle,
+                                                 const rocsparselt_matmul_descr* matmulDescr,
+                                                 const void*                     d_in,
+                                                 void*                           d_out,
+                                                 void*                           d_mask,
+                                                 rocsparselt_prune_alg           pruneAlg,
+                                                 hipStream_t                     stream)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
     {
-        log_error(_handle, __func__, "d_in is a NULL pointer");
-        return rocsparselt_status_invalid_pointer;
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
     }
 
-    if(d_out == nullptr)
+    if(matmulDescr == nullptr)
     {
-        log_error(_handle, __func__, "d_out is a NULL pointer");
+        log_error(_handle, __func__, "matmulDescr is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _matmulDescr = reinterpret_cast<const _rocsparselt_matmul_descr*>(matmulDescr);
+    if(!_matmulDescr->isInit())
+    {
+        log_error(_handle, __func__, "matmulDescr did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(_handle, _matmulDescr, __func__));
+
+    // Check if pointer is valid
+    if(d_in == nullptr || d_out == nullptr || d_mask == nullptr)
+    {
+        log_error(_handle, __func__, "d_in, d_out or d_mask is a NULL pointer");
         return rocsparselt_status_invalid_pointer;
     }
 
@@ -797,46 +2464,53 @@ rocsparselt_status rocsparselt_smfmac_prune2(const rocsparselt_handle*    handle
         return rocsparselt_status_not_implemented;
     }
 
-    // Check if matrix A is a structured matrix
-    if(_sparseMatDescr->m_type != rocsparselt_matrix_type_structured)
-    {
-        log_error(_handle, __func__, "Matrix is not a structured matrix");
-        return rocsparselt_status_not_implemented;
-    }
+    bool                    is_sparse_a = _matmulDescr->is_sparse_a;
+    rocsparselt_operation   op          = is_sparse_a ? _matmulDescr->op_A : _matmulDescr->op_B;
+    _rocsparselt_mat_descr* _sparseMatDescr
+        = is_sparse_a ? _matmulDescr->matrix_A : _matmulDescr->matrix_B;
+    int64_t m, n, stride0, stride1;
+    int64_t ld = _sparseMatDescr->ld;
+    get_prune_matrix_size(is_sparse_a, op, _sparseMatDescr, m, n, stride0, stride1);
 
     log_api(_handle,
             __func__,
-            "sparseMatDescr[in]",
-            *_sparseMatDescr,
-            "isSparseA[in]",
-            isSparseA,
-            "op[in]",
-            rocsparselt_operation_to_string(op),
+            "matmulDescr[in]",
+            *_matmulDescr,
             "d_in[in]",
             d_in,
             "d_out[out]",
             d_out,
+            "d_mask[out]",
+            d_mask,
             "pruneAlg[in]",
             pruneAlg,
             "stream[in]",
             stream);
-
-    int64_t m, n, stride0, stride1;
-    int64_t ld = _sparseMatDescr->ld;
-    get_prune_matrix_size(isSparseA, op, _sparseMatDescr, m, n, stride0, stride1);
-
-    return rocsparselt_smfmac_prune_impl(
-        _handle, _sparseMatDescr, m, n, stride0, stride1, ld, d_in, d_out, pruneAlg, stream);
+    return rocsparselt_smfmac_prune_mask_impl(_handle,
+                                              _sparseMatDescr,
+                                              m,
+                                              n,
+                                              stride0,
+                                              stride1,
+                                              ld,
+                                              d_in,
+                                              d_out,
+                                              d_mask,
+                                              nullptr,
+                                              nullptr,
+                                              pruneAlg,
+                                              stream);
 }
 
 /********************************************************************************
- * \brief
+ * \brief zeros the elements of a dense matrix which a mask does not keep.
  *******************************************************************************/
-rocsparselt_status rocsparselt_smfmac_prune_check(const rocsparselt_handle*       handle,
-                                                  const rocsparselt_matmul_descr* matmulDescr,
-                                                  const void*                     d_in,
-                                                  int*                            d_out,
-                                                  hipStream_t                     stream)
+rocsparselt_status rocsparselt_smfmac_mask_apply(const rocsparselt_handle*       handle,
+                                                 const rocsparselt_matmul_descr* matmulDescr,
+                                                 const void*                     d_in,
+                                                 void*                           d_out,
+                                                 const void*                     d_mask,
+                                                 hipStream_t                     stream)
 {
     // Check if handle is valid
     if(handle == nullptr)
@@ -862,25 +2536,22 @@ rocsparselt_status rocsparselt_smfmac_prune_check(const rocsparselt_handle*
         log_error(_handle, __func__, "matmulDescr did not initialized or already destroyed");
         return rocsparselt_status_invalid_handle;
     }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(_handle, _matmulDescr, __func__));
 
     // Check if pointer is valid
-    if(d_in == nullptr)
-    {
-        log_error(_handle, __func__, "d_in is a NULL pointer");
-        return rocsparselt_status_invalid_pointer;
-    }
-
-    if(d_out == nullptr)
+    if(d_in == nullptr || d_out == nullptr || d_mask == nullptr)
     {
-        log_error(_handle, __func__, "d_out is a NULL pointer");
+        log_error(_handle, __func__, "d_in, d_out or d_mask is a NULL pointer");
         return rocsparselt_status_invalid_pointer;
     }
 
-    rocsparselt_operation   op     = _matmulDescr->is_sparse_a ? _matmulDescr->op_A : _matmulDescr->op_B;
-    _rocsparselt_mat_descr *_sparseMatDescr = _matmulDescr->is_sparse_a ? _matmulDescr->matrix_A : _matmulDescr->matrix_B;
+    bool                    is_sparse_a = _matmulDescr->is_sparse_a;
+    rocsparselt_operation   op          = is_sparse_a ? _matmulDescr->op_A : _matmulDescr->op_B;
+    _rocsparselt_mat_descr* _sparseMatDescr
+        = is_sparse_a ? _matmulDescr->matrix_A : _matmulDescr->matrix_B;
     int64_t m, n, stride0, stride1;
     int64_t ld = _sparseMatDescr->ld;
-    get_prune_matrix_size(_matmulDescr->is_sparse_a, op, _sparseMatDescr, m, n, stride0, stride1);
+    get_prune_matrix_size(is_sparse_a, op, _sparseMatDescr, m, n, stride0, stride1);
 
     log_api(_handle,
             __func__,
@@ -890,30 +2561,27 @@ rocsparselt_status rocsparselt_smfmac_prune_check(const rocsparselt_handle*
             d_in,
             "d_out[out]",
             d_out,
+            "d_mask[in]",
+            d_mask,
             "stream[in]",
             stream);
-    return rocsparselt_smfmac_prune_check_impl(_handle,
-                                               _sparseMatDescr,
-                                               m,
-                                               n,
-                                               stride0,
-                                               stride1,
-                                               ld,
-                                               d_in,
-                                               d_out,
-                                               stream);
+    return rocsparselt_smfmac_mask_apply_impl(
+        _handle, _sparseMatDescr, m, n, stride0, stride1, ld, d_in, d_out, d_mask, stream);
 }
 
 /********************************************************************************
- * \brief
+ * \brief prunes a dense matrix by an importance score instead of the magnitude
+ * of its own values.
  *******************************************************************************/
-rocsparselt_status rocsparselt_smfmac_prune_check2(const rocsparselt_handle*    handle,
-                                                   const rocsparselt_mat_descr* sparseMatDescr,
-                                                   int                          isSparseA,
-                                                   rocsparselt_operation        op,
-                                                   const void*                  d_in,
-                                                   int*                         d_out,
-                                                   hipStream_t                  stream)
+rocsparselt_status rocsparselt_smfmac_prune_scored(const rocsparselt_handle*       handle,
+                                                   const rocsparselt_matmul_descr* matmulDescr,
+                                                   const void*                     d_in,
+                                                   void*                           d_out,
+                                                   const float*                    d_score,
+                                                   const float*                    d_colScale,
+                                                   void*                           d_mask,
+                                                   rocsparselt_prune_alg           pruneAlg,
+                                                   hipStream_t                     stream)
 {
     // Check if handle is valid
     if(handle == nullptr)
@@ -928,68 +2596,118 @@ rocsparselt_status rocsparselt_smfmac_prune_check2(const rocsparselt_handle*
         return rocsparselt_status_invalid_handle;
     }
 
-    if(sparseMatDescr == nullptr)
+    if(matmulDescr == nullptr)
     {
-        log_error(_handle, __func__, "sparseMatDescr is a NULL pointer");
+        log_error(_handle, __func__, "matmulDescr is a NULL pointer");
         return rocsparselt_status_invalid_handle;
     }
-    auto _sparseMatDescr = reinterpret_cast<_rocsparselt_mat_descr*>(
-        const_cast<rocsparselt_mat_descr*>(sparseMatDescr));
-    if(!_sparseMatDescr->isInit())
+    auto _matmulDescr = reinterpret_cast<const _rocsparselt_matmul_descr*>(matmulDescr);
+    if(!_matmulDescr->isInit())
     {
-        log_error(_handle, __func__, "sparseMatDescr did not initialized or already destroyed");
+        log_error(_handle, __func__, "matmulDescr did not initialized or already destroyed");
         return rocsparselt_status_invalid_handle;
     }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_aligned(_handle, _matmulDescr, __func__));
 
-    if(op != rocsparselt_operation_none && op != rocsparselt_operation_transpose)
-    {
-        log_error(_handle, __func__, "op is invalid");
-        return rocsparselt_status_invalid_value;
-    }
-
-    // Check if pointer is valid
-    if(d_in == nullptr)
+    // Check if pointer is valid, the mask is optional
+    if(d_in == nullptr || d_out == nullptr)
     {
-        log_error(_handle, __func__, "d_in is a NULL pointer");
+        log_error(_handle, __func__, "d_in or d_out is a NULL pointer");
         return rocsparselt_status_invalid_pointer;
     }
-
-    if(d_out == nullptr)
+    if(d_score == nullptr && d_colScale == nullptr)
     {
-        log_error(_handle, __func__, "d_out is a NULL pointer");
+        log_error(_handle, __func__, "d_score and d_colScale are both NULL pointers");
         return rocsparselt_status_invalid_pointer;
     }
 
-    // Check if matrix A is a structured matrix
-    if(_sparseMatDescr->m_type != rocsparselt_matrix_type_structured)
+    // Check if prune alg is valid
+    if(pruneAlg != rocsparselt_prune_smfmac_strip && pruneAlg != rocsparselt_prune_smfmac_tile)
     {
-        log_error(_handle, __func__, "Matrix is not a structured matrix");
+        log_error(_handle, __func__, "pruneAlg", pruneAlg, "is not supported");
         return rocsparselt_status_not_implemented;
     }
 
+    bool                    is_sparse_a = _matmulDescr->is_sparse_a;
+    rocsparselt_operation   op          = is_sparse_a ? _matmulDescr->op_A : _matmulDescr->op_B;
+    _rocsparselt_mat_descr* _sparseMatDescr
+        = is_sparse_a ? _matmulDescr->matrix_A : _matmulDescr->matrix_B;
+    int64_t m, n, stride0, stride1;
+    int64_t ld = _sparseMatDescr->ld;
+    get_prune_matrix_size(is_sparse_a, op, _sparseMatDescr, m, n, stride0, stride1);
+
     log_api(_handle,
             __func__,
-            "sparseMatDescr[in]",
-            *_sparseMatDescr,
-            "isSparseA[in]",
-            isSparseA,
-            "op[in]",
-            rocsparselt_operation_to_string(op),
+            "matmulDescr[in]",
+            *_matmulDescr,
             "d_in[in]",
             d_in,
             "d_out[out]",
             d_out,
+            "d_score[in]",
+            d_score,
+            "d_colScale[in]",
+            d_colScale,
+            "d_mask[out]",
+            d_mask,
+            "pruneAlg[in]",
+            pruneAlg,
             "stream[in]",
             stream);
-
-    int64_t m, n, stride0, stride1;
-    int64_t ld = _sparseMatDescr->ld;
-    get_prune_matrix_size(isSparseA, op, _sparseMatDescr, m, n, stride0, stride1);
-
-    return rocsparselt_smfmac_prune_check_impl(
-        _handle, _sparseMatDescr, m, n, stride0, stride1, ld, d_in, d_out, stream);
+    return rocsparselt_smfmac_prune_mask_impl(_handle,
+                                              _sparseMatDescr,
+                                              m,
+                                              n,
+                                              stride0,
+                                              stride1,
+                                              ld,
+                                              d_in,
+                                              d_out,
+                                              d_mask,
+                                              d_score,
+                                              d_colScale,
+                                              pruneAlg,
+                                              stream);
 }
 
 #ifdef __cplusplus
 }
 #endif
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_smfmac_prune_compress_operand(const _rocsparselt_handle*       handle,
+                                              const _rocsparselt_matmul_descr* descr,
+                                              const void*                      d_dense,
+                                              void*                            d_compressed,
+                                              rocsparselt_prune_alg            pruneAlg,
+                                              hipStream_t                      stream)
+{
+    bool                    is_sparse_a = descr->is_sparse_a;
+    rocsparselt_operation   op          = is_sparse_a ? descr->op_A : descr->op_B;
+    _rocsparselt_mat_descr* matrix      = is_sparse_a ? descr->matrix_A : descr->matrix_B;
+    int64_t                 m, n, stride0, stride1, c_stride0, c_stride1;
+    int64_t                 m_stride0 = matrix->c_k / 4;
+    int64_t                 m_stride1 = 1;
+    get_compress_matrix_size(is_sparse_a, op, matrix, m, n, stride0, stride1, c_stride0, c_stride1);
+
+    return rocsparselt_smfmac_prune_compress_impl(handle,
+                                                  matrix,
+                                                  m,
+                                                  n,
+                                                  stride0,
+                                                  stride1,
+                                                  matrix->ld,
+                                                  c_stride0,
+                                                  c_stride1,
+                                                  m_stride0,
+                                                  m_stride1,
+                                                  matrix->c_ld * matrix->c_n,
+                                                  matrix->c_ld * matrix->c_n / 4,
+                                                  d_dense,
+                                                  d_compressed,
+                                                  pruneAlg,
+                                                  stream);
+}
@@ -0,0 +1,241 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "rocsparselt_sharded.hpp"
+#include "definitions.h"
+#include "handle.h"
+#include "hipsparselt_ostream.hpp"
+#include "rocsparselt_compress.hpp"
+#include "rocsparselt_pad.hpp"
+#include "rocsparselt_spmm_utils.hpp"
+#include "utility.hpp"
+
+#include <hip/hip_bfloat16.h>
+#include <hip/hip_fp16.h>
+#include <hip/hip_runtime.h>
+
+namespace
+{
+    constexpr int shard_threads = 256;
+
+    bool same_operand(const _rocsparselt_mat_descr* first, const _rocsparselt_mat_descr* shard)
+    {
+        return first->type == shard->type && first->num_batches == shard->num_batches;
+    }
+
+    // whether shard is a shard of the matmul of first split along split
+    bool same_matmul(const _rocsparselt_matmul_descr* first,
+                     const _rocsparselt_matmul_descr* shard,
+                     rocsparselt_shard_split          split)
+    {
+        if(first->is_sparse_a != shard->is_sparse_a || first->op_A != shard->op_A
+           || first->op_B != shard->op_B || first->compute_type != shard->compute_type
+           || !same_operand(first->matrix_A, shard->matrix_A)
+           || !same_operand(first->matrix_B, shard->matrix_B)
+           || !same_operand(first->matrix_C, shard->matrix_C)
+           || !same_operand(first->matrix_D, shard->matrix_D))
+            return false;
+        // the partial D are summed and the sum copied back, they share their layout
+        if(split == rocsparselt_shard_split_k)
+            return first->m == shard->m && first->n == shard->n
+                   && first->matrix_D->ld == shard->matrix_D->ld
+                   && first->matrix_D->batch_stride == shard->matrix_D->batch_stride;
+        // the outer dimension of the sparse matrix is split, the dense input is shared
+        return first->k == shard->k && (first->is_sparse_a ? first->n == shard->n
+                                                           : first->m == shard->m);
+    }
+
+    // the partial D are summed before the epilogue would see them, only a linear epilogue
+    // can be split, the terms of the sum only once
+    rocsparselt_status check_split_k_epilogue(const _rocsparselt_handle*       handle,
+                                              const _rocsparselt_matmul_descr* descr,
+                                              bool                             first,
+                                              const char*                      caller)
+    {
+        switch(descr->matrix_D->type)
+        {
+        case rocsparselt_datatype_f16_r:
+        case rocsparselt_datatype_bf16_r:
+        case rocsparselt_datatype_f32_r:
+            break;
+        default:
+            log_error(handle, caller, "the D of a matmul split along k must be f16, bf16 or f32");
+            return rocsparselt_status_not_implemented;
+        }
+        if(descr->activation != rocsparselt_matmul_activation_none
+           || descr->gate_pointer != nullptr || descr->amax_d_pointer != nullptr
+           || descr->bias_grad_pointer != nullptr || descr->d_scale != 1.0f || descr->d_saturate
+           || descr->beta_vector_scaling)
+        {
+            log_error(handle, caller, "the epilogue of a matmul split along k must be linear");
+            return rocsparselt_status_not_implemented;
+        }
+        if(!first && (descr->bias_pointer != nullptr || descr->residual_pointer != nullptr))
+        {
+            log_error(
+                handle, caller, "only the first shard split along k adds a bias or a residual");
+            return rocsparselt_status_not_implemented;
+        }
+        return rocsparselt_status_success;
+    }
+
+    // adds the rows x cols matrices of partial to the ones of sum, in float. A workgroup row of
+    // the grid per batch.
+    template <typename T>
+    __global__ __launch_bounds__(shard_threads) void shard_reduce_kernel(T*       sum,
+                                                                         const T* partial,
+                                                                         int64_t  rows,
+                                                                         int64_t  cols,
+                                                                         int64_t  ld,
+                                                                         int64_t  stride)
+    {
+        const int64_t offset = int64_t(blockIdx.y) * stride;
+        const int64_t size   = rows * cols;
+        for(int64_t idx = int64_t(blockIdx.x) * blockDim.x + threadIdx.x; idx < size;
+            idx += int64_t(gridDim.x) * blockDim.x)
+        {
+            int64_t pos = offset + idx % rows + idx / rows * ld;
+            sum[pos]    = static_cast<T>(static_cast<float>(sum[pos])
+                                      + static_cast<float>(partial[pos]));
+        }
+    }
+
+    template <typename T>
+    hipError_t shard_reduce(const _rocsparselt_handle*    handle,
+                            const _rocsparselt_mat_descr* matrix,
+                            void*                         sum,
+                            const void*                   partial,
+                            hipStream_t                   stream)
+    {
+        int     num_batches = matrix->batch_stride == 0 ? 1 : matrix->num_batches;
+        int64_t blocks      = grid_stride_blocks(
+            handle, (matrix->m * matrix->n + shard_threads - 1) / shard_threads, shard_threads);
+        hipLaunchKernelGGL((shard_reduce_kernel<T>),
+                           dim3(blocks, num_batches),
+                           dim3(shard_threads),
+                           0,
+                           stream,
+                           static_cast<T*>(sum),
+                           static_cast<const T*>(partial),
+                           matrix->m,
+                           matrix->n,
+                           matrix->ld,
+                           matrix->batch_stride);
+        return hipGetLastError();
+    }
+}
+
+rocsparselt_status rocsparselt_check_shards(const rocsparselt_handle* const*      handles,
+                                            const rocsparselt_matmul_plan* const* plans,
+                                            int32_t                               numShards,
+                                            rocsparselt_shard_split               split,
+                                            const char*                           caller)
+{
+    if(handles == nullptr)
+    {
+        hipsparselt_cerr << "handles is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    for(int32_t i = 0; i < numShards; i++)
+    {
+        auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handles[i]);
+        if(_handle == nullptr || !_handle->isInit())
+        {
+            hipsparselt_cerr << "handle of shard " << i
+                             << " is a NULL pointer, did not initialized or already destroyed"
+                             << std::endl;
+            return rocsparselt_status_invalid_handle;
+        }
+    }
+
+    auto first = reinterpret_cast<const _rocsparselt_handle*>(handles[0]);
+    if(plans == nullptr)
+    {
+        log_error(first, caller, "plans is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+    if(split != rocsparselt_shard_split_output && split != rocsparselt_shard_split_k)
+    {
+        log_error(first, caller, "split is invalid");
+        return rocsparselt_status_invalid_value;
+    }
+
+    const _rocsparselt_matmul_descr* first_descr = nullptr;
+    for(int32_t i = 0; i < numShards; i++)
+    {
+        auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handles[i]);
+        auto _plan   = reinterpret_cast<const _rocsparselt_matmul_plan*>(plans[i]);
+        if(_plan == nullptr || !_plan->isInit() || _plan->handle != _handle)
+        {
+            log_error(_handle, caller, "plan of shard", i, "is invalid or not of its handle");
+            return rocsparselt_status_invalid_handle;
+        }
+        RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, caller));
+
+        auto descr = _plan->matmul_descr;
+        if(i == 0)
+            first_descr = descr;
+        if(!same_matmul(first_descr, descr, split))
+        {
+            log_error(_handle, caller, "shard", i, "is not a shard of the matmul of shard 0");
+            return rocsparselt_status_invalid_size;
+        }
+        if(split == rocsparselt_shard_split_k)
+            RETURN_IF_ROCSPARSELT_ERROR(check_split_k_epilogue(_handle, descr, i == 0, caller));
+    }
+    return rocsparselt_status_success;
+}
+
+size_t rocsparselt_shard_partial_bytes(const _rocsparselt_matmul_descr* descr)
+{
+    return (rocsparselt_dense_matrix_bytes(descr->matrix_D) + 255) / 256 * 256;
+}
+
+rocsparselt_status rocsparselt_shard_reduce(const _rocsparselt_handle*       handle,
+                                            const _rocsparselt_matmul_descr* descr,
+                                            void*                            d_sum,
+                                            const void*                      d_partial,
+                                            hipStream_t                      stream)
+{
+    const _rocsparselt_mat_descr* matrix = descr->matrix_D;
+    if(matrix->m == 0 || matrix->n == 0)
+        return rocsparselt_status_success;
+    switch(matrix->type)
+    {
+    case rocsparselt_datatype_f16_r:
+        RETURN_IF_HIP_ERROR(shard_reduce<__half>(handle, matrix, d_sum, d_partial, stream));
+        break;
+    case rocsparselt_datatype_bf16_r:
+        RETURN_IF_HIP_ERROR(shard_reduce<hip_bfloat16>(handle, matrix, d_sum, d_partial, stream));
+        break;
+    case rocsparselt_datatype_f32_r:
+        RETURN_IF_HIP_ERROR(shard_reduce<float>(handle, matrix, d_sum, d_partial, stream));
+        break;
+    default:
+        return rocsparselt_status_not_implemented;
+    }
+    return rocsparselt_status_success;
+}
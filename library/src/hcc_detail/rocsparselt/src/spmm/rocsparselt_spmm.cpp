@@ -25,17 +25,52 @@
  *******************************************************************************/
 
 #include "rocsparselt_spmm.hpp"
+#include "config_cache.hpp"
 #include "definitions.h"
 #include "handle.h"
+#include "resource_pool.hpp"
+#include "rocsparselt_compress.hpp"
+#include "rocsparselt_pad.hpp"
+#include "rocsparselt_sharded.hpp"
 #include "rocsparselt_spmm_utils.hpp"
+#include "tracing.hpp"
+#include "tuning_db.hpp"
 #include "utility.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
 #include <hip/hip_runtime_api.h>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// the workspace of the matmul of plan, the one of its config, or for a padded plan the one of
+// its largest config followed by the padded matrices, and for a dynamic sparse plan followed by
+// the compressed operand
+static size_t plan_workspace_bytes(const _rocsparselt_matmul_plan* plan)
+{
+    const _rocsparselt_matmul_alg_selection* alg = plan->alg_selection;
+    if(plan->unpadded_descr != nullptr)
+        return rocsparselt_pad_workspace_offset(alg)
+               + rocsparselt_pad_staging_bytes(plan->matmul_descr);
+    if(plan->matmul_descr->sparse_dynamic)
+        return rocsparselt_pad_workspace_offset(alg)
+               + rocsparselt_compressed_matrix_bytes(plan->matmul_descr->is_sparse_a
+                                                         ? plan->matmul_descr->matrix_A
+                                                         : plan->matmul_descr->matrix_B);
+    return alg->config_max_id == 0 ? 0 : alg->configs[alg->config_id].max_workspace_bytes;
+}
+
 /********************************************************************************
  * \brief
  *******************************************************************************/
@@ -77,31 +112,140 @@ rocsparselt_status rocsparselt_matmul_get_workspace(const rocsparselt_handle*
     }
 
     {
-        if(_plan->alg_selection->config_max_id == 0)
-            *workspaceSize = 0;
-        else
-        {
-            *workspaceSize = _plan->alg_selection->configs[_plan->alg_selection->config_id]
-                                 .max_workspace_bytes;
-        }
+        *workspaceSize = plan_workspace_bytes(_plan);
         log_api(_handle, __func__, *workspaceSize);
         return rocsparselt_status_success;
     }
 }
 
-rocsparselt_status rocsparselt_matmul_impl(const char*                    caller,
-                                           const rocsparselt_handle*      handle,
-                                           const rocsparselt_matmul_plan* plan,
-                                           const void*                    alpha,
-                                           const void*                    d_A,
-                                           const void*                    d_B,
-                                           const void*                    beta,
-                                           const void*                    d_C,
-                                           void*                          d_D,
-                                           void*                          workspace,
-                                           hipStream_t*                   streams,
-                                           int32_t                        numStreams,
-                                           bool                           search = false)
+// Write the hipsparselt-bench command line running the matmul of the plan to the bench log,
+// which hipsparselt-bench --replay runs again
+static void log_bench_matmul(const _rocsparselt_handle*         handle,
+                             const char*                        caller,
+                             const _rocsparselt_matmul_plan*    plan,
+                             const void*                        alpha,
+                             const void*                        beta,
+                             int32_t                            numStreams,
+                             const _rocsparselt_batch_pointers* batch_pointers)
+{
+    if(!handle->log_bench)
+        return;
+
+    // the bench runs the sizes of the caller, it pads them again
+    const _rocsparselt_matmul_descr* descr
+        = plan->unpadded_descr != nullptr ? plan->unpadded_descr : plan->matmul_descr;
+    const _rocsparselt_mat_descr* A = descr->matrix_A;
+    const _rocsparselt_mat_descr* B = descr->matrix_B;
+    const _rocsparselt_mat_descr* C = descr->matrix_C;
+    const _rocsparselt_mat_descr* D = descr->matrix_D;
+
+    std::ostringstream args;
+    args << std::setprecision(std::numeric_limits<float>::max_digits10);
+    args << "-f " << (C->num_batches > 1 ? "spmm_strided_batched" : "spmm") << " -m " << descr->m
+         << " -n " << descr->n << " -k " << descr->k << " --lda " << A->ld << " --ldb " << B->ld
+         << " --ldc " << C->ld << " --ldd " << D->ld << " --transposeA "
+         << rocsparselt_transpose_letter(descr->op_A) << " --transposeB "
+         << rocsparselt_transpose_letter(descr->op_B) << " --a_type "
+         << rocsparselt_datatype_string(A->type) << " --b_type "
+         << rocsparselt_datatype_string(B->type) << " --c_type "
+         << rocsparselt_datatype_string(C->type) << " --d_type "
+         << rocsparselt_datatype_string(D->type) << " --compute_type "
+         << rocsparselt_compute_type_string(descr->compute_type);
+    if(C->num_batches > 1)
+        args << " --batch_count " << C->num_batches << " --stride_a " << A->batch_stride
+             << " --stride_b " << B->batch_stride << " --stride_c " << C->batch_stride
+             << " --stride_d " << D->batch_stride << " --any_stride";
+    if(descr->alpha_vector_scaling)
+        args << " --alpha_vector_scaling";
+    else
+        args << " --alpha " << *static_cast<const float*>(alpha) << " --beta "
+             << *static_cast<const float*>(beta);
+    if(!descr->is_sparse_a)
+        args << " --sparse_b";
+
+    // the client takes no infinite argument, the upper bounds default to it
+    const char* activation = rocsparselt_activation_type_to_string(descr->activation);
+    float       arg1 = 0.0f, arg2 = std::numeric_limits<float>::infinity();
+    switch(descr->activation)
+    {
+    case rocsparselt_matmul_activation_relu:
+        arg1 = descr->activation_relu_threshold;
+        arg2 = descr->activation_relu_upperbound;
+        if(arg1 != 0.0f || std::isfinite(arg2))
+            activation = "clippedrelu";
+        break;
+    case rocsparselt_matmul_activation_gelu:
+        arg1 = descr->activation_gelu_scaling;
+        break;
+    case rocsparselt_matmul_activation_leakyrelu:
+        arg1 = descr->activation_leakyrelu_alpha;
+        break;
+    case rocsparselt_matmul_activation_tanh:
+        arg1 = descr->activation_tanh_alpha;
+        arg2 = descr->activation_tanh_beta;
+        break;
+    case rocsparselt_matmul_activation_clamp:
+        arg1 = descr->activation_clamp_min;
+        arg2 = descr->activation_clamp_max;
+        break;
+    default:
+        break;
+    }
+    if(descr->activation != rocsparselt_matmul_activation_none)
+    {
+        args << " --activation_type " << activation;
+        if(std::isfinite(arg1))
+            args << " --activation_arg1 " << arg1;
+        if(std::isfinite(arg2))
+            args << " --activation_arg2 " << arg2;
+    }
+
+    if(descr->bias_pointer != nullptr)
+        args << " --bias_vector --bias_type " << rocsparselt_datatype_string(descr->bias_type)
+             << " --bias_stride " << descr->bias_stride;
+    if(descr->scale_a != 1.0f)
+        args << " --scale_a " << descr->scale_a;
+    if(descr->scale_b != 1.0f)
+        args << " --scale_b " << descr->scale_b;
+    if(descr->d_scale != 1.0f)
+        args << " --d_scale " << descr->d_scale;
+    if(descr->d_saturate)
+        args << " --d_saturate";
+    if(descr->amax_d_pointer != nullptr)
+        args << " --amax_d";
+    if(descr->residual_pointer != nullptr)
+        args << " --residual";
+    if(descr->gate_pointer != nullptr)
+        args << " --gate";
+    if(descr->bias_grad_pointer != nullptr)
+        args << " --bias_grad";
+    if(descr->sparse_dynamic)
+        args << " --sparse_dynamic";
+    if(descr->cu_count > 0)
+        args << " --cu_count " << descr->cu_count;
+    if(numStreams > 1)
+        args << " --streams " << numStreams;
+    if(batch_pointers != nullptr)
+        args << " --pointer_array";
+
+    log_bench(handle, caller, "hipsparselt-bench", args.str());
+}
+
+rocsparselt_status
+    rocsparselt_matmul_impl(const char*                        caller,
+                            const rocsparselt_handle*          handle,
+                            const rocsparselt_matmul_plan*     plan,
+                            const void*                        alpha,
+                            const void*                        d_A,
+                            const void*                        d_B,
+                            const void*                        beta,
+                            const void*                        d_C,
+                            void*                              d_D,
+                            void*                              workspace,
+                            hipStream_t*                       streams,
+                            int32_t                            numStreams,
+                            bool                               search         = false,
+                            const _rocsparselt_batch_pointers* batch_pointers = nullptr)
 {
     // Check if handle is valid
     if(handle == nullptr)
@@ -165,18 +309,17 @@ rocsparselt_status rocsparselt_matmul_impl(const char*                    caller
         return rocsparselt_status_invalid_pointer;
     }
 
+    // the host time of a sampled plan is counted from here, the search is not counted
+    _rocsparselt_plan_stats* stats      = search ? nullptr : _plan->stats;
+    auto                     call_start = stats ? std::chrono::steady_clock::now()
+                                                : std::chrono::steady_clock::time_point();
+
+    // algorithm selection, config_id can be swapped by a background search at any time
+    int config_id     = __atomic_load_n(&_plan->alg_selection->config_id, __ATOMIC_ACQUIRE);
+    int config_max_id = _plan->alg_selection->config_max_id;
+
     size_t workspaceSize
-        = _plan->alg_selection->config_max_id == 0
-              ? 0
-              : _plan->alg_selection->configs[_plan->alg_selection->config_id].max_workspace_bytes;
-    if(workspace == nullptr && workspaceSize != 0)
-    {
-        hipsparselt_cerr << "The parameter number 9 (workspace) had an illegal value "
-                            "expected a device memroy with "
-                         << workspaceSize << " bytes, but current is nullptr" << std::endl;
-        log_error(_handle, caller, "expected workspace is not a NULL pointer");
-        return rocsparselt_status_invalid_value;
-    }
+        = config_max_id == 0 ? 0 : _plan->alg_selection->configs[config_id].max_workspace_bytes;
 
     if(numStreams < 0)
     {
@@ -195,14 +338,86 @@ rocsparselt_status rocsparselt_matmul_impl(const char*                    caller
         return rocsparselt_status_invalid_value;
     }
 
-    // algorithm selection
-    int config_id         = _plan->alg_selection->config_id;
-    int config_max_id     = _plan->alg_selection->config_max_id;
+    hipStream_t stream = numStreams > 0 ? streams[0] : nullptr;
+
+    rocsparselt_trace_span trace(search ? "search" : "matmul", stream);
+
+    // A padded plan copies its operands to the padded matrices behind the workspace of its
+    // largest config, so that the search can run any config.
+    size_t staging_offset = 0, staging_bytes = 0;
+    if(_plan->unpadded_descr != nullptr)
+    {
+        if(batch_pointers != nullptr)
+            RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, caller));
+        staging_offset = rocsparselt_pad_workspace_offset(_plan->alg_selection);
+        staging_bytes  = rocsparselt_pad_staging_bytes(_plan->matmul_descr);
+        if(search)
+            workspaceSize = staging_offset;
+    }
+    // A dynamic sparse plan compresses its dense structured operand behind the workspace of its
+    // largest config too, the matmul of every config reads it there.
+    const _rocsparselt_matmul_descr* descr = _plan->matmul_descr;
+    if(descr->sparse_dynamic)
+    {
+        if(batch_pointers != nullptr)
+        {
+            log_error(
+                _handle, caller, "the dynamic sparsity is not supported by the pointer arrays");
+            return rocsparselt_status_not_implemented;
+        }
+        staging_offset = rocsparselt_pad_workspace_offset(_plan->alg_selection);
+        staging_bytes  = rocsparselt_compressed_matrix_bytes(descr->is_sparse_a ? descr->matrix_A
+                                                                                : descr->matrix_B);
+        if(search)
+            workspaceSize = staging_offset;
+    }
+    // A mixed input plan keeps its int8 compressed matrix widened, see
+    // _rocsparselt_widened_operand.
+    bool mixed_input = rocsparselt_is_mixed_input(descr);
+    if(mixed_input && descr->sparse_dynamic)
+    {
+        log_error(_handle, caller, "the dynamic sparsity is not supported by a mixed input");
+        return rocsparselt_status_not_implemented;
+    }
+    size_t requiredSize = staging_bytes != 0 ? staging_offset + staging_bytes : workspaceSize;
+
+    // A NULL workspace is drawn from the workspace pool of the handle on streams[0], which
+    // runs all the kernels of a config with a workspace. The search gets the whole pool, so
+    // it also times the configs needing a larger workspace than the current one.
+    rocsparselt_pooled_workspace pooled_workspace(_handle->workspace_pool);
+    if(workspace == nullptr && _handle->workspace_pool != nullptr && (requiredSize != 0 || search))
+    {
+        hipStreamCaptureStatus capture = hipStreamCaptureStatusNone;
+        RETURN_IF_HIP_ERROR(hipStreamIsCapturing(stream, &capture));
+        size_t pool_size = _handle->workspace_pool->size();
+        // a graph would replay the allocation of the capture
+        if(capture == hipStreamCaptureStatusNone && requiredSize <= pool_size)
+        {
+            if(search && staging_bytes == 0)
+                workspaceSize = requiredSize = pool_size;
+            RETURN_IF_HIP_ERROR(pooled_workspace.acquire(requiredSize, stream));
+            workspace = pooled_workspace.get();
+        }
+    }
+    if(workspace == nullptr && requiredSize != 0)
+    {
+        hipsparselt_cerr << "The parameter number 9 (workspace) had an illegal value "
+                            "expected a device memroy with "
+                         << requiredSize << " bytes, but current is nullptr" << std::endl;
+        log_error(_handle, caller, "expected workspace is not a NULL pointer");
+        return rocsparselt_status_invalid_value;
+    }
+
     int search_iterations = search ? _plan->alg_selection->search_iterations : 0; //default
 
-#define EX_PARM                                                                              \
-    caller, _handle, _plan, alpha, beta, d_A, d_B, d_C, d_D, workspace, streams, numStreams, \
-        &config_id, config_max_id, search_iterations
+    // kept apart until the search succeeds
+    rocsparselt_matmul_search_result
+        search_results[_rocsparselt_matmul_alg_selection::max_search_results];
+
+#define EX_PARM                                                                          \
+    caller, _handle, _plan, alpha, beta, d_A, d_B, d_C, d_D, workspace, workspaceSize,   \
+        streams, numStreams, &config_id, config_max_id, search_iterations,               \
+        search ? search_results : nullptr, batch_pointers
 
     log_api(_handle,
             caller,
@@ -229,11 +444,90 @@ rocsparselt_status rocsparselt_matmul_impl(const char*                    caller
             "numStreams[in]",
             numStreams);
 
-    rocsparselt_status status = rocsparselt_spmm_template(EX_PARM);
-    if(search && status == rocsparselt_status_success)
+    if(!search)
+        log_bench_matmul(_handle, caller, _plan, alpha, beta, numStreams, batch_pointers);
+
+    // the matmul reads the padded dense input and C, and writes the padded D
+    void* staging = static_cast<char*>(workspace) + staging_offset;
+    void* user_D  = d_D;
+    if(staging_bytes != 0 && !descr->sparse_dynamic)
+        RETURN_IF_ROCSPARSELT_ERROR(
+            rocsparselt_pad_operands(_plan, staging, &d_A, &d_B, &d_C, &d_D, stream));
+
+    // the structured operand is pruned and compressed by a single kernel on streams[0], which
+    // the matmul runs on right after it
+    if(descr->sparse_dynamic)
+    {
+        const void*& d_sparse = descr->is_sparse_a ? d_A : d_B;
+        RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_smfmac_prune_compress_operand(
+            _handle, descr, d_sparse, staging, rocsparselt_prune_smfmac_strip, stream));
+        d_sparse = staging;
+    }
+
+    // the kernels of the type of the dense matrix read the widened compressed int8 matrix,
+    // widened on streams[0] by the first matmul given it
+    if(mixed_input)
+    {
+        const void*& d_sparse = descr->is_sparse_a ? d_A : d_B;
+        RETURN_IF_ROCSPARSELT_ERROR(
+            rocsparselt_smfmac_widened_operand(_handle, _plan, d_sparse, &d_sparse, stream));
+    }
+
+    // a call captured into a graph is counted, but not timed
+    hipEvent_t start_event = nullptr;
+    if(stats != nullptr)
+    {
+        int64_t                call    = stats->calls.fetch_add(1, std::memory_order_relaxed);
+        hipStreamCaptureStatus capture = hipStreamCaptureStatusNone;
+        RETURN_IF_HIP_ERROR(hipStreamIsCapturing(stream, &capture));
+        if(capture == hipStreamCaptureStatusNone)
+            RETURN_IF_HIP_ERROR(stats->start(call, stream, &start_event));
+    }
+
+    rocsparselt_status status;
+    try
+    {
+        rocsparselt_trace_gpu_span gpu_trace(search ? "search" : "matmul", stream);
+        status = rocsparselt_spmm_template(EX_PARM);
+    }
+    catch(...)
+    {
+        if(start_event != nullptr)
+            (void)stats->stop(start_event, stream, false);
+        throw;
+    }
+
+    if(stats != nullptr)
+    {
+        if(start_event != nullptr)
+            RETURN_IF_HIP_ERROR(
+                stats->stop(start_event, stream, status == rocsparselt_status_success));
+        auto host_time = std::chrono::steady_clock::now() - call_start;
+        stats->count(std::chrono::duration_cast<std::chrono::nanoseconds>(host_time).count(),
+                     workspaceSize);
+    }
+
+    if(staging_bytes != 0 && !descr->sparse_dynamic && status == rocsparselt_status_success)
+        status = rocsparselt_unpad_result(_plan, staging, user_D, stream);
+
+    // a dense-only plan has no config to select
+    if(search && status == rocsparselt_status_success && !_plan->alg_selection->dense_only)
     {
         log_info(_handle, caller, "found the best config_id", config_id);
-        _plan->alg_selection->config_id = config_id;
+        __atomic_store_n(&_plan->alg_selection->config_id, config_id, __ATOMIC_RELEASE);
+
+        for(int i = 0; i < _rocsparselt_matmul_alg_selection::max_search_results; i++)
+        {
+            auto& result = _plan->alg_selection->search_results[i] = search_results[i];
+            if(result.config_id >= 0 && result.config_id < config_max_id)
+                result.max_workspace_bytes
+                    = _plan->alg_selection->configs[result.config_id].max_workspace_bytes;
+        }
+
+        // the next plans of the same problem start from the selected config
+        const std::string signature = rocsparselt_tuning_signature(_handle, _plan->matmul_descr);
+        _handle->config_cache->set_best(signature, config_id);
+        rocsparselt_tuning_db_store(signature, _plan->alg_selection->configs[config_id].index);
     }
     return status;
 }
@@ -288,177 +582,1328 @@ rocsparselt_status rocsparselt_matmul_search(const rocsparselt_handle* handle,
                                    numStreams,
                                    true);
 }
-#ifdef __cplusplus
-}
-#endif
 
-template <typename Ti, typename To, typename Tc>
-rocsparselt_status ConstructRocSparseLtProblem(const char*                                 caller,
-                                               RocsparseltContractionProblem<Ti, To, Tc>** prob,
-                                               const _rocsparselt_matmul_descr* matmul_descr,
-                                               const Tc*                        alpha,
-                                               const Tc*                        beta,
-                                               const Ti*                        a,
-                                               const Ti*                        b,
-                                               const To*                        c,
-                                               To*                              d,
-                                               bool                             strided_batch,
-                                               void*                            workspace,
-                                               size_t                           workspaceSize,
-                                               hipStream_t*                     streams,
-                                               int32_t                          numStreams)
+/********************************************************************************
+ * \brief private copies of the inputs of a background search, so that neither
+ * the search nor the matmuls of the caller see the writes of the other one.
+ * The buffers and the event come from the resource pool of the handle, they
+ * must not be in use by a stream anymore when they are released. The buffers
+ * are freed then, the size of the inputs of a search is not worth keeping.
+ *******************************************************************************/
+struct rocsparselt_search_snapshot
 {
-    std::shared_ptr<Tc> _one = std::make_shared<Tc>(static_cast<Tc>(1));
-    if(alpha == nullptr)
-        alpha = _one.get();
+    _rocsparselt_resource_pool* pool      = nullptr;
+    void*                       A         = nullptr;
+    void*                       B         = nullptr;
+    void*                       C         = nullptr;
+    void*                       D         = nullptr;
+    void*                       workspace = nullptr;
+    hipEvent_t                  ready     = nullptr;
+    float                       alpha     = 0.0f;
+    float                       beta      = 0.0f;
 
-    if(beta == nullptr)
-        beta = _one.get();
+    void release()
+    {
+        for(void* ptr : {A, B, C, D, workspace})
+            if(ptr != nullptr)
+                pool->release_scratch(ptr, false);
+        if(ready != nullptr)
+            pool->release_event(ready);
+        *this = {};
+    }
+};
 
-    rocsparselt_operation opA = matmul_descr->op_A;
-    rocsparselt_operation opB = matmul_descr->op_B;
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_search_async(const rocsparselt_handle* handle,
+                                                   rocsparselt_matmul_plan*  plan,
+                                                   const void*               alpha,
+                                                   const void*               d_A,
+                                                   const void*               d_B,
+                                                   const void*               beta,
+                                                   const void*               d_C,
+                                                   hipStream_t               stream)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
 
-    int64_t c_num_cols; 
-    int64_t metadata_offset;
-    const unsigned char* metadata;
-       
-    // matrix A
-    int64_t lda            = matmul_descr->matrix_A->ld;
-    int64_t offset_a       = 0;
-    int64_t batch_stride_a = matmul_descr->matrix_A->batch_stride;
-    int     num_batches_a  = matmul_descr->matrix_A->num_batches;
-    int64_t c_k            = matmul_descr->matrix_A->c_k;
-    int64_t c_ld           = matmul_descr->matrix_A->c_ld;
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _plan = reinterpret_cast<_rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, __func__));
 
-    if(matmul_descr->is_sparse_a)
+    if(alpha == nullptr || d_A == nullptr || d_B == nullptr || beta == nullptr || d_C == nullptr)
     {
+        log_error(_handle, __func__, "alpha, d_A, d_B, beta or d_C is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
 
-        batch_stride_a = (batch_stride_a == 0 ? 0
-                         : (opA == rocsparselt_operation_none) ? c_ld * c_k
-                                                               : c_ld * matmul_descr->matrix_A->n);
-        lda            = c_ld;
+    log_api(_handle,
+            __func__,
+            "plan[in]",
+            *_plan,
+            "alpha[in]",
+            alpha,
+            "d_A[in]",
+            d_A,
+            "d_B[in]",
+            d_B,
+            "beta[in]",
+            beta,
+            "d_C[in]",
+            d_C,
+            "stream[in]",
+            stream);
 
-        c_num_cols      = (opA == rocsparselt_operation_none ? c_k : matmul_descr->matrix_A->n);
-        metadata_offset = rocsparselt_metadata_offset_in_compressed_matrix(c_num_cols, c_ld, (batch_stride_a == 0 ? 1 : num_batches_a), matmul_descr->matrix_A->type);
-        metadata = (a == nullptr) ? nullptr : reinterpret_cast<const unsigned char*>(a) + metadata_offset;
+    auto worker = _plan->search_worker;
+    if(worker->running.exchange(true))
+    {
+        log_error(_handle, __func__, "a search of the plan is already running");
+        return rocsparselt_status_invalid_value;
     }
+    // joins the thread of the previous search, which has already finished
+    worker->wait();
 
-    // matrix B
-    int64_t ldb            = matmul_descr->matrix_B->ld;
-    int64_t offset_b       = 0;
-    int64_t batch_stride_b = 0;
-    batch_stride_b         = matmul_descr->matrix_B->batch_stride;
-    if(!matmul_descr->is_sparse_a)
+    auto   descr           = _plan->matmul_descr;
+    auto   alg             = _plan->alg_selection;
+    size_t compressed_size = 0, compress_buffer_size = 0;
+    auto   status          = rocsparselt_smfmac_compressed_size(
+        handle, plan, &compressed_size, &compress_buffer_size);
+    if(status != rocsparselt_status_success)
     {
-        c_k            = matmul_descr->matrix_B->c_k;
-        c_ld           = matmul_descr->matrix_B->c_ld;
-        batch_stride_b = (batch_stride_b == 0 ? 0
-                         : (opB == rocsparselt_operation_none) ? c_ld * matmul_descr->matrix_B->n
-                                                               : c_ld * c_k);
-        ldb            = c_ld;
-        c_num_cols      = (opB == rocsparselt_operation_none ? matmul_descr->matrix_B->n : c_k);
-        metadata_offset = rocsparselt_metadata_offset_in_compressed_matrix(c_num_cols, c_ld, (batch_stride_b == 0 ? 1 : num_batches_a), matmul_descr->matrix_B->type);
-        metadata = (b == nullptr) ? nullptr : reinterpret_cast<const unsigned char*>(b) + metadata_offset;
+        worker->running = false;
+        return status;
     }
 
-    // matrix C
-    int64_t ldc            = matmul_descr->matrix_C->ld;
-    int64_t offset_c       = 0;
-    int64_t batch_stride_c = 0;
-    batch_stride_c         = matmul_descr->matrix_C->batch_stride;
+    size_t size_A = descr->is_sparse_a ? compressed_size
+                                       : rocsparselt_dense_matrix_bytes(descr->matrix_A);
+    size_t size_B = descr->is_sparse_a ? rocsparselt_dense_matrix_bytes(descr->matrix_B)
+                                       : compressed_size;
+    size_t size_C = rocsparselt_dense_matrix_bytes(descr->matrix_C);
+    size_t size_D = rocsparselt_dense_matrix_bytes(descr->matrix_D);
+    // only the configs fitting in the workspace of the current one are searched
+    size_t workspace_size
+        = alg->config_max_id == 0
+              ? 0
+              : alg->configs[__atomic_load_n(&alg->config_id, __ATOMIC_ACQUIRE)]
+                    .max_workspace_bytes;
 
-    // matrix D
-    int64_t ldd            = matmul_descr->matrix_D->ld;
-    int64_t offset_d       = 0;
-    int64_t batch_stride_d = 0;
-    batch_stride_d         = matmul_descr->matrix_D->batch_stride;
+    // the snapshot holds scalar scales only
+    if(descr->alpha_vector_scaling)
+    {
+        worker->running = false;
+        log_error(_handle, __func__, "the vector scaling is not supported by the async search");
+        return rocsparselt_status_not_implemented;
+    }
+    // the search would write amax(D) of the snapshot while the caller reads it
+    if(descr->amax_d_pointer != nullptr)
+    {
+        worker->running = false;
+        log_error(_handle, __func__, "amax(D) is not supported by the async search");
+        return rocsparselt_status_not_implemented;
+    }
+    // nor a copy of the residual, the caller may overwrite it while the search runs
+    if(descr->residual_pointer != nullptr)
+    {
+        worker->running = false;
+        log_error(_handle, __func__, "the residual is not supported by the async search");
+        return rocsparselt_status_not_implemented;
+    }
+    // the gate neither, and it commonly aliases D which the search overwrites
+    if(descr->gate_pointer != nullptr)
+    {
+        worker->running = false;
+        log_error(_handle, __func__, "the gate is not supported by the async search");
+        return rocsparselt_status_not_implemented;
+    }
+    // the search would write the bias gradient of the snapshot while the caller reads it
+    if(descr->bias_grad_pointer != nullptr)
+    {
+        worker->running = false;
+        log_error(_handle, __func__, "the bias gradient is not supported by the async search");
+        return rocsparselt_status_not_implemented;
+    }
+    // the snapshot holds a compressed matrix, not the dense structured operand
+    if(descr->sparse_dynamic)
+    {
+        worker->running = false;
+        log_error(_handle, __func__, "the dynamic sparsity is not supported by the async search");
+        return rocsparselt_status_not_implemented;
+    }
+    // nor shares it the widened compressed matrix of a mixed input with the matmuls meanwhile
+    if(rocsparselt_is_mixed_input(descr))
+    {
+        worker->running = false;
+        log_error(_handle, __func__, "the mixed input is not supported by the async search");
+        return rocsparselt_status_not_implemented;
+    }
 
-    // activation
-    hipsparselt_activation_type act_type    = hipsparselt_activation_type::none;
-    float                       act_args[2] = {0.0f, 0.0f};
+    rocsparselt_search_snapshot snapshot;
+    snapshot.pool  = _handle->resource_pool;
+    snapshot.alpha = *reinterpret_cast<const float*>(alpha);
+    snapshot.beta  = *reinterpret_cast<const float*>(beta);
 
-    if(matmul_descr->activation == rocsparselt_matmul_activation_relu)
+    hipError_t hip_status = hipSuccess;
+    auto       copy       = [&](void** dst, const void* src, size_t size) {
+        if(hip_status == hipSuccess)
+            hip_status = snapshot.pool->acquire_scratch(size, dst);
+        if(hip_status == hipSuccess && src != nullptr)
+            hip_status = hipMemcpyAsync(*dst, src, size, hipMemcpyDeviceToDevice, stream);
+    };
+    copy(&snapshot.A, d_A, size_A);
+    copy(&snapshot.B, d_B, size_B);
+    copy(&snapshot.C, d_C, size_C);
+    copy(&snapshot.D, nullptr, size_D);
+    // with a workspace pool, the search draws the whole pool instead
+    if(workspace_size != 0 && _handle->workspace_pool == nullptr)
+        copy(&snapshot.workspace, nullptr, workspace_size);
+    if(hip_status == hipSuccess)
+        hip_status = snapshot.pool->acquire_event(&snapshot.ready);
+    if(hip_status == hipSuccess)
+        hip_status = hipEventRecord(snapshot.ready, stream);
+    if(hip_status != hipSuccess)
     {
-        act_args[0] = matmul_descr->activation_relu_threshold;
-        act_args[1] = matmul_descr->activation_relu_upperbound;
-        if(act_args[0] == 0 && act_args[1] == std::numeric_limits<float>::infinity())
-            act_type = hipsparselt_activation_type::relu;
+        // the copies already queued still write to the buffers
+        (void)hipStreamSynchronize(stream);
+        snapshot.release();
+        worker->running = false;
+        return get_rocsparselt_status_for_hip_status(hip_status);
+    }
+
+    // The search runs on a private stream; the caller keeps using the current config_id
+    // until the best one is stored atomically at the end of the search.
+    worker->thread = std::thread([=]() mutable {
+        rocsparselt_status search_status = rocsparselt_status_success;
+        hipStream_t        search_stream = nullptr;
+        try
+        {
+            THROW_IF_HIP_ERROR(hipSetDevice(_handle->device));
+            THROW_IF_HIP_ERROR(_handle->resource_pool->acquire_stream(&search_stream));
+            THROW_IF_HIP_ERROR(hipStreamWaitEvent(search_stream, snapshot.ready, 0));
+            search_status = rocsparselt_matmul_impl("rocsparselt_matmul_search_async",
+                                                    handle,
+                                                    plan,
+                                                    &snapshot.alpha,
+                                                    snapshot.A,
+                                                    snapshot.B,
+                                                    &snapshot.beta,
+                                                    snapshot.C,
+                                                    snapshot.D,
+                                                    snapshot.workspace,
+                                                    &search_stream,
+                                                    1,
+                                                    true);
+            THROW_IF_HIP_ERROR(hipStreamSynchronize(search_stream));
+        }
+        catch(const rocsparselt_status& e)
+        {
+            search_status = e;
+        }
+        catch(...)
+        {
+            search_status = rocsparselt_status_internal_error;
+        }
+        if(search_stream != nullptr)
+        {
+            // a failed search may leave work on the stream
+            (void)hipStreamSynchronize(search_stream);
+            _handle->resource_pool->release_stream(search_stream);
+        }
         else
-            act_type = hipsparselt_activation_type::clippedrelu;
+            (void)hipEventSynchronize(snapshot.ready);
+        snapshot.release();
+        worker->status  = search_status;
+        worker->running = false;
+    });
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_search_wait(const rocsparselt_handle* handle,
+                                                  rocsparselt_matmul_plan*  plan)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
     }
-    else if(matmul_descr->activation == rocsparselt_matmul_activation_gelu)
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
     {
-        act_type    = hipsparselt_activation_type::gelu;
-        act_args[0] = matmul_descr->activation_gelu_scaling;
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
     }
-    else if(matmul_descr->activation == rocsparselt_matmul_activation_abs)
-        act_type = hipsparselt_activation_type::abs;
-    else if(matmul_descr->activation == rocsparselt_matmul_activation_leakyrelu)
+
+    if(plan == nullptr)
     {
-        act_type    = hipsparselt_activation_type::leakyrelu;
-        act_args[0] = matmul_descr->activation_leakyrelu_alpha;
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
     }
-    else if(matmul_descr->activation == rocsparselt_matmul_activation_sigmoid)
-        act_type = hipsparselt_activation_type::sigmoid;
-    else if(matmul_descr->activation == rocsparselt_matmul_activation_tanh)
+    auto _plan = reinterpret_cast<_rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
     {
-        act_type    = hipsparselt_activation_type::tanh;
-        act_args[0] = matmul_descr->activation_tanh_alpha;
-        act_args[1] = matmul_descr->activation_tanh_beta;
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
     }
 
-    float*  bias_vector = matmul_descr->bias_pointer;
-    int64_t bias_stride = matmul_descr->bias_stride;
+    log_api(_handle, __func__, "plan[in]", *_plan);
+    if(_plan->search_worker == nullptr)
+        return rocsparselt_status_success;
+    return _plan->search_worker->wait();
+}
+
+/********************************************************************************
+ * \brief records the kernels of rocsparselt_matmul on stream into a new graph.
+ * The capture is always ended, also on failure, so the stream is left usable.
+ *******************************************************************************/
+static rocsparselt_status rocsparselt_matmul_capture(const char*                    caller,
+                                                     const rocsparselt_handle*      handle,
+                                                     const rocsparselt_matmul_plan* plan,
+                                                     const void*                    alpha,
+                                                     const void*                    d_A,
+                                                     const void*                    d_B,
+                                                     const void*                    beta,
+                                                     const void*                    d_C,
+                                                     void*                          d_D,
+                                                     void*                          workspace,
+                                                     hipStream_t                    stream,
+                                                     hipGraph_t*                    graph)
+{
+    // Relaxed mode: a first use of a config may still load its code object.
+    RETURN_IF_HIP_ERROR(hipStreamBeginCapture(stream, hipStreamCaptureModeRelaxed));
+
+    rocsparselt_status status   = rocsparselt_status_success;
+    hipGraph_t         captured = nullptr;
+    try
+    {
+        status = rocsparselt_matmul_impl(
+            caller, handle, plan, alpha, d_A, d_B, beta, d_C, d_D, workspace, &stream, 1);
+    }
+    catch(...)
+    {
+        if(hipStreamEndCapture(stream, &captured) == hipSuccess && captured != nullptr)
+            hipGraphDestroy(captured);
+        throw;
+    }
+
+    hipError_t hip_status = hipStreamEndCapture(stream, &captured);
+    if(status == rocsparselt_status_success && hip_status != hipSuccess)
+        status = get_rocsparselt_status_for_hip_status(hip_status);
+
+    if(status != rocsparselt_status_success)
+    {
+        if(captured != nullptr)
+            hipGraphDestroy(captured);
+        return status;
+    }
+    *graph = captured;
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_get_graph(const rocsparselt_handle*      handle,
+                                                const rocsparselt_matmul_plan* plan,
+                                                const void*                    alpha,
+                                                const void*                    d_A,
+                                                const void*                    d_B,
+                                                const void*                    beta,
+                                                const void*                    d_C,
+                                                void*                          d_D,
+                                                void*                          workspace,
+                                                hipStream_t                    stream,
+                                                hipGraph_t*                    graph)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(graph == nullptr)
+    {
+        log_error(_handle, __func__, "graph is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(stream == nullptr)
+    {
+        log_error(_handle, __func__, "the null stream can not be captured");
+        return rocsparselt_status_invalid_value;
+    }
+
+    return rocsparselt_matmul_capture(
+        __func__, handle, plan, alpha, d_A, d_B, beta, d_C, d_D, workspace, stream, graph);
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_graph_launch(const rocsparselt_handle* handle,
+                                                   rocsparselt_matmul_plan*  plan,
+                                                   hipGraphExec_t            graphExec,
+                                                   const void*               alpha,
+                                                   const void*               d_A,
+                                                   const void*               d_B,
+                                                   const void*               beta,
+                                                   const void*               d_C,
+                                                   void*                     d_D,
+                                                   void*                     workspace,
+                                                   hipStream_t               stream)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _plan = reinterpret_cast<_rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, __func__));
+
+    if(graphExec == nullptr)
+    {
+        log_error(_handle, __func__, "graphExec is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(alpha == nullptr || beta == nullptr)
+    {
+        log_error(_handle, __func__, "alpha or beta is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(stream == nullptr)
+    {
+        log_error(_handle, __func__, "the null stream can not be used to update a graph");
+        return rocsparselt_status_invalid_value;
+    }
+
+    // the graph arguments hold scalar scales only
+    if(_plan->matmul_descr->alpha_vector_scaling)
+    {
+        log_error(_handle, __func__, "the vector scaling is not supported by the graph launch");
+        return rocsparselt_status_not_implemented;
+    }
+
+    _rocsparselt_matmul_graph_args args;
+    args.exec      = graphExec;
+    args.config_id = __atomic_load_n(&_plan->alg_selection->config_id, __ATOMIC_ACQUIRE);
+    args.d_A       = d_A;
+    args.d_B       = d_B;
+    args.d_C       = d_C;
+    args.d_D       = d_D;
+    args.workspace = workspace;
+    args.alpha     = *reinterpret_cast<const float*>(alpha);
+    args.beta      = *reinterpret_cast<const float*>(beta);
+
+    if(!(args == _plan->graph_args))
+    {
+        // Re-record the kernels with the new arguments and only patch the node
+        // parameters of graphExec; its topology is kept.
+        hipGraph_t graph = nullptr;
+        RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_matmul_capture(
+            __func__, handle, plan, alpha, d_A, d_B, beta, d_C, d_D, workspace, stream, &graph));
+
+        hipGraphNode_t           error_node = nullptr;
+        hipGraphExecUpdateResult result     = hipGraphExecUpdateError;
+        hipError_t               hip_status
+            = hipGraphExecUpdate(graphExec, graph, &error_node, &result);
+        hipGraphDestroy(graph);
+
+        _plan->graph_args = {};
+        if(hip_status != hipSuccess || result != hipGraphExecUpdateSuccess)
+        {
+            log_error(_handle,
+                      __func__,
+                      "graphExec can not be updated, re-instantiate it from "
+                      "rocsparselt_matmul_get_graph");
+            return rocsparselt_status_invalid_value;
+        }
+        _plan->graph_args = args;
+    }
+
+    log_api(_handle,
+            __func__,
+            "plan[in]",
+            *_plan,
+            "graphExec[in]",
+            graphExec,
+            "stream[in]",
+            stream);
+    RETURN_IF_HIP_ERROR(hipGraphLaunch(graphExec, stream));
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief a copy of matmul_descr with n columns of B, C and D. The leading
+ * dimensions and the batch strides are kept, so the matrices allocated for the N
+ * of the plan also hold the ones of a smaller n.
+ *******************************************************************************/
+static _rocsparselt_matmul_descr* resize_matmul_n(const _rocsparselt_matmul_descr* descr,
+                                                  int64_t                          n)
+{
+    auto resized = new _rocsparselt_matmul_descr(*descr);
+    resized->n   = n;
+    if(resized->op_B == rocsparselt_operation_none)
+        resized->matrix_B->n = n;
+    else
+        resized->matrix_B->m = n;
+    resized->matrix_C->n = n;
+    resized->matrix_D->n = n;
+    return resized;
+}
+
+/********************************************************************************
+ * \brief restrict the configs of a bucket to the ones which run any n of the
+ * bucket in the workspace of the plan. The Stream-K schedules were sized for the
+ * N of the bucket, so a Stream-K config is replaced by the config of its kernel.
+ *******************************************************************************/
+static void restrict_n_bucket_configs(_rocsparselt_matmul_alg_selection* alg_selection,
+                                      size_t                             workspace_size)
+{
+    auto usable = [&](const _rocsparselt_matmul_config& config) {
+        return !config.excluded && config.stream_k_index < 0
+               && config.max_workspace_bytes <= workspace_size;
+    };
+
+    for(int i = 0; i < alg_selection->config_max_id; i++)
+        if(alg_selection->configs[i].stream_k_index >= 0)
+            alg_selection->configs[i].excluded = true;
+
+    const auto& selected = alg_selection->configs[alg_selection->config_id];
+    if(usable(selected))
+        return;
+    int first = -1;
+    for(int i = 0; i < alg_selection->config_max_id; i++)
+    {
+        if(!usable(alg_selection->configs[i]))
+            continue;
+        if(alg_selection->configs[i].index == selected.index)
+        {
+            alg_selection->config_id = i;
+            return;
+        }
+        if(first < 0)
+            first = i;
+    }
+    if(first >= 0)
+        alg_selection->config_id = first;
+}
+
+/********************************************************************************
+ * \brief the algorithm selection of the bucket of n, created on its first use.
+ *******************************************************************************/
+static rocsparselt_status get_n_bucket(const _rocsparselt_handle*          handle,
+                                       const _rocsparselt_matmul_plan*     plan,
+                                       int64_t                             n,
+                                       _rocsparselt_matmul_alg_selection** bucket)
+{
+    auto buckets = plan->n_buckets;
+    int  i       = _rocsparselt_n_buckets::index(n);
+
+    *bucket = buckets->buckets[i].load(std::memory_order_acquire);
+    if(*bucket != nullptr)
+        return rocsparselt_status_success;
+
+    std::lock_guard<std::mutex> lock(buckets->mutex);
+    *bucket = buckets->buckets[i].load(std::memory_order_relaxed);
+    if(*bucket != nullptr)
+        return rocsparselt_status_success;
+
+    auto    descr    = plan->matmul_descr;
+    int64_t bucket_n = std::min<int64_t>(int64_t(1) << i, descr->n);
+
+    std::unique_ptr<_rocsparselt_matmul_alg_selection> alg_selection(
+        new _rocsparselt_matmul_alg_selection(handle));
+    if(bucket_n == descr->n)
+        memcpy(alg_selection.get(), plan->alg_selection, sizeof(_rocsparselt_matmul_alg_selection));
+    else
+    {
+        std::unique_ptr<_rocsparselt_matmul_descr> bucket_descr(resize_matmul_n(descr, bucket_n));
+        RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_matmul_alg_selection_init(
+            reinterpret_cast<const rocsparselt_handle*>(handle),
+            reinterpret_cast<rocsparselt_matmul_alg_selection*>(alg_selection.get()),
+            reinterpret_cast<const rocsparselt_matmul_descr*>(bucket_descr.get()),
+            plan->alg_selection->alg));
+    }
+    // the dense path of the plan is only timed for its own N
+    alg_selection->search_dense   = 0;
+    alg_selection->dense_selected = alg_selection->dense_only;
+
+    auto plan_alg = plan->alg_selection;
+    restrict_n_bucket_configs(alg_selection.get(),
+                              plan_alg->config_max_id == 0
+                                  ? 0
+                                  : plan_alg->configs[plan_alg->config_id].max_workspace_bytes);
+    log_info(handle, __func__, "bucket", bucket_n, "config_id", alg_selection->config_id);
+
+    *bucket = alg_selection.release();
+    buckets->buckets[i].store(*bucket, std::memory_order_release);
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_grouped(const rocsparselt_handle*             handle,
+                                              const rocsparselt_matmul_plan* const* plans,
+                                              int32_t                               groupCount,
+                                              const void*                           alpha,
+                                              const void* const*                    d_A,
+                                              const void* const*                    d_B,
+                                              const void*                           beta,
+                                              const void* const*                    d_C,
+                                              void* const*                          d_D,
+                                              void* const*                          workspaces,
+                                              hipStream_t*                          streams,
+                                              int32_t                               numStreams)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(groupCount < 0)
+    {
+        log_error(_handle, __func__, "groupCount should >= 0");
+        return rocsparselt_status_invalid_value;
+    }
+    if(groupCount == 0)
+        return rocsparselt_status_success;
+
+    if(plans == nullptr || d_A == nullptr || d_B == nullptr || d_C == nullptr || d_D == nullptr)
+    {
+        log_error(_handle, __func__, "plans, d_A, d_B, d_C or d_D is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    if(numStreams < 0 || (streams == nullptr && numStreams > 0))
+    {
+        log_error(_handle, __func__, "streams and numStreams are invalid");
+        return rocsparselt_status_invalid_value;
+    }
+
+    hipStream_t null_stream = nullptr;
+    if(numStreams == 0)
+    {
+        streams    = &null_stream;
+        numStreams = 1;
+    }
+
+    // Validate every group before launching any of them, estimating its cost on the way
+    std::vector<std::pair<double, int32_t>> order(groupCount);
+    for(int32_t g = 0; g < groupCount; g++)
+    {
+        auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plans[g]);
+        if(_plan == nullptr || !_plan->isInit())
+        {
+            log_error(_handle, __func__, "plan of group", g, "is invalid");
+            return rocsparselt_status_invalid_handle;
+        }
+        if(d_A[g] == nullptr || d_B[g] == nullptr || d_C[g] == nullptr || d_D[g] == nullptr)
+        {
+            log_error(_handle, __func__, "a matrix of group", g, "is a NULL pointer");
+            return rocsparselt_status_invalid_pointer;
+        }
+        if(plan_workspace_bytes(_plan) != 0 && (workspaces == nullptr || workspaces[g] == nullptr)
+           && _handle->workspace_pool == nullptr)
+        {
+            log_error(_handle, __func__, "workspace of group", g, "is a NULL pointer");
+            return rocsparselt_status_invalid_value;
+        }
+
+        auto descr = _plan->matmul_descr;
+        order[g]   = {double(descr->m) * descr->n * descr->k * descr->matrix_A->num_batches, g};
+    }
+
+    log_api(_handle,
+            __func__,
+            "groupCount[in]",
+            groupCount,
+            "streams[in]",
+            streams,
+            "numStreams[in]",
+            numStreams);
+
+    // Longest groups first, each on the least loaded stream, so the streams finish together
+    size_t used_streams = std::min<size_t>(numStreams, groupCount);
+    std::stable_sort(order.begin(), order.end(), [](const auto& a, const auto& b) {
+        return a.first > b.first;
+    });
+    std::vector<double> load(used_streams, 0.0);
+
+    // the events of the first plan fork and join the streams
+    auto first_plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plans[0]);
+    auto events     = first_plan->stream_events->acquire();
+    RETURN_IF_HIP_ERROR(events->fork(streams, used_streams));
+
+    rocsparselt_status status = rocsparselt_status_success;
+    for(size_t i = 0; i < order.size() && status == rocsparselt_status_success; i++)
+    {
+        int32_t g = order[i].second;
+        size_t  s = std::min_element(load.begin(), load.end()) - load.begin();
+        load[s] += order[i].first;
+
+        status = rocsparselt_matmul_impl(__func__,
+                                         handle,
+                                         plans[g],
+                                         alpha,
+                                         d_A[g],
+                                         d_B[g],
+                                         beta,
+                                         d_C[g],
+                                         d_D[g],
+                                         workspaces ? workspaces[g] : nullptr,
+                                         &streams[s],
+                                         1);
+    }
+
+    // join also after a failure, the groups already queued must still finish first
+    RETURN_IF_HIP_ERROR(events->join(streams, used_streams));
+    return status;
+}
+
+// the offset of the partial D of the other shards split along k in the workspace of the first
+static size_t shard_partials_offset(const _rocsparselt_matmul_plan* plan)
+{
+    return (plan_workspace_bytes(plan) + 255) / 256 * 256;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status
+    rocsparselt_matmul_sharded_get_workspace(const rocsparselt_handle* const*      handles,
+                                             const rocsparselt_matmul_plan* const* plans,
+                                             int32_t                               numShards,
+                                             rocsparselt_shard_split               split,
+                                             size_t*                               workspaceSizes)
+{
+    if(numShards <= 0)
+    {
+        hipsparselt_cerr << "numShards should > 0" << std::endl;
+        return rocsparselt_status_invalid_value;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(
+        rocsparselt_check_shards(handles, plans, numShards, split, __func__));
+
+    auto first = reinterpret_cast<const _rocsparselt_handle*>(handles[0]);
+    if(workspaceSizes == nullptr)
+    {
+        log_error(first, __func__, "workspaceSizes is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    for(int32_t i = 0; i < numShards; i++)
+        workspaceSizes[i]
+            = plan_workspace_bytes(reinterpret_cast<const _rocsparselt_matmul_plan*>(plans[i]));
+    if(split == rocsparselt_shard_split_k && numShards > 1)
+    {
+        auto first_plan   = reinterpret_cast<const _rocsparselt_matmul_plan*>(plans[0]);
+        workspaceSizes[0] = shard_partials_offset(first_plan)
+                            + (numShards - 1)
+                                  * rocsparselt_shard_partial_bytes(first_plan->matmul_descr);
+    }
+    log_api(first, __func__, "numShards[in]", numShards, "workspaceSizes[0]", workspaceSizes[0]);
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_sharded(const rocsparselt_handle* const*      handles,
+                                              const rocsparselt_matmul_plan* const* plans,
+                                              int32_t                               numShards,
+                                              rocsparselt_shard_split               split,
+                                              const void*                           alpha,
+                                              const void* const*                    d_A,
+                                              const void* const*                    d_B,
+                                              const void*                           beta,
+                                              const void* const*                    d_C,
+                                              void* const*                          d_D,
+                                              void* const*                          workspaces,
+                                              hipStream_t*                          streams)
+{
+    if(numShards < 0)
+    {
+        hipsparselt_cerr << "numShards should >= 0" << std::endl;
+        return rocsparselt_status_invalid_value;
+    }
+    if(numShards == 0)
+        return rocsparselt_status_success;
+    RETURN_IF_ROCSPARSELT_ERROR(
+        rocsparselt_check_shards(handles, plans, numShards, split, __func__));
+
+    auto first      = reinterpret_cast<const _rocsparselt_handle*>(handles[0]);
+    auto first_plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plans[0]);
+    if(alpha == nullptr || beta == nullptr || d_A == nullptr || d_B == nullptr || d_C == nullptr
+       || d_D == nullptr || streams == nullptr)
+    {
+        log_error(first, __func__, "alpha, beta, d_A, d_B, d_C, d_D or streams is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    // the partial D of the other shards split along k are summed in the workspace of the first
+    bool reduce = split == rocsparselt_shard_split_k && numShards > 1;
+    for(int32_t i = 0; i < numShards; i++)
+    {
+        auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handles[i]);
+        auto _plan   = reinterpret_cast<const _rocsparselt_matmul_plan*>(plans[i]);
+        if(d_A[i] == nullptr || d_B[i] == nullptr || d_C[i] == nullptr || d_D[i] == nullptr)
+        {
+            log_error(_handle, __func__, "a matrix of shard", i, "is a NULL pointer");
+            return rocsparselt_status_invalid_pointer;
+        }
+        bool has_workspace = workspaces != nullptr && workspaces[i] != nullptr;
+        if(i == 0 && reduce && !has_workspace)
+        {
+            log_error(_handle, __func__, "workspace of the first shard is a NULL pointer");
+            return rocsparselt_status_invalid_value;
+        }
+        if(plan_workspace_bytes(_plan) != 0 && !has_workspace && _handle->workspace_pool == nullptr)
+        {
+            log_error(_handle, __func__, "workspace of shard", i, "is a NULL pointer");
+            return rocsparselt_status_invalid_value;
+        }
+    }
+
+    log_api(first,
+            __func__,
+            "numShards[in]",
+            numShards,
+            "split[in]",
+            split,
+            "streams[in]",
+            streams);
+
+    // every shard on its device, the partial D of the other shards split along k are copied to
+    // the first device as soon as they are done, while the last shards still run
+    const float                      zero     = 0.0f;
+    const _rocsparselt_matmul_descr* descr    = first_plan->matmul_descr;
+    size_t                           bytes    = rocsparselt_dense_matrix_bytes(descr->matrix_D);
+    char*                            partials = nullptr;
+    if(reduce)
+        partials = static_cast<char*>(workspaces[0]) + shard_partials_offset(first_plan);
 
-    (*prob) = new RocsparseltContractionProblem<Ti, To, Tc>(matmul_descr->handle,
-                                                            opA,
-                                                            opB,
-                                                            matmul_descr->m,
-                                                            matmul_descr->n,
-                                                            matmul_descr->k,
+    std::vector<std::unique_ptr<rocsparselt_pooled_event>> copied;
+
+    rocsparselt_device_scope device;
+    for(int32_t i = 0; i < numShards; i++)
+    {
+        auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handles[i]);
+        RETURN_IF_HIP_ERROR(device.set(_handle));
+        RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_matmul_impl(__func__,
+                                                            handles[i],
+                                                            plans[i],
                                                             alpha,
-                                                            a,
-                                                            nullptr,
-                                                            lda,
-                                                            batch_stride_a,
-                                                            offset_a,
-                                                            b,
-                                                            nullptr,
-                                                            ldb,
-                                                            batch_stride_b,
-                                                            offset_b,
-                                                            beta,
-                                                            c,
-                                                            nullptr,
-                                                            ldc,
-                                                            batch_stride_c,
-                                                            offset_c,
-                                                            d,
-                                                            nullptr,
-                                                            ldd,
-                                                            batch_stride_d,
-                                                            offset_d,
-                                                            num_batches_a,
-                                                            strided_batch,
-                                                            matmul_descr->is_sparse_a,
-                                                            metadata,
-                                                            act_type,
-                                                            act_args[0],
-                                                            act_args[1],
-                                                            bias_vector,
-                                                            bias_stride,
-                                                            matmul_descr->bias_type,
-                                                            workspace,
-                                                            workspaceSize,
-                                                            streams,
-                                                            numStreams);
+                                                            d_A[i],
+                                                            d_B[i],
+                                                            reduce && i > 0 ? &zero : beta,
+                                                            d_C[i],
+                                                            d_D[i],
+                                                            workspaces ? workspaces[i] : nullptr,
+                                                            &streams[i],
+                                                            1));
+        if(!reduce || i == 0)
+            continue;
+
+        char* partial = partials + (i - 1) * rocsparselt_shard_partial_bytes(descr);
+        RETURN_IF_HIP_ERROR(hipMemcpyPeerAsync(
+            partial, first->device, d_D[i], _handle->device, bytes, streams[i]));
+        copied.push_back(std::make_unique<rocsparselt_pooled_event>(_handle->resource_pool));
+        RETURN_IF_HIP_ERROR(copied.back()->acquire());
+        RETURN_IF_HIP_ERROR(hipEventRecord(*copied.back(), streams[i]));
+    }
+    if(!reduce)
+        return rocsparselt_status_success;
+
+    // the first device sums the partial D in the order of the shards, each one once copied
+    RETURN_IF_HIP_ERROR(device.set(first));
+    for(int32_t i = 1; i < numShards; i++)
+    {
+        char* partial = partials + (i - 1) * rocsparselt_shard_partial_bytes(descr);
+        RETURN_IF_HIP_ERROR(hipStreamWaitEvent(streams[0], *copied[i - 1], 0));
+        RETURN_IF_ROCSPARSELT_ERROR(
+            rocsparselt_shard_reduce(first, descr, d_D[0], partial, streams[0]));
+    }
+    rocsparselt_pooled_event reduced(first->resource_pool);
+    RETURN_IF_HIP_ERROR(reduced.acquire());
+    RETURN_IF_HIP_ERROR(hipEventRecord(reduced, streams[0]));
+
+    // the sum is copied back to the D of every other shard
+    for(int32_t i = 1; i < numShards; i++)
+    {
+        auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handles[i]);
+        RETURN_IF_HIP_ERROR(device.set(_handle));
+        RETURN_IF_HIP_ERROR(hipStreamWaitEvent(streams[i], reduced, 0));
+        RETURN_IF_HIP_ERROR(hipMemcpyPeerAsync(
+            d_D[i], _handle->device, d_D[0], first->device, bytes, streams[i]));
+    }
+    return rocsparselt_status_success;
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_pointer_array(const rocsparselt_handle*      handle,
+                                                    const rocsparselt_matmul_plan* plan,
+                                                    const void*                    alpha,
+                                                    const void*                    d_compressed,
+                                                    const void* const*             d_dense,
+                                                    const void*                    beta,
+                                                    const void* const*             d_C,
+                                                    void* const*                   d_D,
+                                                    void*                          workspace,
+                                                    hipStream_t*                   streams,
+                                                    int32_t                        numStreams)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(d_dense == nullptr || d_C == nullptr || d_D == nullptr)
+    {
+        log_error(_handle, __func__, "d_dense, d_C or d_D is a NULL pointer");
+        return rocsparselt_status_invalid_pointer;
+    }
+
+    // every batch of the dense matrices has its own pointer
+    auto    descr       = _plan->matmul_descr;
+    // the batches run one by one, each would overwrite the sums of the others
+    if(descr->bias_grad_pointer != nullptr)
+    {
+        log_error(_handle, __func__, "the bias gradient is not supported by the pointer arrays");
+        return rocsparselt_status_not_implemented;
+    }
+    int64_t num_batches = descr->matrix_A->num_batches;
+    for(int64_t i = 0; i < num_batches; i++)
+    {
+        if(d_dense[i] == nullptr || d_C[i] == nullptr || d_D[i] == nullptr)
+        {
+            log_error(_handle, __func__, "a matrix of batch", i, "is a NULL pointer");
+            return rocsparselt_status_invalid_pointer;
+        }
+    }
+
+    const void* d_A = descr->is_sparse_a ? d_compressed : d_dense[0];
+    const void* d_B = descr->is_sparse_a ? d_dense[0] : d_compressed;
+
+    _rocsparselt_batch_pointers pointers{d_dense, d_C, d_D};
+    return rocsparselt_matmul_impl(__func__,
+                                   handle,
+                                   plan,
+                                   alpha,
+                                   d_A,
+                                   d_B,
+                                   beta,
+                                   d_C[0],
+                                   d_D[0],
+                                   workspace,
+                                   streams,
+                                   numStreams,
+                                   false,
+                                   &pointers);
+}
+
+/********************************************************************************
+ * \brief
+ *******************************************************************************/
+rocsparselt_status rocsparselt_matmul_dynamic_n(const rocsparselt_handle*      handle,
+                                                const rocsparselt_matmul_plan* plan,
+                                                int64_t                        n,
+                                                const void*                    alpha,
+                                                const void*                    d_A,
+                                                const void*                    d_B,
+                                                const void*                    beta,
+                                                const void*                    d_C,
+                                                void*                          d_D,
+                                                void*                          workspace,
+                                                hipStream_t*                   streams,
+                                                int32_t                        numStreams)
+{
+    // Check if handle is valid
+    if(handle == nullptr)
+    {
+        hipsparselt_cerr << "handle is a NULL pointer" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _handle = reinterpret_cast<const _rocsparselt_handle*>(handle);
+    if(!_handle->isInit())
+    {
+        hipsparselt_cerr << "handle did not initialized or already destroyed" << std::endl;
+        return rocsparselt_status_invalid_handle;
+    }
+
+    if(plan == nullptr)
+    {
+        log_error(_handle, __func__, "plan is a NULL pointer");
+        return rocsparselt_status_invalid_handle;
+    }
+    auto _plan = reinterpret_cast<const _rocsparselt_matmul_plan*>(plan);
+    if(!_plan->isInit())
+    {
+        log_error(_handle, __func__, "plan did not initialized or already destroyed");
+        return rocsparselt_status_invalid_handle;
+    }
+    RETURN_IF_ROCSPARSELT_ERROR(rocsparselt_check_unpadded(_handle, _plan, __func__));
+
+    // the compressed matrix, and so the plan, fix the N of a structured B
+    auto descr = _plan->matmul_descr;
+    if(!descr->is_sparse_a)
+    {
+        log_error(_handle, __func__, "n can only change when A is the structured matrix");
+        return rocsparselt_status_not_implemented;
+    }
+    if(n <= 0 || n > descr->n)
+    {
+        log_error(_handle, __func__, "n", n, "is not in [1, N of the plan]", descr->n);
+        return rocsparselt_status_invalid_size;
+    }
+    if(n == descr->n)
+        return rocsparselt_matmul_impl(__func__,
+                                       handle,
+                                       plan,
+                                       alpha,
+                                       d_A,
+                                       d_B,
+                                       beta,
+                                       d_C,
+                                       d_D,
+                                       workspace,
+                                       streams,
+                                       numStreams);
+
+    try
+    {
+        _rocsparselt_matmul_alg_selection* bucket;
+        RETURN_IF_ROCSPARSELT_ERROR(get_n_bucket(_handle, _plan, n, &bucket));
+
+        // the plan of this call borrows the events and the stats of the plan, its backend
+        // objects are resolved on every call since they depend on n
+        _rocsparselt_matmul_plan call_plan(_handle);
+        call_plan.matmul_descr  = resize_matmul_n(descr, n);
+        call_plan.alg_selection = bucket;
+        call_plan.stream_events = _plan->stream_events;
+        call_plan.stats         = _plan->stats;
+
+        rocsparselt_status status;
+        try
+        {
+            status = rocsparselt_matmul_impl(__func__,
+                                             handle,
+                                             reinterpret_cast<rocsparselt_matmul_plan*>(&call_plan),
+                                             alpha,
+                                             d_A,
+                                             d_B,
+                                             beta,
+                                             d_C,
+                                             d_D,
+                                             workspace,
+                                             streams,
+                                             numStreams);
+        }
+        catch(...)
+        {
+            call_plan.stream_events = nullptr;
+            call_plan.stats         = nullptr;
+            throw;
+        }
+        call_plan.stream_events = nullptr;
+        call_plan.stats         = nullptr;
+        return status;
+    }
+    catch(const rocsparselt_status& status)
+    {
+        log_info(_handle, __func__, "status", status);
+        return status;
+    }
+}
+#ifdef __cplusplus
+}
+#endif
+
+template <typename Ti, typename To, typename Tc>
+rocsparselt_status ConstructRocSparseLtProblem(const char*                                 caller,
+                                               RocsparseltContractionProblem<Ti, To, Tc>*  prob,
+                                               const _rocsparselt_matmul_descr* matmul_descr,
+                                               const Tc*                        alpha,
+                                               const Tc*                        beta,
+                                               const Ti*                        a,
+                                               const Ti*                        b,
+                                               const To*                        c,
+                                               To*                              d,
+                                               bool                             strided_batch,
+                                               void*                            workspace,
+                                               size_t                           workspaceSize,
+                                               hipStream_t*                     streams,
+                                               int32_t                          numStreams)
+{
+    static const Tc _one = static_cast<Tc>(1);
+
+    // with vector scaling, alpha and beta are device vectors of m scales: the kernels run
+    // with scalar scales of one and the epilogue of the config scales the rows of D
+    const float* alpha_vector = nullptr;
+    const float* beta_vector  = nullptr;
+    if(matmul_descr->alpha_vector_scaling)
+    {
+        alpha_vector = reinterpret_cast<const float*>(alpha);
+        alpha        = nullptr;
+        if(matmul_descr->beta_vector_scaling && beta != nullptr)
+        {
+            beta_vector = reinterpret_cast<const float*>(beta);
+            beta        = nullptr;
+        }
+    }
+
+    if(alpha == nullptr)
+        alpha = &_one;
+
+    if(beta == nullptr)
+        beta = &_one;
+
+    rocsparselt_operation opA = matmul_descr->op_A;
+    rocsparselt_operation opB = matmul_descr->op_B;
+
+    int64_t c_num_cols; 
+    int64_t metadata_offset;
+    const unsigned char* metadata;
+       
+    // matrix A
+    int64_t lda            = matmul_descr->matrix_A->ld;
+    int64_t offset_a       = 0;
+    int64_t batch_stride_a = matmul_descr->matrix_A->batch_stride;
+    int     num_batches_a  = matmul_descr->matrix_A->num_batches;
+    int64_t c_k            = matmul_descr->matrix_A->c_k;
+    int64_t c_ld           = matmul_descr->matrix_A->c_ld;
+
+    if(matmul_descr->is_sparse_a)
+    {
+
+        batch_stride_a = (batch_stride_a == 0 ? 0
+                         : (opA == rocsparselt_operation_none) ? c_ld * c_k
+                                                               : c_ld * matmul_descr->matrix_A->n);
+        lda            = c_ld;
+
+        c_num_cols      = (opA == rocsparselt_operation_none ? c_k : matmul_descr->matrix_A->n);
+        metadata_offset = rocsparselt_metadata_offset_in_compressed_matrix(c_num_cols, c_ld, (batch_stride_a == 0 ? 1 : num_batches_a), rocsparselt_matmul_input_type(matmul_descr));
+        metadata = (a == nullptr) ? nullptr : reinterpret_cast<const unsigned char*>(a) + metadata_offset;
+    }
+
+    // matrix B
+    int64_t ldb            = matmul_descr->matrix_B->ld;
+    int64_t offset_b       = 0;
+    int64_t batch_stride_b = 0;
+    batch_stride_b         = matmul_descr->matrix_B->batch_stride;
+    if(!matmul_descr->is_sparse_a)
+    {
+        c_k            = matmul_descr->matrix_B->c_k;
+        c_ld           = matmul_descr->matrix_B->c_ld;
+        batch_stride_b = (batch_stride_b == 0 ? 0
+                         : (opB == rocsparselt_operation_none) ? c_ld * matmul_descr->matrix_B->n
+                                                               : c_ld * c_k);
+        ldb            = c_ld;
+        c_num_cols      = (opB == rocsparselt_operation_none ? matmul_descr->matrix_B->n : c_k);
+        metadata_offset = rocsparselt_metadata_offset_in_compressed_matrix(c_num_cols, c_ld, (batch_stride_b == 0 ? 1 : num_batches_a), rocsparselt_matmul_input_type(matmul_descr));
+        metadata = (b == nullptr) ? nullptr : reinterpret_cast<const unsigned char*>(b) + metadata_offset;
+    }
+
+    // matrix C
+    int64_t ldc            = matmul_descr->matrix_C->ld;
+    int64_t offset_c       = 0;
+    int64_t batch_stride_c = 0;
+    batch_stride_c         = matmul_descr->matrix_C->batch_stride;
+
+    // matrix D
+    int64_t ldd            = matmul_descr->matrix_D->ld;
+    int64_t offset_d       = 0;
+    int64_t batch_stride_d = 0;
+    batch_stride_d         = matmul_descr->matrix_D->batch_stride;
+
+    // activation
+    hipsparselt_activation_type act_type    = hipsparselt_activation_type::none;
+    float                       act_args[2] = {0.0f, 0.0f};
+
+    if(matmul_descr->activation == rocsparselt_matmul_activation_relu)
+    {
+        act_args[0] = matmul_descr->activation_relu_threshold;
+        act_args[1] = matmul_descr->activation_relu_upperbound;
+        if(act_args[0] == 0 && act_args[1] == std::numeric_limits<float>::infinity())
+            act_type = hipsparselt_activation_type::relu;
+        else
+            act_type = hipsparselt_activation_type::clippedrelu;
+    }
+    else if(matmul_descr->activation == rocsparselt_matmul_activation_gelu)
+    {
+        act_type    = hipsparselt_activation_type::gelu;
+        act_args[0] = matmul_descr->activation_gelu_scaling;
+    }
+    else if(matmul_descr->activation == rocsparselt_matmul_activation_abs)
+        act_type = hipsparselt_activation_type::abs;
+    else if(matmul_descr->activation == rocsparselt_matmul_activation_leakyrelu)
+    {
+        act_type    = hipsparselt_activation_type::leakyrelu;
+        act_args[0] = matmul_descr->activation_leakyrelu_alpha;
+    }
+    else if(matmul_descr->activation == rocsparselt_matmul_activation_sigmoid)
+        act_type = hipsparselt_activation_type::sigmoid;
+    else if(matmul_descr->activation == rocsparselt_matmul_activation_tanh)
+    {
+        act_type    = hipsparselt_activation_type::tanh;
+        act_args[0] = matmul_descr->activation_tanh_alpha;
+        act_args[1] = matmul_descr->activation_tanh_beta;
+    }
+    else if(matmul_descr->activation == rocsparselt_matmul_activation_silu)
+        act_type = hipsparselt_activation_type::silu;
+    else if(matmul_descr->activation == rocsparselt_matmul_activation_clamp)
+    {
+        act_type    = hipsparselt_activation_type::clamp;
+        act_args[0] = matmul_descr->activation_clamp_min;
+        act_args[1] = matmul_descr->activation_clamp_max;
+    }
+
+    float*  bias_vector = matmul_descr->bias_pointer;
+    int64_t bias_stride = matmul_descr->bias_stride;
+
+    // The problem only holds scalars and pointers, so it is built in place in the storage
+    // provided by the caller instead of on the heap.
+    static_assert(std::is_trivially_destructible<RocsparseltContractionProblem<Ti, To, Tc>>{},
+                  "RocsparseltContractionProblem must be trivially destructible");
+    new(prob) RocsparseltContractionProblem<Ti, To, Tc>(matmul_descr->handle,
+                                                        opA,
+                                                        opB,
+                                                        matmul_descr->m,
+                                                        matmul_descr->n,
+                                                        matmul_descr->k,
+                                                        alpha,
+                                                        a,
+                                                        nullptr,
+                                                        lda,
+                                                        batch_stride_a,
+                                                        offset_a,
+                                                        b,
+                                                        nullptr,
+                                                        ldb,
+                                                        batch_stride_b,
+                                                        offset_b,
+                                                        beta,
+                                                        c,
+                                                        nullptr,
+                                                        ldc,
+                                                        batch_stride_c,
+                                                        offset_c,
+                                                        d,
+                                                        nullptr,
+                                                        ldd,
+                                                        batch_stride_d,
+                                                        offset_d,
+                                                        num_batches_a,
+                                                        strided_batch,
+                                                        matmul_descr->is_sparse_a,
+                                                        metadata,
+                                                        act_type,
+                                                        act_args[0],
+                                                        act_args[1],
+                                                        bias_vector,
+                                                        bias_stride,
+                                                        matmul_descr->bias_type,
+                                                        workspace,
+                                                        workspaceSize,
+                                                        streams,
+                                                        numStreams);
+    prob->alpha_vector          = alpha_vector;
+    prob->beta_vector           = beta_vector;
+    prob->d_scale               = matmul_descr->d_scale;
+    prob->d_saturate            = matmul_descr->d_saturate != 0;
+    prob->amax_d                = matmul_descr->amax_d_pointer;
+    prob->residual              = reinterpret_cast<const To*>(matmul_descr->residual_pointer);
+    prob->batch_stride_residual = matmul_descr->residual_stride;
+    prob->gate                  = reinterpret_cast<const To*>(matmul_descr->gate_pointer);
+    prob->batch_stride_gate     = matmul_descr->gate_stride;
+    prob->bias_grad             = matmul_descr->bias_grad_pointer;
+    prob->cu_count              = matmul_descr->cu_count;
     return rocsparselt_status_success;
 }
 
 #define GENERATE_DEFINITIONS(Ti, To, Tc)                                 \
     template rocsparselt_status ConstructRocSparseLtProblem<Ti, To, Tc>( \
         const char*,                                                     \
-        RocsparseltContractionProblem<Ti, To, Tc>**,                     \
+        RocsparseltContractionProblem<Ti, To, Tc>*,                      \
         const _rocsparselt_matmul_descr*,                                \
         const Tc*,                                                       \
         const Tc*,                                                       \
@@ -475,5 +1920,12 @@ rocsparselt_status ConstructRocSparseLtProblem(const char*
 GENERATE_DEFINITIONS(__half, __half, float)
 GENERATE_DEFINITIONS(hip_bfloat16, hip_bfloat16, float)
 GENERATE_DEFINITIONS(int8_t, int8_t, float)
+GENERATE_DEFINITIONS(int8_t, int32_t, float)
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, __half, float)
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, hip_bfloat16, float)
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, float, float)
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, __half, float)
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, hip_bfloat16, float)
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, float, float)
 
 #undef GENERATE_DEFINITIONS
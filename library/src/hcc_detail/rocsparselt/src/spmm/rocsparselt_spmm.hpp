@@ -30,31 +30,210 @@
 
 //#include "gemm_tensile.hpp"
 
+#include "definitions.h"
 #include "handle.h"
 #include "hipsparselt_ostream.hpp"
+#include "rocsparselt_spmm_dense.hpp"
+#include "rocsparselt_spmm_utils.hpp"
+#include "status.h"
 #include "utility.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
 #if BUILD_WITH_TENSILE
 #include "tensile_host.hpp"
 #else
 #include "kernel_launcher.hpp"
 #endif
 
+/********************************************************************************
+ * \brief _rocsparselt_batch_pointers holds the arrays of per batch pointers of
+ * rocsparselt_matmul_pointer_array(): the dense operand, A or B, C and D of each
+ * batch. The compressed matrix keeps its batch stride.
+ *******************************************************************************/
+struct _rocsparselt_batch_pointers
+{
+    const void* const* dense;
+    const void* const* C;
+    void* const*       D;
+};
+
+/********************************************************************************
+ * \brief spmm_batch_range restricts problem to count batches from first on, with
+ * the pointers of the operands and of the epilogue inputs moved to its first one.
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+RocsparseltContractionProblem<Ti, To, Tc>
+    spmm_batch_range(const _rocsparselt_matmul_plan*                  plan,
+                     const RocsparseltContractionProblem<Ti, To, Tc>& problem,
+                     size_t                                           first,
+                     size_t                                           count)
+{
+    // metadata of a compressed batch takes a quarter of its values, in bytes
+    const size_t metadata_stride
+        = (problem.sparseA ? problem.batch_stride_a : problem.batch_stride_b) / 4;
+    const size_t bias_bytes = rocsparselt_datatype_bytes(plan->matmul_descr->bias_type);
+
+    auto part        = problem;
+    part.batch_count = count;
+    part.A           = problem.A + first * problem.batch_stride_a;
+    part.B           = problem.B + first * problem.batch_stride_b;
+    part.C           = problem.C + first * problem.batch_stride_c;
+    part.D           = problem.D + first * problem.batch_stride_d;
+    if(problem.metadata != nullptr)
+        part.metadata = problem.metadata + first * metadata_stride;
+    if(problem.bias_vector != nullptr)
+        part.bias_vector = reinterpret_cast<const char*>(problem.bias_vector)
+                           + first * problem.bias_stride * bias_bytes;
+    if(problem.residual != nullptr)
+        part.residual = problem.residual + first * problem.batch_stride_residual;
+    if(problem.gate != nullptr)
+        part.gate = problem.gate + first * problem.batch_stride_gate;
+    return part;
+}
+
+/********************************************************************************
+ * \brief spmm_batches_on_streams splits a batched problem into contiguous ranges
+ * of batches and runs each range on its own stream. The other streams wait for
+ * the work already queued on streams[0] and streams[0] waits for them at the end,
+ * so the call stays asynchronous with respect to the host.
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+rocsparselt_status
+    spmm_batches_on_streams(const _rocsparselt_matmul_plan*                  plan,
+                            const RocsparseltContractionProblem<Ti, To, Tc>& problem,
+                            int*                                             config_id,
+                            const int                                        config_max_id)
+{
+    const size_t num_streams = std::min<size_t>(problem.numStreams, problem.batch_count);
+    const size_t chunk       = (problem.batch_count + num_streams - 1) / num_streams;
+    const size_t num_parts   = (problem.batch_count + chunk - 1) / chunk;
+
+    hipStream_t* streams = problem.streams;
+    auto         events  = plan->stream_events->acquire();
+    RETURN_IF_HIP_ERROR(events->fork(streams, num_parts));
+
+    rocsparselt_status status = rocsparselt_status_success;
+    for(size_t i = 0; i < num_parts && status == rocsparselt_status_success; i++)
+    {
+        size_t first = i * chunk;
+        auto   part
+            = spmm_batch_range(plan, problem, first, std::min(chunk, problem.batch_count - first));
+        part.streams    = &streams[i];
+        part.numStreams = 1;
+
+        // the resolved solution is cached for the common range size only, a shorter
+        // last range would otherwise evict it on every call
+        status = runContractionProblem<Ti, To, Tc>(
+            part,
+            &plan->alg_selection->configs[0],
+            config_id,
+            config_max_id,
+            0,
+            false,
+            nullptr,
+            part.batch_count == chunk ? plan->solution_cache : nullptr);
+    }
+
+    // join also after a failure, the ranges already queued must still finish first
+    RETURN_IF_HIP_ERROR(events->join(streams, num_parts));
+    return status;
+}
+
+/********************************************************************************
+ * \brief spmm_pointer_array_batches runs every batch of problem as its own problem,
+ * on the dense operand, C and D of pointers and the compressed matrix at its batch
+ * stride. The batches are dealt round robin over the streams unless they share
+ * the workspace of a config, the streams are forked and joined as for
+ * spmm_batches_on_streams.
+ *******************************************************************************/
+template <typename Ti, typename To, typename Tc>
+rocsparselt_status
+    spmm_pointer_array_batches(const _rocsparselt_matmul_plan*                  plan,
+                               const RocsparseltContractionProblem<Ti, To, Tc>& problem,
+                               const _rocsparselt_batch_pointers&               pointers,
+                               bool                                             dense,
+                               int*                                             config_id,
+                               const int                                        config_max_id)
+{
+    for(size_t i = 0; i < problem.batch_count; i++)
+    {
+        if(!isAligned(pointers.dense[i], sizeof(Ti)) || !isAligned(pointers.C[i], sizeof(To))
+           || !isAligned(pointers.D[i], sizeof(To)))
+        {
+            hipsparselt_cerr << "memmory of batch " << i << " is not aligned" << std::endl;
+            return rocsparselt_status_invalid_size;
+        }
+    }
+
+    hipStream_t  null_stream = nullptr;
+    hipStream_t* streams     = problem.numStreams > 0 ? problem.streams : &null_stream;
+    const size_t num_streams
+        = problem.workspaceSize == 0
+              ? std::min<size_t>(std::max<size_t>(problem.numStreams, 1), problem.batch_count)
+              : 1;
+
+    _rocsparselt_stream_events::lease events;
+    if(num_streams > 1)
+    {
+        events = plan->stream_events->acquire();
+        RETURN_IF_HIP_ERROR(events->fork(streams, num_streams));
+    }
+
+    rocsparselt_status status = rocsparselt_status_success;
+    for(size_t i = 0; i < problem.batch_count && status == rocsparselt_status_success; i++)
+    {
+        auto part = spmm_batch_range(plan, problem, i, 1);
+        if(problem.sparseA)
+            part.B = reinterpret_cast<const Ti*>(pointers.dense[i]);
+        else
+            part.A = reinterpret_cast<const Ti*>(pointers.dense[i]);
+        part.C          = reinterpret_cast<const To*>(pointers.C[i]);
+        part.D          = reinterpret_cast<To*>(pointers.D[i]);
+        part.streams    = &streams[i % num_streams];
+        part.numStreams = 1;
+
+        if(dense)
+            status = get_rocsparselt_status_for_hip_status(
+                rocsparselt_spmm_dense(part, streams[i % num_streams]));
+        else
+            status = runContractionProblem<Ti, To, Tc>(part,
+                                                       &plan->alg_selection->configs[0],
+                                                       config_id,
+                                                       config_max_id,
+                                                       0,
+                                                       false,
+                                                       nullptr,
+                                                       plan->solution_cache);
+    }
+
+    // join also after a failure, the batches already queued must still finish first
+    if(num_streams > 1)
+        RETURN_IF_HIP_ERROR(events->join(streams, num_streams));
+    return status;
+}
+
 template <typename Ti, typename To = Ti, typename Tc = To>
-rocsparselt_status spmm_typecasting(const char*                     caller,
-                                    const _rocsparselt_handle*      handle,
-                                    const _rocsparselt_matmul_plan* plan,
-                                    const void*                     alpha,
-                                    const void*                     beta,
-                                    const void*                     a,
-                                    const void*                     b,
-                                    const void*                     c,
-                                    void*                           d,
-                                    void*                           workspace,
-                                    hipStream_t*                    streams,
-                                    int32_t                         numStreams,
-                                    int*                            config_id,
-                                    const int                       config_max_id,
-                                    const int                       search_iterations)
+rocsparselt_status spmm_typecasting(const char*                        caller,
+                                    const _rocsparselt_handle*         handle,
+                                    const _rocsparselt_matmul_plan*    plan,
+                                    const void*                        alpha,
+                                    const void*                        beta,
+                                    const void*                        a,
+                                    const void*                        b,
+                                    const void*                        c,
+                                    void*                              d,
+                                    void*                              workspace,
+                                    size_t                             workspace_size,
+                                    hipStream_t*                       streams,
+                                    int32_t                            numStreams,
+                                    int*                               config_id,
+                                    const int                          config_max_id,
+                                    const int                          search_iterations,
+                                    rocsparselt_matmul_search_result*  search_results,
+                                    const _rocsparselt_batch_pointers* batch_pointers)
 {
     // check alignment of pointers before casting
     if(!isAligned(a, sizeof(Ti)) || !isAligned(b, sizeof(Ti)) || !isAligned(c, sizeof(Ti))
@@ -64,13 +243,32 @@ rocsparselt_status spmm_typecasting(const char*                     caller,
         return rocsparselt_status_invalid_size;
     }
 
-    RocsparseltContractionProblem<Ti, To, Tc>* problem;
+    // the scales of A and B are folded into the alpha the kernels get by value
+    const _rocsparselt_matmul_descr* descr        = plan->matmul_descr;
+    const Tc*                        alpha_scaled = reinterpret_cast<const Tc*>(alpha);
+    Tc                               alpha_value;
+    if(descr->scale_a != 1.0f || descr->scale_b != 1.0f)
+    {
+        if(descr->alpha_vector_scaling)
+        {
+            log_error(handle, caller, "the scales of A and B need a scalar alpha");
+            return rocsparselt_status_not_implemented;
+        }
+        if(alpha_scaled != nullptr)
+        {
+            alpha_value  = *alpha_scaled * static_cast<Tc>(descr->scale_a * descr->scale_b);
+            alpha_scaled = &alpha_value;
+        }
+    }
+
+    RocsparseltContractionProblemStorage<Ti, To, Tc> storage;
+    RocsparseltContractionProblem<Ti, To, Tc>*       problem = storage.get();
 
     auto status = ConstructRocSparseLtProblem(
         caller,
-        &problem,
-        plan->matmul_descr,
-        reinterpret_cast<const Tc*>(alpha),
+        problem,
+        descr,
+        alpha_scaled,
         reinterpret_cast<const Tc*>(beta),
         reinterpret_cast<const Ti*>(a),
         reinterpret_cast<const Ti*>(b),
@@ -78,49 +276,113 @@ rocsparselt_status spmm_typecasting(const char*                     caller,
         (To*)d,
         true,
         workspace,
-        plan->alg_selection->config_max_id == 0
-            ? 0
-            : plan->alg_selection->configs[plan->alg_selection->config_id].max_workspace_bytes,
+        workspace_size,
         streams,
         numStreams);
 
     if(status != rocsparselt_status_success)
         return status;
 
+    _rocsparselt_matmul_alg_selection* alg    = plan->alg_selection;
+    hipStream_t                        stream = numStreams > 0 ? streams[0] : nullptr;
+    bool                               dense  = rocsparselt_spmm_dense_supported(*problem);
+
+    // without SMFMAC instructions the dense path is all there is, a search just runs it
+    if(alg->dense_only && !dense)
+    {
+        log_error(handle, caller, "no epilogue without SMFMAC instructions");
+        return rocsparselt_status_not_implemented;
+    }
+
+    // the last search found the dense path faster than the best config
+    bool dense_selected = dense && __atomic_load_n(&alg->dense_selected, __ATOMIC_ACQUIRE);
+    if(batch_pointers != nullptr)
+        return spmm_pointer_array_batches<Ti, To, Tc>(
+            plan, *problem, *batch_pointers, dense_selected, config_id, config_max_id);
+    if((!search_iterations || alg->dense_only) && dense_selected)
+        return get_rocsparselt_status_for_hip_status(rocsparselt_spmm_dense(*problem, stream));
+
+    // Batches are spread over the streams only when the launches do not share a workspace.
+    if(!search_iterations && numStreams > 1 && problem->batch_count > 1
+       && problem->workspaceSize == 0)
+        return spmm_batches_on_streams<Ti, To, Tc>(plan, *problem, config_id, config_max_id);
+
     status = runContractionProblem<Ti, To, Tc>(*problem,
-#if BUILD_WITH_TENSILE
-                                               &plan->alg_selection->configs[0],
-#endif
+                                               &alg->configs[0],
                                                config_id,
                                                config_max_id,
-                                               search_iterations);
+                                               search_iterations,
+                                               alg->search_flush_cache != 0,
+                                               search_results,
+                                               plan->solution_cache);
 
-    delete problem;
+    // The dense path is timed the same way as the configs and the faster of the two is kept,
+    // so enabling the sparsity never costs more than the dense path.
+    if(search_iterations && alg->search_dense && status == rocsparselt_status_success)
+    {
+        int   selected = 0;
+        float dense_ms = 0.0f;
+        if(dense)
+        {
+            status = get_rocsparselt_status_for_hip_status(rocsparselt_spmm_dense_time(
+                *problem, stream, search_iterations, alg->search_flush_cache != 0, &dense_ms));
+            if(status != rocsparselt_status_success)
+                return status;
+            selected = search_results != nullptr && search_results[0].config_id >= 0
+                       && dense_ms < search_results[0].mean_ms;
+            log_info(handle, caller, "dense path mean_ms", dense_ms, "selected", selected);
+        }
+        __atomic_store_n(&alg->dense_selected, selected, __ATOMIC_RELEASE);
+    }
 
     return status;
 }
 
-inline rocsparselt_status rocsparselt_spmm_template(const char*                     caller,
-                                                    const _rocsparselt_handle*      handle,
-                                                    const _rocsparselt_matmul_plan* plan,
-                                                    const void*                     alpha,
-                                                    const void*                     beta,
-                                                    const void*                     a,
-                                                    const void*                     b,
-                                                    const void*                     c,
-                                                    void*                           d,
-                                                    void*                           workspace,
-                                                    hipStream_t*                    streams,
-                                                    int32_t                         numStreams,
-                                                    int*                            config_id,
-                                                    const int                       config_max_id,
-                                                    const int search_iterations)
+/********************************************************************************
+ * \brief spmm_fp8_typecasting dispatches an FP8 or BF8 problem on its output type,
+ * the products are accumulated in FP32 and written as fp16, bf16 or fp32.
+ *******************************************************************************/
+template <typename Ti, typename... Args>
+rocsparselt_status spmm_fp8_typecasting(rocsparselt_datatype d_type, Args&&... args)
+{
+    switch(d_type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return spmm_typecasting<Ti, __half, float>(std::forward<Args>(args)...);
+    case rocsparselt_datatype_bf16_r:
+        return spmm_typecasting<Ti, hip_bfloat16, float>(std::forward<Args>(args)...);
+    case rocsparselt_datatype_f32_r:
+        return spmm_typecasting<Ti, float, float>(std::forward<Args>(args)...);
+    default:
+        return rocsparselt_status_not_implemented;
+    }
+}
+
+inline rocsparselt_status
+    rocsparselt_spmm_template(const char*                        caller,
+                              const _rocsparselt_handle*         handle,
+                              const _rocsparselt_matmul_plan*    plan,
+                              const void*                        alpha,
+                              const void*                        beta,
+                              const void*                        a,
+                              const void*                        b,
+                              const void*                        c,
+                              void*                              d,
+                              void*                              workspace,
+                              size_t                             workspace_size,
+                              hipStream_t*                       streams,
+                              int32_t                            numStreams,
+                              int*                               config_id,
+                              const int                          config_max_id,
+                              const int                          search_iterations,
+                              rocsparselt_matmul_search_result*  search_results,
+                              const _rocsparselt_batch_pointers* batch_pointers)
 {
     rocsparselt_status rs_status = rocsparselt_status_not_implemented;
 
-#define EX_TYPECASTING_PARM                                                                   \
-    caller, handle, plan, alpha, beta, a, b, c, d, workspace, streams, numStreams, config_id, \
-        config_max_id, search_iterations
+#define EX_TYPECASTING_PARM                                                                  \
+    caller, handle, plan, alpha, beta, a, b, c, d, workspace, workspace_size, streams,       \
+        numStreams, config_id, config_max_id, search_iterations, search_results, batch_pointers
 
     rocsparselt_datatype     a_type       = plan->matmul_descr->matrix_A->type;
     rocsparselt_datatype     b_type       = plan->matmul_descr->matrix_B->type;
@@ -128,6 +390,10 @@ inline rocsparselt_status rocsparselt_spmm_template(const char*
     rocsparselt_datatype     d_type       = plan->matmul_descr->matrix_D->type;
     rocsparselt_compute_type compute_type = plan->matmul_descr->compute_type;
 
+    // the compressed matrix of a mixed input matmul was widened to the type of the dense one
+    if(rocsparselt_is_mixed_input(plan->matmul_descr))
+        a_type = b_type = rocsparselt_matmul_input_type(plan->matmul_descr);
+
     if(a_type == rocsparselt_datatype_f16_r && b_type == rocsparselt_datatype_f16_r)
     {
         if(c_type == rocsparselt_datatype_f16_r && d_type == rocsparselt_datatype_f16_r)
@@ -165,6 +431,23 @@ inline rocsparselt_status rocsparselt_spmm_template(const char*
                 rs_status = spmm_typecasting<int8_t, __half, float>(EX_TYPECASTING_PARM);
             }
         }
+        else if(c_type == rocsparselt_datatype_i32_r && d_type == rocsparselt_datatype_i32_r)
+        {
+            if(compute_type == rocsparselt_compute_i32)
+            {
+                rs_status = spmm_typecasting<int8_t, int32_t, float>(EX_TYPECASTING_PARM);
+            }
+        }
+    }
+    else if(a_type == rocsparselt_datatype_f8_r && b_type == rocsparselt_datatype_f8_r)
+    {
+        if(c_type == d_type && compute_type == rocsparselt_compute_f32)
+            rs_status = spmm_fp8_typecasting<__hip_fp8_e4m3_fnuz>(d_type, EX_TYPECASTING_PARM);
+    }
+    else if(a_type == rocsparselt_datatype_bf8_r && b_type == rocsparselt_datatype_bf8_r)
+    {
+        if(c_type == d_type && compute_type == rocsparselt_compute_f32)
+            rs_status = spmm_fp8_typecasting<__hip_fp8_e5m2_fnuz>(d_type, EX_TYPECASTING_PARM);
     }
     else
     {
@@ -0,0 +1,274 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "rocsparselt_spmm_dense.hpp"
+#include "definitions.h"
+#include "handle.h"
+#include "resource_pool.hpp"
+#include "search_tuner.hpp"
+#include "utility.hpp"
+
+#include <hip/hip_fp8.h>
+#include <hip/hip_runtime.h>
+#include <type_traits>
+
+template <typename To>
+__device__ inline To dense_saturate(float x)
+{
+    if constexpr(std::is_same<To, int8_t>{})
+        return static_cast<To>(fminf(fmaxf(rintf(x), -128.f), 127.f));
+    else if constexpr(std::is_same<To, int32_t>{})
+        return static_cast<To>(fminf(fmaxf(rintf(x), -2147483648.f), 2147483520.f));
+    else
+        return static_cast<To>(x);
+}
+
+// Each thread computes TT1J outputs of a row of the sparse matrix, the rows of the
+// compressed matrix and of the metadata. The 4 values and the metadata byte of a group
+// of 8 k elements give the k indices of the dense operand to multiply them with, so the
+// pruned zeros are skipped. A wavefront shares its columns, the reads of the dense
+// operand are uniform.
+template <typename Ti, typename To, typename Tc, int SG0I, int SG1J, int TT1J>
+__global__ __launch_bounds__(SG0I* SG1J) void
+    spmm_dense_kernel(const Ti*            sparse,
+                      const unsigned char* metadata,
+                      const Ti*            dense,
+                      const To*            C,
+                      To*                  D,
+                      int64_t              rows,
+                      int64_t              cols,
+                      int64_t              k,
+                      int64_t              s_stride1,
+                      int64_t              s_stride2,
+                      int64_t              s_batch_stride,
+                      int64_t              m_stride1,
+                      int64_t              m_batch_stride,
+                      int64_t              d_stride1,
+                      int64_t              d_stride2,
+                      int64_t              d_batch_stride,
+                      int64_t              c_stride1,
+                      int64_t              c_stride2,
+                      int64_t              c_batch_stride,
+                      int64_t              o_stride1,
+                      int64_t              o_stride2,
+                      int64_t              o_batch_stride,
+                      Tc                   alpha,
+                      Tc                   beta)
+{
+    constexpr int metadata_tiles_y = 8;
+    constexpr int tiles_y          = 4;
+
+    unsigned int serial = hc_get_workitem_id(0);
+    int64_t      row    = int64_t(SG0I) * hc_get_group_id(0) + serial % SG0I;
+    int64_t      col    = (int64_t(SG1J) * hc_get_group_id(1) + serial / SG0I) * TT1J;
+    int64_t      batch  = hc_get_group_id(2);
+    if(row >= rows || col >= cols)
+        return;
+
+    sparse += batch * s_batch_stride + row * s_stride1;
+    metadata += batch * m_batch_stride + row * m_stride1;
+    dense += batch * d_batch_stride + col * d_stride1;
+
+    Tc acc[TT1J];
+#pragma unroll
+    for(int j = 0; j < TT1J; j++)
+        acc[j] = static_cast<Tc>(0);
+
+    for(int64_t g = 0; g < k / metadata_tiles_y; g++)
+    {
+        unsigned char md = metadata[g];
+        Tc            values[tiles_y];
+        int64_t       k_pos[tiles_y];
+#pragma unroll
+        for(int midx = 0; midx < tiles_y; midx++)
+        {
+            values[midx] = static_cast<Tc>(sparse[(g * tiles_y + midx) * s_stride2]);
+            k_pos[midx]  = g * metadata_tiles_y + (midx >> 1) * tiles_y
+                          + ((md >> (midx << 1)) & 0x03);
+        }
+
+#pragma unroll
+        for(int j = 0; j < TT1J; j++)
+        {
+            if(col + j >= cols)
+                break;
+#pragma unroll
+            for(int midx = 0; midx < tiles_y; midx++)
+                acc[j] += values[midx]
+                          * static_cast<Tc>(dense[j * d_stride1 + k_pos[midx] * d_stride2]);
+        }
+    }
+
+    C += batch * c_batch_stride + row * c_stride1 + col * c_stride2;
+    D += batch * o_batch_stride + row * o_stride1 + col * o_stride2;
+#pragma unroll
+    for(int j = 0; j < TT1J; j++)
+    {
+        if(col + j >= cols)
+            break;
+        Tc value = alpha * acc[j];
+        if(beta != static_cast<Tc>(0))
+            value += beta * static_cast<Tc>(C[j * c_stride2]);
+        D[j * o_stride2] = dense_saturate<To>(value);
+    }
+}
+
+template <typename Ti, typename To, typename Tc>
+hipError_t rocsparselt_spmm_dense(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                  hipStream_t                                      stream)
+{
+    constexpr int SG0I = 64;
+    constexpr int SG1J = 4;
+    constexpr int TT1J = 4;
+
+    // The kernel walks the rows of the sparse matrix, m of sparse A or n of sparse B, and
+    // the columns of the dense operand in the k-contiguous view of the compress kernels.
+    // The compressed matrix has k / 2 columns, its metadata k / 8 bytes per row.
+    bool      sparse_a  = prob.sparseA;
+    auto      sparse_op = sparse_a ? prob.trans_a : prob.trans_b;
+    auto      dense_op  = sparse_a ? prob.trans_b : prob.trans_a;
+    bool      sparse_t  = sparse_op == rocsparselt_operation_transpose;
+    bool      dense_t   = dense_op == rocsparselt_operation_transpose;
+    int64_t   rows      = sparse_a ? prob.m : prob.n;
+    int64_t   cols      = sparse_a ? prob.n : prob.m;
+    size_t    s_row     = sparse_a ? prob.row_stride_a : prob.row_stride_b;
+    size_t    s_col     = sparse_a ? prob.col_stride_a : prob.col_stride_b;
+    size_t    d_row     = sparse_a ? prob.row_stride_b : prob.row_stride_a;
+    size_t    d_col     = sparse_a ? prob.col_stride_b : prob.col_stride_a;
+    size_t    s_batch   = sparse_a ? prob.batch_stride_a : prob.batch_stride_b;
+    size_t    d_batch   = sparse_a ? prob.batch_stride_b : prob.batch_stride_a;
+    int64_t   s_stride1 = (sparse_a != sparse_t) ? s_row : s_col;
+    int64_t   s_stride2 = (sparse_a != sparse_t) ? s_col : s_row;
+    int64_t   d_stride1 = (sparse_a != dense_t) ? d_col : d_row;
+    int64_t   d_stride2 = (sparse_a != dense_t) ? d_row : d_col;
+    int64_t   c_stride1 = sparse_a ? prob.row_stride_c : prob.col_stride_c;
+    int64_t   c_stride2 = sparse_a ? prob.col_stride_c : prob.row_stride_c;
+    int64_t   o_stride1 = sparse_a ? prob.row_stride_d : prob.col_stride_d;
+    int64_t   o_stride2 = sparse_a ? prob.col_stride_d : prob.row_stride_d;
+    const Ti* sparse    = sparse_a ? prob.A : prob.B;
+    const Ti* dense     = sparse_a ? prob.B : prob.A;
+
+    size_t elements = prob.m * prob.n * prob.batch_count;
+    if(!elements)
+        return hipSuccess;
+
+    constexpr int MT1J    = SG1J * TT1J;
+    int64_t       block_x = rows / SG0I + (rows % SG0I > 0 ? 1 : 0);
+    int64_t       block_y = cols / MT1J + (cols % MT1J > 0 ? 1 : 0);
+    hipLaunchKernelGGL((spmm_dense_kernel<Ti, To, Tc, SG0I, SG1J, TT1J>),
+                       dim3(block_x, block_y, prob.batch_count),
+                       dim3(SG0I * SG1J),
+                       0 /*dynamic shared*/,
+                       stream,
+                       sparse,
+                       prob.metadata,
+                       dense,
+                       prob.C,
+                       prob.D,
+                       rows,
+                       cols,
+                       int64_t(prob.k),
+                       s_stride1,
+                       s_stride2,
+                       int64_t(s_batch),
+                       int64_t(prob.k / 8),
+                       int64_t(s_batch / 4),
+                       d_stride1,
+                       d_stride2,
+                       int64_t(d_batch),
+                       c_stride1,
+                       c_stride2,
+                       int64_t(prob.batch_stride_c),
+                       o_stride1,
+                       o_stride2,
+                       int64_t(prob.batch_stride_d),
+                       prob.k ? *prob.alpha : static_cast<Tc>(0),
+                       *prob.beta);
+    return hipGetLastError();
+}
+
+template <typename Ti, typename To, typename Tc>
+hipError_t
+    rocsparselt_spmm_dense_time(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                                hipStream_t                                      stream,
+                                int                                              search_iterations,
+                                bool                                             flush_cache,
+                                float*                                           mean_ms)
+{
+    rocsparselt_search_cache_flush flush(prob.handle);
+    rocsparselt_pooled_event       startEvent(prob.handle->resource_pool, true);
+    rocsparselt_pooled_event       stopEvent(prob.handle->resource_pool, true);
+
+    hipError_t err = flush.init(flush_cache);
+    if(err == hipSuccess)
+        err = startEvent.acquire();
+    if(err == hipSuccess)
+        err = stopEvent.acquire();
+
+    // the first run is a warm up, as for the configs
+    if(err == hipSuccess)
+        err = rocsparselt_spmm_dense(prob, stream);
+
+    float sum_ms = 0.0f;
+    for(int i = 0; i < search_iterations && err == hipSuccess; i++)
+    {
+        float ms = 0.0f;
+        err      = flush(stream);
+        if(err == hipSuccess)
+            err = hipEventRecord(startEvent, stream);
+        if(err == hipSuccess)
+            err = rocsparselt_spmm_dense(prob, stream);
+        if(err == hipSuccess)
+            err = hipEventRecord(stopEvent, stream);
+        if(err == hipSuccess)
+            err = hipEventSynchronize(stopEvent);
+        if(err == hipSuccess)
+            err = hipEventElapsedTime(&ms, startEvent, stopEvent);
+        sum_ms += ms;
+    }
+    *mean_ms = search_iterations > 0 ? sum_ms / search_iterations : 0.0f;
+    return err;
+}
+
+#define GENERATE_DEFINITIONS(Ti, To, Tc)                                         \
+    template hipError_t rocsparselt_spmm_dense<Ti, To, Tc>(                      \
+        const RocsparseltContractionProblem<Ti, To, Tc>&, hipStream_t);          \
+    template hipError_t rocsparselt_spmm_dense_time<Ti, To, Tc>(                 \
+        const RocsparseltContractionProblem<Ti, To, Tc>&, hipStream_t, int, bool, float*);
+
+GENERATE_DEFINITIONS(__half, __half, float)
+GENERATE_DEFINITIONS(hip_bfloat16, hip_bfloat16, float)
+GENERATE_DEFINITIONS(int8_t, int8_t, float)
+GENERATE_DEFINITIONS(int8_t, __half, float)
+GENERATE_DEFINITIONS(int8_t, int32_t, float)
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, __half, float)
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, hip_bfloat16, float)
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, float, float)
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, __half, float)
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, hip_bfloat16, float)
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, float, float)
+
+#undef GENERATE_DEFINITIONS
@@ -28,8 +28,10 @@
 
 #include "tensile_host.hpp"
 #include "activation.hpp"
+#include "config_heuristic.hpp"
 #include "definitions.h"
 #include "rocsparselt_spmm_utils.hpp"
+#include "search_tuner.hpp"
 #include "status.h"
 #include "utility.hpp"
 /*****************************************************************************
@@ -53,6 +55,7 @@
 #include <iomanip>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <string>
 #include <type_traits>
 #include <vector>
@@ -109,6 +112,19 @@ namespace
         using tensile_type = int8_t;
     };
 
+    // the FNUZ formats of gfx942: e4m3 -> Float8, e5m2 -> BFloat8
+    template <>
+    struct rocsparselt_to_tensile_type<__hip_fp8_e4m3_fnuz>
+    {
+        using tensile_type = Tensile::Float8;
+    };
+
+    template <>
+    struct rocsparselt_to_tensile_type<__hip_fp8_e5m2_fnuz>
+    {
+        using tensile_type = Tensile::BFloat8;
+    };
+
     /********************************************************************
      * Variable template to map a rocsparselt type into a Tensile::DataType *
      ********************************************************************/
@@ -119,12 +135,21 @@ namespace
     template <>
     constexpr auto tensile_datatype<int8_t> = Tensile::DataType::Int8;
 
+    template <>
+    constexpr auto tensile_datatype<int32_t> = Tensile::DataType::Int32;
+
     template <>
     constexpr auto tensile_datatype<__half> = Tensile::DataType::Half;
 
     template <>
     constexpr auto tensile_datatype<hip_bfloat16> = Tensile::DataType::BFloat16;
 
+    template <>
+    constexpr auto tensile_datatype<__hip_fp8_e4m3_fnuz> = Tensile::DataType::Float8;
+
+    template <>
+    constexpr auto tensile_datatype<__hip_fp8_e5m2_fnuz> = Tensile::DataType::BFloat8;
+
     template <>
     constexpr auto tensile_datatype<float> = Tensile::DataType::Float;
 
@@ -161,6 +186,12 @@ namespace
             return Tensile::DataType::BFloat16;
         case rocsparselt_datatype_i8_r:
             return Tensile::DataType::Int8;
+        case rocsparselt_datatype_i32_r:
+            return Tensile::DataType::Int32;
+        case rocsparselt_datatype_f8_r:
+            return Tensile::DataType::Float8;
+        case rocsparselt_datatype_bf8_r:
+            return Tensile::DataType::BFloat8;
         default:
             assert(!"hipblasltDatatype_to_tensile_type: non-supported type");
             return Tensile::DataType::None;
@@ -363,9 +394,12 @@ namespace
 
     /***************************************************************
      * Construct the inputs to a Tensile ContractionProblemGemm        *
+     * The inputs are written into an existing object, so that the  *
+     * storage of activationArgs can be reused across calls.         *
      ***************************************************************/
     template <typename Ti, typename To, typename Tc>
-    auto GetTensileInputs(const RocsparseltContractionProblem<Ti, To, Tc>& prob)
+    auto& GetTensileInputs(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                           Tensile::ContractionInputs&                      inputs)
     {
         // Tensile types corresponding to Ti, To, Tc
         using Tensile_Ti          = typename rocsparselt_to_tensile_type<Ti>::tensile_type;
@@ -381,9 +415,6 @@ namespace
                           && std::is_standard_layout<To>{} && std::is_standard_layout<Tensile_To>{},
                       "Tensile or rocsparselt types are not standard layout types");
 
-        // Structure describing the inputs (A, B, C, D, alpha, beta)
-        Tensile::ContractionInputs inputs;
-
         // Set the A, B, C, D matrices pointers in Tensile
         inputs.a = reinterpret_cast<const void*>(prob.A);
         inputs.b = reinterpret_cast<const void*>(prob.B);
@@ -413,6 +444,7 @@ namespace
         inputs.metadata = reinterpret_cast<const unsigned char*>(prob.metadata);
 
         // push 2 activation arguments
+        inputs.activationArgs.clear();
         inputs.activationArgs.push_back(static_cast<Tensile_Talpha_beta>(prob.act_arg0));
         inputs.activationArgs.push_back(static_cast<Tensile_Talpha_beta>(prob.act_arg1));
 
@@ -426,14 +458,16 @@ namespace
     {
         // The library object
         std::shared_ptr<Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>> m_library;
-        std::shared_ptr<hipDeviceProp_t> m_deviceProp;
 
         // The adapter object. mutable is used to allow adapters to be modified
-        // even when they are stored in a const vector which is immutable in size
+        // even when they are stored in a const vector which is immutable in size.
+        // The device property is kept next to its adapter since several devices
+        // may be initialized concurrently.
         struct adapter_s
         {
             mutable std::atomic<Tensile::hip::SolutionAdapter*> adapter{nullptr};
             mutable std::mutex                                  mutex;
+            mutable std::shared_ptr<hipDeviceProp_t>            deviceProp;
         };
 
         // Each device contains an adapter
@@ -477,11 +511,6 @@ namespace
             return m_library;
         }
 
-        auto& get_device_property() const
-        {
-            return m_deviceProp;
-        }
-
         auto& get_adapters() const
         {
             return m_adapters;
@@ -499,6 +528,26 @@ namespace
 #endif
         }
 
+        // Whether a file matches the wildcard pattern
+        static bool TestPattern(std::string pattern)
+        {
+#ifdef WIN32
+            std::replace(pattern.begin(), pattern.end(), '/', '\\');
+            WIN32_FIND_DATAA finddata;
+            HANDLE           hfind = FindFirstFileA(pattern.c_str(), &finddata);
+            if(hfind == INVALID_HANDLE_VALUE)
+                return false;
+            FindClose(hfind);
+            return true;
+#else
+            glob_t glob_result{};
+            bool   match = glob(pattern.c_str(), GLOB_NOSORT, nullptr, &glob_result) == 0
+                         && glob_result.gl_pathc != 0;
+            globfree(&glob_result);
+            return match;
+#endif
+        }
+
         /*********************************************************************
          * Initialize adapter and library according to environment variables *
          * and default paths based on librocsparselt.so location and GPU         *
@@ -543,8 +592,15 @@ namespace
                     path += "/" + processor;
             }
 
+#ifdef HIPSPARSELT_TENSILE_LAZY_LOAD
+            // the code object of a problem type is loaded with its solutions, on the first
+            // problem of that type, only the source kernels are loaded up front
+            adapter.initializeLazyLoading(processor, path);
+            auto dir = path + "/Kernels.so-*" + processor + "*.hsaco";
+#else
             // only load modules for the current architecture
             auto dir = path + "/*" + processor + "*co";
+#endif
 
             bool no_match = false;
 #ifdef WIN32
@@ -589,6 +645,12 @@ namespace
                 // clang-format on
             }
             globfree(&glob_result);
+#endif
+#ifdef HIPSPARSELT_TENSILE_LAZY_LOAD
+            // a library of assembly kernels only has no source kernels to load, its code
+            // objects are loaded on demand, so it is enough that they exist
+            if(no_match && TestPattern(path + "/*" + processor + "*co"))
+                no_match = false;
 #endif
             if(no_match)
             {
@@ -605,10 +667,18 @@ namespace
             // initialize library. This ensures that only one thread initializes library,
             // and other threads trying to initialize library wait for it to complete.
             static int once = [&] {
+#ifdef HIPSPARSELT_TENSILE_LAZY_LOAD
+                // the master library only indexes the per problem type libraries, which
+                // Tensile loads on the first problem matching their type, transpose,
+                // sparse matrix and architecture
+                path += "/TensileLibrary_lazy_" + processor;
+#else
+                path += "/TensileLibrary";
+#endif
 #ifdef TENSILE_YAML
-                path += "/TensileLibrary.yaml";
+                path += ".yaml";
 #else
-                path += "/TensileLibrary.dat";
+                path += ".dat";
 #endif
                 if(!TestPath(path))
                 {
@@ -641,7 +711,7 @@ namespace
             hipDeviceProp_t prop;
             THROW_IF_HIP_ERROR(hipGetDeviceProperties(&prop, deviceId));
 
-            m_deviceProp = std::make_shared<hipDeviceProp_t>(prop);
+            m_adapters.at(deviceId).deviceProp = std::make_shared<hipDeviceProp_t>(prop);
         }
     };
 
@@ -688,7 +758,7 @@ namespace
         if(library)
             *library = host.get_library();
         if(deviceProp)
-            *deviceProp = host.get_device_property();
+            *deviceProp = a.deviceProp;
 
         return *adapter;
     }
@@ -727,6 +797,97 @@ namespace
             hipsparselt_cerr << msg << std::endl;
     }
 
+    /**************************************************************************
+     * The hardware the solutions are selected for: the device with only the  *
+     * CUs of the problem when it is restricted to some of them.              *
+     **************************************************************************/
+    std::shared_ptr<Tensile::Hardware> GetHardware(const hipDeviceProp_t& prop, int cu_count)
+    {
+        if(cu_count <= 0 || cu_count >= prop.multiProcessorCount)
+            return Tensile::hip::GetDevice(prop);
+        hipDeviceProp_t masked     = prop;
+        masked.multiProcessorCount = cu_count;
+        return Tensile::hip::GetDevice(masked);
+    }
+
+} // namespace
+
+/******************************************************************************
+ * _rocsparselt_solution_cache keeps the Tensile problem and solution resolved *
+ * for a plan. A published entry is never modified; it is replaced when the   *
+ * selected config or one of the values the problem depends on changes.       *
+ ******************************************************************************/
+struct _rocsparselt_solution_cache
+{
+    struct key_t
+    {
+        int    config_index;
+        int    use_bias;
+        double alpha;
+        double beta;
+        bool   c_equals_d;
+        bool   has_bias;
+        size_t workspace_size;
+        size_t batch_count;
+
+        bool operator==(const key_t& rhs) const
+        {
+            return config_index == rhs.config_index && use_bias == rhs.use_bias
+                   && alpha == rhs.alpha && beta == rhs.beta && c_equals_d == rhs.c_equals_d
+                   && has_bias == rhs.has_bias && workspace_size == rhs.workspace_size
+                   && batch_count == rhs.batch_count;
+        }
+    };
+
+    struct entry_t
+    {
+        key_t                                         key;
+        Tensile::ContractionProblemGemm               problem;
+        std::shared_ptr<Tensile::ContractionSolution> solution;
+        std::shared_ptr<Tensile::Hardware>            hardware;
+        Tensile::hip::SolutionAdapter*                adapter;
+    };
+
+    std::shared_ptr<const entry_t> get() const
+    {
+        return std::atomic_load(&entry);
+    }
+
+    void set(std::shared_ptr<const entry_t> e)
+    {
+        std::atomic_store(&entry, std::move(e));
+    }
+
+private:
+    std::shared_ptr<const entry_t> entry;
+};
+
+_rocsparselt_solution_cache* rocsparselt_solution_cache_create()
+{
+    return new _rocsparselt_solution_cache;
+}
+
+void rocsparselt_solution_cache_destroy(_rocsparselt_solution_cache* cache)
+{
+    delete cache;
+}
+
+namespace
+{
+    template <typename Ti, typename To, typename Tc>
+    _rocsparselt_solution_cache::key_t
+        MakeSolutionCacheKey(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
+                             const _rocsparselt_matmul_config&                config)
+    {
+        return {config.index,
+                config.use_bias,
+                prob.k ? static_cast<double>(*prob.alpha) : 0.0,
+                static_cast<double>(*prob.beta),
+                prob.C == prob.D,
+                prob.bias_vector != nullptr,
+                prob.workspaceSize,
+                prob.batch_count};
+    }
 } // namespace
 
 /******************************************************************************
@@ -737,44 +898,72 @@ template <typename Ti, typename To, typename Tc>
 rocsparselt_status runContractionProblem(const RocsparseltContractionProblem<Ti, To, Tc>& prob,
                                          _rocsparselt_matmul_config*                      configs,
                                          int*                                             config_id,
-                                         const int config_max_id,
-                                         const int search_iterations)
+                                         const int                         config_max_id,
+                                         const int                         search_iterations,
+                                         const bool                        search_flush_cache,
+                                         rocsparselt_matmul_search_result* search_results,
+                                         _rocsparselt_solution_cache*      solution_cache)
 {
     rocsparselt_status                            status = rocsparselt_status_internal_error;
     std::shared_ptr<Tensile::ContractionSolution> solution;
 
     try
     {
-        std::shared_ptr<Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>> library;
-        std::shared_ptr<hipDeviceProp_t>                                                 deviceProp;
-        std::shared_ptr<Tensile::Hardware>                                               hardware;
-
-        auto& adapter = get_library_and_adapter(&library, &deviceProp, prob.handle->device);
-
-        hardware = Tensile::hip::GetDevice(*deviceProp);
-
         if(!config_max_id || configs == nullptr)
         {
             hipsparselt_internal_ostream msg;
             print_once(msg << "\nhipsparselt_error: No Tensile solution found for " << prob);
             status = rocsparselt_status_not_implemented;
         }
-        else
+        else if(prob.alpha_vector || prob.beta_vector)
         {
-            auto tensile_prob = ConstructTensileProblem(prob, configs[*config_id].use_bias);
-
-            auto tensile_inputs = GetTensileInputs(prob);
+            // the Tensile kernels are not built with ScaleAlphaVec
+            hipsparselt_cerr << "The vector scaling is not supported by the Tensile backend"
+                             << std::endl;
+            status = rocsparselt_status_not_implemented;
+        }
+        else if(prob.d_scale != 1.f || prob.d_saturate || prob.amax_d || prob.residual
+                || prob.gate || prob.bias_grad)
+        {
+            // nor with ScaleD, an amax output, a gate, a second addend or a reduction of D
+            hipsparselt_cerr << "The scale and saturation of D, amax(D), the gate, the residual "
+                                "and the bias gradient are not supported by the Tensile backend"
+                             << std::endl;
+            status = rocsparselt_status_not_implemented;
+        }
+        else if(prob.act_type == hipsparselt_activation_type::silu
+                || prob.act_type == hipsparselt_activation_type::clamp)
+        {
+            // the activation args reach the kernels, but none of them is built with these types
+            hipsparselt_cerr << "The " << hipsparselt_activation_type_to_string(prob.act_type)
+                             << " activation is not supported by the Tensile backend" << std::endl;
+            status = rocsparselt_status_not_implemented;
+        }
+        else if(!search_iterations)
+        {
+            if(configs[*config_id].max_workspace_bytes > prob.workspaceSize
+               || (configs[*config_id].max_workspace_bytes > 0 && prob.workspace == nullptr))
+            {
+                hipsparselt_cerr << "config " << *config_id << " need extra workspace "
+                                 << configs[*config_id].max_workspace_bytes << " bytes - skip."
+                                 << std::endl;
+                return rocsparselt_status_internal_error;
+            }
 
-            if(!search_iterations)
+            // Reuse the problem and solution resolved by a previous call when nothing the
+            // Tensile problem depends on has changed, only the inputs have to be rebuilt.
+            auto key   = MakeSolutionCacheKey(prob, configs[*config_id]);
+            auto entry = solution_cache ? solution_cache->get() : nullptr;
+            if(!entry || !(entry->key == key))
             {
-                if(configs[*config_id].max_workspace_bytes > prob.workspaceSize
-                   || (configs[*config_id].max_workspace_bytes > 0 && prob.workspace == nullptr))
-                {
-                    hipsparselt_cerr << "config " << *config_id << " need extra workspace "
-                                     << configs[*config_id].max_workspace_bytes << " bytes - skip."
-                                     << std::endl;
-                    return rocsparselt_status_internal_error;
-                }
+                std::shared_ptr<Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>>
+                                                 library;
+                std::shared_ptr<hipDeviceProp_t> deviceProp;
+
+                auto& adapter
+                    = get_library_and_adapter(&library, &deviceProp, prob.handle->device);
+                auto hardware     = GetHardware(*deviceProp, prob.cu_count);
+                auto tensile_prob = ConstructTensileProblem(prob, configs[*config_id].use_bias);
 
                 solution = library->getSolutionByIndex(
                     tensile_prob, *hardware, configs[*config_id].index);
@@ -785,72 +974,104 @@ rocsparselt_status runContractionProblem(const RocsparseltContractionProblem<Ti,
                     return rocsparselt_status_not_implemented;
                 }
 
-                RETURN_IF_HIP_ERROR(
-                    adapter.launchKernels(solution->solve(tensile_prob, tensile_inputs, *hardware),
-                                          prob.streams[0],
-                                          nullptr,
-                                          nullptr));
+                entry = std::shared_ptr<const _rocsparselt_solution_cache::entry_t>(
+                    new _rocsparselt_solution_cache::entry_t{
+                        key, std::move(tensile_prob), solution, hardware, &adapter});
+                if(solution_cache)
+                    solution_cache->set(entry);
             }
-            else
+            solution = entry->solution;
+
+            // Structure describing the inputs (A, B, C, D, alpha, beta), kept per thread
+            // so that building it does not allocate after the first call
+            thread_local Tensile::ContractionInputs tensile_inputs;
+            GetTensileInputs(prob, tensile_inputs);
+
+            RETURN_IF_HIP_ERROR(entry->adapter->launchKernels(
+                solution->solve(entry->problem, tensile_inputs, *entry->hardware),
+                prob.streams[0],
+                nullptr,
+                nullptr));
+
+            status = rocsparselt_status_success;
+        }
+        else
+        {
+            std::shared_ptr<Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>>
+                                             library;
+            std::shared_ptr<hipDeviceProp_t> deviceProp;
+
+            auto& adapter  = get_library_and_adapter(&library, &deviceProp, prob.handle->device);
+            auto  hardware = GetHardware(*deviceProp, prob.cu_count);
+
+            auto tensile_prob = ConstructTensileProblem(prob, configs[*config_id].use_bias);
+
+            Tensile::ContractionInputs tensile_inputs;
+            GetTensileInputs(prob, tensile_inputs);
+
+            // the invocations of a config are built once, the inputs do not change during the
+            // search
+            std::vector<int>                                           candidates;
+            std::vector<std::shared_ptr<Tensile::ContractionSolution>> solutions(config_max_id);
+            std::vector<std::vector<Tensile::KernelInvocation>>        invocations(config_max_id);
+            for(int id = 0; id < config_max_id; id++)
             {
-                float      min_ms = std::numeric_limits<float>::max();
-                hipEvent_t startEvent, stopEvent;
-                float      ms, sum_ms;
-                RETURN_IF_HIP_ERROR(hipEventCreate(&startEvent));
-                RETURN_IF_HIP_ERROR(hipEventCreate(&stopEvent));
-                for(int id = 0; id < config_max_id; id++)
+                if(configs[id].excluded)
+                    continue;
+                if(configs[id].max_workspace_bytes > prob.workspaceSize
+                   || (configs[id].max_workspace_bytes > 0 && prob.workspace == nullptr))
                 {
-                    if(configs[id].max_workspace_bytes > prob.workspaceSize
-                       || (configs[id].max_workspace_bytes > 0 && prob.workspace == nullptr))
-                    {
-                        hipsparselt_cerr << "config " << id << " need extra workspace "
-                                         << configs[id].max_workspace_bytes << " bytes - skip."
-                                         << std::endl;
-                        continue;
-                    }
-
-                    solution
-                        = library->getSolutionByIndex(tensile_prob, *hardware, configs[id].index);
-                    if(!solution)
-                    {
-                        hipsparselt_cerr << "Solution of config:" << id << " does not exists - skip"
-                                         << std::endl;
-                        continue;
-                    }
-
-                    //warm up
-                    RETURN_IF_HIP_ERROR(adapter.launchKernels(
-                        solution->solve(tensile_prob, tensile_inputs, *hardware),
-                        prob.streams[0],
-                        nullptr,
-                        nullptr));
-
-                    sum_ms = 0.0f;
-                    for(int i = 0; i < search_iterations; i++)
-                    {
-                        RETURN_IF_HIP_ERROR(adapter.launchKernels(
-                            solution->solve(tensile_prob, tensile_inputs, *hardware),
-                            prob.streams[0],
-                            startEvent,
-                            stopEvent));
-                        RETURN_IF_HIP_ERROR(hipEventSynchronize(stopEvent));
-                        RETURN_IF_HIP_ERROR(hipEventElapsedTime(&ms, startEvent, stopEvent));
-                        sum_ms += ms;
-                    }
-
-                    if(sum_ms < min_ms)
-                    {
-                        min_ms     = sum_ms;
-                        *config_id = id;
-                    }
+                    hipsparselt_cerr << "config " << id << " need extra workspace "
+                                     << configs[id].max_workspace_bytes << " bytes - skip."
+                                     << std::endl;
+                    continue;
                 }
-                RETURN_IF_HIP_ERROR(hipEventDestroy(startEvent));
-                RETURN_IF_HIP_ERROR(hipEventDestroy(stopEvent));
 
-                if(min_ms == std::numeric_limits<float>::max())
-                    return rocsparselt_status_internal_error;
+                solution = library->getSolutionByIndex(tensile_prob, *hardware, configs[id].index);
+                if(!solution)
+                {
+                    hipsparselt_cerr << "Solution of config:" << id << " does not exists - skip"
+                                     << std::endl;
+                    continue;
+                }
+                solutions[id]   = solution;
+                invocations[id] = solution->solve(tensile_prob, tensile_inputs, *hardware);
+                candidates.push_back(id);
             }
 
+            if(candidates.empty())
+                return rocsparselt_status_internal_error;
+
+            rocsparselt_search_cache_flush flush_cache(prob.handle);
+            RETURN_IF_HIP_ERROR(flush_cache.init(search_flush_cache));
+
+            rocsparselt_search_timer timer(prob.handle);
+            RETURN_IF_HIP_ERROR(timer.init());
+            auto time_run = [&](int id, int runs, float* ms) {
+                hipError_t err = hipSuccess;
+                for(int run = 0; run < runs && err == hipSuccess; run++)
+                {
+                    err = flush_cache(prob.streams[0]);
+                    if(err == hipSuccess)
+                        err = adapter.launchKernels(
+                            invocations[id], prob.streams[0], timer.start(run), timer.stop(run));
+                }
+                if(err == hipSuccess)
+                    err = timer.elapsed(runs, ms);
+                return err;
+            };
+            std::vector<rocsparselt_search_timing> ranking;
+            hipError_t                             err = rocsparselt_search_successive_halving(
+                prob.handle, candidates, search_iterations, time_run, config_id, &ranking);
+            RETURN_IF_HIP_ERROR(err);
+
+            if(search_results)
+                rocsparselt_search_store_results(
+                    ranking,
+                    [&](int id) { return solutions[id]->kernelName; },
+                    search_results,
+                    _rocsparselt_matmul_alg_selection::max_search_results);
+
             status = rocsparselt_status_success;
         }
     }
@@ -887,12 +1108,63 @@ rocsparselt_status getBestSolutions(const RocsparseltContractionProblem<Ti, To,
     // auto &adapter =
     get_library_and_adapter(&library, &deviceProp, prob.handle->device);
 
-    hardware          = Tensile::hip::GetDevice(*deviceProp);
+    hardware          = GetHardware(*deviceProp, prob.cu_count);
     auto tensile_prob = ConstructTensileProblem(prob);
     // auto handle = prob.handle;
-    auto solutions = library->findTopSolutions(tensile_prob, *hardware, requestConfigs);
 
-    *foundConfigs = std::min((int)solutions.size(), requestConfigs);
+    // The selection heuristic ranks the solutions Tensile found: its first one, tuned for the
+    // sizes of the logic files, stays first unless another is predicted at least 10% faster.
+    // Beyond the top requestConfigs, the best solution of each other Split-K factor is kept
+    // as well, so that the search also compares the factors: a tall K can be faster split.
+    using Solution = std::shared_ptr<Tensile::ContractionSolution>;
+    const int cus  = prob.cu_count > 0 ? prob.cu_count : deviceProp->multiProcessorCount;
+    auto      score = [&](const Solution& solution) {
+        rocsparselt_config_shape shape;
+        shape.macro_tile0   = solution->sizeMapping.macroTile.x;
+        shape.macro_tile1   = solution->sizeMapping.macroTile.y;
+        shape.depth_u       = solution->sizeMapping.depthU;
+        shape.split_k       = std::max<int64_t>(1, solution->sizeMapping.globalSplitU);
+        shape.reduce_kernel = solution->sizeMapping.globalAccumulation != 1;
+        double time
+            = rocsparselt_config_time(shape, prob.m, prob.n, prob.k, prob.batch_count, cus);
+        return rocsparselt_config_score(time, prob.m, prob.n, prob.k, prob.batch_count, cus);
+    };
+    constexpr int maxConfigs
+        = sizeof(_rocsparselt_matmul_alg_selection::configs) / sizeof(_rocsparselt_matmul_config);
+    std::vector<float> scores;
+    auto               select = [&](const std::vector<Solution>& found) {
+        std::vector<float>  found_scores;
+        std::vector<size_t> order;
+        for(size_t i = 0; i < found.size(); i++)
+        {
+            found_scores.push_back(score(found[i]));
+            order.push_back(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return found_scores[a] > found_scores[b];
+        });
+        if(!order.empty() && found_scores[0] * 1.1f >= found_scores[order[0]])
+            std::stable_partition(order.begin(), order.end(), [](size_t i) { return i == 0; });
+
+        std::vector<Solution> selected;
+        std::set<size_t>      factors;
+        scores.clear();
+        for(size_t i = 0; i < order.size(); i++)
+        {
+            const auto& solution = found[order[i]];
+            size_t      factor   = std::max<size_t>(1, solution->sizeMapping.globalSplitU);
+            if(i < (size_t)requestConfigs || factors.count(factor) == 0)
+            {
+                selected.push_back(solution);
+                scores.push_back(found_scores[order[i]]);
+            }
+            factors.insert(factor);
+        }
+        return selected;
+    };
+    auto solutions = select(library->findTopSolutions(tensile_prob, *hardware, maxConfigs));
+
+    *foundConfigs = (int)solutions.size();
 
     // Finding alternative solutions.
     int useBias = tensile_prob.useBias();
@@ -911,8 +1183,8 @@ rocsparselt_status getBestSolutions(const RocsparseltContractionProblem<Ti, To,
         if(hasUpdated)
         {
             tensile_prob  = ConstructTensileProblem(prob, useBias);
-            solutions     = library->findTopSolutions(tensile_prob, *hardware, requestConfigs);
-            *foundConfigs = std::min((int)solutions.size(), requestConfigs);
+            solutions     = select(library->findTopSolutions(tensile_prob, *hardware, maxConfigs));
+            *foundConfigs = (int)solutions.size();
             log_info(prob.handle, __func__, *foundConfigs, " alternative solutions found");
         }
     }
@@ -922,7 +1194,13 @@ rocsparselt_status getBestSolutions(const RocsparseltContractionProblem<Ti, To,
         auto solution                  = solutions[i];
         configs[i].index               = solution->index;
         configs[i].max_workspace_bytes = solution->requiredWorkspaceSize(tensile_prob);
+        configs[i].score               = scores[i];
         configs[i].use_bias            = useBias;
+        configs[i].split_k             = std::max<int>(1, solution->sizeMapping.globalSplitU);
+        // a single buffer reduces the splits with atomics in the kernel itself
+        configs[i].split_k_mode = solution->sizeMapping.globalAccumulation == 1
+                                      ? rocsparselt_splik_k_mode_one_kernel
+                                      : rocsparselt_split_k_mode_two_kernels;
     }
     return rocsparselt_status_success;
 }
@@ -936,6 +1214,122 @@ extern "C" void rocsparselt_initialize()
     get_library_and_adapter();
 }
 
+/***********************************************************************
+ * ! \brief  Initialize rocsparselt for the devices of device_mask, one *
+ * thread per device. The Tensile library is loaded only once and the   *
+ * code objects of each device are loaded concurrently.                 *
+ ***********************************************************************/
+extern "C" rocsparselt_status rocsparselt_init_devices(uint64_t device_mask)
+{
+    return rocsparselt_run_on_devices(device_mask, [](int device) {
+        get_library_and_adapter(nullptr, nullptr, device);
+        return rocsparselt_status_success;
+    });
+}
+
+namespace
+{
+    template <typename Ti, typename To, typename Tc>
+    bool hasTypedSolution(const _rocsparselt_matmul_descr*  matmulDescr,
+                          const _rocsparselt_matmul_config& config)
+    {
+        RocsparseltContractionProblemStorage<Ti, To, Tc> storage;
+        Tc                                               alpha = static_cast<Tc>(1.0f);
+        Tc                                               beta  = static_cast<Tc>(1.0f);
+        if(ConstructRocSparseLtProblem<Ti, To, Tc>(
+               __func__, storage.get(), matmulDescr, &alpha, &beta)
+           != rocsparselt_status_success)
+            return false;
+        const auto& prob = *storage.get();
+
+        std::shared_ptr<Tensile::MasterSolutionLibrary<Tensile::ContractionProblemGemm>>
+                                         library;
+        std::shared_ptr<hipDeviceProp_t> deviceProp;
+        get_library_and_adapter(&library, &deviceProp, prob.handle->device);
+        if(!library)
+            return false;
+
+        // getSolutionByIndex loads the library of the problem type when it is lazy
+        auto hardware     = GetHardware(*deviceProp, prob.cu_count);
+        auto tensile_prob = ConstructTensileProblem(prob, config.use_bias);
+        try
+        {
+            return library->getSolutionByIndex(tensile_prob, *hardware, config.index) != nullptr;
+        }
+        catch(...)
+        {
+            return false;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Whether config is a solution of the Tensile library for matmulDescr          *
+ *******************************************************************************/
+bool hasSolution(const _rocsparselt_matmul_descr*  matmulDescr,
+                 const _rocsparselt_matmul_config& config)
+{
+    if(config.index < 0 || config.stream_k_index >= 0)
+        return false;
+
+    // a mixed input matmul runs the kernels of the type of its dense matrix
+    auto in_type      = rocsparselt_matmul_input_type(matmulDescr);
+    auto out_type     = matmulDescr->matrix_D->type;
+    auto compute_type = matmulDescr->compute_type;
+
+    if(compute_type == rocsparselt_compute_i32 && in_type == rocsparselt_datatype_i8_r)
+    {
+        switch(out_type)
+        {
+        case rocsparselt_datatype_i8_r:
+            return hasTypedSolution<int8_t, int8_t, float>(matmulDescr, config);
+        case rocsparselt_datatype_f16_r:
+            return hasTypedSolution<int8_t, __half, float>(matmulDescr, config);
+        case rocsparselt_datatype_i32_r:
+            return hasTypedSolution<int8_t, int32_t, float>(matmulDescr, config);
+        default:
+            return false;
+        }
+    }
+    if(compute_type != rocsparselt_compute_f32)
+        return false;
+    switch(in_type)
+    {
+    case rocsparselt_datatype_f16_r:
+        return out_type == rocsparselt_datatype_f16_r
+               && hasTypedSolution<__half, __half, float>(matmulDescr, config);
+    case rocsparselt_datatype_bf16_r:
+        return out_type == rocsparselt_datatype_bf16_r
+               && hasTypedSolution<hip_bfloat16, hip_bfloat16, float>(matmulDescr, config);
+    case rocsparselt_datatype_f8_r:
+        switch(out_type)
+        {
+        case rocsparselt_datatype_f16_r:
+            return hasTypedSolution<__hip_fp8_e4m3_fnuz, __half, float>(matmulDescr, config);
+        case rocsparselt_datatype_bf16_r:
+            return hasTypedSolution<__hip_fp8_e4m3_fnuz, hip_bfloat16, float>(matmulDescr, config);
+        case rocsparselt_datatype_f32_r:
+            return hasTypedSolution<__hip_fp8_e4m3_fnuz, float, float>(matmulDescr, config);
+        default:
+            return false;
+        }
+    case rocsparselt_datatype_bf8_r:
+        switch(out_type)
+        {
+        case rocsparselt_datatype_f16_r:
+            return hasTypedSolution<__hip_fp8_e5m2_fnuz, __half, float>(matmulDescr, config);
+        case rocsparselt_datatype_bf16_r:
+            return hasTypedSolution<__hip_fp8_e5m2_fnuz, hip_bfloat16, float>(matmulDescr, config);
+        case rocsparselt_datatype_f32_r:
+            return hasTypedSolution<__hip_fp8_e5m2_fnuz, float, float>(matmulDescr, config);
+        default:
+            return false;
+        }
+    default:
+        return false;
+    }
+}
+
 /***********************************************************************************
  * Whether Tensile has been initialized for at least one device (used for testing) *
  ***********************************************************************************/
@@ -956,7 +1350,10 @@ std::atomic_bool& rocsparselt_internal_tensile_is_initialized()
         _rocsparselt_matmul_config*,                               \
         int*,                                                      \
         const int,                                                 \
-        const int);                                                \
+        const int,                                                 \
+        const bool,                                                \
+        rocsparselt_matmul_search_result*,                         \
+        _rocsparselt_solution_cache*);                             \
     template rocsparselt_status getBestSolutions<Ti, To, Tc>(      \
         const RocsparseltContractionProblem<Ti, To, Tc>&, int, _rocsparselt_matmul_config*, int*);
 
@@ -964,5 +1361,12 @@ GENERATE_DEFINITIONS(__half, __half, float)
 GENERATE_DEFINITIONS(hip_bfloat16, hip_bfloat16, float)
 GENERATE_DEFINITIONS(int8_t, int8_t, float)
 GENERATE_DEFINITIONS(int8_t, __half, float)
+GENERATE_DEFINITIONS(int8_t, int32_t, float)
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, __half, float)
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, hip_bfloat16, float)
+GENERATE_DEFINITIONS(__hip_fp8_e4m3_fnuz, float, float)
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, __half, float)
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, hip_bfloat16, float)
+GENERATE_DEFINITIONS(__hip_fp8_e5m2_fnuz, float, float)
 
 #undef GENERATE_DEFINITIONS
@@ -0,0 +1,358 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "tracing.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unistd.h>
+#include <vector>
+
+namespace
+{
+    // the host spans are shown under the process host_pid, the GPU spans of
+    // device d under the process gpu_pid + d
+    constexpr int host_pid = 1;
+    constexpr int gpu_pid  = 2;
+
+    std::string json_escape(const char* s)
+    {
+        std::string out;
+        for(; *s; s++)
+        {
+            if(*s == '"' || *s == '\\')
+                out.push_back('\\');
+            if(static_cast<unsigned char>(*s) >= 0x20)
+                out.push_back(*s);
+        }
+        return out;
+    }
+
+    int thread_tid()
+    {
+        static std::atomic<int> next_tid{1};
+        thread_local int        tid = next_tid++;
+        return tid;
+    }
+
+    class tracer
+    {
+    public:
+        tracer()
+            : t0(std::chrono::steady_clock::now())
+        {
+            std::string path = getenv("HIPSPARSELT_TRACE_FILE");
+            size_t      pos  = path.find("%i");
+            if(pos != std::string::npos)
+                path.replace(pos, 2, std::to_string(getpid()));
+            file.open(path);
+            if(!file.is_open())
+            {
+                std::cerr << "hipSPARSELt: cannot open the trace file " << path << std::endl;
+                return;
+            }
+            // the closing bracket is optional in the JSON array format, a trace
+            // cut short by the end of the process stays readable
+            file << std::fixed << std::setprecision(3) << "[\n";
+            metadata(host_pid, 0, "process_name", "hipSPARSELt host");
+        }
+
+        double now_us() const
+        {
+            return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0)
+                .count();
+        }
+
+        void host_span(const char*        name,
+                       hipStream_t        stream,
+                       const std::string& detail,
+                       double             start_us,
+                       double             end_us)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(!file.is_open())
+                return;
+            file << "{\"name\":\"" << json_escape(name)
+                 << "\",\"cat\":\"host\",\"ph\":\"X\",\"pid\":" << host_pid
+                 << ",\"tid\":" << thread_tid() << ",\"ts\":" << start_us
+                 << ",\"dur\":" << end_us - start_us << ",\"args\":{\"stream\":\"" << stream
+                 << "\"";
+            if(!detail.empty())
+                file << ",\"detail\":\"" << json_escape(detail.c_str()) << "\"";
+            file << "}},\n";
+        }
+
+        // the time line of the GPU of device is anchored to the host once, on
+        // the first GPU span of the device
+        hipError_t anchor(int device, hipStream_t stream)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(anchors.count(device))
+                return hipSuccess;
+            hipEvent_t event;
+            hipError_t status = hipEventCreate(&event);
+            if(status != hipSuccess)
+                return status;
+            status = hipEventRecord(event, stream);
+            if(status == hipSuccess)
+                status = hipEventSynchronize(event);
+            if(status != hipSuccess)
+            {
+                (void)hipEventDestroy(event);
+                return status;
+            }
+            anchors[device] = {event, now_us()};
+            metadata(gpu_pid + device, 0, "process_name", "GPU " + std::to_string(device));
+            return hipSuccess;
+        }
+
+        // starts the arrow from the calling thread to the GPU span at ts
+        uint64_t flow_start(double ts)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            uint64_t                    id = ++flows;
+            if(file.is_open())
+                file << "{\"name\":\"launch\",\"cat\":\"launch\",\"ph\":\"s\",\"id\":" << id
+                     << ",\"pid\":" << host_pid << ",\"tid\":" << thread_tid() << ",\"ts\":" << ts
+                     << "},\n";
+            return id;
+        }
+
+        void gpu_span(const char* name,
+                      int         device,
+                      hipStream_t stream,
+                      hipEvent_t  start,
+                      hipEvent_t  stop,
+                      uint64_t    flow)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            collect_locked(false);
+            pending.push_back({name, device, stream, start, stop, flow});
+        }
+
+        // writes the span between start and stop at once, both completed
+        void gpu_events(const std::string& name,
+                        int                device,
+                        hipStream_t        stream,
+                        hipEvent_t         start,
+                        hipEvent_t         stop)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if(anchors.count(device))
+                write_gpu_span_locked(name.c_str(), device, stream, start, stop, 0);
+        }
+
+        void flush()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            collect_locked(true);
+            if(file.is_open())
+                file.flush();
+        }
+
+    private:
+        struct gpu_sample
+        {
+            const char* name;
+            int         device;
+            hipStream_t stream;
+            hipEvent_t  start;
+            hipEvent_t  stop;
+            uint64_t    flow;
+        };
+
+        void metadata(int pid, int tid, const char* kind, const std::string& name)
+        {
+            if(file.is_open())
+                file << "{\"name\":\"" << kind << "\",\"ph\":\"M\",\"pid\":" << pid
+                     << ",\"tid\":" << tid << ",\"args\":{\"name\":\"" << json_escape(name.c_str())
+                     << "\"}},\n";
+        }
+
+        // one GPU thread per stream, named after it
+        int stream_tid_locked(int device, hipStream_t stream)
+        {
+            auto it = stream_tids.find({device, stream});
+            if(it != stream_tids.end())
+                return it->second;
+            int               tid = static_cast<int>(stream_tids.size()) + 1;
+            std::stringstream name;
+            name << "stream " << stream;
+            metadata(gpu_pid + device, tid, "thread_name", name.str());
+            stream_tids[{device, stream}] = tid;
+            return tid;
+        }
+
+        // writes the span between the completed events start and stop, and the
+        // end of the arrow flow unless 0
+        void write_gpu_span_locked(const char* name,
+                                   int         device,
+                                   hipStream_t stream,
+                                   hipEvent_t  start,
+                                   hipEvent_t  stop,
+                                   uint64_t    flow)
+        {
+            auto& base     = anchors[device];
+            float start_ms = 0.0f, dur_ms = 0.0f;
+            if(!file.is_open() || hipEventElapsedTime(&start_ms, base.first, start) != hipSuccess
+               || hipEventElapsedTime(&dur_ms, start, stop) != hipSuccess)
+                return;
+            int    pid = gpu_pid + device;
+            int    tid = stream_tid_locked(device, stream);
+            double ts  = base.second + start_ms * 1e3;
+            file << "{\"name\":\"" << json_escape(name)
+                 << "\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":" << pid << ",\"tid\":" << tid
+                 << ",\"ts\":" << ts << ",\"dur\":" << dur_ms * 1e3 << "},\n";
+            if(flow != 0)
+                file << "{\"name\":\"launch\",\"cat\":\"launch\",\"ph\":\"f\",\"bp\":\"e\",\"id\":"
+                     << flow << ",\"pid\":" << pid << ",\"tid\":" << tid << ",\"ts\":" << ts
+                     << "},\n";
+        }
+
+        // writes the GPU spans whose events completed, all of them when wait
+        void collect_locked(bool wait)
+        {
+            size_t kept = 0;
+            for(auto& sample : pending)
+            {
+                hipError_t status = wait ? hipEventSynchronize(sample.stop)
+                                         : hipEventQuery(sample.stop);
+                if(status == hipErrorNotReady)
+                {
+                    pending[kept++] = sample;
+                    continue;
+                }
+                if(status == hipSuccess)
+                    write_gpu_span_locked(sample.name,
+                                          sample.device,
+                                          sample.stream,
+                                          sample.start,
+                                          sample.stop,
+                                          sample.flow);
+                (void)hipEventDestroy(sample.start);
+                (void)hipEventDestroy(sample.stop);
+            }
+            pending.resize(kept);
+        }
+
+        const std::chrono::steady_clock::time_point t0;
+
+        std::mutex                                   mutex;
+        std::ofstream                                file;
+        std::map<int, std::pair<hipEvent_t, double>> anchors;
+        std::map<std::pair<int, hipStream_t>, int>   stream_tids;
+        std::vector<gpu_sample>                      pending;
+        uint64_t                                     flows = 0;
+    };
+
+    tracer& get_tracer()
+    {
+        static tracer instance;
+        return instance;
+    }
+}
+
+void rocsparselt_trace_flush()
+{
+    if(rocsparselt_tracing())
+        get_tracer().flush();
+}
+
+void rocsparselt_trace_gpu_events(const std::string& name,
+                                  hipStream_t        stream,
+                                  hipEvent_t         start,
+                                  hipEvent_t         stop)
+{
+    int device;
+    if(rocsparselt_tracing() && hipGetDevice(&device) == hipSuccess)
+        get_tracer().gpu_events(name, device, stream, start, stop);
+}
+
+void rocsparselt_trace_span::begin(const char* name, hipStream_t stream, const char* detail)
+{
+    this->name   = name;
+    this->stream = stream;
+    if(detail != nullptr)
+        this->detail = detail;
+    start_us = get_tracer().now_us();
+}
+
+void rocsparselt_trace_span::end()
+{
+    auto& t = get_tracer();
+    t.host_span(name, stream, detail, start_us, t.now_us());
+}
+
+void rocsparselt_trace_gpu_span::begin(const char* name, hipStream_t stream)
+{
+    // the work captured into a graph is not timed
+    hipStreamCaptureStatus capture = hipStreamCaptureStatusNone;
+    if(hipStreamIsCapturing(stream, &capture) != hipSuccess
+       || capture != hipStreamCaptureStatusNone)
+        return;
+
+    auto& t = get_tracer();
+    int   device;
+    if(hipGetDevice(&device) != hipSuccess || t.anchor(device, stream) != hipSuccess)
+        return;
+    if(hipEventCreate(&start) != hipSuccess)
+    {
+        start = nullptr;
+        return;
+    }
+    if(hipEventRecord(start, stream) != hipSuccess)
+    {
+        (void)hipEventDestroy(start);
+        start = nullptr;
+        return;
+    }
+    this->name   = name;
+    this->stream = stream;
+    flow         = t.flow_start(t.now_us());
+}
+
+void rocsparselt_trace_gpu_span::end()
+{
+    hipEvent_t stop;
+    int        device;
+    if(hipGetDevice(&device) != hipSuccess || hipEventCreate(&stop) != hipSuccess)
+    {
+        (void)hipEventDestroy(start);
+        return;
+    }
+    if(hipEventRecord(stop, stream) != hipSuccess)
+    {
+        (void)hipEventDestroy(start);
+        (void)hipEventDestroy(stop);
+        return;
+    }
+    get_tracer().gpu_span(name, device, stream, start, stop, flow);
+}
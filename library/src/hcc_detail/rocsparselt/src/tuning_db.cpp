@@ -0,0 +1,90 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+#include "tuning_db.hpp"
+#include "hipsparselt_tuning_db.hpp"
+#include "utility.hpp"
+
+#include <sstream>
+
+namespace
+{
+    void append_matrix(std::ostream& os, char name, const _rocsparselt_mat_descr* mat)
+    {
+        os << '_' << name << rocsparselt_datatype_to_string(mat->type) << '_'
+           << rocsparselt_order_to_string(mat->order) << '_' << mat->m << 'x' << mat->n << "_ld"
+           << mat->ld << "_b" << mat->num_batches << (mat->batch_stride == 0 ? "s0" : "");
+    }
+}
+
+std::string rocsparselt_tuning_signature(const _rocsparselt_handle*       handle,
+                                         const _rocsparselt_matmul_descr* matmul_descr)
+{
+    std::string arch(handle->properties.gcnArchName);
+
+    std::ostringstream os;
+    os << arch.substr(0, arch.find(':')) << "_rev" << handle->asic_rev << "_cu"
+       << matmul_descr->effective_cu_count() << '_'
+       << rocsparselt_compute_type_to_string(matmul_descr->compute_type) << '_'
+       << rocsparselt_transpose_letter(matmul_descr->op_A)
+       << rocsparselt_transpose_letter(matmul_descr->op_B) << "_m" << matmul_descr->m << "_n"
+       << matmul_descr->n << "_k" << matmul_descr->k;
+    append_matrix(os, 'A', matmul_descr->matrix_A);
+    append_matrix(os, 'B', matmul_descr->matrix_B);
+    append_matrix(os, 'C', matmul_descr->matrix_C);
+    append_matrix(os, 'D', matmul_descr->matrix_D);
+    if(matmul_descr->bias_pointer != nullptr)
+        os << "_bias" << rocsparselt_datatype_to_string(matmul_descr->bias_type);
+    os << '_' << rocsparselt_activation_type_to_string(matmul_descr->activation) << "_sparse"
+       << (matmul_descr->is_sparse_a ? 'A' : 'B');
+    if(matmul_descr->alpha_vector_scaling)
+        os << "_alphaVec" << (matmul_descr->beta_vector_scaling ? "_betaVec" : "");
+    if(matmul_descr->d_scale != 1.0f || matmul_descr->d_saturate || matmul_descr->amax_d_pointer)
+        os << "_epilogueD";
+    if(matmul_descr->residual_pointer != nullptr)
+        os << "_residual";
+    if(matmul_descr->gate_pointer != nullptr)
+        os << "_gate";
+    if(matmul_descr->bias_grad_pointer != nullptr)
+        os << "_biasGrad";
+    // the candidates restrict the configs of the problem, as the CU count does
+    if(matmul_descr->candidates > 0)
+        os << "_candidates" << matmul_descr->candidates;
+    return os.str();
+}
+
+bool rocsparselt_tuning_db_find(const std::string& signature, int* index)
+{
+    std::vector<int64_t> values;
+    if(!hipsparselt_tuning_db_find("hip", signature, &values) || values.size() != 1)
+        return false;
+    *index = values[0];
+    return true;
+}
+
+void rocsparselt_tuning_db_store(const std::string& signature, int index)
+{
+    hipsparselt_tuning_db_store("hip", signature, {index});
+}
@@ -25,7 +25,9 @@
  *******************************************************************************/
 #include "utility.hpp"
 #include <sys/types.h>
+#include <thread>
 #include <unistd.h>
+#include <vector>
 
 std::string prefix(const char* layer, const char* caller)
 {
@@ -58,6 +60,8 @@ const char* rocsparselt_datatype_to_string(rocsparselt_datatype type)
         return "f32_r";
     case rocsparselt_datatype_i8_r:
         return "i8_r";
+    case rocsparselt_datatype_i32_r:
+        return "i32_r";
     case rocsparselt_datatype_bf16_r:
         return "bf16_r";
     case rocsparselt_datatype_f8_r:
@@ -161,7 +165,58 @@ const char* rocsparselt_activation_type_to_string(rocsparselt_matmul_descr_attri
         return "sigmoid";
     case rocsparselt_matmul_activation_tanh:
         return "tanh";
+    case rocsparselt_matmul_activation_silu:
+        return "silu";
+    case rocsparselt_matmul_activation_clamp:
+        return "clamp";
     default:
         return "none";
     }
 }
+
+rocsparselt_status
+    rocsparselt_run_on_devices(uint64_t                                      device_mask,
+                               const std::function<rocsparselt_status(int)>& fn)
+{
+    int count;
+    if(hipGetDeviceCount(&count) != hipSuccess)
+        return rocsparselt_status_internal_error;
+
+    // a bit set beyond the last device does not stand for any device
+    if(count < 64 && (device_mask >> count) != 0)
+        return rocsparselt_status_invalid_value;
+
+    std::vector<int> devices;
+    for(int device = 0; device < count; device++)
+        if(device_mask == 0 || (device < 64 && ((device_mask >> device) & 1)))
+            devices.push_back(device);
+
+    std::vector<rocsparselt_status> status(devices.size(), rocsparselt_status_success);
+    std::vector<std::thread>        threads;
+    for(size_t i = 0; i < devices.size(); i++)
+        threads.emplace_back([&, i]() {
+            // an exception must not escape the thread, it would terminate the process
+            try
+            {
+                if(hipSetDevice(devices[i]) != hipSuccess)
+                    status[i] = rocsparselt_status_internal_error;
+                else
+                    status[i] = fn(devices[i]);
+            }
+            catch(const rocsparselt_status& s)
+            {
+                status[i] = s;
+            }
+            catch(...)
+            {
+                status[i] = rocsparselt_status_internal_error;
+            }
+        });
+    for(auto& thread : threads)
+        thread.join();
+
+    for(auto s : status)
+        if(s != rocsparselt_status_success)
+            return s;
+    return rocsparselt_status_success;
+}
@@ -24,12 +24,17 @@
  *
  *******************************************************************************/
 
+#include <algorithm>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <utility>
+#include <vector>
 using namespace std;
 
-void bin_2_hex(string infilename, ofstream* outfile, string dataname)
+// Writes the code object as a constant array, which stays in the read-only pages of the
+// library: nothing is copied when the library is loaded.
+void bin_2_hex(string infilename, ofstream* outfile, string arrayname)
 {
     ifstream infile;
     infile.open(infilename, ios_base::binary);
@@ -39,29 +44,21 @@ void bin_2_hex(string infilename, ofstream* outfile, string dataname)
         exit(-1);
     }
 
-    char          readByte;
-    unsigned char readByte2;
-    int           cnt = 0;
+    char readByte;
+    int  cnt = 0;
 
-    *outfile << "{ \"" << dataname.substr(0, dataname.length() - 3) << "\", " << endl;
-    *outfile << "{ " << endl;
+    *outfile << "alignas(16) const unsigned char " << arrayname << "[] = {";
 
-    while(!infile.eof())
+    while(infile.get(readByte))
     {
         if(cnt % 16 == 0)
-        {
-            *outfile << " " << endl;
-            *outfile << "   ";
-        }
-        infile.get(readByte);
-        readByte2 = (unsigned char)readByte;
+            *outfile << "\n   ";
         cnt++;
-        *outfile << "0x" << setfill('0') << setw(2);
-        *outfile << hex << (unsigned int)readByte2;
-        *outfile << ",";
+        *outfile << " 0x" << setfill('0') << setw(2) << hex
+                 << (unsigned int)(unsigned char)readByte << dec << ",";
     }
 
-    *outfile << "\n}}, \n";
+    *outfile << "\n};\n";
     infile.close();
 }
 
@@ -91,23 +88,55 @@ int main(int argc, char** argv)
         exit(-1);
     }
 
-    //outfile << "#ifndef SPMM_KERNELS_H\n#define SPMM_KERNELS_H" << endl;
-    //outfile << "#include \"" << outfilename << ".hpp\"" << endl;
-    outfile << "#include <map>" << endl;
-    outfile << "#include <string>" << endl;
-    outfile << "#include <vector>" << endl;
-    outfile << "std::map<std::string, std::vector<unsigned char>> kernel_map = {" << endl;
+    // kernel name without the .co extension and code object file, sorted by name for the
+    // binary search of get_kernel_entry()
+    vector<pair<string, string>> kernels;
     for(int i = 3; i < filenum; i++)
     {
-        bin_2_hex(argv[i], &outfile, get_kernel_name(argv[i]));
+        string name = get_kernel_name(argv[i]);
+        kernels.emplace_back(name.substr(0, name.length() - 3), argv[i]);
     }
+    sort(kernels.begin(), kernels.end());
+
+    outfile << "#include <cstddef>" << endl;
+    outfile << "#include <cstring>" << endl;
+    outfile << "namespace {" << endl;
+    for(size_t i = 0; i < kernels.size(); i++)
+        bin_2_hex(kernels[i].second, &outfile, "kernel_" + to_string(i));
+
+    outfile << "struct kernel_entry { const char* name; const unsigned char* data; size_t size; };"
+            << endl;
+    outfile << "const kernel_entry kernel_index[] = {" << endl;
+    for(size_t i = 0; i < kernels.size(); i++)
+        outfile << "    { \"" << kernels[i].first << "\", kernel_" << i << ", sizeof(kernel_" << i
+                << ") }," << endl;
+    if(kernels.empty())
+        outfile << "    { \"\", nullptr, 0 }," << endl;
     outfile << "};" << endl;
+    outfile << "const size_t kernel_index_size = " << kernels.size() << ";" << endl;
+    outfile << "}" << endl;
 
-    outfile << "extern \"C\" int get_map_size() { return kernel_map.size(); }" << endl;
+    outfile << "extern \"C\" int get_map_size() { return kernel_index_size; }" << endl;
+    outfile << "extern \"C\" const unsigned char* get_kernel_entry(const char* name, size_t* size)"
+            << endl;
+    outfile << "{" << endl;
+    outfile << "    size_t first = 0, last = kernel_index_size;" << endl;
+    outfile << "    while(first < last)" << endl;
+    outfile << "    {" << endl;
+    outfile << "        size_t mid = first + (last - first) / 2;" << endl;
+    outfile << "        int    cmp = strcmp(kernel_index[mid].name, name);" << endl;
+    outfile << "        if(cmp == 0)" << endl;
+    outfile << "        {" << endl;
+    outfile << "            if(size) *size = kernel_index[mid].size;" << endl;
+    outfile << "            return kernel_index[mid].data;" << endl;
+    outfile << "        }" << endl;
+    outfile << "        if(cmp < 0) first = mid + 1; else last = mid;" << endl;
+    outfile << "    }" << endl;
+    outfile << "    return nullptr;" << endl;
+    outfile << "}" << endl;
     outfile << "extern \"C\" unsigned char* get_kernel_byte(const char* name) { return "
-               "kernel_map[name].data(); }"
+               "const_cast<unsigned char*>(get_kernel_entry(name, nullptr)); }"
             << endl;
-    //outfile << "#endif" << endl;
     outfile.close();
 
     outfile.open(hppfilename, ios_base::binary | ios_base::app);
@@ -120,7 +120,7 @@ def writefile(filename, kernel_maps):
                             wg, tt, mt,
                             ka.StaggerU, ka.DepthU, ka.GlobalSplitU, ka.StaggerStrideShift, ka.WorkGroupMapping, ka.PackBatchDims,
                             "true" if ka.UseInitialStridesA else "false", "true" if ka.UseInitialStridesCD else "false",
-                            "true" if ka.ActivationFused else "false", 0 if not ka.GlobalAccumulation else ka.GlobalAccumulation,
+                            "true" if ka.ActivationFused else "false", ka.GlobalAccumulation,
                             "true" if ka.Activation else "false", "true" if ka.ActivationHPA else "false", ka.ActivationType)
                     f.write("{}{}{},\n".format("{", values, "}"))
                 f.write("}},\n")
@@ -184,7 +184,9 @@ def main(args):
                         ka.UseInitialStridesA = contents4.get('UseInitialStridesAB')
                         ka.UseInitialStridesC = contents4.get('UseInitialStridesCD')
                         ka.ActivationFused = contents5[c_index].get('ActivationFused')
-                        ka.GlobalAccumulation = contents5[c_index].get('_GlobalAccumulation')
+                        # 0: none, 1: SingleBuffer (atomics), 2: MultipleBuffer (one buffer per split)
+                        ka.GlobalAccumulation = {'SingleBuffer': 1, 'MultipleBuffer': 2}.get(
+                            contents5[c_index].get('_GlobalAccumulation'), 0)
                         ka.Activation = contents_p.get('Activation')
                         ka.ActivationHPA = contents_p.get('ActivationHPA')
                         ka.ActivationType = contents_p.get('ActivationType')
@@ -213,6 +215,9 @@ def main(args):
                             print("ActivationHPA=", ka.ActivationHPA)
                             print("ActivationType=", ka.ActivationType)
                         key="{}_{}_{}_{}_{}".format(ka.DataType, ka.DestDataType, ka.ComputeDataType, 'T' if ka.TransposeA else 'N', 'T' if ka.TransposeB else 'N')
+                        # the kernels of a structured B (Sparse: 2) are a category of their own
+                        if contents4.get('Sparse', 1) == 2:
+                            key += "_SPB"
                         if key in kernel_maps :
                             kernel_maps[key].append(ka)
                         else:
@@ -0,0 +1,137 @@
+#!/usr/bin/python
+# ########################################################################
+# Copyright (c) 2024 Advanced Micro Devices, Inc.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in
+# all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+# THE SOFTWARE.
+#
+# ########################################################################
+
+# Copies the logic files, and the code objects of their solutions, of the problem
+# signatures given by --signatures or found in the tuning database --tuning-db from
+# --source to --dest, so that only the kernels of a workload are built. A signature
+# is "arch:A type:D type:ops:sparse side", e.g. "gfx942:f16_r:f16_r:NT:A", any field
+# may be "*". The archs of the copied files are printed, separated by semicolons.
+
+import getopt
+import os
+import re
+import shutil
+import sys
+import yaml
+
+try:
+    SafeLoader = yaml.CSafeLoader
+except AttributeError:
+    SafeLoader = yaml.SafeLoader
+
+# the Tensile data types of the type names of rocsparselt_datatype_to_string(), the int8
+# kernels also give int32 through their float partial sums
+dataTypes = {'f32_r': [0], 'f16_r': [4], 'i32_r': [6, 8], 'bf16_r': [7], 'i8_r': [8],
+             'f8_r': [11], 'bf8_r': [12]}
+
+# [hip ]<arch>_rev<n>_cu<n>_<compute>_<opA><opB>_m<m>_n<n>_k<k>_A<type>_..._D<type>_..._sparse<A|B>,
+# the "cuda" lines of the CUDA backend have no kernel here
+tuningLine = re.compile(r'^(?:hip\s+)?(?P<arch>[^_\s]+)_rev\d+_cu\d+_[^_]+_(?P<ops>[NTC]{2})_m\d+_n\d+_k\d+'
+                        r'_A(?P<a>[a-z0-9]+_r)_.*?_D(?P<d>[a-z0-9]+_r)_.*_sparse(?P<side>[AB])')
+
+class Signature:
+    def __init__(self, arch, a, d, ops, side):
+        self.arch = arch
+        self.a = a
+        self.d = d
+        self.ops = ops.replace('C', 'T')
+        self.side = side
+
+    def matches(self, arch, problem):
+        def same(field, value):
+            return field == '*' or field == value
+        ops = '{}{}'.format('T' if problem.get('TransposeA') else 'N',
+                            'T' if problem.get('TransposeB') else 'N')
+        side = 'B' if problem.get('Sparse', 1) == 2 else 'A'
+        return (same(self.arch, arch) and same(self.ops, ops) and same(self.side, side)
+                and (self.a == '*' or problem.get('DataType') in dataTypes.get(self.a, []))
+                and (self.d == '*' or problem.get('DestDataType') in dataTypes.get(self.d, [])))
+
+def parseSignatures(text):
+    signatures = []
+    for s in re.split(r'[;,\s]+', text):
+        if not s:
+            continue
+        fields = s.split(':')
+        if len(fields) != 5:
+            raise ValueError('signature {} is not arch:A type:D type:ops:sparse side'.format(s))
+        signatures.append(Signature(*fields))
+    return signatures
+
+def readTuningDb(path):
+    signatures = []
+    with open(path, 'r') as f:
+        for line in f:
+            m = tuningLine.match(line)
+            if m:
+                signatures.append(Signature(m.group('arch'), m.group('a'), m.group('d'),
+                                            m.group('ops'), m.group('side')))
+    return signatures
+
+def main(args):
+    (opts, rem) = getopt.getopt(args, '', ['source=', 'dest=', 'signatures=', 'tuning-db='])
+    optDict = dict(opts)
+    source = optDict['--source']
+    dest = optDict['--dest']
+
+    signatures = parseSignatures(optDict.get('--signatures', ''))
+    if optDict.get('--tuning-db'):
+        signatures += readTuningDb(optDict['--tuning-db'])
+    if not signatures:
+        sys.exit('no problem signature to build the kernels of')
+
+    if os.path.isdir(dest):
+        shutil.rmtree(dest)
+
+    archs = []
+    for root, dirs, files in os.walk(source):
+        yamls = [f for f in files if f.upper().endswith('.YAML')]
+        codeObjects = [f for f in files if f.endswith('.co')]
+        names = set()
+        for file_name in yamls:
+            with open(os.path.join(root, file_name), 'r') as f:
+                contents = yaml.load(f, Loader=SafeLoader)
+            arch = contents[2]
+            if not any(s.matches(arch, contents[4]) for s in signatures):
+                continue
+            target = os.path.join(dest, os.path.relpath(root, source))
+            os.makedirs(target, exist_ok=True)
+            shutil.copy2(os.path.join(root, file_name), target)
+            if arch not in archs:
+                archs.append(arch)
+            names.add(os.path.splitext(file_name)[0])
+            for solution in contents[5]:
+                name = solution.get('SolutionNameMin')
+                names.update([name, name + 'K1'])
+        # the code objects are named after their solution, or after their logic file
+        for file_name in codeObjects:
+            if os.path.splitext(file_name)[0] in names:
+                shutil.copy2(os.path.join(root, file_name), os.path.join(dest, os.path.relpath(root, source)))
+
+    if not archs:
+        sys.exit('no kernel of {} matches the problem signatures'.format(source))
+    print(';'.join(archs), end='')
+
+if __name__=="__main__":
+    main(sys.argv[1:])
@@ -0,0 +1,146 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#include "hipsparselt_tuning_db.hpp"
+#include "hipsparselt_ostream.hpp"
+
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+namespace
+{
+    struct tuning_db
+    {
+        std::mutex                                            mutex;
+        std::string                                           path;
+        bool                                                  read_only = false;
+        std::unordered_map<std::string, std::vector<int64_t>> entries;
+
+        tuning_db()
+        {
+            const char* env = getenv("HIPSPARSELT_TUNING_DB");
+            if(env == nullptr || *env == '\0')
+                return;
+            path = env;
+
+            if((env = getenv("HIPSPARSELT_TUNING_DB_READONLY")) != nullptr)
+                read_only = (atoi(env) > 0);
+
+            std::ifstream ifs(path);
+            std::string   line;
+            while(std::getline(ifs, line))
+            {
+                // skip comments
+                if(line.empty() || line[0] == '#')
+                    continue;
+                std::istringstream       iss(line);
+                std::vector<std::string> fields;
+                std::string              field;
+                while(iss >> field)
+                    fields.push_back(field);
+
+                std::string backend;
+                size_t      first = 1;
+                if(fields.size() >= 3 && (fields[0] == "hip" || fields[0] == "cuda"))
+                {
+                    backend = fields[0];
+                    first   = 2;
+                }
+                else if(fields.size() == 2)
+                {
+                    backend = "hip";
+                    first   = 1;
+                }
+                else
+                    continue;
+
+                // skip the lines truncated by a concurrent writer
+                std::vector<int64_t> values;
+                for(size_t i = first; i < fields.size(); i++)
+                {
+                    char* end;
+                    values.push_back(strtoll(fields[i].c_str(), &end, 10));
+                    if(*end != '\0')
+                        break;
+                }
+                if(values.size() != fields.size() - first)
+                    continue;
+                entries[backend + ' ' + fields[first - 1]] = values;
+            }
+        }
+    };
+
+    tuning_db& get_tuning_db()
+    {
+        static tuning_db db;
+        return db;
+    }
+}
+
+bool hipsparselt_tuning_db_find(const char*           backend,
+                                const std::string&    signature,
+                                std::vector<int64_t>* values)
+{
+    auto& db = get_tuning_db();
+    if(db.path.empty())
+        return false;
+
+    std::lock_guard<std::mutex> lock(db.mutex);
+    auto                        it = db.entries.find(backend + (' ' + signature));
+    if(it == db.entries.end())
+        return false;
+    *values = it->second;
+    return true;
+}
+
+void hipsparselt_tuning_db_store(const char*                 backend,
+                                 const std::string&          signature,
+                                 const std::vector<int64_t>& values)
+{
+    auto& db = get_tuning_db();
+    if(db.path.empty() || db.read_only)
+        return;
+
+    std::lock_guard<std::mutex> lock(db.mutex);
+    const std::string           key = backend + (' ' + signature);
+    auto                        it  = db.entries.find(key);
+    if(it != db.entries.end() && it->second == values)
+        return;
+    db.entries[key] = values;
+
+    // one line per write, so the processes sharing the file only append whole entries
+    std::ostringstream line;
+    line << key;
+    for(auto value : values)
+        line << ' ' << value;
+    line << '\n';
+    std::ofstream ofs(db.path, std::ios::app);
+    ofs << line.str() << std::flush;
+    if(!ofs)
+        hipsparselt_cerr << "cannot write the tuning database " << db.path << std::endl;
+}
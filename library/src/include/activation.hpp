@@ -41,6 +41,8 @@ enum class hipsparselt_activation_type
     tanh,
     all,
     exp,
+    silu,
+    clamp,
 };
 
 HIPSPARSELT_EXPORT
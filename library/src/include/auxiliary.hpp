@@ -105,6 +105,8 @@ constexpr const char* hipsparselt_datatype_to_string(hipsparseLtDatatype_t type)
         return "bf16_r";
     case HIPSPARSELT_R_8I:
         return "i8_r";
+    case HIPSPARSELT_R_32I:
+        return "i32_r";
     case HIPSPARSELT_R_8F:
         return "f8_r";
     case HIPSPARSELT_R_8BF:
@@ -0,0 +1,51 @@
+/*******************************************************************************
+ *
+ * MIT License
+ *
+ * Copyright (c) 2024 Advanced Micro Devices, Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+ *******************************************************************************/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*******************************************************************************
+ * The tuning database file of HIPSPARSELT_TUNING_DB, shared by the backends so
+ * one file tunes a fleet of AMD and NVIDIA devices. Every line is
+ * "<backend> <problem signature> <value>...", where the backend is "hip" or
+ * "cuda" and the signature starts with the device; later lines override
+ * earlier ones. The lines "<problem signature> <config index>" of the files
+ * written before the backend was recorded are read as "hip" lines. The file is
+ * only read when HIPSPARSELT_TUNING_DB_READONLY is set to 1.
+ ******************************************************************************/
+
+/*! \brief look up the values the backend tuned for signature */
+bool hipsparselt_tuning_db_find(const char*           backend,
+                                const std::string&    signature,
+                                std::vector<int64_t>* values);
+
+/*! \brief record the values the backend tuned for signature, unless the file is read only */
+void hipsparselt_tuning_db_store(const char*                 backend,
+                                 const std::string&          signature,
+                                 const std::vector<int64_t>& values);
@@ -24,16 +24,81 @@
  *
  *******************************************************************************/
 
+#include "auxiliary.hpp"
 #include "exceptions.hpp"
+#include "hipsparselt_tuning_db.hpp"
 #include <hipsparselt/hipsparselt.h>
 
 #include <cusparseLt.h>
+#include <mutex>
+#include <sstream>
 #include <stdio.h>
 #include <stdlib.h>
+#include <unordered_map>
 
 #define TO_STR2(x) #x
 #define TO_STR(x) TO_STR2(x)
 
+namespace
+{
+    // cuSPARSELt descriptors are opaque, the problem signatures of the tuning database are
+    // built from the arguments the descriptors of the problem were initialized with
+    struct tuning_mat
+    {
+        std::string text;
+        bool        structured;
+        int64_t     rows;
+        int64_t     cols;
+        int64_t     batches = 1;
+    };
+
+    struct tuning_matmul
+    {
+        std::string text;
+        uint64_t    attributes = 0;
+    };
+
+    struct tuning_state
+    {
+        std::mutex                                     mutex;
+        std::unordered_map<const void*, tuning_mat>    mats;
+        std::unordered_map<const void*, tuning_matmul> matmuls;
+        std::unordered_map<const void*, std::string>   alg_selections;
+        std::unordered_map<const void*, const void*>   plans;
+    };
+
+    tuning_state& get_tuning_state()
+    {
+        static tuning_state state;
+        return state;
+    }
+
+    void tuning_record_mat(const void*           matDescr,
+                           bool                  structured,
+                           int64_t               rows,
+                           int64_t               cols,
+                           int64_t               ld,
+                           hipsparseLtDatatype_t valueType,
+                           hipsparseOrder_t      order)
+    {
+        std::ostringstream os;
+        os << hipsparselt_datatype_to_string(valueType) << '_'
+           << (order == HIPSPARSE_ORDER_ROW ? "row" : "col") << '_' << rows << 'x' << cols << "_ld"
+           << ld;
+
+        auto&                       state = get_tuning_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.mats[matDescr] = {os.str(), structured, rows, cols};
+    }
+
+    // "cuda" entries are "<config id> <split k> <split k mode> <split k buffers>"
+    constexpr cusparseLtMatmulAlgAttribute_t tuning_attributes[]
+        = {CUSPARSELT_MATMUL_ALG_CONFIG_ID,
+           CUSPARSELT_MATMUL_SPLIT_K,
+           CUSPARSELT_MATMUL_SPLIT_K_MODE,
+           CUSPARSELT_MATMUL_SPLIT_K_BUFFERS};
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -129,6 +194,9 @@ cudaDataType HIPDatatypeToCuSparseLtDatatype(hipsparseLtDatatype_t type)
     case HIPSPARSELT_R_8I:
         return CUDA_R_8I;
 
+    case HIPSPARSELT_R_32I:
+        return CUDA_R_32I;
+
     default:
         throw HIPSPARSE_STATUS_NOT_SUPPORTED;
     }
@@ -150,6 +218,9 @@ hipsparseLtDatatype_t CuSparseLtDatatypeToHIPDatatype(cudaDataType type)
     case CUDA_R_8I:
         return HIPSPARSELT_R_8I;
 
+    case CUDA_R_32I:
+        return HIPSPARSELT_R_32I;
+
     default:
         throw HIPSPARSE_STATUS_NOT_SUPPORTED;
     }
@@ -536,6 +607,18 @@ hipsparseStatus_t hipsparseLtGetProperty(hipLibraryPropertyType propertyType, in
         cusparseLtGetProperty(HIPLibraryPropertyTypeToCuLibraryPoropertyType(propertyType), value));
 }
 
+hipsparseStatus_t hipsparseLtGetConfigCacheStats(const hipsparseLtHandle_t*     handle,
+                                                 hipsparseLtConfigCacheStats_t* stats)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtGetCodeObjectStats(const hipsparseLtHandle_t*    handle,
+                                                hipsparseLtCodeObjectStats_t* stats)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
 /* matrix descriptor */
 // dense matrix
 hipsparseStatus_t hipsparseLtDenseDescriptorInit(const hipsparseLtHandle_t*  handle,
@@ -547,7 +630,7 @@ hipsparseStatus_t hipsparseLtDenseDescriptorInit(const hipsparseLtHandle_t*  han
                                                  hipsparseLtDatatype_t       valueType,
                                                  hipsparseOrder_t            order)
 {
-    return hipCUSPARSEStatusToHIPStatus(
+    RETURN_IF_CUSPARSE_ERROR(
         cusparseLtDenseDescriptorInit((const cusparseLtHandle_t*)handle,
                                       (cusparseLtMatDescriptor_t*)matDescr,
                                       rows,
@@ -556,6 +639,8 @@ hipsparseStatus_t hipsparseLtDenseDescriptorInit(const hipsparseLtHandle_t*  han
                                       alignment,
                                       HIPDatatypeToCuSparseLtDatatype(valueType),
                                       hipOrderToCudaOrder(order)));
+    tuning_record_mat(matDescr, false, rows, cols, ld, valueType, order);
+    return HIPSPARSE_STATUS_SUCCESS;
 }
 
 // structured matrix
@@ -569,7 +654,7 @@ hipsparseStatus_t hipsparseLtStructuredDescriptorInit(const hipsparseLtHandle_t*
                                                       hipsparseOrder_t            order,
                                                       hipsparseLtSparsity_t       sparsity)
 {
-    return hipCUSPARSEStatusToHIPStatus(
+    RETURN_IF_CUSPARSE_ERROR(
         cusparseLtStructuredDescriptorInit((const cusparseLtHandle_t*)handle,
                                            (cusparseLtMatDescriptor_t*)matDescr,
                                            rows,
@@ -579,10 +664,17 @@ hipsparseStatus_t hipsparseLtStructuredDescriptorInit(const hipsparseLtHandle_t*
                                            HIPDatatypeToCuSparseLtDatatype(valueType),
                                            hipOrderToCudaOrder(order),
                                            HIPSparsityToCuSparseLtSparsity(sparsity)));
+    tuning_record_mat(matDescr, true, rows, cols, ld, valueType, order);
+    return HIPSPARSE_STATUS_SUCCESS;
 }
 
 hipsparseStatus_t hipsparseLtMatDescriptorDestroy(const hipsparseLtMatDescriptor_t* matDescr)
 {
+    {
+        auto&                       state = get_tuning_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.mats.erase(matDescr);
+    }
     return hipCUSPARSEStatusToHIPStatus(
         cusparseLtMatDescriptorDestroy((const cusparseLtMatDescriptor_t*)matDescr));
 }
@@ -593,12 +685,21 @@ hipsparseStatus_t hipsparseLtMatDescSetAttribute(const hipsparseLtHandle_t*    h
                                                  const void*                   data,
                                                  size_t                        dataSize)
 {
-    return hipCUSPARSEStatusToHIPStatus(
+    RETURN_IF_CUSPARSE_ERROR(
         cusparseLtMatDescSetAttribute((const cusparseLtHandle_t*)handle,
                                       (cusparseLtMatDescriptor_t*)matmulDescr,
                                       HIPMatDescAttributeToCuSparseLtMatDescAttribute(matAttribute),
                                       data,
                                       dataSize));
+    if(matAttribute == HIPSPARSELT_MAT_NUM_BATCHES && dataSize == sizeof(int))
+    {
+        auto&                       state = get_tuning_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto                        it = state.mats.find(matmulDescr);
+        if(it != state.mats.end())
+            it->second.batches = *reinterpret_cast<const int*>(data);
+    }
+    return HIPSPARSE_STATUS_SUCCESS;
 }
 
 hipsparseStatus_t hipsparseLtMatDescGetAttribute(const hipsparseLtHandle_t*        handle,
@@ -626,7 +727,7 @@ hipsparseStatus_t hipsparseLtMatmulDescriptorInit(const hipsparseLtHandle_t*
                                                   const hipsparseLtMatDescriptor_t* matD,
                                                   hipsparseLtComputetype_t          computeType)
 {
-    return hipCUSPARSEStatusToHIPStatus(
+    RETURN_IF_CUSPARSE_ERROR(
         cusparseLtMatmulDescriptorInit((const cusparseLtHandle_t*)handle,
                                        (cusparseLtMatmulDescriptor_t*)matmulDescr,
                                        hipOperationToCudaOperation(opA),
@@ -636,6 +737,34 @@ hipsparseStatus_t hipsparseLtMatmulDescriptorInit(const hipsparseLtHandle_t*
                                        (const cusparseLtMatDescriptor_t*)matC,
                                        (const cusparseLtMatDescriptor_t*)matD,
                                        HIPComputetypeToCuSparseComputetype(computeType)));
+
+    // the key of the problem: device, types, operations, sizes and sparse side, as the
+    // signatures of the HIP backend
+    int             device;
+    hipDeviceProp_t prop;
+    if(hipGetDevice(&device) != hipSuccess || hipGetDeviceProperties(&prop, device) != hipSuccess)
+        return HIPSPARSE_STATUS_SUCCESS;
+
+    auto&                       state = get_tuning_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    const void*                 mats[] = {matA, matB, matC, matD};
+    for(auto mat : mats)
+        if(state.mats.find(mat) == state.mats.end())
+            return HIPSPARSE_STATUS_SUCCESS;
+
+    const auto&        A = state.mats[matA];
+    std::ostringstream os;
+    os << "sm" << prop.major << prop.minor << "_cu" << prop.multiProcessorCount << '_'
+       << hipsparselt_computetype_to_string(computeType) << '_'
+       << hipsparselt_operation_to_string(opA) << hipsparselt_operation_to_string(opB) << "_m"
+       << state.mats[matC].rows << "_n" << state.mats[matC].cols << "_k"
+       << (opA == HIPSPARSE_OPERATION_NON_TRANSPOSE ? A.cols : A.rows);
+    const char names[] = "ABCD";
+    for(int i = 0; i < 4; i++)
+        os << '_' << names[i] << state.mats[mats[i]].text << "_b" << state.mats[mats[i]].batches;
+    os << "_sparse" << (A.structured ? 'A' : 'B');
+    state.matmuls[matmulDescr] = {os.str()};
+    return HIPSPARSE_STATUS_SUCCESS;
 }
 
 hipsparseStatus_t
@@ -645,12 +774,20 @@ hipsparseStatus_t
                                       const void*                      data,
                                       size_t                           dataSize)
 {
-    return hipCUSPARSEStatusToHIPStatus(cusparseLtMatmulDescSetAttribute(
+    RETURN_IF_CUSPARSE_ERROR(cusparseLtMatmulDescSetAttribute(
         (const cusparseLtHandle_t*)handle,
         (cusparseLtMatmulDescriptor_t*)matmulDescr,
         HIPMatmulDescAttributeToCuSparseLtMatmulDescAttribute(matmulAttribute),
         data,
         dataSize));
+
+    // the epilogue of the problem is part of its signature
+    auto&                       state = get_tuning_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    auto                        it = state.matmuls.find(matmulDescr);
+    if(it != state.matmuls.end() && matmulAttribute < 64)
+        it->second.attributes |= uint64_t(1) << matmulAttribute;
+    return HIPSPARSE_STATUS_SUCCESS;
 }
 
 hipsparseStatus_t
@@ -675,11 +812,44 @@ hipsparseStatus_t
                                       const hipsparseLtMatmulDescriptor_t* matmulDescr,
                                       hipsparseLtMatmulAlg_t               alg)
 {
-    return hipCUSPARSEStatusToHIPStatus(
+    RETURN_IF_CUSPARSE_ERROR(
         cusparseLtMatmulAlgSelectionInit((const cusparseLtHandle_t*)handle,
                                          (cusparseLtMatmulAlgSelection_t*)algSelection,
                                          (const cusparseLtMatmulDescriptor_t*)matmulDescr,
                                          HIPMatmulAlgToCuSparseLtMatmulAlg(alg)));
+
+    std::string signature;
+    {
+        auto&                       state = get_tuning_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto                        it = state.matmuls.find(matmulDescr);
+        if(it == state.matmuls.end())
+            return HIPSPARSE_STATUS_SUCCESS;
+        signature = it->second.text;
+        if(it->second.attributes != 0)
+            signature += "_attributes" + std::to_string(it->second.attributes);
+        state.alg_selections[algSelection] = signature;
+    }
+
+    // start from the config a previous search selected for the same problem, the defaults
+    // of cuSPARSELt stay when the tuned config is not valid for this version
+    std::vector<int64_t> values;
+    if(hipsparselt_tuning_db_find("cuda", signature, &values)
+       && values.size() == sizeof(tuning_attributes) / sizeof(tuning_attributes[0]))
+    {
+        for(size_t i = 0; i < values.size(); i++)
+        {
+            int value = static_cast<int>(values[i]);
+            if(cusparseLtMatmulAlgSetAttribute((const cusparseLtHandle_t*)handle,
+                                               (cusparseLtMatmulAlgSelection_t*)algSelection,
+                                               tuning_attributes[i],
+                                               &value,
+                                               sizeof(value))
+               != CUSPARSE_STATUS_SUCCESS)
+                break;
+        }
+    }
+    return HIPSPARSE_STATUS_SUCCESS;
 }
 
 hipsparseStatus_t hipsparseLtMatmulAlgSetAttribute(const hipsparseLtHandle_t*       handle,
@@ -725,19 +895,86 @@ hipsparseStatus_t hipsparseLtMatmulPlanInit(const hipsparseLtHandle_t*
                                             const hipsparseLtMatmulDescriptor_t*   matmulDescr,
                                             const hipsparseLtMatmulAlgSelection_t* algSelection)
 {
-    return hipCUSPARSEStatusToHIPStatus(
+    RETURN_IF_CUSPARSE_ERROR(
         cusparseLtMatmulPlanInit((const cusparseLtHandle_t*)handle,
                                  (cusparseLtMatmulPlan_t*)plan,
                                  (const cusparseLtMatmulDescriptor_t*)matmulDescr,
                                  (const cusparseLtMatmulAlgSelection_t*)algSelection));
+
+    // the search updates the algorithm selection of the plan
+    auto&                       state = get_tuning_state();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    state.plans[plan] = algSelection;
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+
+// cuSPARSELt has no initialization in the background, the plan is ready on return
+hipsparseStatus_t hipsparseLtMatmulPlanInitAsync(const hipsparseLtHandle_t*           handle,
+                                                 hipsparseLtMatmulPlan_t*             plan,
+                                                 hipsparseLtMatmulAlgSelection_t*     algSelection,
+                                                 const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                                 hipsparseLtMatmulAlg_t               alg)
+{
+    hipsparseStatus_t status
+        = hipsparseLtMatmulAlgSelectionInit(handle, algSelection, matmulDescr, alg);
+    if(status != HIPSPARSE_STATUS_SUCCESS)
+        return status;
+    return hipsparseLtMatmulPlanInit(handle, plan, matmulDescr, algSelection);
+}
+
+hipsparseStatus_t hipsparseLtMatmulPlanInitWait(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan)
+{
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+
+hipsparseStatus_t hipsparseLtMatmulPlanInitQuery(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 int*                           ready)
+{
+    if(ready == nullptr)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+    *ready = 1;
+    return HIPSPARSE_STATUS_SUCCESS;
 }
 
 hipsparseStatus_t hipsparseLtMatmulPlanDestroy(const hipsparseLtMatmulPlan_t* plan)
 {
+    {
+        auto&                       state = get_tuning_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        state.plans.erase(plan);
+    }
     return hipCUSPARSEStatusToHIPStatus(
         cusparseLtMatmulPlanDestroy((const cusparseLtMatmulPlan_t*)plan));
 }
 
+hipsparseStatus_t hipsparseLtMatmulPlanSerialize(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 void*                          data,
+                                                 size_t*                        dataSize)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t
+    hipsparseLtMatmulPlanDeserialize(const hipsparseLtHandle_t*           handle,
+                                     hipsparseLtMatmulPlan_t*             plan,
+                                     const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                     hipsparseLtMatmulAlgSelection_t*     algSelection,
+                                     const void*                          data,
+                                     size_t                               dataSize)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtMatmulPlanGetStats(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan,
+                                                hipsparseLtMatmulPlanStats_t*  stats)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
 /* matmul execution */
 hipsparseStatus_t hipsparseLtMatmul(const hipsparseLtHandle_t*     handle,
                                     const hipsparseLtMatmulPlan_t* plan,
@@ -776,17 +1013,252 @@ hipsparseStatus_t hipsparseLtMatmulSearch(const hipsparseLtHandle_t* handle,
                                           hipStream_t*               streams,
                                           int32_t                    numStreams)
 {
-    return hipCUSPARSEStatusToHIPStatus(cusparseLtMatmulSearch((const cusparseLtHandle_t*)handle,
-                                                               (cusparseLtMatmulPlan_t*)plan,
-                                                               alpha,
-                                                               d_A,
-                                                               d_B,
-                                                               beta,
-                                                               d_C,
-                                                               d_D,
-                                                               workspace,
-                                                               streams,
-                                                               numStreams));
+    RETURN_IF_CUSPARSE_ERROR(cusparseLtMatmulSearch((const cusparseLtHandle_t*)handle,
+                                                    (cusparseLtMatmulPlan_t*)plan,
+                                                    alpha,
+                                                    d_A,
+                                                    d_B,
+                                                    beta,
+                                                    d_C,
+                                                    d_D,
+                                                    workspace,
+                                                    streams,
+                                                    numStreams));
+
+    // the next processes start from the selected config
+    const void* algSelection = nullptr;
+    std::string signature;
+    {
+        auto&                       state = get_tuning_state();
+        std::lock_guard<std::mutex> lock(state.mutex);
+        auto                        it = state.plans.find(plan);
+        if(it == state.plans.end())
+            return HIPSPARSE_STATUS_SUCCESS;
+        algSelection = it->second;
+        auto alg_it  = state.alg_selections.find(algSelection);
+        if(alg_it == state.alg_selections.end())
+            return HIPSPARSE_STATUS_SUCCESS;
+        signature = alg_it->second;
+    }
+
+    std::vector<int64_t> values;
+    for(auto attribute : tuning_attributes)
+    {
+        int value = 0;
+        if(cusparseLtMatmulAlgGetAttribute((const cusparseLtHandle_t*)handle,
+                                           (const cusparseLtMatmulAlgSelection_t*)algSelection,
+                                           attribute,
+                                           &value,
+                                           sizeof(value))
+           != CUSPARSE_STATUS_SUCCESS)
+            return HIPSPARSE_STATUS_SUCCESS;
+        values.push_back(value);
+    }
+    hipsparselt_tuning_db_store("cuda", signature, values);
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+
+// cusparseLt searches in place on the output and workspace of the caller, which a background
+// search cannot borrow, so only the blocking hipsparseLtMatmulSearch is available.
+hipsparseStatus_t hipsparseLtMatmulSearchAsync(const hipsparseLtHandle_t* handle,
+                                               hipsparseLtMatmulPlan_t*   plan,
+                                               const void*                alpha,
+                                               const void*                d_A,
+                                               const void*                d_B,
+                                               const void*                beta,
+                                               const void*                d_C,
+                                               hipStream_t                stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtMatmulSearchWait(const hipsparseLtHandle_t* handle,
+                                              hipsparseLtMatmulPlan_t*   plan)
+{
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+
+hipsparseStatus_t hipsparseLtMatmulPlanGetGraph(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan,
+                                                const void*                    alpha,
+                                                const void*                    d_A,
+                                                const void*                    d_B,
+                                                const void*                    beta,
+                                                const void*                    d_C,
+                                                void*                          d_D,
+                                                void*                          workspace,
+                                                hipStream_t                    stream,
+                                                hipGraph_t*                    graph)
+{
+    if(graph == nullptr || stream == nullptr)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+
+    if(hipStreamBeginCapture(stream, hipStreamCaptureModeRelaxed) != hipSuccess)
+        return HIPSPARSE_STATUS_INTERNAL_ERROR;
+
+    hipsparseStatus_t status
+        = hipCUSPARSEStatusToHIPStatus(cusparseLtMatmul((const cusparseLtHandle_t*)handle,
+                                                        (const cusparseLtMatmulPlan_t*)plan,
+                                                        alpha,
+                                                        d_A,
+                                                        d_B,
+                                                        beta,
+                                                        d_C,
+                                                        d_D,
+                                                        workspace,
+                                                        &stream,
+                                                        1));
+
+    hipGraph_t captured = nullptr;
+    if(hipStreamEndCapture(stream, &captured) != hipSuccess
+       && status == HIPSPARSE_STATUS_SUCCESS)
+        status = HIPSPARSE_STATUS_INTERNAL_ERROR;
+
+    if(status != HIPSPARSE_STATUS_SUCCESS)
+    {
+        if(captured != nullptr)
+            hipGraphDestroy(captured);
+        return status;
+    }
+    *graph = captured;
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+
+hipsparseStatus_t hipsparseLtMatmulGraphLaunch(const hipsparseLtHandle_t* handle,
+                                               hipsparseLtMatmulPlan_t*   plan,
+                                               hipGraphExec_t             graphExec,
+                                               const void*                alpha,
+                                               const void*                d_A,
+                                               const void*                d_B,
+                                               const void*                beta,
+                                               const void*                d_C,
+                                               void*                      d_D,
+                                               void*                      workspace,
+                                               hipStream_t                stream)
+{
+    if(graphExec == nullptr)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+
+    // cusparseLt plans are opaque, so the arguments of the last launch are not tracked and
+    // the node parameters of graphExec are refreshed on every launch.
+    hipGraph_t        graph  = nullptr;
+    hipsparseStatus_t status = hipsparseLtMatmulPlanGetGraph(
+        handle, plan, alpha, d_A, d_B, beta, d_C, d_D, workspace, stream, &graph);
+    if(status != HIPSPARSE_STATUS_SUCCESS)
+        return status;
+
+    hipGraphNode_t           error_node = nullptr;
+    hipGraphExecUpdateResult result     = hipGraphExecUpdateError;
+    hipError_t               hip_status
+        = hipGraphExecUpdate(graphExec, graph, &error_node, &result);
+    hipGraphDestroy(graph);
+    if(hip_status != hipSuccess || result != hipGraphExecUpdateSuccess)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+
+    if(hipGraphLaunch(graphExec, stream) != hipSuccess)
+        return HIPSPARSE_STATUS_EXECUTION_FAILED;
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+
+hipsparseStatus_t hipsparseLtMatmulGrouped(const hipsparseLtHandle_t*            handle,
+                                           const hipsparseLtMatmulPlan_t* const* plans,
+                                           int32_t                               groupCount,
+                                           const void*                           alpha,
+                                           const void* const*                    d_A,
+                                           const void* const*                    d_B,
+                                           const void*                           beta,
+                                           const void* const*                    d_C,
+                                           void* const*                          d_D,
+                                           void* const*                          workspaces,
+                                           hipStream_t*                          streams,
+                                           int32_t                               numStreams)
+{
+    if(groupCount < 0 || numStreams < 0 || (streams == nullptr && numStreams > 0))
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+    if(groupCount == 0)
+        return HIPSPARSE_STATUS_SUCCESS;
+    if(plans == nullptr || d_A == nullptr || d_B == nullptr || d_C == nullptr || d_D == nullptr)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+
+    // cusparseLt has no grouped entry point, the groups are issued in order on streams[0]
+    // so that no join is needed
+    for(int32_t g = 0; g < groupCount; g++)
+    {
+        hipsparseStatus_t status = hipCUSPARSEStatusToHIPStatus(
+            cusparseLtMatmul((const cusparseLtHandle_t*)handle,
+                             (const cusparseLtMatmulPlan_t*)plans[g],
+                             alpha,
+                             d_A[g],
+                             d_B[g],
+                             beta,
+                             d_C[g],
+                             d_D[g],
+                             workspaces ? workspaces[g] : nullptr,
+                             streams,
+                             numStreams ? 1 : 0));
+        if(status != HIPSPARSE_STATUS_SUCCESS)
+            return status;
+    }
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+
+hipsparseStatus_t
+    hipsparseLtMatmulShardedGetWorkspace(const hipsparseLtHandle_t* const*     handles,
+                                         const hipsparseLtMatmulPlan_t* const* plans,
+                                         int32_t                               numShards,
+                                         hipsparseLtShardSplit_t               split,
+                                         size_t*                               workspaceSizes)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtMatmulSharded(const hipsparseLtHandle_t* const*     handles,
+                                           const hipsparseLtMatmulPlan_t* const* plans,
+                                           int32_t                               numShards,
+                                           hipsparseLtShardSplit_t               split,
+                                           const void*                           alpha,
+                                           const void* const*                    d_A,
+                                           const void* const*                    d_B,
+                                           const void*                           beta,
+                                           const void* const*                    d_C,
+                                           void* const*                          d_D,
+                                           void* const*                          workspaces,
+                                           hipStream_t*                          streams)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtMatmulPointerArray(const hipsparseLtHandle_t*     handle,
+                                                const hipsparseLtMatmulPlan_t* plan,
+                                                const void*                    alpha,
+                                                const void*                    d_compressed,
+                                                const void* const*             d_dense,
+                                                const void*                    beta,
+                                                const void* const*             d_C,
+                                                void* const*                   d_D,
+                                                void*                          workspace,
+                                                hipStream_t*                   streams,
+                                                int32_t                        numStreams)
+{
+    // cusparseLt addresses the batches of a plan by their strides only
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtMatmulDynamicN(const hipsparseLtHandle_t*     handle,
+                                            const hipsparseLtMatmulPlan_t* plan,
+                                            int64_t                        n,
+                                            const void*                    alpha,
+                                            const void*                    d_A,
+                                            const void*                    d_B,
+                                            const void*                    beta,
+                                            const void*                    d_C,
+                                            void*                          d_D,
+                                            void*                          workspace,
+                                            hipStream_t*                   streams,
+                                            int32_t                        numStreams)
+{
+    // the N of a cusparseLt plan is fixed
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
 }
 
 /* helper */
@@ -860,6 +1332,59 @@ hipsparseStatus_t hipsparseLtSpMMAPruneCheck2(const hipsparseLtHandle_t*
                                    stream));
 }
 
+hipsparseStatus_t hipsparseLtSpMMAPruneCheckCount(const hipsparseLtHandle_t*           handle,
+                                                  const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                                  const void*                          d_in,
+                                                  int64_t*                             d_count,
+                                                  int64_t*                             d_offsets,
+                                                  int                                  maxOffsets,
+                                                  hipStream_t                          stream)
+{
+    // cusparseLt only reports whether the matrix is valid.
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMAPruneMaskSize(const hipsparseLtHandle_t*           handle,
+                                                const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                                size_t*                              maskSize)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMAPruneMask(const hipsparseLtHandle_t*           handle,
+                                            const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                            const void*                          d_in,
+                                            void*                                d_out,
+                                            void*                                d_mask,
+                                            hipsparseLtPruneAlg_t                pruneAlg,
+                                            hipStream_t                          stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMAMaskApply(const hipsparseLtHandle_t*           handle,
+                                            const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                            const void*                          d_in,
+                                            void*                                d_out,
+                                            const void*                          d_mask,
+                                            hipStream_t                          stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMAPruneScored(const hipsparseLtHandle_t*           handle,
+                                              const hipsparseLtMatmulDescriptor_t* matmulDescr,
+                                              const void*                          d_in,
+                                              void*                                d_out,
+                                              const float*                         d_score,
+                                              const float*                         d_colScale,
+                                              void*                                d_mask,
+                                              hipsparseLtPruneAlg_t                pruneAlg,
+                                              hipStream_t                          stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
 // compression
 hipsparseStatus_t hipsparseLtSpMMACompressedSize(const hipsparseLtHandle_t*     handle,
                                                  const hipsparseLtMatmulPlan_t* plan,
@@ -888,6 +1413,19 @@ hipsparseStatus_t hipsparseLtSpMMACompress(const hipsparseLtHandle_t*     handle
                                                                 stream));
 }
 
+hipsparseStatus_t
+    hipsparseLtSpMMACompressSharded(const hipsparseLtHandle_t* const*     handles,
+                                    const hipsparseLtMatmulPlan_t* const* plans,
+                                    int32_t                               numShards,
+                                    hipsparseLtShardSplit_t               split,
+                                    const void* const*                    d_dense,
+                                    void* const*                          d_compressed,
+                                    void* const*                          d_compressBuffer,
+                                    hipStream_t*                          streams)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
 hipsparseStatus_t hipsparseLtSpMMACompressedSize2(const hipsparseLtHandle_t*        handle,
                                                   const hipsparseLtMatDescriptor_t* sparseMatDescr,
                                                   size_t*                           compressedSize,
@@ -920,8 +1458,254 @@ hipsparseStatus_t hipsparseLtSpMMACompress2(const hipsparseLtHandle_t*        ha
                                  stream));
 }
 
+hipsparseStatus_t hipsparseLtSpMMAPruneAndCompress(const hipsparseLtHandle_t*     handle,
+                                                   const hipsparseLtMatmulPlan_t* plan,
+                                                   const void*                    d_dense,
+                                                   void*                          d_compressed,
+                                                   void*                          d_compressBuffer,
+                                                   hipsparseLtPruneAlg_t          pruneAlg,
+                                                   hipStream_t                    stream)
+{
+    // cusparseLt has no fused entry point, prune and compress separately.
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMAPruneAndCompressTransposable(const hipsparseLtHandle_t*        handle,
+                                                 const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                                 int                               isSparseA,
+                                                 const void*                       d_in,
+                                                 void*                             d_out,
+                                                 void*                             d_compressed,
+                                                 void*                             d_compressedT,
+                                                 hipStream_t                       stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMAGroupedWorkListSize(const hipsparseLtHandle_t* handle,
+                                                      int                        groupCount,
+                                                      size_t*                    workListSize)
+{
+    // cusparseLt has no grouped entry points, prune and compress the matrices one by one.
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMAPrune2Grouped(const hipsparseLtHandle_t*               handle,
+                                  int                                      groupCount,
+                                  const hipsparseLtMatDescriptor_t* const* sparseMatDescrs,
+                                  int                                      isSparseA,
+                                  hipsparseOperation_t                     op,
+                                  const void* const*                       d_in,
+                                  void* const*                             d_out,
+                                  hipsparseLtPruneAlg_t                    pruneAlg,
+                                  void*                                    d_workList,
+                                  hipStream_t                              stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMACompress2Grouped(const hipsparseLtHandle_t*               handle,
+                                     int                                      groupCount,
+                                     const hipsparseLtMatDescriptor_t* const* sparseMatDescrs,
+                                     int                                      isSparseA,
+                                     hipsparseOperation_t                     op,
+                                     const void* const*                       d_dense,
+                                     void* const*                             d_compressed,
+                                     void*                                    d_workList,
+                                     hipStream_t                              stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedSizeHost(int64_t               rows,
+                                                     int64_t               cols,
+                                                     int64_t               ld,
+                                                     hipsparseLtDatatype_t valueType,
+                                                     int                   numBatches,
+                                                     int64_t               batchStride,
+                                                     int                   isSparseA,
+                                                     hipsparseOperation_t  op,
+                                                     size_t*               compressedSize)
+{
+    // the compressed layout of cusparseLt is not documented, it is only written on the device.
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMAPruneHost(int64_t               rows,
+                                            int64_t               cols,
+                                            int64_t               ld,
+                                            hipsparseLtDatatype_t valueType,
+                                            int                   numBatches,
+                                            int64_t               batchStride,
+                                            int                   isSparseA,
+                                            hipsparseOperation_t  op,
+                                            const void*           h_in,
+                                            void*                 h_out,
+                                            hipsparseLtPruneAlg_t pruneAlg,
+                                            int                   numThreads)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressHost(int64_t               rows,
+                                               int64_t               cols,
+                                               int64_t               ld,
+                                               hipsparseLtDatatype_t valueType,
+                                               int                   numBatches,
+                                               int64_t               batchStride,
+                                               int                   isSparseA,
+                                               hipsparseOperation_t  op,
+                                               const void*           h_dense,
+                                               void*                 h_compressed,
+                                               int                   numThreads)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMADecompress(const hipsparseLtHandle_t*     handle,
+                                             const hipsparseLtMatmulPlan_t* plan,
+                                             const void*                    d_compressed,
+                                             void*                          d_dense,
+                                             hipStream_t                    stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMADecompress2(const hipsparseLtHandle_t*        handle,
+                                              const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                              int                               isSparseA,
+                                              hipsparseOperation_t              op,
+                                              const void*                       d_compressed,
+                                              void*                             d_dense,
+                                              hipStream_t                       stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMACompressedUpdateStateSize(const hipsparseLtHandle_t*     handle,
+                                              const hipsparseLtMatmulPlan_t* plan,
+                                              size_t*                        stateSize)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedUpdate(const hipsparseLtHandle_t*          handle,
+                                                   const hipsparseLtMatmulPlan_t*      plan,
+                                                   const hipsparseLtOptimizerParams_t* params,
+                                                   void*                               d_compressed,
+                                                   const void*                         d_grad,
+                                                   float*                              d_state1,
+                                                   float*                              d_state2,
+                                                   hipStream_t                         stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedInt4Size(const hipsparseLtHandle_t*     handle,
+                                                     const hipsparseLtMatmulPlan_t* plan,
+                                                     int64_t                        groupSize,
+                                                     size_t*                        packedSize)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedInt4Pack(const hipsparseLtHandle_t*     handle,
+                                                     const hipsparseLtMatmulPlan_t* plan,
+                                                     int64_t                        groupSize,
+                                                     const void*                    d_compressed,
+                                                     void*                          d_packed,
+                                                     hipStream_t                    stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedInt4Unpack(const hipsparseLtHandle_t*     handle,
+                                                       const hipsparseLtMatmulPlan_t* plan,
+                                                       int64_t                        groupSize,
+                                                       const void*                    d_packed,
+                                                       void*                          d_compressed,
+                                                       hipStream_t                    stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressRows(const hipsparseLtHandle_t*     handle,
+                                               const hipsparseLtMatmulPlan_t* plan,
+                                               const void*                    d_dense,
+                                               void*                          d_compressed,
+                                               int                            rangeCount,
+                                               const int64_t*                 rowRanges,
+                                               void*                          d_workList,
+                                               hipStream_t                    stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMACompress2Streamed(const hipsparseLtHandle_t*        handle,
+                                      const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                      int                               isSparseA,
+                                      hipsparseOperation_t              op,
+                                      const void*                       dense,
+                                      void*                             d_compressed,
+                                      void*                             d_panelBuffer,
+                                      size_t                            panelBufferSize,
+                                      hipStream_t                       stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t
+    hipsparseLtSpMMAPruneAndCompressStreamed(const hipsparseLtHandle_t*        handle,
+                                             const hipsparseLtMatDescriptor_t* sparseMatDescr,
+                                             int                               isSparseA,
+                                             hipsparseOperation_t              op,
+                                             const void*                       dense,
+                                             void*                             d_compressed,
+                                             void*                             d_panelBuffer,
+                                             size_t                            panelBufferSize,
+                                             hipsparseLtPruneAlg_t             pruneAlg,
+                                             float*                            bandwidth,
+                                             hipStream_t                       stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedSave(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 const void*                    d_compressed,
+                                                 const char*                    path,
+                                                 hipStream_t                    stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
+hipsparseStatus_t hipsparseLtSpMMACompressedLoad(const hipsparseLtHandle_t*     handle,
+                                                 const hipsparseLtMatmulPlan_t* plan,
+                                                 const char*                    path,
+                                                 void*                          d_compressed,
+                                                 hipStream_t                    stream)
+{
+    return HIPSPARSE_STATUS_NOT_SUPPORTED;
+}
+
 void hipsparseLtInitialize() {}
 
+hipsparseStatus_t hipsparseLtInitDevices(uint64_t deviceMask)
+{
+    // cuSPARSELt has nothing to preload, only the mask is checked
+    int count;
+    if(hipGetDeviceCount(&count) != hipSuccess)
+        return HIPSPARSE_STATUS_INTERNAL_ERROR;
+    if(count < 64 && (deviceMask >> count) != 0)
+        return HIPSPARSE_STATUS_INVALID_VALUE;
+    return HIPSPARSE_STATUS_SUCCESS;
+}
+
 hipsparseStatus_t hipsparseLtGetGitRevision(hipsparseLtHandle_t handle, char* rev)
 try
 {